@@ -16,39 +16,128 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <sys/syscall.h>
-#include <sys/socket.h>
+#include <sys/eventfd.h>
 #include <pthread.h>
 
 #include "sm_limits.h"
 #include "sm_types.h"
 #include "sm_debug_thread.h"
+#include "sm_debug_binary.h"
+
+#define SM_DEBUG_RING_SIZE                                  (64*1024)
+#define SM_DEBUG_RING_ALIGN( size )                   (((size) + 7) & ~7U)
+
+// Single producer, single consumer log ring.  The owning thread is the
+// only writer of head, the debug thread the only writer of tail.
+typedef struct
+{
+    uint64_t head __attribute__ ((aligned (64)));
+    uint64_t logged;
+    uint64_t dropped;
+    uint64_t tail __attribute__ ((aligned (64)));
+    uint64_t dropped_reported;
+    char buffer[SM_DEBUG_RING_SIZE] __attribute__ ((aligned (64)));
+} SmDebugRingT;
+
+#define SM_DEBUG_FLIGHT_RECORDER_ENTRIES                               256
+#define SM_DEBUG_FLIGHT_RECORDER_ARGS_MAX                              176
+#define SM_DEBUG_FLIGHT_RECORDER_LOG_LEVEL          SM_DEBUG_LOG_LEVEL_DEBUG
+
+// Flight recorder entry, the encoded arguments of one log.
+typedef struct
+{
+    int64_t mono_ns;
+    uint32_t format_id;
+    uint16_t args_len;
+    uint8_t log_type;
+    uint8_t truncated;
+    char args[SM_DEBUG_FLIGHT_RECORDER_ARGS_MAX];
+} SmDebugFlightEntryT;
+
+// Flight recorder, the owning thread is the only writer and overwrites
+// the oldest entry.
+typedef struct
+{
+    uint64_t next;
+    SmDebugFlightEntryT entries[SM_DEBUG_FLIGHT_RECORDER_ENTRIES];
+} SmDebugFlightRecorderT;
+
+typedef void (*SmDebugFlightCallbackT) ( const SmDebugFlightEntryT* entry,
+    int64_t real_offset_ns, void* user_data );
 
 typedef struct
 {
+    int fd;
+    int len;
+    char buffer[4096];
+    bool format_written[SM_DEBUG_BINARY_FORMATS_MAX];
+} SmDebugFlightWriterT;
+
+typedef struct
+{
+    bool claimed;
     bool inuse;
     uint64_t log_seqnum;
     uint64_t service_log_seqnum;
     char thread_name[SM_THREAD_NAME_MAX_CHAR];
     int thread_id;
     char thread_identifier[SM_THREAD_NAME_MAX_CHAR+10];
+    SmDebugRingT ring;
+    SmDebugFlightRecorderT flight;
 } SmDebugThreadInfoT;
 
-static int _server_fd = -1;
-static int _client_fd = -1;
+static int _event_fd = -1;
 static int _initialized;
 static SmDebugLogLevelT _log_level = SM_DEBUG_LOG_LEVEL_INFO;
+static SmDebugLogModeT _log_mode = SM_DEBUG_LOG_MODE_TEXT;
 static SmDebugThreadInfoT _thread_info[SM_THREADS_MAX];
 static pthread_key_t _thread_key;
 
-#define SCHED_LOGS_MAX          128
+// Shared by threads that did not register, writers never wait on it.
+static pthread_mutex_t _shared_ring_mutex = PTHREAD_MUTEX_INITIALIZER;
+static SmDebugRingT _shared_ring;
+static pthread_mutex_t _shared_flight_mutex = PTHREAD_MUTEX_INITIALIZER;
+static SmDebugFlightRecorderT _shared_flight;
+
+static int _flight_saving = 0;
+static SmDebugFlightWriterT _flight_writer;
+
+#define SCHED_LOGS_MAX                  128
+#define SCHED_LOG_DOMAINS_MAX             2
+#define SCHED_LOG_SNAPSHOT_PASSES       100 // every 5 minutes at 3 seconds
 
 typedef SmDebugThreadMsgT SmDebugSchedLogSetT[SCHED_LOGS_MAX];
 
-static int _sched_log_set = 0;
-static int _sched_log_num = 0;
-static bool _print_sched_log = true;
-static SmDebugSchedLogSetT _sched_logs[2];
+typedef struct
+{
+    int num;
+    uint32_t hashes[SCHED_LOGS_MAX];
+    SmDebugSchedLogSetT logs;
+} SmDebugSchedLogT;
+
+typedef struct
+{
+    bool inuse;
+    char domain[SM_SERVICE_DOMAIN_NAME_MAX_CHAR];
+    unsigned int passes;
+    SmDebugSchedLogT prev;
+} SmDebugSchedLogDomainT;
+
+typedef struct
+{
+    bool snapshot;
+    int lines;
+    int added;
+    int removed;
+    int dropped;
+} SmDebugSchedLogStatsT;
+
+static int _sched_log_dropped = 0;
+static SmDebugSchedLogT _sched_log;
+static SmDebugSchedLogStatsT _sched_log_stats;
+static SmDebugSchedLogDomainT _sched_log_domains[SCHED_LOG_DOMAINS_MAX];
 
 // ****************************************************************************
 // Debug - Log Level String
@@ -89,6 +178,37 @@ void sm_debug_set_log_level( SmDebugLogLevelT level )
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Debug - Log Mode String
+// =======================
+const char* sm_debug_log_mode_str( SmDebugLogModeT mode )
+{
+    switch( mode )
+    {
+        case SM_DEBUG_LOG_MODE_TEXT:
+            return( "text" );
+        break;
+
+        case SM_DEBUG_LOG_MODE_BINARY:
+            return( "binary" );
+        break;
+
+        default:
+            return( "???" );
+        break;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Set Log Mode
+// ====================
+void sm_debug_set_log_mode( SmDebugLogModeT mode )
+{
+    __atomic_store_n( &_log_mode, mode, __ATOMIC_RELAXED );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Debug - Do Log
 // ==============
@@ -99,22 +219,193 @@ bool sm_debug_do_log( const char* file_name, SmDebugLogLevelT level )
 // ****************************************************************************
 
 // ****************************************************************************
-// Debug - Log
+// Debug - Do Record
+// =================
+bool sm_debug_do_record( const char* file_name, SmDebugLogLevelT level )
+{
+    return(( level <= _log_level )||
+           (( _initialized )&&( level <= SM_DEBUG_FLIGHT_RECORDER_LOG_LEVEL )));
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Ring Put
+// ================
+// Copies a log record into the ring, never blocks.  Returns false and
+// counts a drop if the ring is full.
+static bool sm_debug_ring_put( SmDebugRingT* ring, SmDebugThreadMsgTypeT type,
+    uint64_t seqnum, const struct timespec* ts_mono,
+    const struct timespec* ts_real, const char data[], int data_len )
+{
+    SmDebugThreadRecordT* record;
+    uint32_t size = SM_DEBUG_RING_ALIGN( sizeof(SmDebugThreadRecordT)
+                                         + data_len + 1 );
+    uint64_t head = ring->head;
+    uint64_t tail = __atomic_load_n( &(ring->tail), __ATOMIC_ACQUIRE );
+    uint32_t offset = head & (SM_DEBUG_RING_SIZE-1);
+    uint32_t pad = 0;
+
+    if( offset + size > SM_DEBUG_RING_SIZE )
+    {
+        // Records are contiguous, skip the remainder of the buffer.
+        pad = SM_DEBUG_RING_SIZE - offset;
+    }
+
+    if( head + pad + size - tail > SM_DEBUG_RING_SIZE )
+    {
+        __atomic_add_fetch( &(ring->dropped), 1, __ATOMIC_RELAXED );
+        return( false );
+    }
+
+    if( 0 < pad )
+    {
+        record = (SmDebugThreadRecordT*) &(ring->buffer[offset]);
+        record->size = pad;
+        record->type = SM_DEBUG_THREAD_MSG_PAD;
+        head += pad;
+        offset = 0;
+    }
+
+    record = (SmDebugThreadRecordT*) &(ring->buffer[offset]);
+    record->size = size;
+    record->type = type;
+    record->seqnum = seqnum;
+    record->ts_mono = *ts_mono;
+    record->ts_real = *ts_real;
+    memcpy( (char*) (record+1), data, data_len );
+    ((char*) (record+1))[data_len] = '\0';
+
+    __atomic_store_n( &(ring->head), head + size, __ATOMIC_RELEASE );
+    ++(ring->logged);
+
+    // Wake the debug thread early only when a burst fills half the ring,
+    // otherwise it drains on its own tick.
+    if(( head - tail < SM_DEBUG_RING_SIZE/2 )&&
+       ( head + size - tail >= SM_DEBUG_RING_SIZE/2 )&&( -1 < _event_fd ))
+    {
+        uint64_t count = 1;
+        if( 0 > write( _event_fd, &count, sizeof(count) ) )
+        {
+            // Debug thread is already signalled.
+        }
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Put
 // ===========
-void sm_debug_log( SmDebugLogTypeT type, const char* format, ... ) 
+static void sm_debug_put( SmDebugThreadInfoT* info, SmDebugThreadMsgTypeT type,
+    uint64_t seqnum, const struct timespec* ts_mono,
+    const struct timespec* ts_real, const char data[], int data_len )
 {
-    SmDebugThreadInfoT* info = NULL;
-    SmDebugThreadMsgT msg;
-    va_list arguments;
+    if( NULL != info )
+    {
+        sm_debug_ring_put( &(info->ring), type, seqnum, ts_mono, ts_real,
+                           data, data_len );
 
-    memset( &msg, 0, sizeof(msg) );
+    } else if( 0 == pthread_mutex_trylock( &_shared_ring_mutex ) ) {
+        sm_debug_ring_put( &_shared_ring, type, seqnum, ts_mono, ts_real,
+                           data, data_len );
+        pthread_mutex_unlock( &_shared_ring_mutex );
+
+    } else {
+        __atomic_add_fetch( &(_shared_ring.dropped), 1, __ATOMIC_RELAXED );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Flight Record
+// =====================
+// Overwrites the oldest entry of the recorder.  An entry's timestamp is
+// zero while it is written, readers discard entries that change under
+// them.
+static void sm_debug_flight_record( SmDebugFlightRecorderT* recorder,
+    SmDebugThreadMsgTypeT type, const struct timespec* ts_mono,
+    const char* format, va_list arguments )
+{
+    SmDebugFlightEntryT* entry;
+    uint32_t format_id = SM_DEBUG_BINARY_FORMATS_MAX;
+    int args_len;
+
+    entry = &(recorder->entries[recorder->next
+                                & (SM_DEBUG_FLIGHT_RECORDER_ENTRIES-1)]);
+
+    __atomic_store_n( &(entry->mono_ns), 0, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+
+    args_len = sm_debug_binary_encode( format, arguments, &format_id,
+                                       entry->args, sizeof(entry->args) );
+    if( SM_DEBUG_BINARY_FORMATS_MAX <= format_id )
+    {
+        return;
+    }
+
+    entry->format_id = format_id;
+    entry->log_type = type;
+
+    if( 0 > args_len )
+    {
+        // Kept as the bare format, the decoder shows it unformatted.
+        entry->args_len = 0;
+        entry->truncated = 1;
+    } else {
+        entry->args_len = args_len;
+        entry->truncated = 0;
+    }
+
+    __atomic_store_n( &(entry->mono_ns),
+                      (int64_t) ts_mono->tv_sec * 1000000000LL
+                      + ts_mono->tv_nsec, __ATOMIC_RELEASE );
+    __atomic_store_n( &(recorder->next), recorder->next + 1,
+                      __ATOMIC_RELEASE );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Flight Put
+// ==================
+static void sm_debug_flight_put( SmDebugThreadInfoT* info,
+    SmDebugThreadMsgTypeT type, const struct timespec* ts_mono,
+    const char* format, va_list arguments )
+{
+    if( NULL != info )
+    {
+        sm_debug_flight_record( &(info->flight), type, ts_mono, format,
+                                arguments );
+
+    } else if( 0 == pthread_mutex_trylock( &_shared_flight_mutex ) ) {
+        sm_debug_flight_record( &_shared_flight, type, ts_mono, format,
+                                arguments );
+        pthread_mutex_unlock( &_shared_flight_mutex );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Log Arguments
+// =====================
+static void sm_debug_vlog( SmDebugLogTypeT type, bool do_log, bool do_record,
+    const char* format, va_list arguments )
+{
+    SmDebugThreadInfoT* info = NULL;
+    SmDebugThreadMsgTypeT msg_type;
+    uint64_t seqnum;
+    struct timespec ts_mono, ts_real;
+    char data[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+    int data_len;
+    va_list copy;
 
     if( !_initialized )
     {
-        va_start( arguments, format );
-        vsnprintf( msg.u.log.data, sizeof(msg.u.log.data), format, arguments );
-        va_end( arguments );
-        printf( "%s\n", msg.u.log.data );
+        if( do_log )
+        {
+            vsnprintf( data, sizeof(data), format, arguments );
+            printf( "%s\n", data );
+        }
         return;
     }
 
@@ -122,36 +413,120 @@ void sm_debug_log( SmDebugLogTypeT type, const char* format, ... )
 
     if( SM_DEBUG_SCHED_LOG == type )
     {
-        msg.type = SM_DEBUG_THREAD_MSG_SCHED_LOG;
-        msg.u.log.seqnum = 0;
-
+        msg_type = SM_DEBUG_THREAD_MSG_SCHED_LOG;
     } else if (SM_DEBUG_SERVICE_LOG == type) {
-        msg.type = SM_DEBUG_THREAD_MSG_SERVICE_LOG;
+        msg_type = SM_DEBUG_THREAD_MSG_SERVICE_LOG;
+    } else {
+        msg_type = SM_DEBUG_THREAD_MSG_LOG;
+    }
 
-        if( NULL != info )
-            msg.u.log.seqnum = ++(info->service_log_seqnum);
-        else
-            msg.u.log.seqnum = 0;
+    clock_gettime( CLOCK_MONOTONIC_RAW, &ts_mono );
+
+    if( do_record )
+    {
+        va_copy( copy, arguments );
+        sm_debug_flight_put( info, msg_type, &ts_mono, format, copy );
+        va_end( copy );
+    }
+
+    if( !do_log )
+    {
+        return;
+    }
+
+    if(( NULL == info )||( SM_DEBUG_THREAD_MSG_SCHED_LOG == msg_type ))
+    {
+        seqnum = 0;
+    } else if( SM_DEBUG_THREAD_MSG_SERVICE_LOG == msg_type ) {
+        seqnum = ++(info->service_log_seqnum);
     } else {
-        msg.type = SM_DEBUG_THREAD_MSG_LOG;
+        seqnum = ++(info->log_seqnum);
+    }
+
+    clock_gettime( CLOCK_REALTIME, &ts_real );
 
-        if( NULL != info )
-            msg.u.log.seqnum = ++(info->log_seqnum);
-        else
-            msg.u.log.seqnum = 0;
+    if(( SM_DEBUG_THREAD_MSG_SCHED_LOG != msg_type )&&
+       ( SM_DEBUG_LOG_MODE_BINARY == __atomic_load_n( &_log_mode,
+                                                      __ATOMIC_RELAXED ) ))
+    {
+        SmDebugBinaryLogT log;
+
+        va_copy( copy, arguments );
+        data_len = sm_debug_binary_encode( format, copy, &(log.format_id),
+                                           &(data[sizeof(log)]),
+                                           sizeof(data) - sizeof(log) );
+        va_end( copy );
+
+        if( 0 <= data_len )
+        {
+            log.log_type = msg_type;
+            log.args_len = data_len;
+            memcpy( data, &log, sizeof(log) );
+
+            sm_debug_put( info, SM_DEBUG_THREAD_MSG_BINARY_LOG, seqnum,
+                          &ts_mono, &ts_real, data,
+                          sizeof(log) + data_len );
+            return;
+        }
     }
 
-    clock_gettime( CLOCK_MONOTONIC_RAW, &(msg.u.log.ts_mono) );
-    clock_gettime( CLOCK_REALTIME, &(msg.u.log.ts_real) );
+    data_len = vsnprintf( data, sizeof(data), format, arguments );
+
+    if( 0 > data_len )
+    {
+        return;
+    } else if( (int) sizeof(data) <= data_len ) {
+        data_len = sizeof(data) - 1;
+    }
+
+    sm_debug_put( info, msg_type, seqnum, &ts_mono, &ts_real, data,
+                  data_len );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Log
+// ===========
+void sm_debug_log( SmDebugLogTypeT type, const char* format, ... ) 
+{
+    va_list arguments;
+
+    va_start( arguments, format );
+    sm_debug_vlog( type, true, false, format, arguments );
+    va_end( arguments );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Log At
+// ==============
+void sm_debug_log_at( SmDebugLogLevelT level, SmDebugLogTypeT type,
+    const char* format, ... )
+{
+    va_list arguments;
 
     va_start( arguments, format );
-    vsnprintf( msg.u.log.data, sizeof(msg.u.log.data), format, arguments );
+    sm_debug_vlog( type, level <= _log_level,
+                   level <= SM_DEBUG_FLIGHT_RECORDER_LOG_LEVEL,
+                   format, arguments );
     va_end( arguments );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Scheduler Log Hash
+// ==========================
+static uint32_t sm_debug_sched_log_hash( const char data[] )
+{
+    uint32_t hash = 2166136261U;
 
-    if( -1 < _client_fd )
+    for( ; '\0' != *data; ++data )
     {
-        send( _client_fd, &msg, sizeof(msg), 0 );
+        hash ^= (uint8_t) *data;
+        hash *= 16777619U;
     }
+
+    return( hash );
 }
 // ****************************************************************************
 
@@ -160,27 +535,38 @@ void sm_debug_log( SmDebugLogTypeT type, const char* format, ... )
 // =====================
 void sm_debug_sched_log( SmDebugLogTypeT type, const char* format, ... )
 {
-    SmDebugThreadMsgT* msg = &(_sched_logs[_sched_log_set][_sched_log_num]);
+    SmDebugThreadMsgT* msg;
     va_list arguments;
 
-    memset( msg, 0, sizeof(SmDebugThreadMsgT) );
+    if( !_initialized )
+    {
+        return;
+    }
 
-    if( _initialized )
+    if( SCHED_LOGS_MAX <= _sched_log.num )
     {
-        msg->type = SM_DEBUG_THREAD_MSG_SCHED_LOG;
-        msg->u.log.seqnum = 0;
+        ++_sched_log_dropped;
+        return;
+    }
 
-        clock_gettime( CLOCK_MONOTONIC_RAW, &(msg->u.log.ts_mono) );
-        clock_gettime( CLOCK_REALTIME, &(msg->u.log.ts_real) );
+    msg = &(_sched_log.logs[_sched_log.num]);
 
-        va_start( arguments, format );
-        vsnprintf( msg->u.log.data, sizeof(msg->u.log.data), format,
-                   arguments );
-        va_end( arguments );
+    memset( msg, 0, sizeof(SmDebugThreadMsgT) );
 
-        if( _sched_log_num < SCHED_LOGS_MAX )
-            ++_sched_log_num;
-    }
+    msg->type = SM_DEBUG_THREAD_MSG_SCHED_LOG;
+    msg->u.log.seqnum = 0;
+
+    clock_gettime( CLOCK_MONOTONIC_RAW, &(msg->u.log.ts_mono) );
+    clock_gettime( CLOCK_REALTIME, &(msg->u.log.ts_real) );
+
+    va_start( arguments, format );
+    vsnprintf( msg->u.log.data, sizeof(msg->u.log.data), format,
+               arguments );
+    va_end( arguments );
+
+    _sched_log.hashes[_sched_log.num] = sm_debug_sched_log_hash(
+                                                        msg->u.log.data );
+    ++_sched_log.num;
 }
 // ****************************************************************************
 
@@ -189,68 +575,568 @@ void sm_debug_sched_log( SmDebugLogTypeT type, const char* format, ... )
 // ===========================
 void sm_debug_sched_log_start( char* domain )
 {
-    if( 0 == _sched_log_set )
+    _sched_log.num = 0;
+    _sched_log_dropped = 0;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Scheduler Log Find Domain
+// =================================
+static SmDebugSchedLogDomainT* sm_debug_sched_log_find_domain(
+    const char domain[] )
+{
+    SmDebugSchedLogDomainT* entry;
+    SmDebugSchedLogDomainT* free_entry = NULL;
+
+    int domain_i;
+    for( domain_i=0; SCHED_LOG_DOMAINS_MAX > domain_i; ++domain_i )
     {
-        _sched_log_set = 1;
-    } else {
-        _sched_log_set = 0;
+        entry = &(_sched_log_domains[domain_i]);
+
+        if( !entry->inuse )
+        {
+            if( NULL == free_entry )
+                free_entry = entry;
+
+        } else if( 0 == strncmp( domain, entry->domain,
+                                 sizeof(entry->domain) ) ) {
+            return( entry );
+        }
+    }
+
+    if( NULL == free_entry )
+    {
+        // More domains than expected, share the last one; passes of
+        // the domains then show up as differences of each other.
+        free_entry = &(_sched_log_domains[SCHED_LOG_DOMAINS_MAX-1]);
+    }
+
+    memset( free_entry, 0, sizeof(SmDebugSchedLogDomainT) );
+    free_entry->inuse = true;
+    snprintf( free_entry->domain, sizeof(free_entry->domain), "%s", domain );
+
+    return( free_entry );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Scheduler Log Put
+// =========================
+static void sm_debug_sched_log_put( const SmDebugThreadMsgT* msg,
+    const char prefix[] )
+{
+    char data[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+    int data_len;
+
+    data_len = snprintf( data, sizeof(data), "%s%s", prefix,
+                         msg->u.log.data );
+    if( (int) sizeof(data) <= data_len )
+    {
+        data_len = sizeof(data) - 1;
     }
 
-    _sched_log_num = 0;
-    memset( &(_sched_logs[_sched_log_set][0]), 0, sizeof(SmDebugSchedLogSetT) );
+    sm_debug_put( (SmDebugThreadInfoT*) pthread_getspecific( _thread_key ),
+                  SM_DEBUG_THREAD_MSG_SCHED_LOG, 0, &(msg->u.log.ts_mono),
+                  &(msg->u.log.ts_real), data, data_len );
 }
 // ****************************************************************************
 
 // ****************************************************************************
 // Debug - Scheduler Log Done
 // ==========================
+// Logs the lines of the pass that differ from the previous pass of the
+// domain, "+" for new or changed lines and "-" for the lines they replace.
+// Every SCHED_LOG_SNAPSHOT_PASSES passes, and on the first pass, all the
+// lines are logged so the full picture is never far back in the log.
 void sm_debug_sched_log_done( char* domain )
 {
-    if( -1 < _client_fd )
+    SmDebugSchedLogDomainT* entry;
+    SmDebugSchedLogT* prev;
+    SmDebugThreadMsgT removed;
+    bool prev_matched[SCHED_LOGS_MAX];
+    bool cur_matched[SCHED_LOGS_MAX];
+    int cur_i, prev_i;
+
+    if( !_initialized )
     {
-        bool changes = false;
-        SmDebugThreadMsgT* msg_lhs;
-        SmDebugThreadMsgT* msg_rhs;
+        return;
+    }
+
+    entry = sm_debug_sched_log_find_domain( domain );
+    prev = &(entry->prev);
+
+    memset( &_sched_log_stats, 0, sizeof(_sched_log_stats) );
+    _sched_log_stats.lines = _sched_log.num;
+    _sched_log_stats.dropped = _sched_log_dropped;
+    _sched_log_stats.snapshot
+        = (0 == (entry->passes % SCHED_LOG_SNAPSHOT_PASSES));
 
-        int sched_log_i;
-        for( sched_log_i=0; SCHED_LOGS_MAX > sched_log_i; ++sched_log_i )
+    ++entry->passes;
+
+    if( _sched_log_stats.snapshot )
+    {
+        for( cur_i=0; _sched_log.num > cur_i; ++cur_i )
         {
-            msg_lhs =  &(_sched_logs[0][sched_log_i]);
-            msg_rhs =  &(_sched_logs[1][sched_log_i]);
+            sm_debug_sched_log_put( &(_sched_log.logs[cur_i]), "" );
+        }
+
+        memcpy( prev, &_sched_log, sizeof(SmDebugSchedLogT) );
+        return;
+    }
 
-            if( 0 != memcmp( &(msg_lhs->u.log.data[0]),
-                             &(msg_rhs->u.log.data[0]),
-                             SM_DEBUG_THREAD_LOG_MAX_CHARS ) )
+    memset( prev_matched, 0, sizeof(prev_matched) );
+    memset( cur_matched, 0, sizeof(cur_matched) );
+
+    for( cur_i=0; _sched_log.num > cur_i; ++cur_i )
+    {
+        for( prev_i=0; prev->num > prev_i; ++prev_i )
+        {
+            if(( !prev_matched[prev_i] )&&
+               ( _sched_log.hashes[cur_i] == prev->hashes[prev_i] )&&
+               ( 0 == strcmp( _sched_log.logs[cur_i].u.log.data,
+                              prev->logs[prev_i].u.log.data ) ))
             {
-                changes = true;
+                prev_matched[prev_i] = true;
+                cur_matched[cur_i] = true;
                 break;
             }
         }
+    }
+
+    memset( &removed, 0, sizeof(removed) );
+    clock_gettime( CLOCK_MONOTONIC_RAW, &(removed.u.log.ts_mono) );
+    clock_gettime( CLOCK_REALTIME, &(removed.u.log.ts_real) );
+
+    for( prev_i=0; prev->num > prev_i; ++prev_i )
+    {
+        if( !prev_matched[prev_i] )
+        {
+            memcpy( removed.u.log.data, prev->logs[prev_i].u.log.data,
+                    sizeof(removed.u.log.data) );
+            sm_debug_sched_log_put( &removed, "- " );
+            ++_sched_log_stats.removed;
+        }
+    }
 
-        if( changes )
+    for( cur_i=0; _sched_log.num > cur_i; ++cur_i )
+    {
+        if( !cur_matched[cur_i] )
         {
-            SmDebugThreadMsgT* msg;
+            sm_debug_sched_log_put( &(_sched_log.logs[cur_i]), "+ " );
+            ++_sched_log_stats.added;
+        }
+    }
 
-            for( sched_log_i=0; _sched_log_num > sched_log_i; ++sched_log_i )
-            {
-                if( sched_log_i >= SCHED_LOGS_MAX )
-                    break;
+    memcpy( prev, &_sched_log, sizeof(SmDebugSchedLogT) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Scheduler Log Pass
+// ==========================
+void sm_debug_sched_log_pass( const char* format, ... )
+{
+    char data[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+    struct timespec ts_mono, ts_real;
+    va_list arguments;
+    int data_len;
+
+    if( !_initialized )
+    {
+        return;
+    }
+
+    clock_gettime( CLOCK_MONOTONIC_RAW, &ts_mono );
+    clock_gettime( CLOCK_REALTIME, &ts_real );
+
+    va_start( arguments, format );
+    data_len = vsnprintf( data, sizeof(data), format, arguments );
+    va_end( arguments );
+
+    if(( 0 <= data_len )&&( (int) sizeof(data) > data_len ))
+    {
+        data_len += snprintf( &(data[data_len]), sizeof(data) - data_len,
+                              " log(%s lines=%i added=%i removed=%i "
+                              "dropped=%i)", _sched_log_stats.snapshot
+                              ? "snapshot" : "diff",
+                              _sched_log_stats.lines, _sched_log_stats.added,
+                              _sched_log_stats.removed,
+                              _sched_log_stats.dropped );
+    }
+
+    if(( 0 > data_len )||( (int) sizeof(data) <= data_len ))
+    {
+        data_len = strnlen( data, sizeof(data) - 1 );
+    }
+
+    sm_debug_put( (SmDebugThreadInfoT*) pthread_getspecific( _thread_key ),
+                  SM_DEBUG_THREAD_MSG_SCHED_LOG, 0, &ts_mono, &ts_real,
+                  data, data_len );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Ring Drain
+// ==================
+static void sm_debug_ring_drain( SmDebugRingT* ring, const char thread_name[],
+    SmDebugThreadDrainCallbackT callback )
+{
+    const SmDebugThreadRecordT* record;
+    uint64_t tail = ring->tail;
+    uint64_t head = __atomic_load_n( &(ring->head), __ATOMIC_ACQUIRE );
+
+    while( tail != head )
+    {
+        record = (const SmDebugThreadRecordT*)
+                 &(ring->buffer[tail & (SM_DEBUG_RING_SIZE-1)]);
+
+        if( SM_DEBUG_THREAD_MSG_PAD != record->type )
+        {
+            callback( record, (const char*) (record+1) );
+        }
+
+        tail += record->size;
+        __atomic_store_n( &(ring->tail), tail, __ATOMIC_RELEASE );
+    }
+
+    uint64_t dropped = __atomic_load_n( &(ring->dropped), __ATOMIC_RELAXED );
+    if( dropped != ring->dropped_reported )
+    {
+        char data[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+        SmDebugThreadRecordT report;
+
+        memset( &report, 0, sizeof(report) );
+        report.type = SM_DEBUG_THREAD_MSG_LOG;
+        clock_gettime( CLOCK_MONOTONIC_RAW, &(report.ts_mono) );
+        clock_gettime( CLOCK_REALTIME, &(report.ts_real) );
+        snprintf( data, sizeof(data), "ERROR: %s: dropped %" PRIu64
+                  " logs, log ring full, total dropped %" PRIu64 ".",
+                  thread_name, dropped - ring->dropped_reported, dropped );
+        callback( &report, data );
+
+        ring->dropped_reported = dropped;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Drain
+// =============
+void sm_debug_drain( SmDebugThreadDrainCallbackT callback )
+{
+    int thread_i;
+    for( thread_i=0; SM_THREADS_MAX > thread_i; ++thread_i )
+    {
+        SmDebugThreadInfoT* info = &(_thread_info[thread_i]);
+
+        if( __atomic_load_n( &(info->inuse), __ATOMIC_ACQUIRE ) )
+        {
+            sm_debug_ring_drain( &(info->ring), info->thread_identifier,
+                                 callback );
+        }
+    }
+
+    sm_debug_ring_drain( &_shared_ring, "unknown", callback );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Dropped
+// ===============
+uint64_t sm_debug_dropped( void )
+{
+    uint64_t dropped;
+
+    dropped = __atomic_load_n( &(_shared_ring.dropped), __ATOMIC_RELAXED );
+
+    int thread_i;
+    for( thread_i=0; SM_THREADS_MAX > thread_i; ++thread_i )
+    {
+        dropped += __atomic_load_n( &(_thread_info[thread_i].ring.dropped),
+                                    __ATOMIC_RELAXED );
+    }
+
+    return( dropped );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Flight Read
+// ===================
+// Copies the next intact entry before end, entries overwritten while
+// being copied are skipped.
+static bool sm_debug_flight_read( const SmDebugFlightRecorderT* recorder,
+    uint64_t* cursor, uint64_t end, SmDebugFlightEntryT* entry )
+{
+    const SmDebugFlightEntryT* slot;
+    int64_t mono_ns;
+
+    while( *cursor < end )
+    {
+        slot = &(recorder->entries[*cursor
+                                   & (SM_DEBUG_FLIGHT_RECORDER_ENTRIES-1)]);
+        ++(*cursor);
+
+        mono_ns = __atomic_load_n( &(slot->mono_ns), __ATOMIC_ACQUIRE );
+        memcpy( entry, slot, sizeof(SmDebugFlightEntryT) );
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+
+        if(( 0 != mono_ns )&&
+           ( mono_ns == __atomic_load_n( &(slot->mono_ns), __ATOMIC_RELAXED ) ))
+        {
+            entry->mono_ns = mono_ns;
+            return( true );
+        }
+    }
+
+    return( false );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Flight For Each
+// =======================
+// Walks the entries of all flight recorders oldest first.
+static void sm_debug_flight_foreach( SmDebugFlightCallbackT callback,
+    void* user_data )
+{
+    const SmDebugFlightRecorderT* recorders[SM_THREADS_MAX+1];
+    SmDebugFlightEntryT entries[SM_THREADS_MAX+1];
+    uint64_t cursor[SM_THREADS_MAX+1];
+    uint64_t end[SM_THREADS_MAX+1];
+    bool valid[SM_THREADS_MAX+1];
+    struct timespec ts_mono, ts_real;
+    int64_t real_offset_ns;
+    int num_recorders = 0;
+
+    clock_gettime( CLOCK_MONOTONIC_RAW, &ts_mono );
+    clock_gettime( CLOCK_REALTIME, &ts_real );
+
+    real_offset_ns = ((int64_t) ts_real.tv_sec - ts_mono.tv_sec) * 1000000000LL
+                   + (ts_real.tv_nsec - ts_mono.tv_nsec);
+
+    int thread_i;
+    for( thread_i=0; SM_THREADS_MAX > thread_i; ++thread_i )
+    {
+        if( __atomic_load_n( &(_thread_info[thread_i].inuse),
+                             __ATOMIC_ACQUIRE ) )
+        {
+            recorders[num_recorders++] = &(_thread_info[thread_i].flight);
+        }
+    }
+    recorders[num_recorders++] = &_shared_flight;
+
+    int recorder_i;
+    for( recorder_i=0; num_recorders > recorder_i; ++recorder_i )
+    {
+        end[recorder_i] = __atomic_load_n( &(recorders[recorder_i]->next),
+                                           __ATOMIC_ACQUIRE );
+        cursor[recorder_i] = 0;
+        if( SM_DEBUG_FLIGHT_RECORDER_ENTRIES < end[recorder_i] )
+        {
+            cursor[recorder_i] = end[recorder_i]
+                               - SM_DEBUG_FLIGHT_RECORDER_ENTRIES;
+        }
+        valid[recorder_i] = sm_debug_flight_read( recorders[recorder_i],
+                                &(cursor[recorder_i]), end[recorder_i],
+                                &(entries[recorder_i]) );
+    }
 
-                msg =  &(_sched_logs[_sched_log_set][sched_log_i]);
+    while( true )
+    {
+        int oldest = -1;
 
-                send( _client_fd, msg, sizeof(SmDebugThreadMsgLogT), 0 );
+        for( recorder_i=0; num_recorders > recorder_i; ++recorder_i )
+        {
+            if(( valid[recorder_i] )&&
+               (( 0 > oldest )||
+                ( entries[recorder_i].mono_ns < entries[oldest].mono_ns )))
+            {
+                oldest = recorder_i;
             }
-            _print_sched_log = true;
         }
-        else {
-            if (_print_sched_log)
+
+        if( 0 > oldest )
+        {
+            break;
+        }
+
+        callback( &(entries[oldest]), real_offset_ns, user_data );
+
+        valid[oldest] = sm_debug_flight_read( recorders[oldest],
+                                              &(cursor[oldest]), end[oldest],
+                                              &(entries[oldest]) );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Flight Writer Flush
+// ===========================
+static void sm_debug_flight_writer_flush( SmDebugFlightWriterT* writer )
+{
+    int offset = 0;
+
+    while( writer->len > offset )
+    {
+        ssize_t result = write( writer->fd, &(writer->buffer[offset]),
+                                writer->len - offset );
+        if( 0 > result )
+        {
+            if( EINTR == errno )
             {
-                sm_debug_log( SM_DEBUG_SCHED_LOG, "%s: no scheduling changes "
-                              "required.", domain );
-                _print_sched_log = false;
+                continue;
             }
+            break;
         }
+        offset += result;
+    }
+
+    writer->len = 0;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Flight Writer Put
+// =========================
+static void sm_debug_flight_writer_put( SmDebugFlightWriterT* writer,
+    SmDebugBinaryRecordKindT kind, uint8_t log_type, uint32_t format_id,
+    int64_t mono_ns, int64_t real_ns, const char args[], uint16_t args_len )
+{
+    SmDebugBinaryRecordT record;
+
+    if( (int) sizeof(writer->buffer) - writer->len
+        < (int) sizeof(record) + args_len )
+    {
+        sm_debug_flight_writer_flush( writer );
+
+        if( (int) sizeof(writer->buffer) < (int) sizeof(record) + args_len )
+        {
+            return;
+        }
+    }
+
+    memset( &record, 0, sizeof(record) );
+    record.kind = kind;
+    record.log_type = log_type;
+    record.args_len = args_len;
+    record.format_id = format_id;
+    record.mono_ns = mono_ns;
+    record.real_ns = real_ns;
+
+    memcpy( &(writer->buffer[writer->len]), &record, sizeof(record) );
+    memcpy( &(writer->buffer[writer->len+sizeof(record)]), args, args_len );
+    writer->len += sizeof(record) + args_len;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Flight Save Entry
+// =========================
+static void sm_debug_flight_save_entry( const SmDebugFlightEntryT* entry,
+    int64_t real_offset_ns, void* user_data )
+{
+    SmDebugFlightWriterT* writer = (SmDebugFlightWriterT*) user_data;
+    const char* format = sm_debug_binary_format( entry->format_id );
+
+    if( NULL == format )
+    {
+        return;
+    }
+
+    if( !writer->format_written[entry->format_id] )
+    {
+        sm_debug_flight_writer_put( writer, SM_DEBUG_BINARY_RECORD_FORMAT,
+                                    0, entry->format_id, 0, 0, format,
+                                    (uint16_t) strnlen( format,
+                                                        UINT16_MAX ) );
+        writer->format_written[entry->format_id] = true;
+    }
+
+    sm_debug_flight_writer_put( writer, SM_DEBUG_BINARY_RECORD_LOG,
+                                entry->log_type, entry->format_id,
+                                entry->mono_ns,
+                                entry->mono_ns + real_offset_ns,
+                                entry->args, entry->args_len );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Flight Recorder Save
+// ============================
+void sm_debug_flight_recorder_save( const char filename[] )
+{
+    SmDebugFlightWriterT* writer = &_flight_writer;
+    int fd;
+
+    if( !__sync_bool_compare_and_swap( &_flight_saving, 0, 1 ) )
+    {
+        return;
     }
+
+    fd = open( filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+               S_IRUSR | S_IWUSR | S_IRGRP );
+    if( 0 <= fd )
+    {
+        writer->fd = fd;
+        writer->len = 0;
+        memset( writer->format_written, 0, sizeof(writer->format_written) );
+
+        sm_debug_flight_writer_put( writer, SM_DEBUG_BINARY_RECORD_SESSION,
+                                    0, SM_DEBUG_BINARY_VERSION, 0, 0,
+                                    SM_DEBUG_BINARY_MAGIC,
+                                    strlen( SM_DEBUG_BINARY_MAGIC ) );
+
+        sm_debug_flight_foreach( sm_debug_flight_save_entry, writer );
+
+        sm_debug_flight_writer_flush( writer );
+        close( fd );
+    }
+
+    __sync_lock_release( &_flight_saving );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Flight Dump Entry
+// =========================
+static void sm_debug_flight_dump_entry( const SmDebugFlightEntryT* entry,
+    int64_t real_offset_ns, void* user_data )
+{
+    FILE* log = (FILE*) user_data;
+    const char* format = sm_debug_binary_format( entry->format_id );
+    char text[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+
+    if( NULL == format )
+    {
+        return;
+    }
+
+    if(( entry->truncated )||
+       ( SM_OKAY != sm_debug_binary_decode( format, entry->args,
+                                            entry->args_len, text,
+                                            sizeof(text) ) ))
+    {
+        snprintf( text, sizeof(text), "[arguments not recorded] %s",
+                  format );
+    }
+
+    fprintf( log, "  time[%" PRIi64 ".%03" PRIi64 "] %s\n",
+             entry->mono_ns / 1000000000,
+             (entry->mono_ns % 1000000000) / 1000000, text );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Flight Recorder Dump Data
+// =================================
+void sm_debug_flight_recorder_dump_data( FILE* log )
+{
+    fprintf( log, "--------------------------------------------------------------------\n" );
+    fprintf( log, "DEBUG FLIGHT RECORDER DATA\n" );
+    sm_debug_flight_foreach( sm_debug_flight_dump_entry, log );
+    fprintf( log, "--------------------------------------------------------------------\n" );
 }
 // ****************************************************************************
 
@@ -281,7 +1167,7 @@ void sm_debug_set_thread_info( void )
     for( thread_i=0; SM_THREADS_MAX > thread_i; ++thread_i )
     {
         info = &(_thread_info[thread_i]);
-        if( !(info->inuse) )
+        if( __sync_bool_compare_and_swap( &(info->claimed), false, true ) )
         {
             info->log_seqnum = 0;
             info->service_log_seqnum = 0;
@@ -290,7 +1176,7 @@ void sm_debug_set_thread_info( void )
             info->thread_id = (int) syscall(SYS_gettid);
             snprintf( info->thread_identifier, sizeof(info->thread_identifier),
                       "%s[%i]", info->thread_name, info->thread_id );
-            info->inuse = true;
+            __atomic_store_n( &(info->inuse), true, __ATOMIC_RELEASE );
 
             pthread_setspecific( _thread_key, info );
             break;
@@ -304,71 +1190,25 @@ void sm_debug_set_thread_info( void )
 // ==================
 SmErrorT sm_debug_initialize( void )
 {
-    int flags;
-    int sockets[2];
-    int buffer_len = 1048576;
-    int result;
     SmErrorT error;
 
     memset( _thread_info, 0, sizeof(_thread_info) );
+    memset( &_shared_ring, 0, sizeof(_shared_ring) );
+    memset( &_shared_flight, 0, sizeof(_shared_flight) );
 
     pthread_key_create( &_thread_key, NULL );
 
     sm_debug_set_thread_info();
 
-    result = socketpair( AF_UNIX, SOCK_DGRAM, 0, sockets );
-    if( 0 > result )
+    _event_fd = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+    if( 0 > _event_fd )
     {
-        printf( "Failed to create debug communication sockets, error=%s.\n",
+        printf( "Failed to create debug event file descriptor, error=%s.\n",
                 strerror( errno ) );
         return( SM_FAILED );
     }
 
-    int socket_i;
-    for( socket_i=0; socket_i < 2; ++socket_i )
-    {
-        flags = fcntl( sockets[socket_i] , F_GETFL, 0 );
-        if( 0 > flags )
-        {
-            printf( "Failed to get debug communication socket (%i) flags, "
-                    "error=%s.\n", socket_i, strerror( errno ) );
-            return( SM_FAILED );
-        }
-
-        result = fcntl( sockets[socket_i], F_SETFL, flags | O_NONBLOCK );
-        if( 0 > result )
-        {
-            printf( "Failed to set debug communication socket (%i) to "
-                    "non-blocking, error=%s.\n", socket_i, 
-                      strerror( errno ) );
-            return( SM_FAILED );
-        }
-
-        result = setsockopt( sockets[socket_i], SOL_SOCKET, SO_SNDBUF,
-                             &buffer_len, sizeof(buffer_len) );
-        if( 0 > result )
-        {
-            printf( "Failed to set debug communication socket (%i) "
-                    "send buffer length (%i), error=%s.\n", socket_i,
-                    buffer_len, strerror( errno ) );
-            return( SM_FAILED );
-        }
-
-        result = setsockopt( sockets[socket_i], SOL_SOCKET, SO_RCVBUF,
-                             &buffer_len, sizeof(buffer_len) );
-        if( 0 > result )
-        {
-            printf( "Failed to set debug communication socket (%i) "
-                    "receive buffer length (%i), error=%s.\n", socket_i,
-                    buffer_len, strerror( errno ) );
-            return( SM_FAILED );
-        }
-    }
-
-    _server_fd = sockets[0];
-    _client_fd = sockets[1];
-
-    error = sm_debug_thread_start( _server_fd );
+    error = sm_debug_thread_start( _event_fd );
     if( SM_OKAY != error )
     {
         printf( "Failed to start debug thread, error=%s.\n",
@@ -376,9 +1216,10 @@ SmErrorT sm_debug_initialize( void )
         return( error );
     }
 
-    _sched_log_set = 0;
-    _sched_log_num = 0;
-    memset( _sched_logs, 0, sizeof(_sched_logs) );
+    _sched_log_dropped = 0;
+    memset( &_sched_log, 0, sizeof(_sched_log) );
+    memset( &_sched_log_stats, 0, sizeof(_sched_log_stats) );
+    memset( _sched_log_domains, 0, sizeof(_sched_log_domains) );
 
     _initialized = true;
 
@@ -402,21 +1243,16 @@ SmErrorT sm_debug_finalize( void )
 
     memset( _thread_info, 0, sizeof(_thread_info) );
     
-    if( -1 < _server_fd )
-    {
-        close( _server_fd );
-        _server_fd = -1;
-    }
-
-    if( -1 < _client_fd )
+    if( -1 < _event_fd )
     {
-        close( _client_fd );
-        _client_fd = -1;
+        close( _event_fd );
+        _event_fd = -1;
     }
 
-    _sched_log_set = 0;
-    _sched_log_num = 0;
-    memset( _sched_logs, 0, sizeof(_sched_logs) );
+    _sched_log_dropped = 0;
+    memset( &_sched_log, 0, sizeof(_sched_log) );
+    memset( &_sched_log_stats, 0, sizeof(_sched_log_stats) );
+    memset( _sched_log_domains, 0, sizeof(_sched_log_domains) );
 
     _initialized = false;
 
@@ -6,6 +6,8 @@
 #ifndef __SM_DEBUG_H__
 #define __SM_DEBUG_H__
 
+#include <stdio.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 #include "sm_types.h"
@@ -21,6 +23,14 @@ typedef enum
     SM_DEBUG_SERVICE_LOG,
 } SmDebugLogTypeT;
 
+#define SM_DEBUG_FLIGHT_RECORDER_FILE_FORMAT    "/var/log/%s-flight-%s.bin"
+
+typedef enum
+{
+    SM_DEBUG_LOG_MODE_TEXT,
+    SM_DEBUG_LOG_MODE_BINARY,
+} SmDebugLogModeT;
+
 typedef enum
 {
     SM_DEBUG_LOG_LEVEL_ERROR,
@@ -41,12 +51,35 @@ extern const char* sm_debug_log_level_str( SmDebugLogLevelT level );
 extern void sm_debug_set_log_level( SmDebugLogLevelT level );
 // ****************************************************************************
 
+// ****************************************************************************
+// Debug - Log Mode String
+// =======================
+extern const char* sm_debug_log_mode_str( SmDebugLogModeT mode );
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Set Log Mode
+// ====================
+// In binary mode logs are not formatted by the logging thread, the format
+// and arguments are recorded and the debug thread writes them to the
+// binary log file for sm-debug-decode.  Scheduler logs stay text.
+extern void sm_debug_set_log_mode( SmDebugLogModeT mode );
+// ****************************************************************************
+
 // ****************************************************************************
 // Debug - Do Log
 // ==============
 extern bool sm_debug_do_log( const char* file_name, SmDebugLogLevelT level );
 // ****************************************************************************
 
+// ****************************************************************************
+// Debug - Do Record
+// =================
+// Debug level logs are kept in the flight recorder even when the log
+// level filters them out.
+extern bool sm_debug_do_record( const char* file_name, SmDebugLogLevelT level );
+// ****************************************************************************
+
 // ****************************************************************************
 // Debug - Log
 // ===========
@@ -56,6 +89,37 @@ __attribute__ ((format (printf, 2, 3)));
 // variable arguments start at parameter #3
 // ****************************************************************************
 
+// ****************************************************************************
+// Debug - Log At
+// ==============
+// Logs when the level passes the log level, and records into the calling
+// thread's flight recorder.
+extern void sm_debug_log_at( SmDebugLogLevelT level, SmDebugLogTypeT type,
+    const char* format, ... ) __attribute__ ((format (printf, 3, 4)));
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Dropped
+// ===============
+// Returns the number of logs dropped because a log ring was full.
+extern uint64_t sm_debug_dropped( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Flight Recorder Save
+// ============================
+// Writes the flight recorders to filename in the binary log format read by
+// sm-debug-decode.  Only uses async-signal-safe calls, so it can be called
+// from a crash handler.
+extern void sm_debug_flight_recorder_save( const char filename[] );
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug - Flight Recorder Dump Data
+// =================================
+extern void sm_debug_flight_recorder_dump_data( FILE* log );
+// ****************************************************************************
+
 // ****************************************************************************
 // Debug - Get Thread Information
 // ==============================
@@ -86,6 +150,15 @@ extern void sm_debug_sched_log_start( char* domain );
 extern void sm_debug_sched_log_done( char* domain );
 // ****************************************************************************
 
+// ****************************************************************************
+// Debug - Scheduler Log Pass
+// ==========================
+// Logs the summary of a scheduling pass, followed by how many lines the
+// pass logged and whether they were logged as a snapshot or a diff.
+extern void sm_debug_sched_log_pass( const char* format, ... )
+__attribute__ ((format (printf, 1, 2)));
+// ****************************************************************************
+
 // ****************************************************************************
 // Debug - Initialize
 // ==================
@@ -99,15 +172,16 @@ extern SmErrorT sm_debug_finalize( void );
 // ****************************************************************************
 
 #define DPRINTF_SVC( level, format, args... ) \
-    if( sm_debug_do_log( __FILE__, level ) ) \
-        sm_debug_log( SM_DEBUG_SERVICE_LOG, "%s: %s: %s(%i): " format, \
+    if( sm_debug_do_record( __FILE__, level ) ) \
+        sm_debug_log_at( level, SM_DEBUG_SERVICE_LOG, \
+                      "%s: %s: %s(%i): " format, \
                       sm_debug_log_level_str( level ), \
                       sm_debug_get_thread_info(), \
                       __FILE__, __LINE__, ##args )
 
 #define DPRINTF( level, format, args... ) \
-    if( sm_debug_do_log( __FILE__, level ) ) \
-        sm_debug_log( SM_DEBUG_LOG, "%s: %s: %s(%i): " format, \
+    if( sm_debug_do_record( __FILE__, level ) ) \
+        sm_debug_log_at( level, SM_DEBUG_LOG, "%s: %s: %s(%i): " format, \
                       sm_debug_log_level_str( level ), \
                       sm_debug_get_thread_info(), \
                       __FILE__, __LINE__, ##args )
@@ -140,6 +214,9 @@ extern SmErrorT sm_debug_finalize( void );
     sm_debug_sched_log( SM_DEBUG_SCHED_LOG, "%s: " format, domain, ##args ); \
     sm_debug_sched_log_done( domain )
 
+#define SCHED_LOG_PASS( domain, format, args... ) \
+    sm_debug_sched_log_pass( "%s: " format, domain, ##args )
+
 #ifdef __cplusplus
 }
 #endif
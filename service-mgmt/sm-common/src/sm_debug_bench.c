@@ -0,0 +1,467 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Measures the cost of a log call with one or more threads logging at
+// once, through the per-thread log rings and through the socketpair the
+// debug thread used to read from.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <syslog.h>
+#include <getopt.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <sys/socket.h>
+#include <pthread.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_debug_thread.h"
+
+#define SM_DEBUG_BENCH_LOGS                                          20000
+#define SM_DEBUG_BENCH_THREADS_MAX                    (SM_THREADS_MAX-1)
+#define SM_DEBUG_BENCH_SOCKET_BUFFER                               1048576
+#define SM_DEBUG_BENCH_POLL_INTERVAL_IN_MS                             100
+#define SM_DEBUG_BENCH_BURST                                            10
+#define SM_DEBUG_BENCH_BURST_PAUSE_IN_US                              1000
+
+typedef enum
+{
+    SM_DEBUG_BENCH_PATH_SOCKETPAIR,
+    SM_DEBUG_BENCH_PATH_RING,
+    SM_DEBUG_BENCH_PATH_RING_RECORDED,
+    SM_DEBUG_BENCH_PATH_MAX
+} SmDebugBenchPathT;
+
+typedef struct
+{
+    pthread_t thread;
+    SmDebugBenchPathT path;
+    unsigned int logs;
+    unsigned int burst;
+    int64_t wall_ns;
+    int64_t cpu_ns;
+} SmDebugBenchWriterT;
+
+static struct option _sm_debug_bench_long_options[] =
+{
+    { "logs",    required_argument, NULL, 'l'},
+    { "threads", required_argument, NULL, 't'},
+    { "burst",   required_argument, NULL, 'b'},
+    { "help",    no_argument,       NULL, 'h'},
+    {0, 0, 0, 0}
+};
+
+static const char* _path_names[SM_DEBUG_BENCH_PATH_MAX] =
+{
+    "socketpair", "ring", "ring+recorder"
+};
+
+static pthread_barrier_t _barrier;
+static int _server_fd = -1;
+static int _client_fd = -1;
+static uint64_t _socket_dropped = 0;
+static bool _reader_stay_on = false;
+
+// ****************************************************************************
+// Debug Benchmark - Usage
+// =======================
+static void usage( void )
+{
+    printf( " usage:\n"
+            "   sm-debug-bench [--logs <number>] [--threads <number>]\n"
+            "                  [--burst <number>] [--help]\n"
+            "       --logs    : logs per thread, defaults to %u\n"
+            "       --threads : threads logging at once, can be repeated,\n"
+            "                   defaults to 1 and 4, at most %u\n"
+            "       --burst   : logs per burst, defaults to %u, each thread\n"
+            "                   pauses %u us between bursts so the debug\n"
+            "                   thread keeps up, 0 logs without pausing\n"
+            "       --help    : print out this help message\n"
+            "\n"
+            "   Only the time spent in the log calls is counted.\n"
+            "\n", SM_DEBUG_BENCH_LOGS, SM_DEBUG_BENCH_THREADS_MAX,
+            SM_DEBUG_BENCH_BURST, SM_DEBUG_BENCH_BURST_PAUSE_IN_US );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Benchmark - Nanoseconds
+// =============================
+static int64_t sm_debug_bench_ns( clockid_t clock_id )
+{
+    struct timespec ts;
+
+    clock_gettime( clock_id, &ts );
+
+    return( (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Benchmark - Socket Log
+// ============================
+// The log call as it was before the log rings: the fixed-size message is
+// cleared, formatted into and sent whole over the socketpair.
+static void sm_debug_bench_socket_log( uint64_t seqnum, const char* format,
+    ... )
+{
+    SmDebugThreadMsgT msg;
+    va_list arguments;
+
+    memset( &msg, 0, sizeof(msg) );
+
+    msg.type = SM_DEBUG_THREAD_MSG_LOG;
+    msg.u.log.seqnum = seqnum;
+
+    clock_gettime( CLOCK_MONOTONIC_RAW, &(msg.u.log.ts_mono) );
+    clock_gettime( CLOCK_REALTIME, &(msg.u.log.ts_real) );
+
+    va_start( arguments, format );
+    vsnprintf( msg.u.log.data, sizeof(msg.u.log.data), format, arguments );
+    va_end( arguments );
+
+    if( 0 > send( _client_fd, &msg, sizeof(msg), 0 ) )
+    {
+        __atomic_add_fetch( &_socket_dropped, 1, __ATOMIC_RELAXED );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Benchmark - Socket Reader
+// ===============================
+// Stands in for the debug thread reading the socketpair.
+static void* sm_debug_bench_socket_reader( void* arguments )
+{
+    SmDebugThreadMsgT msg;
+    struct pollfd fds;
+
+    fds.fd = _server_fd;
+    fds.events = POLLIN;
+
+    while( true )
+    {
+        bool stay_on = __atomic_load_n( &_reader_stay_on, __ATOMIC_ACQUIRE );
+
+        poll( &fds, 1, stay_on ? SM_DEBUG_BENCH_POLL_INTERVAL_IN_MS : 0 );
+
+        while( 0 < recv( _server_fd, &msg, sizeof(msg), 0 ) )
+        {
+            syslog( LOG_LOCAL3 | LOG_DEBUG, "%s\n", msg.u.log.data );
+        }
+
+        if( !stay_on )
+        {
+            break;
+        }
+    }
+
+    return( NULL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Benchmark - Socket Open
+// =============================
+static SmErrorT sm_debug_bench_socket_open( void )
+{
+    int sockets[2];
+    int buffer_len = SM_DEBUG_BENCH_SOCKET_BUFFER;
+
+    if( 0 > socketpair( AF_UNIX, SOCK_DGRAM, 0, sockets ) )
+    {
+        printf( "Failed to create sockets, error=%s.\n", strerror(errno) );
+        return( SM_FAILED );
+    }
+
+    int socket_i;
+    for( socket_i=0; 2 > socket_i; ++socket_i )
+    {
+        fcntl( sockets[socket_i], F_SETFL,
+               fcntl( sockets[socket_i], F_GETFL, 0 ) | O_NONBLOCK );
+        setsockopt( sockets[socket_i], SOL_SOCKET, SO_SNDBUF, &buffer_len,
+                    sizeof(buffer_len) );
+        setsockopt( sockets[socket_i], SOL_SOCKET, SO_RCVBUF, &buffer_len,
+                    sizeof(buffer_len) );
+    }
+
+    _server_fd = sockets[0];
+    _client_fd = sockets[1];
+    _socket_dropped = 0;
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Benchmark - Socket Close
+// ==============================
+static void sm_debug_bench_socket_close( void )
+{
+    close( _client_fd );
+    close( _server_fd );
+    _client_fd = -1;
+    _server_fd = -1;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Benchmark - Write
+// =======================
+// Logs as DPRINTFI does, the ring+recorder path also records into the
+// flight recorder.
+static void sm_debug_bench_write( SmDebugBenchPathT path, unsigned int log_i )
+{
+    const char* level_str = sm_debug_log_level_str( SM_DEBUG_LOG_LEVEL_INFO );
+
+    switch( path )
+    {
+        case SM_DEBUG_BENCH_PATH_SOCKETPAIR:
+            sm_debug_bench_socket_log( log_i + 1,
+                "%s: %s: %s(%i): Service (%s) is %s-%s, log %u.",
+                level_str, sm_debug_get_thread_info(), __FILE__, __LINE__,
+                "sm-bench-service", "enabled", "active", log_i );
+        break;
+
+        case SM_DEBUG_BENCH_PATH_RING:
+            sm_debug_log( SM_DEBUG_LOG,
+                "%s: %s: %s(%i): Service (%s) is %s-%s, log %u.",
+                level_str, sm_debug_get_thread_info(), __FILE__, __LINE__,
+                "sm-bench-service", "enabled", "active", log_i );
+        break;
+
+        default:
+            DPRINTFI( "Service (%s) is %s-%s, log %u.", "sm-bench-service",
+                      "enabled", "active", log_i );
+        break;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Benchmark - Writer
+// ========================
+static void* sm_debug_bench_writer( void* arguments )
+{
+    SmDebugBenchWriterT* writer = (SmDebugBenchWriterT*) arguments;
+    unsigned int burst = writer->burst;
+    unsigned int log_i = 0;
+    int64_t wall_ns, cpu_ns;
+
+    pthread_setname_np( pthread_self(), "sm_debug_bench" );
+    sm_debug_set_thread_info();
+
+    if( 0 == burst )
+    {
+        burst = writer->logs;
+    }
+
+    pthread_barrier_wait( &_barrier );
+
+    while( writer->logs > log_i )
+    {
+        unsigned int burst_end = log_i + burst;
+
+        if( writer->logs < burst_end )
+        {
+            burst_end = writer->logs;
+        }
+
+        wall_ns = sm_debug_bench_ns( CLOCK_MONOTONIC );
+        cpu_ns = sm_debug_bench_ns( CLOCK_THREAD_CPUTIME_ID );
+
+        for( ; burst_end > log_i; ++log_i )
+        {
+            sm_debug_bench_write( writer->path, log_i );
+        }
+
+        writer->cpu_ns += sm_debug_bench_ns( CLOCK_THREAD_CPUTIME_ID )
+                        - cpu_ns;
+        writer->wall_ns += sm_debug_bench_ns( CLOCK_MONOTONIC ) - wall_ns;
+
+        if( writer->logs > log_i )
+        {
+            usleep( SM_DEBUG_BENCH_BURST_PAUSE_IN_US );
+        }
+    }
+
+    return( NULL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Benchmark - Run
+// =====================
+static SmErrorT sm_debug_bench_run( SmDebugBenchPathT path,
+    unsigned int num_threads, unsigned int logs, unsigned int burst )
+{
+    SmDebugBenchWriterT writers[SM_DEBUG_BENCH_THREADS_MAX];
+    pthread_t reader;
+    int64_t wall_ns = 0;
+    int64_t cpu_ns = 0;
+    uint64_t dropped;
+    SmErrorT error;
+
+    // Fresh thread slots and log rings for every run.
+    error = sm_debug_initialize();
+    if( SM_OKAY != error )
+    {
+        printf( "Failed to initialize debug module, error=%s.\n",
+                sm_error_str( error ) );
+        return( error );
+    }
+
+    if( SM_DEBUG_BENCH_PATH_SOCKETPAIR == path )
+    {
+        error = sm_debug_bench_socket_open();
+        if( SM_OKAY != error )
+        {
+            sm_debug_finalize();
+            return( error );
+        }
+
+        _reader_stay_on = true;
+        pthread_create( &reader, NULL, sm_debug_bench_socket_reader, NULL );
+    }
+
+    pthread_barrier_init( &_barrier, NULL, num_threads );
+
+    unsigned int thread_i;
+    for( thread_i=0; num_threads > thread_i; ++thread_i )
+    {
+        memset( &(writers[thread_i]), 0, sizeof(SmDebugBenchWriterT) );
+        writers[thread_i].path = path;
+        writers[thread_i].logs = logs;
+        writers[thread_i].burst = burst;
+
+        pthread_create( &(writers[thread_i].thread), NULL,
+                        sm_debug_bench_writer, &(writers[thread_i]) );
+    }
+
+    for( thread_i=0; num_threads > thread_i; ++thread_i )
+    {
+        pthread_join( writers[thread_i].thread, NULL );
+        wall_ns += writers[thread_i].wall_ns;
+        cpu_ns += writers[thread_i].cpu_ns;
+    }
+
+    pthread_barrier_destroy( &_barrier );
+
+    if( SM_DEBUG_BENCH_PATH_SOCKETPAIR == path )
+    {
+        __atomic_store_n( &_reader_stay_on, false, __ATOMIC_RELEASE );
+        pthread_join( reader, NULL );
+        dropped = _socket_dropped;
+        sm_debug_bench_socket_close();
+    } else {
+        dropped = sm_debug_dropped();
+    }
+
+    sm_debug_finalize();
+
+    printf( "%-14s threads: %u  wall: %7.0f ns/call  cpu: %7.0f ns/call  "
+            "dropped: %" PRIu64 " of %" PRIu64 "\n", _path_names[path],
+            num_threads, (double) wall_ns / ((double) logs * num_threads),
+            (double) cpu_ns / ((double) logs * num_threads), dropped,
+            (uint64_t) logs * num_threads );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Benchmark - Main
+// ======================
+int main( int argc, char *argv[], char *envp[] )
+{
+    unsigned int threads[16];
+    unsigned int num_thread_counts = 0;
+    unsigned int logs = SM_DEBUG_BENCH_LOGS;
+    unsigned int burst = SM_DEBUG_BENCH_BURST;
+    int c;
+
+    while( true )
+    {
+        c = getopt_long( argc, argv, "", _sm_debug_bench_long_options,
+                         NULL );
+        if( -1 == c )
+        {
+            break;
+        }
+
+        switch( c )
+        {
+            case 'l':
+                logs = (unsigned int) atoi( optarg );
+            break;
+
+            case 't':
+                if( sizeof(threads)/sizeof(threads[0]) > num_thread_counts )
+                {
+                    threads[num_thread_counts++] = (unsigned int) atoi( optarg );
+                }
+            break;
+
+            case 'b':
+                burst = (unsigned int) atoi( optarg );
+            break;
+
+            case 'h':
+            case '?':
+                usage();
+                exit( 0 );
+            break;
+        }
+    }
+
+    if( 0 == num_thread_counts )
+    {
+        threads[num_thread_counts++] = 1;
+        threads[num_thread_counts++] = 4;
+    }
+
+    if( 0 == logs )
+    {
+        logs = 1;
+    }
+
+    printf( "logs per thread: %u, burst: %u, cpus: %li\n", logs, burst,
+            sysconf( _SC_NPROCESSORS_ONLN ) );
+
+    unsigned int count_i;
+    for( count_i=0; num_thread_counts > count_i; ++count_i )
+    {
+        unsigned int num_threads = threads[count_i];
+
+        if( 0 == num_threads )
+        {
+            num_threads = 1;
+        } else if( SM_DEBUG_BENCH_THREADS_MAX < num_threads ) {
+            num_threads = SM_DEBUG_BENCH_THREADS_MAX;
+        }
+
+        int path;
+        for( path=0; SM_DEBUG_BENCH_PATH_MAX > path; ++path )
+        {
+            if( SM_OKAY != sm_debug_bench_run( (SmDebugBenchPathT) path,
+                                               num_threads, logs, burst ) )
+            {
+                return( EXIT_FAILURE );
+            }
+        }
+    }
+
+    return( EXIT_SUCCESS );
+}
+// ****************************************************************************
@@ -0,0 +1,664 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "sm_debug_binary.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "sm_types.h"
+
+#define SM_DEBUG_BINARY_SPEC_MAX_CHARS                                  64
+
+typedef enum
+{
+    SM_DEBUG_BINARY_ARG_INT,
+    SM_DEBUG_BINARY_ARG_LONG,
+    SM_DEBUG_BINARY_ARG_LONG_LONG,
+    SM_DEBUG_BINARY_ARG_SIZE,
+    SM_DEBUG_BINARY_ARG_INTMAX,
+    SM_DEBUG_BINARY_ARG_PTRDIFF,
+    SM_DEBUG_BINARY_ARG_DOUBLE,
+    SM_DEBUG_BINARY_ARG_STRING,
+    SM_DEBUG_BINARY_ARG_POINTER,
+    SM_DEBUG_BINARY_ARG_NONE,
+} SmDebugBinaryArgT;
+
+typedef struct
+{
+    bool width_star;
+    bool precision_star;
+    int precision;
+    SmDebugBinaryArgT type;
+} SmDebugBinarySpecT;
+
+// Arguments a format consumes, in order.  A string precision is -1 when
+// absent and -2 when taken from the previous argument.
+typedef struct
+{
+    int num_args;
+    uint8_t type[SM_DEBUG_BINARY_ARGS_MAX];
+    int16_t precision[SM_DEBUG_BINARY_ARGS_MAX];
+} SmDebugBinarySignatureT;
+
+// Formats are keyed by address, the format strings passed to the log
+// macros are literals and live as long as the process.
+typedef struct
+{
+    const char* format;
+    bool ready;
+    bool encodable;
+    SmDebugBinarySignatureT signature;
+} SmDebugBinaryFormatT;
+
+static SmDebugBinaryFormatT _formats[SM_DEBUG_BINARY_FORMATS_MAX];
+
+// ****************************************************************************
+// Debug Binary - Spec
+// ===================
+// Parses the conversion following a '%', returns the character after it
+// or NULL when the conversion cannot be carried in a binary log.
+static const char* sm_debug_binary_spec( const char* p,
+    SmDebugBinarySpecT* spec )
+{
+    int length = 0;     // 1 h, 2 hh, 3 l, 4 ll, 5 j, 6 z, 7 t, 8 L
+
+    memset( spec, 0, sizeof(SmDebugBinarySpecT) );
+    spec->precision = -1;
+    spec->type = SM_DEBUG_BINARY_ARG_NONE;
+
+    if( '%' == *p )
+    {
+        return( p+1 );
+    }
+
+    while( NULL != strchr( "-+ #0'I", *p ) && '\0' != *p )
+    {
+        ++p;
+    }
+
+    if( '*' == *p )
+    {
+        spec->width_star = true;
+        ++p;
+    } else {
+        while(( '0' <= *p )&&( '9' >= *p ))
+        {
+            ++p;
+        }
+    }
+
+    if( '.' == *p )
+    {
+        ++p;
+        if( '*' == *p )
+        {
+            spec->precision_star = true;
+            ++p;
+        } else {
+            spec->precision = 0;
+            while(( '0' <= *p )&&( '9' >= *p ))
+            {
+                spec->precision = spec->precision*10 + (*p - '0');
+                ++p;
+            }
+        }
+    }
+
+    switch( *p )
+    {
+        case 'h':
+            length = ( 'h' == p[1] ) ? 2 : 1;
+            p += length;
+        break;
+
+        case 'l':
+            length = ( 'l' == p[1] ) ? 4 : 3;
+            p += length - 2;
+        break;
+
+        case 'q':
+            length = 4;
+            ++p;
+        break;
+
+        case 'j':
+            length = 5;
+            ++p;
+        break;
+
+        case 'z':
+        case 'Z':
+            length = 6;
+            ++p;
+        break;
+
+        case 't':
+            length = 7;
+            ++p;
+        break;
+
+        case 'L':
+            length = 8;
+            ++p;
+        break;
+
+        default:
+            // No length modifier.
+        break;
+    }
+
+    switch( *p )
+    {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+            switch( length )
+            {
+                case 3: spec->type = SM_DEBUG_BINARY_ARG_LONG; break;
+                case 4: spec->type = SM_DEBUG_BINARY_ARG_LONG_LONG; break;
+                case 5: spec->type = SM_DEBUG_BINARY_ARG_INTMAX; break;
+                case 6: spec->type = SM_DEBUG_BINARY_ARG_SIZE; break;
+                case 7: spec->type = SM_DEBUG_BINARY_ARG_PTRDIFF; break;
+                case 8: return( NULL ); break;
+                default: spec->type = SM_DEBUG_BINARY_ARG_INT; break;
+            }
+        break;
+
+        case 'c':
+            spec->type = SM_DEBUG_BINARY_ARG_INT;
+        break;
+
+        case 's':
+            if( 0 != length )
+            {
+                return( NULL );
+            }
+            spec->type = SM_DEBUG_BINARY_ARG_STRING;
+        break;
+
+        case 'p':
+            spec->type = SM_DEBUG_BINARY_ARG_POINTER;
+        break;
+
+        case 'f': case 'F': case 'e': case 'E':
+        case 'g': case 'G': case 'a': case 'A':
+            if( 8 == length )
+            {
+                return( NULL );
+            }
+            spec->type = SM_DEBUG_BINARY_ARG_DOUBLE;
+        break;
+
+        default:
+            // %n, %m and wide conversions are formatted as text.
+            return( NULL );
+        break;
+    }
+
+    return( p+1 );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary - Signature
+// ========================
+static bool sm_debug_binary_signature( const char* format,
+    SmDebugBinarySignatureT* signature )
+{
+    SmDebugBinarySpecT spec;
+    const char* p = format;
+
+    memset( signature, 0, sizeof(SmDebugBinarySignatureT) );
+
+    while( '\0' != *p )
+    {
+        if( '%' != *p )
+        {
+            ++p;
+            continue;
+        }
+
+        p = sm_debug_binary_spec( p+1, &spec );
+        if( NULL == p )
+        {
+            return( false );
+        }
+
+        if( SM_DEBUG_BINARY_ARG_NONE == spec.type )
+        {
+            continue;
+        }
+
+        if( SM_DEBUG_BINARY_ARGS_MAX < signature->num_args
+            + (spec.width_star ? 1 : 0) + (spec.precision_star ? 1 : 0) + 1 )
+        {
+            return( false );
+        }
+
+        if( spec.width_star )
+        {
+            signature->type[signature->num_args] = SM_DEBUG_BINARY_ARG_INT;
+            signature->precision[signature->num_args] = -1;
+            ++(signature->num_args);
+        }
+
+        if( spec.precision_star )
+        {
+            signature->type[signature->num_args] = SM_DEBUG_BINARY_ARG_INT;
+            signature->precision[signature->num_args] = -1;
+            ++(signature->num_args);
+        }
+
+        signature->type[signature->num_args] = spec.type;
+        signature->precision[signature->num_args]
+            = spec.precision_star ? -2 : spec.precision;
+        ++(signature->num_args);
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary - Lookup
+// =====================
+// Returns the format entry, adding it on first use, or NULL when the
+// table is full or another thread is still adding it.
+static SmDebugBinaryFormatT* sm_debug_binary_lookup( const char* format,
+    uint32_t* format_id )
+{
+    SmDebugBinaryFormatT* entry;
+    const char* key;
+    uint32_t slot = (uint32_t) ((((uint64_t) (uintptr_t) format)
+                                 * 0x9E3779B97F4A7C15ULL) >> 32)
+                  & (SM_DEBUG_BINARY_FORMATS_MAX-1);
+
+    int probe_i;
+    for( probe_i=0; SM_DEBUG_BINARY_FORMATS_MAX > probe_i; ++probe_i )
+    {
+        entry = &(_formats[slot]);
+
+        key = __atomic_load_n( &(entry->format), __ATOMIC_ACQUIRE );
+        if( NULL == key )
+        {
+            if( __sync_bool_compare_and_swap( &(entry->format), NULL,
+                                              format ) )
+            {
+                entry->encodable = sm_debug_binary_signature( format,
+                                                    &(entry->signature) );
+                __atomic_store_n( &(entry->ready), true, __ATOMIC_RELEASE );
+                *format_id = slot;
+                return( entry );
+            }
+
+            key = __atomic_load_n( &(entry->format), __ATOMIC_ACQUIRE );
+        }
+
+        if( key == format )
+        {
+            if( !__atomic_load_n( &(entry->ready), __ATOMIC_ACQUIRE ) )
+            {
+                return( NULL );
+            }
+
+            *format_id = slot;
+            return( entry );
+        }
+
+        slot = (slot + 1) & (SM_DEBUG_BINARY_FORMATS_MAX-1);
+    }
+
+    return( NULL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary - Encode
+// =====================
+int sm_debug_binary_encode( const char* format, va_list arguments,
+    uint32_t* format_id, char buffer[], int buffer_size )
+{
+    SmDebugBinaryFormatT* entry;
+    int last_int = -1;
+    int len = 0;
+
+    entry = sm_debug_binary_lookup( format, format_id );
+    if(( NULL == entry )||( !entry->encodable ))
+    {
+        return( -1 );
+    }
+
+    if( SM_DEBUG_BINARY_ARGS_MAX_BYTES < buffer_size )
+    {
+        buffer_size = SM_DEBUG_BINARY_ARGS_MAX_BYTES;
+    }
+
+    int arg_i;
+    for( arg_i=0; entry->signature.num_args > arg_i; ++arg_i )
+    {
+        int64_t value;
+        int value_size = (int) sizeof(int64_t);
+
+        switch( entry->signature.type[arg_i] )
+        {
+            case SM_DEBUG_BINARY_ARG_INT:
+                last_int = va_arg( arguments, int );
+                value = last_int;
+                value_size = (int) sizeof(int32_t);
+            break;
+
+            case SM_DEBUG_BINARY_ARG_LONG:
+                value = va_arg( arguments, long );
+            break;
+
+            case SM_DEBUG_BINARY_ARG_LONG_LONG:
+                value = va_arg( arguments, long long );
+            break;
+
+            case SM_DEBUG_BINARY_ARG_SIZE:
+                value = (int64_t) va_arg( arguments, size_t );
+            break;
+
+            case SM_DEBUG_BINARY_ARG_INTMAX:
+                value = va_arg( arguments, intmax_t );
+            break;
+
+            case SM_DEBUG_BINARY_ARG_PTRDIFF:
+                value = va_arg( arguments, ptrdiff_t );
+            break;
+
+            case SM_DEBUG_BINARY_ARG_POINTER:
+                value = (int64_t) (uintptr_t) va_arg( arguments, void* );
+            break;
+
+            case SM_DEBUG_BINARY_ARG_DOUBLE:
+            {
+                double d = va_arg( arguments, double );
+                memcpy( &value, &d, sizeof(value) );
+            }
+            break;
+
+            case SM_DEBUG_BINARY_ARG_STRING:
+            {
+                const char* s = va_arg( arguments, const char* );
+                int precision = entry->signature.precision[arg_i];
+                size_t max_len = buffer_size;
+                uint16_t s_len;
+
+                if( NULL == s )
+                {
+                    s = "(null)";
+                }
+
+                if( 0 <= precision )
+                {
+                    max_len = precision;
+                } else if(( -2 == precision )&&( 0 <= last_int )) {
+                    max_len = last_int;
+                }
+
+                s_len = (uint16_t) strnlen( s, max_len );
+                if( len + (int) sizeof(s_len) + s_len > buffer_size )
+                {
+                    return( -1 );
+                }
+
+                memcpy( &(buffer[len]), &s_len, sizeof(s_len) );
+                memcpy( &(buffer[len+sizeof(s_len)]), s, s_len );
+                len += sizeof(s_len) + s_len;
+                continue;
+            }
+            break;
+
+            default:
+                return( -1 );
+            break;
+        }
+
+        if( len + value_size > buffer_size )
+        {
+            return( -1 );
+        }
+
+        if( (int) sizeof(int32_t) == value_size )
+        {
+            int32_t value32 = (int32_t) value;
+            memcpy( &(buffer[len]), &value32, sizeof(value32) );
+        } else {
+            memcpy( &(buffer[len]), &value, sizeof(value) );
+        }
+        len += value_size;
+    }
+
+    return( len );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary - Format
+// =====================
+const char* sm_debug_binary_format( uint32_t format_id )
+{
+    SmDebugBinaryFormatT* entry;
+
+    if( SM_DEBUG_BINARY_FORMATS_MAX <= format_id )
+    {
+        return( NULL );
+    }
+
+    entry = &(_formats[format_id]);
+
+    if( !__atomic_load_n( &(entry->ready), __ATOMIC_ACQUIRE ) )
+    {
+        return( NULL );
+    }
+
+    return( entry->format );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary - Get
+// ==================
+static bool sm_debug_binary_get( const char args[], int args_len,
+    int* offset, void* value, int size )
+{
+    if( *offset + size > args_len )
+    {
+        return( false );
+    }
+
+    memcpy( value, &(args[*offset]), size );
+    *offset += size;
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary - Decode
+// =====================
+SmErrorT sm_debug_binary_decode( const char format[], const char args[],
+    int args_len, char text[], int text_size )
+{
+    SmDebugBinarySpecT spec;
+    char spec_text[SM_DEBUG_BINARY_SPEC_MAX_CHARS];
+    char str[SM_DEBUG_BINARY_ARGS_MAX_BYTES+1];
+    const char* p = format;
+    int offset = 0;
+    int len = 0;
+
+    if( 0 >= text_size )
+    {
+        return( SM_FAILED );
+    }
+
+    while(( '\0' != *p )&&( text_size-1 > len ))
+    {
+        if( '%' != *p )
+        {
+            text[len++] = *(p++);
+            continue;
+        }
+
+        const char* start = p;
+
+        p = sm_debug_binary_spec( p+1, &spec );
+        if( NULL == p )
+        {
+            text[len] = '\0';
+            return( SM_FAILED );
+        }
+
+        if( SM_DEBUG_BINARY_ARG_NONE == spec.type )
+        {
+            text[len++] = '%';
+            continue;
+        }
+
+        // Star width and precision are substituted with their values.
+        int spec_len = 0;
+        const char* q;
+        for( q=start; p > q; ++q )
+        {
+            if( '*' == *q )
+            {
+                int32_t star;
+
+                if( !sm_debug_binary_get( args, args_len, &offset, &star,
+                                          sizeof(star) ) )
+                {
+                    text[len] = '\0';
+                    return( SM_FAILED );
+                }
+
+                spec_len += snprintf( &(spec_text[spec_len]),
+                                      sizeof(spec_text) - spec_len, "%d",
+                                      (int) star );
+            } else {
+                spec_text[spec_len++] = *q;
+            }
+
+            if( (int) sizeof(spec_text) - 1 <= spec_len )
+            {
+                text[len] = '\0';
+                return( SM_FAILED );
+            }
+        }
+        spec_text[spec_len] = '\0';
+
+        int32_t value32 = 0;
+        int64_t value = 0;
+        int result;
+        bool got;
+
+        if( SM_DEBUG_BINARY_ARG_INT == spec.type )
+        {
+            got = sm_debug_binary_get( args, args_len, &offset, &value32,
+                                       sizeof(value32) );
+
+        } else if( SM_DEBUG_BINARY_ARG_STRING == spec.type ) {
+            uint16_t s_len = 0;
+
+            got = sm_debug_binary_get( args, args_len, &offset, &s_len,
+                                       sizeof(s_len) );
+            if(( got )&&( (int) sizeof(str) <= s_len ))
+            {
+                got = false;
+            }
+            if( got )
+            {
+                got = sm_debug_binary_get( args, args_len, &offset, str,
+                                           s_len );
+                str[s_len] = '\0';
+            }
+
+        } else {
+            got = sm_debug_binary_get( args, args_len, &offset, &value,
+                                       sizeof(value) );
+        }
+
+        if( !got )
+        {
+            text[len] = '\0';
+            return( SM_FAILED );
+        }
+
+        switch( spec.type )
+        {
+            case SM_DEBUG_BINARY_ARG_INT:
+                result = snprintf( &(text[len]), text_size - len, spec_text,
+                                   (int) value32 );
+            break;
+
+            case SM_DEBUG_BINARY_ARG_LONG:
+                result = snprintf( &(text[len]), text_size - len, spec_text,
+                                   (long) value );
+            break;
+
+            case SM_DEBUG_BINARY_ARG_LONG_LONG:
+                result = snprintf( &(text[len]), text_size - len, spec_text,
+                                   (long long) value );
+            break;
+
+            case SM_DEBUG_BINARY_ARG_SIZE:
+                result = snprintf( &(text[len]), text_size - len, spec_text,
+                                   (size_t) value );
+            break;
+
+            case SM_DEBUG_BINARY_ARG_INTMAX:
+                result = snprintf( &(text[len]), text_size - len, spec_text,
+                                   (intmax_t) value );
+            break;
+
+            case SM_DEBUG_BINARY_ARG_PTRDIFF:
+                result = snprintf( &(text[len]), text_size - len, spec_text,
+                                   (ptrdiff_t) value );
+            break;
+
+            case SM_DEBUG_BINARY_ARG_POINTER:
+                result = snprintf( &(text[len]), text_size - len, spec_text,
+                                   (void*) (uintptr_t) value );
+            break;
+
+            case SM_DEBUG_BINARY_ARG_DOUBLE:
+            {
+                double d;
+                memcpy( &d, &value, sizeof(d) );
+                result = snprintf( &(text[len]), text_size - len, spec_text,
+                                   d );
+            }
+            break;
+
+            case SM_DEBUG_BINARY_ARG_STRING:
+                result = snprintf( &(text[len]), text_size - len, spec_text,
+                                   str );
+            break;
+
+            default:
+                result = 0;
+            break;
+        }
+
+        if( 0 > result )
+        {
+            text[len] = '\0';
+            return( SM_FAILED );
+        }
+
+        len += result;
+        if( text_size-1 < len )
+        {
+            len = text_size-1;
+        }
+    }
+
+    text[len] = '\0';
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
@@ -0,0 +1,88 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __SM_DEBUG_BINARY_H__
+#define __SM_DEBUG_BINARY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+
+#include "sm_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SM_DEBUG_BINARY_LOG_FILE                    "/var/log/sm-debug.bin"
+#define SM_DEBUG_BINARY_LOG_MAX_BYTES                       (64*1024*1024)
+#define SM_DEBUG_BINARY_MAGIC                                   "SMDBGBIN"
+#define SM_DEBUG_BINARY_VERSION                                          1
+#define SM_DEBUG_BINARY_FORMATS_MAX                                   4096
+#define SM_DEBUG_BINARY_ARGS_MAX                                        24
+#define SM_DEBUG_BINARY_ARGS_MAX_BYTES                                 480
+
+typedef enum
+{
+    SM_DEBUG_BINARY_RECORD_SESSION,
+    SM_DEBUG_BINARY_RECORD_FORMAT,
+    SM_DEBUG_BINARY_RECORD_LOG,
+} SmDebugBinaryRecordKindT;
+
+// Record as written to the binary log file, followed by args_len bytes.
+// A session record carries the magic and starts a new format dictionary,
+// a format record carries the format string for format_id, a log record
+// carries the encoded arguments of one log.
+typedef struct
+{
+    uint8_t kind;
+    uint8_t log_type;
+    uint16_t args_len;
+    uint32_t format_id;
+    uint64_t seqnum;
+    int64_t mono_ns;
+    int64_t real_ns;
+} __attribute__ ((packed)) SmDebugBinaryRecordT;
+
+// Header of a binary log in the log ring, followed by args_len bytes of
+// encoded arguments.
+typedef struct
+{
+    uint32_t format_id;
+    uint16_t log_type;
+    uint16_t args_len;
+} SmDebugBinaryLogT;
+
+// ****************************************************************************
+// Debug Binary - Encode
+// =====================
+// Records the format and copies the arguments it consumes into buffer.
+// Returns the encoded length, or -1 when the format has a conversion that
+// cannot be encoded or the arguments do not fit, the caller then logs text.
+extern int sm_debug_binary_encode( const char* format, va_list arguments,
+    uint32_t* format_id, char buffer[], int buffer_size );
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary - Format
+// =====================
+// Returns the format string recorded for format_id, or NULL.
+extern const char* sm_debug_binary_format( uint32_t format_id );
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary - Decode
+// =====================
+// Formats encoded arguments with their format string into text, the
+// result is what the text log would have held.
+extern SmErrorT sm_debug_binary_decode( const char format[],
+    const char args[], int args_len, char text[], int text_size );
+// ****************************************************************************
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SM_DEBUG_BINARY_H__
@@ -0,0 +1,479 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Checks that log arguments encoded for the binary debug log decode to
+// the text the log would have had, exits non-zero when a check fails.
+// With --benchmark, also compares the cost of formatting and encoding a
+// log, and the bytes written per log, for representative log sites.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <getopt.h>
+#include <sys/types.h>
+
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_debug_thread.h"
+#include "sm_debug_binary.h"
+
+#define SM_DEBUG_BINARY_TEST_SITES                                       4
+#define SM_DEBUG_BINARY_TEST_ITERATIONS                             200000
+
+// Same prefix as the DPRINTF macros.
+#define SM_DEBUG_BINARY_TEST_SITE( binary, buffer, format, args... ) \
+    ( (binary) \
+      ? sm_debug_binary_test_encode( buffer, SM_DEBUG_THREAD_LOG_MAX_CHARS, \
+                                     "%s: %s: %s(%i): " format, "DEBUG", \
+                                     "sm[2104]", "sm_msg.c", 1712, ##args ) \
+      : sm_debug_binary_test_text( buffer, SM_DEBUG_THREAD_LOG_MAX_CHARS, \
+                                   "%s: %s: %s(%i): " format, "DEBUG", \
+                                   "sm[2104]", "sm_msg.c", 1712, ##args ) )
+
+static struct option _sm_debug_binary_test_long_options[] =
+{
+    { "benchmark", optional_argument, NULL, 'b'},
+    { "help",      no_argument,       NULL, 'h'},
+    {0, 0, 0, 0}
+};
+
+static const char* _site_names[SM_DEBUG_BINARY_TEST_SITES] =
+{
+    "msg-receive", "msg-ip-receive", "service-fsm", "msg-verbose"
+};
+
+static uint32_t _last_format_id;
+static unsigned int _failures = 0;
+
+// ****************************************************************************
+// Debug Binary Test - Usage
+// =========================
+static void usage( void )
+{
+    printf( " usage:\n"
+            "   sm_debug_binary_test [--benchmark[=<iterations>]] [--help]\n"
+            "       --benchmark : after the checks, compare the formatting\n"
+            "                     and encoding cost per log, and the bytes\n"
+            "                     per log, for representative log sites\n"
+            "       --help      : print out this help message\n"
+            "\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary Test - Check
+// =========================
+static void sm_debug_binary_test_check( bool passed, const char name[] )
+{
+    printf( "%s: %s\n", passed ? "PASS" : "FAIL", name );
+
+    if( !passed )
+    {
+        ++_failures;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary Test - Text
+// ========================
+static int sm_debug_binary_test_text( char buffer[], int buffer_size,
+    const char* format, ... ) __attribute__ ((format (printf, 3, 4)));
+
+static int sm_debug_binary_test_text( char buffer[], int buffer_size,
+    const char* format, ... )
+{
+    va_list arguments;
+    int len;
+
+    va_start( arguments, format );
+    len = vsnprintf( buffer, buffer_size, format, arguments );
+    va_end( arguments );
+
+    return( len );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary Test - Encode
+// ==========================
+static int sm_debug_binary_test_encode( char buffer[], int buffer_size,
+    const char* format, ... ) __attribute__ ((format (printf, 3, 4)));
+
+static int sm_debug_binary_test_encode( char buffer[], int buffer_size,
+    const char* format, ... )
+{
+    va_list arguments;
+    int len;
+
+    va_start( arguments, format );
+    len = sm_debug_binary_encode( format, arguments, &_last_format_id,
+                                  buffer, buffer_size );
+    va_end( arguments );
+
+    return( len );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary Test - Decodes To
+// ==============================
+// Returns true when the arguments last encoded decode to the given text.
+static bool sm_debug_binary_test_decodes_to( const char args[], int args_len,
+    const char text[] )
+{
+    char decoded[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+    const char* format = sm_debug_binary_format( _last_format_id );
+
+    if(( 0 > args_len )||( NULL == format ))
+    {
+        return( false );
+    }
+
+    if( SM_OKAY != sm_debug_binary_decode( format, args, args_len, decoded,
+                                           sizeof(decoded) ) )
+    {
+        return( false );
+    }
+
+    if( 0 != strcmp( text, decoded ) )
+    {
+        printf( "  expected: %s\n  decoded : %s\n", text, decoded );
+        return( false );
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary Test - Round Trip
+// ==============================
+static void sm_debug_binary_test_round_trip( const char name[],
+    const char* format, ... ) __attribute__ ((format (printf, 2, 3)));
+
+static void sm_debug_binary_test_round_trip( const char name[],
+    const char* format, ... )
+{
+    char text[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+    char args[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+    va_list arguments;
+    va_list copy;
+    int args_len;
+
+    va_start( arguments, format );
+    va_copy( copy, arguments );
+    vsnprintf( text, sizeof(text), format, arguments );
+    args_len = sm_debug_binary_encode( format, copy, &_last_format_id, args,
+                                       sizeof(args) );
+    va_end( copy );
+    va_end( arguments );
+
+    sm_debug_binary_test_check(
+        sm_debug_binary_test_decodes_to( args, args_len, text ), name );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary Test - Site
+// ========================
+// Log sites from the messaging and service paths, with typical arguments.
+static int sm_debug_binary_test_site( int site, bool binary,
+    char buffer[SM_DEBUG_THREAD_LOG_MAX_CHARS] )
+{
+    int len;
+
+    switch( site )
+    {
+        case 0:
+            len = SM_DEBUG_BINARY_TEST_SITE( binary, buffer,
+                    "Message received from node (%s), msg_seq=%" PRIi64 ".",
+                    "controller-1", (int64_t) 81723461 );
+        break;
+
+        case 1:
+            len = SM_DEBUG_BINARY_TEST_SITE( binary, buffer,
+                    "Received message from ip (%s), port (%i) on "
+                    "interface (%s).", "192.168.204.3", 2222, "enp0s8" );
+        break;
+
+        case 2:
+            len = SM_DEBUG_BINARY_TEST_SITE( binary, buffer,
+                    "Service (%s) received event (%s) was in the %s%s%s "
+                    "state and is now in the %s%s%s state%s%s.",
+                    "drbd-platform", "enable-success", "enabling", "", "",
+                    "enabled-active", "", "", "", "" );
+        break;
+
+        case 3:
+            len = SM_DEBUG_BINARY_TEST_SITE( binary, buffer,
+                    "Hello message size is %i.", 144 );
+        break;
+
+        default:
+            return( -1 );
+        break;
+    }
+
+    return( len );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary Test - Sites
+// =========================
+static void sm_debug_binary_test_sites( void )
+{
+    char text[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+    char args[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+    char name[64];
+    int args_len;
+
+    int site_i;
+    for( site_i=0; SM_DEBUG_BINARY_TEST_SITES > site_i; ++site_i )
+    {
+        sm_debug_binary_test_site( site_i, false, text );
+        args_len = sm_debug_binary_test_site( site_i, true, args );
+
+        snprintf( name, sizeof(name), "site %s", _site_names[site_i] );
+        sm_debug_binary_test_check(
+            sm_debug_binary_test_decodes_to( args, args_len, text ), name );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary Test - Conversions
+// ===============================
+static void sm_debug_binary_test_conversions( void )
+{
+    char args[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+    const char* volatile null_str = NULL;
+    int value = 7;
+    int args_len;
+
+    sm_debug_binary_test_round_trip( "integers",
+        "%d %i %u %o %x %X %c %hd %hhu", -42, 42, 3000000000U, 8, 255,
+        255, 'z', (short) -3, (unsigned char) 250 );
+
+    sm_debug_binary_test_round_trip( "long integers",
+        "%ld %lu %lld %llx %zu %zd %jd %td", -1234567890123L,
+        9876543210UL, -1LL, 0xdeadbeefcafeULL, (size_t) 65536,
+        (ssize_t) -1, (intmax_t) INT64_MIN, (ptrdiff_t) -16 );
+
+    sm_debug_binary_test_round_trip( "flags and width",
+        "[%-8s] [%08.3f] [%+d] [% i] [%#x] [%5c]", "left", 3.14159, 5, 6,
+        0x1f, 'q' );
+
+    sm_debug_binary_test_round_trip( "star width and precision",
+        "[%*d] [%-*s] [%.*s] [%*.*f]", 6, 12, 10, "pad", 3, "truncated",
+        9, 2, 2.71828 );
+
+    sm_debug_binary_test_round_trip( "precision string", "[%.4s]",
+                                     "controller-0" );
+
+    sm_debug_binary_test_round_trip( "doubles", "%f %e %g %a %E %G",
+        0.1, 12345.678, 1e-10, 1.5, -2.5e300, 100.0 );
+
+    sm_debug_binary_test_round_trip( "pointer", "%p", (void*) &value );
+
+    sm_debug_binary_test_round_trip( "percent and no arguments",
+                                     "100%% done" );
+
+    // Printed the way glibc prints a null string.
+    args_len = sm_debug_binary_test_encode( args, sizeof(args), "(%s)",
+                                            null_str );
+    sm_debug_binary_test_check(
+        sm_debug_binary_test_decodes_to( args, args_len, "((null))" ),
+        "null string" );
+
+    sm_debug_binary_test_round_trip( "empty strings", "[%s%s]", "", "" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary Test - Not Encodable
+// =================================
+// Formats the encoder leaves to the text log.
+static void sm_debug_binary_test_not_encodable( void )
+{
+    char args[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+    char long_str[SM_DEBUG_BINARY_ARGS_MAX_BYTES+1];
+
+    sm_debug_binary_test_check(
+        0 > sm_debug_binary_test_encode( args, sizeof(args), "%m" ),
+        "not encodable %m" );
+
+    sm_debug_binary_test_check(
+        0 > sm_debug_binary_test_encode( args, sizeof(args), "%ls",
+                                         L"wide" ),
+        "not encodable %ls" );
+
+    sm_debug_binary_test_check(
+        0 > sm_debug_binary_test_encode( args, sizeof(args), "%Lf",
+                                         (long double) 1.0 ),
+        "not encodable %Lf" );
+
+    sm_debug_binary_test_check(
+        0 > sm_debug_binary_test_encode( args, sizeof(args),
+                "%d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d "
+                "%d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
+                14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25 ),
+        "not encodable, too many arguments" );
+
+    memset( long_str, 'x', sizeof(long_str)-1 );
+    long_str[sizeof(long_str)-1] = '\0';
+
+    sm_debug_binary_test_check(
+        0 > sm_debug_binary_test_encode( args, sizeof(args), "long (%s)",
+                                         long_str ),
+        "not encodable, arguments too long" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary Test - Format Identifiers
+// ======================================
+static void sm_debug_binary_test_format_ids( void )
+{
+    char args[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+    uint32_t first_id;
+    uint32_t other_id;
+
+    sm_debug_binary_test_encode( args, sizeof(args), "format id (%i)", 1 );
+    first_id = _last_format_id;
+
+    sm_debug_binary_test_encode( args, sizeof(args), "format id (%s)", "2" );
+    other_id = _last_format_id;
+
+    sm_debug_binary_test_encode( args, sizeof(args), "format id (%i)", 3 );
+
+    sm_debug_binary_test_check(
+        ( first_id == _last_format_id )&&( first_id != other_id ),
+        "format recorded once" );
+
+    sm_debug_binary_test_check(
+        ( NULL != sm_debug_binary_format( first_id ) )&&
+        ( 0 == strcmp( "format id (%i)",
+                       sm_debug_binary_format( first_id ) ) ),
+        "format looked up by id" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary Test - Benchmark
+// =============================
+static void sm_debug_binary_test_benchmark( long iterations )
+{
+    char text[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+    char args[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+    struct timespec start, end;
+    int text_len = 0, args_len = 0;
+    double text_ns, binary_ns;
+
+    printf( "%-16s %10s %10s %11s %11s\n", "site", "text-ns", "binary-ns",
+            "text-bytes", "binary-bytes" );
+
+    int site_i;
+    for( site_i=0; SM_DEBUG_BINARY_TEST_SITES > site_i; ++site_i )
+    {
+        clock_gettime( CLOCK_MONOTONIC, &start );
+        long iteration_i;
+        for( iteration_i=0; iterations > iteration_i; ++iteration_i )
+        {
+            text_len = sm_debug_binary_test_site( site_i, false, text );
+        }
+        clock_gettime( CLOCK_MONOTONIC, &end );
+        text_ns = ((end.tv_sec - start.tv_sec) * 1e9
+                   + (end.tv_nsec - start.tv_nsec)) / iterations;
+
+        clock_gettime( CLOCK_MONOTONIC, &start );
+        for( iteration_i=0; iterations > iteration_i; ++iteration_i )
+        {
+            args_len = sm_debug_binary_test_site( site_i, true, args );
+        }
+        clock_gettime( CLOCK_MONOTONIC, &end );
+        binary_ns = ((end.tv_sec - start.tv_sec) * 1e9
+                     + (end.tv_nsec - start.tv_nsec)) / iterations;
+
+        if(( 0 > text_len )||( 0 > args_len ))
+        {
+            printf( "%-16s not encodable\n", _site_names[site_i] );
+            continue;
+        }
+
+        // Bytes as written, a syslog line against a binary log record.
+        printf( "%-16s %10.1f %10.1f %11d %11d\n", _site_names[site_i],
+                text_ns, binary_ns, text_len + 1,
+                (int) sizeof(SmDebugBinaryRecordT) + args_len );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Binary Test - Main
+// ========================
+int main( int argc, char *argv[], char *envp[] )
+{
+    long iterations = 0;
+    int c;
+
+    while( true )
+    {
+        c = getopt_long( argc, argv, "", _sm_debug_binary_test_long_options,
+                         NULL );
+        if( -1 == c )
+        {
+            break;
+        }
+
+        switch( c )
+        {
+            case 'b':
+                iterations = SM_DEBUG_BINARY_TEST_ITERATIONS;
+                if( optarg )
+                {
+                    iterations = atol( optarg );
+                }
+                if( 0 >= iterations )
+                {
+                    usage();
+                    return( EXIT_FAILURE );
+                }
+            break;
+
+            case 'h':
+                usage();
+                return( EXIT_SUCCESS );
+            break;
+
+            default:
+                usage();
+                return( EXIT_FAILURE );
+            break;
+        }
+    }
+
+    sm_debug_binary_test_sites();
+    sm_debug_binary_test_conversions();
+    sm_debug_binary_test_not_encodable();
+    sm_debug_binary_test_format_ids();
+
+    printf( "%u failed\n", _failures );
+
+    if( 0 < iterations )
+    {
+        sm_debug_binary_test_benchmark( iterations );
+    }
+
+    return( ( 0 == _failures ) ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+// ****************************************************************************
@@ -0,0 +1,214 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_debug_thread.h"
+#include "sm_debug_binary.h"
+
+static struct option _sm_debug_decode_long_options[] =
+{
+    { "file", required_argument, NULL, 'f'},
+    {0, 0, 0, 0}
+};
+
+static const char* _formats[SM_DEBUG_BINARY_FORMATS_MAX];
+
+// ****************************************************************************
+// Debug Decode - Usage
+// ====================
+static void usage( void )
+{
+    printf( " usage:\n"
+            "   sm-debug-decode [--file <binary log file>]\n"
+            "\n"
+            " Decodes a binary sm debug log or a saved flight recorder into\n"
+            " the text that would have been logged, the default file is\n"
+            " %s.\n", SM_DEBUG_BINARY_LOG_FILE );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Decode - Reset Formats
+// ============================
+static void sm_debug_decode_reset_formats( void )
+{
+    int format_i;
+    for( format_i=0; SM_DEBUG_BINARY_FORMATS_MAX > format_i; ++format_i )
+    {
+        free( (void*) _formats[format_i] );
+        _formats[format_i] = NULL;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Decode - Print Log
+// ========================
+static void sm_debug_decode_print_log( const SmDebugBinaryRecordT* record,
+    const char args[] )
+{
+    char text[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+    char date_str[32];
+    struct tm t_real;
+    time_t real_sec = (time_t) (record->real_ns / 1000000000LL);
+    long real_ms = (long) ((record->real_ns % 1000000000LL) / 1000000);
+    long mono_sec = (long) (record->mono_ns / 1000000000LL);
+    long mono_ms = (long) ((record->mono_ns % 1000000000LL) / 1000000);
+
+    if( NULL == localtime_r( &real_sec, &t_real ) )
+    {
+        snprintf( date_str, sizeof(date_str), "YYYY:MM:DD HH:MM:SS" );
+    } else {
+        strftime( date_str, sizeof(date_str), "%FT%T", &t_real );
+    }
+
+    if( NULL == _formats[record->format_id] )
+    {
+        printf( "%s.%03ld time[%ld.%03ld] unknown format (%u)\n", date_str,
+                real_ms, mono_sec, mono_ms, record->format_id );
+        return;
+    }
+
+    if( SM_OKAY != sm_debug_binary_decode( _formats[record->format_id],
+                                           args, record->args_len, text,
+                                           sizeof(text) ) )
+    {
+        printf( "%s.%03ld time[%ld.%03ld] failed to decode format (%s)\n",
+                date_str, real_ms, mono_sec, mono_ms,
+                _formats[record->format_id] );
+        return;
+    }
+
+    printf( "%s.%03ld time[%ld.%03ld] %s<%" PRIu64 "> %s\n", date_str,
+            real_ms, mono_sec, mono_ms,
+            ( SM_DEBUG_THREAD_MSG_SERVICE_LOG == record->log_type )
+            ? "sm_svc_log" : "log", record->seqnum, text );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Decode - File
+// ===================
+static SmErrorT sm_debug_decode_file( const char filename[] )
+{
+    SmDebugBinaryRecordT record;
+    char args[UINT16_MAX+1];
+    bool session = false;
+    FILE* fp;
+
+    fp = fopen( filename, "r" );
+    if( NULL == fp )
+    {
+        printf( "Failed to open binary log file (%s).\n", filename );
+        return( SM_FAILED );
+    }
+
+    while( 1 == fread( &record, sizeof(record), 1, fp ) )
+    {
+        if( record.args_len != fread( args, 1, record.args_len, fp ) )
+        {
+            printf( "Truncated record at end of file.\n" );
+            break;
+        }
+        args[record.args_len] = '\0';
+
+        switch( record.kind )
+        {
+            case SM_DEBUG_BINARY_RECORD_SESSION:
+                if(( SM_DEBUG_BINARY_VERSION != record.format_id )||
+                   ( 0 != strcmp( args, SM_DEBUG_BINARY_MAGIC ) ))
+                {
+                    printf( "Unsupported binary log, version=%u.\n",
+                            record.format_id );
+                    fclose( fp );
+                    return( SM_FAILED );
+                }
+                sm_debug_decode_reset_formats();
+                session = true;
+            break;
+
+            case SM_DEBUG_BINARY_RECORD_FORMAT:
+                if(( !session )||
+                   ( SM_DEBUG_BINARY_FORMATS_MAX <= record.format_id ))
+                {
+                    printf( "Invalid format record (%u).\n",
+                            record.format_id );
+                    fclose( fp );
+                    return( SM_FAILED );
+                }
+                free( (void*) _formats[record.format_id] );
+                _formats[record.format_id] = strdup( args );
+            break;
+
+            case SM_DEBUG_BINARY_RECORD_LOG:
+                if(( !session )||
+                   ( SM_DEBUG_BINARY_FORMATS_MAX <= record.format_id ))
+                {
+                    printf( "Invalid log record (%u).\n", record.format_id );
+                    fclose( fp );
+                    return( SM_FAILED );
+                }
+                sm_debug_decode_print_log( &record, args );
+            break;
+
+            default:
+                printf( "Unknown record kind (%u).\n", record.kind );
+                fclose( fp );
+                return( SM_FAILED );
+            break;
+        }
+    }
+
+    fclose( fp );
+    sm_debug_decode_reset_formats();
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Main - Debug Decode
+// ===================
+int main( int argc, char *argv[], char *envp[] )
+{
+    const char* filename = SM_DEBUG_BINARY_LOG_FILE;
+    SmErrorT error;
+    int c;
+
+    while( true )
+    {
+        c = getopt_long( argc, argv, "", _sm_debug_decode_long_options,
+                         NULL );
+        if( -1 == c )
+        {
+            break;
+        }
+
+        switch( c )
+        {
+            case 'f':
+                filename = optarg;
+            break;
+
+            default:
+                usage();
+                return( EXIT_FAILURE );
+            break;
+        }
+    }
+
+    error = sm_debug_decode_file( filename );
+
+    return( ( SM_OKAY == error ) ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+// ****************************************************************************
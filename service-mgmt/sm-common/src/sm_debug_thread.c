@@ -23,9 +23,10 @@
 #include "sm_time.h"
 #include "sm_selobj.h"
 #include "sm_trap.h"
+#include "sm_debug_binary.h"
 
 #define SM_DEBUG_THREAD_NAME                                        "sm_debug"
-#define SM_DEBUG_THREAD_TICK_INTERVAL_IN_MS                               1000
+#define SM_DEBUG_THREAD_TICK_INTERVAL_IN_MS                                100
 #define SM_DEBUG_THREAD_SCHED_LOG_FILE             "/var/log/sm-scheduler.log"
 
 #define SM_SYSLOG( format, args... ) \
@@ -38,55 +39,36 @@
 static sig_atomic_t _stay_on;
 static bool _thread_created = false;
 static pthread_t _debug_thread;
-static int _server_fd = -1;
-static bool _server_fd_registered = false;
+static int _event_fd = -1;
+static bool _event_fd_registered = false;
 static FILE * _sched_log = NULL;
+static FILE * _binary_log = NULL;
+static bool _binary_log_failed = false;
+static long _binary_log_bytes = 0;
+static bool _binary_format_written[SM_DEBUG_BINARY_FORMATS_MAX];
 
 // ****************************************************************************
-// Debug Thread - Dispatch
-// =======================
-static void sm_debug_thread_dispatch( int selobj, int64_t user_data )
+// Debug Thread - Log
+// ==================
+static void sm_debug_thread_log( const SmDebugThreadRecordT* record,
+    const char data[] )
 {
-    int bytes_read;
     long ms_expired;
     SmTimeT time_prev, time_now;
-    SmDebugThreadMsgT msg;
     char time_str[80];
     char date_str[32];
     struct tm t_real;
 
-    memset( &msg, 0, sizeof(msg) );
-
-    int retry_count;
-    for( retry_count = 5; retry_count != 0; --retry_count )
-    {
-        bytes_read = recv( selobj, &msg, sizeof(msg), 0 );
-        if( 0 < bytes_read )
-        {
-            break;
-
-        } else if( 0 == bytes_read ) {
-            // For connection oriented sockets, this indicates that the peer 
-            // has performed an orderly shutdown.
-            return;
-
-        } else if(( 0 > bytes_read )&&( EINTR != errno )) {
-            SM_SYSLOG( "Failed to receive message, errno=%s.",
-                       strerror( errno ) );
-            return;
-        }
-    }
-
-    switch( msg.type )
+    switch( record->type )
     {
         case SM_DEBUG_THREAD_MSG_LOG:
 
             sm_time_get( &time_prev );
 
             SM_SYSLOG( "time[%ld.%03ld] log<%" PRIu64 "> %s",
-                             (long) msg.u.log.ts_mono.tv_sec,
-                             (long) msg.u.log.ts_mono.tv_nsec/1000000,
-                             msg.u.log.seqnum, msg.u.log.data );
+                             (long) record->ts_mono.tv_sec,
+                             (long) record->ts_mono.tv_nsec/1000000,
+                             record->seqnum, data );
 
             sm_time_get( &time_now );
             ms_expired = sm_time_delta_in_ms( &time_now, &time_prev );
@@ -99,7 +81,7 @@ static void sm_debug_thread_dispatch( int selobj, int64_t user_data )
 
             sm_time_get( &time_prev );
 
-            if( NULL == localtime_r( &(msg.u.log.ts_real.tv_sec), &t_real ) )
+            if( NULL == localtime_r( &(record->ts_real.tv_sec), &t_real ) )
             {
                 snprintf( time_str, sizeof(time_str),
                           "YYYY:MM:DD HH:MM:SS.xxx" );
@@ -107,13 +89,13 @@ static void sm_debug_thread_dispatch( int selobj, int64_t user_data )
                 strftime( date_str, sizeof(date_str), "%FT%T",
                           &t_real );
                 snprintf( time_str, sizeof(time_str), "%s.%03ld", date_str,
-                          msg.u.log.ts_real.tv_nsec/1000000 );
+                          record->ts_real.tv_nsec/1000000 );
             }
 
             SM_WRITE_SCHEDLOG( "%s sm: time[%ld.%03ld] %s", time_str,
-                               (long) msg.u.log.ts_mono.tv_sec,
-                               (long) msg.u.log.ts_mono.tv_nsec/1000000,
-                               msg.u.log.data );
+                               (long) record->ts_mono.tv_sec,
+                               (long) record->ts_mono.tv_nsec/1000000,
+                               data );
 
             sm_time_get( &time_now );
             ms_expired = sm_time_delta_in_ms( &time_now, &time_prev );
@@ -127,9 +109,9 @@ static void sm_debug_thread_dispatch( int selobj, int64_t user_data )
             sm_time_get( &time_prev );
 
             SM_SYSLOG( "time[%ld.%03ld] sm_svc_log<%" PRIu64 "> %s",
-                             (long) msg.u.log.ts_mono.tv_sec,
-                             (long) msg.u.log.ts_mono.tv_nsec/1000000,
-                             msg.u.log.seqnum, msg.u.log.data );
+                             (long) record->ts_mono.tv_sec,
+                             (long) record->ts_mono.tv_nsec/1000000,
+                             record->seqnum, data );
 
             sm_time_get( &time_now );
             ms_expired = sm_time_delta_in_ms( &time_now, &time_prev );
@@ -140,13 +122,189 @@ static void sm_debug_thread_dispatch( int selobj, int64_t user_data )
 
 
         default:
-            SM_SYSLOG( "Unknown message (%i) received.", msg.type );
+            SM_SYSLOG( "Unknown message (%i) received.", record->type );
             return;
         break;
     }
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Debug Thread - Binary Log Write
+// ===============================
+static void sm_debug_thread_binary_log_write( SmDebugBinaryRecordKindT kind,
+    const SmDebugThreadRecordT* record, uint8_t log_type, uint32_t format_id,
+    const char args[], uint16_t args_len )
+{
+    SmDebugBinaryRecordT binary;
+
+    memset( &binary, 0, sizeof(binary) );
+    binary.kind = kind;
+    binary.log_type = log_type;
+    binary.args_len = args_len;
+    binary.format_id = format_id;
+
+    if( NULL != record )
+    {
+        binary.seqnum = record->seqnum;
+        binary.mono_ns = (int64_t) record->ts_mono.tv_sec * 1000000000LL
+                       + record->ts_mono.tv_nsec;
+        binary.real_ns = (int64_t) record->ts_real.tv_sec * 1000000000LL
+                       + record->ts_real.tv_nsec;
+    }
+
+    fwrite( &binary, sizeof(binary), 1, _binary_log );
+    fwrite( args, 1, args_len, _binary_log );
+
+    _binary_log_bytes += sizeof(binary) + args_len;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Thread - Binary Log Open
+// ==============================
+// Opens the binary log on first use and rotates it once it is full, every
+// open starts a new session so formats are written again before use.
+static bool sm_debug_thread_binary_log_open( void )
+{
+    if( NULL != _binary_log )
+    {
+        if( SM_DEBUG_BINARY_LOG_MAX_BYTES > _binary_log_bytes )
+        {
+            return( true );
+        }
+
+        fclose( _binary_log );
+        _binary_log = NULL;
+
+        if( 0 > rename( SM_DEBUG_BINARY_LOG_FILE,
+                        SM_DEBUG_BINARY_LOG_FILE ".1" ) )
+        {
+            SM_SYSLOG( "Failed to rotate binary log file (%s), error=%s.",
+                       SM_DEBUG_BINARY_LOG_FILE, strerror( errno ) );
+        }
+
+    } else if( _binary_log_failed ) {
+        return( false );
+    }
+
+    _binary_log = fopen( SM_DEBUG_BINARY_LOG_FILE, "a" );
+    if( NULL == _binary_log )
+    {
+        SM_SYSLOG( "Failed to open binary log file (%s), error=%s, "
+                   "logging text.", SM_DEBUG_BINARY_LOG_FILE,
+                   strerror( errno ) );
+        _binary_log_failed = true;
+        return( false );
+    }
+
+    fseek( _binary_log, 0, SEEK_END );
+    _binary_log_bytes = ftell( _binary_log );
+
+    memset( _binary_format_written, 0, sizeof(_binary_format_written) );
+
+    sm_debug_thread_binary_log_write( SM_DEBUG_BINARY_RECORD_SESSION, NULL,
+                                      0, SM_DEBUG_BINARY_VERSION,
+                                      SM_DEBUG_BINARY_MAGIC,
+                                      strlen( SM_DEBUG_BINARY_MAGIC ) );
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Thread - Binary Log
+// =========================
+static void sm_debug_thread_binary_log( const SmDebugThreadRecordT* record,
+    const char data[] )
+{
+    SmDebugBinaryLogT log;
+    const char* format;
+
+    memcpy( &log, data, sizeof(log) );
+
+    format = sm_debug_binary_format( log.format_id );
+    if( NULL == format )
+    {
+        SM_SYSLOG( "Unknown binary log format (%u).", log.format_id );
+        return;
+    }
+
+    if( !sm_debug_thread_binary_log_open() )
+    {
+        SmDebugThreadRecordT text_record = *record;
+        char text[SM_DEBUG_THREAD_LOG_MAX_CHARS];
+
+        sm_debug_binary_decode( format, &(data[sizeof(log)]), log.args_len,
+                                text, sizeof(text) );
+        text_record.type = log.log_type;
+        sm_debug_thread_log( &text_record, text );
+        return;
+    }
+
+    if( !_binary_format_written[log.format_id] )
+    {
+        size_t format_len = strnlen( format, UINT16_MAX );
+
+        sm_debug_thread_binary_log_write( SM_DEBUG_BINARY_RECORD_FORMAT,
+                                          NULL, 0, log.format_id, format,
+                                          (uint16_t) format_len );
+        _binary_format_written[log.format_id] = true;
+    }
+
+    sm_debug_thread_binary_log_write( SM_DEBUG_BINARY_RECORD_LOG, record,
+                                      (uint8_t) log.log_type, log.format_id,
+                                      &(data[sizeof(log)]), log.args_len );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Thread - Record
+// =====================
+static void sm_debug_thread_record( const SmDebugThreadRecordT* record,
+    const char data[] )
+{
+    if( SM_DEBUG_THREAD_MSG_BINARY_LOG == record->type )
+    {
+        sm_debug_thread_binary_log( record, data );
+    } else {
+        sm_debug_thread_log( record, data );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Thread - Drain
+// ====================
+static void sm_debug_thread_drain( void )
+{
+    sm_debug_drain( sm_debug_thread_record );
+
+    if( NULL != _binary_log )
+    {
+        fflush( _binary_log );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Debug Thread - Dispatch
+// =======================
+static void sm_debug_thread_dispatch( int selobj, int64_t user_data )
+{
+    uint64_t count;
+
+    if( 0 > read( selobj, &count, sizeof(count) ) )
+    {
+        if(( EAGAIN != errno )&&( EINTR != errno ))
+        {
+            SM_SYSLOG( "Failed to read event, errno=%s.", strerror( errno ) );
+        }
+    }
+
+    sm_debug_thread_drain();
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Debug Thread - Initialize Thread
 // ================================
@@ -154,7 +312,7 @@ static SmErrorT sm_debug_thread_initialize_thread( void )
 {
     SmErrorT error;
 
-    _server_fd_registered = false;
+    _event_fd_registered = false;
 
     error = sm_selobj_initialize();
     if( SM_OKAY != error )
@@ -164,9 +322,9 @@ static SmErrorT sm_debug_thread_initialize_thread( void )
         return( SM_FAILED );
     }
 
-    if( -1 < _server_fd )
+    if( -1 < _event_fd )
     {
-        error = sm_selobj_register( _server_fd, sm_debug_thread_dispatch, 0 );
+        error = sm_selobj_register( _event_fd, sm_debug_thread_dispatch, 0 );
         if( SM_OKAY != error )
         {
             SM_SYSLOG( "Failed to register selection object, error=%s.",
@@ -174,7 +332,7 @@ static SmErrorT sm_debug_thread_initialize_thread( void )
             return( error );
         }    
 
-        _server_fd_registered = true;
+        _event_fd_registered = true;
     }
 
     return( SM_OKAY );
@@ -188,16 +346,16 @@ static SmErrorT sm_debug_thread_finalize_thread( void )
 {
     SmErrorT error;
 
-    if( _server_fd_registered )
+    if( _event_fd_registered )
     {
-        error = sm_selobj_deregister( _server_fd );
+        error = sm_selobj_deregister( _event_fd );
         if( SM_OKAY != error )
         {
             SM_SYSLOG( "Failed to deregister selection object, error=%s.",
                        sm_error_str( error ) );
         }
 
-        _server_fd_registered = false;
+        _event_fd_registered = false;
     }
 
     error = sm_selobj_finalize();
@@ -242,8 +400,12 @@ static void* sm_debug_thread_main( void* arguments )
                       sm_error_str(error) );
             break;
         }
+
+        sm_debug_thread_drain();
     }
 
+    sm_debug_thread_drain();
+
     SM_SYSLOG( "Shutting down." );
 
     error = sm_debug_thread_finalize_thread();
@@ -262,13 +424,13 @@ static void* sm_debug_thread_main( void* arguments )
 // ****************************************************************************
 // Debug Thread - Start
 // ====================
-SmErrorT sm_debug_thread_start( int server_fd )
+SmErrorT sm_debug_thread_start( int event_fd )
 {
     int result;
 
     _stay_on = 1;
     _thread_created = false;
-    _server_fd = server_fd;
+    _event_fd = event_fd;
 
     openlog( NULL, LOG_NDELAY, LOG_LOCAL3 );
 
@@ -312,8 +474,11 @@ SmErrorT sm_debug_thread_stop( void )
         while( true )
         {
             result = pthread_tryjoin_np( _debug_thread, NULL );
-            if(( 0 != result )&&( EBUSY != result ))
+            if( 0 == result )
             {
+                break;
+
+            } else if( EBUSY != result ) {
                 if(( ESRCH != result )&&( EINVAL != result ))
                 {
                     printf( "Failed to wait for debug thread exit, "
@@ -344,7 +509,15 @@ SmErrorT sm_debug_thread_stop( void )
         _sched_log = NULL;
     }
 
-    _server_fd = -1;
+    if( NULL != _binary_log )
+    {
+        fflush( _binary_log );
+        fclose( _binary_log );
+        _binary_log = NULL;
+    }
+    _binary_log_failed = false;
+
+    _event_fd = -1;
     _thread_created = false;
 
     closelog();
@@ -19,10 +19,27 @@ typedef enum
     SM_DEBUG_THREAD_MSG_LOG,
     SM_DEBUG_THREAD_MSG_SCHED_LOG,
     SM_DEBUG_THREAD_MSG_SERVICE_LOG,
+    SM_DEBUG_THREAD_MSG_BINARY_LOG,
+    SM_DEBUG_THREAD_MSG_PAD,
 } SmDebugThreadMsgTypeT;
 
 #define SM_DEBUG_THREAD_LOG_MAX_CHARS       512
 
+// Log record as stored in a per-thread log ring, followed by the
+// nul-terminated log text, or for a binary log by an SmDebugBinaryLogT
+// and its encoded arguments.  Size covers header, data and alignment.
+typedef struct
+{
+    uint32_t size;
+    uint32_t type;
+    uint64_t seqnum;
+    struct timespec ts_mono;
+    struct timespec ts_real;
+} SmDebugThreadRecordT;
+
+typedef void (*SmDebugThreadDrainCallbackT) (
+    const SmDebugThreadRecordT* record, const char data[] );
+
 typedef struct
 {
     uint64_t seqnum;
@@ -41,10 +58,18 @@ typedef struct
     } u;
 } SmDebugThreadMsgT;
 
+// ****************************************************************************
+// Debug - Drain
+// =============
+// Passes every log record queued in the per-thread log rings to the
+// callback and reports dropped logs, called from the debug thread only.
+extern void sm_debug_drain( SmDebugThreadDrainCallbackT callback );
+// ****************************************************************************
+
 // ****************************************************************************
 // Debug Thread - Start
 // ====================
-extern SmErrorT sm_debug_thread_start( int server_fd );
+extern SmErrorT sm_debug_thread_start( int event_fd );
 // ****************************************************************************
 
 // ****************************************************************************
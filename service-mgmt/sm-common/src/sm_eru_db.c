@@ -28,109 +28,199 @@
 #include "sm_types.h"
 #include "sm_debug.h"
 
-#define SM_ERU_DB_FILENAME                          "/var/lib/sm/sm.eru.v1"
-#define SM_ERU_DB_MMAP_INITIALIZED                               0xA5A5A5A5
-#define SM_ERU_DB_MAX_RECORDS                                       4194304
-#define SM_ERU_DB_HEADER_SIZE                                             8
+#define SM_ERU_DB_FILENAME                          "/var/lib/sm/sm.eru.v3"
+#define SM_ERU_DB_FILENAME_V1                       "/var/lib/sm/sm.eru.v1"
+#define SM_ERU_DB_MAGIC                                          0x53455255
+#define SM_ERU_DB_VERSION                                                 3
+#define SM_ERU_DB_HEADER_SIZE                                          4096
+#define SM_ERU_DB_INDEX_MAX \
+    (SM_ERU_DB_MAX_RECORDS / SM_ERU_DB_INDEX_INTERVAL)
+#define SM_ERU_DB_FILL_SIZE_V1                                      1048576
+
+// The header is only ever advanced after the record it covers is stored,
+// the generation counts every record appended since the file was created.
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t max_records;
+    uint32_t index_interval;
+    uint32_t reserved;
+    uint64_t generation;
+} SmEruDatabaseHeaderT;
+
+// Sparse time index, one entry per segment of SM_ERU_DB_INDEX_INTERVAL
+// records holding the time of the first record of the segment.  Tagged
+// like the records with the generation of that first record plus one.
+typedef struct
+{
+    uint64_t generation;
+    int64_t time_ms;
+    uint64_t generation_end;
+} SmEruDatabaseIndexT;
+
+// A record is whole when both generation tags match, they hold the
+// generation of the append plus one and are zero while it is overwritten.
+typedef struct
+{
+    uint64_t generation;
+    SmEruDatabaseEntryT entry;
+    uint64_t generation_end;
+} SmEruDatabaseRecordT;
 
 typedef struct
 {
     bool initialized;
     bool read_only;
     int fd;
-    FILE* fp;
-    off_t file_size;
+    size_t map_size;
+    void* map;
+    SmEruDatabaseHeaderT* header;
+    SmEruDatabaseIndexT* index;
+    SmEruDatabaseRecordT* records;
+    uint64_t sync_generation;
+    bool age_out_pending;
 } SmEruDBFileInfoT;
 
+// Header of the sm.eru.v1 file, followed by the entries without tags.
 typedef struct
 {
     int write_index;
     bool wrapped;
-} SmEruDatabaseHeaderT;
+} SmEruDatabaseHeaderV1T;
+
+// The sm.eru.v1 file, mapped read-only.  Its entries are numbered from
+// zero, the oldest, to count minus one.
+typedef struct
+{
+    int fd;
+    size_t map_size;
+    void* map;
+    uint64_t first;
+    uint64_t count;
+} SmEruDBOldFileT;
 
-static SmEruDBFileInfoT _file_info;
-static SmEruDatabaseHeaderT _file_header;
+typedef struct
+{
+    pthread_t thread;
+    bool joinable;
+    int read_index;
+    int num_records;
+    const SmEruDatabaseFilterT* filter;
+    char* buf;
+    size_t buf_len;
+    int matched;
+} SmEruDBDumpWorkT;
+
+static SmEruDBFileInfoT _file_info = { false, false, -1, 0, MAP_FAILED };
+
+static_assert( 0 == (SM_ERU_DB_MAX_RECORDS % SM_ERU_DB_INDEX_INTERVAL),
+               "index interval does not divide the ring" );
 
-static uint32_t _1MB_data_block[1048576/sizeof(uint32_t)];
+static bool sm_eru_db_age_out( void );
 
 // ****************************************************************************
-// Event Recorder Unit Database - Read Lock
-// ========================================
-static SmErrorT sm_eru_db_read_lock( void )
+// Event Recorder Unit Database - Generation
+// =========================================
+static uint64_t sm_eru_db_generation( void )
 {
-    struct flock lock;
-    int result;
+    return( __atomic_load_n( &(_file_info.header->generation),
+                             __ATOMIC_ACQUIRE ) );
+}
+// ****************************************************************************
 
-    memset( &lock, 0, sizeof(lock) );
-    lock.l_type = F_RDLCK;
+// ****************************************************************************
+// Event Recorder Unit Database - Record Generation
+// ================================================
+// Returns the generation tag of a whole record, or zero when the record
+// was never written or is torn.
+static uint64_t sm_eru_db_record_generation( int index,
+    SmEruDatabaseEntryT* entry )
+{
+    SmEruDatabaseRecordT* record = &(_file_info.records[index]);
+    uint64_t generation;
+    uint64_t generation_end;
 
-    int retry_i;
-    for( retry_i=0; 10 > retry_i; ++retry_i )
+    generation = __atomic_load_n( &(record->generation), __ATOMIC_ACQUIRE );
+    if( NULL != entry )
     {
-        result = fcntl( _file_info.fd, F_SETLK, &lock );
-        if( 0 == result )
-        {
-            return( SM_OKAY );
-        }
+        memcpy( entry, &(record->entry), sizeof(SmEruDatabaseEntryT) );
+    }
+    __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    generation_end = __atomic_load_n( &(record->generation_end),
+                                      __ATOMIC_RELAXED );
 
-        usleep( 50000 ); // 50 milliseconds.
+    if(( generation != generation_end )||
+       ( (uint64_t) index != ((generation - 1) % SM_ERU_DB_MAX_RECORDS) ))
+    {
+        return( 0 );
     }
 
-    return( SM_FAILED );
+    return( generation );
 }
 // ****************************************************************************
 
 // ****************************************************************************
-// Event Recorder Unit Database - Write Lock
-// =========================================
-static SmErrorT sm_eru_db_write_lock( void )
+// Event Recorder Unit Database - Index Update
+// ===========================================
+// Called once the first record of a segment is stored.
+static void sm_eru_db_index_update( uint64_t generation,
+    SmEruDatabaseEntryT* entry )
 {
-    struct flock lock;
-    int result;
+    SmEruDatabaseIndexT* index_entry;
 
-    memset( &lock, 0, sizeof(lock) );
-    lock.l_type = F_WRLCK;
+    index_entry = &(_file_info.index[(generation / SM_ERU_DB_INDEX_INTERVAL)
+                                     % SM_ERU_DB_INDEX_MAX]);
 
-    int retry_i;
-    for( retry_i=0; 10 > retry_i; ++retry_i )
-    {
-        result = fcntl( _file_info.fd, F_SETLK, &lock );
-        if( 0 == result )
-        {
-            return( SM_OKAY );
-        }
+    __atomic_store_n( &(index_entry->generation), 0, __ATOMIC_RELAXED );
+    __atomic_store_n( &(index_entry->generation_end), 0, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
 
-        usleep( 50000 ); // 50 milliseconds.
-    }
+    index_entry->time_ms = (int64_t) entry->ts_real.tv_sec * 1000
+                         + entry->ts_real.tv_nsec / 1000000;
 
-    return( SM_FAILED );
+    __atomic_store_n( &(index_entry->generation_end), generation + 1,
+                      __ATOMIC_RELEASE );
+    __atomic_store_n( &(index_entry->generation), generation + 1,
+                      __ATOMIC_RELEASE );
 }
 // ****************************************************************************
 
 // ****************************************************************************
-// Event Recorder Unit Database - Unlock
-// =====================================
-static void sm_eru_db_unlock( void )
+// Event Recorder Unit Database - Segment Time
+// ===========================================
+// Time of the first record of a segment, from the index or, while the
+// index entry is being written, from the record itself.
+static bool sm_eru_db_segment_time( uint64_t segment, int64_t* time_ms )
 {
-    struct flock lock;
-    int result;
+    SmEruDatabaseIndexT* index_entry;
+    SmEruDatabaseEntryT entry;
+    uint64_t generation = segment * SM_ERU_DB_INDEX_INTERVAL;
+    uint64_t tag;
+
+    index_entry = &(_file_info.index[segment % SM_ERU_DB_INDEX_MAX]);
 
-    memset( &lock, 0, sizeof(lock) );
-    lock.l_type = F_UNLCK;
+    tag = __atomic_load_n( &(index_entry->generation), __ATOMIC_ACQUIRE );
+    *time_ms = index_entry->time_ms;
+    __atomic_thread_fence( __ATOMIC_ACQUIRE );
 
-    int retry_i;
-    for( retry_i=0; 10 > retry_i; ++retry_i )
+    if(( generation + 1 == tag )&&
+       ( tag == __atomic_load_n( &(index_entry->generation_end),
+                                 __ATOMIC_RELAXED ) ))
     {
-        result = fcntl( _file_info.fd, F_SETLK, &lock );
-        if( 0 == result )
-        {
-            return;
-        }
+        return( true );
+    }
 
-        usleep( 50000 ); // 50 milliseconds.
+    if( generation + 1 == sm_eru_db_record_generation(
+                            generation % SM_ERU_DB_MAX_RECORDS, &entry ) )
+    {
+        *time_ms = (int64_t) entry.ts_real.tv_sec * 1000
+                 + entry.ts_real.tv_nsec / 1000000;
+        return( true );
     }
 
-    abort();
+    return( false );
 }
 // ****************************************************************************
 
@@ -139,17 +229,20 @@ static void sm_eru_db_unlock( void )
 // ====================================
 int sm_eru_db_total( void )
 {
+    uint64_t generation;
+
     if( !_file_info.initialized )
     {
         DPRINTFE( "Database is not initialized." );
         return( 0 );
     }
 
-    if( _file_header.wrapped )
+    generation = sm_eru_db_generation();
+    if( SM_ERU_DB_MAX_RECORDS <= generation )
     {
         return( SM_ERU_DB_MAX_RECORDS );
     }
-    return( _file_header.write_index );
+    return( (int) generation );
 }
 // ****************************************************************************
 
@@ -164,19 +257,200 @@ int sm_eru_db_get_write_index( void )
         return( -1 );
     }
 
-    return( _file_header.write_index );
+    return( (int) (sm_eru_db_generation() % SM_ERU_DB_MAX_RECORDS) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Find Window
+// ==========================================
+SmErrorT sm_eru_db_find_window( time_t start_time, time_t end_time,
+    int* read_index, int* num_records )
+{
+    uint64_t generation, oldest, begin, end;
+    uint64_t first_segment, last_segment;
+    uint64_t lo, hi, mid;
+    int64_t time_ms;
+
+    if( !_file_info.initialized )
+    {
+        DPRINTFE( "Database is not initialized." );
+        return( SM_FAILED );
+    }
+
+    generation = sm_eru_db_generation();
+    oldest = 0;
+    if( SM_ERU_DB_MAX_RECORDS < generation )
+    {
+        oldest = generation - SM_ERU_DB_MAX_RECORDS;
+    }
+
+    begin = oldest;
+    end = generation;
+
+    // Only segments whose first record is still in the ring are searched,
+    // records before the first of them are in the oldest partial segment.
+    first_segment = (oldest + SM_ERU_DB_INDEX_INTERVAL - 1)
+                  / SM_ERU_DB_INDEX_INTERVAL;
+    last_segment = generation / SM_ERU_DB_INDEX_INTERVAL;
+    if( 0 == (generation % SM_ERU_DB_INDEX_INTERVAL) )
+    {
+        --last_segment;
+    }
+
+    if(( 0 < generation )&&( first_segment <= last_segment ))
+    {
+        // Segment time unknown means it is being overwritten, both searches
+        // then widen the window rather than narrow it.
+        if( 0 != start_time )
+        {
+            int64_t start_ms = (int64_t) start_time * 1000;
+
+            lo = first_segment;
+            hi = last_segment + 1;
+            while( lo < hi )
+            {
+                mid = lo + (hi - lo) / 2;
+                if(( sm_eru_db_segment_time( mid, &time_ms ) )&&
+                   ( time_ms <= start_ms ))
+                {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+
+            if( first_segment < lo )
+            {
+                begin = (lo - 1) * SM_ERU_DB_INDEX_INTERVAL;
+            }
+        }
+
+        if( 0 != end_time )
+        {
+            int64_t end_ms = (int64_t) end_time * 1000 + 999;
+
+            lo = first_segment;
+            hi = last_segment + 1;
+            while( lo < hi )
+            {
+                mid = lo + (hi - lo) / 2;
+                if(( sm_eru_db_segment_time( mid, &time_ms ) )&&
+                   ( time_ms > end_ms ))
+                {
+                    hi = mid;
+                } else {
+                    lo = mid + 1;
+                }
+            }
+
+            if( last_segment >= lo )
+            {
+                end = lo * SM_ERU_DB_INDEX_INTERVAL;
+            }
+
+            if( end < begin )
+            {
+                end = begin;
+            }
+        }
+    }
+
+    *read_index = (int) (begin % SM_ERU_DB_MAX_RECORDS);
+    *num_records = (int) (end - begin);
+
+    return( SM_OKAY );
 }
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Sync Range
+// =========================================
+static void sm_eru_db_sync_range( void* addr, size_t len, int flags )
+{
+    static long page_size = 0;
+    uintptr_t start;
+    uintptr_t end;
+
+    if( 0 == page_size )
+    {
+        page_size = sysconf( _SC_PAGESIZE );
+    }
+
+    start = (uintptr_t) addr & ~((uintptr_t) page_size - 1);
+    end = (uintptr_t) addr + len;
+
+    if( 0 > msync( (void*) start, end - start, flags ) )
+    {
+        DPRINTFE( "Failed to sync database, error=%s.", strerror(errno) );
+    }
+}
+// ****************************************************************************
 
 // ****************************************************************************
 // Event Recorder Unit Database - Flush the database
 // =================================================
 void sm_eru_db_sync( void )
 {
-    if( _file_info.fp != NULL )
+    uint64_t generation;
+    uint64_t count;
+    int first, last;
+
+    if(( !_file_info.initialized )||( _file_info.read_only ))
+    {
+        return;
+    }
+
+    generation = sm_eru_db_generation();
+    if( generation == _file_info.sync_generation )
+    {
+        return;
+    }
+
+    // Stores to the map are in the page cache and survive the process, so
+    // only writeback of the records appended since the last sync is started
+    // here, ahead of the header that covers them.
+    count = generation - _file_info.sync_generation;
+    if( SM_ERU_DB_MAX_RECORDS <= count )
     {
-       fflush( _file_info.fp );
-       fsync(fileno(_file_info.fp));
+        sm_eru_db_sync_range( _file_info.records, sizeof(SmEruDatabaseRecordT)
+                              * SM_ERU_DB_MAX_RECORDS, MS_ASYNC );
+    } else {
+        first = _file_info.sync_generation % SM_ERU_DB_MAX_RECORDS;
+        last = (generation - 1) % SM_ERU_DB_MAX_RECORDS;
+
+        if( first <= last )
+        {
+            sm_eru_db_sync_range( &(_file_info.records[first]),
+                sizeof(SmEruDatabaseRecordT) * (last - first + 1), MS_ASYNC );
+        } else {
+            sm_eru_db_sync_range( &(_file_info.records[first]),
+                sizeof(SmEruDatabaseRecordT)
+                * (SM_ERU_DB_MAX_RECORDS - first), MS_ASYNC );
+            sm_eru_db_sync_range( _file_info.records,
+                sizeof(SmEruDatabaseRecordT) * (last + 1), MS_ASYNC );
+        }
     }
+
+    if( (generation / SM_ERU_DB_INDEX_INTERVAL)
+        != (_file_info.sync_generation / SM_ERU_DB_INDEX_INTERVAL) )
+    {
+        sm_eru_db_sync_range( _file_info.index, sizeof(SmEruDatabaseIndexT)
+                              * SM_ERU_DB_INDEX_MAX, MS_ASYNC );
+
+        // Once the ring has wrapped, the v1 file is checked a segment at a
+        // time until its records have aged out.
+        if(( _file_info.age_out_pending )&&
+           ( SM_ERU_DB_MAX_RECORDS <= generation ))
+        {
+            _file_info.age_out_pending = sm_eru_db_age_out();
+        }
+    }
+
+    sm_eru_db_sync_range( _file_info.header, sizeof(SmEruDatabaseHeaderT),
+                          MS_ASYNC );
+
+    _file_info.sync_generation = generation;
 }
 // ****************************************************************************
 
@@ -185,106 +459,93 @@ void sm_eru_db_sync( void )
 // ===================================
 SmErrorT sm_eru_db_read( int read_index, SmEruDatabaseEntryT* entry )
 {
-    SmErrorT error;
-
     if( !_file_info.initialized )
     {
         DPRINTFE( "Database is not initialized." );
         return( SM_NOT_FOUND );
     }
 
-    if(( 0 > read_index )&&( SM_ERU_DB_MAX_RECORDS <= read_index ))
+    if(( 0 > read_index )||( SM_ERU_DB_MAX_RECORDS <= read_index ))
     {
         DPRINTFE( "Database read index (%i) is invalid.", read_index );
         return( SM_FAILED );
     }
-    
-    error = sm_eru_db_read_lock();
-    if( SM_OKAY != error )
+
+    if( 0 == sm_eru_db_record_generation( read_index, entry ) )
     {
-        DPRINTFE( "Failed to get eru database read lock, error=%s.",
-                  sm_error_str(error) );
-        return( error );
+        return( SM_NOT_FOUND );
     }
 
-    fseek(_file_info.fp, (read_index*sizeof(SmEruDatabaseEntryT))+SM_ERU_DB_HEADER_SIZE, SEEK_SET);
-    fread(entry, 1, sizeof(SmEruDatabaseEntryT), _file_info.fp);
-
-    sm_eru_db_unlock();
-
     return( SM_OKAY );
 }
 // ****************************************************************************
 
 // ****************************************************************************
-// Event Recorder Unit Database - Write
-// ====================================
-SmErrorT sm_eru_db_write( SmEruDatabaseEntryT* entry )
+// Event Recorder Unit Database - Append
+// =====================================
+// Stores the entry as the next record, keeping the time it carries.
+static void sm_eru_db_append( SmEruDatabaseEntryT* entry )
 {
-    SmErrorT error;
+    SmEruDatabaseRecordT* record;
+    uint64_t generation;
+    int write_index;
 
-    if( !_file_info.initialized )
-    {
-        DPRINTFE( "Database is not initialized." );
-        return( SM_FAILED );
-    }
+    // Single writer, readers only ever look at whole records.
+    generation = _file_info.header->generation;
+    write_index = generation % SM_ERU_DB_MAX_RECORDS;
+    record = &(_file_info.records[write_index]);
 
-    error = sm_eru_db_write_lock();
-    if( SM_OKAY != error )
-    {
-        DPRINTFE( "Failed to get eru database write lock, error=%s.",
-                  sm_error_str(error) );
-        return( error );
-    }
+    entry->index = write_index;
 
-    clock_gettime( CLOCK_REALTIME, &(entry->ts_real) );
-    entry->index = _file_header.write_index;
+    __atomic_store_n( &(record->generation), 0, __ATOMIC_RELAXED );
+    __atomic_store_n( &(record->generation_end), 0, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
 
-    fseek(_file_info.fp, (_file_header.write_index*sizeof(SmEruDatabaseEntryT))+SM_ERU_DB_HEADER_SIZE, SEEK_SET);
-    size_t written = fwrite(entry, 1, sizeof(SmEruDatabaseEntryT), _file_info.fp);
+    memcpy( &(record->entry), entry, sizeof(SmEruDatabaseEntryT) );
 
-    if( 0 > written )
-    {
-        DPRINTFE( "Failed to write , error=%s.", strerror(errno) );
-        sm_eru_db_unlock();
-        return( SM_FAILED );
-    }
-    if( written != sizeof(SmEruDatabaseEntryT))
+    __atomic_store_n( &(record->generation_end), generation + 1,
+                      __ATOMIC_RELEASE );
+    __atomic_store_n( &(record->generation), generation + 1,
+                      __ATOMIC_RELEASE );
+
+    if( 0 == (generation % SM_ERU_DB_INDEX_INTERVAL) )
     {
-        DPRINTFE( "Failed to write, %lu bytes should of been written instead of %lu", sizeof(SmEruDatabaseEntryT), written );
-        sm_eru_db_unlock();
-        return( SM_FAILED );
+        sm_eru_db_index_update( generation, entry );
     }
 
-    ++(_file_header.write_index);
+    __atomic_store_n( &(_file_info.header->generation), generation + 1,
+                      __ATOMIC_RELEASE );
 
-    if( SM_ERU_DB_MAX_RECORDS <= _file_header.write_index )
+    if( SM_ERU_DB_MAX_RECORDS - 1 == write_index )
     {
         DPRINTFD( "Database wrapped." );
-        _file_header.wrapped = true;
-        _file_header.write_index = 0;
     }
+}
+// ****************************************************************************
 
-    // The first 8 bytes of the database contains the write index and the wrapped flag
-    unsigned char buffer[SM_ERU_DB_HEADER_SIZE];
-    memset( &buffer, 0, SM_ERU_DB_HEADER_SIZE);
-
-    memcpy( buffer, &_file_header.write_index, sizeof(int));
-    memcpy( buffer+sizeof(int), &_file_header.wrapped, sizeof(bool));
+// ****************************************************************************
+// Event Recorder Unit Database - Write
+// ====================================
+SmErrorT sm_eru_db_write( SmEruDatabaseEntryT* entry )
+{
+    if(( !_file_info.initialized )||( _file_info.read_only ))
+    {
+        DPRINTFE( "Database is not initialized for write." );
+        return( SM_FAILED );
+    }
 
-    fseek(_file_info.fp, 0, SEEK_SET);
-    fwrite(buffer, 1, SM_ERU_DB_HEADER_SIZE, _file_info.fp);
+    clock_gettime( CLOCK_REALTIME, &(entry->ts_real) );
 
-    sm_eru_db_unlock();
+    sm_eru_db_append( entry );
 
     return( SM_OKAY );
 }
 // ****************************************************************************
 
 // ****************************************************************************
-// Event Recorder Unit Database - Display
-// ======================================
-void sm_eru_db_display( SmEruDatabaseEntryT* entry, bool want_raw )
+// Event Recorder Unit Database - Print
+// ====================================
+void sm_eru_db_print( FILE* fp, SmEruDatabaseEntryT* entry, bool want_raw )
 {
     char time_str[80];
     char date_str[32];
@@ -303,6 +564,7 @@ void sm_eru_db_display( SmEruDatabaseEntryT* entry, bool want_raw )
     SmHwQdiscInfoT* qdisc = &(entry->u.tc_stats);
     SmHwInterfaceChangeDataT* if_change = &(entry->u.if_change);
     SmHwIpChangeDataT* ip_change = &(entry->u.ip_change);
+    SmEruServiceStatsT* service = &(entry->u.service_stats);
 
     if( NULL == localtime_r( &(entry->ts_real.tv_sec), &t_real ) )
     {
@@ -313,7 +575,7 @@ void sm_eru_db_display( SmEruDatabaseEntryT* entry, bool want_raw )
                   entry->ts_real.tv_nsec/1000000 );
     }
 
-    printf( "%10i. %s " , entry->index, time_str );
+    fprintf( fp, "%10i. %s " , entry->index, time_str );
 
     switch( entry->type )
     {
@@ -349,105 +611,105 @@ void sm_eru_db_display( SmEruDatabaseEntryT* entry, bool want_raw )
                 guest_nice = (long double)cpu->guest_nice_cpu_usage
                            /(long double)total_time * 100.0;
 
-                printf( "cpu-stats: %s user: %5.1Lf nice: %5.1Lf sys: %5.1Lf"
-                        " idle: %5.1Lf iowait: %5.1Lf irq: %5.1Lf"
-                        " soft-irq: %5.1Lf steal: %5.1Lf guest-cpu: %5.1Lf"
-                        " guest-nice: %5.1Lf total-interrupts: %llu"
-                        " total-context-switches: %llu"
-                        " total-processes: %llu processes_running: %llu"
-                        " processes_blocked: %llu boot_time_in_secs: %llu\n",
-                        cpu->cpu_name, user, nice, sys, idle, iowait, irq,
-                        soft_irq, steal, guest, guest_nice,
-                        cpu->total_interrupts, cpu->total_context_switches,
-                        cpu->total_processes, cpu->processes_running,
-                        cpu->processes_blocked, cpu->boot_time_in_secs );
+                fprintf( fp, "cpu-stats: %s user: %5.1Lf nice: %5.1Lf sys: %5.1Lf"
+                         " idle: %5.1Lf iowait: %5.1Lf irq: %5.1Lf"
+                         " soft-irq: %5.1Lf steal: %5.1Lf guest-cpu: %5.1Lf"
+                         " guest-nice: %5.1Lf total-interrupts: %llu"
+                         " total-context-switches: %llu"
+                         " total-processes: %llu processes_running: %llu"
+                         " processes_blocked: %llu boot_time_in_secs: %llu\n",
+                         cpu->cpu_name, user, nice, sys, idle, iowait, irq,
+                         soft_irq, steal, guest, guest_nice,
+                         cpu->total_interrupts, cpu->total_context_switches,
+                         cpu->total_processes, cpu->processes_running,
+                         cpu->processes_blocked, cpu->boot_time_in_secs );
             } else {
                 want_raw = true;
             }
 
             if( want_raw )
             {
-                printf( "cpu-raw-stats: %s user: %llu nice: %llu sys: %llu"
-                        " idle: %llu iowait: %llu irq: %llu soft-irq: %llu"
-                        " steal: %llu guest-cpu: %llu guest-nice: %llu"
-                        " total-interrupts: %llu total-context-switches: %llu"
-                        " total-processes: %llu processes_running: %llu"
-                        " processes_blocked: %llu boot_time_in_secs: %llu\n",
-                        cpu->cpu_name, cpu->user_cpu_usage, cpu->nice_cpu_usage,
-                        cpu->system_cpu_usage, cpu->idle_task_cpu_usage,
-                        cpu->iowait_cpu_usage, cpu->irq_cpu_usage,
-                        cpu->soft_irq_cpu_usage, cpu->steal_cpu_usage,
-                        cpu->guest_cpu_usage, cpu->guest_nice_cpu_usage,
-                        cpu->total_interrupts, cpu->total_context_switches,
-                        cpu->total_processes, cpu->processes_running,
-                        cpu->processes_blocked, cpu->boot_time_in_secs );
+                fprintf( fp, "cpu-raw-stats: %s user: %llu nice: %llu sys: %llu"
+                         " idle: %llu iowait: %llu irq: %llu soft-irq: %llu"
+                         " steal: %llu guest-cpu: %llu guest-nice: %llu"
+                         " total-interrupts: %llu total-context-switches: %llu"
+                         " total-processes: %llu processes_running: %llu"
+                         " processes_blocked: %llu boot_time_in_secs: %llu\n",
+                         cpu->cpu_name, cpu->user_cpu_usage, cpu->nice_cpu_usage,
+                         cpu->system_cpu_usage, cpu->idle_task_cpu_usage,
+                         cpu->iowait_cpu_usage, cpu->irq_cpu_usage,
+                         cpu->soft_irq_cpu_usage, cpu->steal_cpu_usage,
+                         cpu->guest_cpu_usage, cpu->guest_nice_cpu_usage,
+                         cpu->total_interrupts, cpu->total_context_switches,
+                         cpu->total_processes, cpu->processes_running,
+                         cpu->processes_blocked, cpu->boot_time_in_secs );
             }
         break;
 
         case SM_ERU_DATABASE_ENTRY_TYPE_MEM_STATS:
-            printf( "mem-stats: total: %lu free: %lu buffers: %lu"
-                    " cached: %lu swap-cached: %lu swap-total: %lu"
-                    " swap-free: %lu active: %lu inactive: %lu"
-                    " dirty: %lu hugepages-total: %lu"
-                    " hugepages-free: %lu hugepage-size: %lu"
-                    " nfs-uncommited: %lu commited: %lu\n",
-                    mem->total_memory_kB, mem->free_memory_kB,
-                    mem->buffers_kB, mem->cached_kB, mem->swap_cached_kB,
-                    mem->swap_total_kB, mem->swap_free_kB, mem->active_kB,
-                    mem->inactive_kB, mem->dirty_kB, mem->hugepages_total,
-                    mem->hugepages_free, mem->hugepage_size_kB,
-                    mem->nfs_uncommited_kB, mem->commited_memory_kB );
+            fprintf( fp, "mem-stats: total: %lu free: %lu buffers: %lu"
+                     " cached: %lu swap-cached: %lu swap-total: %lu"
+                     " swap-free: %lu active: %lu inactive: %lu"
+                     " dirty: %lu hugepages-total: %lu"
+                     " hugepages-free: %lu hugepage-size: %lu"
+                     " nfs-uncommited: %lu commited: %lu\n",
+                     mem->total_memory_kB, mem->free_memory_kB,
+                     mem->buffers_kB, mem->cached_kB, mem->swap_cached_kB,
+                     mem->swap_total_kB, mem->swap_free_kB, mem->active_kB,
+                     mem->inactive_kB, mem->dirty_kB, mem->hugepages_total,
+                     mem->hugepages_free, mem->hugepage_size_kB,
+                     mem->nfs_uncommited_kB, mem->commited_memory_kB );
         break;
 
         case SM_ERU_DATABASE_ENTRY_TYPE_DISK_STATS:
-            printf( "disk-stats: %s major: %i minor: %i"
-                    " reads-completed: %lu reads-merged: %lu"
-                    " sectors-read: %lu ms-spent-reading: %lu"
-                    " writes-completed: %lu writes-merged: %lu"
-                    " sectors-written: %lu ms-spent-writing: %lu"
-                    " io-inprogress: %lu ms-spent-io: %lu"
-                    " weighted-ms-spent-io: %lu\n", disk->dev_name,
-                    disk->major_num, disk->minor_num, disk->reads_completed,
-                    disk->reads_merged, disk->sectors_read,
-                    disk->ms_spent_reading, disk->writes_completed,
-                    disk->writes_merged, disk->sectors_written, 
-                    disk->ms_spent_writing, disk->io_inprogress,
-                    disk->ms_spent_io, disk->weighted_ms_spent_io );
+            fprintf( fp, "disk-stats: %s major: %i minor: %i"
+                     " reads-completed: %lu reads-merged: %lu"
+                     " sectors-read: %lu ms-spent-reading: %lu"
+                     " writes-completed: %lu writes-merged: %lu"
+                     " sectors-written: %lu ms-spent-writing: %lu"
+                     " io-inprogress: %lu ms-spent-io: %lu"
+                     " weighted-ms-spent-io: %lu\n", disk->dev_name,
+                     disk->major_num, disk->minor_num, disk->reads_completed,
+                     disk->reads_merged, disk->sectors_read,
+                     disk->ms_spent_reading, disk->writes_completed,
+                     disk->writes_merged, disk->sectors_written, 
+                     disk->ms_spent_writing, disk->io_inprogress,
+                     disk->ms_spent_io, disk->weighted_ms_spent_io );
         break;
 
         case SM_ERU_DATABASE_ENTRY_TYPE_NET_STATS:
-            printf( "net-stats: %s rx-bytes: %llu rx-packets: %llu"
-                    " rx-errors: %llu rx-dropped: %llu rx-fifo-errors: %llu"
-                    " rx-frame-errors: %llu rx-compressed-packets: %llu"
-                    " rx-multicast-frames: %llu tx-bytes: %llu"
-                    " tx-packets: %llu tx-errors: %llu tx-dropped: %llu"
-                    " tx-fifo-errors: %llu tx-collisions: %llu"
-                    " tx-carrier-loss: %llu tx-compressed-packets: %llu\n",
-                    net->dev_name, net->rx_bytes, net->rx_packets, 
-                    net->rx_errors, net->rx_dropped, net->rx_fifo_errors,
-                    net->rx_frame_errors, net->rx_compressed_packets,
-                    net->rx_multicast_frames, net->tx_bytes, net->tx_packets,
-                    net->tx_errors, net->tx_dropped, net->tx_fifo_errors,
-                    net->tx_collisions, net->tx_carrier_loss,
-                    net->tx_compressed_packets );
+            fprintf( fp, "net-stats: %s rx-bytes: %llu rx-packets: %llu"
+                     " rx-errors: %llu rx-dropped: %llu rx-fifo-errors: %llu"
+                     " rx-frame-errors: %llu rx-compressed-packets: %llu"
+                     " rx-multicast-frames: %llu tx-bytes: %llu"
+                     " tx-packets: %llu tx-errors: %llu tx-dropped: %llu"
+                     " tx-fifo-errors: %llu tx-collisions: %llu"
+                     " tx-carrier-loss: %llu tx-compressed-packets: %llu\n",
+                     net->dev_name, net->rx_bytes, net->rx_packets, 
+                     net->rx_errors, net->rx_dropped, net->rx_fifo_errors,
+                     net->rx_frame_errors, net->rx_compressed_packets,
+                     net->rx_multicast_frames, net->tx_bytes, net->tx_packets,
+                     net->tx_errors, net->tx_dropped, net->tx_fifo_errors,
+                     net->tx_collisions, net->tx_carrier_loss,
+                     net->tx_compressed_packets );
         break;
 
         case SM_ERU_DATABASE_ENTRY_TYPE_TC_STATS:
-            printf( "tc-stats: %s %s %s bytes: %" PRIu64 " packets: %" PRIu64
-                    " qlen: %" PRIu64 " backlog: %" PRIu64 " drops: %" PRIu64
-                    " requeues: %" PRIu64 " overlimits: %" PRIu64 "\n",
-                    qdisc->interface_name, qdisc->queue_type,
-                    qdisc->handle, qdisc->bytes, qdisc->packets,
-                    qdisc->q_length, qdisc->backlog, qdisc->drops,
-                    qdisc->requeues, qdisc->overlimits );
+            fprintf( fp, "tc-stats: %s %s %s bytes: %" PRIu64 " packets: %" PRIu64
+                     " qlen: %" PRIu64 " backlog: %" PRIu64 " drops: %" PRIu64
+                     " requeues: %" PRIu64 " overlimits: %" PRIu64 "\n",
+                     qdisc->interface_name, qdisc->queue_type,
+                     qdisc->handle, qdisc->bytes, qdisc->packets,
+                     qdisc->q_length, qdisc->backlog, qdisc->drops,
+                     qdisc->requeues, qdisc->overlimits );
         break;
 
         case SM_ERU_DATABASE_ENTRY_TYPE_IF_CHANGE:
-            printf( "if-change: %s type: %s state: %s\n",
-                    if_change->interface_name, 
-                    (SM_HW_INTERFACE_CHANGE_TYPE_ADD == if_change->type)
-                    ? "add" : "delete",
-                    sm_interface_state_str(if_change->interface_state) );
+            fprintf( fp, "if-change: %s type: %s state: %s\n",
+                     if_change->interface_name, 
+                     (SM_HW_INTERFACE_CHANGE_TYPE_ADD == if_change->type)
+                     ? "add" : "delete",
+                     sm_interface_state_str(if_change->interface_state) );
         break;
 
         case SM_ERU_DATABASE_ENTRY_TYPE_IP_CHANGE:
@@ -466,11 +728,21 @@ void sm_eru_db_display( SmEruDatabaseEntryT* entry, bool want_raw )
                 snprintf( addr_type_str, sizeof(addr_type_str), "unknown" );
             }
 
-            printf( "ip-change: %s type: %s address: %s/%i address-type=%s\n",
-                    ip_change->interface_name,
-                    (SM_HW_IP_CHANGE_TYPE_ADD == ip_change->type)
-                    ? "add" : "delete", ip_str, ip_change->prefix_len,
-                    addr_type_str );
+            fprintf( fp, "ip-change: %s type: %s address: %s/%i address-type=%s\n",
+                     ip_change->interface_name,
+                     (SM_HW_IP_CHANGE_TYPE_ADD == ip_change->type)
+                     ? "add" : "delete", ip_str, ip_change->prefix_len,
+                     addr_type_str );
+        break;
+
+        case SM_ERU_DATABASE_ENTRY_TYPE_SERVICE_STATS:
+            fprintf( fp, "service-stats: %s pid: %i user-ms: %llu"
+                     " sys-ms: %llu rss-kB: %llu read-bytes: %llu"
+                     " write-bytes: %llu fds: %u\n", service->service_name,
+                     service->usage.pid, service->usage.user_time_ms,
+                     service->usage.system_time_ms, service->usage.rss_kB,
+                     service->usage.read_bytes, service->usage.write_bytes,
+                     service->usage.num_fds );
         break;
 
         default:
@@ -480,6 +752,546 @@ void sm_eru_db_display( SmEruDatabaseEntryT* entry, bool want_raw )
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Event Recorder Unit Database - Display
+// ======================================
+void sm_eru_db_display( SmEruDatabaseEntryT* entry, bool want_raw )
+{
+    sm_eru_db_print( stdout, entry, want_raw );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Match
+// ====================================
+bool sm_eru_db_match( const SmEruDatabaseFilterT* filter,
+    SmEruDatabaseEntryT* entry )
+{
+    if(( 0 > entry->type )||( SM_ERU_DATABASE_ENTRY_TYPE_MAX <= entry->type )||
+       ( !filter->types[entry->type] ))
+    {
+        return( false );
+    }
+
+    if(( 0 != filter->start_time )&&
+       ( 0.0 < difftime( filter->start_time, entry->ts_real.tv_sec ) ))
+    {
+        return( false );
+    }
+
+    if(( 0 != filter->end_time )&&
+       ( 0.0 > difftime( filter->end_time, entry->ts_real.tv_sec ) ))
+    {
+        return( false );
+    }
+
+    if( NULL == filter->service_name )
+    {
+        return( true );
+    }
+
+    return(( SM_ERU_DATABASE_ENTRY_TYPE_SERVICE_STATS == entry->type )&&
+           ( 0 == strncmp( filter->service_name,
+                           entry->u.service_stats.service_name,
+                           sizeof(entry->u.service_stats.service_name) ) ));
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Dump Records
+// ===========================================
+static int sm_eru_db_dump_records( FILE* fp, int read_index, int num_records,
+    const SmEruDatabaseFilterT* filter )
+{
+    SmEruDatabaseEntryT entry;
+    SmErrorT error;
+    int matched = 0;
+
+    for( ; 0 < num_records; --num_records )
+    {
+        error = sm_eru_db_read( read_index, &entry );
+        if( SM_OKAY == error )
+        {
+            if( sm_eru_db_match( filter, &entry ) )
+            {
+                sm_eru_db_print( fp, &entry, filter->want_raw );
+                ++matched;
+            }
+
+        } else if( SM_NOT_FOUND != error ) {
+            DPRINTFE( "Failed to read record at index (%i), error=%s.",
+                      read_index, sm_error_str( error ) );
+            break;
+        }
+
+        ++read_index;
+        if( SM_ERU_DB_MAX_RECORDS <= read_index )
+        {
+            read_index = 0;
+        }
+    }
+
+    return( matched );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Dump Worker
+// ==========================================
+static void* sm_eru_db_dump_worker( void* arg )
+{
+    SmEruDBDumpWorkT* work = (SmEruDBDumpWorkT*) arg;
+    FILE* fp;
+
+    work->buf = NULL;
+    work->buf_len = 0;
+    work->matched = 0;
+
+    fp = open_memstream( &(work->buf), &(work->buf_len) );
+    if( NULL == fp )
+    {
+        DPRINTFE( "Failed to open dump buffer, error=%s.", strerror(errno) );
+        return( NULL );
+    }
+
+    work->matched = sm_eru_db_dump_records( fp, work->read_index,
+                                            work->num_records, work->filter );
+    fclose( fp );
+
+    return( NULL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Dump
+// ===================================
+// The segments formatted by a round of threads are written out in ring
+// order once all of them are done.
+int sm_eru_db_dump( FILE* fp, int read_index, int num_records,
+    const SmEruDatabaseFilterT* filter, unsigned int num_threads )
+{
+    SmEruDBDumpWorkT work[SM_ERU_DB_DUMP_THREADS_MAX];
+    int matched = 0;
+
+    if( 1 >= num_threads )
+    {
+        return( sm_eru_db_dump_records( fp, read_index, num_records, filter ) );
+    }
+
+    if( SM_ERU_DB_DUMP_THREADS_MAX < num_threads )
+    {
+        num_threads = SM_ERU_DB_DUMP_THREADS_MAX;
+    }
+
+    while( 0 < num_records )
+    {
+        unsigned int num_work = 0;
+
+        for( ; (num_threads > num_work)&&(0 < num_records); ++num_work )
+        {
+            SmEruDBDumpWorkT* segment = &(work[num_work]);
+            int count = SM_ERU_DB_INDEX_INTERVAL
+                      - (read_index % SM_ERU_DB_INDEX_INTERVAL);
+
+            if( count > num_records )
+            {
+                count = num_records;
+            }
+
+            segment->read_index = read_index;
+            segment->num_records = count;
+            segment->filter = filter;
+
+            segment->joinable = ( 0 == pthread_create( &(segment->thread),
+                                    NULL, sm_eru_db_dump_worker, segment ) );
+            if( !segment->joinable )
+            {
+                DPRINTFE( "Failed to create dump thread, dumping inline." );
+                sm_eru_db_dump_worker( segment );
+            }
+
+            read_index = (read_index + count) % SM_ERU_DB_MAX_RECORDS;
+            num_records -= count;
+        }
+
+        unsigned int work_i;
+        for( work_i=0; num_work > work_i; ++work_i )
+        {
+            SmEruDBDumpWorkT* segment = &(work[work_i]);
+
+            if( segment->joinable )
+            {
+                pthread_join( segment->thread, NULL );
+            }
+
+            if( NULL != segment->buf )
+            {
+                fwrite( segment->buf, 1, segment->buf_len, fp );
+                free( segment->buf );
+                segment->buf = NULL;
+            }
+
+            matched += segment->matched;
+        }
+    }
+
+    return( matched );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Map
+// ==================================
+static SmErrorT sm_eru_db_map( void )
+{
+    int prot = PROT_READ;
+
+    if( !_file_info.read_only )
+    {
+        prot |= PROT_WRITE;
+    }
+
+    _file_info.map = mmap( NULL, _file_info.map_size, prot, MAP_SHARED,
+                           _file_info.fd, 0 );
+    if( MAP_FAILED == _file_info.map )
+    {
+        DPRINTFE( "Failed to map database, error=%s.", strerror(errno) );
+        return( SM_FAILED );
+    }
+
+    if( _file_info.read_only )
+    {
+        madvise( _file_info.map, _file_info.map_size, MADV_SEQUENTIAL );
+    }
+
+    _file_info.header = (SmEruDatabaseHeaderT*) _file_info.map;
+    _file_info.index = (SmEruDatabaseIndexT*)
+        ((char*) _file_info.map + SM_ERU_DB_HEADER_SIZE);
+    _file_info.records = (SmEruDatabaseRecordT*)
+        (_file_info.index + SM_ERU_DB_INDEX_MAX);
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Header Valid
+// ===========================================
+static bool sm_eru_db_header_valid( void )
+{
+    SmEruDatabaseHeaderT* header = _file_info.header;
+
+    return(( SM_ERU_DB_MAGIC == header->magic )&&
+           ( SM_ERU_DB_VERSION == header->version )&&
+           ( sizeof(SmEruDatabaseRecordT) == header->record_size )&&
+           ( SM_ERU_DB_MAX_RECORDS == header->max_records )&&
+           ( SM_ERU_DB_INDEX_INTERVAL == header->index_interval ));
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Format
+// =====================================
+static SmErrorT sm_eru_db_format( void )
+{
+    int result;
+
+    DPRINTFI( "Initializing database." );
+
+    // Truncate first so that every record reads back as zero, never written.
+    if(( 0 > ftruncate( _file_info.fd, 0 ) )||
+       ( 0 > ftruncate( _file_info.fd, _file_info.map_size ) ))
+    {
+        DPRINTFE( "Failed to size database, error=%s.", strerror(errno) );
+        return( SM_FAILED );
+    }
+
+    // Reserve the blocks, a store into a hole on a full disk is a SIGBUS.
+    result = posix_fallocate( _file_info.fd, 0, _file_info.map_size );
+    if( 0 != result )
+    {
+        DPRINTFE( "Failed to allocate database, error=%s.", strerror(result) );
+        return( SM_FAILED );
+    }
+
+    if( SM_OKAY != sm_eru_db_map() )
+    {
+        return( SM_FAILED );
+    }
+
+    _file_info.header->version = SM_ERU_DB_VERSION;
+    _file_info.header->record_size = sizeof(SmEruDatabaseRecordT);
+    _file_info.header->max_records = SM_ERU_DB_MAX_RECORDS;
+    _file_info.header->index_interval = SM_ERU_DB_INDEX_INTERVAL;
+    _file_info.header->generation = 0;
+    __atomic_store_n( &(_file_info.header->magic), SM_ERU_DB_MAGIC,
+                      __ATOMIC_RELEASE );
+
+    sm_eru_db_sync_range( _file_info.header, sizeof(SmEruDatabaseHeaderT),
+                          MS_SYNC );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Recover
+// ======================================
+// Records stored after the last header update that made it to disk are
+// whole when both tags match, pick them up.
+static void sm_eru_db_recover( void )
+{
+    uint64_t generation = _file_info.header->generation;
+    uint64_t recovered = 0;
+    SmEruDatabaseEntryT entry;
+
+    while( SM_ERU_DB_MAX_RECORDS > recovered )
+    {
+        int index = generation % SM_ERU_DB_MAX_RECORDS;
+
+        if( generation + 1 != sm_eru_db_record_generation( index, &entry ) )
+        {
+            break;
+        }
+
+        if( 0 == (generation % SM_ERU_DB_INDEX_INTERVAL) )
+        {
+            sm_eru_db_index_update( generation, &entry );
+        }
+
+        ++generation;
+        ++recovered;
+    }
+
+    if( 0 < recovered )
+    {
+        DPRINTFI( "Recovered %" PRIu64 " database records past the header.",
+                  recovered );
+        __atomic_store_n( &(_file_info.header->generation), generation,
+                          __ATOMIC_RELEASE );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Old Open
+// =======================================
+// Maps the v1 database file and works out which of its entries are valid,
+// returns SM_NOT_FOUND when there is no such file.
+static SmErrorT sm_eru_db_old_open( SmEruDBOldFileT* old )
+{
+    SmEruDatabaseHeaderV1T* header;
+    struct stat stat_info;
+    size_t expected_size;
+
+    memset( old, 0, sizeof(SmEruDBOldFileT) );
+    old->map = MAP_FAILED;
+
+    old->fd = open( SM_ERU_DB_FILENAME_V1, O_RDONLY | O_CLOEXEC );
+    if( 0 > old->fd )
+    {
+        return( SM_NOT_FOUND );
+    }
+
+    if( 0 > fstat( old->fd, &stat_info ) )
+    {
+        DPRINTFE( "Failed to get old database file (%s) stats, error=%s.",
+                  SM_ERU_DB_FILENAME_V1, strerror(errno) );
+        goto ERROR;
+    }
+
+    // The v1 file was filled in blocks, up to one block past its entries.
+    expected_size = sizeof(SmEruDatabaseHeaderV1T)
+                  + sizeof(SmEruDatabaseEntryT) * SM_ERU_DB_MAX_RECORDS;
+
+    if(( (size_t) stat_info.st_size < expected_size )||
+       ( (size_t) stat_info.st_size > expected_size + SM_ERU_DB_FILL_SIZE_V1 ))
+    {
+        goto INVALID;
+    }
+
+    old->map_size = expected_size;
+    old->map = mmap( NULL, old->map_size, PROT_READ, MAP_SHARED, old->fd, 0 );
+    if( MAP_FAILED == old->map )
+    {
+        DPRINTFE( "Failed to map old database file (%s), error=%s.",
+                  SM_ERU_DB_FILENAME_V1, strerror(errno) );
+        goto ERROR;
+    }
+
+    madvise( old->map, old->map_size, MADV_SEQUENTIAL );
+
+    header = (SmEruDatabaseHeaderV1T*) old->map;
+
+    if(( 0 > header->write_index )||
+       ( SM_ERU_DB_MAX_RECORDS <= header->write_index ))
+    {
+        goto INVALID;
+    }
+
+    if( header->wrapped )
+    {
+        old->first = header->write_index;
+        old->count = SM_ERU_DB_MAX_RECORDS;
+    } else {
+        old->first = 0;
+        old->count = header->write_index;
+    }
+
+    return( SM_OKAY );
+
+INVALID:
+    DPRINTFI( "Old database file (%s) is not formatted as expected.",
+              SM_ERU_DB_FILENAME_V1 );
+ERROR:
+    if( MAP_FAILED != old->map )
+    {
+        munmap( old->map, old->map_size );
+        old->map = MAP_FAILED;
+    }
+    close( old->fd );
+    old->fd = -1;
+    return( SM_FAILED );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Old Read
+// =======================================
+// Copies out the given entry of the v1 database file, oldest first.
+static bool sm_eru_db_old_read( SmEruDBOldFileT* old, uint64_t number,
+    SmEruDatabaseEntryT* entry )
+{
+    SmEruDatabaseEntryT* entries;
+
+    if( old->count <= number )
+    {
+        return( false );
+    }
+
+    entries = (SmEruDatabaseEntryT*)
+        ((char*) old->map + sizeof(SmEruDatabaseHeaderV1T));
+
+    memcpy( entry, &(entries[(old->first + number) % SM_ERU_DB_MAX_RECORDS]),
+            sizeof(SmEruDatabaseEntryT) );
+
+    return(( SM_ERU_DATABASE_ENTRY_TYPE_MAX > entry->type )&&
+           ( 0 != entry->ts_real.tv_sec ));
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Old Close
+// ========================================
+static void sm_eru_db_old_close( SmEruDBOldFileT* old )
+{
+    if( MAP_FAILED != old->map )
+    {
+        munmap( old->map, old->map_size );
+        old->map = MAP_FAILED;
+    }
+
+    if( 0 <= old->fd )
+    {
+        close( old->fd );
+        old->fd = -1;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Migrate
+// ======================================
+// Copies the entries of the v1 database file into a newly created ring,
+// oldest first.  The v1 file is left in place until its entries have aged
+// out of the ring.
+static void sm_eru_db_migrate( void )
+{
+    SmEruDBOldFileT old;
+    SmEruDatabaseEntryT entry;
+    uint64_t migrated = 0;
+
+    if( SM_OKAY != sm_eru_db_old_open( &old ) )
+    {
+        return;
+    }
+
+    uint64_t number;
+    for( number=0; old.count > number; ++number )
+    {
+        if( sm_eru_db_old_read( &old, number, &entry ) )
+        {
+            sm_eru_db_append( &entry );
+            ++migrated;
+        }
+    }
+
+    DPRINTFI( "Migrated %" PRIu64 " of %" PRIu64 " records from old "
+              "database file (%s).", migrated, old.count,
+              SM_ERU_DB_FILENAME_V1 );
+
+    sm_eru_db_old_close( &old );
+
+    if( 0 < migrated )
+    {
+        sm_eru_db_sync_range( _file_info.map, _file_info.map_size, MS_SYNC );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Age Out
+// ======================================
+// Removes the v1 database file once the ring has wrapped past the time of
+// its newest entry, its entries are then all older than any kept in the
+// ring.  Returns true while the file is still to be removed.
+static bool sm_eru_db_age_out( void )
+{
+    SmEruDBOldFileT old;
+    SmEruDatabaseEntryT oldest;
+    SmEruDatabaseEntryT newest;
+    uint64_t generation = sm_eru_db_generation();
+    bool aged_out = false;
+
+    if( SM_OKAY != sm_eru_db_old_open( &old ) )
+    {
+        return( false );
+    }
+
+    if( 0 == old.count )
+    {
+        aged_out = true;
+
+    } else if(( SM_ERU_DB_MAX_RECORDS <= generation )&&
+              ( sm_eru_db_old_read( &old, old.count - 1, &newest ) )&&
+              ( 0 != sm_eru_db_record_generation( generation
+                                                  % SM_ERU_DB_MAX_RECORDS,
+                                                  &oldest ) )&&
+              ( oldest.ts_real.tv_sec > newest.ts_real.tv_sec )) {
+        aged_out = true;
+    }
+
+    sm_eru_db_old_close( &old );
+
+    if( !aged_out )
+    {
+        return( true );
+    }
+
+    if( 0 > unlink( SM_ERU_DB_FILENAME_V1 ) )
+    {
+        DPRINTFE( "Failed to remove old database file (%s), error=%s.",
+                  SM_ERU_DB_FILENAME_V1, strerror(errno) );
+        return( false );
+    }
+
+    DPRINTFI( "Removed old database file (%s), its records have aged out.",
+              SM_ERU_DB_FILENAME_V1 );
+
+    return( false );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Event Recorder Unit Database - Initialize
 // =========================================
@@ -487,44 +1299,43 @@ SmErrorT sm_eru_db_initialize( char* filename, bool read_only )
 {
     char db_filename[512] = "";
     struct stat stat_info;
+    bool formatted = false;
+    int flags = O_RDONLY;
     int result;
+
     _file_info.initialized = false;
-    _file_info.fp = NULL;
-    _file_header.wrapped = false;
-    _file_header.write_index = 0;
+    _file_info.read_only = read_only;
+    _file_info.age_out_pending = false;
+    _file_info.fd = -1;
+    _file_info.map = MAP_FAILED;
+    _file_info.map_size = SM_ERU_DB_HEADER_SIZE
+                        + sizeof(SmEruDatabaseIndexT) * SM_ERU_DB_INDEX_MAX
+                        + sizeof(SmEruDatabaseRecordT) * SM_ERU_DB_MAX_RECORDS;
 
     if( NULL == filename )
     {
         snprintf( db_filename, sizeof(db_filename), "%s", SM_ERU_DB_FILENAME );
     } else {
         snprintf( db_filename, sizeof(db_filename), "%s", filename );
-
     }
 
-    DPRINTFD( "ERU Database Entry size is %i, total_records=%i.",
-              (int) sizeof(SmEruDatabaseEntryT), SM_ERU_DB_MAX_RECORDS );
+    DPRINTFD( "ERU Database Record size is %i, total_records=%i.",
+              (int) sizeof(SmEruDatabaseRecordT), SM_ERU_DB_MAX_RECORDS );
 
-    if( read_only )
+    if( !read_only )
     {
-        _file_info.fp = fopen (db_filename, "r");
-    } else {
-       _file_info.fp = fopen (db_filename, "r+");
-       if (_file_info.fp == NULL)
-       {
-          // File does not exist, open for write with file creation
-          _file_info.fp = fopen (db_filename, "w+");
-       }
+        flags = O_RDWR | O_CREAT;
     }
 
-    if( _file_info.fp == NULL )
+    _file_info.fd = open( db_filename, flags | O_CLOEXEC,
+                          S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH );
+    if( 0 > _file_info.fd )
     {
         DPRINTFE( "Failed to open database file (%s), error=%s.", db_filename,
                   strerror( errno ) );
         return( SM_FAILED );
     }
 
-    _file_info.fd = fileno(_file_info.fp);
-
     result = fstat( _file_info.fd, &stat_info );
     if( 0 > result )
     {
@@ -534,68 +1345,60 @@ SmErrorT sm_eru_db_initialize( char* filename, bool read_only )
         return( SM_FAILED );
     }
 
-    int max_db_size = (sizeof(SmEruDatabaseEntryT) * SM_ERU_DB_MAX_RECORDS ) + SM_ERU_DB_HEADER_SIZE;
-
-    if( (int) stat_info.st_size < max_db_size )
+    if( (size_t) stat_info.st_size == _file_info.map_size )
     {
-        if( read_only )
+        if( SM_OKAY != sm_eru_db_map() )
         {
-            DPRINTFE( "Database is not sized correctly, expected=%i, "
-                      "actual=%i.", max_db_size, (int) stat_info.st_size );
             sm_eru_db_finalize();
             return( SM_FAILED );
+        }
 
-        } else {
-            int num_blocks;
+        if( !sm_eru_db_header_valid() )
+        {
+            munmap( _file_info.map, _file_info.map_size );
+            _file_info.map = MAP_FAILED;
+        }
+    }
 
-            DPRINTFI( "Initializing database." );
+    if( MAP_FAILED == _file_info.map )
+    {
+        if( read_only )
+        {
+            DPRINTFE( "Database is not formatted correctly, expected-size=%zu, "
+                      "actual-size=%zu.", _file_info.map_size,
+                      (size_t) stat_info.st_size );
+            sm_eru_db_finalize();
+            return( SM_FAILED );
+        }
 
-            num_blocks = max_db_size / sizeof(_1MB_data_block) + 1;
-            memset( _1MB_data_block, 0, sizeof(_1MB_data_block) );
+        if( SM_OKAY != sm_eru_db_format() )
+        {
+            sm_eru_db_finalize();
+            return( SM_FAILED );
+        }
 
-            int block_i;
-            for( block_i=0; block_i < num_blocks; ++block_i )
-            {
-                write( _file_info.fd, (void*) _1MB_data_block,
-                       sizeof(_1MB_data_block) );
-            }
+        formatted = true;
+    }
 
-            result = fstat( _file_info.fd, &stat_info );
-            if( 0 > result )
-            {
-                DPRINTFE( "Failed to get database file statistics, error=%s.",
-                          strerror(errno) );
-                sm_eru_db_finalize();
-                return( SM_FAILED );
-            }
+    if( !read_only )
+    {
+        sm_eru_db_recover();
 
-            if( (int) stat_info.st_size < (max_db_size) )
+        // The records of the v1 file are carried over on upgrade.
+        if( NULL == filename )
+        {
+            if( formatted )
             {
-                DPRINTFE( "Failed to create database, size=%d.",
-                          (int) stat_info.st_size );
-                sm_eru_db_finalize();
-                return( SM_FAILED );
+                sm_eru_db_migrate();
             }
 
-            _file_info.file_size = stat_info.st_size;
+            _file_info.age_out_pending = sm_eru_db_age_out();
         }
-    } else {
-        _file_info.file_size = stat_info.st_size;
     }
 
-    _file_info.read_only = read_only;
+    _file_info.sync_generation = sm_eru_db_generation();
     _file_info.initialized = true;
 
-    // Read write index and wrapper flag
-    unsigned char buffer[SM_ERU_DB_HEADER_SIZE];
-    int bytes_read = fread(buffer, 1, SM_ERU_DB_HEADER_SIZE, _file_info.fp);
-
-    if (bytes_read == SM_ERU_DB_HEADER_SIZE)
-    {
-       memcpy(&_file_header.write_index, buffer, sizeof(int));
-       memcpy(&_file_header.wrapped, buffer+sizeof(int), sizeof(bool));
-    }
-
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -605,12 +1408,28 @@ SmErrorT sm_eru_db_initialize( char* filename, bool read_only )
 // =======================================
 SmErrorT sm_eru_db_finalize( void )
 {
+    if(( _file_info.initialized )&&( !_file_info.read_only ))
+    {
+        sm_eru_db_sync_range( _file_info.records, sizeof(SmEruDatabaseRecordT)
+                              * SM_ERU_DB_MAX_RECORDS, MS_SYNC );
+        sm_eru_db_sync_range( _file_info.index, sizeof(SmEruDatabaseIndexT)
+                              * SM_ERU_DB_INDEX_MAX, MS_SYNC );
+        sm_eru_db_sync_range( _file_info.header, sizeof(SmEruDatabaseHeaderT),
+                              MS_SYNC );
+    }
+
     _file_info.initialized = false;
 
-    if( _file_info.fp != NULL )
+    if( MAP_FAILED != _file_info.map )
+    {
+        munmap( _file_info.map, _file_info.map_size );
+        _file_info.map = MAP_FAILED;
+    }
+
+    if( 0 <= _file_info.fd )
     {
-        sm_eru_db_sync();
-        fclose(_file_info.fp);
+        close( _file_info.fd );
+        _file_info.fd = -1;
     }
 
     return( SM_OKAY );
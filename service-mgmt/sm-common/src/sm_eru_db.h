@@ -6,8 +6,11 @@
 #ifndef __SM_ERU_DB_H__
 #define __SM_ERU_DB_H__
 
+#include <stdio.h>
 #include <stdbool.h>
+#include <time.h>
 
+#include "sm_limits.h"
 #include "sm_types.h"
 #include "sm_hw.h"
 #include "sm_node_stats.h"
@@ -16,6 +19,16 @@
 extern "C" {
 #endif
 
+// The ring is only resized for tests, a file of another size is
+// reformatted when opened for write.
+#ifndef SM_ERU_DB_MAX_RECORDS
+#define SM_ERU_DB_MAX_RECORDS                                       4194304
+#endif
+#ifndef SM_ERU_DB_INDEX_INTERVAL
+#define SM_ERU_DB_INDEX_INTERVAL                                       4096
+#endif
+#define SM_ERU_DB_DUMP_THREADS_MAX                                       64
+
 typedef enum
 {
     SM_ERU_DATABASE_ENTRY_TYPE_CPU_STATS,
@@ -25,9 +38,16 @@ typedef enum
     SM_ERU_DATABASE_ENTRY_TYPE_TC_STATS,
     SM_ERU_DATABASE_ENTRY_TYPE_IF_CHANGE,
     SM_ERU_DATABASE_ENTRY_TYPE_IP_CHANGE,
+    SM_ERU_DATABASE_ENTRY_TYPE_SERVICE_STATS,
     SM_ERU_DATABASE_ENTRY_TYPE_MAX
 } SmEruDatabaseEntryType;
 
+typedef struct
+{
+    char service_name[SM_SERVICE_NAME_MAX_CHAR];
+    SmNodeProcessUsageT usage;
+} SmEruServiceStatsT;
+
 typedef struct
 {
     int index;               // Filled in on write.
@@ -43,9 +63,19 @@ typedef struct
         SmHwQdiscInfoT tc_stats;
         SmHwInterfaceChangeDataT if_change;
         SmHwIpChangeDataT ip_change;
+        SmEruServiceStatsT service_stats;
     } u;
 } SmEruDatabaseEntryT;
 
+typedef struct
+{
+    bool types[SM_ERU_DATABASE_ENTRY_TYPE_MAX];
+    time_t start_time;        // Zero when not filtering on start time.
+    time_t end_time;          // Zero when not filtering on end time.
+    const char* service_name; // NULL when not filtering on service.
+    bool want_raw;
+} SmEruDatabaseFilterT;
+
 // ****************************************************************************
 // Event Recorder Unit Database - Total
 // ====================================
@@ -58,15 +88,30 @@ extern int sm_eru_db_total( void );
 extern int sm_eru_db_get_write_index( void );
 // ****************************************************************************
 
+// ****************************************************************************
+// Event Recorder Unit Database - Find Window
+// ==========================================
+// Binary searches the time index for the records that may fall between
+// start and end time, a zero time leaves that side open.  The records
+// from the read index on, wrapping, still need filtering on their time.
+// Relies on records being appended in time order.
+extern SmErrorT sm_eru_db_find_window( time_t start_time, time_t end_time,
+    int* read_index, int* num_records );
+// ****************************************************************************
+
 // ****************************************************************************
 // Event Recorder Unit Database - Flush the database
 // =================================================
+// Starts writeback of the records written since the last flush and then
+// the header, the database is synced to disk on finalize.
 extern void sm_eru_db_sync( void );
 // ****************************************************************************
 
 // ****************************************************************************
 // Event Recorder Unit Database - Read
 // ===================================
+// Copies the record out of the mapped database, returns SM_NOT_FOUND for a
+// record that was never written or is being overwritten.
 extern SmErrorT sm_eru_db_read( int read_index, SmEruDatabaseEntryT* entry );
 // ****************************************************************************
 
@@ -82,6 +127,31 @@ extern SmErrorT sm_eru_db_write( SmEruDatabaseEntryT* entry );
 extern void sm_eru_db_display( SmEruDatabaseEntryT* entry, bool want_raw );
 // ****************************************************************************
 
+// ****************************************************************************
+// Event Recorder Unit Database - Print
+// ====================================
+// Same as display, to the given stream.
+extern void sm_eru_db_print( FILE* fp, SmEruDatabaseEntryT* entry,
+    bool want_raw );
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Match
+// ====================================
+extern bool sm_eru_db_match( const SmEruDatabaseFilterT* filter,
+    SmEruDatabaseEntryT* entry );
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Database - Dump
+// ===================================
+// Prints the records from the read index on, wrapping, that pass the
+// filter and returns how many did.  On more than one thread each thread
+// formats a ring segment, the output is the same as on one thread.
+extern int sm_eru_db_dump( FILE* fp, int read_index, int num_records,
+    const SmEruDatabaseFilterT* filter, unsigned int num_threads );
+// ****************************************************************************
+
 // ****************************************************************************
 // Event Recorder Unit Database - Initialize
 // =========================================
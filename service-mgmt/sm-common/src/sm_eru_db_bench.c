@@ -0,0 +1,435 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Measures appending a full ring to the mapped ERU database and reading
+// it back, against a seek and buffered write or read per record as the
+// database was stored before.  With --query, measures the time index and
+// the threaded dump against a copy of a live database instead.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <errno.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_eru_db.h"
+
+#define SM_ERU_DB_BENCH_SYNC_RECORDS                                    64
+#define SM_ERU_DB_BENCH_QUERY_WINDOW_IN_SECS                           600
+
+static struct option _sm_eru_db_bench_long_options[] =
+{
+    { "file",    required_argument, NULL, 'f'},
+    { "query",   required_argument, NULL, 'q'},
+    { "threads", required_argument, NULL, 'j'},
+    { "help",    no_argument,       NULL, 'h'},
+    {0, 0, 0, 0}
+};
+
+// ****************************************************************************
+// ERU Database Benchmark - Usage
+// ==============================
+static void usage( void )
+{
+    printf( " usage:\n"
+            "   sm_eru_db_bench [--file <scratch database>]\n"
+            "   sm_eru_db_bench --query <eru database> [--threads <number>]\n"
+            "       --file    : scratch database to fill, removed afterwards,\n"
+            "                   defaults to a file in /tmp\n"
+            "       --query   : time the last ten minutes of disk stats found\n"
+            "                   through the time index against a full scan,\n"
+            "                   and a full dump on one thread against\n"
+            "                   --threads threads, output goes to /dev/null\n"
+            "       --threads : threads of the full dump, defaults to the\n"
+            "                   number of cpus\n"
+            "       --help    : print out this help message\n"
+            "\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Database Benchmark - Elapsed
+// ================================
+static double sm_eru_db_bench_elapsed( struct timespec* start )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return( (double) (now.tv_sec - start->tv_sec)
+            + (double) (now.tv_nsec - start->tv_nsec) / 1000000000.0 );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Database Benchmark - Entry
+// ==============================
+static void sm_eru_db_bench_entry( int record_i, SmEruDatabaseEntryT* entry )
+{
+    memset( entry, 0, sizeof(SmEruDatabaseEntryT) );
+    entry->type = SM_ERU_DATABASE_ENTRY_TYPE_CPU_STATS;
+    snprintf( entry->u.cpu_stats.cpu_name,
+              sizeof(entry->u.cpu_stats.cpu_name), "cpu%i", record_i % 64 );
+    entry->u.cpu_stats.user_cpu_usage = record_i;
+    entry->u.cpu_stats.idle_task_cpu_usage = record_i * 2ULL;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Database Benchmark - Stdio
+// ==============================
+// Baseline of a seek and buffered write or read per record, with the
+// header rewritten after each append, as the database was stored before.
+static SmErrorT sm_eru_db_bench_stdio( char filename[], double* append_secs,
+    double* dump_secs )
+{
+    SmEruDatabaseEntryT entry;
+    struct timespec start;
+    int header[2] = { 0, 0 };
+    FILE* fp;
+
+    fp = fopen( filename, "w+" );
+    if( NULL == fp )
+    {
+        printf( "Failed to open %s, error=%s.\n", filename, strerror(errno) );
+        return( SM_FAILED );
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+
+    int record_i;
+    for( record_i=0; SM_ERU_DB_MAX_RECORDS > record_i; ++record_i )
+    {
+        sm_eru_db_bench_entry( record_i, &entry );
+        clock_gettime( CLOCK_REALTIME, &(entry.ts_real) );
+        entry.index = record_i;
+
+        fseek( fp, record_i*sizeof(SmEruDatabaseEntryT) + sizeof(header),
+               SEEK_SET );
+        fwrite( &entry, 1, sizeof(entry), fp );
+
+        header[0] = record_i + 1;
+        fseek( fp, 0, SEEK_SET );
+        fwrite( header, 1, sizeof(header), fp );
+
+        if( 0 == ((record_i + 1) % SM_ERU_DB_BENCH_SYNC_RECORDS) )
+        {
+            fflush( fp );
+            fsync( fileno(fp) );
+        }
+    }
+
+    fflush( fp );
+    fsync( fileno(fp) );
+
+    *append_secs = sm_eru_db_bench_elapsed( &start );
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+
+    for( record_i=0; SM_ERU_DB_MAX_RECORDS > record_i; ++record_i )
+    {
+        fseek( fp, record_i*sizeof(SmEruDatabaseEntryT) + sizeof(header),
+               SEEK_SET );
+        if( sizeof(entry) != fread( &entry, 1, sizeof(entry), fp ) )
+        {
+            printf( "Failed to read record at index (%i).\n", record_i );
+            break;
+        }
+    }
+
+    *dump_secs = sm_eru_db_bench_elapsed( &start );
+
+    fclose( fp );
+    unlink( filename );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Database Benchmark - Run
+// ============================
+static SmErrorT sm_eru_db_bench_run( char filename[] )
+{
+    char stdio_filename[512];
+    double append_secs, dump_secs;
+    double stdio_append_secs, stdio_dump_secs;
+    int records_found = 0;
+    SmEruDatabaseEntryT entry;
+    struct timespec start;
+    SmErrorT error;
+
+    error = sm_eru_db_initialize( filename, false );
+    if( SM_OKAY != error )
+    {
+        printf( "Failed to initialize %s, error=%s.\n", filename,
+                sm_error_str( error ) );
+        return( error );
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+
+    int record_i;
+    for( record_i=0; SM_ERU_DB_MAX_RECORDS > record_i; ++record_i )
+    {
+        sm_eru_db_bench_entry( record_i, &entry );
+        sm_eru_db_write( &entry );
+
+        if( 0 == ((record_i + 1) % SM_ERU_DB_BENCH_SYNC_RECORDS) )
+        {
+            sm_eru_db_sync();
+        }
+    }
+
+    sm_eru_db_finalize();
+
+    append_secs = sm_eru_db_bench_elapsed( &start );
+
+    error = sm_eru_db_initialize( filename, true );
+    if( SM_OKAY != error )
+    {
+        printf( "Failed to open %s, error=%s.\n", filename,
+                sm_error_str( error ) );
+        return( error );
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+
+    for( record_i=0; SM_ERU_DB_MAX_RECORDS > record_i; ++record_i )
+    {
+        if( SM_OKAY == sm_eru_db_read( record_i, &entry ) )
+        {
+            ++records_found;
+        }
+    }
+
+    dump_secs = sm_eru_db_bench_elapsed( &start );
+
+    sm_eru_db_finalize();
+
+    snprintf( stdio_filename, sizeof(stdio_filename), "%s.stdio", filename );
+
+    error = sm_eru_db_bench_stdio( stdio_filename, &stdio_append_secs,
+                                   &stdio_dump_secs );
+    if( SM_OKAY != error )
+    {
+        return( error );
+    }
+
+    printf( "benchmark-records   : %i (sync every %i records)\n",
+            SM_ERU_DB_MAX_RECORDS, SM_ERU_DB_BENCH_SYNC_RECORDS );
+    printf( "mmap-append         : %.3f secs (%.0f records/sec)\n",
+            append_secs, SM_ERU_DB_MAX_RECORDS / append_secs );
+    printf( "mmap-dump           : %.3f secs (%.0f records/sec, found=%i)\n",
+            dump_secs, SM_ERU_DB_MAX_RECORDS / dump_secs, records_found );
+    printf( "stdio-append        : %.3f secs (%.0f records/sec)\n",
+            stdio_append_secs, SM_ERU_DB_MAX_RECORDS / stdio_append_secs );
+    printf( "stdio-dump          : %.3f secs (%.0f records/sec)\n",
+            stdio_dump_secs, SM_ERU_DB_MAX_RECORDS / stdio_dump_secs );
+
+    if( SM_ERU_DB_MAX_RECORDS != records_found )
+    {
+        printf( "Read back %i of %i records.\n", records_found,
+                SM_ERU_DB_MAX_RECORDS );
+        return( SM_FAILED );
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Database Benchmark - Query
+// ==============================
+// Times the last ten minutes of disk stats found through the time index
+// against a scan of the whole ring, then a full dump on one thread against
+// the given number of threads.  Each pair has to match the same records.
+static SmErrorT sm_eru_db_bench_query( char filename[],
+    unsigned int num_threads )
+{
+    SmEruDatabaseFilterT filter;
+    SmEruDatabaseEntryT entry;
+    struct timespec start;
+    double scan_secs, window_secs, full_secs, threaded_secs;
+    int scan_matched, window_matched, full_matched, threaded_matched;
+    int oldest_i, total_records, record_i, record_count;
+    int newest_i;
+    FILE* fp;
+    SmErrorT error;
+
+    error = sm_eru_db_initialize( filename, true );
+    if( SM_OKAY != error )
+    {
+        printf( "Failed to open ERU database, error=%s.\n",
+                sm_error_str( error ) );
+        return( error );
+    }
+
+    fp = fopen( "/dev/null", "w" );
+    if( NULL == fp )
+    {
+        printf( "Failed to open /dev/null, error=%s.\n", strerror(errno) );
+        sm_eru_db_finalize();
+        return( SM_FAILED );
+    }
+
+    if( 0 == num_threads )
+    {
+        num_threads = (unsigned int) sysconf( _SC_NPROCESSORS_ONLN );
+        if( SM_ERU_DB_DUMP_THREADS_MAX < num_threads )
+        {
+            num_threads = SM_ERU_DB_DUMP_THREADS_MAX;
+        }
+    }
+
+    total_records = sm_eru_db_total();
+    newest_i = sm_eru_db_get_write_index() - 1;
+    if( 0 > newest_i )
+    {
+        newest_i = SM_ERU_DB_MAX_RECORDS - 1;
+    }
+
+    if(( 0 == total_records )||
+       ( SM_OKAY != sm_eru_db_read( newest_i, &entry ) ))
+    {
+        printf( "No records in the ERU database.\n" );
+        fclose( fp );
+        sm_eru_db_finalize();
+        return( SM_NOT_FOUND );
+    }
+
+    sm_eru_db_find_window( 0, 0, &oldest_i, &total_records );
+
+    memset( &filter, 0, sizeof(filter) );
+    filter.types[SM_ERU_DATABASE_ENTRY_TYPE_DISK_STATS] = true;
+    filter.start_time = entry.ts_real.tv_sec
+                      - SM_ERU_DB_BENCH_QUERY_WINDOW_IN_SECS;
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    scan_matched = sm_eru_db_dump( fp, oldest_i, total_records, &filter, 1 );
+    scan_secs = sm_eru_db_bench_elapsed( &start );
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    sm_eru_db_find_window( filter.start_time, 0, &record_i, &record_count );
+    window_matched = sm_eru_db_dump( fp, record_i, record_count, &filter,
+                                     1 );
+    window_secs = sm_eru_db_bench_elapsed( &start );
+
+    memset( &filter, 0, sizeof(filter) );
+    memset( filter.types, 1, sizeof(filter.types) );
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    full_matched = sm_eru_db_dump( fp, oldest_i, total_records, &filter, 1 );
+    full_secs = sm_eru_db_bench_elapsed( &start );
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    threaded_matched = sm_eru_db_dump( fp, oldest_i, total_records, &filter,
+                                       num_threads );
+    threaded_secs = sm_eru_db_bench_elapsed( &start );
+
+    fclose( fp );
+    sm_eru_db_finalize();
+
+    printf( "total-records       : %i\n", total_records );
+    printf( "disk-last-%is      : full scan %.4f secs, windowed %.4f secs "
+            "(%i records read, matched %i/%i)\n",
+            SM_ERU_DB_BENCH_QUERY_WINDOW_IN_SECS, scan_secs, window_secs,
+            record_count, scan_matched, window_matched );
+    printf( "full-dump           : 1 thread %.3f secs, %u threads %.3f "
+            "secs (matched %i/%i)\n", full_secs, num_threads, threaded_secs,
+            full_matched, threaded_matched );
+
+    if(( scan_matched != window_matched )||
+       ( full_matched != threaded_matched ))
+    {
+        printf( "Records matched differ.\n" );
+        return( SM_FAILED );
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Database Benchmark - Main
+// =============================
+int main( int argc, char *argv[], char *envp[] )
+{
+    char scratch_filename[] = "/tmp/sm_eru_db_bench.XXXXXX";
+    char* filename = NULL;
+    char* query_filename = NULL;
+    unsigned int num_threads = 0;
+    SmErrorT error;
+    int fd;
+    int c;
+
+    while( true )
+    {
+        c = getopt_long( argc, argv, "", _sm_eru_db_bench_long_options,
+                         NULL );
+        if( -1 == c )
+        {
+            break;
+        }
+
+        switch( c )
+        {
+            case 'f':
+                filename = optarg;
+            break;
+
+            case 'q':
+                query_filename = optarg;
+            break;
+
+            case 'j':
+                num_threads = (unsigned int) atoi( optarg );
+                if( SM_ERU_DB_DUMP_THREADS_MAX < num_threads )
+                {
+                    num_threads = SM_ERU_DB_DUMP_THREADS_MAX;
+                }
+            break;
+
+            case 'h':
+            case '?':
+                usage();
+                exit( 0 );
+            break;
+        }
+    }
+
+    if( NULL != query_filename )
+    {
+        error = sm_eru_db_bench_query( query_filename, num_threads );
+
+        return( ( SM_OKAY == error ) ? EXIT_SUCCESS : EXIT_FAILURE );
+    }
+
+    if( NULL == filename )
+    {
+        fd = mkstemp( scratch_filename );
+        if( 0 > fd )
+        {
+            printf( "Failed to create scratch database, error=%s.\n",
+                    strerror(errno) );
+            return( EXIT_FAILURE );
+        }
+        close( fd );
+        filename = scratch_filename;
+    }
+
+    error = sm_eru_db_bench_run( filename );
+
+    unlink( filename );
+
+    return( ( SM_OKAY == error ) ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+// ****************************************************************************
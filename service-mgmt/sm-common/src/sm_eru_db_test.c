@@ -0,0 +1,437 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Checks the time index and the threaded dump of the ERU database over a
+// synthetic ring, exits non-zero when a check fails.  Built with a small
+// ring so it wraps, records are stamped by a synthetic clock twenty times
+// a second.  Each window found through the index has to dump the same as
+// a scan of the whole ring, on one thread and on several.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_eru_db.h"
+
+#define SM_ERU_DB_TEST_START_TIME                               1700000000
+#define SM_ERU_DB_TEST_STEP_IN_MS                                       50
+#define SM_ERU_DB_TEST_HEADER_SIZE                                    4096
+#define SM_ERU_DB_TEST_INDEX_MAX \
+    (SM_ERU_DB_MAX_RECORDS / SM_ERU_DB_INDEX_INTERVAL)
+
+// Layout of the database file, as in sm_eru_db.c.
+typedef struct
+{
+    uint64_t generation;
+    int64_t time_ms;
+    uint64_t generation_end;
+} SmEruDbTestIndexT;
+
+typedef struct
+{
+    uint64_t generation;
+    SmEruDatabaseEntryT entry;
+    uint64_t generation_end;
+} SmEruDbTestRecordT;
+
+typedef struct
+{
+    const char* name;
+    time_t start_time;
+    time_t end_time;
+} SmEruDbTestWindowT;
+
+extern "C" int __real_clock_gettime( clockid_t clock_id, struct timespec* tp );
+
+static bool _synthetic_clock = false;
+static int64_t _clock_ms = 0;
+static char _filename[] = "/tmp/sm_eru_db_test.XXXXXX";
+static unsigned int _failures = 0;
+
+// ****************************************************************************
+// ERU Database Test - Check
+// =========================
+static void sm_eru_db_test_check( bool passed, const char name[] )
+{
+    printf( "%s: %s\n", passed ? "PASS" : "FAIL", name );
+
+    if( !passed )
+    {
+        ++_failures;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Database Test - Clock
+// =========================
+// Stamps the records written with the synthetic clock.
+extern "C" int __wrap_clock_gettime( clockid_t clock_id, struct timespec* tp )
+{
+    if(( _synthetic_clock )&&( CLOCK_REALTIME == clock_id ))
+    {
+        tp->tv_sec = (time_t) (_clock_ms / 1000);
+        tp->tv_nsec = (long) (_clock_ms % 1000) * 1000000;
+        _clock_ms += SM_ERU_DB_TEST_STEP_IN_MS;
+        return( 0 );
+    }
+
+    return( __real_clock_gettime( clock_id, tp ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Database Test - Fill
+// ========================
+static bool sm_eru_db_test_fill( unsigned int num_records )
+{
+    static const SmEruDatabaseEntryType types[] =
+    {
+        SM_ERU_DATABASE_ENTRY_TYPE_CPU_STATS,
+        SM_ERU_DATABASE_ENTRY_TYPE_DISK_STATS,
+        SM_ERU_DATABASE_ENTRY_TYPE_MEM_STATS,
+    };
+    SmEruDatabaseEntryT entry;
+
+    unlink( _filename );
+
+    if( SM_OKAY != sm_eru_db_initialize( _filename, false ) )
+    {
+        return( false );
+    }
+
+    _clock_ms = (int64_t) SM_ERU_DB_TEST_START_TIME * 1000;
+    _synthetic_clock = true;
+
+    unsigned int record_i;
+    for( record_i=0; num_records > record_i; ++record_i )
+    {
+        memset( &entry, 0, sizeof(entry) );
+        entry.type = types[record_i % 3];
+        switch( entry.type )
+        {
+            case SM_ERU_DATABASE_ENTRY_TYPE_CPU_STATS:
+                snprintf( entry.u.cpu_stats.cpu_name,
+                          sizeof(entry.u.cpu_stats.cpu_name), "cpu%u",
+                          record_i % 8 );
+                entry.u.cpu_stats.user_cpu_usage = record_i;
+            break;
+
+            case SM_ERU_DATABASE_ENTRY_TYPE_DISK_STATS:
+                snprintf( entry.u.disk_stats.dev_name,
+                          sizeof(entry.u.disk_stats.dev_name), "sd%c",
+                          'a' + (record_i % 4) );
+                entry.u.disk_stats.reads_completed = record_i;
+            break;
+
+            default:
+                entry.u.mem_stats.total_memory_kB = 16777216;
+                entry.u.mem_stats.free_memory_kB = record_i;
+            break;
+        }
+
+        sm_eru_db_write( &entry );
+    }
+
+    _synthetic_clock = false;
+
+    sm_eru_db_finalize();
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Database Test - Tear
+// ========================
+// Clears the tags of a segment's index entry and first record, as the
+// writer leaves them while overwriting the segment.
+static bool sm_eru_db_test_tear( uint64_t segment )
+{
+    size_t map_size = SM_ERU_DB_TEST_HEADER_SIZE
+                    + sizeof(SmEruDbTestIndexT) * SM_ERU_DB_TEST_INDEX_MAX
+                    + sizeof(SmEruDbTestRecordT) * SM_ERU_DB_MAX_RECORDS;
+    SmEruDbTestIndexT* index;
+    SmEruDbTestRecordT* record;
+    void* map;
+    int fd;
+
+    fd = open( _filename, O_RDWR );
+    if( 0 > fd )
+    {
+        return( false );
+    }
+
+    map = mmap( NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    close( fd );
+
+    if( MAP_FAILED == map )
+    {
+        return( false );
+    }
+
+    index = (SmEruDbTestIndexT*) ((char*) map + SM_ERU_DB_TEST_HEADER_SIZE);
+    index += segment % SM_ERU_DB_TEST_INDEX_MAX;
+    index->generation = 0;
+    index->generation_end = 0;
+
+    record = (SmEruDbTestRecordT*) ((char*) map + SM_ERU_DB_TEST_HEADER_SIZE
+           + sizeof(SmEruDbTestIndexT) * SM_ERU_DB_TEST_INDEX_MAX);
+    record += (segment * SM_ERU_DB_INDEX_INTERVAL) % SM_ERU_DB_MAX_RECORDS;
+    record->generation = 0;
+    record->generation_end = 0;
+
+    munmap( map, map_size );
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Database Test - Dump
+// ========================
+// Returns the dump as a string, to be freed.
+static char* sm_eru_db_test_dump( int read_index, int num_records,
+    const SmEruDatabaseFilterT* filter, unsigned int num_threads )
+{
+    char* buffer = NULL;
+    size_t buffer_size = 0;
+    FILE* fp;
+
+    fp = open_memstream( &buffer, &buffer_size );
+    if( NULL == fp )
+    {
+        return( NULL );
+    }
+
+    sm_eru_db_dump( fp, read_index, num_records, filter, num_threads );
+    fclose( fp );
+
+    return( buffer );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Database Test - Same
+// ========================
+static bool sm_eru_db_test_same( const char* expected, const char* actual )
+{
+    return(( NULL != expected )&&( NULL != actual )&&
+           ( 0 == strcmp( expected, actual ) ));
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Database Test - Windows
+// ===========================
+// Dumps each window from the index and by scanning the whole ring, from
+// the oldest record when it has wrapped.
+static void sm_eru_db_test_windows( const char ring_name[] )
+{
+    SmEruDatabaseFilterT filter;
+    SmEruDatabaseEntryT entry;
+    time_t first_time, last_time, mid_time;
+    int total, oldest_i, newest_i;
+    int read_index, num_records;
+    bool same = true, same_threaded = true, narrowed = true;
+    bool clamped = false, oldest_found = true;
+    char name[128];
+
+    if( SM_OKAY != sm_eru_db_initialize( _filename, true ) )
+    {
+        snprintf( name, sizeof(name), "%s: open", ring_name );
+        sm_eru_db_test_check( false, name );
+        return;
+    }
+
+    total = sm_eru_db_total();
+    newest_i = sm_eru_db_get_write_index();
+    oldest_i = ( SM_ERU_DB_MAX_RECORDS == total ) ? newest_i : 0;
+    newest_i = ( 0 == newest_i ) ? SM_ERU_DB_MAX_RECORDS - 1 : newest_i - 1;
+
+    // The oldest record is read ahead of a torn one.
+    int record_i = oldest_i;
+    while( SM_OKAY != sm_eru_db_read( record_i, &entry ) )
+    {
+        record_i = (record_i + 1) % SM_ERU_DB_MAX_RECORDS;
+    }
+    first_time = entry.ts_real.tv_sec;
+
+    sm_eru_db_read( newest_i, &entry );
+    last_time = entry.ts_real.tv_sec;
+    mid_time = first_time + (last_time - first_time) / 2;
+
+    const SmEruDbTestWindowT windows[] =
+    {
+        { "open", 0, 0 },
+        { "start only", mid_time, 0 },
+        { "end only", 0, mid_time },
+        { "inside", mid_time - 10, mid_time + 10 },
+        { "oldest segment", first_time - 100, first_time + 1 },
+        { "newest segment", last_time - 1, last_time + 100 },
+        { "one second", mid_time, mid_time },
+        { "end before start", mid_time + 10, mid_time - 10 },
+    };
+
+    unsigned int window_i;
+    for( window_i=0; sizeof(windows)/sizeof(windows[0]) > window_i;
+         ++window_i )
+    {
+        const SmEruDbTestWindowT* window = &(windows[window_i]);
+
+        unsigned int types_i;
+        for( types_i=0; 2 > types_i; ++types_i )
+        {
+            memset( &filter, 0, sizeof(filter) );
+            memset( filter.types, 0 == types_i, sizeof(filter.types) );
+            filter.types[SM_ERU_DATABASE_ENTRY_TYPE_DISK_STATS] = true;
+            filter.start_time = window->start_time;
+            filter.end_time = window->end_time;
+
+            char* full = sm_eru_db_test_dump( oldest_i, total, &filter, 1 );
+
+            sm_eru_db_find_window( window->start_time, window->end_time,
+                                   &read_index, &num_records );
+
+            char* windowed = sm_eru_db_test_dump( read_index, num_records,
+                                                  &filter, 1 );
+            char* threaded = sm_eru_db_test_dump( read_index, num_records,
+                                                  &filter, 4 );
+
+            if( !sm_eru_db_test_same( full, windowed ) )
+            {
+                printf( "  %s window %s: %i records from %i differ\n",
+                        ring_name, window->name, num_records, read_index );
+                same = false;
+            }
+
+            same_threaded &= sm_eru_db_test_same( windowed, threaded );
+
+            if(( 0 == strcmp( "inside", window->name ) )&&
+               ( 4 * SM_ERU_DB_INDEX_INTERVAL < num_records ))
+            {
+                narrowed = false;
+            }
+
+            if( 0 == strcmp( "end before start", window->name ) )
+            {
+                clamped = ( 0 == num_records );
+            }
+
+            if(( 0 == strcmp( "oldest segment", window->name ) )&&
+               (( read_index != oldest_i )||( NULL == full )||
+                ( '\0' == full[0] )))
+            {
+                oldest_found = false;
+            }
+
+            free( full );
+            free( windowed );
+            free( threaded );
+        }
+    }
+
+    snprintf( name, sizeof(name), "%s: windows match a full scan",
+              ring_name );
+    sm_eru_db_test_check( same, name );
+    snprintf( name, sizeof(name), "%s: windows match on 4 threads",
+              ring_name );
+    sm_eru_db_test_check( same_threaded, name );
+    snprintf( name, sizeof(name), "%s: window narrowed by the index",
+              ring_name );
+    sm_eru_db_test_check( narrowed, name );
+    snprintf( name, sizeof(name), "%s: oldest records found", ring_name );
+    sm_eru_db_test_check( oldest_found, name );
+    snprintf( name, sizeof(name), "%s: end before start clamped",
+              ring_name );
+    sm_eru_db_test_check( clamped, name );
+
+    // Full dumps, split at segment boundaries whatever the oldest record.
+    memset( &filter, 0, sizeof(filter) );
+    memset( filter.types, 1, sizeof(filter.types) );
+
+    char* single = sm_eru_db_test_dump( oldest_i, total, &filter, 1 );
+
+    unsigned int num_threads;
+    for( num_threads=2; 16 >= num_threads; num_threads *= 2 )
+    {
+        char* threaded = sm_eru_db_test_dump( oldest_i, total, &filter,
+                                              num_threads );
+
+        snprintf( name, sizeof(name), "%s: full dump on %u threads "
+                  "byte-identical", ring_name, num_threads );
+        sm_eru_db_test_check( sm_eru_db_test_same( single, threaded ), name );
+        free( threaded );
+    }
+
+    free( single );
+
+    sm_eru_db_finalize();
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Main
+// ====
+int main( int argc, char *argv[], char *envp[] )
+{
+    const unsigned int wrapped = 2 * SM_ERU_DB_MAX_RECORDS + 1000;
+    int fd;
+
+    setenv( "TZ", "", 1 );
+    tzset();
+
+    fd = mkstemp( _filename );
+    if( 0 > fd )
+    {
+        printf( "FAIL: scratch file, error=%s\n", strerror(errno) );
+        return( EXIT_FAILURE );
+    }
+    close( fd );
+
+    printf( "ring of %i records, index every %i records\n",
+            SM_ERU_DB_MAX_RECORDS, SM_ERU_DB_INDEX_INTERVAL );
+
+    if( sm_eru_db_test_fill( 5000 ) )
+    {
+        sm_eru_db_test_windows( "partial" );
+    }
+
+    if( sm_eru_db_test_fill( 16 * SM_ERU_DB_INDEX_INTERVAL ) )
+    {
+        sm_eru_db_test_windows( "segment aligned" );
+    }
+
+    // The oldest segment is partial, its first record overwritten.
+    if( sm_eru_db_test_fill( wrapped ) )
+    {
+        sm_eru_db_test_windows( "wrapped" );
+
+        // The newest segment and one in the middle as if being overwritten.
+        sm_eru_db_test_check(
+            ( sm_eru_db_test_tear( (wrapped - 1) / SM_ERU_DB_INDEX_INTERVAL ) )&&
+            ( sm_eru_db_test_tear( (wrapped - SM_ERU_DB_MAX_RECORDS / 2)
+                                   / SM_ERU_DB_INDEX_INTERVAL ) ),
+            "tear segments" );
+
+        sm_eru_db_test_windows( "overwritten" );
+    }
+
+    unlink( _filename );
+
+    printf( "%u failed\n", _failures );
+
+    return( ( 0 == _failures ) ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+// ****************************************************************************
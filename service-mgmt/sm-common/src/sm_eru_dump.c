@@ -14,6 +14,8 @@
 #include "sm_types.h"
 #include "sm_debug.h"
 #include "sm_eru_db.h"
+#include "sm_eru_ts.h"
+
 
 static struct option _sm_eru_long_options[] =
 {
@@ -23,6 +25,9 @@ static struct option _sm_eru_long_options[] =
     { "end-time",   required_argument, NULL, 'e'},
     { "last",       required_argument, NULL, 'l'},
     { "raw",        no_argument,       NULL, 'r'},
+    { "timeseries", no_argument,       NULL, 'T'},
+    { "threads",    required_argument, NULL, 'j'},
+    { "service",    required_argument, NULL, 'S'},
     {0, 0, 0, 0}
 };
 
@@ -33,17 +38,26 @@ static void usage( void )
 {
     printf( " usage:\n"
             "   sm-eru-dump [--file <file name of the eru database>]\n"
-            "               [--type <cpu|mem|disk|net|tc|if|ip>]\n"
+            "               [--type <cpu|mem|disk|net|tc|if|ip|svc>]\n"
+            "               [--service <service name>]\n"
             "               [--start-time <\"YEAR-MONTH-DAY HH:MM:SS\">]\n"
             "               [--end-time   <\"YEAR-MONTH-DAY HH:MM:SS\">]\n"
             "               [--last <number>]\n"
             "               [--raw]\n"
+            "               [--timeseries]\n"
+            "               [--threads <number>]\n"
             "               [--help]\n"
             "       --type      : type of record to filter on\n"
+            "       --service   : only the service statistics of this service,\n"
+            "                     implies --type svc\n"
             "       --start-time: start time for filter (inclusive)\n"
             "       --end-time  : end time for filter (inclusive)\n"
             "       --last      : display last so many records\n"
             "       --raw       : display raw record data\n"
+            "       --timeseries: dump the time series store instead of the\n"
+            "                     ring, --file then names the time series file\n"
+            "       --threads   : format the dump on this many threads, one\n"
+            "                     ring segment each, output order is kept\n"
             "       --help      : print out this help message\n"
             "\n"
             "   eg. sm-eru-dump --start-time \"2014-10-17 22:15:10\"\n"
@@ -51,6 +65,23 @@ static void usage( void )
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Main - Event Recorder Unit Dump Time Series Display
+// ===================================================
+static bool sm_eru_dump_ts_display( SmEruDatabaseEntryT* entry,
+    void* user_data )
+{
+    const SmEruDatabaseFilterT* filter
+        = (const SmEruDatabaseFilterT*) user_data;
+
+    if( sm_eru_db_match( filter, entry ) )
+    {
+        sm_eru_db_display( entry, filter->want_raw );
+    }
+    return( true );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Main - Event Recorder Unit Dump
 // ===============================
@@ -61,6 +92,8 @@ int main( int argc, char *argv[], char *envp[] )
     int record_i, record_count, total_records;
     char buf[128];
     bool want_raw = false;
+    bool want_timeseries = false;
+    unsigned int num_threads = 1;
     bool filter_record_type = false;
     bool filter_start_time = false;
     bool filter_end_time = false;
@@ -70,13 +103,16 @@ int main( int argc, char *argv[], char *envp[] )
     time_t end_time = 0;
     int num_record_types = 0;
     char* filename = NULL;
+    char* service_name = NULL;
     char* tz = NULL;
 
     SmEruDatabaseEntryType record_types[SM_ERU_DATABASE_ENTRY_TYPE_MAX];
-    SmEruDatabaseEntryT entry;
+    SmEruDatabaseFilterT filter;
     SmErrorT error;
 
     memset( record_types, 0, sizeof(record_types) );
+    memset( &start_tm, 0, sizeof(start_tm) );
+    memset( &end_tm, 0, sizeof(end_tm) );
 
     tz = getenv( "TZ" );
     setenv( "TZ", "", 1 );
@@ -151,10 +187,25 @@ int main( int argc, char *argv[], char *envp[] )
                             = SM_ERU_DATABASE_ENTRY_TYPE_IP_CHANGE;
                         ++num_record_types;
                         printf( "filter-record-match : ip-change\n" );
+
+                    } else if( 0 == strcmp( optarg, "svc" ) ) {
+                        filter_record_type = true;
+                        record_types[num_record_types]
+                            = SM_ERU_DATABASE_ENTRY_TYPE_SERVICE_STATS;
+                        ++num_record_types;
+                        printf( "filter-record-match : service-stats\n" );
                     }
                 }
             break;
 
+            case 'S':
+                if( optarg )
+                {
+                    service_name = (char*) optarg;
+                    printf( "filter-service      : %s\n", service_name );
+                }
+            break;
+
             case 's':
                 if( optarg )
                 {
@@ -196,6 +247,25 @@ int main( int argc, char *argv[], char *envp[] )
                 want_raw = true;
             break;
 
+            case 'T':
+                printf( "dump-timeseries     : true\n" );
+                want_timeseries = true;
+            break;
+
+            case 'j':
+                if( optarg )
+                {
+                    num_threads = (unsigned int) atoi( optarg );
+                    if( 0 == num_threads )
+                    {
+                        num_threads = 1;
+                    } else if( SM_ERU_DB_DUMP_THREADS_MAX < num_threads ) {
+                        num_threads = SM_ERU_DB_DUMP_THREADS_MAX;
+                    }
+                    printf( "dump-threads        : %u\n", num_threads );
+                }
+            break;
+
             case 'h':
             case '?':
                 usage();
@@ -212,6 +282,65 @@ int main( int argc, char *argv[], char *envp[] )
     }
     tzset();
 
+    memset( &filter, 0, sizeof(filter) );
+    memset( filter.types, !filter_record_type, sizeof(filter.types) );
+
+    int type_i;
+    for( type_i=0; num_record_types > type_i; ++type_i )
+    {
+        filter.types[record_types[type_i]] = true;
+    }
+
+    if( filter_start_time )
+    {
+        filter.start_time = start_time;
+    }
+
+    if( filter_end_time )
+    {
+        filter.end_time = end_time;
+    }
+
+    if( NULL != service_name )
+    {
+        memset( filter.types, 0, sizeof(filter.types) );
+        filter.types[SM_ERU_DATABASE_ENTRY_TYPE_SERVICE_STATS] = true;
+        filter.service_name = service_name;
+    }
+
+    filter.want_raw = want_raw;
+
+    if( want_timeseries )
+    {
+        if( -1 != last )
+        {
+            printf( "display-last is not supported with --timeseries, "
+                    "use --start-time instead.\n" );
+            return( EXIT_FAILURE );
+        }
+
+        error = sm_eru_ts_initialize( filename, true );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "ERU time series initialize failed, error=%s.",
+                      sm_error_str( error ) );
+            return( EXIT_FAILURE );
+        }
+
+        error = sm_eru_ts_query( filter.types, filter.start_time,
+                                 filter.end_time, sm_eru_dump_ts_display,
+                                 &filter );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "ERU time series query failed, error=%s.",
+                      sm_error_str( error ) );
+        }
+
+        sm_eru_ts_finalize();
+
+        return(( SM_OKAY == error ) ? EXIT_SUCCESS : EXIT_FAILURE );
+    }
+
     error = sm_eru_db_initialize( filename, true );
     if( SM_OKAY != error )
     {
@@ -221,15 +350,24 @@ int main( int argc, char *argv[], char *envp[] )
     }
 
     total_records = sm_eru_db_total();
-    record_count = total_records;
 
     printf( "total-records: %i (entry-size=%i bytes)\n", total_records,
             (int) sizeof(SmEruDatabaseEntryT) );
 
     if(( -1 == last )||( last >= total_records ))
     {
-        record_i = 0;
+        error = sm_eru_db_find_window( filter.start_time, filter.end_time,
+                                       &record_i, &record_count );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to find records to dump, error=%s.",
+                      sm_error_str( error ) );
+            sm_eru_db_finalize();
+            return( EXIT_FAILURE );
+        }
     } else {
+        record_count = total_records;
+
         int last_record = sm_eru_db_get_write_index();
         if( 0 >= last_record )
         {
@@ -248,64 +386,8 @@ int main( int argc, char *argv[], char *envp[] )
         }
     }
 
-    for( ; 0 < record_count; --record_count )
-    {
-        error = sm_eru_db_read( record_i, &entry );
-        if( SM_OKAY != error )
-        {
-            DPRINTFE( "Failed to read record at index (%i), error=%s.",
-                      record_i, sm_error_str( error ) );
-            break;
-        }
-
-        if( filter_record_type )
-        {
-            bool found = false;
+    sm_eru_db_dump( stdout, record_i, record_count, &filter, num_threads );
 
-            int type_i;
-            for( type_i=0; num_record_types > type_i; ++type_i )
-            {
-                if( record_types[type_i] == entry.type )
-                {
-                    found = true;
-                    break;
-                }
-            }
-
-            if( !found )
-            {
-                goto INCREMENT;
-            }
-        }
-
-        if( filter_start_time )
-        {
-            double diff = difftime( start_time, entry.ts_real.tv_sec ); 
-            if( diff > 0.0 )
-            {
-                goto INCREMENT;
-            }
-        }
-
-        if( filter_end_time )
-        {
-            double diff = difftime( end_time, entry.ts_real.tv_sec ); 
-            if( diff < 0.0 )
-            {
-                goto INCREMENT;
-            }
-        }
-
-        sm_eru_db_display( &entry, want_raw );
-
-INCREMENT:
-        ++record_i;
-        if( total_records <= record_i )
-        {
-            record_i = 0;
-        }
-    }
-    
     printf( "total-records: %i (entry-size=%i bytes)\n", total_records,
             (int) sizeof(SmEruDatabaseEntryT) );
 
@@ -38,14 +38,53 @@
 #include "sm_node_utils.h"
 #include "sm_node_stats.h"
 #include "sm_eru_db.h"
+#include "sm_eru_ts.h"
+#include "sm_eru_services.h"
 
 #define SM_ERU_PROCESS_TICK_INTERVAL_IN_MS                             1000
-#define SM_ERU_PROCESS_STATS_TIMER_IN_MS                              30000
+#define SM_ERU_PROCESS_STATS_TIMER_IN_MS                               5000
+#define SM_ERU_PROCESS_STATS_INTERVAL_IN_MS                           30000
+#define SM_ERU_PROCESS_TRANSITION_STATS_INTERVAL_IN_MS                 5000
+#define SM_ERU_PROCESS_TRANSITION_MAX_IN_MS                          600000
 
 static sig_atomic_t _stay_on = 1;
 static SmTimerIdT _stats_timer_id = SM_TIMER_ID_INVALID;
 static SmEruDatabaseEntryT _cpu_prev_entry;
 static char _interfaces[SM_INTERFACE_MAX][SM_INTERFACE_NAME_MAX_CHAR];
+static SmNodeDiskStatsT _disk_stats[SM_DISK_MAX];
+static SmNodeNetDevStatsT _net_stats[SM_INTERFACE_MAX];
+static SmEruServiceT _services[SM_ERU_SERVICES_MAX];
+static SmTimeT _stats_last_time;
+static SmTimeT _transition_start_time;
+static bool _stats_sampled = false;
+static bool _transition = false;
+static bool _storage_ring = true;
+static bool _storage_timeseries = false;
+
+static struct option _sm_eru_process_long_options[] =
+{
+    { "storage", required_argument, NULL, 's'},
+    {0, 0, 0, 0}
+};
+
+// ****************************************************************************
+// Event Recorder Unit Process - Write
+// ===================================
+// Records the entry in each of the stores enabled by --storage, the ring
+// stamps the entry first so both stores carry the same time.
+static void sm_eru_process_write( SmEruDatabaseEntryT* entry )
+{
+    if( _storage_ring )
+    {
+        sm_eru_db_write( entry );
+    }
+
+    if( _storage_timeseries )
+    {
+        sm_eru_ts_write( entry );
+    }
+}
+// ****************************************************************************
 
 // ****************************************************************************
 // Event Recorder Unit Process - Find Interface
@@ -140,10 +179,10 @@ static void sm_eru_process_qdisc_info_callback( SmHwQdiscInfoT* qdisc )
         memset( &entry, 0, sizeof(SmEruDatabaseEntryT) );    
         entry.type = SM_ERU_DATABASE_ENTRY_TYPE_TC_STATS;
         memcpy( &(entry.u.tc_stats), qdisc, sizeof(SmHwQdiscInfoT) );
-        sm_eru_db_write( &entry );
+        sm_eru_process_write( &entry );
     }
 
-    // Ensure all the records are written to disk after this callback
+    // Start writeback of the records to disk after this callback
     sm_eru_db_sync();
 }
 // ****************************************************************************
@@ -165,10 +204,10 @@ static void sm_eru_process_interface_change_callback(
         entry.type = SM_ERU_DATABASE_ENTRY_TYPE_IF_CHANGE;
         memcpy( &(entry.u.if_change), if_change,
                 sizeof(SmHwInterfaceChangeDataT) );
-        sm_eru_db_write( &entry );
+        sm_eru_process_write( &entry );
     }
 
-    // Ensure all the records are written to disk after this callback
+    // Start writeback of the records to disk after this callback
     sm_eru_db_sync();
 }
 // ****************************************************************************
@@ -189,23 +228,115 @@ static void sm_eru_process_ip_change_callback( SmHwIpChangeDataT* ip_change )
         entry.type = SM_ERU_DATABASE_ENTRY_TYPE_IP_CHANGE;
         memcpy( &(entry.u.ip_change), ip_change,
                 sizeof(SmHwIpChangeDataT) );
-        sm_eru_db_write( &entry );
+        sm_eru_process_write( &entry );
     }
 
-    // Ensure all the records are written to disk after this callback
+    // Start writeback of the records to disk after this callback
     sm_eru_db_sync();
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Event Recorder Unit Process - Service Statistics
+// ================================================
+// Resource use of the processes of the services SM monitors, tagged with
+// the service name.
+static void sm_eru_process_service_stats( void )
+{
+    SmEruDatabaseEntryT entry;
+    unsigned int num_services = 0;
+    SmErrorT error;
+
+    error = sm_eru_services_get( _services, SM_ERU_SERVICES_MAX,
+                                 &num_services );
+    if( SM_OKAY != error )
+    {
+        return;
+    }
+
+    unsigned int service_i;
+    for( service_i=0; num_services > service_i; ++service_i )
+    {
+        SmEruServiceT* service = &(_services[service_i]);
+
+        memset( &entry, 0, sizeof(SmEruDatabaseEntryT) );
+        entry.type = SM_ERU_DATABASE_ENTRY_TYPE_SERVICE_STATS;
+        snprintf( entry.u.service_stats.service_name,
+                  sizeof(entry.u.service_stats.service_name), "%s",
+                  service->service_name );
+
+        error = sm_node_stats_get_process_usage( service->pid,
+                                                 &(entry.u.service_stats.usage) );
+        if( SM_OKAY == error )
+        {
+            sm_eru_process_write( &entry );
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Process - Statistics Due
+// ============================================
+// Samples every SM_ERU_PROCESS_STATS_INTERVAL_IN_MS, and faster while SM
+// is doing a swact or failover.  A transition that runs past
+// SM_ERU_PROCESS_TRANSITION_MAX_IN_MS drops back to the normal rate.
+bool sm_eru_process_stats_due( void )
+{
+    long interval_in_ms = SM_ERU_PROCESS_STATS_INTERVAL_IN_MS;
+
+    if( SM_ERU_SERVICES_TRANSITION_NONE != sm_eru_services_get_transitions() )
+    {
+        if( !_transition )
+        {
+            DPRINTFI( "SM transition started, sampling every %i ms.",
+                      SM_ERU_PROCESS_TRANSITION_STATS_INTERVAL_IN_MS );
+            sm_time_get( &_transition_start_time );
+            _transition = true;
+        }
+
+        if( SM_ERU_PROCESS_TRANSITION_MAX_IN_MS
+            > sm_time_get_elapsed_ms( &_transition_start_time ) )
+        {
+            interval_in_ms = SM_ERU_PROCESS_TRANSITION_STATS_INTERVAL_IN_MS;
+        }
+    } else if( _transition ) {
+        DPRINTFI( "SM transition ended after %li ms.",
+                  sm_time_get_elapsed_ms( &_transition_start_time ) );
+        _transition = false;
+    }
+
+    // Half a timer period of slack so a late timer does not skip a sample.
+    interval_in_ms -= SM_ERU_PROCESS_STATS_TIMER_IN_MS / 2;
+
+    if(( _stats_sampled )&&
+       ( interval_in_ms > sm_time_get_elapsed_ms( &_stats_last_time ) ))
+    {
+        return( false );
+    }
+
+    sm_time_get( &_stats_last_time );
+    _stats_sampled = true;
+
+    return( true );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Event Recorder Unit Process - Statistics 
 // ========================================
 static bool sm_eru_process_stats( SmTimerIdT timer_id, int64_t user_data )
 {
     SmEruDatabaseEntryT entry;
-    SmNodeDiskStatsT* disk_stats = &(entry.u.disk_stats);
+    unsigned int num_disks = 0;
+    unsigned int num_interfaces = 0;
     SmErrorT error;
 
+    if( !sm_eru_process_stats_due() )
+    {
+        return( true );
+    }
+
     sm_eru_process_load_interfaces();
 
     // CPU Statistics.
@@ -251,7 +382,7 @@ static bool sm_eru_process_stats( SmTimerIdT timer_id, int64_t user_data )
                 = entry.u.cpu_stats.guest_nice_cpu_usage
                 - _cpu_prev_entry.u.cpu_stats.guest_nice_cpu_usage;
 
-            sm_eru_db_write( &delta_entry );
+            sm_eru_process_write( &delta_entry );
         }
         memcpy( &_cpu_prev_entry, &entry, sizeof(_cpu_prev_entry) );
     }
@@ -262,52 +393,74 @@ static bool sm_eru_process_stats( SmTimerIdT timer_id, int64_t user_data )
     error = sm_node_stats_get_memory( &(entry.u.mem_stats) );
     if( SM_OKAY == error )
     {
-        sm_eru_db_write( &entry );
+        sm_eru_process_write( &entry );
     }
 
-    // Disk Statistics
-    int disk_i;
-    for( disk_i=0; SM_DISK_MAX > disk_i; ++disk_i )
+    // Disk Statistics, all disks in one pass.
+    error = sm_node_stats_get_disks( _disk_stats, SM_DISK_MAX, &num_disks );
+    if( SM_OKAY != error )
     {
-        memset( &entry, 0, sizeof(SmEruDatabaseEntryT) );
-        entry.type = SM_ERU_DATABASE_ENTRY_TYPE_DISK_STATS;
-        error = sm_node_stats_get_disk_by_index( disk_i, disk_stats );
-        if( SM_OKAY == error )
+        num_disks = 0;
+    }
+
+    unsigned int disk_i;
+    for( disk_i=0; num_disks > disk_i; ++disk_i )
+    {
+        SmNodeDiskStatsT* disk_stats = &(_disk_stats[disk_i]);
+
+        if(( 0 != disk_stats->reads_completed )||
+           ( 0 != disk_stats->reads_merged )||
+           ( 0 != disk_stats->sectors_read )||
+           ( 0 != disk_stats->ms_spent_reading )||
+           ( 0 != disk_stats->writes_completed )||
+           ( 0 != disk_stats->writes_merged )||
+           ( 0 != disk_stats->sectors_written )||
+           ( 0 != disk_stats->ms_spent_writing )||
+           ( 0 != disk_stats->io_inprogress )||
+           ( 0 != disk_stats->ms_spent_io )||
+           ( 0 != disk_stats->weighted_ms_spent_io ))
         {
-            if(( 0 != disk_stats->reads_completed )||
-               ( 0 != disk_stats->reads_merged )||
-               ( 0 != disk_stats->sectors_read )||
-               ( 0 != disk_stats->ms_spent_reading )||
-               ( 0 != disk_stats->writes_completed )||
-               ( 0 != disk_stats->writes_merged )||
-               ( 0 != disk_stats->sectors_written )||
-               ( 0 != disk_stats->ms_spent_writing )||
-               ( 0 != disk_stats->io_inprogress )||
-               ( 0 != disk_stats->ms_spent_io )||
-               ( 0 != disk_stats->weighted_ms_spent_io ))
-            {
-                sm_eru_db_write( &entry );
-            }
+            memset( &entry, 0, sizeof(SmEruDatabaseEntryT) );
+            entry.type = SM_ERU_DATABASE_ENTRY_TYPE_DISK_STATS;
+            memcpy( &(entry.u.disk_stats), disk_stats,
+                    sizeof(SmNodeDiskStatsT) );
+            sm_eru_process_write( &entry );
         }
     }
 
-    // Net Device Statistics.
+    // Net Device Statistics, all interfaces in one pass.
     int if_i;
     for( if_i=0; SM_INTERFACE_MAX > if_i; ++if_i )
     {
         if( '\0' != _interfaces[if_i][0] )
         {
-            memset( &entry, 0, sizeof(SmEruDatabaseEntryT) );    
-            entry.type = SM_ERU_DATABASE_ENTRY_TYPE_NET_STATS;
-            error = sm_node_stats_get_netdev( _interfaces[if_i],
-                                              &(entry.u.net_stats) );
-            if( SM_OKAY == error )
+            snprintf( _net_stats[num_interfaces].dev_name,
+                      sizeof(_net_stats[num_interfaces].dev_name), "%s",
+                      _interfaces[if_i] );
+            ++num_interfaces;
+        }
+    }
+
+    if( 0 < num_interfaces )
+    {
+        error = sm_node_stats_get_netdevs( _net_stats, num_interfaces );
+        if( SM_OKAY == error )
+        {
+            unsigned int net_i;
+            for( net_i=0; num_interfaces > net_i; ++net_i )
             {
-                sm_eru_db_write( &entry );
+                memset( &entry, 0, sizeof(SmEruDatabaseEntryT) );
+                entry.type = SM_ERU_DATABASE_ENTRY_TYPE_NET_STATS;
+                memcpy( &(entry.u.net_stats), &(_net_stats[net_i]),
+                        sizeof(SmNodeNetDevStatsT) );
+                sm_eru_process_write( &entry );
             }
         }
     }
 
+    // Service Statistics.
+    sm_eru_process_service_stats();
+
     // Traffic Class Statistics.
     sm_hw_get_all_qdisc_async();
 
@@ -414,13 +567,35 @@ static SmErrorT sm_eru_process_initialize( void )
         return( error );
     }
 
-    error = sm_eru_db_initialize( NULL, false );
+    error = sm_eru_services_initialize( false );
     if( SM_OKAY != error )
     {
-        DPRINTFE( "Failed to initialize eru database module, error=%s.",
+        DPRINTFE( "Failed to initialize eru services module, error=%s.",
                   sm_error_str( error ) );
         return( error );
     }
+
+    if( _storage_ring )
+    {
+        error = sm_eru_db_initialize( NULL, false );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to initialize eru database module, error=%s.",
+                      sm_error_str( error ) );
+            return( error );
+        }
+    }
+
+    if( _storage_timeseries )
+    {
+        error = sm_eru_ts_initialize( NULL, false );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to initialize eru time series module, "
+                      "error=%s.", sm_error_str( error ) );
+            return( error );
+        }
+    }
     
     error = sm_timer_register( "eru stats",
                                SM_ERU_PROCESS_STATS_TIMER_IN_MS,
@@ -455,10 +630,30 @@ static SmErrorT sm_eru_process_finalize( void )
         _stats_timer_id = SM_TIMER_ID_INVALID;
     }
 
-    error = sm_eru_db_finalize();
+    if( _storage_timeseries )
+    {
+        error = sm_eru_ts_finalize();
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to finalize eru time series module, error=%s.",
+                      sm_error_str( error ) );
+        }
+    }
+
+    if( _storage_ring )
+    {
+        error = sm_eru_db_finalize();
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to finalize eru database module, error=%s.",
+                      sm_error_str( error ) );
+        }
+    }
+
+    error = sm_eru_services_finalize();
     if( SM_OKAY != error )
     {
-        DPRINTFE( "Failed to finalize eru database module, error=%s.",
+        DPRINTFE( "Failed to finalize eru services module, error=%s.",
                   sm_error_str( error ) );
     }
 
@@ -508,6 +703,44 @@ SmErrorT sm_eru_process_main( int argc, char *argv[], char *envp[] )
 {
     bool thread_health;
     SmErrorT error;
+    int c;
+
+    while( true )
+    {
+        c = getopt_long( argc, argv, "", _sm_eru_process_long_options, NULL );
+        if( -1 == c )
+        {
+            break;
+        }
+
+        switch( c )
+        {
+            case 's':
+                if( 0 == strcmp( optarg, "ring" ) )
+                {
+                    _storage_ring = true;
+                    _storage_timeseries = false;
+
+                } else if( 0 == strcmp( optarg, "timeseries" ) ) {
+                    _storage_ring = false;
+                    _storage_timeseries = true;
+
+                } else if( 0 == strcmp( optarg, "both" ) ) {
+                    _storage_ring = true;
+                    _storage_timeseries = true;
+
+                } else {
+                    DPRINTFE( "Unknown storage (%s), expected ring, "
+                              "timeseries or both.", optarg );
+                    return( SM_FAILED );
+                }
+            break;
+
+            case '?':
+                return( SM_FAILED );
+            break;
+        }
+    }
 
     sm_eru_process_setup_signal_handler();
 
@@ -6,12 +6,21 @@
 #ifndef __SM_ERU_PROCESS_H__
 #define __SM_ERU_PROCESS_H__
 
+#include <stdbool.h>
+
 #include "sm_types.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// ****************************************************************************
+// Event Recorder Unit Process - Statistics Due
+// ============================================
+// Called on each statistics timer, returns true when a sample is due.
+extern bool sm_eru_process_stats_due( void );
+// ****************************************************************************
+
 // ****************************************************************************
 // Event Recorder Unit Process - Main
 // ==================================
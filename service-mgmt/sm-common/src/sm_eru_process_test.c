@@ -0,0 +1,453 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Checks the per-service sampling of the ERU, exits non-zero when a check
+// fails.  The services table is written and read back in a scratch
+// directory, the sampling rate is driven by wrapping the clock, and the
+// process statistics are read from a fixture /proc.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_node_stats.h"
+#include "sm_eru_services.h"
+#include "sm_eru_process.h"
+
+#define SM_ERU_PROCESS_TEST_PID                                       4242
+
+// Layout of the services table, as in sm_eru_services.c.
+typedef struct
+{
+    uint32_t sequence;
+    int32_t pid;
+    char service_name[SM_SERVICE_NAME_MAX_CHAR];
+} SmEruProcessTestEntryT;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t max_services;
+    uint32_t transitions;
+    SmEruProcessTestEntryT entries[SM_ERU_SERVICES_MAX];
+} SmEruProcessTestTableT;
+
+extern "C" int __real_clock_gettime( clockid_t clock_id, struct timespec* tp );
+
+static bool _synthetic_clock = false;
+static int64_t _clock_ms = 0;
+static char _directory[] = "/tmp/sm_eru_process_test.XXXXXX";
+static unsigned int _failures = 0;
+
+// ****************************************************************************
+// ERU Process Test - Check
+// ========================
+static void sm_eru_process_test_check( bool passed, const char name[] )
+{
+    printf( "%s: %s\n", passed ? "PASS" : "FAIL", name );
+
+    if( !passed )
+    {
+        ++_failures;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Process Test - Clock
+// ========================
+// Drives the monotonic clock the sampling rate is measured on.
+extern "C" int __wrap_clock_gettime( clockid_t clock_id, struct timespec* tp )
+{
+    if(( _synthetic_clock )&&( CLOCK_MONOTONIC_RAW == clock_id ))
+    {
+        tp->tv_sec = (time_t) (_clock_ms / 1000);
+        tp->tv_nsec = (long) (_clock_ms % 1000) * 1000000;
+        return( 0 );
+    }
+
+    return( __real_clock_gettime( clock_id, tp ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Process Test - Find
+// =======================
+static int sm_eru_process_test_find( SmEruServiceT services[],
+    unsigned int num_services, const char service_name[] )
+{
+    unsigned int service_i;
+    for( service_i=0; num_services > service_i; ++service_i )
+    {
+        if( 0 == strcmp( service_name, services[service_i].service_name ) )
+        {
+            return( services[service_i].pid );
+        }
+    }
+
+    return( -1 );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Process Test - Read Back
+// ============================
+// Reads the table in a child, as the ERU does from its own process, and
+// returns the number of services seen or -1 when the table is not valid.
+static int sm_eru_process_test_read_back( int expected_api_pid,
+    int expected_db_pid )
+{
+    int status;
+    pid_t pid;
+
+    pid = fork();
+    if( 0 > pid )
+    {
+        return( -1 );
+    }
+
+    if( 0 == pid )
+    {
+        SmEruServiceT services[SM_ERU_SERVICES_MAX];
+        unsigned int num_services = 0;
+
+        // The mapping of the writer is left to the exit of the child.
+        sm_eru_services_initialize( false );
+
+        if( SM_OKAY != sm_eru_services_get( services, SM_ERU_SERVICES_MAX,
+                                            &num_services ) )
+        {
+            _exit( 255 );
+        }
+
+        if(( expected_api_pid != sm_eru_process_test_find( services,
+                                            num_services, "api" ) )||
+           ( expected_db_pid != sm_eru_process_test_find( services,
+                                            num_services, "database" ) ))
+        {
+            _exit( 254 );
+        }
+
+        _exit( (int) num_services );
+    }
+
+    if(( pid != waitpid( pid, &status, 0 ) )||( !WIFEXITED(status) ))
+    {
+        return( -1 );
+    }
+
+    if( 255 == WEXITSTATUS(status) )
+    {
+        return( -1 );
+    }
+
+    return( WEXITSTATUS(status) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Process Test - Services Table
+// =================================
+static void sm_eru_process_test_services( void )
+{
+    char filename[sizeof(_directory)+32];
+    SmEruProcessTestTableT* table;
+    SmEruProcessTestEntryT* entry = NULL;
+    struct stat stat_info;
+    int fd;
+
+    sm_eru_services_set_directory( _directory );
+
+    sm_eru_process_test_check( 0 > sm_eru_process_test_read_back( 0, 0 ),
+                               "no table before SM creates it" );
+
+    sm_eru_process_test_check( SM_OKAY == sm_eru_services_initialize( true ),
+                               "writer initialize" );
+
+    snprintf( filename, sizeof(filename), "%s/sm.eru.services", _directory );
+    sm_eru_process_test_check(( 0 == stat( filename, &stat_info ) )&&
+                              ( sizeof(SmEruProcessTestTableT)
+                                == (size_t) stat_info.st_size ),
+                              "table created in the run directory" );
+
+    sm_eru_services_set( "api", 100 );
+    sm_eru_services_set( "database", 200 );
+    sm_eru_services_set( "web", 300 );
+    sm_eru_services_set( "database", 201 );
+    sm_eru_services_set( "web", 0 );
+    sm_eru_services_set( "ntp", -1 );
+
+    sm_eru_process_test_check( 2 == sm_eru_process_test_read_back( 100, 201 ),
+                               "services read back with their latest pids" );
+
+    // An odd sequence is an entry the writer is in the middle of.
+    fd = open( filename, O_RDWR );
+    table = (SmEruProcessTestTableT*) mmap( NULL,
+        sizeof(SmEruProcessTestTableT), PROT_READ | PROT_WRITE, MAP_SHARED,
+        fd, 0 );
+    close( fd );
+
+    if( MAP_FAILED != (void*) table )
+    {
+        unsigned int entry_i;
+        for( entry_i=0; SM_ERU_SERVICES_MAX > entry_i; ++entry_i )
+        {
+            if( 0 == strcmp( "database", table->entries[entry_i].service_name ) )
+            {
+                entry = &(table->entries[entry_i]);
+                break;
+            }
+        }
+    }
+
+    sm_eru_process_test_check( NULL != entry, "entry in the mapped table" );
+
+    if( NULL != entry )
+    {
+        ++(entry->sequence);
+        sm_eru_process_test_check( 1 == sm_eru_process_test_read_back( 100,
+                                   -1 ), "entry being written skipped" );
+
+        ++(entry->sequence);
+        sm_eru_process_test_check( 2 == sm_eru_process_test_read_back( 100,
+                                   201 ), "entry read once written" );
+    }
+
+    if( MAP_FAILED != (void*) table )
+    {
+        munmap( table, sizeof(SmEruProcessTestTableT) );
+    }
+
+    sm_eru_services_set_transition( SM_ERU_SERVICES_TRANSITION_SWACT, true );
+    sm_eru_services_set_transition( SM_ERU_SERVICES_TRANSITION_FAILOVER,
+                                    true );
+    sm_eru_services_set_transition( SM_ERU_SERVICES_TRANSITION_SWACT, false );
+    sm_eru_process_test_check( SM_ERU_SERVICES_TRANSITION_FAILOVER
+                               == sm_eru_services_get_transitions(),
+                               "transitions in progress" );
+    sm_eru_services_set_transition( SM_ERU_SERVICES_TRANSITION_FAILOVER,
+                                    false );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Process Test - Due
+// ======================
+// Advances the clock and polls as the 5 second statistics timer does.
+static bool sm_eru_process_test_due( long advance_ms )
+{
+    _clock_ms += advance_ms;
+
+    return( sm_eru_process_stats_due() );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Process Test - Sampling Rate
+// ================================
+static void sm_eru_process_test_rate( void )
+{
+    unsigned int samples = 0;
+
+    _clock_ms = 1000000;
+    _synthetic_clock = true;
+
+    sm_eru_process_test_check( sm_eru_process_test_due( 0 ),
+                               "first timer samples" );
+
+    unsigned int tick_i;
+    for( tick_i=0; 24 > tick_i; ++tick_i )
+    {
+        samples += sm_eru_process_test_due( 5000 ) ? 1 : 0;
+    }
+
+    sm_eru_process_test_check( 4 == samples, "every 30 s when idle" );
+
+    sm_eru_services_set_transition( SM_ERU_SERVICES_TRANSITION_SWACT, true );
+
+    samples = 0;
+    for( tick_i=0; 24 > tick_i; ++tick_i )
+    {
+        samples += sm_eru_process_test_due( 5000 ) ? 1 : 0;
+    }
+
+    sm_eru_process_test_check( 24 == samples, "every 5 s during a swact" );
+
+    // A transition that never ends drops back after 10 minutes.
+    samples = 0;
+    for( tick_i=0; 120 > tick_i; ++tick_i )
+    {
+        samples += sm_eru_process_test_due( 5000 ) ? 1 : 0;
+    }
+
+    sm_eru_process_test_check( 96 + 4 == samples,
+                              "back to every 30 s after 10 minutes" );
+
+    sm_eru_services_set_transition( SM_ERU_SERVICES_TRANSITION_SWACT, false );
+    sm_eru_process_test_due( 30000 );
+    sm_eru_services_set_transition( SM_ERU_SERVICES_TRANSITION_FAILOVER,
+                                    true );
+
+    sm_eru_process_test_check( sm_eru_process_test_due( 5000 ),
+                               "failover samples on the next timer" );
+
+    sm_eru_services_set_transition( SM_ERU_SERVICES_TRANSITION_FAILOVER,
+                                    false );
+
+    samples = 0;
+    for( tick_i=0; 12 > tick_i; ++tick_i )
+    {
+        samples += sm_eru_process_test_due( 5000 ) ? 1 : 0;
+    }
+
+    sm_eru_process_test_check( 2 == samples, "every 30 s once it ends" );
+
+    _synthetic_clock = false;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Process Test - Write File
+// =============================
+static bool sm_eru_process_test_write_file( const char path[],
+    const char content[] )
+{
+    FILE* fp = fopen( path, "w" );
+
+    if( NULL == fp )
+    {
+        return( false );
+    }
+
+    fputs( content, fp );
+    fclose( fp );
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Process Test - Process Usage
+// ================================
+// A stat line whose command name holds spaces and parentheses, with utime,
+// stime and rss at fields 14, 15 and 24.
+static void sm_eru_process_test_usage( void )
+{
+    char proc_dir[sizeof(_directory)+16];
+    char path[sizeof(proc_dir)+64];
+    SmNodeProcessUsageT usage;
+    long user_hz = sysconf( _SC_CLK_TCK );
+    long page_size = sysconf( _SC_PAGESIZE );
+    bool created;
+
+    snprintf( proc_dir, sizeof(proc_dir), "%s/proc", _directory );
+
+    created = ( 0 == mkdir( proc_dir, 0700 ) );
+    snprintf( path, sizeof(path), "%s/%i", proc_dir,
+              SM_ERU_PROCESS_TEST_PID );
+    created &= ( 0 == mkdir( path, 0700 ) );
+    snprintf( path, sizeof(path), "%s/%i/fd", proc_dir,
+              SM_ERU_PROCESS_TEST_PID );
+    created &= ( 0 == mkdir( path, 0700 ) );
+
+    unsigned int fd_i;
+    for( fd_i=0; 3 > fd_i; ++fd_i )
+    {
+        snprintf( path, sizeof(path), "%s/%i/fd/%u", proc_dir,
+                  SM_ERU_PROCESS_TEST_PID, fd_i );
+        created &= sm_eru_process_test_write_file( path, "" );
+    }
+
+    snprintf( path, sizeof(path), "%s/%i/stat", proc_dir,
+              SM_ERU_PROCESS_TEST_PID );
+    created &= sm_eru_process_test_write_file( path,
+        "4242 (sm (api) worker) S 1 4242 4242 0 -1 4194560 1200 0 3 0 "
+        "250 75 0 0 20 0 4 0 123456 104857600 2048 18446744073709551615 "
+        "1 1 0 0 0 0 0 0 0 0 0 0 17 2 0 0 0 0 0\n" );
+
+    snprintf( path, sizeof(path), "%s/%i/io", proc_dir,
+              SM_ERU_PROCESS_TEST_PID );
+    created &= sm_eru_process_test_write_file( path,
+        "rchar: 1000\nwchar: 2000\nsyscr: 10\nsyscw: 20\n"
+        "read_bytes: 4096\nwrite_bytes: 8192\ncancelled_write_bytes: 0\n" );
+
+    sm_eru_process_test_check( created, "fixture /proc" );
+
+    sm_node_stats_set_proc_dir( proc_dir );
+    sm_node_stats_initialize();
+
+    sm_eru_process_test_check( SM_OKAY == sm_node_stats_get_process_usage(
+                               SM_ERU_PROCESS_TEST_PID, &usage ),
+                               "process usage read" );
+
+    sm_eru_process_test_check(( SM_ERU_PROCESS_TEST_PID == usage.pid )&&
+                              ( 123456 == usage.start_time ),
+                              "pid and start time" );
+    sm_eru_process_test_check(( 250 * 1000 / user_hz == (long) usage.user_time_ms )&&
+                              ( 75 * 1000 / user_hz == (long) usage.system_time_ms ),
+                              "utime and stime from fields 14 and 15" );
+    sm_eru_process_test_check( 2048 * (page_size / 1024) == (long) usage.rss_kB,
+                               "rss from field 24" );
+    sm_eru_process_test_check(( 4096 == usage.read_bytes )&&
+                              ( 8192 == usage.write_bytes ),
+                              "storage io" );
+    sm_eru_process_test_check( 3 == usage.num_fds, "open files" );
+
+    sm_eru_process_test_check( SM_NOT_FOUND == sm_node_stats_get_process_usage(
+                               SM_ERU_PROCESS_TEST_PID + 1, &usage ),
+                               "process gone" );
+
+    sm_node_stats_finalize();
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Main
+// ====
+int main( int argc, char *argv[], char *envp[] )
+{
+    char command[sizeof(_directory)+16];
+
+    if( NULL == mkdtemp( _directory ) )
+    {
+        printf( "FAIL: scratch directory, error=%s\n", strerror(errno) );
+        return( EXIT_FAILURE );
+    }
+
+    printf( "services table\n" );
+    sm_eru_process_test_services();
+
+    printf( "sampling rate\n" );
+    sm_eru_process_test_rate();
+
+    sm_eru_services_finalize();
+
+    printf( "process usage\n" );
+    sm_eru_process_test_usage();
+
+    snprintf( command, sizeof(command), "rm -rf %s", _directory );
+    if( 0 != system( command ) )
+    {
+        printf( "Failed to remove %s.\n", _directory );
+    }
+
+    printf( "%u failed\n", _failures );
+
+    return( ( 0 == _failures ) ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+// ****************************************************************************
@@ -0,0 +1,399 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "sm_eru_services.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "sm_debug.h"
+
+#define SM_ERU_SERVICES_FILENAME                          "sm.eru.services"
+#define SM_ERU_SERVICES_DIRECTORY_MAX_LEN                              256
+#define SM_ERU_SERVICES_MAGIC                                    0x53455253
+#define SM_ERU_SERVICES_VERSION                                           1
+
+// An entry is being written while its sequence is odd.
+typedef struct
+{
+    uint32_t sequence;
+    int32_t pid;
+    char service_name[SM_SERVICE_NAME_MAX_CHAR];
+} SmEruServicesEntryT;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t max_services;
+    uint32_t transitions;
+    SmEruServicesEntryT entries[SM_ERU_SERVICES_MAX];
+} SmEruServicesTableT;
+
+typedef struct
+{
+    bool writer;
+    int fd;
+    SmEruServicesTableT* table;
+} SmEruServicesInfoT;
+
+static SmEruServicesInfoT _info = { false, -1, NULL };
+static char _directory[SM_ERU_SERVICES_DIRECTORY_MAX_LEN] = SM_RUN_DIRECTORY;
+
+// ****************************************************************************
+// Event Recorder Unit Services - Open
+// ===================================
+static SmErrorT sm_eru_services_open( void )
+{
+    char filename[SM_ERU_SERVICES_DIRECTORY_MAX_LEN+32];
+    int flags = O_RDONLY;
+    int prot = PROT_READ;
+    void* map;
+
+    if( NULL != _info.table )
+    {
+        return( SM_OKAY );
+    }
+
+    if( _info.writer )
+    {
+        flags = O_RDWR | O_CREAT;
+        prot |= PROT_WRITE;
+    }
+
+    snprintf( filename, sizeof(filename), "%s/%s", _directory,
+              SM_ERU_SERVICES_FILENAME );
+
+    _info.fd = open( filename, flags | O_CLOEXEC,
+                     S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH );
+    if( 0 > _info.fd )
+    {
+        if( _info.writer )
+        {
+            DPRINTFE( "Failed to open services table (%s), error=%s.",
+                      filename, strerror(errno) );
+        }
+        return( SM_FAILED );
+    }
+
+    if( _info.writer )
+    {
+        if( 0 > ftruncate( _info.fd, sizeof(SmEruServicesTableT) ) )
+        {
+            DPRINTFE( "Failed to size services table, error=%s.",
+                      strerror(errno) );
+            close( _info.fd );
+            _info.fd = -1;
+            return( SM_FAILED );
+        }
+    } else {
+        struct stat stat_info;
+
+        // Not yet sized by the writer.
+        if(( 0 > fstat( _info.fd, &stat_info ) )||
+           ( sizeof(SmEruServicesTableT) > (size_t) stat_info.st_size ))
+        {
+            close( _info.fd );
+            _info.fd = -1;
+            return( SM_FAILED );
+        }
+    }
+
+    map = mmap( NULL, sizeof(SmEruServicesTableT), prot, MAP_SHARED,
+                _info.fd, 0 );
+    if( MAP_FAILED == map )
+    {
+        DPRINTFE( "Failed to map services table, error=%s.", strerror(errno) );
+        close( _info.fd );
+        _info.fd = -1;
+        return( SM_FAILED );
+    }
+
+    _info.table = (SmEruServicesTableT*) map;
+
+    if( _info.writer )
+    {
+        // Cleared in place, a reader that has the table mapped skips it
+        // until the magic is set again.
+        __atomic_store_n( &(_info.table->magic), 0, __ATOMIC_RELEASE );
+        memset( &(_info.table->entries), 0, sizeof(_info.table->entries) );
+        _info.table->transitions = 0;
+        _info.table->version = SM_ERU_SERVICES_VERSION;
+        _info.table->max_services = SM_ERU_SERVICES_MAX;
+        __atomic_store_n( &(_info.table->magic), SM_ERU_SERVICES_MAGIC,
+                          __ATOMIC_RELEASE );
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Services - Table
+// ====================================
+// Returns the table once it is valid, the reader opens it on first use.
+static SmEruServicesTableT* sm_eru_services_table( void )
+{
+    if( SM_OKAY != sm_eru_services_open() )
+    {
+        return( NULL );
+    }
+
+    if(( SM_ERU_SERVICES_MAGIC != __atomic_load_n( &(_info.table->magic),
+                                                   __ATOMIC_ACQUIRE ) )||
+       ( SM_ERU_SERVICES_VERSION != _info.table->version )||
+       ( SM_ERU_SERVICES_MAX != _info.table->max_services ))
+    {
+        return( NULL );
+    }
+
+    return( _info.table );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Services - Set
+// ==================================
+SmErrorT sm_eru_services_set( const char service_name[], int pid )
+{
+    SmEruServicesTableT* table;
+    SmEruServicesEntryT* entry = NULL;
+    SmEruServicesEntryT* free_entry = NULL;
+
+    if( !_info.writer )
+    {
+        return( SM_FAILED );
+    }
+
+    table = sm_eru_services_table();
+    if( NULL == table )
+    {
+        return( SM_FAILED );
+    }
+
+    unsigned int entry_i;
+    for( entry_i=0; SM_ERU_SERVICES_MAX > entry_i; ++entry_i )
+    {
+        SmEruServicesEntryT* candidate = &(table->entries[entry_i]);
+
+        if( '\0' == candidate->service_name[0] )
+        {
+            if( NULL == free_entry )
+            {
+                free_entry = candidate;
+            }
+            continue;
+        }
+
+        if( 0 == strncmp( service_name, candidate->service_name,
+                          sizeof(candidate->service_name) ) )
+        {
+            entry = candidate;
+            break;
+        }
+    }
+
+    if( NULL == entry )
+    {
+        if( 0 >= pid )
+        {
+            return( SM_OKAY );
+        }
+
+        if( NULL == free_entry )
+        {
+            DPRINTFE( "Services table full, service (%s) not recorded.",
+                      service_name );
+            return( SM_FAILED );
+        }
+
+        entry = free_entry;
+    }
+
+    __atomic_add_fetch( &(entry->sequence), 1, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+
+    snprintf( entry->service_name, sizeof(entry->service_name), "%s",
+              service_name );
+    entry->pid = ( 0 < pid ) ? pid : 0;
+
+    __atomic_add_fetch( &(entry->sequence), 1, __ATOMIC_RELEASE );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Services - Set Transition
+// =============================================
+void sm_eru_services_set_transition( SmEruServicesTransitionT transition,
+    bool in_progress )
+{
+    SmEruServicesTableT* table;
+
+    if( !_info.writer )
+    {
+        return;
+    }
+
+    table = sm_eru_services_table();
+    if( NULL == table )
+    {
+        return;
+    }
+
+    if( in_progress )
+    {
+        __atomic_or_fetch( &(table->transitions), (uint32_t) transition,
+                           __ATOMIC_RELEASE );
+    } else {
+        __atomic_and_fetch( &(table->transitions), ~((uint32_t) transition),
+                            __ATOMIC_RELEASE );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Services - Get Transitions
+// ==============================================
+unsigned int sm_eru_services_get_transitions( void )
+{
+    SmEruServicesTableT* table = sm_eru_services_table();
+
+    if( NULL == table )
+    {
+        return( SM_ERU_SERVICES_TRANSITION_NONE );
+    }
+
+    return( __atomic_load_n( &(table->transitions), __ATOMIC_ACQUIRE ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Services - Get
+// ==================================
+SmErrorT sm_eru_services_get( SmEruServiceT services[],
+    unsigned int max_services, unsigned int* num_services )
+{
+    SmEruServicesTableT* table;
+
+    *num_services = 0;
+
+    table = sm_eru_services_table();
+    if( NULL == table )
+    {
+        return( SM_NOT_FOUND );
+    }
+
+    unsigned int entry_i;
+    for( entry_i=0; SM_ERU_SERVICES_MAX > entry_i; ++entry_i )
+    {
+        SmEruServicesEntryT* entry = &(table->entries[entry_i]);
+        SmEruServiceT* service;
+        uint32_t sequence;
+
+        if( max_services <= *num_services )
+        {
+            break;
+        }
+
+        sequence = __atomic_load_n( &(entry->sequence), __ATOMIC_ACQUIRE );
+        if( 0 != (sequence % 2) )
+        {
+            continue;
+        }
+
+        service = &(services[*num_services]);
+
+        service->pid = entry->pid;
+        memcpy( service->service_name, entry->service_name,
+                sizeof(service->service_name) );
+        service->service_name[sizeof(service->service_name)-1] = '\0';
+
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+
+        if( sequence != __atomic_load_n( &(entry->sequence), __ATOMIC_RELAXED ) )
+        {
+            continue;
+        }
+
+        if(( 0 < service->pid )&&( '\0' != service->service_name[0] ))
+        {
+            ++(*num_services);
+        }
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Services - Set Directory
+// ============================================
+void sm_eru_services_set_directory( const char directory[] )
+{
+    snprintf( _directory, sizeof(_directory), "%s", directory );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Services - Initialize
+// =========================================
+SmErrorT sm_eru_services_initialize( bool writer )
+{
+    _info.writer = writer;
+    _info.fd = -1;
+    _info.table = NULL;
+
+    if( writer )
+    {
+        return( sm_eru_services_open() );
+    }
+
+    // SM may not be running yet, the reader opens the table on first use.
+    sm_eru_services_open();
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Services - Finalize
+// =======================================
+SmErrorT sm_eru_services_finalize( void )
+{
+    if( NULL != _info.table )
+    {
+        // The pids go stale once SM is gone.
+        if( _info.writer )
+        {
+            __atomic_store_n( &(_info.table->magic), 0, __ATOMIC_RELEASE );
+        }
+
+        if( 0 > munmap( _info.table, sizeof(SmEruServicesTableT) ) )
+        {
+            DPRINTFE( "Failed to unmap services table, error=%s.",
+                      strerror(errno) );
+        }
+        _info.table = NULL;
+    }
+
+    if( 0 <= _info.fd )
+    {
+        close( _info.fd );
+        _info.fd = -1;
+    }
+
+    _info.writer = false;
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
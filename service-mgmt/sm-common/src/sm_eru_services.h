@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __SM_ERU_SERVICES_H__
+#define __SM_ERU_SERVICES_H__
+
+#include <stdbool.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SM_ERU_SERVICES_MAX                                            256
+
+typedef enum
+{
+    SM_ERU_SERVICES_TRANSITION_NONE     = 0x0,
+    SM_ERU_SERVICES_TRANSITION_SWACT    = 0x1,
+    SM_ERU_SERVICES_TRANSITION_FAILOVER = 0x2,
+} SmEruServicesTransitionT;
+
+typedef struct
+{
+    char service_name[SM_SERVICE_NAME_MAX_CHAR];
+    int pid;
+} SmEruServiceT;
+
+// ****************************************************************************
+// Event Recorder Unit Services - Set
+// ==================================
+// Publishes the pid of the service to the ERU, a pid of zero or less
+// clears it.  Only SM writes the table, from its main thread.
+extern SmErrorT sm_eru_services_set( const char service_name[], int pid );
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Services - Set Transition
+// =============================================
+extern void sm_eru_services_set_transition(
+    SmEruServicesTransitionT transition, bool in_progress );
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Services - Get Transitions
+// ==============================================
+// Returns the transitions in progress as a mask of SmEruServicesTransitionT.
+extern unsigned int sm_eru_services_get_transitions( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Services - Get
+// ==================================
+// Copies out the services that have a pid, entries being written are
+// skipped until the next call.
+extern SmErrorT sm_eru_services_get( SmEruServiceT services[],
+    unsigned int max_services, unsigned int* num_services );
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Services - Set Directory
+// ============================================
+// Keeps the table in another directory than SM_RUN_DIRECTORY, used by the
+// test.  Set before initialize.
+extern void sm_eru_services_set_directory( const char directory[] );
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Services - Initialize
+// =========================================
+// The writer creates and clears the table, a reader maps it once SM has
+// created it.
+extern SmErrorT sm_eru_services_initialize( bool writer );
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Services - Finalize
+// =======================================
+extern SmErrorT sm_eru_services_finalize( void );
+// ****************************************************************************
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SM_ERU_SERVICES_H__
@@ -0,0 +1,1805 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "sm_eru_ts.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+#include "sm_debug.h"
+
+#define SM_ERU_TS_FILENAME                       "/var/lib/sm/sm.eru.ts.v1"
+#define SM_ERU_TS_MAGIC                                          0x53455254
+#define SM_ERU_TS_BLOCK_MAGIC                                    0x53455242
+#define SM_ERU_TS_VERSION                                                 2
+#define SM_ERU_TS_VERSION_NO_TAILS                                        1
+#define SM_ERU_TS_HEADER_SIZE                                          4096
+#define SM_ERU_TS_INDEX_MAX                      (SM_ERU_TS_DATA_SIZE/1024)
+#define SM_ERU_TS_KEY_MAX                                               96
+#define SM_ERU_TS_COLUMN_MAX                                            16
+#define SM_ERU_TS_RANGE_MAX                                              4
+#define SM_ERU_TS_VARINT_MAX                                            10
+#define SM_ERU_TS_TAIL_READ_ATTEMPTS                                   100
+#define SM_ERU_TS_BASE_SIZE \
+    (SM_ERU_TS_HEADER_SIZE + sizeof(SmEruTsIndexEntryT) * SM_ERU_TS_INDEX_MAX \
+     + SM_ERU_TS_DATA_SIZE)
+#define SM_ERU_TS_BLOCK_DATA_MAX \
+    ((SM_ERU_TS_BLOCK_SAMPLES * (SM_ERU_TS_COLUMN_MAX + 1) \
+      * SM_ERU_TS_VARINT_MAX) + SM_ERU_TS_COLUMN_MAX)
+
+typedef enum
+{
+    SM_ERU_TS_ENCODING_DELTA,
+    SM_ERU_TS_ENCODING_XOR,
+} SmEruTsEncodingT;
+
+// Layout is the header, the index of blocks, the block data as a ring of
+// bytes and then the tails of the series.  The position counts every byte
+// handed out in the ring, it is advanced before a block is stored so
+// readers can tell when the block they copied was being overwritten.
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t index_max;
+    uint32_t index_entry_size;
+    uint64_t data_size;
+    uint64_t sequence;
+    uint64_t position;
+} SmEruTsHeaderT;
+
+// Whole when both sequence tags match, they hold the block sequence plus
+// one and are zero while the entry is overwritten.
+typedef struct
+{
+    uint64_t sequence;
+    uint64_t position;
+    uint32_t length;
+    uint16_t type;
+    uint16_t count;
+    int64_t t_first_ms;
+    int64_t t_last_ms;
+    uint32_t key_hash;
+    uint32_t reserved;
+    uint64_t sequence_end;
+} SmEruTsIndexEntryT;
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t type;
+    uint16_t count;
+    uint64_t sequence;
+    int64_t t_first_ms;
+    uint32_t length;
+    uint32_t checksum;
+    char key[SM_ERU_TS_KEY_MAX];
+} SmEruTsBlockHeaderT;
+
+typedef struct
+{
+    SmEruTsBlockHeaderT header;
+    uint8_t data[SM_ERU_TS_BLOCK_DATA_MAX];
+} SmEruTsBlockT;
+
+// Samples of a series not yet sealed, one tail per entry of the series
+// table.  Being written while the sequence is odd, the count is raised
+// once the sample is whole.  The block sequence is set while the samples
+// are sealed so a restart can tell whether the block made it.
+typedef struct
+{
+    uint32_t sequence;
+    uint16_t type;
+    uint16_t count;
+    uint32_t key_hash;
+    uint32_t reserved;
+    uint64_t block_sequence;
+    char key[SM_ERU_TS_KEY_MAX];
+    int64_t t_ms[SM_ERU_TS_BLOCK_SAMPLES];
+    uint64_t values[SM_ERU_TS_BLOCK_SAMPLES][SM_ERU_TS_COLUMN_MAX];
+} SmEruTsTailT;
+
+// Numeric fields of an entry type as runs of columns of the same size.
+typedef struct
+{
+    uint16_t offset;
+    uint8_t num_columns;
+    uint8_t column_size;
+} SmEruTsRangeT;
+
+typedef struct
+{
+    unsigned int num_ranges;
+    SmEruTsRangeT ranges[SM_ERU_TS_RANGE_MAX];
+} SmEruTsColumnsT;
+
+typedef struct
+{
+    bool inuse;
+    SmEruDatabaseEntryType type;
+    char key[SM_ERU_TS_KEY_MAX];
+    uint32_t key_hash;
+    unsigned int count;
+    unsigned long last_used;
+    int64_t t_ms[SM_ERU_TS_BLOCK_SAMPLES];
+    uint64_t values[SM_ERU_TS_BLOCK_SAMPLES][SM_ERU_TS_COLUMN_MAX];
+} SmEruTsSeriesT;
+
+typedef struct
+{
+    bool initialized;
+    bool read_only;
+    int fd;
+    size_t map_size;
+    void* map;
+    SmEruTsHeaderT* header;
+    SmEruTsIndexEntryT* index;
+    uint8_t* data;
+    SmEruTsTailT* tails;
+} SmEruTsFileInfoT;
+
+typedef struct
+{
+    SmEruDatabaseEntryT* entries;
+    unsigned int count;
+    unsigned int next;
+} SmEruTsQueryBlockT;
+
+static SmEruTsFileInfoT _file_info = { false, false, -1, 0, MAP_FAILED };
+static SmEruTsSeriesT _series[SM_ERU_TS_SERIES_MAX];
+static unsigned long _series_writes = 0;
+static SmEruTsBlockT _block;
+static uint8_t _column_scratch[2][SM_ERU_TS_BLOCK_SAMPLES*SM_ERU_TS_VARINT_MAX];
+static SmEruTsStatsT _stats;
+
+static const SmEruTsColumnsT _columns[SM_ERU_DATABASE_ENTRY_TYPE_MAX] =
+{
+    // SM_ERU_DATABASE_ENTRY_TYPE_CPU_STATS
+    { 1, { { offsetof(SmNodeCpuStatsT, user_cpu_usage), 16, 8 } } },
+    // SM_ERU_DATABASE_ENTRY_TYPE_MEM_STATS
+    { 1, { { offsetof(SmNodeMemStatsT, total_memory_kB), 15, 8 } } },
+    // SM_ERU_DATABASE_ENTRY_TYPE_DISK_STATS
+    { 2, { { offsetof(SmNodeDiskStatsT, major_num), 2, 4 },
+           { offsetof(SmNodeDiskStatsT, reads_completed), 11, 8 } } },
+    // SM_ERU_DATABASE_ENTRY_TYPE_NET_STATS
+    { 1, { { offsetof(SmNodeNetDevStatsT, rx_bytes), 16, 8 } } },
+    // SM_ERU_DATABASE_ENTRY_TYPE_TC_STATS
+    { 1, { { offsetof(SmHwQdiscInfoT, bytes), 7, 8 } } },
+    // SM_ERU_DATABASE_ENTRY_TYPE_IF_CHANGE
+    { 2, { { offsetof(SmHwInterfaceChangeDataT, type), 1, 4 },
+           { offsetof(SmHwInterfaceChangeDataT, interface_state), 1, 4 } } },
+    // SM_ERU_DATABASE_ENTRY_TYPE_IP_CHANGE
+    { 4, { { offsetof(SmHwIpChangeDataT, type), 1, 4 },
+           { offsetof(SmHwIpChangeDataT, address_type), 1, 4 },
+           { offsetof(SmHwIpChangeDataT, address),
+             sizeof(SmNetworkAddressT)/4, 4 },
+           { offsetof(SmHwIpChangeDataT, prefix_len), 1, 4 } } },
+    // SM_ERU_DATABASE_ENTRY_TYPE_SERVICE_STATS
+    { 3, { { offsetof(SmEruServiceStatsT, usage.pid), 1, 4 },
+           { offsetof(SmEruServiceStatsT, usage.start_time), 6, 8 },
+           { offsetof(SmEruServiceStatsT, usage.num_fds), 1, 4 } } },
+};
+
+static_assert( 8 == sizeof(unsigned long),
+               "columns of unsigned long are taken as 64 bit" );
+static_assert( 0 == (sizeof(SmNetworkAddressT) % 4),
+               "network address is not a whole number of columns" );
+static_assert( SM_ERU_TS_COLUMN_MAX >= 2 + sizeof(SmNetworkAddressT)/4 + 1 + 1,
+               "ip change does not fit the columns" );
+static_assert( offsetof(SmNodeProcessUsageT, write_bytes)
+               - offsetof(SmNodeProcessUsageT, start_time) == 5 * 8,
+               "process usage counters are not one run of columns" );
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Hash
+// ======================================
+static uint32_t sm_eru_ts_hash( const void* data, size_t len )
+{
+    const uint8_t* bytes = (const uint8_t*) data;
+    uint32_t hash = 2166136261U;
+
+    size_t byte_i;
+    for( byte_i=0; len > byte_i; ++byte_i )
+    {
+        hash ^= bytes[byte_i];
+        hash *= 16777619U;
+    }
+
+    return( hash );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Put Varint
+// ============================================
+static uint8_t* sm_eru_ts_put_varint( uint8_t* p, uint64_t value )
+{
+    while( 0x80 <= value )
+    {
+        *p++ = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (uint8_t) value;
+
+    return( p );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Get Varint
+// ============================================
+static const uint8_t* sm_eru_ts_get_varint( const uint8_t* p,
+    const uint8_t* end, uint64_t* value )
+{
+    unsigned int shift = 0;
+
+    *value = 0;
+
+    while(( end > p )&&( 64 > shift ))
+    {
+        uint8_t byte = *p++;
+
+        *value |= (uint64_t) (byte & 0x7F) << shift;
+        if( 0 == (byte & 0x80) )
+        {
+            return( p );
+        }
+
+        shift += 7;
+    }
+
+    return( NULL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Zigzag
+// ========================================
+static uint64_t sm_eru_ts_zigzag( int64_t value )
+{
+    return( ((uint64_t) value << 1) ^ (uint64_t) (value >> 63) );
+}
+
+static int64_t sm_eru_ts_unzigzag( uint64_t value )
+{
+    return( (int64_t) (value >> 1) ^ -(int64_t) (value & 1) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Entry Payload
+// ===============================================
+static uint8_t* sm_eru_ts_entry_payload( SmEruDatabaseEntryT* entry )
+{
+    return( (uint8_t*) &(entry->u) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Entry Key
+// ===========================================
+// The names of an entry identify its series and are kept in the block
+// header, the numeric fields are the columns.
+static void sm_eru_ts_entry_key( SmEruDatabaseEntryT* entry, char key[] )
+{
+    switch( entry->type )
+    {
+        case SM_ERU_DATABASE_ENTRY_TYPE_CPU_STATS:
+            snprintf( key, SM_ERU_TS_KEY_MAX, "%s",
+                      entry->u.cpu_stats.cpu_name );
+        break;
+
+        case SM_ERU_DATABASE_ENTRY_TYPE_DISK_STATS:
+            snprintf( key, SM_ERU_TS_KEY_MAX, "%s",
+                      entry->u.disk_stats.dev_name );
+        break;
+
+        case SM_ERU_DATABASE_ENTRY_TYPE_NET_STATS:
+            snprintf( key, SM_ERU_TS_KEY_MAX, "%s",
+                      entry->u.net_stats.dev_name );
+        break;
+
+        case SM_ERU_DATABASE_ENTRY_TYPE_TC_STATS:
+            snprintf( key, SM_ERU_TS_KEY_MAX, "%s %s %s",
+                      entry->u.tc_stats.interface_name,
+                      entry->u.tc_stats.queue_type,
+                      entry->u.tc_stats.handle );
+        break;
+
+        case SM_ERU_DATABASE_ENTRY_TYPE_IF_CHANGE:
+            snprintf( key, SM_ERU_TS_KEY_MAX, "%s",
+                      entry->u.if_change.interface_name );
+        break;
+
+        case SM_ERU_DATABASE_ENTRY_TYPE_IP_CHANGE:
+            snprintf( key, SM_ERU_TS_KEY_MAX, "%s",
+                      entry->u.ip_change.interface_name );
+        break;
+
+        case SM_ERU_DATABASE_ENTRY_TYPE_SERVICE_STATS:
+            snprintf( key, SM_ERU_TS_KEY_MAX, "%s",
+                      entry->u.service_stats.service_name );
+        break;
+
+        default:
+            key[0] = '\0';
+        break;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Entry Set Key
+// ===============================================
+static void sm_eru_ts_entry_set_key( SmEruDatabaseEntryT* entry,
+    const char key[] )
+{
+    char format[32];
+
+    switch( entry->type )
+    {
+        case SM_ERU_DATABASE_ENTRY_TYPE_CPU_STATS:
+            snprintf( entry->u.cpu_stats.cpu_name,
+                      sizeof(entry->u.cpu_stats.cpu_name), "%s", key );
+        break;
+
+        case SM_ERU_DATABASE_ENTRY_TYPE_DISK_STATS:
+            snprintf( entry->u.disk_stats.dev_name,
+                      sizeof(entry->u.disk_stats.dev_name), "%s", key );
+        break;
+
+        case SM_ERU_DATABASE_ENTRY_TYPE_NET_STATS:
+            snprintf( entry->u.net_stats.dev_name,
+                      sizeof(entry->u.net_stats.dev_name), "%s", key );
+        break;
+
+        case SM_ERU_DATABASE_ENTRY_TYPE_TC_STATS:
+            snprintf( format, sizeof(format), "%%%zus %%%zus %%%zus",
+                      sizeof(entry->u.tc_stats.interface_name) - 1,
+                      sizeof(entry->u.tc_stats.queue_type) - 1,
+                      sizeof(entry->u.tc_stats.handle) - 1 );
+            sscanf( key, format, entry->u.tc_stats.interface_name,
+                    entry->u.tc_stats.queue_type, entry->u.tc_stats.handle );
+        break;
+
+        case SM_ERU_DATABASE_ENTRY_TYPE_IF_CHANGE:
+            snprintf( entry->u.if_change.interface_name,
+                      sizeof(entry->u.if_change.interface_name), "%s", key );
+        break;
+
+        case SM_ERU_DATABASE_ENTRY_TYPE_IP_CHANGE:
+            snprintf( entry->u.ip_change.interface_name,
+                      sizeof(entry->u.ip_change.interface_name), "%s", key );
+        break;
+
+        case SM_ERU_DATABASE_ENTRY_TYPE_SERVICE_STATS:
+            snprintf( entry->u.service_stats.service_name,
+                      sizeof(entry->u.service_stats.service_name), "%s", key );
+        break;
+
+        default:
+        break;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Entry Columns
+// ===============================================
+static unsigned int sm_eru_ts_entry_columns( SmEruDatabaseEntryT* entry,
+    uint64_t values[] )
+{
+    const SmEruTsColumnsT* columns = &(_columns[entry->type]);
+    uint8_t* payload = sm_eru_ts_entry_payload( entry );
+    unsigned int num_columns = 0;
+
+    unsigned int range_i;
+    for( range_i=0; columns->num_ranges > range_i; ++range_i )
+    {
+        const SmEruTsRangeT* range = &(columns->ranges[range_i]);
+
+        unsigned int column_i;
+        for( column_i=0; range->num_columns > column_i; ++column_i )
+        {
+            uint8_t* field = payload + range->offset
+                           + column_i * range->column_size;
+
+            if( 4 == range->column_size )
+            {
+                uint32_t value;
+                memcpy( &value, field, sizeof(value) );
+                values[num_columns++] = value;
+            } else {
+                memcpy( &(values[num_columns++]), field, sizeof(uint64_t) );
+            }
+        }
+    }
+
+    return( num_columns );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Entry Set Columns
+// ===================================================
+static void sm_eru_ts_entry_set_columns( SmEruDatabaseEntryT* entry,
+    const uint64_t values[] )
+{
+    const SmEruTsColumnsT* columns = &(_columns[entry->type]);
+    uint8_t* payload = sm_eru_ts_entry_payload( entry );
+    unsigned int num_columns = 0;
+
+    unsigned int range_i;
+    for( range_i=0; columns->num_ranges > range_i; ++range_i )
+    {
+        const SmEruTsRangeT* range = &(columns->ranges[range_i]);
+
+        unsigned int column_i;
+        for( column_i=0; range->num_columns > column_i; ++column_i )
+        {
+            uint8_t* field = payload + range->offset
+                           + column_i * range->column_size;
+
+            if( 4 == range->column_size )
+            {
+                uint32_t value = (uint32_t) values[num_columns++];
+                memcpy( field, &value, sizeof(value) );
+            } else {
+                memcpy( field, &(values[num_columns++]), sizeof(uint64_t) );
+            }
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Number of Columns
+// ===================================================
+static unsigned int sm_eru_ts_num_columns( SmEruDatabaseEntryType type )
+{
+    const SmEruTsColumnsT* columns = &(_columns[type]);
+    unsigned int num_columns = 0;
+
+    unsigned int range_i;
+    for( range_i=0; columns->num_ranges > range_i; ++range_i )
+    {
+        num_columns += columns->ranges[range_i].num_columns;
+    }
+
+    return( num_columns );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Encode
+// ========================================
+// Timestamps go first as delta of deltas, then each column as either the
+// deltas or the xor of successive values, whichever is smaller.
+static uint32_t sm_eru_ts_encode( SmEruTsSeriesT* series, uint8_t* data )
+{
+    unsigned int num_columns = sm_eru_ts_num_columns( series->type );
+    int64_t prev_delta = 0;
+    uint8_t* p = data;
+
+    unsigned int sample_i;
+    for( sample_i=1; series->count > sample_i; ++sample_i )
+    {
+        int64_t delta = series->t_ms[sample_i] - series->t_ms[sample_i-1];
+
+        p = sm_eru_ts_put_varint( p, sm_eru_ts_zigzag( delta - prev_delta ) );
+        prev_delta = delta;
+    }
+
+    unsigned int column_i;
+    for( column_i=0; num_columns > column_i; ++column_i )
+    {
+        uint8_t* delta_p = _column_scratch[SM_ERU_TS_ENCODING_DELTA];
+        uint8_t* xor_p = _column_scratch[SM_ERU_TS_ENCODING_XOR];
+        uint64_t prev = 0;
+        size_t delta_len, xor_len;
+
+        for( sample_i=0; series->count > sample_i; ++sample_i )
+        {
+            uint64_t value = series->values[sample_i][column_i];
+
+            delta_p = sm_eru_ts_put_varint( delta_p,
+                                    sm_eru_ts_zigzag( (int64_t) (value - prev) ) );
+            xor_p = sm_eru_ts_put_varint( xor_p, value ^ prev );
+            prev = value;
+        }
+
+        delta_len = delta_p - _column_scratch[SM_ERU_TS_ENCODING_DELTA];
+        xor_len = xor_p - _column_scratch[SM_ERU_TS_ENCODING_XOR];
+
+        if( xor_len < delta_len )
+        {
+            *p++ = SM_ERU_TS_ENCODING_XOR;
+            memcpy( p, _column_scratch[SM_ERU_TS_ENCODING_XOR], xor_len );
+            p += xor_len;
+        } else {
+            *p++ = SM_ERU_TS_ENCODING_DELTA;
+            memcpy( p, _column_scratch[SM_ERU_TS_ENCODING_DELTA], delta_len );
+            p += delta_len;
+        }
+    }
+
+    return( (uint32_t) (p - data) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Decode
+// ========================================
+static SmErrorT sm_eru_ts_decode( const SmEruTsBlockT* block,
+    SmEruDatabaseEntryT entries[] )
+{
+    const SmEruTsBlockHeaderT* header = &(block->header);
+    const uint8_t* p = block->data;
+    const uint8_t* end = block->data + header->length;
+    SmEruDatabaseEntryType type = (SmEruDatabaseEntryType) header->type;
+    unsigned int num_columns = sm_eru_ts_num_columns( type );
+    uint64_t values[SM_ERU_TS_BLOCK_SAMPLES][SM_ERU_TS_COLUMN_MAX];
+    int64_t t_ms = header->t_first_ms;
+    int64_t delta = 0;
+    uint64_t value;
+
+    unsigned int sample_i;
+    for( sample_i=0; header->count > sample_i; ++sample_i )
+    {
+        SmEruDatabaseEntryT* entry = &(entries[sample_i]);
+
+        if( 0 < sample_i )
+        {
+            p = sm_eru_ts_get_varint( p, end, &value );
+            if( NULL == p )
+            {
+                return( SM_FAILED );
+            }
+
+            delta += sm_eru_ts_unzigzag( value );
+            t_ms += delta;
+        }
+
+        memset( entry, 0, sizeof(SmEruDatabaseEntryT) );
+        entry->type = type;
+        entry->ts_real.tv_sec = t_ms / 1000;
+        entry->ts_real.tv_nsec = (t_ms % 1000) * 1000000;
+    }
+
+    unsigned int column_i;
+    for( column_i=0; num_columns > column_i; ++column_i )
+    {
+        uint8_t encoding;
+        uint64_t prev = 0;
+
+        if( end <= p )
+        {
+            return( SM_FAILED );
+        }
+
+        encoding = *p++;
+
+        for( sample_i=0; header->count > sample_i; ++sample_i )
+        {
+            p = sm_eru_ts_get_varint( p, end, &value );
+            if( NULL == p )
+            {
+                return( SM_FAILED );
+            }
+
+            if( SM_ERU_TS_ENCODING_XOR == encoding )
+            {
+                prev ^= value;
+            } else {
+                prev += (uint64_t) sm_eru_ts_unzigzag( value );
+            }
+
+            values[sample_i][column_i] = prev;
+        }
+    }
+
+    for( sample_i=0; header->count > sample_i; ++sample_i )
+    {
+        sm_eru_ts_entry_set_key( &(entries[sample_i]), header->key );
+        sm_eru_ts_entry_set_columns( &(entries[sample_i]), values[sample_i] );
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Sync Range
+// ============================================
+static void sm_eru_ts_sync_range( void* addr, size_t len, int flags )
+{
+    static long page_size = 0;
+    uintptr_t start;
+    uintptr_t end;
+
+    if( 0 == page_size )
+    {
+        page_size = sysconf( _SC_PAGESIZE );
+    }
+
+    start = (uintptr_t) addr & ~((uintptr_t) page_size - 1);
+    end = (uintptr_t) addr + len;
+
+    if( 0 > msync( (void*) start, end - start, flags ) )
+    {
+        DPRINTFE( "Failed to sync time series, error=%s.", strerror(errno) );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Series Tail
+// =============================================
+static SmEruTsTailT* sm_eru_ts_series_tail( SmEruTsSeriesT* series )
+{
+    if( NULL == _file_info.tails )
+    {
+        return( NULL );
+    }
+
+    return( &(_file_info.tails[series - _series]) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Tail Begin
+// ============================================
+static void sm_eru_ts_tail_begin( SmEruTsTailT* tail )
+{
+    __atomic_add_fetch( &(tail->sequence), 1, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Tail End
+// ==========================================
+static void sm_eru_ts_tail_end( SmEruTsTailT* tail )
+{
+    __atomic_add_fetch( &(tail->sequence), 1, __ATOMIC_RELEASE );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Tail Append
+// =============================================
+// Copies the last sample of the series to its tail.  The map is shared, so
+// the sample outlives the process without a sync.
+static void sm_eru_ts_tail_append( SmEruTsSeriesT* series )
+{
+    SmEruTsTailT* tail = sm_eru_ts_series_tail( series );
+    unsigned int sample_i = series->count - 1;
+
+    if( NULL == tail )
+    {
+        return;
+    }
+
+    sm_eru_ts_tail_begin( tail );
+
+    if( 0 == sample_i )
+    {
+        tail->type = series->type;
+        tail->key_hash = series->key_hash;
+        tail->block_sequence = 0;
+        memcpy( tail->key, series->key, sizeof(tail->key) );
+    }
+
+    tail->t_ms[sample_i] = series->t_ms[sample_i];
+    memcpy( tail->values[sample_i], series->values[sample_i],
+            sizeof(tail->values[sample_i]) );
+    tail->count = series->count;
+
+    sm_eru_ts_tail_end( tail );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Seal
+// ======================================
+// Encodes the samples of the series as a block, stores the block in the
+// data ring and then its index entry.
+static void sm_eru_ts_seal( SmEruTsSeriesT* series )
+{
+    SmEruTsHeaderT* header = _file_info.header;
+    SmEruTsBlockHeaderT* block_header = &(_block.header);
+    SmEruTsTailT* tail = sm_eru_ts_series_tail( series );
+    SmEruTsIndexEntryT* index_entry;
+    uint64_t sequence;
+    uint64_t position;
+    uint64_t offset;
+    uint32_t length;
+
+    if(( 0 == series->count )||( NULL == header ))
+    {
+        series->count = 0;
+        return;
+    }
+
+    memset( block_header, 0, sizeof(SmEruTsBlockHeaderT) );
+    block_header->magic = SM_ERU_TS_BLOCK_MAGIC;
+    block_header->type = series->type;
+    block_header->count = series->count;
+    block_header->t_first_ms = series->t_ms[0];
+    block_header->length = sm_eru_ts_encode( series, _block.data );
+    block_header->checksum = sm_eru_ts_hash( _block.data,
+                                             block_header->length );
+    memcpy( block_header->key, series->key, sizeof(block_header->key) );
+
+    length = sizeof(SmEruTsBlockHeaderT) + block_header->length;
+
+    sequence = header->sequence;
+    block_header->sequence = sequence + 1;
+
+    if( NULL != tail )
+    {
+        sm_eru_ts_tail_begin( tail );
+        tail->block_sequence = sequence + 1;
+        sm_eru_ts_tail_end( tail );
+    }
+
+    // Blocks never wrap around the end of the data ring.
+    position = header->position;
+    offset = position % SM_ERU_TS_DATA_SIZE;
+    if( SM_ERU_TS_DATA_SIZE < offset + length )
+    {
+        position += SM_ERU_TS_DATA_SIZE - offset;
+        offset = 0;
+    }
+
+    __atomic_store_n( &(header->position), position + length,
+                      __ATOMIC_RELEASE );
+
+    index_entry = &(_file_info.index[sequence % SM_ERU_TS_INDEX_MAX]);
+
+    __atomic_store_n( &(index_entry->sequence), 0, __ATOMIC_RELAXED );
+    __atomic_store_n( &(index_entry->sequence_end), 0, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+
+    memcpy( _file_info.data + offset, &_block, length );
+
+    index_entry->position = position;
+    index_entry->length = length;
+    index_entry->type = series->type;
+    index_entry->count = series->count;
+    index_entry->t_first_ms = series->t_ms[0];
+    index_entry->t_last_ms = series->t_ms[series->count-1];
+    index_entry->key_hash = series->key_hash;
+
+    __atomic_store_n( &(index_entry->sequence_end), sequence + 1,
+                      __ATOMIC_RELEASE );
+    __atomic_store_n( &(index_entry->sequence), sequence + 1,
+                      __ATOMIC_RELEASE );
+    __atomic_store_n( &(header->sequence), sequence + 1, __ATOMIC_RELEASE );
+
+    if( NULL != tail )
+    {
+        sm_eru_ts_tail_begin( tail );
+        tail->count = 0;
+        tail->block_sequence = 0;
+        sm_eru_ts_tail_end( tail );
+    }
+
+    sm_eru_ts_sync_range( _file_info.data + offset, length, MS_ASYNC );
+    sm_eru_ts_sync_range( index_entry, sizeof(SmEruTsIndexEntryT), MS_ASYNC );
+    sm_eru_ts_sync_range( header, sizeof(SmEruTsHeaderT), MS_ASYNC );
+
+    ++(_stats.blocks);
+    _stats.bytes += length + sizeof(SmEruTsIndexEntryT);
+
+    DPRINTFD( "Sealed block %" PRIu64 " of %s, samples=%u, length=%u.",
+              sequence, series->key, series->count, length );
+
+    series->count = 0;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Find Series
+// =============================================
+static SmEruTsSeriesT* sm_eru_ts_find_series( SmEruDatabaseEntryType type,
+    const char key[], uint32_t key_hash )
+{
+    SmEruTsSeriesT* oldest = NULL;
+    SmEruTsSeriesT* series;
+
+    unsigned int series_i;
+    for( series_i=0; SM_ERU_TS_SERIES_MAX > series_i; ++series_i )
+    {
+        series = &(_series[series_i]);
+
+        if(( series->inuse )&&( type == series->type )&&
+           ( key_hash == series->key_hash )&&
+           ( 0 == strcmp( key, series->key ) ))
+        {
+            return( series );
+        }
+
+        if(( NULL == oldest )||
+           (( oldest->inuse )&&
+            (( !series->inuse )||( series->last_used < oldest->last_used ))))
+        {
+            oldest = series;
+        }
+    }
+
+    series = oldest;
+
+    if( series->inuse )
+    {
+        DPRINTFD( "Series table full, sealing %s.", series->key );
+        sm_eru_ts_seal( series );
+    }
+
+    memset( series, 0, sizeof(SmEruTsSeriesT) );
+    series->inuse = true;
+    series->type = type;
+    snprintf( series->key, sizeof(series->key), "%s", key );
+    series->key_hash = key_hash;
+
+    return( series );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Write
+// =======================================
+SmErrorT sm_eru_ts_write( SmEruDatabaseEntryT* entry )
+{
+    char key[SM_ERU_TS_KEY_MAX];
+    SmEruTsSeriesT* series;
+    int64_t t_ms;
+
+    if(( !_file_info.initialized )||( _file_info.read_only ))
+    {
+        DPRINTFE( "Time series is not initialized for write." );
+        return( SM_FAILED );
+    }
+
+    if(( 0 > entry->type )||( SM_ERU_DATABASE_ENTRY_TYPE_MAX <= entry->type ))
+    {
+        DPRINTFE( "Unknown entry type (%i).", entry->type );
+        return( SM_FAILED );
+    }
+
+    if(( 0 == entry->ts_real.tv_sec )&&( 0 == entry->ts_real.tv_nsec ))
+    {
+        clock_gettime( CLOCK_REALTIME, &(entry->ts_real) );
+    }
+
+    t_ms = (int64_t) entry->ts_real.tv_sec * 1000
+         + entry->ts_real.tv_nsec / 1000000;
+
+    sm_eru_ts_entry_key( entry, key );
+
+    series = sm_eru_ts_find_series( entry->type, key,
+                                    sm_eru_ts_hash( key, strlen(key) ) );
+
+    if(( 0 < series->count )&&
+       (( t_ms < series->t_ms[series->count-1] )||
+        ( SM_ERU_TS_BLOCK_SPAN_IN_MS <= t_ms - series->t_ms[0] )))
+    {
+        sm_eru_ts_seal( series );
+    }
+
+    series->t_ms[series->count] = t_ms;
+    sm_eru_ts_entry_columns( entry, series->values[series->count] );
+    ++(series->count);
+    series->last_used = ++_series_writes;
+
+    ++(_stats.samples);
+
+    if( SM_ERU_TS_BLOCK_SAMPLES <= series->count )
+    {
+        sm_eru_ts_seal( series );
+    } else {
+        sm_eru_ts_tail_append( series );
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Read Block
+// ============================================
+// Copies the block out of the map and checks it was not overwritten
+// while it was copied.
+static bool sm_eru_ts_read_block( const SmEruTsIndexEntryT* index_entry,
+    SmEruTsBlockT* block )
+{
+    uint64_t offset = index_entry->position % SM_ERU_TS_DATA_SIZE;
+
+    if(( sizeof(SmEruTsBlockHeaderT) > index_entry->length )||
+       ( sizeof(SmEruTsBlockT) < index_entry->length )||
+       ( SM_ERU_TS_DATA_SIZE < offset + index_entry->length ))
+    {
+        return( false );
+    }
+
+    memcpy( block, _file_info.data + offset, index_entry->length );
+    __atomic_thread_fence( __ATOMIC_ACQUIRE );
+
+    if( SM_ERU_TS_DATA_SIZE < __atomic_load_n( &(_file_info.header->position),
+                                               __ATOMIC_RELAXED )
+                              - index_entry->position )
+    {
+        return( false );
+    }
+
+    return(( SM_ERU_TS_BLOCK_MAGIC == block->header.magic )&&
+           ( index_entry->sequence == block->header.sequence )&&
+           ( index_entry->length == sizeof(SmEruTsBlockHeaderT)
+                                    + block->header.length )&&
+           ( index_entry->count == block->header.count )&&
+           ( SM_ERU_TS_BLOCK_SAMPLES >= block->header.count )&&
+           ( SM_ERU_DATABASE_ENTRY_TYPE_MAX > block->header.type )&&
+           ( '\0' == block->header.key[SM_ERU_TS_KEY_MAX-1] )&&
+           ( block->header.checksum == sm_eru_ts_hash( block->data,
+                                                block->header.length ) ));
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Read Index Entry
+// ==================================================
+static bool sm_eru_ts_read_index_entry( uint32_t index_i,
+    SmEruTsIndexEntryT* index_entry )
+{
+    SmEruTsIndexEntryT* entry = &(_file_info.index[index_i]);
+    uint64_t sequence;
+
+    sequence = __atomic_load_n( &(entry->sequence), __ATOMIC_ACQUIRE );
+    memcpy( index_entry, entry, sizeof(SmEruTsIndexEntryT) );
+    __atomic_thread_fence( __ATOMIC_ACQUIRE );
+
+    return(( 0 != sequence )&&
+           ( sequence == __atomic_load_n( &(entry->sequence_end),
+                                          __ATOMIC_RELAXED ) )&&
+           ( sequence == index_entry->sequence )&&
+           ( index_i == (sequence - 1) % SM_ERU_TS_INDEX_MAX ));
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Read Tail
+// ===========================================
+// Copies the samples of a tail, false when it has none or the writer kept
+// changing it.
+static bool sm_eru_ts_read_tail( unsigned int tail_i, SmEruTsTailT* copy )
+{
+    SmEruTsTailT* tail = &(_file_info.tails[tail_i]);
+
+    unsigned int attempt_i;
+    for( attempt_i=0; SM_ERU_TS_TAIL_READ_ATTEMPTS > attempt_i; ++attempt_i )
+    {
+        uint32_t sequence;
+        unsigned int count;
+
+        sequence = __atomic_load_n( &(tail->sequence), __ATOMIC_ACQUIRE );
+        if( 0 != (sequence % 2) )
+        {
+            continue;
+        }
+
+        memcpy( copy, tail, offsetof(SmEruTsTailT, t_ms) );
+
+        count = copy->count;
+        if( SM_ERU_TS_BLOCK_SAMPLES < count )
+        {
+            count = 0;
+        }
+
+        memcpy( copy->t_ms, tail->t_ms, sizeof(int64_t) * count );
+        memcpy( copy->values, tail->values, sizeof(copy->values[0]) * count );
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+
+        if( sequence == __atomic_load_n( &(tail->sequence), __ATOMIC_RELAXED ) )
+        {
+            return(( 0 < copy->count )&&
+                   ( SM_ERU_TS_BLOCK_SAMPLES >= copy->count )&&
+                   ( SM_ERU_DATABASE_ENTRY_TYPE_MAX > copy->type )&&
+                   ( '\0' == copy->key[SM_ERU_TS_KEY_MAX-1] ));
+        }
+    }
+
+    return( false );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Tail Entries
+// ==============================================
+// Fills in the entries of the samples of a tail within the window and
+// returns how many there are.
+static unsigned int sm_eru_ts_tail_entries( const SmEruTsTailT* tail,
+    int64_t start_ms, int64_t end_ms, SmEruDatabaseEntryT entries[] )
+{
+    unsigned int num_entries = 0;
+
+    unsigned int sample_i;
+    for( sample_i=0; tail->count > sample_i; ++sample_i )
+    {
+        SmEruDatabaseEntryT* entry = &(entries[num_entries]);
+        int64_t t_ms = tail->t_ms[sample_i];
+
+        if(( start_ms > t_ms )||( end_ms < t_ms ))
+        {
+            continue;
+        }
+
+        memset( entry, 0, sizeof(SmEruDatabaseEntryT) );
+        entry->type = (SmEruDatabaseEntryType) tail->type;
+        entry->ts_real.tv_sec = t_ms / 1000;
+        entry->ts_real.tv_nsec = (t_ms % 1000) * 1000000;
+        sm_eru_ts_entry_set_key( entry, tail->key );
+        sm_eru_ts_entry_set_columns( entry, tail->values[sample_i] );
+        ++num_entries;
+    }
+
+    return( num_entries );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Query Match
+// =============================================
+static bool sm_eru_ts_query_match( uint32_t index_i,
+    const bool types[SM_ERU_DATABASE_ENTRY_TYPE_MAX], int64_t start_ms,
+    int64_t end_ms, SmEruTsIndexEntryT* match )
+{
+    return(( sm_eru_ts_read_index_entry( index_i, match ) )&&
+           ( SM_ERU_DATABASE_ENTRY_TYPE_MAX > match->type )&&
+           ( types[match->type] )&&
+           ( match->t_last_ms >= start_ms )&&( match->t_first_ms <= end_ms ));
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Query Sealed
+// ==============================================
+// True when the samples of the tail were sealed into one of the matches
+// while they were copied, the block starts at the first sample.
+static bool sm_eru_ts_query_sealed( const SmEruTsTailT* tail,
+    const SmEruTsIndexEntryT matches[], unsigned int num_matches )
+{
+    unsigned int low = 0;
+    unsigned int high = num_matches;
+
+    while( low < high )
+    {
+        unsigned int middle = low + (high - low) / 2;
+
+        if( matches[middle].t_first_ms < tail->t_ms[0] )
+        {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    while(( num_matches > low )&&( matches[low].t_first_ms == tail->t_ms[0] ))
+    {
+        if(( tail->type == matches[low].type )&&
+           ( tail->key_hash == matches[low].key_hash ))
+        {
+            return( true );
+        }
+        ++low;
+    }
+
+    return( false );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Query Compare
+// ===============================================
+static int sm_eru_ts_query_compare( const void* lhs, const void* rhs )
+{
+    const SmEruTsIndexEntryT* a = (const SmEruTsIndexEntryT*) lhs;
+    const SmEruTsIndexEntryT* b = (const SmEruTsIndexEntryT*) rhs;
+
+    if( a->t_first_ms != b->t_first_ms )
+    {
+        return(( a->t_first_ms < b->t_first_ms ) ? -1 : 1 );
+    }
+
+    return(( a->sequence < b->sequence ) ? -1 : 1 );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Query
+// =======================================
+// The matching blocks are merged in time order, a block is decoded once
+// the output reaches its first sample so only overlapping blocks are held.
+// The tails are copied after the index, so the blocks sealed since the
+// index was read are looked up again and the tails they hold dropped.
+SmErrorT sm_eru_ts_query( const bool types[SM_ERU_DATABASE_ENTRY_TYPE_MAX],
+    time_t start_time, time_t end_time, SmEruTsQueryCallbackT callback,
+    void* user_data )
+{
+    int64_t start_ms = (0 == start_time) ? INT64_MIN
+                     : (int64_t) start_time * 1000;
+    int64_t end_ms = (0 == end_time) ? INT64_MAX
+                   : (int64_t) end_time * 1000 + 999;
+    SmEruTsIndexEntryT* matches = NULL;
+    SmEruTsQueryBlockT* active = NULL;
+    SmEruTsTailT* tails = NULL;
+    unsigned int num_matches = 0;
+    unsigned int num_active = 0;
+    unsigned int num_tails = 0;
+    unsigned int next_match = 0;
+    uint64_t sequence_start, sequence_end;
+    SmErrorT error = SM_OKAY;
+
+    if( !_file_info.initialized )
+    {
+        DPRINTFE( "Time series is not initialized." );
+        return( SM_FAILED );
+    }
+
+    matches = (SmEruTsIndexEntryT*) malloc( sizeof(SmEruTsIndexEntryT)
+                                            * SM_ERU_TS_INDEX_MAX );
+    active = (SmEruTsQueryBlockT*) malloc( sizeof(SmEruTsQueryBlockT)
+                            * (SM_ERU_TS_INDEX_MAX + SM_ERU_TS_SERIES_MAX) );
+    tails = (SmEruTsTailT*) malloc( sizeof(SmEruTsTailT)
+                                    * SM_ERU_TS_SERIES_MAX );
+    if(( NULL == matches )||( NULL == active )||( NULL == tails ))
+    {
+        DPRINTFE( "Failed to allocate query." );
+        free( matches );
+        free( active );
+        free( tails );
+        return( SM_FAILED );
+    }
+
+    sequence_start = __atomic_load_n( &(_file_info.header->sequence),
+                                      __ATOMIC_ACQUIRE );
+
+    uint32_t index_i;
+    for( index_i=0; SM_ERU_TS_INDEX_MAX > index_i; ++index_i )
+    {
+        if( sm_eru_ts_query_match( index_i, types, start_ms, end_ms,
+                                   &(matches[num_matches]) ) )
+        {
+            ++num_matches;
+        }
+    }
+
+    if( NULL != _file_info.tails )
+    {
+        unsigned int tail_i;
+        for( tail_i=0; SM_ERU_TS_SERIES_MAX > tail_i; ++tail_i )
+        {
+            if(( sm_eru_ts_read_tail( tail_i, &(tails[num_tails]) ) )&&
+               ( types[tails[num_tails].type] ))
+            {
+                ++num_tails;
+            }
+        }
+    }
+
+    sequence_end = __atomic_load_n( &(_file_info.header->sequence),
+                                    __ATOMIC_ACQUIRE );
+    if( SM_ERU_TS_INDEX_MAX < sequence_end - sequence_start )
+    {
+        sequence_start = sequence_end - SM_ERU_TS_INDEX_MAX;
+    }
+
+    uint64_t sequence;
+    for( sequence=sequence_start+1; sequence_end >= sequence; ++sequence )
+    {
+        SmEruTsIndexEntryT* match = &(matches[num_matches]);
+        bool found = false;
+
+        if(( SM_ERU_TS_INDEX_MAX <= num_matches )||
+           ( !sm_eru_ts_query_match( (sequence - 1) % SM_ERU_TS_INDEX_MAX,
+                                     types, start_ms, end_ms, match ) )||
+           ( sequence != match->sequence ))
+        {
+            continue;
+        }
+
+        unsigned int match_i;
+        for( match_i=0; num_matches > match_i; ++match_i )
+        {
+            if( sequence == matches[match_i].sequence )
+            {
+                found = true;
+                break;
+            }
+        }
+
+        if( !found )
+        {
+            ++num_matches;
+        }
+    }
+
+    qsort( matches, num_matches, sizeof(SmEruTsIndexEntryT),
+           sm_eru_ts_query_compare );
+
+    unsigned int tail_i;
+    for( tail_i=0; num_tails > tail_i; ++tail_i )
+    {
+        SmEruTsQueryBlockT* query_block = &(active[num_active]);
+        SmEruTsTailT* tail = &(tails[tail_i]);
+
+        if( sm_eru_ts_query_sealed( tail, matches, num_matches ) )
+        {
+            continue;
+        }
+
+        query_block->entries = (SmEruDatabaseEntryT*)
+            malloc( sizeof(SmEruDatabaseEntryT) * tail->count );
+        if( NULL == query_block->entries )
+        {
+            DPRINTFE( "Failed to allocate query block." );
+            error = SM_FAILED;
+            break;
+        }
+
+        query_block->count = sm_eru_ts_tail_entries( tail, start_ms, end_ms,
+                                                     query_block->entries );
+        if( 0 == query_block->count )
+        {
+            free( query_block->entries );
+            continue;
+        }
+
+        query_block->next = 0;
+        ++num_active;
+    }
+
+    while( SM_OKAY == error )
+    {
+        SmEruTsQueryBlockT* earliest = NULL;
+        int64_t earliest_ms = INT64_MAX;
+
+        unsigned int active_i;
+        for( active_i=0; num_active > active_i; ++active_i )
+        {
+            SmEruTsQueryBlockT* query_block = &(active[active_i]);
+            SmEruDatabaseEntryT* entry
+                = &(query_block->entries[query_block->next]);
+            int64_t t_ms = (int64_t) entry->ts_real.tv_sec * 1000
+                         + entry->ts_real.tv_nsec / 1000000;
+
+            if( t_ms < earliest_ms )
+            {
+                earliest = query_block;
+                earliest_ms = t_ms;
+            }
+        }
+
+        if(( num_matches > next_match )&&
+           ( matches[next_match].t_first_ms <= earliest_ms ))
+        {
+            SmEruTsQueryBlockT* query_block = &(active[num_active]);
+            SmEruTsIndexEntryT* match = &(matches[next_match++]);
+            unsigned int keep = 0;
+
+            if( !sm_eru_ts_read_block( match, &_block ) )
+            {
+                DPRINTFD( "Block %" PRIu64 " overwritten or torn, skipped.",
+                          match->sequence );
+                continue;
+            }
+
+            query_block->entries = (SmEruDatabaseEntryT*)
+                malloc( sizeof(SmEruDatabaseEntryT) * _block.header.count );
+            if( NULL == query_block->entries )
+            {
+                DPRINTFE( "Failed to allocate query block." );
+                error = SM_FAILED;
+                break;
+            }
+
+            if( SM_OKAY != sm_eru_ts_decode( &_block, query_block->entries ) )
+            {
+                DPRINTFE( "Failed to decode block %" PRIu64 ".",
+                          match->sequence );
+                free( query_block->entries );
+                continue;
+            }
+
+            unsigned int sample_i;
+            for( sample_i=0; _block.header.count > sample_i; ++sample_i )
+            {
+                SmEruDatabaseEntryT* entry = &(query_block->entries[sample_i]);
+                int64_t t_ms = (int64_t) entry->ts_real.tv_sec * 1000
+                             + entry->ts_real.tv_nsec / 1000000;
+
+                if(( start_ms <= t_ms )&&( end_ms >= t_ms ))
+                {
+                    memmove( &(query_block->entries[keep++]), entry,
+                             sizeof(SmEruDatabaseEntryT) );
+                }
+            }
+
+            if( 0 == keep )
+            {
+                free( query_block->entries );
+                continue;
+            }
+
+            query_block->count = keep;
+            query_block->next = 0;
+            ++num_active;
+            continue;
+        }
+
+        if( NULL == earliest )
+        {
+            break;
+        }
+
+        if( !callback( &(earliest->entries[earliest->next]), user_data ) )
+        {
+            break;
+        }
+
+        if( earliest->count <= ++(earliest->next) )
+        {
+            free( earliest->entries );
+            *earliest = active[--num_active];
+        }
+    }
+
+    unsigned int active_i;
+    for( active_i=0; num_active > active_i; ++active_i )
+    {
+        free( active[active_i].entries );
+    }
+
+    free( tails );
+    free( active );
+    free( matches );
+
+    return( error );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Get Statistics
+// ================================================
+void sm_eru_ts_get_stats( SmEruTsStatsT* stats )
+{
+    memcpy( stats, &_stats, sizeof(SmEruTsStatsT) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Map
+// =====================================
+static SmErrorT sm_eru_ts_map( void )
+{
+    int prot = PROT_READ;
+
+    if( !_file_info.read_only )
+    {
+        prot |= PROT_WRITE;
+    }
+
+    _file_info.map = mmap( NULL, _file_info.map_size, prot, MAP_SHARED,
+                           _file_info.fd, 0 );
+    if( MAP_FAILED == _file_info.map )
+    {
+        DPRINTFE( "Failed to map time series, error=%s.", strerror(errno) );
+        return( SM_FAILED );
+    }
+
+    _file_info.header = (SmEruTsHeaderT*) _file_info.map;
+    _file_info.index = (SmEruTsIndexEntryT*)
+        ((uint8_t*) _file_info.map + SM_ERU_TS_HEADER_SIZE);
+    _file_info.data = (uint8_t*) (_file_info.index + SM_ERU_TS_INDEX_MAX);
+    _file_info.tails = NULL;
+
+    if( SM_ERU_TS_BASE_SIZE < _file_info.map_size )
+    {
+        _file_info.tails = (SmEruTsTailT*)
+            (_file_info.data + SM_ERU_TS_DATA_SIZE);
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Header Valid
+// ==============================================
+static bool sm_eru_ts_header_valid( uint32_t version )
+{
+    SmEruTsHeaderT* header = _file_info.header;
+
+    return(( SM_ERU_TS_MAGIC == header->magic )&&
+           ( version == header->version )&&
+           ( SM_ERU_TS_INDEX_MAX == header->index_max )&&
+           ( sizeof(SmEruTsIndexEntryT) == header->index_entry_size )&&
+           ( SM_ERU_TS_DATA_SIZE == header->data_size ));
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Format
+// ========================================
+static SmErrorT sm_eru_ts_format( void )
+{
+    int result;
+
+    DPRINTFI( "Initializing time series." );
+
+    if(( 0 > ftruncate( _file_info.fd, 0 ) )||
+       ( 0 > ftruncate( _file_info.fd, _file_info.map_size ) ))
+    {
+        DPRINTFE( "Failed to size time series, error=%s.", strerror(errno) );
+        return( SM_FAILED );
+    }
+
+    result = posix_fallocate( _file_info.fd, 0, _file_info.map_size );
+    if( 0 != result )
+    {
+        DPRINTFE( "Failed to allocate time series, error=%s.",
+                  strerror(result) );
+        return( SM_FAILED );
+    }
+
+    if( SM_OKAY != sm_eru_ts_map() )
+    {
+        return( SM_FAILED );
+    }
+
+    _file_info.header->version = SM_ERU_TS_VERSION;
+    _file_info.header->index_max = SM_ERU_TS_INDEX_MAX;
+    _file_info.header->index_entry_size = sizeof(SmEruTsIndexEntryT);
+    _file_info.header->data_size = SM_ERU_TS_DATA_SIZE;
+    _file_info.header->sequence = 0;
+    _file_info.header->position = 0;
+    __atomic_store_n( &(_file_info.header->magic), SM_ERU_TS_MAGIC,
+                      __ATOMIC_RELEASE );
+
+    sm_eru_ts_sync_range( _file_info.header, sizeof(SmEruTsHeaderT),
+                          MS_SYNC );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Upgrade
+// =========================================
+// Grows a store of version 1 by the tails, keeping its blocks.
+static SmErrorT sm_eru_ts_upgrade( void )
+{
+    int result;
+
+    if( 0 > ftruncate( _file_info.fd, _file_info.map_size ) )
+    {
+        DPRINTFE( "Failed to size time series, error=%s.", strerror(errno) );
+        return( SM_FAILED );
+    }
+
+    result = posix_fallocate( _file_info.fd, SM_ERU_TS_BASE_SIZE,
+                              _file_info.map_size - SM_ERU_TS_BASE_SIZE );
+    if( 0 != result )
+    {
+        DPRINTFE( "Failed to allocate time series, error=%s.",
+                  strerror(result) );
+        return( SM_FAILED );
+    }
+
+    if( SM_OKAY != sm_eru_ts_map() )
+    {
+        return( SM_FAILED );
+    }
+
+    if( !sm_eru_ts_header_valid( SM_ERU_TS_VERSION_NO_TAILS ) )
+    {
+        munmap( _file_info.map, _file_info.map_size );
+        _file_info.map = MAP_FAILED;
+        _file_info.header = NULL;
+        return( SM_OKAY );
+    }
+
+    DPRINTFI( "Upgrading time series to version %i.", SM_ERU_TS_VERSION );
+
+    _file_info.header->version = SM_ERU_TS_VERSION;
+
+    sm_eru_ts_sync_range( _file_info.header, sizeof(SmEruTsHeaderT),
+                          MS_SYNC );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Recover
+// =========================================
+// Picks up whole blocks stored after the last header update that made it
+// to disk.
+static void sm_eru_ts_recover( void )
+{
+    SmEruTsHeaderT* header = _file_info.header;
+    SmEruTsIndexEntryT index_entry;
+    uint64_t recovered = 0;
+
+    while( SM_ERU_TS_INDEX_MAX > recovered )
+    {
+        uint32_t index_i = header->sequence % SM_ERU_TS_INDEX_MAX;
+
+        if(( !sm_eru_ts_read_index_entry( index_i, &index_entry ) )||
+           ( header->sequence + 1 != index_entry.sequence ))
+        {
+            break;
+        }
+
+        if( header->position < index_entry.position + index_entry.length )
+        {
+            header->position = index_entry.position + index_entry.length;
+        }
+
+        if( !sm_eru_ts_read_block( &index_entry, &_block ) )
+        {
+            break;
+        }
+
+        ++(header->sequence);
+        ++recovered;
+    }
+
+    if( 0 < recovered )
+    {
+        DPRINTFI( "Recovered %" PRIu64 " time series blocks past the header.",
+                  recovered );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Recover Tails
+// ===============================================
+// Reloads the samples the last writer left in the tails, unless their
+// block made it into the index before it stopped.
+static void sm_eru_ts_recover_tails( void )
+{
+    SmEruTsIndexEntryT index_entry;
+    unsigned int recovered = 0;
+
+    if( NULL == _file_info.tails )
+    {
+        return;
+    }
+
+    unsigned int series_i;
+    for( series_i=0; SM_ERU_TS_SERIES_MAX > series_i; ++series_i )
+    {
+        SmEruTsTailT* tail = &(_file_info.tails[series_i]);
+        SmEruTsSeriesT* series = &(_series[series_i]);
+
+        // Left odd by a writer that stopped part way through an update.
+        tail->sequence += tail->sequence % 2;
+
+        if( 0 == tail->count )
+        {
+            continue;
+        }
+
+        if(( SM_ERU_TS_BLOCK_SAMPLES < tail->count )||
+           ( SM_ERU_DATABASE_ENTRY_TYPE_MAX <= tail->type )||
+           ( '\0' != tail->key[SM_ERU_TS_KEY_MAX-1] ))
+        {
+            DPRINTFE( "Time series tail %u is not valid, dropped.", series_i );
+            tail->count = 0;
+            tail->block_sequence = 0;
+            continue;
+        }
+
+        if(( 0 != tail->block_sequence )&&
+           ( sm_eru_ts_read_index_entry( (tail->block_sequence - 1)
+                                         % SM_ERU_TS_INDEX_MAX,
+                                         &index_entry ) )&&
+           ( tail->block_sequence == index_entry.sequence ))
+        {
+            tail->count = 0;
+            tail->block_sequence = 0;
+            continue;
+        }
+
+        tail->block_sequence = 0;
+
+        series->inuse = true;
+        series->type = (SmEruDatabaseEntryType) tail->type;
+        memcpy( series->key, tail->key, sizeof(series->key) );
+        series->key_hash = tail->key_hash;
+        series->count = tail->count;
+        series->last_used = ++_series_writes;
+        memcpy( series->t_ms, tail->t_ms, sizeof(int64_t) * tail->count );
+        memcpy( series->values, tail->values,
+                sizeof(series->values[0]) * tail->count );
+
+        recovered += tail->count;
+    }
+
+    if( 0 < recovered )
+    {
+        DPRINTFI( "Recovered %u time series samples not yet sealed.",
+                  recovered );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Initialize
+// ============================================
+SmErrorT sm_eru_ts_initialize( char filename[], bool read_only )
+{
+    char ts_filename[512] = "";
+    struct stat stat_info;
+    int flags = O_RDONLY;
+
+    _file_info.initialized = false;
+    _file_info.read_only = read_only;
+    _file_info.fd = -1;
+    _file_info.map = MAP_FAILED;
+    _file_info.header = NULL;
+    _file_info.tails = NULL;
+    _file_info.map_size = SM_ERU_TS_BASE_SIZE
+                        + sizeof(SmEruTsTailT) * SM_ERU_TS_SERIES_MAX;
+
+    memset( _series, 0, sizeof(_series) );
+    memset( &_stats, 0, sizeof(_stats) );
+
+    if( NULL == filename )
+    {
+        snprintf( ts_filename, sizeof(ts_filename), "%s", SM_ERU_TS_FILENAME );
+    } else {
+        snprintf( ts_filename, sizeof(ts_filename), "%s", filename );
+    }
+
+    if( !read_only )
+    {
+        flags = O_RDWR | O_CREAT;
+    }
+
+    _file_info.fd = open( ts_filename, flags | O_CLOEXEC,
+                          S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH );
+    if( 0 > _file_info.fd )
+    {
+        DPRINTFE( "Failed to open time series file (%s), error=%s.",
+                  ts_filename, strerror( errno ) );
+        return( SM_FAILED );
+    }
+
+    if( 0 > fstat( _file_info.fd, &stat_info ) )
+    {
+        DPRINTFE( "Failed to get time series file stats, error=%s.",
+                  strerror(errno) );
+        sm_eru_ts_finalize();
+        return( SM_FAILED );
+    }
+
+    if( (size_t) stat_info.st_size == _file_info.map_size )
+    {
+        if( SM_OKAY != sm_eru_ts_map() )
+        {
+            sm_eru_ts_finalize();
+            return( SM_FAILED );
+        }
+
+        if( !sm_eru_ts_header_valid( SM_ERU_TS_VERSION ) )
+        {
+            munmap( _file_info.map, _file_info.map_size );
+            _file_info.map = MAP_FAILED;
+            _file_info.header = NULL;
+        }
+    } else if( SM_ERU_TS_BASE_SIZE == (size_t) stat_info.st_size ) {
+        if( read_only )
+        {
+            _file_info.map_size = SM_ERU_TS_BASE_SIZE;
+
+            if( SM_OKAY != sm_eru_ts_map() )
+            {
+                sm_eru_ts_finalize();
+                return( SM_FAILED );
+            }
+
+            if( !sm_eru_ts_header_valid( SM_ERU_TS_VERSION_NO_TAILS ) )
+            {
+                munmap( _file_info.map, _file_info.map_size );
+                _file_info.map = MAP_FAILED;
+                _file_info.header = NULL;
+            }
+        } else if( SM_OKAY != sm_eru_ts_upgrade() ) {
+            sm_eru_ts_finalize();
+            return( SM_FAILED );
+        }
+    }
+
+    if( MAP_FAILED == _file_info.map )
+    {
+        if( read_only )
+        {
+            DPRINTFE( "Time series file (%s) is not formatted correctly.",
+                      ts_filename );
+            sm_eru_ts_finalize();
+            return( SM_FAILED );
+        }
+
+        if( SM_OKAY != sm_eru_ts_format() )
+        {
+            sm_eru_ts_finalize();
+            return( SM_FAILED );
+        }
+    }
+
+    if( !read_only )
+    {
+        sm_eru_ts_recover();
+        sm_eru_ts_recover_tails();
+    }
+
+    _file_info.initialized = true;
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Finalize
+// ==========================================
+SmErrorT sm_eru_ts_finalize( void )
+{
+    if(( _file_info.initialized )&&( !_file_info.read_only ))
+    {
+        unsigned int series_i;
+        for( series_i=0; SM_ERU_TS_SERIES_MAX > series_i; ++series_i )
+        {
+            if( _series[series_i].inuse )
+            {
+                sm_eru_ts_seal( &(_series[series_i]) );
+            }
+        }
+
+        sm_eru_ts_sync_range( _file_info.map, _file_info.map_size, MS_SYNC );
+    }
+
+    _file_info.initialized = false;
+
+    if( MAP_FAILED != _file_info.map )
+    {
+        munmap( _file_info.map, _file_info.map_size );
+        _file_info.map = MAP_FAILED;
+        _file_info.header = NULL;
+    }
+
+    if( 0 <= _file_info.fd )
+    {
+        close( _file_info.fd );
+        _file_info.fd = -1;
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
@@ -0,0 +1,88 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __SM_ERU_TS_H__
+#define __SM_ERU_TS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "sm_types.h"
+#include "sm_eru_db.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SM_ERU_TS_SERIES_MAX                                           128
+#define SM_ERU_TS_BLOCK_SAMPLES                                         64
+#define SM_ERU_TS_BLOCK_SPAN_IN_MS                                 1800000
+
+// The store is only resized for tests, a file of another size is
+// reformatted when opened for write.
+#ifndef SM_ERU_TS_DATA_SIZE
+#define SM_ERU_TS_DATA_SIZE                                      268435456
+#endif
+
+typedef struct
+{
+    uint64_t samples;       // Samples written.
+    uint64_t blocks;        // Blocks sealed.
+    uint64_t bytes;         // Block and index bytes used by the blocks.
+} SmEruTsStatsT;
+
+// Called for each sample of a query in time order, return false to stop.
+typedef bool (*SmEruTsQueryCallbackT) (SmEruDatabaseEntryT* entry,
+    void* user_data);
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Write
+// =======================================
+// Adds the sample to the block of its series, the block is written to the
+// store once it holds SM_ERU_TS_BLOCK_SAMPLES samples or spans
+// SM_ERU_TS_BLOCK_SPAN_IN_MS.  Until then the sample is kept in the tail
+// of its series in the store, so a query or a restart after a crash sees
+// it.  A zero ts_real is filled in on write.
+extern SmErrorT sm_eru_ts_write( SmEruDatabaseEntryT* entry );
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Query
+// =======================================
+// Decodes only the blocks of the given types that overlap the window,
+// followed by the samples not yet sealed.  A zero start or end leaves that
+// side open.
+extern SmErrorT sm_eru_ts_query( const bool types[SM_ERU_DATABASE_ENTRY_TYPE_MAX],
+    time_t start_time, time_t end_time, SmEruTsQueryCallbackT callback,
+    void* user_data );
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Get Statistics
+// ================================================
+extern void sm_eru_ts_get_stats( SmEruTsStatsT* stats );
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Initialize
+// ============================================
+// A writer reloads the samples left in the tails by the last writer and
+// grows a store of version 1, which has no tails, in place.
+extern SmErrorT sm_eru_ts_initialize( char filename[], bool read_only );
+// ****************************************************************************
+
+// ****************************************************************************
+// Event Recorder Unit Time Series - Finalize
+// ==========================================
+// Writes out the blocks still being filled.
+extern SmErrorT sm_eru_ts_finalize( void );
+// ****************************************************************************
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SM_ERU_TS_H__
@@ -0,0 +1,599 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Checks that the samples of the ERU ring come back from the time series
+// store as they went in, exits non-zero when a check fails.  Built with a
+// small ring and store, records are stamped by a synthetic clock twenty
+// times a second.  The wrapped ring is encoded oldest first, then queried
+// whole, by window and by type, once after a clean finalize and once
+// after a writer that exits with its samples left in the tails.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <arpa/inet.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_eru_db.h"
+#include "sm_eru_ts.h"
+
+#define SM_ERU_TS_TEST_START_TIME                               1700000000
+#define SM_ERU_TS_TEST_STEP_IN_MS                                       50
+#define SM_ERU_TS_TEST_GAP_IN_MS                                   1860000
+
+typedef struct
+{
+    SmEruDatabaseEntryT* entries;
+    unsigned int count;
+    unsigned int max;
+} SmEruTsTestResultT;
+
+extern "C" int __real_clock_gettime( clockid_t clock_id, struct timespec* tp );
+
+static bool _synthetic_clock = false;
+static int64_t _clock_ms = 0;
+static char _ring_filename[] = "/tmp/sm_eru_ts_test.ring.XXXXXX";
+static char _ts_filename[] = "/tmp/sm_eru_ts_test.ts.XXXXXX";
+static SmEruDatabaseEntryT* _ring = NULL;
+static unsigned int _ring_count = 0;
+static SmEruTsTestResultT _result;
+static unsigned int _failures = 0;
+
+// ****************************************************************************
+// ERU Time Series Test - Check
+// ============================
+static void sm_eru_ts_test_check( bool passed, const char name[] )
+{
+    printf( "%s: %s\n", passed ? "PASS" : "FAIL", name );
+
+    if( !passed )
+    {
+        ++_failures;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Time Series Test - Clock
+// ============================
+// Stamps the records written to the ring with the synthetic clock.
+extern "C" int __wrap_clock_gettime( clockid_t clock_id, struct timespec* tp )
+{
+    if(( _synthetic_clock )&&( CLOCK_REALTIME == clock_id ))
+    {
+        tp->tv_sec = (time_t) (_clock_ms / 1000);
+        tp->tv_nsec = (long) (_clock_ms % 1000) * 1000000;
+        _clock_ms += SM_ERU_TS_TEST_STEP_IN_MS;
+        return( 0 );
+    }
+
+    return( __real_clock_gettime( clock_id, tp ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Time Series Test - Entry
+// ============================
+// Every type of entry over a few series each.  Counters grow by uneven
+// steps, gauges go up and down and some columns only change in their low
+// bits, so both column encodings are used.
+static void sm_eru_ts_test_entry( unsigned int record_i,
+    SmEruDatabaseEntryT* entry )
+{
+    uint64_t step = (record_i * 2654435761U) % 4096;
+    unsigned int series_i = record_i / 10;
+
+    memset( entry, 0, sizeof(SmEruDatabaseEntryT) );
+
+    switch( record_i % 10 )
+    {
+        case 0: case 1: case 2: case 3:
+        {
+            SmNodeCpuStatsT* cpu = &(entry->u.cpu_stats);
+
+            entry->type = SM_ERU_DATABASE_ENTRY_TYPE_CPU_STATS;
+            snprintf( cpu->cpu_name, sizeof(cpu->cpu_name), "cpu%u",
+                      record_i % 10 );
+            cpu->user_cpu_usage = record_i * 3ULL + step;
+            cpu->nice_cpu_usage = record_i / 7;
+            cpu->system_cpu_usage = record_i * 2ULL;
+            cpu->idle_task_cpu_usage = 22625563ULL + record_i * 11ULL;
+            cpu->iowait_cpu_usage = step;
+            cpu->steal_cpu_usage = UINT64_MAX - record_i;
+            cpu->total_interrupts = 114930548ULL + record_i * 97ULL;
+            cpu->total_context_switches = 1990473ULL + record_i * step;
+            cpu->processes_running = record_i % 5;
+            cpu->boot_time_in_secs = 1062191376ULL;
+        }
+        break;
+
+        case 4:
+        {
+            SmNodeMemStatsT* mem = &(entry->u.mem_stats);
+
+            entry->type = SM_ERU_DATABASE_ENTRY_TYPE_MEM_STATS;
+            mem->total_memory_kB = 16303084UL;
+            mem->free_memory_kB = 8110124UL + step * 64 - record_i % 1000;
+            mem->cached_kB = 3751268UL ^ (record_i & 0xff);
+            mem->hugepages_total = 1024;
+            mem->hugepage_size_kB = 2048;
+            mem->commited_memory_kB = 9153012UL + series_i;
+        }
+        break;
+
+        case 5:
+        {
+            SmNodeDiskStatsT* disk = &(entry->u.disk_stats);
+
+            entry->type = SM_ERU_DATABASE_ENTRY_TYPE_DISK_STATS;
+            disk->major_num = 8;
+            disk->minor_num = (series_i % 3) * 16;
+            snprintf( disk->dev_name, sizeof(disk->dev_name), "sd%c",
+                      'a' + (series_i % 3) );
+            disk->reads_completed = 180293UL + record_i;
+            disk->sectors_read = 3377298UL + record_i * step;
+            disk->writes_completed = 1226428UL + record_i / 3;
+            disk->io_inprogress = step % 3;
+            disk->weighted_ms_spent_io = 2567262UL + record_i * 5UL;
+        }
+        break;
+
+        case 6:
+        {
+            SmNodeNetDevStatsT* net = &(entry->u.net_stats);
+
+            entry->type = SM_ERU_DATABASE_ENTRY_TYPE_NET_STATS;
+            snprintf( net->dev_name, sizeof(net->dev_name), "eth%u",
+                      series_i % 2 );
+            net->rx_bytes = 169294721ULL + record_i * 1500ULL + step;
+            net->rx_packets = 15598ULL + record_i;
+            net->tx_bytes = (1ULL << 40) + record_i * 64ULL;
+            net->tx_packets = 15598ULL + record_i / 2;
+            net->rx_dropped = step / 1024;
+        }
+        break;
+
+        case 7:
+        {
+            SmHwQdiscInfoT* qdisc = &(entry->u.tc_stats);
+
+            entry->type = SM_ERU_DATABASE_ENTRY_TYPE_TC_STATS;
+            snprintf( qdisc->interface_name, sizeof(qdisc->interface_name),
+                      "eth%u", series_i % 2 );
+            snprintf( qdisc->queue_type, sizeof(qdisc->queue_type), "%s",
+                      ( 0 == series_i % 2 ) ? "htb" : "pfifo_fast" );
+            snprintf( qdisc->handle, sizeof(qdisc->handle), "%s",
+                      ( 0 == series_i % 2 ) ? "1:10" : "0:" );
+            qdisc->bytes = 987654321ULL + record_i * 1000ULL;
+            qdisc->packets = 654321ULL + record_i;
+            qdisc->backlog = step;
+            qdisc->overlimits = record_i / 100;
+        }
+        break;
+
+        case 8:
+        {
+            SmEruServiceStatsT* service = &(entry->u.service_stats);
+            static const char* services[] =
+                { "sm-api", "drbd-platform", "management-ip" };
+
+            entry->type = SM_ERU_DATABASE_ENTRY_TYPE_SERVICE_STATS;
+            snprintf( service->service_name, sizeof(service->service_name),
+                      "%s", services[series_i % 3] );
+            service->usage.pid = 4000 + (int) (series_i % 3)
+                               + (int) (record_i / 5000);
+            service->usage.start_time = 123456ULL + record_i / 5000;
+            service->usage.user_time_ms = record_i * 2ULL;
+            service->usage.system_time_ms = record_i / 2;
+            service->usage.rss_kB = 40960ULL + step;
+            service->usage.read_bytes = 0;
+            service->usage.write_bytes = record_i * 4096ULL;
+            service->usage.num_fds = 12 + (unsigned int) (step % 4);
+        }
+        break;
+
+        default:
+            if( 0 == series_i % 2 )
+            {
+                SmHwInterfaceChangeDataT* if_change = &(entry->u.if_change);
+
+                entry->type = SM_ERU_DATABASE_ENTRY_TYPE_IF_CHANGE;
+                if_change->type = SM_HW_INTERFACE_CHANGE_TYPE_ADD;
+                snprintf( if_change->interface_name,
+                          sizeof(if_change->interface_name), "enp0s%u",
+                          3 + (series_i / 2) % 2 );
+                if_change->interface_state = ( 0 == step % 2 )
+                                           ? SM_INTERFACE_STATE_ENABLED
+                                           : SM_INTERFACE_STATE_DISABLED;
+            } else {
+                SmHwIpChangeDataT* ip_change = &(entry->u.ip_change);
+                char address[64];
+
+                entry->type = SM_ERU_DATABASE_ENTRY_TYPE_IP_CHANGE;
+                ip_change->type = ( 0 == step % 2 )
+                                ? SM_HW_IP_CHANGE_TYPE_ADD
+                                : SM_HW_IP_CHANGE_TYPE_DELETE;
+                snprintf( ip_change->interface_name,
+                          sizeof(ip_change->interface_name), "vlan%u",
+                          100 + (series_i / 2) % 2 );
+                ip_change->address_type = SM_HW_ADDRESS_TYPE_ADDRESS;
+                ip_change->address.type = SM_NETWORK_TYPE_IPV6;
+                snprintf( address, sizeof(address), "fd00::%x",
+                          (unsigned int) (record_i & 0xffff) );
+                inet_pton( AF_INET6, address,
+                           &(ip_change->address.u.ipv6.sin6) );
+                ip_change->prefix_len = 64;
+            }
+        break;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Time Series Test - Fill Ring
+// ================================
+// Wraps the ring, with a gap longer than a block span in the middle, then
+// reads it back oldest first.
+static bool sm_eru_ts_test_fill_ring( unsigned int num_records )
+{
+    SmEruDatabaseEntryT entry;
+    int total_records, record_i;
+
+    unlink( _ring_filename );
+
+    if( SM_OKAY != sm_eru_db_initialize( _ring_filename, false ) )
+    {
+        return( false );
+    }
+
+    _clock_ms = (int64_t) SM_ERU_TS_TEST_START_TIME * 1000;
+    _synthetic_clock = true;
+
+    unsigned int write_i;
+    for( write_i=0; num_records > write_i; ++write_i )
+    {
+        if( num_records - SM_ERU_DB_MAX_RECORDS / 2 == write_i )
+        {
+            _clock_ms += SM_ERU_TS_TEST_GAP_IN_MS;
+        }
+
+        sm_eru_ts_test_entry( write_i, &entry );
+        sm_eru_db_write( &entry );
+    }
+
+    _synthetic_clock = false;
+
+    sm_eru_db_finalize();
+
+    if( SM_OKAY != sm_eru_db_initialize( _ring_filename, true ) )
+    {
+        return( false );
+    }
+
+    total_records = sm_eru_db_total();
+    record_i = 0;
+    if( SM_ERU_DB_MAX_RECORDS == total_records )
+    {
+        record_i = sm_eru_db_get_write_index();
+    }
+
+    _ring_count = 0;
+
+    int record_count;
+    for( record_count=0; total_records > record_count; ++record_count )
+    {
+        if( SM_OKAY == sm_eru_db_read( record_i, &(_ring[_ring_count]) ) )
+        {
+            ++_ring_count;
+        }
+
+        if( SM_ERU_DB_MAX_RECORDS <= ++record_i )
+        {
+            record_i = 0;
+        }
+    }
+
+    sm_eru_db_finalize();
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Time Series Test - Encode
+// =============================
+// Writes the samples of the ring to a new store, the store is left
+// unsealed when finalize is false.
+static bool sm_eru_ts_test_encode( bool finalize, SmEruTsStatsT* stats )
+{
+    unlink( _ts_filename );
+
+    if( SM_OKAY != sm_eru_ts_initialize( _ts_filename, false ) )
+    {
+        return( false );
+    }
+
+    unsigned int ring_i;
+    for( ring_i=0; _ring_count > ring_i; ++ring_i )
+    {
+        SmEruDatabaseEntryT entry = _ring[ring_i];
+
+        if( SM_OKAY != sm_eru_ts_write( &entry ) )
+        {
+            return( false );
+        }
+    }
+
+    if( finalize )
+    {
+        sm_eru_ts_finalize();
+        sm_eru_ts_get_stats( stats );
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Time Series Test - Collect
+// ==============================
+static bool sm_eru_ts_test_collect( SmEruDatabaseEntryT* entry,
+    void* user_data )
+{
+    SmEruTsTestResultT* result = (SmEruTsTestResultT*) user_data;
+
+    if( result->max <= result->count )
+    {
+        return( false );
+    }
+
+    result->entries[result->count++] = *entry;
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Time Series Test - Query
+// ===========================
+// Queries the store and compares the samples with those of the ring in
+// the window and of the types given.  Only the ring index does not come
+// back from the store.
+static void sm_eru_ts_test_query( const char name[],
+    const bool types[SM_ERU_DATABASE_ENTRY_TYPE_MAX], time_t start_time,
+    time_t end_time )
+{
+    SmEruDatabaseEntryT expected;
+    unsigned int result_i = 0;
+    bool passed = true;
+    char check_name[128];
+
+    _result.count = 0;
+
+    if( SM_OKAY != sm_eru_ts_query( types, start_time, end_time,
+                                    sm_eru_ts_test_collect, &_result ) )
+    {
+        snprintf( check_name, sizeof(check_name), "%s, query", name );
+        sm_eru_ts_test_check( false, check_name );
+        return;
+    }
+
+    unsigned int ring_i;
+    for( ring_i=0; _ring_count > ring_i; ++ring_i )
+    {
+        expected = _ring[ring_i];
+
+        if(( !types[expected.type] )||
+           (( 0 != start_time )&&( start_time > expected.ts_real.tv_sec ))||
+           (( 0 != end_time )&&( end_time < expected.ts_real.tv_sec )))
+        {
+            continue;
+        }
+
+        expected.index = 0;
+
+        if(( _result.count <= result_i )||
+           ( 0 != memcmp( &expected, &(_result.entries[result_i]),
+                          sizeof(expected) ) ))
+        {
+            printf( "  sample %u of %u differs, expected\n", result_i,
+                    _result.count );
+            sm_eru_db_print( stdout, &expected, true );
+            if( _result.count > result_i )
+            {
+                printf( "  got\n" );
+                sm_eru_db_print( stdout, &(_result.entries[result_i]),
+                                 true );
+            }
+            passed = false;
+            break;
+        }
+
+        ++result_i;
+    }
+
+    if(( passed )&&( _result.count != result_i ))
+    {
+        printf( "  %u samples read, expected %u\n", _result.count,
+                result_i );
+        passed = false;
+    }
+
+    snprintf( check_name, sizeof(check_name), "%s (%u samples)", name,
+              result_i );
+    sm_eru_ts_test_check( passed, check_name );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Time Series Test - Queries
+// ==============================
+static void sm_eru_ts_test_queries( const char name[] )
+{
+    bool all_types[SM_ERU_DATABASE_ENTRY_TYPE_MAX];
+    bool some_types[SM_ERU_DATABASE_ENTRY_TYPE_MAX];
+    time_t start_time = _ring[_ring_count / 4].ts_real.tv_sec;
+    time_t end_time = _ring[_ring_count - _ring_count / 4].ts_real.tv_sec;
+    char check_name[128];
+
+    if( SM_OKAY != sm_eru_ts_initialize( _ts_filename, true ) )
+    {
+        snprintf( check_name, sizeof(check_name), "%s, open", name );
+        sm_eru_ts_test_check( false, check_name );
+        return;
+    }
+
+    memset( all_types, 1, sizeof(all_types) );
+    memset( some_types, 0, sizeof(some_types) );
+    some_types[SM_ERU_DATABASE_ENTRY_TYPE_DISK_STATS] = true;
+    some_types[SM_ERU_DATABASE_ENTRY_TYPE_IP_CHANGE] = true;
+    some_types[SM_ERU_DATABASE_ENTRY_TYPE_SERVICE_STATS] = true;
+
+    snprintf( check_name, sizeof(check_name), "%s, all", name );
+    sm_eru_ts_test_query( check_name, all_types, 0, 0 );
+
+    snprintf( check_name, sizeof(check_name), "%s, window across the gap",
+              name );
+    sm_eru_ts_test_query( check_name, all_types, start_time, end_time );
+
+    snprintf( check_name, sizeof(check_name), "%s, start only", name );
+    sm_eru_ts_test_query( check_name, all_types, end_time, 0 );
+
+    snprintf( check_name, sizeof(check_name), "%s, some types in window",
+              name );
+    sm_eru_ts_test_query( check_name, some_types, start_time, end_time );
+
+    sm_eru_ts_finalize();
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Time Series Test - Report
+// =============================
+// Space the samples take in each store, as a ring record is the entry
+// between its two generation tags.
+static void sm_eru_ts_test_report( SmEruTsStatsT* stats )
+{
+    double record_size = sizeof(SmEruDatabaseEntryT) + 2*sizeof(uint64_t);
+    double ring_bytes = stats->samples * record_size;
+    double ts_bytes = (double) stats->bytes;
+
+    printf( "samples             : %" PRIu64 " in %" PRIu64 " blocks\n",
+            stats->samples, stats->blocks );
+    printf( "ring-bytes          : %.0f (%.1f per sample)\n", ring_bytes,
+            record_size );
+    printf( "timeseries-bytes    : %.0f (%.1f per sample)\n", ts_bytes,
+            ( 0 < stats->samples ) ? ts_bytes / stats->samples : 0.0 );
+
+    sm_eru_ts_test_check(( _ring_count == stats->samples )&&
+                         ( 0 < ts_bytes )&&( ts_bytes < ring_bytes ),
+                         "time series smaller than the ring" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// ERU Time Series Test - Main
+// ===========================
+int main( int argc, char *argv[], char *envp[] )
+{
+    unsigned int wrapped = 2 * SM_ERU_DB_MAX_RECORDS + 1000;
+    SmEruTsStatsT stats;
+    pid_t pid;
+    int status;
+    int fd;
+
+    setenv( "TZ", "", 1 );
+    tzset();
+
+    fd = mkstemp( _ring_filename );
+    if( 0 > fd )
+    {
+        printf( "FAIL: scratch ring, error=%s\n", strerror(errno) );
+        return( EXIT_FAILURE );
+    }
+    close( fd );
+
+    fd = mkstemp( _ts_filename );
+    if( 0 > fd )
+    {
+        printf( "FAIL: scratch time series, error=%s\n", strerror(errno) );
+        unlink( _ring_filename );
+        return( EXIT_FAILURE );
+    }
+    close( fd );
+
+    _ring = (SmEruDatabaseEntryT*) malloc( sizeof(SmEruDatabaseEntryT)
+                                           * SM_ERU_DB_MAX_RECORDS );
+    _result.entries = (SmEruDatabaseEntryT*) malloc(
+        sizeof(SmEruDatabaseEntryT) * (SM_ERU_DB_MAX_RECORDS + 1) );
+    _result.max = SM_ERU_DB_MAX_RECORDS + 1;
+    if(( NULL == _ring )||( NULL == _result.entries ))
+    {
+        printf( "FAIL: allocate samples\n" );
+        return( EXIT_FAILURE );
+    }
+
+    printf( "ring of %i records, time series of %i bytes\n",
+            SM_ERU_DB_MAX_RECORDS, SM_ERU_TS_DATA_SIZE );
+
+    sm_eru_ts_test_check(( sm_eru_ts_test_fill_ring( wrapped ) )&&
+                         ( SM_ERU_DB_MAX_RECORDS == _ring_count ),
+                         "fill and read back the wrapped ring" );
+
+    memset( &stats, 0, sizeof(stats) );
+
+    if( sm_eru_ts_test_encode( true, &stats ) )
+    {
+        sm_eru_ts_test_report( &stats );
+        sm_eru_ts_test_queries( "sealed" );
+    } else {
+        sm_eru_ts_test_check( false, "encode the ring" );
+    }
+
+    // A writer that exits without finalize leaves the samples of blocks
+    // not yet full in the tails only.
+    fflush( stdout );
+
+    pid = fork();
+    if( 0 == pid )
+    {
+        _exit( sm_eru_ts_test_encode( false, &stats ) ? 0 : 1 );
+    }
+
+    if(( 0 < pid )&&( pid == waitpid( pid, &status, 0 ) )&&
+       ( WIFEXITED(status) )&&( 0 == WEXITSTATUS(status) ))
+    {
+        sm_eru_ts_test_queries( "unsealed" );
+
+        // The next writer seals the samples it reloads from the tails.
+        if( SM_OKAY == sm_eru_ts_initialize( _ts_filename, false ) )
+        {
+            sm_eru_ts_finalize();
+            sm_eru_ts_test_queries( "recovered" );
+        } else {
+            sm_eru_ts_test_check( false, "recover the tails" );
+        }
+    } else {
+        sm_eru_ts_test_check( false, "encode the ring without finalize" );
+    }
+
+    unlink( _ring_filename );
+    unlink( _ts_filename );
+    free( _result.entries );
+    free( _ring );
+
+    printf( "%u failed\n", _failures );
+
+    return( ( 0 == _failures ) ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+// ****************************************************************************
@@ -0,0 +1,1166 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "sm_journal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#include "sm_types.h"
+#include "sm_debug.h"
+
+// A record is cut to SM_JOURNAL_RECORD_MAX_BYTES, but for the lengths of
+// the fields that were cut to nothing.
+#define SM_JOURNAL_RECORD_MAX_LENGTH \
+    (SM_JOURNAL_RECORD_MAX_BYTES + SM_JOURNAL_FIELDS_MAX * sizeof(uint16_t))
+
+typedef struct
+{
+    int fd;
+    uint64_t size;
+} SmJournalFileT;
+
+static pthread_mutex_t _journal_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool _journal_initialized = false;
+static int _journal_fd = -1;
+static int _index_fd = -1;
+static FILE* _customer_log = NULL;
+static FILE* _customer_alarm = NULL;
+static uint64_t _journal_offset = 0;
+static int64_t _journal_last_ns = 0;
+static SmJournalBlockT _batch_block;
+static char _batch[SM_JOURNAL_BATCH_MAX_BYTES];
+static uint32_t _batch_len = 0;
+static uint64_t _records_appended = 0;
+static uint64_t _records_truncated = 0;
+static uint64_t _blocks_written = 0;
+static uint64_t _bytes_written = 0;
+static uint64_t _write_failures = 0;
+static uint64_t _rotations = 0;
+
+// ****************************************************************************
+// Journal - Event String
+// ======================
+const char* sm_journal_event_str( SmJournalEventT event_type )
+{
+    switch( event_type )
+    {
+        case SM_JOURNAL_EVENT_UNKNOWN:
+            return( "unknown" );
+        break;
+
+        case SM_JOURNAL_EVENT_STATE_CHANGE:
+            return( "state-change" );
+        break;
+
+        case SM_JOURNAL_EVENT_REBOOT:
+            return( "reboot" );
+        break;
+
+        case SM_JOURNAL_EVENT_FAILOVER:
+            return( "failover" );
+        break;
+
+        case SM_JOURNAL_EVENT_ALARM:
+            return( "alarm" );
+        break;
+
+        case SM_JOURNAL_EVENT_ALARMS_CLEARED:
+            return( "alarms-cleared" );
+        break;
+
+        default:
+            return( "???" );
+        break;
+    }
+
+    return( "???" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Event Value
+// =====================
+SmJournalEventT sm_journal_event_value( const char event_str[] )
+{
+    int event_i;
+    for( event_i=0; SM_JOURNAL_EVENT_MAX > event_i; ++event_i )
+    {
+        if( 0 == strcmp( event_str,
+                         sm_journal_event_str( (SmJournalEventT) event_i ) ) )
+        {
+            return( (SmJournalEventT) event_i );
+        }
+    }
+
+    return( SM_JOURNAL_EVENT_UNKNOWN );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Generation File Name
+// ==============================
+void sm_journal_generation_file_name( const char filename[],
+    int generation, char generation_filename[], int size )
+{
+    if( 0 == generation )
+    {
+        snprintf( generation_filename, size, "%s", filename );
+    } else {
+        snprintf( generation_filename, size, "%s.%i", filename, generation );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Time String
+// =====================
+static void sm_journal_time_str( int64_t real_ns, char time_str[],
+    int time_str_size )
+{
+    char date_str[32];
+    struct tm t_real;
+    time_t secs = real_ns / 1000000000LL;
+
+    if( NULL == localtime_r( &secs, &t_real ) )
+    {
+        snprintf( time_str, time_str_size, "YYYY:MM:DD HH:MM:SS.xxx" );
+    } else {
+        strftime( date_str, sizeof(date_str), "%FT%T", &t_real );
+        snprintf( time_str, time_str_size, "%s.%03ld", date_str,
+                  (long) ((real_ns % 1000000000LL) / 1000000) );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Print Log
+// ===================
+static void sm_journal_print_log( FILE* fp, SmJournalEntryT* entry,
+    bool log_header )
+{
+    char time_str[80];
+    const char* fields[SM_JOURNAL_LOG_FIELD_MAX];
+
+    int field_i;
+    for( field_i=0; SM_JOURNAL_LOG_FIELD_MAX > field_i; ++field_i )
+    {
+        fields[field_i] = ( field_i < entry->field_count )
+                        ? entry->fields[field_i] : "";
+    }
+
+    if(( log_header )||( 0 == ( (entry->log_id - 1) % 512 ) ))
+    {
+        fprintf( fp, "+-------------------------+------------+----------------------+----------------------------------+----------------------------------+----------------------------------+---------------------------------------------------------------------------\n" );
+        fprintf( fp, "| timestamp               | log-id     | log-type             | entity-name                      | from-state                       | to-state                         | reason                                                                    \n" );
+        fprintf( fp, "+-------------------------+------------+----------------------+----------------------------------+----------------------------------+----------------------------------+---------------------------------------------------------------------------\n" );
+    }
+
+    sm_journal_time_str( entry->real_ns, time_str, sizeof(time_str) );
+
+    fprintf( fp, "| %s | %10" PRIu64 " | %-20s | %-32s | %-32s | %-32s | %-s \n",
+             time_str, entry->log_id, fields[SM_JOURNAL_LOG_FIELD_LOG_TYPE],
+             fields[SM_JOURNAL_LOG_FIELD_ENTITY_NAME],
+             fields[SM_JOURNAL_LOG_FIELD_FROM_STATE],
+             fields[SM_JOURNAL_LOG_FIELD_TO_STATE],
+             fields[SM_JOURNAL_LOG_FIELD_REASON] );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Print Alarm
+// =====================
+static void sm_journal_print_alarm( FILE* fp, SmJournalEntryT* entry )
+{
+    char name[64];
+
+    fprintf( fp, "%-31s%" PRIu64 "\n", "alarm-log-id:", entry->log_id );
+
+    int field_i;
+    for( field_i=0; entry->field_count > field_i+1; field_i += 2 )
+    {
+        snprintf( name, sizeof(name), "%s:", entry->fields[field_i] );
+        fprintf( fp, "%-31s%s\n", name, entry->fields[field_i+1] );
+    }
+
+    fprintf( fp, "\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Print Entry
+// =====================
+void sm_journal_print_entry( FILE* fp, SmJournalEntryT* entry,
+    bool log_header )
+{
+    char time_str[80];
+
+    switch( entry->event_type )
+    {
+        case SM_JOURNAL_EVENT_STATE_CHANGE:
+        case SM_JOURNAL_EVENT_REBOOT:
+        case SM_JOURNAL_EVENT_FAILOVER:
+            sm_journal_print_log( fp, entry, log_header );
+        break;
+
+        case SM_JOURNAL_EVENT_ALARM:
+            sm_journal_print_alarm( fp, entry );
+        break;
+
+        case SM_JOURNAL_EVENT_ALARMS_CLEARED:
+            sm_journal_time_str( entry->real_ns, time_str, sizeof(time_str) );
+            fprintf( fp, "----- all alarms cleared for %s at %s -----\n\n",
+                     entry->entity_name, time_str );
+        break;
+
+        default:
+            fprintf( fp, "unknown journal event %i, log-id=%" PRIu64 "\n",
+                     entry->event_type, entry->log_id );
+        break;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Record Entry
+// ======================
+// Decodes the record at pos of a block into entry, its fields are copied
+// NUL terminated to fields.  A terminator takes less than the length of a
+// field, fields of SM_JOURNAL_RECORD_MAX_LENGTH bytes hold any record.
+static SmErrorT sm_journal_record_entry( const char buffer[], uint32_t pos,
+    SmJournalRecordT* record, SmJournalEntryT* entry, char fields[] )
+{
+    uint16_t field_len;
+    uint32_t field_pos;
+    char* field_ptr;
+
+    memset( entry, 0, sizeof(SmJournalEntryT) );
+    entry->event_type = (SmJournalEventT) record->event_type;
+    entry->log_id = record->log_id;
+    entry->real_ns = record->real_ns;
+    entry->field_count = record->field_count;
+
+    field_pos = pos + sizeof(SmJournalRecordT);
+    field_ptr = fields;
+
+    int field_i;
+    for( field_i=0; record->field_count > field_i; ++field_i )
+    {
+        if( pos + record->length < field_pos + sizeof(field_len) )
+        {
+            return( SM_FAILED );
+        }
+
+        memcpy( &field_len, buffer + field_pos, sizeof(field_len) );
+        field_pos += sizeof(field_len);
+
+        if( pos + record->length < field_pos + field_len )
+        {
+            return( SM_FAILED );
+        }
+
+        memcpy( field_ptr, buffer + field_pos, field_len );
+        field_ptr[field_len] = '\0';
+
+        entry->fields[field_i] = field_ptr;
+        entry->field_lens[field_i] = field_len;
+
+        field_pos += field_len;
+        field_ptr += field_len + 1;
+    }
+
+    entry->entity_name = entry->fields[record->entity_field];
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Record Valid
+// ======================
+static bool sm_journal_record_valid( SmJournalRecordT* record, uint32_t pos,
+    uint32_t block_length )
+{
+    return(( sizeof(SmJournalRecordT) <= record->length )&&
+           ( SM_JOURNAL_RECORD_MAX_LENGTH >= record->length )&&
+           ( block_length >= pos + record->length )&&
+           ( SM_JOURNAL_FIELDS_MAX >= record->field_count )&&
+           ( record->field_count > record->entity_field ));
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Entity Hash
+// =====================
+static uint32_t sm_journal_entity_hash( const char entity_name[], int len )
+{
+    uint32_t hash = 2166136261U;
+
+    int char_i;
+    for( char_i=0; len > char_i; ++char_i )
+    {
+        hash ^= (uint8_t) entity_name[char_i];
+        hash *= 16777619U;
+    }
+
+    return( hash );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Entity Bloom Set
+// ==========================
+static void sm_journal_entity_bloom_set( SmJournalBlockT* block,
+    uint32_t entity_hash )
+{
+    unsigned int bit1 = entity_hash & 0xFF;
+    unsigned int bit2 = (entity_hash >> 8) & 0xFF;
+
+    block->entity_bloom[bit1 / 64] |= (1ULL << (bit1 % 64));
+    block->entity_bloom[bit2 / 64] |= (1ULL << (bit2 % 64));
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Entity Bloom Test
+// ===========================
+static bool sm_journal_entity_bloom_test( SmJournalBlockT* block,
+    uint32_t entity_hash )
+{
+    unsigned int bit1 = entity_hash & 0xFF;
+    unsigned int bit2 = (entity_hash >> 8) & 0xFF;
+
+    return( (block->entity_bloom[bit1 / 64] & (1ULL << (bit1 % 64))) &&
+            (block->entity_bloom[bit2 / 64] & (1ULL << (bit2 % 64))) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Write All
+// ===================
+static bool sm_journal_write_all( int fd, struct iovec iov[], int iov_count )
+{
+    ssize_t result;
+
+    while( 0 < iov_count )
+    {
+        result = writev( fd, iov, iov_count );
+        if( 0 > result )
+        {
+            if( EINTR == errno )
+            {
+                continue;
+            }
+            return( false );
+        }
+
+        while(( 0 < iov_count ) && ( (size_t) result >= iov->iov_len ))
+        {
+            result -= iov->iov_len;
+            ++iov;
+            --iov_count;
+        }
+
+        if( 0 < iov_count )
+        {
+            iov->iov_base = (char*) iov->iov_base + result;
+            iov->iov_len -= result;
+        }
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Open
+// ==============
+static SmErrorT sm_journal_open( void )
+{
+    SmJournalIndexT index;
+    struct stat stat_data;
+
+    _journal_fd = open( SM_JOURNAL_FILE, O_WRONLY | O_CREAT | O_APPEND,
+                        0640 );
+    if( 0 > _journal_fd )
+    {
+        DPRINTFE( "Failed to open journal file (%s), error=%s.",
+                  SM_JOURNAL_FILE, strerror( errno ) );
+        return( SM_FAILED );
+    }
+
+    _index_fd = open( SM_JOURNAL_INDEX_FILE, O_RDWR | O_CREAT | O_APPEND,
+                      0640 );
+    if( 0 > _index_fd )
+    {
+        DPRINTFE( "Failed to open journal index file (%s), error=%s.",
+                  SM_JOURNAL_INDEX_FILE, strerror( errno ) );
+        close( _journal_fd );
+        _journal_fd = -1;
+        return( SM_FAILED );
+    }
+
+    _journal_offset = 0;
+    if( 0 == fstat( _journal_fd, &stat_data ) )
+    {
+        _journal_offset = stat_data.st_size;
+    }
+
+    // Carry on the time order of the index from its last block.
+    if(( 0 == fstat( _index_fd, &stat_data ) ) &&
+       ( (off_t) sizeof(index) <= stat_data.st_size ))
+    {
+        if( (ssize_t) sizeof(index) == pread( _index_fd, &index,
+                sizeof(index), stat_data.st_size - sizeof(index) ) )
+        {
+            if( _journal_last_ns < index.block.last_ns )
+            {
+                _journal_last_ns = index.block.last_ns;
+            }
+        }
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Close
+// ===============
+static void sm_journal_close( void )
+{
+    if( 0 <= _journal_fd )
+    {
+        close( _journal_fd );
+        _journal_fd = -1;
+    }
+
+    if( 0 <= _index_fd )
+    {
+        close( _index_fd );
+        _index_fd = -1;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Rotate File
+// =====================
+// Moves each generation of the file up by one, the oldest is replaced.
+static void sm_journal_rotate_file( const char filename[] )
+{
+    char from[PATH_MAX];
+    char to[PATH_MAX];
+
+    int generation;
+    for( generation=SM_JOURNAL_GENERATIONS; 0 < generation; --generation )
+    {
+        sm_journal_generation_file_name( filename, generation - 1, from,
+                                         sizeof(from) );
+        sm_journal_generation_file_name( filename, generation, to,
+                                         sizeof(to) );
+
+        if(( 0 > rename( from, to ) )&&( ENOENT != errno ))
+        {
+            DPRINTFE( "Failed to rotate %s to %s, error=%s.", from, to,
+                      strerror( errno ) );
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Rotate
+// ================
+static void sm_journal_rotate( void )
+{
+    sm_journal_close();
+
+    sm_journal_rotate_file( SM_JOURNAL_FILE );
+    sm_journal_rotate_file( SM_JOURNAL_INDEX_FILE );
+
+    ++_rotations;
+
+    sm_journal_open();
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Customer Open
+// =======================
+static FILE* sm_journal_customer_open( const char filename[] )
+{
+    FILE* fp;
+
+    fp = fopen( filename, "a" );
+    if( NULL == fp )
+    {
+        DPRINTFE( "Failed to open customer file (%s), error=%s.", filename,
+                  strerror( errno ) );
+        return( NULL );
+    }
+
+    // Written a batch at a time, on the flush of the journal.
+    setvbuf( fp, NULL, _IOFBF, SM_JOURNAL_BATCH_MAX_BYTES );
+    chmod( filename, 0640 );
+
+    return( fp );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Customer Close
+// ========================
+static void sm_journal_customer_close( FILE** fp )
+{
+    if( NULL != *fp )
+    {
+        fclose( *fp );
+        *fp = NULL;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Customer Print
+// ========================
+// Prints the records of the batch to the customer log and alarm files.
+static void sm_journal_customer_print( void )
+{
+    SmJournalRecordT record;
+    SmJournalEntryT entry;
+    char fields[SM_JOURNAL_RECORD_MAX_LENGTH];
+    uint32_t pos = 0;
+    FILE* fp;
+
+    while( pos + sizeof(record) <= _batch_len )
+    {
+        memcpy( &record, _batch + pos, sizeof(record) );
+
+        if(( !sm_journal_record_valid( &record, pos, _batch_len ) )||
+           ( SM_OKAY != sm_journal_record_entry( _batch, pos, &record,
+                                                 &entry, fields ) ))
+        {
+            break;
+        }
+
+        if(( SM_JOURNAL_EVENT_ALARM == entry.event_type )||
+           ( SM_JOURNAL_EVENT_ALARMS_CLEARED == entry.event_type ))
+        {
+            fp = _customer_alarm;
+        } else {
+            fp = _customer_log;
+        }
+
+        if( NULL != fp )
+        {
+            sm_journal_print_entry( fp, &entry, false );
+        }
+
+        pos += record.length;
+    }
+
+    if((( NULL != _customer_log )&&( 0 != fflush( _customer_log ) ))||
+       (( NULL != _customer_alarm )&&( 0 != fflush( _customer_alarm ) )))
+    {
+        DPRINTFE( "Failed to write customer files, error=%s.",
+                  strerror( errno ) );
+        ++_write_failures;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Flush Batch
+// =====================
+// Called with the journal mutex held.
+static void sm_journal_flush_batch( void )
+{
+    SmJournalIndexT index;
+    struct iovec iov[2];
+
+    if( 0 == _batch_block.record_count )
+    {
+        return;
+    }
+
+    sm_journal_customer_print();
+
+    if(( 0 > _journal_fd )||( 0 > _index_fd ))
+    {
+        ++_write_failures;
+        goto CLEAR;
+    }
+
+    memcpy( _batch_block.magic, SM_JOURNAL_BLOCK_MAGIC,
+            sizeof(_batch_block.magic) );
+    _batch_block.length = _batch_len;
+
+    iov[0].iov_base = &_batch_block;
+    iov[0].iov_len = sizeof(_batch_block);
+    iov[1].iov_base = _batch;
+    iov[1].iov_len = _batch_len;
+
+    if( !sm_journal_write_all( _journal_fd, iov, 2 ) )
+    {
+        DPRINTFE( "Failed to write journal block, error=%s.",
+                  strerror( errno ) );
+        ++_write_failures;
+        goto CLEAR;
+    }
+
+    // The block is indexed once it is complete in the journal.
+    memset( &index, 0, sizeof(index) );
+    index.offset = _journal_offset;
+    index.block = _batch_block;
+
+    iov[0].iov_base = &index;
+    iov[0].iov_len = sizeof(index);
+
+    if( !sm_journal_write_all( _index_fd, iov, 1 ) )
+    {
+        DPRINTFE( "Failed to write journal index, error=%s.",
+                  strerror( errno ) );
+        ++_write_failures;
+    }
+
+    _journal_offset += sizeof(_batch_block) + _batch_len;
+    _bytes_written += sizeof(_batch_block) + _batch_len;
+    ++_blocks_written;
+
+    if( SM_JOURNAL_MAX_BYTES <= _journal_offset )
+    {
+        sm_journal_rotate();
+    }
+
+CLEAR:
+    memset( &_batch_block, 0, sizeof(_batch_block) );
+    _batch_len = 0;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Append
+// ================
+SmErrorT sm_journal_append( SmJournalEventT event_type,
+    uint64_t log_id, const struct timespec* ts_real, int entity_field,
+    int field_count, const char* fields[] )
+{
+    SmJournalRecordT record;
+    uint16_t field_len;
+    uint32_t record_len;
+    int len;
+    char* ptr;
+
+    if( SM_JOURNAL_FIELDS_MAX < field_count )
+    {
+        field_count = SM_JOURNAL_FIELDS_MAX;
+    }
+
+    if(( 0 > entity_field )||( field_count <= entity_field ))
+    {
+        DPRINTFE( "Invalid journal entity field %i of %i fields.",
+                  entity_field, field_count );
+        return( SM_FAILED );
+    }
+
+    memset( &record, 0, sizeof(record) );
+    record.event_type = event_type;
+    record.field_count = field_count;
+    record.entity_field = entity_field;
+    record.entity_hash = sm_journal_entity_hash( fields[entity_field],
+                                                 strlen( fields[entity_field] ) );
+    record.log_id = log_id;
+    record.real_ns = (int64_t) ts_real->tv_sec * 1000000000LL
+                   + ts_real->tv_nsec;
+
+    if( 0 != pthread_mutex_lock( &_journal_mutex ) )
+    {
+        DPRINTFE( "Failed to capture mutex." );
+        return( SM_FAILED );
+    }
+
+    if( !_journal_initialized )
+    {
+        pthread_mutex_unlock( &_journal_mutex );
+        return( SM_FAILED );
+    }
+
+    if( SM_JOURNAL_BATCH_MAX_BYTES < _batch_len + SM_JOURNAL_RECORD_MAX_LENGTH )
+    {
+        sm_journal_flush_batch();
+    }
+
+    // Fields are cut to keep the record within its maximum size.
+    ptr = _batch + _batch_len + sizeof(record);
+    record_len = sizeof(record);
+
+    int field_i;
+    for( field_i=0; field_count > field_i; ++field_i )
+    {
+        len = (NULL == fields[field_i]) ? 0 : strlen( fields[field_i] );
+
+        if( SM_JOURNAL_RECORD_MAX_BYTES
+            < record_len + sizeof(field_len) + len )
+        {
+            len = SM_JOURNAL_RECORD_MAX_BYTES - record_len - sizeof(field_len);
+            if( 0 > len )
+            {
+                len = 0;
+            }
+            ++_records_truncated;
+        }
+
+        field_len = len;
+        memcpy( ptr, &field_len, sizeof(field_len) );
+        memcpy( ptr + sizeof(field_len), fields[field_i], len );
+        ptr += sizeof(field_len) + len;
+        record_len += sizeof(field_len) + len;
+    }
+
+    record.length = record_len;
+    memcpy( _batch + _batch_len, &record, sizeof(record) );
+    _batch_len += record_len;
+
+    if(( 0 == _batch_block.record_count )||
+       ( _batch_block.first_ns > record.real_ns ))
+    {
+        _batch_block.first_ns = record.real_ns;
+    }
+
+    // Kept in order for the binary search of the index, even when the
+    // real time clock is stepped back.
+    if( _journal_last_ns < record.real_ns )
+    {
+        _journal_last_ns = record.real_ns;
+    }
+    _batch_block.last_ns = _journal_last_ns;
+
+    _batch_block.event_mask |= (1U << event_type);
+    sm_journal_entity_bloom_set( &_batch_block, record.entity_hash );
+    ++_batch_block.record_count;
+    ++_records_appended;
+
+    if(( SM_JOURNAL_EVENT_REBOOT == event_type )||
+       ( SM_JOURNAL_EVENT_FAILOVER == event_type ))
+    {
+        sm_journal_flush_batch();
+    }
+
+    if( 0 != pthread_mutex_unlock( &_journal_mutex ) )
+    {
+        DPRINTFE( "Failed to release mutex." );
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Flush
+// ===============
+void sm_journal_flush( void )
+{
+    if( 0 != pthread_mutex_lock( &_journal_mutex ) )
+    {
+        DPRINTFE( "Failed to capture mutex." );
+        return;
+    }
+
+    sm_journal_flush_batch();
+
+    if( 0 != pthread_mutex_unlock( &_journal_mutex ) )
+    {
+        DPRINTFE( "Failed to release mutex." );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Query Match Block
+// ===========================
+static bool sm_journal_query_match_block( SmJournalBlockT* block,
+    SmJournalFilterT* filter, uint32_t entity_hash )
+{
+    if( 0 == ( block->event_mask & filter->event_mask ) )
+    {
+        return( false );
+    }
+
+    if(( NULL != filter->entity_name ) &&
+       ( !sm_journal_entity_bloom_test( block, entity_hash ) ))
+    {
+        return( false );
+    }
+
+    if(( 0 != filter->end_ns )&&( block->first_ns > filter->end_ns ))
+    {
+        return( false );
+    }
+
+    if(( 0 != filter->start_ns )&&( block->last_ns < filter->start_ns ))
+    {
+        return( false );
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Query Block
+// =====================
+static SmErrorT sm_journal_query_block( SmJournalFileT* file,
+    SmJournalBlockT* block, uint64_t offset, char buffer[],
+    SmJournalFilterT* filter, uint32_t entity_hash,
+    SmJournalQueryCallbackT callback, void* user_data,
+    SmJournalQueryStatsT* stats )
+{
+    SmJournalRecordT record;
+    SmJournalEntryT entry;
+    char fields[SM_JOURNAL_RECORD_MAX_LENGTH];
+    uint32_t pos = 0;
+
+    if( (ssize_t) block->length != pread( file->fd, buffer, block->length,
+                                          offset + sizeof(SmJournalBlockT) ) )
+    {
+        return( SM_FAILED );
+    }
+
+    ++(stats->blocks_read);
+
+    while( pos + sizeof(record) <= block->length )
+    {
+        memcpy( &record, buffer + pos, sizeof(record) );
+
+        if( !sm_journal_record_valid( &record, pos, block->length ) )
+        {
+            return( SM_FAILED );
+        }
+
+        ++(stats->records_read);
+
+        if(( 0 == ( filter->event_mask & (1U << record.event_type) ) )||
+           (( 0 != filter->start_ns )&&( record.real_ns < filter->start_ns ))||
+           (( 0 != filter->end_ns )&&( record.real_ns > filter->end_ns ))||
+           (( NULL != filter->entity_name )&&
+            ( entity_hash != record.entity_hash )))
+        {
+            pos += record.length;
+            continue;
+        }
+
+        if( SM_OKAY != sm_journal_record_entry( buffer, pos, &record, &entry,
+                                                fields ) )
+        {
+            return( SM_FAILED );
+        }
+
+        if(( NULL == filter->entity_name )||
+           ( 0 == strcmp( filter->entity_name, entry.entity_name ) ))
+        {
+            ++(stats->records_matched);
+            callback( &entry, user_data );
+        }
+
+        pos += record.length;
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Query Read Block
+// ==========================
+static bool sm_journal_query_read_block( SmJournalFileT* file,
+    uint64_t offset, SmJournalBlockT* block )
+{
+    if( offset + sizeof(SmJournalBlockT) > file->size )
+    {
+        return( false );
+    }
+
+    if( (ssize_t) sizeof(SmJournalBlockT) != pread( file->fd, block,
+                                            sizeof(SmJournalBlockT), offset ) )
+    {
+        return( false );
+    }
+
+    if(( 0 != memcmp( block->magic, SM_JOURNAL_BLOCK_MAGIC,
+                      sizeof(block->magic) ) )||
+       ( SM_JOURNAL_BATCH_MAX_BYTES < block->length )||
+       ( offset + sizeof(SmJournalBlockT) + block->length > file->size ))
+    {
+        return( false );
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Query
+// ===============
+SmErrorT sm_journal_query( const char filename[],
+    const char index_filename[], SmJournalFilterT* filter,
+    SmJournalQueryCallbackT callback, void* user_data,
+    SmJournalQueryStatsT* stats )
+{
+    SmJournalFileT file;
+    SmJournalBlockT block;
+    SmJournalIndexT* indexes = NULL;
+    uint32_t entity_hash = 0;
+    uint64_t offset = 0;
+    struct stat stat_data;
+    char* buffer = NULL;
+    int index_count = 0;
+    int index_fd;
+    int low, high, mid;
+    SmErrorT error = SM_OKAY;
+
+    memset( stats, 0, sizeof(SmJournalQueryStatsT) );
+
+    if( NULL != filter->entity_name )
+    {
+        entity_hash = sm_journal_entity_hash( filter->entity_name,
+                                              strlen( filter->entity_name ) );
+    }
+
+    memset( &file, 0, sizeof(file) );
+    file.fd = open( filename, O_RDONLY );
+    if( 0 > file.fd )
+    {
+        return( SM_NOT_FOUND );
+    }
+
+    if( 0 != fstat( file.fd, &stat_data ) )
+    {
+        close( file.fd );
+        return( SM_FAILED );
+    }
+    file.size = stat_data.st_size;
+
+    buffer = (char*) malloc( SM_JOURNAL_BATCH_MAX_BYTES );
+    if( NULL == buffer )
+    {
+        close( file.fd );
+        return( SM_FAILED );
+    }
+
+    // Without an index every block is read.
+    index_fd = open( index_filename, O_RDONLY );
+    if( 0 <= index_fd )
+    {
+        if(( 0 == fstat( index_fd, &stat_data ) ) &&
+           ( (off_t) sizeof(SmJournalIndexT) <= stat_data.st_size ))
+        {
+            index_count = stat_data.st_size / sizeof(SmJournalIndexT);
+            indexes = (SmJournalIndexT*) malloc( index_count
+                                                 * sizeof(SmJournalIndexT) );
+            if(( NULL == indexes )||
+               ( (ssize_t) (index_count * sizeof(SmJournalIndexT))
+                 != pread( index_fd, indexes,
+                           index_count * sizeof(SmJournalIndexT), 0 ) ))
+            {
+                index_count = 0;
+            }
+        }
+        close( index_fd );
+    }
+
+    stats->blocks_total = index_count;
+
+    // Index last times never go back, the first block that ends at or
+    // after the start time is found with a binary search.
+    low = 0;
+    high = index_count;
+
+    if( 0 != filter->start_ns )
+    {
+        while( low < high )
+        {
+            mid = low + (high - low) / 2;
+            if( indexes[mid].block.last_ns < filter->start_ns )
+            {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+    }
+
+    int index_i;
+    for( index_i=low; index_count > index_i; ++index_i )
+    {
+        SmJournalIndexT* index = &(indexes[index_i]);
+
+        // Later blocks start after the end time, unless the real time
+        // clock was stepped back.
+        if(( 0 != filter->end_ns )&&( index->block.first_ns > filter->end_ns ))
+        {
+            break;
+        }
+
+        if( !sm_journal_query_match_block( &(index->block), filter,
+                                           entity_hash ) )
+        {
+            continue;
+        }
+
+        if( !sm_journal_query_read_block( &file, index->offset, &block ) )
+        {
+            continue;
+        }
+
+        error = sm_journal_query_block( &file, &block, index->offset, buffer,
+                                        filter, entity_hash, callback,
+                                        user_data, stats );
+        if( SM_OKAY != error )
+        {
+            goto DONE;
+        }
+    }
+
+    if( 0 < index_count )
+    {
+        offset = indexes[index_count-1].offset + sizeof(SmJournalBlockT)
+               + indexes[index_count-1].block.length;
+    }
+
+    // Blocks written after the last index entry, or all blocks when the
+    // index is missing, are found by walking the block headers.
+    while( sm_journal_query_read_block( &file, offset, &block ) )
+    {
+        ++(stats->blocks_total);
+
+        if( sm_journal_query_match_block( &block, filter, entity_hash ) )
+        {
+            error = sm_journal_query_block( &file, &block, offset, buffer,
+                                            filter, entity_hash, callback,
+                                            user_data, stats );
+            if( SM_OKAY != error )
+            {
+                goto DONE;
+            }
+        }
+
+        offset += sizeof(SmJournalBlockT) + block.length;
+    }
+
+DONE:
+    if( NULL != indexes )
+    {
+        free( indexes );
+    }
+
+    free( buffer );
+    close( file.fd );
+
+    return( error );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Dump Data
+// ===================
+void sm_journal_dump_data( FILE* log )
+{
+    fprintf( log, "--------------------------------------------------------------------\n" );
+    fprintf( log, "JOURNAL DATA\n" );
+    fprintf( log, "  journal_file.........................%s\n", SM_JOURNAL_FILE );
+    fprintf( log, "  journal_offset.......................%" PRIu64 "\n",
+             _journal_offset );
+    fprintf( log, "  records_appended.....................%" PRIu64 "\n",
+             _records_appended );
+    fprintf( log, "  records_truncated....................%" PRIu64 "\n",
+             _records_truncated );
+    fprintf( log, "  records_pending......................%u\n",
+             _batch_block.record_count );
+    fprintf( log, "  blocks_written.......................%" PRIu64 "\n",
+             _blocks_written );
+    fprintf( log, "  bytes_written........................%" PRIu64 "\n",
+             _bytes_written );
+    fprintf( log, "  write_failures.......................%" PRIu64 "\n",
+             _write_failures );
+    fprintf( log, "  rotations............................%" PRIu64 "\n",
+             _rotations );
+    fprintf( log, "--------------------------------------------------------------------\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Initialize
+// ====================
+SmErrorT sm_journal_initialize( void )
+{
+    SmErrorT error;
+
+    if( 0 != pthread_mutex_lock( &_journal_mutex ) )
+    {
+        DPRINTFE( "Failed to capture mutex." );
+        return( SM_FAILED );
+    }
+
+    memset( &_batch_block, 0, sizeof(_batch_block) );
+    _batch_len = 0;
+
+    error = sm_journal_open();
+    if( SM_OKAY == error )
+    {
+        _customer_log = sm_journal_customer_open(
+                                    SM_JOURNAL_CUSTOMER_LOG_FILE );
+        _customer_alarm = sm_journal_customer_open(
+                                    SM_JOURNAL_CUSTOMER_ALARM_FILE );
+        _journal_initialized = true;
+    }
+
+    if( 0 != pthread_mutex_unlock( &_journal_mutex ) )
+    {
+        DPRINTFE( "Failed to release mutex." );
+    }
+
+    return( error );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Finalize
+// ==================
+SmErrorT sm_journal_finalize( void )
+{
+    if( 0 != pthread_mutex_lock( &_journal_mutex ) )
+    {
+        DPRINTFE( "Failed to capture mutex." );
+        return( SM_FAILED );
+    }
+
+    if( _journal_initialized )
+    {
+        sm_journal_flush_batch();
+        sm_journal_close();
+        sm_journal_customer_close( &_customer_log );
+        sm_journal_customer_close( &_customer_alarm );
+        _journal_initialized = false;
+    }
+
+    if( 0 != pthread_mutex_unlock( &_journal_mutex ) )
+    {
+        DPRINTFE( "Failed to release mutex." );
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
@@ -0,0 +1,207 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __SM_JOURNAL_H__
+#define __SM_JOURNAL_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "sm_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SM_JOURNAL_FILE                             "/var/log/sm-journal.bin"
+#define SM_JOURNAL_INDEX_FILE                       "/var/log/sm-journal.idx"
+#define SM_JOURNAL_CUSTOMER_LOG_FILE               "/var/log/sm-customer.log"
+#define SM_JOURNAL_CUSTOMER_ALARM_FILE           "/var/log/sm-customer.alarm"
+#define SM_JOURNAL_MAX_BYTES                              (64*1024*1024)
+#define SM_JOURNAL_GENERATIONS                                       5
+#define SM_JOURNAL_BLOCK_MAGIC                                  "SMJRNBLK"
+#define SM_JOURNAL_BATCH_MAX_BYTES                            (64*1024)
+#define SM_JOURNAL_RECORD_MAX_BYTES                               4096
+#define SM_JOURNAL_FIELDS_MAX                                       48
+#define SM_JOURNAL_ENTITY_BLOOM_WORDS                                4
+
+typedef enum
+{
+    SM_JOURNAL_EVENT_UNKNOWN,
+    SM_JOURNAL_EVENT_STATE_CHANGE,
+    SM_JOURNAL_EVENT_REBOOT,
+    SM_JOURNAL_EVENT_FAILOVER,
+    SM_JOURNAL_EVENT_ALARM,
+    SM_JOURNAL_EVENT_ALARMS_CLEARED,
+    SM_JOURNAL_EVENT_MAX
+} SmJournalEventT;
+
+// Fields of the state-change, reboot and failover events, these are the
+// columns of the customer log.
+typedef enum
+{
+    SM_JOURNAL_LOG_FIELD_LOG_TYPE,
+    SM_JOURNAL_LOG_FIELD_ENTITY_NAME,
+    SM_JOURNAL_LOG_FIELD_FROM_STATE,
+    SM_JOURNAL_LOG_FIELD_TO_STATE,
+    SM_JOURNAL_LOG_FIELD_REASON,
+    SM_JOURNAL_LOG_FIELD_MAX
+} SmJournalLogFieldT;
+
+// Record as written to the journal, followed by field_count fields each
+// of a uint16_t length and that many bytes, entity_field is the field that
+// holds the entity name. Alarm events carry name and value field pairs,
+// the alarms-cleared event carries the domain name.
+typedef struct
+{
+    uint16_t event_type;
+    uint16_t length;
+    uint16_t field_count;
+    uint16_t entity_field;
+    uint32_t entity_hash;
+    uint32_t reserved;
+    uint64_t log_id;
+    int64_t real_ns;
+} __attribute__ ((packed)) SmJournalRecordT;
+
+// Header of a batch of records in the journal, the same header with the
+// offset of the block is appended to the index file.
+typedef struct
+{
+    char magic[8];
+    uint32_t length;
+    uint32_t record_count;
+    int64_t first_ns;
+    int64_t last_ns;
+    uint32_t event_mask;
+    uint32_t reserved;
+    uint64_t entity_bloom[SM_JOURNAL_ENTITY_BLOOM_WORDS];
+} __attribute__ ((packed)) SmJournalBlockT;
+
+typedef struct
+{
+    uint64_t offset;
+    SmJournalBlockT block;
+} __attribute__ ((packed)) SmJournalIndexT;
+
+typedef struct
+{
+    SmJournalEventT event_type;
+    uint64_t log_id;
+    int64_t real_ns;
+    const char* entity_name;
+    int field_count;
+    const char* fields[SM_JOURNAL_FIELDS_MAX];
+    int field_lens[SM_JOURNAL_FIELDS_MAX];
+} SmJournalEntryT;
+
+typedef struct
+{
+    uint32_t event_mask;
+    const char* entity_name;
+    int64_t start_ns;
+    int64_t end_ns;
+} SmJournalFilterT;
+
+typedef struct
+{
+    unsigned int blocks_total;
+    unsigned int blocks_read;
+    unsigned int records_read;
+    unsigned int records_matched;
+} SmJournalQueryStatsT;
+
+typedef void (*SmJournalQueryCallbackT) (SmJournalEntryT* entry,
+    void* user_data);
+
+// ****************************************************************************
+// Journal - Event String
+// ======================
+extern const char* sm_journal_event_str( SmJournalEventT event_type );
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Event Value
+// =====================
+extern SmJournalEventT sm_journal_event_value( const char event_str[] );
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Generation File Name
+// ==============================
+// Name of a rotated generation of the journal or its index, generation 1
+// is the newest and zero is the file being written.
+extern void sm_journal_generation_file_name( const char filename[],
+    int generation, char generation_filename[], int size );
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Print Entry
+// =====================
+// Prints the entry in the format of sm-customer.log or sm-customer.alarm,
+// the log table header is printed every 512 logs or when asked for.
+extern void sm_journal_print_entry( FILE* fp, SmJournalEntryT* entry,
+    bool log_header );
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Append
+// ================
+// Copies the event into the current batch, the batch is written as one
+// block when it fills, on a flush, and right away for reboot and failover
+// events.  A written batch is also printed to sm-customer.log and
+// sm-customer.alarm. Fields are NUL terminated strings, the entity name is
+// fields entity_field and is indexed.
+extern SmErrorT sm_journal_append( SmJournalEventT event_type,
+    uint64_t log_id, const struct timespec* ts_real, int entity_field,
+    int field_count, const char* fields[] );
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Flush
+// ===============
+extern void sm_journal_flush( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Query
+// ===============
+// Calls callback for each record of the journal file that matches filter,
+// in the order written. The index file narrows the blocks read: a binary
+// search on time finds the first block, and the event mask and entity
+// bloom filter of each block skip the blocks without a match.
+extern SmErrorT sm_journal_query( const char filename[],
+    const char index_filename[], SmJournalFilterT* filter,
+    SmJournalQueryCallbackT callback, void* user_data,
+    SmJournalQueryStatsT* stats );
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Dump Data
+// ===================
+extern void sm_journal_dump_data( FILE* log );
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Initialize
+// ====================
+// The journal keeps SM_JOURNAL_GENERATIONS rotated generations of
+// SM_JOURNAL_MAX_BYTES, the customer files are left to logrotate.
+extern SmErrorT sm_journal_initialize( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Journal - Finalize
+// ==================
+extern SmErrorT sm_journal_finalize( void );
+// ****************************************************************************
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SM_JOURNAL_H__
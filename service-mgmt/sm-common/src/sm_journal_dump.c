@@ -0,0 +1,317 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#define _XOPEN_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <limits.h>
+#include <getopt.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+#include "sm_journal.h"
+
+#define SM_JOURNAL_DUMP_LOG_EVENTS                                        \
+    ((1U << SM_JOURNAL_EVENT_STATE_CHANGE) |                              \
+     (1U << SM_JOURNAL_EVENT_REBOOT) |                                    \
+     (1U << SM_JOURNAL_EVENT_FAILOVER))
+#define SM_JOURNAL_DUMP_ALARM_EVENTS                                      \
+    ((1U << SM_JOURNAL_EVENT_ALARM) |                                     \
+     (1U << SM_JOURNAL_EVENT_ALARMS_CLEARED))
+
+typedef struct
+{
+    uint64_t log_rows;
+} SmJournalDumpT;
+
+static struct option _sm_journal_dump_long_options[] =
+{
+    { "file",       required_argument, NULL, 'f'},
+    { "index",      required_argument, NULL, 'i'},
+    { "entity",     required_argument, NULL, 'n'},
+    { "type",       required_argument, NULL, 't'},
+    { "start-time", required_argument, NULL, 's'},
+    { "end-time",   required_argument, NULL, 'e'},
+    { "log",        no_argument,       NULL, 'l'},
+    { "alarm",      no_argument,       NULL, 'a'},
+    { "stats",      no_argument,       NULL, 'x'},
+    { "help",       no_argument,       NULL, 'h'},
+    {0, 0, 0, 0}
+};
+
+// ****************************************************************************
+// Main - Journal Dump Usage
+// =========================
+static void usage( void )
+{
+    printf( " usage:\n"
+            "   sm-journal [--file <journal file> [--index <index file>]]\n"
+            "              [--entity <entity name>]\n"
+            "              [--type <state-change|reboot|failover|alarm|"
+            "alarms-cleared>]\n"
+            "              [--start-time <\"YEAR-MONTH-DAY HH:MM:SS\">]\n"
+            "              [--end-time   <\"YEAR-MONTH-DAY HH:MM:SS\">]\n"
+            "              [--log] [--alarm] [--stats]\n"
+            "              [--help]\n"
+            "       --file      : journal file, defaults to the rotated "
+            "generations and the current journal\n"
+            "       --index     : index of the journal file\n"
+            "       --entity    : entity name to filter on\n"
+            "       --type      : type of event to filter on, repeatable\n"
+            "       --start-time: start time for filter (inclusive)\n"
+            "       --end-time  : end time for filter (inclusive)\n"
+            "       --log       : events of the customer log\n"
+            "       --alarm     : events of the customer alarm log\n"
+            "       --stats     : print the blocks read to stderr\n"
+            "       --help      : print out this help message\n"
+            "\n"
+            "   Events are displayed in the sm-customer.log and "
+            "sm-customer.alarm formats.\n"
+            "\n"
+            "   eg. sm-journal --entity controller-0 --start-time "
+            "\"2014-10-17 22:15:10\"\n"
+            "\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Main - Journal Dump Entry
+// =========================
+static void sm_journal_dump_entry( SmJournalEntryT* entry, void* user_data )
+{
+    SmJournalDumpT* dump = (SmJournalDumpT*) user_data;
+
+    sm_journal_print_entry( stdout, entry, 0 == dump->log_rows );
+
+    if( SM_JOURNAL_DUMP_LOG_EVENTS & (1U << entry->event_type) )
+    {
+        ++(dump->log_rows);
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Main - Journal Dump Parse Time
+// ==============================
+static int64_t sm_journal_dump_parse_time( const char time_str[] )
+{
+    struct tm t;
+
+    memset( &t, 0, sizeof(t) );
+
+    if( NULL == strptime( time_str, "%FT%T", &t ) )
+    {
+        if( NULL == strptime( time_str, "%F %T", &t ) )
+        {
+            return( -1 );
+        }
+    }
+
+    t.tm_isdst = -1;
+
+    return( (int64_t) mktime( &t ) * 1000000000LL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Main - Journal Dump File
+// ========================
+static SmErrorT sm_journal_dump_file( const char filename[],
+    const char index_filename[], SmJournalFilterT* filter,
+    SmJournalDumpT* dump, bool want_stats )
+{
+    SmJournalQueryStatsT stats;
+    SmErrorT error;
+
+    error = sm_journal_query( filename, index_filename, filter,
+                              sm_journal_dump_entry, dump, &stats );
+    if( SM_NOT_FOUND == error )
+    {
+        return( error );
+    }
+
+    if( SM_OKAY != error )
+    {
+        fprintf( stderr, "Failed to read journal %s, error=%s.\n", filename,
+                 sm_error_str( error ) );
+    }
+
+    if( want_stats )
+    {
+        fprintf( stderr, "%s: blocks-read=%u of %u, records-read=%u, "
+                 "records-matched=%u\n", filename, stats.blocks_read,
+                 stats.blocks_total, stats.records_read,
+                 stats.records_matched );
+    }
+
+    return( error );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Main - Journal Dump
+// ===================
+int main( int argc, char *argv[], char *envp[] )
+{
+    const char* filename = NULL;
+    char filename_buf[PATH_MAX];
+    char index_filename[PATH_MAX];
+    const char* index_arg = NULL;
+    bool want_stats = false;
+    SmJournalEventT event_type;
+    SmJournalFilterT filter;
+    SmJournalDumpT dump;
+    SmErrorT error;
+    char* bin;
+    int c;
+
+    memset( &filter, 0, sizeof(filter) );
+    memset( &dump, 0, sizeof(dump) );
+
+    while( true )
+    {
+        c = getopt_long( argc, argv, "", _sm_journal_dump_long_options,
+                         NULL );
+        if( -1 == c )
+        {
+            break;
+        }
+
+        switch( c )
+        {
+            case 'f':
+                filename = optarg;
+            break;
+
+            case 'i':
+                index_arg = optarg;
+            break;
+
+            case 'n':
+                filter.entity_name = optarg;
+            break;
+
+            case 't':
+                event_type = sm_journal_event_value( optarg );
+                if( SM_JOURNAL_EVENT_UNKNOWN == event_type )
+                {
+                    usage();
+                    return( EXIT_FAILURE );
+                }
+                filter.event_mask |= (1U << event_type);
+            break;
+
+            case 's':
+                filter.start_ns = sm_journal_dump_parse_time( optarg );
+                if( 0 > filter.start_ns )
+                {
+                    usage();
+                    return( EXIT_FAILURE );
+                }
+            break;
+
+            case 'e':
+                filter.end_ns = sm_journal_dump_parse_time( optarg );
+                if( 0 > filter.end_ns )
+                {
+                    usage();
+                    return( EXIT_FAILURE );
+                }
+                // Inclusive of the whole second.
+                filter.end_ns += 999999999LL;
+            break;
+
+            case 'l':
+                filter.event_mask |= SM_JOURNAL_DUMP_LOG_EVENTS;
+            break;
+
+            case 'a':
+                filter.event_mask |= SM_JOURNAL_DUMP_ALARM_EVENTS;
+            break;
+
+            case 'x':
+                want_stats = true;
+            break;
+
+            case 'h':
+                usage();
+                return( EXIT_SUCCESS );
+            break;
+
+            default:
+                usage();
+                return( EXIT_FAILURE );
+            break;
+        }
+    }
+
+    if( 0 == filter.event_mask )
+    {
+        filter.event_mask = SM_JOURNAL_DUMP_LOG_EVENTS
+                          | SM_JOURNAL_DUMP_ALARM_EVENTS;
+    }
+
+    if( NULL != filename )
+    {
+        // The index sits beside the journal, sm-journal.bin[.N] is
+        // indexed by sm-journal.idx[.N].
+        if( NULL != index_arg )
+        {
+            snprintf( index_filename, sizeof(index_filename), "%s",
+                      index_arg );
+        } else {
+            snprintf( index_filename, sizeof(index_filename), "%s",
+                      filename );
+            bin = strstr( index_filename, ".bin" );
+            if( NULL != bin )
+            {
+                memcpy( bin, ".idx", 4 );
+            } else {
+                snprintf( index_filename, sizeof(index_filename), "%s.idx",
+                          filename );
+            }
+        }
+
+        error = sm_journal_dump_file( filename, index_filename, &filter,
+                                      &dump, want_stats );
+        if( SM_NOT_FOUND == error )
+        {
+            fprintf( stderr, "Failed to open journal %s.\n", filename );
+        }
+
+        return( ( SM_OKAY == error ) ? EXIT_SUCCESS : EXIT_FAILURE );
+    }
+
+    // Oldest generation first.
+    int generation;
+    for( generation=SM_JOURNAL_GENERATIONS; 0 < generation; --generation )
+    {
+        sm_journal_generation_file_name( SM_JOURNAL_FILE, generation,
+                                         filename_buf, sizeof(filename_buf) );
+        sm_journal_generation_file_name( SM_JOURNAL_INDEX_FILE, generation,
+                                         index_filename,
+                                         sizeof(index_filename) );
+
+        error = sm_journal_dump_file( filename_buf, index_filename, &filter,
+                                      &dump, want_stats );
+        if(( SM_OKAY != error )&&( SM_NOT_FOUND != error ))
+        {
+            return( EXIT_FAILURE );
+        }
+    }
+
+    error = sm_journal_dump_file( SM_JOURNAL_FILE, SM_JOURNAL_INDEX_FILE,
+                                  &filter, &dump, want_stats );
+    if( SM_NOT_FOUND == error )
+    {
+        fprintf( stderr, "Failed to open journal %s.\n", SM_JOURNAL_FILE );
+    }
+
+    return( ( SM_OKAY == error ) ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+// ****************************************************************************
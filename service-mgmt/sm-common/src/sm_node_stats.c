@@ -6,28 +6,204 @@
 #include "sm_node_stats.h"
 
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
 
 #include "sm_limits.h"
 #include "sm_types.h"
 #include "sm_debug.h"
 
-#define SM_NODE_STATS_PROC_STAT         "/proc/stat"
-#define SM_NODE_STATS_PROC_MEMINFO      "/proc/meminfo"
-#define SM_NODE_STATS_PROC_DISKSTATS    "/proc/diskstats"
-#define SM_NODE_STATS_PROC_NET_DEV      "/proc/net/dev"
+#define SM_NODE_STATS_PROC_DIR          "/proc"
+#define SM_NODE_STATS_PROC_STAT         "stat"
+#define SM_NODE_STATS_PROC_MEMINFO      "meminfo"
+#define SM_NODE_STATS_PROC_DISKSTATS    "diskstats"
+#define SM_NODE_STATS_PROC_NET_DEV      "net/dev"
+#define SM_NODE_STATS_BUFFER_SIZE       4096
+#define SM_NODE_STATS_PROC_DIR_MAX_LEN   256
+
+typedef enum
+{
+    SM_NODE_STATS_FILE_STAT,
+    SM_NODE_STATS_FILE_MEMINFO,
+    SM_NODE_STATS_FILE_DISKSTATS,
+    SM_NODE_STATS_FILE_NET_DEV,
+    SM_NODE_STATS_FILE_MAX
+} SmNodeStatsFileIdT;
+
+typedef struct
+{
+    char* data;
+    size_t size;
+} SmNodeStatsBufferT;
+
+typedef struct
+{
+    const char* name;
+    int fd;
+    SmNodeStatsBufferT buffer;
+} SmNodeStatsFileT;
+
+typedef struct
+{
+    bool inuse;
+    int pid;
+    unsigned long long start_time;
+    int stat_fd;
+    int sched_fd;
+    int io_fd;
+    unsigned long last_used;
+} SmNodeStatsProcessT;
 
 static long _user_hz = 0;
+static long _page_size = 0;
+static char _proc_dir[SM_NODE_STATS_PROC_DIR_MAX_LEN] = SM_NODE_STATS_PROC_DIR;
+static SmNodeStatsFileT _files[SM_NODE_STATS_FILE_MAX] =
+{
+    { SM_NODE_STATS_PROC_STAT,      -1, { NULL, 0 } },
+    { SM_NODE_STATS_PROC_MEMINFO,   -1, { NULL, 0 } },
+    { SM_NODE_STATS_PROC_DISKSTATS, -1, { NULL, 0 } },
+    { SM_NODE_STATS_PROC_NET_DEV,   -1, { NULL, 0 } },
+};
+static SmNodeStatsProcessT _processes[SM_NODE_STATS_PROCESS_MAX];
+static SmNodeStatsBufferT _process_buffer;
+static unsigned long _process_lookups = 0;
+
+// ****************************************************************************
+// Node Statistics - Read
+// ======================
+// Reads the whole file from offset zero into the buffer, the buffer is
+// kept and grown as needed.  Returns the length read or -1.
+static ssize_t sm_node_stats_read( int fd, SmNodeStatsBufferT* buffer )
+{
+    size_t len = 0;
+    ssize_t result;
+
+    while( true )
+    {
+        if( buffer->size <= len + 1 )
+        {
+            size_t size = buffer->size ? buffer->size * 2
+                                       : SM_NODE_STATS_BUFFER_SIZE;
+            char* data = (char*) realloc( buffer->data, size );
+            if( NULL == data )
+            {
+                DPRINTFE( "Failed to grow stats buffer to %zu bytes.", size );
+                return( -1 );
+            }
+
+            buffer->data = data;
+            buffer->size = size;
+        }
+
+        result = pread( fd, buffer->data + len, buffer->size - len - 1, len );
+        if( 0 > result )
+        {
+            if( EINTR == errno )
+            {
+                continue;
+            }
+            return( -1 );
+        }
+
+        if( 0 == result )
+        {
+            break;
+        }
+
+        len += result;
+    }
+
+    buffer->data[len] = '\0';
+
+    return( len );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics - Open
+// ======================
+static int sm_node_stats_open( const char name[] )
+{
+    char filename[SM_NODE_STATS_PROC_DIR_MAX_LEN*2];
+
+    snprintf( filename, sizeof(filename), "%s/%s", _proc_dir, name );
+
+    return( open( filename, O_RDONLY | O_CLOEXEC ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics - Read File
+// ===========================
+// The file is opened once and read again from offset zero on each sample.
+static char* sm_node_stats_read_file( SmNodeStatsFileIdT file_id )
+{
+    SmNodeStatsFileT* file = &(_files[file_id]);
+
+    if( 0 > file->fd )
+    {
+        file->fd = sm_node_stats_open( file->name );
+        if( 0 > file->fd )
+        {
+            DPRINTFE( "Failed to open %s/%s, error=%s.", _proc_dir,
+                      file->name, strerror(errno) );
+            return( NULL );
+        }
+    }
+
+    if( 0 > sm_node_stats_read( file->fd, &(file->buffer) ) )
+    {
+        DPRINTFE( "Failed to read %s/%s, error=%s.", _proc_dir, file->name,
+                  strerror(errno) );
+        close( file->fd );
+        file->fd = -1;
+        return( NULL );
+    }
+
+    return( file->buffer.data );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics - Next Line
+// ===========================
+// Terminates the line at the cursor and moves the cursor past it.
+static char* sm_node_stats_next_line( char** cursor )
+{
+    char* line = *cursor;
+    char* eol;
+
+    if( '\0' == *line )
+    {
+        return( NULL );
+    }
+
+    eol = strchr( line, '\n' );
+    if( NULL == eol )
+    {
+        *cursor = line + strlen( line );
+    } else {
+        *eol = '\0';
+        *cursor = eol + 1;
+    }
+
+    return( line );
+}
+// ****************************************************************************
 
 // ****************************************************************************
 // Node Statistics - Get CPU
 // =========================
 SmErrorT sm_node_stats_get_cpu( const char cpu_name[], SmNodeCpuStatsT* stats )
 {
-    char line[512];
-    FILE* fp;
+    size_t cpu_name_len;
+    char* cursor;
+    char* line;
 
     memset( stats, 0, sizeof(SmNodeCpuStatsT) );
 
@@ -40,24 +216,28 @@ SmErrorT sm_node_stats_get_cpu( const char cpu_name[], SmNodeCpuStatsT* stats )
     if( '\0' == cpu_name[0] )
     {
         snprintf( stats->cpu_name, sizeof(stats->cpu_name), "all" );
+        cpu_name = "cpu";
     } else {
         snprintf( stats->cpu_name, sizeof(stats->cpu_name), "%s", cpu_name );
     }
 
-    fp = fopen( SM_NODE_STATS_PROC_STAT, "r" );
-    if( NULL == fp )
+    cpu_name_len = strlen( cpu_name );
+
+    cursor = sm_node_stats_read_file( SM_NODE_STATS_FILE_STAT );
+    if( NULL == cursor )
     {
         DPRINTFE( "Failed to get cpu statistics from %s.",
                   SM_NODE_STATS_PROC_STAT );
         return( SM_NOT_FOUND );
     }
 
-    while( NULL != fgets( line, sizeof(line), fp ) )
+    while( NULL != (line = sm_node_stats_next_line( &cursor )) )
     {
-        if((( '\0' == cpu_name[0] )&&( 0 == strncmp( line, "cpu ", 4 ) ))||
-           ( 0 == strncmp( line, cpu_name, 4 ) )) 
+        if(( 0 == strncmp( line, cpu_name, cpu_name_len ) )&&
+           ( ' ' == line[cpu_name_len] ))
         {
-            sscanf( line+5, "%llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
+            sscanf( line+cpu_name_len+1,
+                    "%llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
                     &(stats->user_cpu_usage),
                     &(stats->nice_cpu_usage),
                     &(stats->system_cpu_usage),
@@ -89,8 +269,6 @@ SmErrorT sm_node_stats_get_cpu( const char cpu_name[], SmNodeCpuStatsT* stats )
         }
     }
 
-    fclose( fp );
-
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -100,20 +278,20 @@ SmErrorT sm_node_stats_get_cpu( const char cpu_name[], SmNodeCpuStatsT* stats )
 // ============================
 SmErrorT sm_node_stats_get_memory( SmNodeMemStatsT* stats )
 {
-    char line[512];
-    FILE* fp;
+    char* cursor;
+    char* line;
 
     memset( stats, 0, sizeof(SmNodeMemStatsT) );
 
-    fp = fopen( SM_NODE_STATS_PROC_MEMINFO, "r" );
-    if( NULL == fp )
+    cursor = sm_node_stats_read_file( SM_NODE_STATS_FILE_MEMINFO );
+    if( NULL == cursor )
     {
         DPRINTFE( "Failed to get memory statistics from %s.",
                   SM_NODE_STATS_PROC_MEMINFO );
         return( SM_NOT_FOUND );
     }
 
-    while( NULL != fgets( line, sizeof(line), fp ) )
+    while( NULL != (line = sm_node_stats_next_line( &cursor )) )
     {
         if( 0 == strncmp( line, "MemTotal:", 9 ) )
         {
@@ -163,50 +341,65 @@ SmErrorT sm_node_stats_get_memory( SmNodeMemStatsT* stats )
         }
     }
 
-    fclose( fp );
-
     return( SM_OKAY );
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Node Statistics - Parse Disk
+// ============================
+static bool sm_node_stats_parse_disk( const char line[],
+    SmNodeDiskStatsT* stats )
+{
+    int n_scanned;
+
+    n_scanned = sscanf( line, "%u %u %127s "
+                        "%lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu",
+                        &(stats->major_num), &(stats->minor_num),
+                        stats->dev_name,
+                        &(stats->reads_completed),
+                        &(stats->reads_merged),
+                        &(stats->sectors_read),
+                        &(stats->ms_spent_reading),
+                        &(stats->writes_completed),
+                        &(stats->writes_merged),
+                        &(stats->sectors_written),
+                        &(stats->ms_spent_writing),
+                        &(stats->io_inprogress),
+                        &(stats->ms_spent_io),
+                        &(stats->weighted_ms_spent_io) );
+    if( 14 != n_scanned )
+    {
+        memset( stats, 0, sizeof(SmNodeDiskStatsT) );
+        return( false );
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Node Statistics - Get Disk
 // ==========================
 SmErrorT sm_node_stats_get_disk( const char dev_name[],
     SmNodeDiskStatsT* stats )
 {
-    int n_scanned;
-    char line[512];
-    FILE* fp;
+    char* cursor;
+    char* line;
 
     memset( stats, 0, sizeof(SmNodeDiskStatsT) );
 
-    fp = fopen( SM_NODE_STATS_PROC_DISKSTATS, "r" );
-    if( NULL == fp )
+    cursor = sm_node_stats_read_file( SM_NODE_STATS_FILE_DISKSTATS );
+    if( NULL == cursor )
     {
         DPRINTFE( "Failed to get disk statistics for %s from %s.",
                   dev_name, SM_NODE_STATS_PROC_DISKSTATS );
         return( SM_NOT_FOUND );
     }
 
-    while( NULL != fgets( line, sizeof(line), fp ) )
-    {
-        n_scanned = sscanf( line, "%u %u %s "
-                            "%lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu",
-                            &(stats->major_num), &(stats->minor_num),
-                            stats->dev_name,
-                            &(stats->reads_completed),
-                            &(stats->reads_merged),
-                            &(stats->sectors_read),
-                            &(stats->ms_spent_reading),
-                            &(stats->writes_completed),
-                            &(stats->writes_merged),
-                            &(stats->sectors_written),
-                            &(stats->ms_spent_writing),
-                            &(stats->io_inprogress),
-                            &(stats->ms_spent_io),
-                            &(stats->weighted_ms_spent_io) );
-        if( 14 == n_scanned )
+    while( NULL != (line = sm_node_stats_next_line( &cursor )) )
+    {
+        if( sm_node_stats_parse_disk( line, stats ) )
         {
             if( 0 == strcmp( dev_name, stats->dev_name ) )
             {
@@ -218,8 +411,6 @@ SmErrorT sm_node_stats_get_disk( const char dev_name[],
         memset( stats, 0, sizeof(SmNodeDiskStatsT) );
     }
 
-    fclose( fp );
-
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -231,51 +422,141 @@ SmErrorT sm_node_stats_get_disk_by_index( unsigned int index,
     SmNodeDiskStatsT* stats )
 {
     unsigned int current_index = 0;
-    int n_scanned;
-    char line[512];
-    FILE* fp;
+    char* cursor;
+    char* line;
 
     memset( stats, 0, sizeof(SmNodeDiskStatsT) );
 
-    fp = fopen( SM_NODE_STATS_PROC_DISKSTATS, "r" );
-    if( NULL == fp )
+    cursor = sm_node_stats_read_file( SM_NODE_STATS_FILE_DISKSTATS );
+    if( NULL == cursor )
     {
         DPRINTFE( "Failed to get disk statistics from %s.",
                   SM_NODE_STATS_PROC_DISKSTATS );
         return( SM_NOT_FOUND );
     }
 
-    while( NULL != fgets( line, sizeof(line), fp ) )
+    while( NULL != (line = sm_node_stats_next_line( &cursor )) )
     {
         if( current_index == index )
         {
-            n_scanned = sscanf( line, "%u %u %s "
-                                "%lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu",
-                                &(stats->major_num), &(stats->minor_num),
-                                stats->dev_name,
-                                &(stats->reads_completed),
-                                &(stats->reads_merged),
-                                &(stats->sectors_read),
-                                &(stats->ms_spent_reading),
-                                &(stats->writes_completed),
-                                &(stats->writes_merged),
-                                &(stats->sectors_written),
-                                &(stats->ms_spent_writing),
-                                &(stats->io_inprogress),
-                                &(stats->ms_spent_io),
-                                &(stats->weighted_ms_spent_io) );
-            if( 14 == n_scanned )
-            {
-                break;
-            }
-
-            memset( stats, 0, sizeof(SmNodeDiskStatsT) );
+            sm_node_stats_parse_disk( line, stats );
+            break;
         }
 
         ++current_index;
     }
 
-    fclose( fp );
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics - Get Disks
+// ===========================
+SmErrorT sm_node_stats_get_disks( SmNodeDiskStatsT stats[],
+    unsigned int max_disks, unsigned int* num_disks )
+{
+    char* cursor;
+    char* line;
+
+    *num_disks = 0;
+
+    cursor = sm_node_stats_read_file( SM_NODE_STATS_FILE_DISKSTATS );
+    if( NULL == cursor )
+    {
+        DPRINTFE( "Failed to get disk statistics from %s.",
+                  SM_NODE_STATS_PROC_DISKSTATS );
+        return( SM_NOT_FOUND );
+    }
+
+    while( NULL != (line = sm_node_stats_next_line( &cursor )) )
+    {
+        if( max_disks <= *num_disks )
+        {
+            DPRINTFD( "More than %u disks, remaining disks skipped.",
+                      max_disks );
+            break;
+        }
+
+        if( sm_node_stats_parse_disk( line, &(stats[*num_disks]) ) )
+        {
+            ++(*num_disks);
+        }
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics - Get Network Devices
+// =====================================
+SmErrorT sm_node_stats_get_netdevs( SmNodeNetDevStatsT stats[],
+    unsigned int num_devs )
+{
+    char* cursor;
+    char* line;
+    char* colon;
+
+    unsigned int dev_i;
+    for( dev_i=0; num_devs > dev_i; ++dev_i )
+    {
+        char dev_name[SM_NODE_STATS_NET_DEV_NAME_MAX_LEN];
+
+        memcpy( dev_name, stats[dev_i].dev_name, sizeof(dev_name) );
+        memset( &(stats[dev_i]), 0, sizeof(SmNodeNetDevStatsT) );
+        memcpy( stats[dev_i].dev_name, dev_name, sizeof(dev_name) );
+    }
+
+    cursor = sm_node_stats_read_file( SM_NODE_STATS_FILE_NET_DEV );
+    if( NULL == cursor )
+    {
+        DPRINTFE( "Failed to get network device statistics from %s.",
+                  SM_NODE_STATS_PROC_NET_DEV );
+        return( SM_NOT_FOUND );
+    }
+
+    while( NULL != (line = sm_node_stats_next_line( &cursor )) )
+    {
+        colon = strchr( line, ':' );
+        if( NULL == colon )
+        {
+            continue;
+        }
+
+        *colon = '\0';
+        line += strspn( line, " " );
+
+        for( dev_i=0; num_devs > dev_i; ++dev_i )
+        {
+            SmNodeNetDevStatsT* dev_stats = &(stats[dev_i]);
+
+            if( 0 != strcmp( line, dev_stats->dev_name ) )
+            {
+                continue;
+            }
+
+            sscanf( colon+1,
+                    "%llu %llu %llu %llu %llu %llu %llu %llu "
+                    "%llu %llu %llu %llu %llu %llu %llu %llu",
+                    &(dev_stats->rx_bytes),
+                    &(dev_stats->rx_packets),
+                    &(dev_stats->rx_errors),
+                    &(dev_stats->rx_dropped),
+                    &(dev_stats->rx_fifo_errors),
+                    &(dev_stats->rx_frame_errors),
+                    &(dev_stats->rx_compressed_packets),
+                    &(dev_stats->rx_multicast_frames),
+                    &(dev_stats->tx_bytes),
+                    &(dev_stats->tx_packets),
+                    &(dev_stats->tx_errors),
+                    &(dev_stats->tx_dropped),
+                    &(dev_stats->tx_fifo_errors),
+                    &(dev_stats->tx_collisions),
+                    &(dev_stats->tx_carrier_loss),
+                    &(dev_stats->tx_compressed_packets) );
+        }
+    }
 
     return( SM_OKAY );
 }
@@ -287,58 +568,186 @@ SmErrorT sm_node_stats_get_disk_by_index( unsigned int index,
 SmErrorT sm_node_stats_get_netdev( const char dev_name[],
     SmNodeNetDevStatsT* stats )
 {
-    int stats_start = 0;
-    char line[512];
-    char if_name[512];
-    char dev_name_with_colon[512];
-    FILE* fp;
+    snprintf( stats->dev_name, sizeof(stats->dev_name), "%s", dev_name );
 
-    memset( stats, 0, sizeof(SmNodeNetDevStatsT) );
+    return( sm_node_stats_get_netdevs( stats, 1 ) );
+}
+// ****************************************************************************
 
-    snprintf( stats->dev_name, sizeof(stats->dev_name), "%s", dev_name );
+// ****************************************************************************
+// Node Statistics - Process Close
+// ===============================
+static void sm_node_stats_process_close( SmNodeStatsProcessT* process )
+{
+    if(( process->inuse )&&( 0 <= process->stat_fd ))
+    {
+        close( process->stat_fd );
+    }
 
-    snprintf( dev_name_with_colon, sizeof(dev_name_with_colon), "%s:",
-              dev_name );
+    if(( process->inuse )&&( 0 <= process->sched_fd ))
+    {
+        close( process->sched_fd );
+    }
 
-    fp = fopen( SM_NODE_STATS_PROC_NET_DEV, "r" );
-    if( NULL == fp )
+    if(( process->inuse )&&( 0 <= process->io_fd ))
     {
-        DPRINTFE( "Failed to get network device statistics for %s from %s.",
-                  dev_name, SM_NODE_STATS_PROC_NET_DEV );
-        return( SM_NOT_FOUND );
+        close( process->io_fd );
     }
 
-    while( NULL != fgets( line, sizeof(line), fp ) )
+    memset( process, 0, sizeof(SmNodeStatsProcessT) );
+    process->stat_fd = -1;
+    process->sched_fd = -1;
+    process->io_fd = -1;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics - Process Open
+// ==============================
+// Uses the cached descriptors of the pid, or the least recently used
+// slot.  Descriptors of a process that exited fail to read, a pid that
+// is reused is told apart by its start time.  Only stat is opened here,
+// the other files are opened on first use.
+static SmNodeStatsProcessT* sm_node_stats_process_open( int pid )
+{
+    SmNodeStatsProcessT* process = NULL;
+    char name[64];
+
+    unsigned int process_i;
+    for( process_i=0; SM_NODE_STATS_PROCESS_MAX > process_i; ++process_i )
     {
-		stats_start = strcspn( line, ":" );
-        sscanf( line, "%s:", if_name );
-        if( 0 == strncmp( if_name, dev_name_with_colon, strlen(if_name) ) )
+        SmNodeStatsProcessT* entry = &(_processes[process_i]);
+
+        if(( entry->inuse )&&( pid == entry->pid ))
         {
-            sscanf( line+stats_start+2,
-                    "%llu %llu %llu %llu %llu %llu %llu %llu "
-                    "%llu %llu %llu %llu %llu %llu %llu %llu",
-                    &(stats->rx_bytes),
-                    &(stats->rx_packets),
-                    &(stats->rx_errors),
-                    &(stats->rx_dropped),
-                    &(stats->rx_fifo_errors),
-                    &(stats->rx_frame_errors),
-                    &(stats->rx_compressed_packets),
-                    &(stats->rx_multicast_frames),
-                    &(stats->tx_bytes),
-                    &(stats->tx_packets),
-                    &(stats->tx_errors),
-                    &(stats->tx_dropped),
-                    &(stats->tx_fifo_errors),
-                    &(stats->tx_collisions),
-                    &(stats->tx_carrier_loss),
-                    &(stats->tx_compressed_packets) );
+            process = entry;
+            break;
+        }
+
+        if(( NULL == process )||
+           (( process->inuse )&&
+            (( !entry->inuse )||( entry->last_used < process->last_used ))))
+        {
+            process = entry;
         }
     }
 
-    fclose( fp );
+    process->last_used = ++_process_lookups;
 
-    return( SM_OKAY );
+    if(( process->inuse )&&( pid == process->pid ))
+    {
+        return( process );
+    }
+
+    sm_node_stats_process_close( process );
+
+    process->inuse = true;
+    process->pid = pid;
+    process->last_used = _process_lookups;
+
+    snprintf( name, sizeof(name), "%i/stat", pid );
+    process->stat_fd = sm_node_stats_open( name );
+
+    if( 0 > process->stat_fd )
+    {
+        sm_node_stats_process_close( process );
+        return( NULL );
+    }
+
+    return( process );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics - Process Read Stat
+// ===================================
+static bool sm_node_stats_process_read_stat( SmNodeStatsProcessT* process,
+    SmNodeProcessStatusT* status )
+{
+    char* comm_start;
+    char* comm_end;
+    size_t comm_len;
+
+    if( 0 >= sm_node_stats_read( process->stat_fd, &_process_buffer ) )
+    {
+        return( false );
+    }
+
+    // The command name is in parentheses and can hold spaces.
+    comm_start = strchr( _process_buffer.data, '(' );
+    comm_end = strrchr( _process_buffer.data, ')' );
+    if(( NULL == comm_start )||( NULL == comm_end )||( comm_end < comm_start ))
+    {
+        return( false );
+    }
+
+    status->pid = atoi( _process_buffer.data );
+
+    comm_len = comm_end - comm_start - 1;
+    if( sizeof(status->name) <= comm_len )
+    {
+        comm_len = sizeof(status->name) - 1;
+    }
+    memcpy( status->name, comm_start+1, comm_len );
+    status->name[comm_len] = '\0';
+
+    if( 7 != sscanf( comm_end+1, " %c %d %d %*d %*d %*d %*u %*u %*u %*u %*u"
+                     " %llu %llu %*d %*d %*d %*d %*d %*d %llu %*u %llu",
+                     &(status->state), &(status->ppid), &(status->pgrp),
+                     &(status->user_time), &(status->system_time),
+                     &(status->start_time), &(status->rss_pages) ) )
+    {
+        return( false );
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics - Process Lookup
+// ================================
+// Returns the cache entry of the pid with its stat read, or NULL when the
+// process is gone.
+static SmNodeStatsProcessT* sm_node_stats_process_lookup( int pid,
+    SmNodeProcessStatusT* status )
+{
+    SmNodeStatsProcessT* process;
+
+    memset( status, 0, sizeof(SmNodeProcessStatusT) );
+
+    process = sm_node_stats_process_open( pid );
+    if( NULL == process )
+    {
+        // Could be a short lived process.
+        DPRINTFD( "Failed to get process (%i) status.", pid );
+        return( NULL );
+    }
+
+    if(( !sm_node_stats_process_read_stat( process, status ) )||
+       (( 0 != process->start_time )&&
+        ( status->start_time != process->start_time )))
+    {
+        // Exited, or the pid now belongs to another process.
+        sm_node_stats_process_close( process );
+
+        process = sm_node_stats_process_open( pid );
+        if(( NULL == process )||
+           ( !sm_node_stats_process_read_stat( process, status ) ))
+        {
+            DPRINTFD( "Failed to get process (%i) status.", pid );
+            if( NULL != process )
+            {
+                sm_node_stats_process_close( process );
+            }
+            memset( status, 0, sizeof(SmNodeProcessStatusT) );
+            return( NULL );
+        }
+    }
+
+    process->start_time = status->start_time;
+
+    return( process );
 }
 // ****************************************************************************
 
@@ -348,46 +757,37 @@ SmErrorT sm_node_stats_get_netdev( const char dev_name[],
 SmErrorT sm_node_stats_get_process_status( int pid,
     SmNodeProcessStatusT* status )
 {
+    SmNodeStatsProcessT* process;
     unsigned long long ms;
     unsigned long long ns;
-    char filename[80];
-    char line[512];
-    FILE* fp;
-
-    memset( status, 0, sizeof(SmNodeProcessStatusT) );
-
-    // Process Stat Information
-    snprintf( filename, sizeof(filename), "/proc/%i/stat", pid );
+    char name[64];
+    char* cursor;
+    char* line;
 
-    fp = fopen( filename, "r" );
-    if( NULL == fp )
+    process = sm_node_stats_process_lookup( pid, status );
+    if( NULL == process )
     {
-        // Could be a short lived process.
-        DPRINTFD( "Failed to get process (%i) status.", pid );
         return( SM_NOT_FOUND );
     }
 
-    while( NULL != fgets( line, sizeof(line), fp ) )
+    if( 0 > process->sched_fd )
     {
-        sscanf( line, "%d %s %c %d %d",
-                &(status->pid), status->name, &(status->state),
-                &(status->ppid), &(status->pgrp) );
+        snprintf( name, sizeof(name), "%i/sched", pid );
+        process->sched_fd = sm_node_stats_open( name );
     }
 
-    fclose( fp );
-
     // Process Scheduler Information
-    snprintf( filename, sizeof(filename), "/proc/%i/sched", pid );
-
-    fp = fopen( filename, "r" );
-    if( NULL == fp )
+    if(( 0 > process->sched_fd )||
+       ( 0 > sm_node_stats_read( process->sched_fd, &_process_buffer ) ))
     {
-        // Could be a short lived process.
         DPRINTFD( "Failed to get process (%i) status.", pid );
+        sm_node_stats_process_close( process );
         return( SM_NOT_FOUND );
     }
 
-    while( NULL != fgets( line, sizeof(line), fp ) )
+    cursor = _process_buffer.data;
+
+    while( NULL != (line = sm_node_stats_next_line( &cursor )) )
     {
         if( 0 == strncmp( "se.statistics.block_start", line, 25 ) )
         {
@@ -418,18 +818,105 @@ SmErrorT sm_node_stats_get_process_status( int pid,
         }
     }
 
-    fclose( fp );
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics - Get Process Usage
+// ===================================
+SmErrorT sm_node_stats_get_process_usage( int pid,
+    SmNodeProcessUsageT* usage )
+{
+    SmNodeProcessStatusT status;
+    SmNodeStatsProcessT* process;
+    struct dirent* dir_entry;
+    char name[SM_NODE_STATS_PROC_DIR_MAX_LEN+64];
+    char* cursor;
+    char* line;
+    DIR* dir;
+
+    memset( usage, 0, sizeof(SmNodeProcessUsageT) );
+
+    process = sm_node_stats_process_lookup( pid, &status );
+    if( NULL == process )
+    {
+        return( SM_NOT_FOUND );
+    }
+
+    usage->pid = pid;
+    usage->start_time = status.start_time;
+    usage->user_time_ms = status.user_time * 1000 / _user_hz;
+    usage->system_time_ms = status.system_time * 1000 / _user_hz;
+    usage->rss_kB = status.rss_pages * (_page_size / 1024);
+
+    // Process IO, only readable with ptrace access to the process.
+    if( 0 > process->io_fd )
+    {
+        snprintf( name, sizeof(name), "%i/io", pid );
+        process->io_fd = sm_node_stats_open( name );
+    }
+
+    if(( 0 <= process->io_fd )&&
+       ( 0 < sm_node_stats_read( process->io_fd, &_process_buffer ) ))
+    {
+        cursor = _process_buffer.data;
+
+        while( NULL != (line = sm_node_stats_next_line( &cursor )) )
+        {
+            if( 0 == strncmp( "read_bytes:", line, 11 ) )
+            {
+                sscanf( line+11, "%llu", &(usage->read_bytes) );
+
+            } else if( 0 == strncmp( "write_bytes:", line, 12 ) ) {
+                sscanf( line+12, "%llu", &(usage->write_bytes) );
+            }
+        }
+    }
+
+    // Open file descriptors, the directory is listed fresh on each open.
+    snprintf( name, sizeof(name), "%s/%i/fd", _proc_dir, pid );
+
+    dir = opendir( name );
+    if( NULL != dir )
+    {
+        while( NULL != (dir_entry = readdir( dir )) )
+        {
+            if( '.' != dir_entry->d_name[0] )
+            {
+                ++(usage->num_fds);
+            }
+        }
+
+        closedir( dir );
+    }
 
     return( SM_OKAY );
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Node Statistics - Set Proc Directory
+// ====================================
+void sm_node_stats_set_proc_dir( const char proc_dir[] )
+{
+    snprintf( _proc_dir, sizeof(_proc_dir), "%s", proc_dir );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Node Statistics - Initialize
 // ============================
 SmErrorT sm_node_stats_initialize( void )
 {
+    unsigned int process_i;
+    for( process_i=0; SM_NODE_STATS_PROCESS_MAX > process_i; ++process_i )
+    {
+        sm_node_stats_process_close( &(_processes[process_i]) );
+    }
+
     _user_hz = sysconf(_SC_CLK_TCK);
+    _page_size = sysconf(_SC_PAGESIZE);
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -440,6 +927,33 @@ SmErrorT sm_node_stats_initialize( void )
 SmErrorT sm_node_stats_finalize( void )
 {
     _user_hz = 0;
+
+    unsigned int file_i;
+    for( file_i=0; SM_NODE_STATS_FILE_MAX > file_i; ++file_i )
+    {
+        SmNodeStatsFileT* file = &(_files[file_i]);
+
+        if( 0 <= file->fd )
+        {
+            close( file->fd );
+            file->fd = -1;
+        }
+
+        free( file->buffer.data );
+        file->buffer.data = NULL;
+        file->buffer.size = 0;
+    }
+
+    unsigned int process_i;
+    for( process_i=0; SM_NODE_STATS_PROCESS_MAX > process_i; ++process_i )
+    {
+        sm_node_stats_process_close( &(_processes[process_i]) );
+    }
+
+    free( _process_buffer.data );
+    _process_buffer.data = NULL;
+    _process_buffer.size = 0;
+
     return( SM_OKAY );
 }
 // ****************************************************************************
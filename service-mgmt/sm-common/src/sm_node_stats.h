@@ -19,6 +19,7 @@ extern "C" {
 #define SM_NODE_STATS_NET_DEV_NAME_MAX_LEN      128
 #define SM_NODE_STATS_PROCESS_NAME_MAX_LEN      128
 #define SM_NODE_STATS_PROCESS_STATE_MAX_LEN      32
+#define SM_NODE_STATS_PROCESS_MAX               128
 
 typedef struct
 {
@@ -113,6 +114,10 @@ typedef struct
     char state; // RSDZTW
     int ppid;
     int pgrp;
+    unsigned long long start_time; // clock ticks since boot
+    unsigned long long user_time;   // clock ticks
+    unsigned long long system_time; // clock ticks
+    unsigned long long rss_pages;
 
     unsigned long long block_start_ns;
     unsigned long long nr_switches;
@@ -120,6 +125,22 @@ typedef struct
     unsigned long long nr_involuntary_switches;
 } SmNodeProcessStatusT;
 
+typedef struct
+{
+    int pid;
+    unsigned long long start_time; // clock ticks since boot
+    unsigned long long user_time_ms;
+    unsigned long long system_time_ms;
+    unsigned long long rss_kB;
+    unsigned long long read_bytes;  // storage io, zero when not permitted
+    unsigned long long write_bytes; // storage io, zero when not permitted
+    unsigned int num_fds;
+} SmNodeProcessUsageT;
+
+// The /proc files are kept open and read again from the start on each
+// sample, into buffers that are kept between samples, so the functions
+// below are for use from a single thread.
+
 // ****************************************************************************
 // Node Statistics - Get CPU
 // =========================
@@ -147,6 +168,14 @@ extern SmErrorT sm_node_stats_get_disk_by_index( unsigned int index,
     SmNodeDiskStatsT* stats );
 // ****************************************************************************
 
+// ****************************************************************************
+// Node Statistics - Get Disks
+// ===========================
+// Reads up to max_disks disks in one pass.
+extern SmErrorT sm_node_stats_get_disks( SmNodeDiskStatsT stats[],
+    unsigned int max_disks, unsigned int* num_disks );
+// ****************************************************************************
+
 // ****************************************************************************
 // Node Statistics - Get Network Device
 // ====================================
@@ -154,13 +183,41 @@ extern SmErrorT sm_node_stats_get_netdev( const char dev_name[],
     SmNodeNetDevStatsT* stats );
 // ****************************************************************************
 
+// ****************************************************************************
+// Node Statistics - Get Network Devices
+// =====================================
+// Reads the devices named in stats[].dev_name in one pass, devices that
+// are not found are left zeroed.
+extern SmErrorT sm_node_stats_get_netdevs( SmNodeNetDevStatsT stats[],
+    unsigned int num_devs );
+// ****************************************************************************
+
 // ****************************************************************************
 // Node Statistics - Get Process Status
 // ====================================
+// Keeps the /proc/<pid> files of up to SM_NODE_STATS_PROCESS_MAX processes
+// open, keyed by pid and start time.
 extern SmErrorT sm_node_stats_get_process_status( int pid,
     SmNodeProcessStatusT* status );
 // ****************************************************************************
 
+// ****************************************************************************
+// Node Statistics - Get Process Usage
+// ===================================
+// Resource use of the process, through the same cache of open files as
+// the process status.
+extern SmErrorT sm_node_stats_get_process_usage( int pid,
+    SmNodeProcessUsageT* usage );
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics - Set Proc Directory
+// ====================================
+// Reads the statistics from a copy of /proc, used by the benchmark.  Set
+// before the first sample.
+extern void sm_node_stats_set_proc_dir( const char proc_dir[] );
+// ****************************************************************************
+
 // ****************************************************************************
 // Node Statistics - Initialize
 // ============================
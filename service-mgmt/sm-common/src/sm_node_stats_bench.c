@@ -0,0 +1,560 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Measures the cpu used per ERU sampling cycle against a generated copy of
+// /proc with a given number of block devices.  The statistics read back are
+// first checked against the generated values, in one pass and by index,
+// and again after the files kept open are rewritten.  Exits non-zero when
+// they do not match.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_node_stats.h"
+
+#define SM_NODE_STATS_BENCH_CYCLES                                    1000
+#define SM_NODE_STATS_BENCH_DISKS_MAX                                 1024
+#define SM_NODE_STATS_BENCH_CPUS                                        16
+#define SM_NODE_STATS_BENCH_INTERFACES                                   4
+#define SM_NODE_STATS_BENCH_READS                                   180293
+#define SM_NODE_STATS_BENCH_REWRITE_READS                          5000000
+
+static struct option _sm_node_stats_bench_long_options[] =
+{
+    { "cycles", required_argument, NULL, 'c'},
+    { "disks",  required_argument, NULL, 'd'},
+    { "help",   no_argument,       NULL, 'h'},
+    {0, 0, 0, 0}
+};
+
+static SmNodeDiskStatsT _disk_stats[SM_NODE_STATS_BENCH_DISKS_MAX];
+static SmNodeNetDevStatsT _net_stats[SM_NODE_STATS_BENCH_INTERFACES];
+
+// ****************************************************************************
+// Node Statistics Benchmark - Usage
+// =================================
+static void usage( void )
+{
+    printf( " usage:\n"
+            "   sm-node-stats-bench [--cycles <number>] [--disks <number>]\n"
+            "                       [--help]\n"
+            "       --cycles : sampling cycles to run per disk count\n"
+            "       --disks  : block devices to generate, can be repeated,\n"
+            "                  defaults to 4, 64 and 256\n"
+            "       --help   : print out this help message\n"
+            "\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics Benchmark - Open
+// ================================
+static FILE* sm_node_stats_bench_open( const char dir[], const char name[] )
+{
+    char filename[512];
+    FILE* fp;
+
+    snprintf( filename, sizeof(filename), "%s/%s", dir, name );
+
+    fp = fopen( filename, "w" );
+    if( NULL == fp )
+    {
+        printf( "Failed to create %s, error=%s.\n", filename,
+                strerror(errno) );
+    }
+
+    return( fp );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics Benchmark - Generate Disks
+// ==========================================
+// Each disk has completed reads plus its index reads.
+static SmErrorT sm_node_stats_bench_generate_disks( const char dir[],
+    unsigned int num_disks, unsigned int reads )
+{
+    FILE* fp;
+
+    fp = sm_node_stats_bench_open( dir, "diskstats" );
+    if( NULL == fp )
+    {
+        return( SM_FAILED );
+    }
+
+    unsigned int disk_i;
+    for( disk_i=0; num_disks > disk_i; ++disk_i )
+    {
+        fprintf( fp, " 259 %7u nvme%un1 %u 1180 3377298 %u 1226428 2093399 "
+                 "121958456 1193617 0 846692 2567262 0 0 0 0 63740 184127\n",
+                 disk_i, disk_i, reads + disk_i, 31843 + disk_i );
+    }
+    fclose( fp );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics Benchmark - Generate
+// ====================================
+static SmErrorT sm_node_stats_bench_generate( const char dir[],
+    unsigned int num_disks )
+{
+    char net_dir[512];
+    SmErrorT error;
+    FILE* fp;
+
+    fp = sm_node_stats_bench_open( dir, "stat" );
+    if( NULL == fp )
+    {
+        return( SM_FAILED );
+    }
+
+    fprintf( fp, "cpu  2255 34 2290 22625563 6290 127 456 0 0 0\n" );
+
+    unsigned int cpu_i;
+    for( cpu_i=0; SM_NODE_STATS_BENCH_CPUS > cpu_i; ++cpu_i )
+    {
+        fprintf( fp, "cpu%u 1132 34 1441 11311718 3675 127 438 0 0 0\n",
+                 cpu_i );
+    }
+
+    fprintf( fp, "intr 114930548 113199788 3 0 5 263 0 4 [...]\n"
+                 "ctxt 1990473\nbtime 1062191376\nprocesses 2915\n"
+                 "procs_running 1\nprocs_blocked 0\n" );
+    fclose( fp );
+
+    fp = sm_node_stats_bench_open( dir, "meminfo" );
+    if( NULL == fp )
+    {
+        return( SM_FAILED );
+    }
+
+    fprintf( fp, "MemTotal:       16303084 kB\nMemFree:         8110124 kB\n"
+                 "MemAvailable:   12093880 kB\nBuffers:          310140 kB\n"
+                 "Cached:          3751268 kB\nSwapCached:            0 kB\n"
+                 "Active:          4339832 kB\nInactive:        2870820 kB\n"
+                 "SwapTotal:             0 kB\nSwapFree:              0 kB\n"
+                 "Dirty:               572 kB\nNFS_Unstable:          0 kB\n"
+                 "Committed_AS:    9153012 kB\nHugePages_Total:       0\n"
+                 "HugePages_Free:        0\nHugepagesize:       2048 kB\n" );
+    fclose( fp );
+
+    error = sm_node_stats_bench_generate_disks( dir, num_disks,
+                                                SM_NODE_STATS_BENCH_READS );
+    if( SM_OKAY != error )
+    {
+        return( error );
+    }
+
+    snprintf( net_dir, sizeof(net_dir), "%s/net", dir );
+    if(( 0 > mkdir( net_dir, 0755 ) )&&( EEXIST != errno ))
+    {
+        printf( "Failed to create %s, error=%s.\n", net_dir, strerror(errno) );
+        return( SM_FAILED );
+    }
+
+    fp = sm_node_stats_bench_open( dir, "net/dev" );
+    if( NULL == fp )
+    {
+        return( SM_FAILED );
+    }
+
+    fprintf( fp, "Inter-|   Receive                                      "
+                 "          |  Transmit\n"
+                 " face |bytes    packets errs drop fifo frame compressed "
+                 "multicast|bytes    packets errs drop fifo colls carrier "
+                 "compressed\n" );
+
+    unsigned int if_i;
+    for( if_i=0; SM_NODE_STATS_BENCH_INTERFACES*2 > if_i; ++if_i )
+    {
+        fprintf( fp, "  eth%u: 169294721   15598    0    0    0     0"
+                 "          0         0 169294721   15598    0    0    0"
+                 "     0       0          0\n", if_i );
+    }
+    fclose( fp );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics Benchmark - Remove
+// ==================================
+static void sm_node_stats_bench_remove( const char dir[] )
+{
+    const char* names[] = { "stat", "meminfo", "diskstats", "net/dev", "net" };
+    char filename[512];
+
+    unsigned int name_i;
+    for( name_i=0; sizeof(names)/sizeof(names[0]) > name_i; ++name_i )
+    {
+        snprintf( filename, sizeof(filename), "%s/%s", dir, names[name_i] );
+        remove( filename );
+    }
+
+    rmdir( dir );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics Benchmark - CPU Time
+// ====================================
+static double sm_node_stats_bench_cpu_us( void )
+{
+    struct rusage usage;
+
+    getrusage( RUSAGE_SELF, &usage );
+
+    return( (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000.0
+            + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics Benchmark - Cycle
+// =================================
+// One sampling cycle as done by the ERU, the disks are either read in one
+// pass or one index at a time.
+static void sm_node_stats_bench_cycle( bool by_index, unsigned int num_disks )
+{
+    SmNodeCpuStatsT cpu_stats;
+    SmNodeMemStatsT mem_stats;
+    unsigned int disks_read;
+
+    sm_node_stats_get_cpu( "", &cpu_stats );
+    sm_node_stats_get_memory( &mem_stats );
+
+    if( by_index )
+    {
+        unsigned int disk_i;
+        for( disk_i=0; num_disks > disk_i; ++disk_i )
+        {
+            sm_node_stats_get_disk_by_index( disk_i, &(_disk_stats[disk_i]) );
+        }
+    } else {
+        sm_node_stats_get_disks( _disk_stats, SM_NODE_STATS_BENCH_DISKS_MAX,
+                                 &disks_read );
+    }
+
+    unsigned int if_i;
+    for( if_i=0; SM_NODE_STATS_BENCH_INTERFACES > if_i; ++if_i )
+    {
+        snprintf( _net_stats[if_i].dev_name, sizeof(_net_stats[if_i].dev_name),
+                  "eth%u", if_i );
+    }
+
+    sm_node_stats_get_netdevs( _net_stats, SM_NODE_STATS_BENCH_INTERFACES );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics Benchmark - Check Disks
+// =======================================
+static bool sm_node_stats_bench_check_disks( unsigned int num_disks,
+    unsigned int reads )
+{
+    SmNodeDiskStatsT by_index;
+    char dev_name[SM_NODE_STATS_DEV_NAME_MAX_LEN];
+    unsigned int disks_read = 0;
+
+    sm_node_stats_get_disks( _disk_stats, SM_NODE_STATS_BENCH_DISKS_MAX,
+                             &disks_read );
+    if( num_disks != disks_read )
+    {
+        printf( "Read %u disks in one pass, expected %u.\n", disks_read,
+                num_disks );
+        return( false );
+    }
+
+    unsigned int disk_i;
+    for( disk_i=0; num_disks > disk_i; ++disk_i )
+    {
+        SmNodeDiskStatsT* disk = &(_disk_stats[disk_i]);
+
+        snprintf( dev_name, sizeof(dev_name), "nvme%un1", disk_i );
+
+        if(( 259 != disk->major_num )||( disk_i != disk->minor_num )||
+           ( 0 != strcmp( dev_name, disk->dev_name ) )||
+           ( reads + disk_i != disk->reads_completed )||
+           ( 31843 + disk_i != disk->ms_spent_reading )||
+           ( 121958456 != disk->sectors_written )||
+           ( 2567262 != disk->weighted_ms_spent_io ))
+        {
+            printf( "Disk %u read in one pass as (%s), reads=%lu.\n", disk_i,
+                    disk->dev_name, disk->reads_completed );
+            return( false );
+        }
+
+        sm_node_stats_get_disk_by_index( disk_i, &by_index );
+        if( 0 != memcmp( disk, &by_index, sizeof(by_index) ) )
+        {
+            printf( "Disk %u read by index as (%s), reads=%lu, does not "
+                    "match the one pass.\n", disk_i, by_index.dev_name,
+                    by_index.reads_completed );
+            return( false );
+        }
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics Benchmark - Check
+// =================================
+// Reads the generated copy of /proc back, then rewrites the disks under
+// the files kept open and reads them again.
+static bool sm_node_stats_bench_check( const char dir[],
+    unsigned int num_disks )
+{
+    SmNodeCpuStatsT cpu_stats;
+    SmNodeMemStatsT mem_stats;
+
+    sm_node_stats_get_cpu( "", &cpu_stats );
+    if(( 2255 != cpu_stats.user_cpu_usage )||
+       ( 22625563 != cpu_stats.idle_task_cpu_usage )||
+       ( 456 != cpu_stats.soft_irq_cpu_usage )||
+       ( 114930548 != cpu_stats.total_interrupts )||
+       ( 1990473 != cpu_stats.total_context_switches )||
+       ( 2915 != cpu_stats.total_processes )||
+       ( 1062191376 != cpu_stats.boot_time_in_secs ))
+    {
+        printf( "Cpu totals read as user=%llu, idle=%llu, ctxt=%llu.\n",
+                cpu_stats.user_cpu_usage, cpu_stats.idle_task_cpu_usage,
+                cpu_stats.total_context_switches );
+        return( false );
+    }
+
+    sm_node_stats_get_cpu( "cpu3", &cpu_stats );
+    if(( 1132 != cpu_stats.user_cpu_usage )||
+       ( 11311718 != cpu_stats.idle_task_cpu_usage ))
+    {
+        printf( "Cpu3 read as user=%llu, idle=%llu.\n",
+                cpu_stats.user_cpu_usage, cpu_stats.idle_task_cpu_usage );
+        return( false );
+    }
+
+    sm_node_stats_get_memory( &mem_stats );
+    if(( 16303084 != mem_stats.total_memory_kB )||
+       ( 8110124 != mem_stats.free_memory_kB )||
+       ( 3751268 != mem_stats.cached_kB )||
+       ( 9153012 != mem_stats.commited_memory_kB )||
+       ( 2048 != mem_stats.hugepage_size_kB ))
+    {
+        printf( "Memory read as total=%lu, free=%lu, committed=%lu.\n",
+                mem_stats.total_memory_kB, mem_stats.free_memory_kB,
+                mem_stats.commited_memory_kB );
+        return( false );
+    }
+
+    unsigned int if_i;
+    for( if_i=0; SM_NODE_STATS_BENCH_INTERFACES > if_i; ++if_i )
+    {
+        snprintf( _net_stats[if_i].dev_name, sizeof(_net_stats[if_i].dev_name),
+                  "eth%u", ( 0 == if_i ) ? 99 : if_i );
+    }
+
+    sm_node_stats_get_netdevs( _net_stats, SM_NODE_STATS_BENCH_INTERFACES );
+
+    // A device that is not found is left zeroed.
+    if(( 0 != _net_stats[0].rx_bytes )||( 0 != _net_stats[0].tx_packets ))
+    {
+        printf( "Missing device (%s) read as rx_bytes=%llu.\n",
+                _net_stats[0].dev_name, _net_stats[0].rx_bytes );
+        return( false );
+    }
+
+    for( if_i=1; SM_NODE_STATS_BENCH_INTERFACES > if_i; ++if_i )
+    {
+        if(( 169294721 != _net_stats[if_i].rx_bytes )||
+           ( 15598 != _net_stats[if_i].rx_packets )||
+           ( 169294721 != _net_stats[if_i].tx_bytes )||
+           ( 15598 != _net_stats[if_i].tx_packets ))
+        {
+            printf( "Device (%s) read as rx_bytes=%llu, tx_packets=%llu.\n",
+                    _net_stats[if_i].dev_name, _net_stats[if_i].rx_bytes,
+                    _net_stats[if_i].tx_packets );
+            return( false );
+        }
+    }
+
+    if( !sm_node_stats_bench_check_disks( num_disks,
+                                          SM_NODE_STATS_BENCH_READS ) )
+    {
+        return( false );
+    }
+
+    if( SM_OKAY != sm_node_stats_bench_generate_disks( dir, num_disks,
+                                        SM_NODE_STATS_BENCH_REWRITE_READS ) )
+    {
+        return( false );
+    }
+
+    if( !sm_node_stats_bench_check_disks( num_disks,
+                                          SM_NODE_STATS_BENCH_REWRITE_READS ) )
+    {
+        printf( "Disks not read again after being rewritten.\n" );
+        return( false );
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics Benchmark - Run
+// ===============================
+static SmErrorT sm_node_stats_bench_run( unsigned int num_disks,
+    unsigned int cycles )
+{
+    char dir[] = "/tmp/sm-node-stats-bench-XXXXXX";
+    double single_pass_us;
+    double by_index_us;
+    double start_us;
+    SmErrorT error;
+
+    if( NULL == mkdtemp( dir ) )
+    {
+        printf( "Failed to create directory, error=%s.\n", strerror(errno) );
+        return( SM_FAILED );
+    }
+
+    error = sm_node_stats_bench_generate( dir, num_disks );
+    if( SM_OKAY != error )
+    {
+        sm_node_stats_bench_remove( dir );
+        return( error );
+    }
+
+    sm_node_stats_set_proc_dir( dir );
+    sm_node_stats_initialize();
+
+    if( !sm_node_stats_bench_check( dir, num_disks ) )
+    {
+        printf( "disks: %4u  statistics read back do not match\n",
+                num_disks );
+        sm_node_stats_finalize();
+        sm_node_stats_bench_remove( dir );
+        return( SM_FAILED );
+    }
+
+    sm_node_stats_bench_cycle( false, num_disks );
+
+    start_us = sm_node_stats_bench_cpu_us();
+
+    unsigned int cycle_i;
+    for( cycle_i=0; cycles > cycle_i; ++cycle_i )
+    {
+        sm_node_stats_bench_cycle( false, num_disks );
+    }
+
+    single_pass_us = (sm_node_stats_bench_cpu_us() - start_us) / cycles;
+
+    start_us = sm_node_stats_bench_cpu_us();
+
+    for( cycle_i=0; cycles > cycle_i; ++cycle_i )
+    {
+        sm_node_stats_bench_cycle( true, num_disks );
+    }
+
+    by_index_us = (sm_node_stats_bench_cpu_us() - start_us) / cycles;
+
+    sm_node_stats_finalize();
+    sm_node_stats_bench_remove( dir );
+
+    printf( "disks: %4u  single-pass: %9.1f us/cycle  by-index: %9.1f "
+            "us/cycle\n", num_disks, single_pass_us, by_index_us );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Statistics Benchmark - Main
+// ================================
+int main( int argc, char *argv[], char *envp[] )
+{
+    unsigned int disks[16];
+    unsigned int num_disk_counts = 0;
+    unsigned int cycles = SM_NODE_STATS_BENCH_CYCLES;
+    int c;
+
+    while( true )
+    {
+        c = getopt_long( argc, argv, "", _sm_node_stats_bench_long_options,
+                         NULL );
+        if( -1 == c )
+        {
+            break;
+        }
+
+        switch( c )
+        {
+            case 'c':
+                cycles = (unsigned int) atoi( optarg );
+            break;
+
+            case 'd':
+                if( sizeof(disks)/sizeof(disks[0]) > num_disk_counts )
+                {
+                    disks[num_disk_counts++] = (unsigned int) atoi( optarg );
+                }
+            break;
+
+            case 'h':
+            case '?':
+                usage();
+                exit( 0 );
+            break;
+        }
+    }
+
+    if( 0 == num_disk_counts )
+    {
+        disks[num_disk_counts++] = 4;
+        disks[num_disk_counts++] = 64;
+        disks[num_disk_counts++] = 256;
+    }
+
+    if( 0 == cycles )
+    {
+        cycles = 1;
+    }
+
+    printf( "cycles: %u, cpus: %u, interfaces: %u\n", cycles,
+            SM_NODE_STATS_BENCH_CPUS, SM_NODE_STATS_BENCH_INTERFACES );
+
+    unsigned int count_i;
+    for( count_i=0; num_disk_counts > count_i; ++count_i )
+    {
+        unsigned int num_disks = disks[count_i];
+
+        if( SM_NODE_STATS_BENCH_DISKS_MAX < num_disks )
+        {
+            num_disks = SM_NODE_STATS_BENCH_DISKS_MAX;
+        }
+
+        if( SM_OKAY != sm_node_stats_bench_run( num_disks, cycles ) )
+        {
+            return( EXIT_FAILURE );
+        }
+    }
+
+    return( EXIT_SUCCESS );
+}
+// ****************************************************************************
@@ -11,12 +11,15 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <pthread.h>
 #include <sys/stat.h>
 #include <sys/sysinfo.h>
+#include <sys/inotify.h>
 
 #include "sm_limits.h"
 #include "sm_types.h"
 #include "sm_debug.h"
+#include "sm_selobj.h"
 
 #define SM_NODE_LOCKED_FILE           "/var/persist/mtc/.node_locked"
 #define SM_NODE_GO_ENABLE_FILE        "/var/run/goenabled"
@@ -25,8 +28,58 @@
 #define SM_NODE_CONFIG_COMPLETE_FILE  "/etc/platform/.initial_config_complete"
 #define SM_NODE_PLATFORM_CONFIG_FILE  "/etc/platform/platform.conf"
 
+#define SM_NODE_PLATFORM_CONFIG_MAX                  128
+#define SM_NODE_PLATFORM_CONFIG_KEY_MAX_CHAR          64
+#define SM_NODE_PLATFORM_CONFIG_VALUE_MAX_CHAR       256
+#define SM_NODE_WATCH_EVENTS \
+    ( IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO )
+
+typedef enum
+{
+    SM_NODE_FILE_LOCKED,
+    SM_NODE_FILE_GO_ENABLE,
+    SM_NODE_FILE_GO_ENABLE_SIMPLEX,
+    SM_NODE_FILE_UNHEALTHY,
+    SM_NODE_FILE_CONFIG_COMPLETE,
+    SM_NODE_FILE_PLATFORM_CONFIG,
+    SM_NODE_FILE_MAX
+} SmNodeFileT;
+
+typedef struct
+{
+    const char* path;
+    int wd;
+    bool exists;
+} SmNodeFileWatchT;
+
+typedef struct
+{
+    char key[SM_NODE_PLATFORM_CONFIG_KEY_MAX_CHAR];
+    char value[SM_NODE_PLATFORM_CONFIG_VALUE_MAX_CHAR];
+} SmNodePlatformConfigEntryT;
+
 static bool _failover_disabled = false;
 
+// A file is answered from memory only while its directory is watched.
+static int _watch_fd = -1;
+static SmNodeFileWatchT _files[SM_NODE_FILE_MAX] =
+{
+    { SM_NODE_LOCKED_FILE,            -1, false },
+    { SM_NODE_GO_ENABLE_FILE,         -1, false },
+    { SM_NODE_GO_ENABLE_FILE_SIMPLEX, -1, false },
+    { SM_NODE_UNHEALTHY_FILE,         -1, false },
+    { SM_NODE_CONFIG_COMPLETE_FILE,   -1, false },
+    { SM_NODE_PLATFORM_CONFIG_FILE,   -1, false },
+};
+static SmNodeUtilsReadinessCallbackT _readiness_callback = NULL;
+static bool _ready = false;
+static char _ready_reason_text[SM_LOG_REASON_TEXT_MAX_CHAR] = "";
+
+static pthread_mutex_t _platform_config_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool _platform_config_loaded = false;
+static unsigned int _platform_config_size = 0;
+static SmNodePlatformConfigEntryT _platform_config[SM_NODE_PLATFORM_CONFIG_MAX];
+
 static SmErrorT _sm_node_utils_get_system_mode_str( char system_mode[] );
 static SmErrorT _sm_node_utils_get_system_type_str( char system_type[] );
 
@@ -42,17 +95,21 @@ static ThreeValuedT _is_aio_simplex = IsUnknown;
 static ThreeValuedT _is_aio_duplex = IsUnknown;
 
 // ****************************************************************************
-// Node Utilities - Read Platform Config
+// Node Utilities - Load Platform Config
 // =====================================
-static SmErrorT sm_node_utils_read_platform_config( const char key[],
-    char value[], int value_size )
+// Parses every key=value line of platform.conf, the first value of a key
+// wins.  Called with the platform config mutex held.
+static SmErrorT sm_node_utils_load_platform_config( void )
 {
+    SmNodePlatformConfigEntryT* entry;
     FILE* fp;
-    char format[1024];
+    char format[32];
     char line[1024];
-    char val[1024];
+    char* equals;
+    size_t key_len;
 
-    value[0] = '\0';
+    _platform_config_loaded = false;
+    _platform_config_size = 0;
 
     fp = fopen( SM_NODE_PLATFORM_CONFIG_FILE, "r" );
     if( NULL == fp )
@@ -61,21 +118,84 @@ static SmErrorT sm_node_utils_read_platform_config( const char key[],
         return( SM_FAILED );
     }
 
-    snprintf( format, sizeof(format), "%s=%%%ds", (char*) key,
-              (int) sizeof(val)-1 );
+    snprintf( format, sizeof(format), "%%%ds",
+              SM_NODE_PLATFORM_CONFIG_VALUE_MAX_CHAR-1 );
 
-    while( NULL != fgets( line, sizeof(line), fp ) )
+    while(( NULL != fgets( line, sizeof(line), fp ) )&&
+          ( SM_NODE_PLATFORM_CONFIG_MAX > _platform_config_size ))
     {
-        if( 1 == sscanf( line, format, val ) )
+        equals = strchr( line, '=' );
+        if( NULL == equals )
         {
-            val[sizeof(val)-1] = '\0';
-            snprintf( value, value_size, "%s", val );
-            break;
+            continue;
         }
+
+        key_len = (size_t) (equals - line);
+        if(( 0 == key_len )||( SM_NODE_PLATFORM_CONFIG_KEY_MAX_CHAR <= key_len ))
+        {
+            continue;
+        }
+
+        entry = &(_platform_config[_platform_config_size]);
+
+        if( 1 != sscanf( equals+1, format, entry->value ) )
+        {
+            continue;
+        }
+
+        memcpy( entry->key, line, key_len );
+        entry->key[key_len] = '\0';
+        ++_platform_config_size;
     }
 
     fclose( fp );
 
+    _platform_config_loaded = true;
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Utilities - Read Platform Config
+// =====================================
+static SmErrorT sm_node_utils_read_platform_config( const char key[],
+    char value[], int value_size )
+{
+    SmErrorT error = SM_OKAY;
+
+    value[0] = '\0';
+
+    pthread_mutex_lock( &_platform_config_mutex );
+
+    // Without a watch on platform.conf it is re-read on every lookup.
+    if(( !_platform_config_loaded )||
+       ( 0 > _files[SM_NODE_FILE_PLATFORM_CONFIG].wd ))
+    {
+        error = sm_node_utils_load_platform_config();
+    }
+
+    if( SM_OKAY == error )
+    {
+        unsigned int entry_i;
+        for( entry_i=0; _platform_config_size > entry_i; ++entry_i )
+        {
+            if( 0 == strcmp( key, _platform_config[entry_i].key ) )
+            {
+                snprintf( value, value_size, "%s",
+                          _platform_config[entry_i].value );
+                break;
+            }
+        }
+    }
+
+    pthread_mutex_unlock( &_platform_config_mutex );
+
+    if( SM_OKAY != error )
+    {
+        return( error );
+    }
+
     if( '\0' == value[0] )
     {
         return( SM_NOT_FOUND );
@@ -84,6 +204,38 @@ static SmErrorT sm_node_utils_read_platform_config( const char key[],
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Node Utilities - File Exists
+// ============================
+static SmErrorT sm_node_utils_file_exists( SmNodeFileT file, bool* exists )
+{
+    SmNodeFileWatchT* file_watch = &(_files[file]);
+
+    if( 0 <= file_watch->wd )
+    {
+        *exists = file_watch->exists;
+        return( SM_OKAY );
+    }
+
+    if( 0 == access( file_watch->path, F_OK ) )
+    {
+        *exists = true;
+        return( SM_OKAY );
+    }
+
+    *exists = false;
+
+    if( ENOENT != errno )
+    {
+        DPRINTFE( "File (%s) access failed, error=%s.", file_watch->path,
+                  strerror( errno ) );
+        return( SM_FAILED );
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Node Utilities - Get Node Type
 // ==============================
@@ -351,26 +503,8 @@ SmErrorT sm_node_utils_get_hostname( char node_name[] )
 // =======================================
 SmErrorT sm_node_utils_config_complete( bool* complete )
 {
-    *complete = false;
-
-    if( 0 > access( SM_NODE_CONFIG_COMPLETE_FILE, F_OK ) )
-    {
-        if( ENOENT == errno )
-        {
-            DPRINTFD( "Config-Complete file (%s) not available, error=%s.",
-                      SM_NODE_CONFIG_COMPLETE_FILE, strerror( errno ) );
-            return( SM_OKAY );
-
-        } else {
-            DPRINTFE( "Config-Complete file (%s) access failed, error=%s.",
-                      SM_NODE_CONFIG_COMPLETE_FILE, strerror( errno ) );
-            return( SM_FAILED );
-        }
-    }
-
-    *complete = true;
-
-    return( SM_OKAY );
+    return( sm_node_utils_file_exists( SM_NODE_FILE_CONFIG_COMPLETE,
+                                       complete ) );
 }
 // ****************************************************************************
 
@@ -388,18 +522,21 @@ typedef enum
 static SmNodeEnabledBlockingStateT blocking_state = BLOCKING_STATE_INIT;
 
 // ****************************************************************************
-// Node Utilities - Enabled
-// ========================
-// ****************************************************************************
-SmErrorT sm_node_utils_enabled( bool* enabled, char reason_text[] )
+// Node Utilities - Evaluate Enabled
+// =================================
+static SmErrorT sm_node_utils_evaluate_enabled( bool* enabled,
+    char reason_text[], SmNodeEnabledBlockingStateT* state )
 {
+    bool exists;
+    SmNodeFileT goenabled_file = SM_NODE_FILE_GO_ENABLE;
+    SmErrorT error;
+
     *enabled = false;
     reason_text[0] = '\0';
-    const char* goenabled_file = SM_NODE_GO_ENABLE_FILE;
-    const char* node_locked_file = SM_NODE_LOCKED_FILE;
+    *state = BLOCKING_STATE_INIT;
 
     bool is_aio_simplex = false;
-    SmErrorT error = sm_node_utils_is_aio_simplex(&is_aio_simplex);
+    error = sm_node_utils_is_aio_simplex(&is_aio_simplex);
     if(SM_OKAY != error)
     {
         DPRINTFE("Failed to get system mode, error %s",
@@ -409,112 +546,137 @@ SmErrorT sm_node_utils_enabled( bool* enabled, char reason_text[] )
 
     if(is_aio_simplex)
     {
-        goenabled_file = SM_NODE_GO_ENABLE_FILE_SIMPLEX;
+        goenabled_file = SM_NODE_FILE_GO_ENABLE_SIMPLEX;
     }
 
     // AIO SX Case: Need to support SM
     // 1. activating on the only locked controller
     // 2. maintaining an active state after locking the only controller
-    if( (!is_aio_simplex) && ( 0 == access( node_locked_file, F_OK )))
+    if( !is_aio_simplex )
     {
-        if(blocking_state != NODE_IS_LOCKED)
+        error = sm_node_utils_file_exists( SM_NODE_FILE_LOCKED, &exists );
+        if(( SM_OKAY == error )&&( exists ))
         {
-            blocking_state = NODE_IS_LOCKED;
-            DPRINTFI("Node enable: blocked. Node is locked ; the %s file is present", node_locked_file);
+            *state = NODE_IS_LOCKED;
+            snprintf( reason_text, SM_LOG_REASON_TEXT_MAX_CHAR,
+                      "node is locked" );
+            return( SM_OKAY );
         }
+    }
 
-        snprintf( reason_text, SM_LOG_REASON_TEXT_MAX_CHAR,
-                  "node is locked" );
+    error = sm_node_utils_file_exists( goenabled_file, &exists );
+    if( SM_OKAY != error )
+    {
+        return( error );
+    }
 
+    if( !exists )
+    {
+        *state = WAIT_FOR_GOENABLED_FILE;
+        snprintf( reason_text, SM_LOG_REASON_TEXT_MAX_CHAR,
+                  "node not ready, go-enable not set" );
         return( SM_OKAY );
     }
 
-    if(0 > access( goenabled_file, F_OK ))
+    error = sm_node_utils_file_exists( SM_NODE_FILE_CONFIG_COMPLETE, &exists );
+    if( SM_OKAY != error )
     {
-        if( ENOENT == errno )
-        {
-            if(blocking_state != WAIT_FOR_GOENABLED_FILE)
-            {
-                blocking_state = WAIT_FOR_GOENABLED_FILE;
-                DPRINTFI("Node enable: blocked. wait for goenabled file %s", goenabled_file);
-            }
-
-            snprintf( reason_text, SM_LOG_REASON_TEXT_MAX_CHAR,
-                      "node not ready, go-enable not set" );
-
-            return( SM_OKAY );
-
-        } else {
-            DPRINTFE( "Go-Enable file (%s) access failed, error=%s.",
-                      SM_NODE_GO_ENABLE_FILE, strerror( errno ) );
-            return( SM_FAILED );
-        }
+        return( error );
     }
 
-    if( 0 > access( SM_NODE_CONFIG_COMPLETE_FILE, F_OK ) )
+    if( !exists )
     {
-        if( ENOENT == errno )
-        {
-            if(blocking_state != WAIT_FOR_CONFIG_COMPLETE_FILE)
-            {
-                blocking_state = WAIT_FOR_CONFIG_COMPLETE_FILE;
-                DPRINTFI("Node enable: blocked. wait for config complete file %s", SM_NODE_CONFIG_COMPLETE_FILE);
-            }
-
-            snprintf( reason_text, SM_LOG_REASON_TEXT_MAX_CHAR,
-                      "node not ready, config-complete not set" );
-
-            return( SM_OKAY );
-
-        } else {
-            DPRINTFE( "Config-Complete file (%s) access failed, error=%s.",
-                      SM_NODE_CONFIG_COMPLETE_FILE, strerror( errno ) );
-            return( SM_FAILED );
-        }
+        *state = WAIT_FOR_CONFIG_COMPLETE_FILE;
+        snprintf( reason_text, SM_LOG_REASON_TEXT_MAX_CHAR,
+                  "node not ready, config-complete not set" );
+        return( SM_OKAY );
     }
 
-    if( 0 == access( SM_NODE_UNHEALTHY_FILE, F_OK ) )
+    error = sm_node_utils_file_exists( SM_NODE_FILE_UNHEALTHY, &exists );
+    if( SM_OKAY != error )
     {
-        if(blocking_state != NODE_UNHEALTHY_FILE_EXISTS)
-        {
-            blocking_state = NODE_UNHEALTHY_FILE_EXISTS;
-            DPRINTFI("Node enable: blocked. node unhealthy file %s found", SM_NODE_UNHEALTHY_FILE);
-        }
+        return( error );
+    }
 
+    if( exists )
+    {
+        *state = NODE_UNHEALTHY_FILE_EXISTS;
         snprintf( reason_text, SM_LOG_REASON_TEXT_MAX_CHAR,
                   "node not ready, node unhealthy set" );
-
         return( SM_OKAY );
-
-    } else {
-        if( ENOENT != errno )
-        {
-            DPRINTFE( "Node unhealthy file (%s) access failed, error=%s.",
-                      SM_NODE_UNHEALTHY_FILE, strerror( errno ) );
-            return( SM_FAILED );
-        }
     }
 
     if(_failover_disabled)
     {
-        if(blocking_state != NODE_DISABLED_FAILOVER)
-        {
-            blocking_state = NODE_DISABLED_FAILOVER;
-            DPRINTFI("Node enable: blocked. node has failed");
-        }
+        *state = NODE_DISABLED_FAILOVER;
         snprintf( reason_text, SM_LOG_REASON_TEXT_MAX_CHAR,
                   "Failover action to disable node" );
         return( SM_OKAY );
     }
 
-    if(blocking_state != NODE_ENABLED)
+    *state = NODE_ENABLED;
+    *enabled = true;
+    snprintf( reason_text, SM_LOG_REASON_TEXT_MAX_CHAR, "node ready" );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Utilities - Enabled
+// ========================
+// ****************************************************************************
+SmErrorT sm_node_utils_enabled( bool* enabled, char reason_text[] )
+{
+    bool is_aio_simplex = false;
+    SmNodeEnabledBlockingStateT state;
+    SmErrorT error;
+
+    error = sm_node_utils_evaluate_enabled( enabled, reason_text, &state );
+    if( SM_OKAY != error )
     {
-        blocking_state = NODE_ENABLED;
-        DPRINTFI("Node enable: passed. node is enabled");
+        return( error );
     }
 
-    *enabled = true;
-    snprintf( reason_text, SM_LOG_REASON_TEXT_MAX_CHAR, "node ready" );
+    if( blocking_state == state )
+    {
+        return( SM_OKAY );
+    }
+
+    blocking_state = state;
+
+    switch( state )
+    {
+        case NODE_IS_LOCKED:
+            DPRINTFI("Node enable: blocked. Node is locked ; the %s file is present", SM_NODE_LOCKED_FILE);
+        break;
+
+        case WAIT_FOR_GOENABLED_FILE:
+            sm_node_utils_is_aio_simplex(&is_aio_simplex);
+            DPRINTFI("Node enable: blocked. wait for goenabled file %s",
+                     is_aio_simplex ? SM_NODE_GO_ENABLE_FILE_SIMPLEX
+                                    : SM_NODE_GO_ENABLE_FILE);
+        break;
+
+        case WAIT_FOR_CONFIG_COMPLETE_FILE:
+            DPRINTFI("Node enable: blocked. wait for config complete file %s", SM_NODE_CONFIG_COMPLETE_FILE);
+        break;
+
+        case NODE_UNHEALTHY_FILE_EXISTS:
+            DPRINTFI("Node enable: blocked. node unhealthy file %s found", SM_NODE_UNHEALTHY_FILE);
+        break;
+
+        case NODE_DISABLED_FAILOVER:
+            DPRINTFI("Node enable: blocked. node has failed");
+        break;
+
+        case NODE_ENABLED:
+            DPRINTFI("Node enable: passed. node is enabled");
+        break;
+
+        default:
+        break;
+    }
 
     return( SM_OKAY );
 }
@@ -549,6 +711,7 @@ SmErrorT sm_node_utils_set_unhealthy( void )
         return( SM_FAILED );
     }
     close(fd);
+    _files[SM_NODE_FILE_UNHEALTHY].exists = true;
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -623,6 +786,270 @@ extern void sm_node_utils_reset_unhealthy_flag( void )
         if( 0 == access( SM_NODE_UNHEALTHY_FILE,  F_OK ) )
         {
             DPRINTFE("file did not get removed ; %s", SM_NODE_UNHEALTHY_FILE);
+        } else {
+            _files[SM_NODE_FILE_UNHEALTHY].exists = false;
         }
     }
 }
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Utilities - Platform Config Changed
+// ========================================
+static void sm_node_utils_platform_config_changed( void )
+{
+    pthread_mutex_lock( &_platform_config_mutex );
+    _platform_config_loaded = false;
+    pthread_mutex_unlock( &_platform_config_mutex );
+
+    _is_aio = IsUnknown;
+    _is_aio_simplex = IsUnknown;
+    _is_aio_duplex = IsUnknown;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Utilities - Refresh File
+// =============================
+static void sm_node_utils_refresh_file( SmNodeFileT file )
+{
+    if( SM_NODE_FILE_PLATFORM_CONFIG == file )
+    {
+        sm_node_utils_platform_config_changed();
+    } else {
+        _files[file].exists = ( 0 == access( _files[file].path, F_OK ) );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Utilities - Readiness Check
+// ================================
+static void sm_node_utils_readiness_check( void )
+{
+    bool enabled;
+    char reason_text[SM_LOG_REASON_TEXT_MAX_CHAR] = "";
+    SmNodeEnabledBlockingStateT state;
+    SmErrorT error;
+
+    error = sm_node_utils_evaluate_enabled( &enabled, reason_text, &state );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to evaluate node readiness, error=%s.",
+                  sm_error_str( error ) );
+        return;
+    }
+
+    if(( enabled == _ready )&&
+       ( 0 == strcmp( reason_text, _ready_reason_text ) ))
+    {
+        return;
+    }
+
+    DPRINTFI( "Node readiness changed from (%s) to (%s).",
+              _ready_reason_text, reason_text );
+
+    _ready = enabled;
+    snprintf( _ready_reason_text, sizeof(_ready_reason_text), "%s",
+              reason_text );
+
+    if( NULL != _readiness_callback )
+    {
+        _readiness_callback( enabled, reason_text );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Utilities - Watch Dispatch
+// ===============================
+static void sm_node_utils_watch_dispatch( int selobj, int64_t user_data )
+{
+    char buf[4096]
+        __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    const struct inotify_event* event;
+    const char* name;
+    bool changed = false;
+    ssize_t len;
+
+    for( ;; )
+    {
+        len = read( _watch_fd, buf, sizeof(buf) );
+        if( 0 >= len )
+        {
+            if(( 0 > len )&&( EAGAIN != errno )&&( EINTR != errno ))
+            {
+                DPRINTFE( "Failed to read node file events, error=%s.",
+                          strerror( errno ) );
+            }
+            break;
+        }
+
+        char* ptr;
+        for( ptr = buf; buf + len > ptr;
+             ptr += sizeof(struct inotify_event) + event->len )
+        {
+            event = (const struct inotify_event*) ptr;
+
+            unsigned int file_i;
+            for( file_i=0; SM_NODE_FILE_MAX > file_i; ++file_i )
+            {
+                SmNodeFileWatchT* file_watch = &(_files[file_i]);
+
+                if( event->mask & IN_Q_OVERFLOW )
+                {
+                    if( 0 <= file_watch->wd )
+                    {
+                        sm_node_utils_refresh_file( (SmNodeFileT) file_i );
+                    }
+                    changed = true;
+                    continue;
+                }
+
+                if(( 0 > file_watch->wd )||( event->wd != file_watch->wd ))
+                    continue;
+
+                if( event->mask & IN_IGNORED )
+                {
+                    // Directory went away, fall back to probing the file.
+                    DPRINTFI( "Stopped watching node file (%s).",
+                              file_watch->path );
+                    file_watch->wd = -1;
+                    if( SM_NODE_FILE_PLATFORM_CONFIG == file_i )
+                    {
+                        sm_node_utils_platform_config_changed();
+                    }
+                    changed = true;
+                    continue;
+                }
+
+                name = strrchr( file_watch->path, '/' ) + 1;
+
+                if(( 0 == event->len )||( 0 != strcmp( event->name, name ) ))
+                    continue;
+
+                if( SM_NODE_FILE_PLATFORM_CONFIG == file_i )
+                {
+                    sm_node_utils_platform_config_changed();
+                } else {
+                    file_watch->exists =
+                        ( 0 == (event->mask & ( IN_DELETE | IN_MOVED_FROM )) );
+                }
+
+                DPRINTFD( "Node file (%s) changed, exists=%d.",
+                          file_watch->path, (int) file_watch->exists );
+                changed = true;
+            }
+        }
+    }
+
+    if( changed )
+    {
+        sm_node_utils_readiness_check();
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Utilities - Watch Initialize
+// =================================
+SmErrorT sm_node_utils_watch_initialize(
+    SmNodeUtilsReadinessCallbackT callback )
+{
+    char dir[SM_NODE_PLATFORM_CONFIG_VALUE_MAX_CHAR];
+    const char* slash;
+    int wd;
+    SmErrorT error;
+
+    _watch_fd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+    if( 0 > _watch_fd )
+    {
+        DPRINTFE( "Failed to initialize inotify, error=%s, node files will "
+                  "be probed.", strerror( errno ) );
+        return( SM_OKAY );
+    }
+
+    // Watch first, then take the snapshot, so no change is missed.
+    unsigned int file_i;
+    for( file_i=0; SM_NODE_FILE_MAX > file_i; ++file_i )
+    {
+        SmNodeFileWatchT* file_watch = &(_files[file_i]);
+
+        slash = strrchr( file_watch->path, '/' );
+        snprintf( dir, sizeof(dir), "%.*s",
+                  (int) (slash - file_watch->path), file_watch->path );
+
+        wd = inotify_add_watch( _watch_fd, dir, SM_NODE_WATCH_EVENTS );
+        if( 0 > wd )
+        {
+            DPRINTFI( "Failed to watch directory (%s), error=%s, node file "
+                      "(%s) will be probed.", dir, strerror( errno ),
+                      file_watch->path );
+            file_watch->wd = -1;
+            continue;
+        }
+
+        sm_node_utils_refresh_file( (SmNodeFileT) file_i );
+        file_watch->wd = wd;
+    }
+
+    error = sm_selobj_register( _watch_fd, sm_node_utils_watch_dispatch, 0 );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to register selection object, error=%s.",
+                  sm_error_str( error ) );
+
+        for( file_i=0; SM_NODE_FILE_MAX > file_i; ++file_i )
+        {
+            _files[file_i].wd = -1;
+        }
+
+        close( _watch_fd );
+        _watch_fd = -1;
+        return( error );
+    }
+
+    _readiness_callback = callback;
+    _ready = false;
+    _ready_reason_text[0] = '\0';
+
+    sm_node_utils_readiness_check();
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Utilities - Watch Finalize
+// ===============================
+SmErrorT sm_node_utils_watch_finalize( void )
+{
+    SmErrorT error;
+
+    _readiness_callback = NULL;
+
+    unsigned int file_i;
+    for( file_i=0; SM_NODE_FILE_MAX > file_i; ++file_i )
+    {
+        _files[file_i].wd = -1;
+        _files[file_i].exists = false;
+    }
+
+    sm_node_utils_platform_config_changed();
+
+    if( 0 <= _watch_fd )
+    {
+        error = sm_selobj_deregister( _watch_fd );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to deregister selection object, error=%s.",
+                      sm_error_str( error ) );
+        }
+
+        close( _watch_fd );
+        _watch_fd = -1;
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
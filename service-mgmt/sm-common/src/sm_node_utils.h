@@ -14,6 +14,9 @@
 extern "C" {
 #endif
 
+typedef void (*SmNodeUtilsReadinessCallbackT) (bool enabled,
+        const char reason_text[]);
+
 // ****************************************************************************
 // Node Utilities - Node Type Is Controller
 // ========================================
@@ -116,6 +119,23 @@ extern bool sm_node_utils_set_failover( bool to_disable );
 extern void sm_node_utils_reset_unhealthy_flag( void );
 // ****************************************************************************
 
+// ****************************************************************************
+// Node Utilities - Watch Initialize
+// =================================
+// Watches platform.conf and the node flag files from the calling thread's
+// selection loop.  Until finalized, platform.conf is parsed once per change
+// and the flag files are answered from memory.  The callback is invoked
+// when the node enabled state or its reason changes.
+extern SmErrorT sm_node_utils_watch_initialize(
+    SmNodeUtilsReadinessCallbackT callback );
+// ****************************************************************************
+
+// ****************************************************************************
+// Node Utilities - Watch Finalize
+// ===============================
+extern SmErrorT sm_node_utils_watch_finalize( void );
+// ****************************************************************************
+
 #ifdef __cplusplus
 }
 #endif
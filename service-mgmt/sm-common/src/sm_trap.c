@@ -37,6 +37,7 @@ typedef struct
 static int _trap_fd = -1;
 static int _process_id;
 static char _process_name[SM_PROCESS_NAME_MAX_CHAR];
+static char _flight_recorder_file[SM_PROCESS_NAME_MAX_CHAR+32];
 static SmTrapThreadInfoT _threads[SM_THREADS_MAX];
 static pthread_mutex_t trap_mutex;
 static pthread_spinlock_t _thread_spinlock;
@@ -146,6 +147,9 @@ static void sm_trap_signal_handler( int signum, siginfo_t* siginfo,
 
     close( _trap_fd );
 
+    // Recent debug logs leading up to the crash, for sm-debug-decode.
+    sm_debug_flight_recorder_save( _flight_recorder_file );
+
     // Core dump produced if enabled.
     _exit( EXIT_SUCCESS );
 }
@@ -212,6 +216,8 @@ SmErrorT sm_trap_initialize( const char process_name[] )
 
     _process_id = (int) getpid();
     snprintf( _process_name, sizeof(_process_name), "%s", process_name );
+    snprintf( _flight_recorder_file, sizeof(_flight_recorder_file),
+              SM_DEBUG_FLIGHT_RECORDER_FILE_FORMAT, process_name, "crash" );
 
     // Force load the backtrace function symbols, need to avoid malloc
     // in the trap exception handler.
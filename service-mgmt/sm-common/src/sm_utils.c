@@ -16,6 +16,9 @@
 #include <errno.h>
 #include <signal.h>
 #include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 
 // ****************************************************************************
 // Utils - Process Running
@@ -124,3 +127,30 @@ SmErrorT sm_utils_clear_degraded( void )
     return( SM_OKAY );
 }
 // ****************************************************************************
+
+// ****************************************************************************
+// Utils - Close File Descriptors
+// ==============================
+void sm_utils_close_fds( int first_fd )
+{
+    struct rlimit file_limits;
+
+#ifdef __NR_close_range
+    if( 0 == syscall( __NR_close_range, (unsigned int) first_fd, ~0U, 0 ) )
+    {
+        return;
+    }
+#endif // __NR_close_range
+
+    if( 0 > getrlimit( RLIMIT_NOFILE, &file_limits ) )
+    {
+        return;
+    }
+
+    unsigned int fd_i;
+    for( fd_i=first_fd; fd_i < file_limits.rlim_cur; ++fd_i )
+    {
+        close( fd_i );
+    }
+}
+// ****************************************************************************
@@ -50,6 +50,15 @@ extern SmErrorT sm_utils_indicate_degraded( void );
 extern SmErrorT sm_utils_clear_degraded( void );
 // ****************************************************************************
 
+// ****************************************************************************
+// Utils - Close File Descriptors
+// ==============================
+// Closes every file descriptor from first_fd upwards.  Uses close_range()
+// when the kernel provides it, otherwise loops up to RLIMIT_NOFILE.  Only
+// makes system calls, so it is safe to call in a forked or vforked child.
+extern void sm_utils_close_fds( int first_fd );
+// ****************************************************************************
+
 #ifdef __cplusplus
 }
 #endif
@@ -775,6 +775,12 @@ CREATE TABLE CONFIGURATION ( ID INTEGER PRIMARY KEY AUTOINCREMENT, "KEY" CHAR(32
 INSERT INTO "CONFIGURATION" VALUES(1,'ENABLING_THROTTLE','2');
 INSERT INTO "CONFIGURATION" ("KEY", "VALUE") VALUES("sm_client_port", "");
 INSERT INTO "CONFIGURATION" ("KEY", "VALUE") VALUES("sm_server_port", "");
+INSERT INTO "CONFIGURATION" ("KEY", "VALUE") VALUES("sm_rt_cpu", "");
+INSERT INTO "CONFIGURATION" ("KEY", "VALUE") VALUES("sm_rt_priority", "");
+INSERT INTO "CONFIGURATION" ("KEY", "VALUE") VALUES("sm_swact_profile_reports", "5");
+INSERT INTO "CONFIGURATION" ("KEY", "VALUE") VALUES("sm_go_active_concurrency", "8");
+INSERT INTO "CONFIGURATION" ("KEY", "VALUE") VALUES("sm_notification_handler", "script");
+INSERT INTO "CONFIGURATION" ("KEY", "VALUE") VALUES("sm_debug_log_mode", "text");
 -- to add new service or service member, follow the examples below, avoid using a hardcoded id
 -- INSERT INTO "SERVICES" SELECT MAX(id) + 1,'no','drbd-dc-vault','initial','initial','none','none',2,1,90000,4,16,'' FROM "SERVICES";
 -- INSERT INTO "SERVICE_GROUP_MEMBERS" SELECT MAX(id) + 1,'no','distributed-cloud-services','dcorch-nova-api-proxy','critical' FROM "SERVICE_GROUP_MEMBERS";
@@ -17,6 +17,8 @@
 #include "sm_db.h"
 #include "sm_node_utils.h"
 
+static unsigned int _generation = 0;
+
 // ****************************************************************************
 // Database Nodes - Convert
 // ========================
@@ -166,6 +168,15 @@ SmErrorT sm_db_nodes_query( SmDbHandleT* sm_db_handle, const char* db_query,
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Database Nodes - Generation
+// ===========================
+unsigned int sm_db_nodes_generation( void )
+{
+    return( __sync_add_and_fetch( &_generation, 0 ) );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Database Nodes - Insert
 // =======================
@@ -201,6 +212,8 @@ SmErrorT sm_db_nodes_insert( SmDbHandleT* sm_db_handle, SmDbNodeT* record )
         return( SM_FAILED );
     }
 
+    __sync_add_and_fetch( &_generation, 1 );
+
     DPRINTFD( "Insert completed." );
 
     return( SM_OKAY );
@@ -264,6 +277,8 @@ SmErrorT sm_db_nodes_update( SmDbHandleT* sm_db_handle, SmDbNodeT* record )
         return( SM_FAILED );
     }
 
+    __sync_add_and_fetch( &_generation, 1 );
+
     DPRINTFD( "Update completed." );
 
     return( SM_OKAY );
@@ -293,6 +308,8 @@ SmErrorT sm_db_nodes_delete( SmDbHandleT* sm_db_handle, char name[] )
         return( SM_FAILED );
     }
 
+    __sync_add_and_fetch( &_generation, 1 );
+
     DPRINTFD( "Delete finished." );
 
     return( SM_OKAY );
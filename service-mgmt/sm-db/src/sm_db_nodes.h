@@ -59,6 +59,13 @@ extern SmErrorT sm_db_nodes_query( SmDbHandleT* sm_db_handle,
     const char* db_query, SmDbNodeT* record );
 // ****************************************************************************
 
+// ****************************************************************************
+// Database Nodes - Generation
+// ===========================
+// Changes whenever this process inserts, updates or deletes a node.
+extern unsigned int sm_db_nodes_generation( void );
+// ****************************************************************************
+
 // ****************************************************************************
 // Database Nodes - Insert
 // =======================
@@ -0,0 +1,589 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "sm_alarm_fm.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/eventfd.h>
+#include <pthread.h>
+
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_time.h"
+#include "sm_selobj.h"
+
+#define SM_ALARM_FM_THREAD_NAME                                      "sm_alarm_fm"
+
+typedef struct
+{
+    SmAlarmFmRequestTypeT type;
+    void* context;
+    uint32_t generation;
+
+    union
+    {
+        SFmAlarmDataT fm_alarm_data;
+        AlarmFilter fm_filter;
+        fm_ent_inst_t fm_entity_instance_id;
+    } u;
+} SmAlarmFmRequestT;
+
+static bool _stay_on = false;
+static bool _thread_created = false;
+static bool _thread_exited = false;
+static bool _thread_detached = false;
+static pthread_t _fm_thread;
+static int _result_fd = -1;
+static SmAlarmFmCallbackT _callback = NULL;
+
+static pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _cond = PTHREAD_COND_INITIALIZER;
+
+// Requests and results are rings of the same size, a request counts as
+// outstanding until its result is dispatched so neither ring overflows.
+static SmAlarmFmRequestT _requests[SM_ALARM_FM_QUEUE_MAX];
+static unsigned int _request_head = 0;
+static unsigned int _request_tail = 0;
+static SmAlarmFmResultT _results[SM_ALARM_FM_QUEUE_MAX];
+static unsigned int _result_head = 0;
+static unsigned int _result_tail = 0;
+static unsigned int _outstanding = 0;
+
+static uint64_t _submitted[SM_ALARM_FM_REQUEST_MAX];
+static uint64_t _completed = 0;
+static uint64_t _failed = 0;
+static uint64_t _retries = 0;
+static uint64_t _queue_full = 0;
+static unsigned int _outstanding_max = 0;
+
+// ****************************************************************************
+// Alarm FM - Request Type String
+// ==============================
+const char* sm_alarm_fm_request_type_str( SmAlarmFmRequestTypeT type )
+{
+    switch( type )
+    {
+        case SM_ALARM_FM_REQUEST_RAISE:
+            return( "raise" );
+        break;
+
+        case SM_ALARM_FM_REQUEST_CLEAR:
+            return( "clear" );
+        break;
+
+        case SM_ALARM_FM_REQUEST_CLEAR_ALL:
+            return( "clear-all" );
+        break;
+
+        case SM_ALARM_FM_REQUEST_GET:
+            return( "get" );
+        break;
+
+        default:
+            return( "???" );
+        break;
+    }
+
+    return( "???" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Submit
+// =================
+static SmErrorT sm_alarm_fm_submit( SmAlarmFmRequestT* request )
+{
+    if( !_thread_created )
+    {
+        return( SM_FAILED );
+    }
+
+    pthread_mutex_lock( &_mutex );
+
+    if( SM_ALARM_FM_QUEUE_MAX <= _outstanding )
+    {
+        ++_queue_full;
+        pthread_mutex_unlock( &_mutex );
+        return( SM_FAILED );
+    }
+
+    memcpy( &(_requests[_request_head % SM_ALARM_FM_QUEUE_MAX]), request,
+            sizeof(SmAlarmFmRequestT) );
+    ++_request_head;
+    ++_submitted[request->type];
+
+    if( _outstanding_max < ++_outstanding )
+    {
+        _outstanding_max = _outstanding;
+    }
+
+    pthread_cond_signal( &_cond );
+    pthread_mutex_unlock( &_mutex );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Raise
+// ================
+SmErrorT sm_alarm_fm_raise( void* context, uint32_t generation,
+    const SFmAlarmDataT* fm_alarm_data )
+{
+    SmAlarmFmRequestT request;
+
+    request.type = SM_ALARM_FM_REQUEST_RAISE;
+    request.context = context;
+    request.generation = generation;
+    memcpy( &(request.u.fm_alarm_data), fm_alarm_data,
+            sizeof(request.u.fm_alarm_data) );
+
+    return( sm_alarm_fm_submit( &request ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Clear
+// ================
+SmErrorT sm_alarm_fm_clear( void* context, uint32_t generation,
+    const AlarmFilter* fm_filter )
+{
+    SmAlarmFmRequestT request;
+
+    request.type = SM_ALARM_FM_REQUEST_CLEAR;
+    request.context = context;
+    request.generation = generation;
+    memcpy( &(request.u.fm_filter), fm_filter, sizeof(request.u.fm_filter) );
+
+    return( sm_alarm_fm_submit( &request ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Clear All
+// ====================
+SmErrorT sm_alarm_fm_clear_all( void* context, uint32_t generation,
+    const char fm_entity_instance_id[] )
+{
+    SmAlarmFmRequestT request;
+
+    request.type = SM_ALARM_FM_REQUEST_CLEAR_ALL;
+    request.context = context;
+    request.generation = generation;
+    snprintf( request.u.fm_entity_instance_id,
+              sizeof(request.u.fm_entity_instance_id), "%s",
+              fm_entity_instance_id );
+
+    return( sm_alarm_fm_submit( &request ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Get
+// ==============
+SmErrorT sm_alarm_fm_get( void* context, uint32_t generation,
+    const AlarmFilter* fm_filter )
+{
+    SmAlarmFmRequestT request;
+
+    request.type = SM_ALARM_FM_REQUEST_GET;
+    request.context = context;
+    request.generation = generation;
+    memcpy( &(request.u.fm_filter), fm_filter, sizeof(request.u.fm_filter) );
+
+    return( sm_alarm_fm_submit( &request ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Execute
+// ==================
+static EFmErrorT sm_alarm_fm_execute( SmAlarmFmRequestT* request,
+    SmAlarmFmResultT* result )
+{
+    SFmAlarmDataT fm_alarm_data;
+    EFmErrorT fm_error;
+
+    switch( request->type )
+    {
+        case SM_ALARM_FM_REQUEST_RAISE:
+            fm_error = fm_set_fault_wrapper( &(request->u.fm_alarm_data),
+                                             &(result->fm_uuid) );
+            result->found = ( FM_ERR_OK == fm_error );
+        break;
+
+        case SM_ALARM_FM_REQUEST_CLEAR:
+            fm_error = fm_clear_fault_wrapper( &(request->u.fm_filter) );
+        break;
+
+        case SM_ALARM_FM_REQUEST_CLEAR_ALL:
+            fm_error = fm_clear_all_wrapper(
+                                    &(request->u.fm_entity_instance_id) );
+        break;
+
+        case SM_ALARM_FM_REQUEST_GET:
+            memset( &fm_alarm_data, 0, sizeof(fm_alarm_data) );
+            fm_error = fm_get_fault_wrapper( &(request->u.fm_filter),
+                                             &fm_alarm_data );
+            if( FM_ERR_OK == fm_error )
+            {
+                result->found = true;
+                snprintf( result->fm_uuid, sizeof(result->fm_uuid), "%s",
+                          fm_alarm_data.uuid );
+            }
+        break;
+
+        default:
+            DPRINTFE( "Unknown FM request (%i).", request->type );
+            fm_error = FM_ERR_OK;
+        break;
+    }
+
+    return( fm_error );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Main
+// ===============
+static void* sm_alarm_fm_main( void* arguments )
+{
+    SmAlarmFmRequestT request;
+    SmAlarmFmResultT result;
+    struct timespec ts;
+    uint64_t count = 1;
+    long delay_ms;
+
+    pthread_setname_np( pthread_self(), SM_ALARM_FM_THREAD_NAME );
+    sm_debug_set_thread_info();
+
+    pthread_mutex_lock( &_mutex );
+
+    while( _stay_on )
+    {
+        if( _request_head == _request_tail )
+        {
+            pthread_cond_wait( &_cond, &_mutex );
+            continue;
+        }
+
+        memcpy( &request, &(_requests[_request_tail % SM_ALARM_FM_QUEUE_MAX]),
+                sizeof(request) );
+        ++_request_tail;
+
+        pthread_mutex_unlock( &_mutex );
+
+        memset( &result, 0, sizeof(result) );
+        result.type = request.type;
+        result.context = request.context;
+        result.generation = request.generation;
+
+        int attempt;
+        for( attempt=0; SM_ALARM_FM_RETRY_MAX >= attempt; ++attempt )
+        {
+            result.fm_error = sm_alarm_fm_execute( &request, &result );
+            if(( FM_ERR_OK == result.fm_error )||
+               ( FM_ERR_ENTITY_NOT_FOUND == result.fm_error ))
+            {
+                break;
+            }
+
+            if( SM_ALARM_FM_RETRY_MAX == attempt )
+            {
+                break;
+            }
+
+            DPRINTFD( "FM %s request failed, error=%i, attempt=%i.",
+                      sm_alarm_fm_request_type_str( request.type ),
+                      result.fm_error, attempt );
+
+            delay_ms = SM_ALARM_FM_RETRY_DELAY_IN_MS << attempt;
+
+            clock_gettime( CLOCK_REALTIME, &ts );
+            ts.tv_sec += delay_ms / 1000;
+            ts.tv_nsec += (delay_ms % 1000) * 1000000;
+            if( 1000000000 <= ts.tv_nsec )
+            {
+                ++ts.tv_sec;
+                ts.tv_nsec -= 1000000000;
+            }
+
+            pthread_mutex_lock( &_mutex );
+            ++_retries;
+            while( _stay_on )
+            {
+                if( ETIMEDOUT == pthread_cond_timedwait( &_cond, &_mutex,
+                                                         &ts ) )
+                {
+                    break;
+                }
+            }
+            pthread_mutex_unlock( &_mutex );
+
+            if( !_stay_on )
+            {
+                break;
+            }
+        }
+
+        pthread_mutex_lock( &_mutex );
+
+        if( !_stay_on )
+        {
+            // Finalized while in the FM library, nobody dispatches results.
+            break;
+        }
+
+        memcpy( &(_results[_result_head % SM_ALARM_FM_QUEUE_MAX]), &result,
+                sizeof(result) );
+        ++_result_head;
+
+        if(( FM_ERR_OK == result.fm_error )||
+           ( FM_ERR_ENTITY_NOT_FOUND == result.fm_error ))
+        {
+            ++_completed;
+        } else {
+            ++_failed;
+        }
+
+        if( 0 > write( _result_fd, &count, sizeof(count) ) )
+        {
+            if( EAGAIN != errno )
+            {
+                DPRINTFE( "Failed to signal FM result, error=%s.",
+                          strerror( errno ) );
+            }
+        }
+    }
+
+    _thread_exited = true;
+
+    if( _thread_detached )
+    {
+        // Finalize gave up waiting, the event file descriptor is ours.
+        close( _result_fd );
+        _result_fd = -1;
+        _thread_detached = false;
+    }
+
+    pthread_mutex_unlock( &_mutex );
+
+    return( NULL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Dispatch
+// ===================
+static void sm_alarm_fm_dispatch( int selobj, int64_t user_data )
+{
+    SmAlarmFmResultT result;
+    uint64_t count;
+
+    if( 0 > read( _result_fd, &count, sizeof(count) ) )
+    {
+        if( EAGAIN != errno )
+        {
+            DPRINTFE( "Failed to read FM result event, error=%s.",
+                      strerror( errno ) );
+        }
+    }
+
+    while( true )
+    {
+        pthread_mutex_lock( &_mutex );
+
+        if( _result_head == _result_tail )
+        {
+            pthread_mutex_unlock( &_mutex );
+            break;
+        }
+
+        memcpy( &result, &(_results[_result_tail % SM_ALARM_FM_QUEUE_MAX]),
+                sizeof(result) );
+        ++_result_tail;
+        --_outstanding;
+
+        pthread_mutex_unlock( &_mutex );
+
+        if( NULL != _callback )
+        {
+            _callback( &result );
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Dump Data
+// ====================
+void sm_alarm_fm_dump_data( FILE* log )
+{
+    pthread_mutex_lock( &_mutex );
+
+    fprintf( log, "--------------------------------------------------------------------\n" );
+    fprintf( log, "ALARM FM DATA\n" );
+    fprintf( log, "  raise_requests...............................%" PRIu64 "\n", _submitted[SM_ALARM_FM_REQUEST_RAISE] );
+    fprintf( log, "  clear_requests...............................%" PRIu64 "\n", _submitted[SM_ALARM_FM_REQUEST_CLEAR] );
+    fprintf( log, "  clear_all_requests...........................%" PRIu64 "\n", _submitted[SM_ALARM_FM_REQUEST_CLEAR_ALL] );
+    fprintf( log, "  get_requests.................................%" PRIu64 "\n", _submitted[SM_ALARM_FM_REQUEST_GET] );
+    fprintf( log, "  completed....................................%" PRIu64 "\n", _completed );
+    fprintf( log, "  failed.......................................%" PRIu64 "\n", _failed );
+    fprintf( log, "  retries......................................%" PRIu64 "\n", _retries );
+    fprintf( log, "  queue_full...................................%" PRIu64 "\n", _queue_full );
+    fprintf( log, "  outstanding..................................%u\n", _outstanding );
+    fprintf( log, "  outstanding_max..............................%u\n", _outstanding_max );
+
+    pthread_mutex_unlock( &_mutex );
+
+    fprintf( log, "--------------------------------------------------------------------\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Initialize
+// =====================
+SmErrorT sm_alarm_fm_initialize( SmAlarmFmCallbackT callback )
+{
+    int result;
+    SmErrorT error;
+
+    pthread_mutex_lock( &_mutex );
+
+    if( _thread_detached )
+    {
+        pthread_mutex_unlock( &_mutex );
+        DPRINTFE( "Previous alarm FM thread still blocked in FM." );
+        return( SM_FAILED );
+    }
+
+    _request_head = 0;
+    _request_tail = 0;
+    _result_head = 0;
+    _result_tail = 0;
+    _outstanding = 0;
+    _stay_on = true;
+    _thread_exited = false;
+    pthread_mutex_unlock( &_mutex );
+
+    _callback = callback;
+
+    _result_fd = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+    if( 0 > _result_fd )
+    {
+        DPRINTFE( "Failed to open FM result event file descriptor, "
+                  "error=%s.", strerror( errno ) );
+        return( SM_FAILED );
+    }
+
+    error = sm_selobj_register( _result_fd, sm_alarm_fm_dispatch, 0 );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to register selection object, error=%s.",
+                  sm_error_str( error ) );
+        close( _result_fd );
+        _result_fd = -1;
+        return( error );
+    }
+
+    result = pthread_create( &_fm_thread, NULL, sm_alarm_fm_main, NULL );
+    if( 0 != result )
+    {
+        DPRINTFE( "Failed to start alarm FM thread, error=%s.",
+                  strerror(result) );
+        sm_selobj_deregister( _result_fd );
+        close( _result_fd );
+        _result_fd = -1;
+        return( SM_FAILED );
+    }
+
+    _thread_created = true;
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Finalize
+// ===================
+SmErrorT sm_alarm_fm_finalize( void )
+{
+    bool detached = false;
+    SmErrorT error;
+
+    pthread_mutex_lock( &_mutex );
+    _stay_on = false;
+    pthread_cond_broadcast( &_cond );
+    pthread_mutex_unlock( &_mutex );
+
+    if( _thread_created )
+    {
+        long ms_expired;
+        SmTimeT time_prev;
+        int result;
+
+        sm_time_get( &time_prev );
+
+        while( true )
+        {
+            result = pthread_tryjoin_np( _fm_thread, NULL );
+            if( EBUSY != result )
+            {
+                break;
+            }
+
+            ms_expired = sm_time_get_elapsed_ms( &time_prev );
+            if( 5000 <= ms_expired )
+            {
+                pthread_mutex_lock( &_mutex );
+                if( _thread_exited )
+                {
+                    pthread_mutex_unlock( &_mutex );
+                    pthread_join( _fm_thread, NULL );
+                    break;
+                }
+
+                // Blocked in the FM library, the thread exits on return
+                // and closes the event file descriptor itself.
+                DPRINTFE( "Failed to stop alarm FM thread." );
+                sm_selobj_deregister( _result_fd );
+                pthread_detach( _fm_thread );
+                _thread_detached = true;
+                detached = true;
+                pthread_mutex_unlock( &_mutex );
+                break;
+            }
+
+            usleep( 50000 ); // 50 milliseconds.
+        }
+
+        _thread_created = false;
+    }
+
+    if(( !detached )&&( -1 < _result_fd ))
+    {
+        error = sm_selobj_deregister( _result_fd );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to deregister selection object, error=%s.",
+                      sm_error_str( error ) );
+        }
+
+        close( _result_fd );
+        _result_fd = -1;
+    }
+
+    _callback = NULL;
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
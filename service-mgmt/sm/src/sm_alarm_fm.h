@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __SM_ALARM_FM_H__
+#define __SM_ALARM_FM_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "fm_api_wrapper.h"
+
+#include "sm_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SM_ALARM_FM_QUEUE_MAX                                            64
+#define SM_ALARM_FM_RETRY_MAX                                             3
+#define SM_ALARM_FM_RETRY_DELAY_IN_MS                                   500
+
+typedef enum
+{
+    SM_ALARM_FM_REQUEST_RAISE,
+    SM_ALARM_FM_REQUEST_CLEAR,
+    SM_ALARM_FM_REQUEST_CLEAR_ALL,
+    SM_ALARM_FM_REQUEST_GET,
+    SM_ALARM_FM_REQUEST_MAX
+} SmAlarmFmRequestTypeT;
+
+typedef struct
+{
+    SmAlarmFmRequestTypeT type;
+    void* context;
+    uint32_t generation;
+    EFmErrorT fm_error;
+    bool found;
+    fm_uuid_t fm_uuid;
+} SmAlarmFmResultT;
+
+typedef void (*SmAlarmFmCallbackT) (SmAlarmFmResultT* result);
+
+// ****************************************************************************
+// Alarm FM - Request Type String
+// ==============================
+extern const char* sm_alarm_fm_request_type_str(
+    SmAlarmFmRequestTypeT type );
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Raise
+// ================
+// Queues a raise of the alarm, the result is passed to the callback along
+// with context and generation.  Returns SM_FAILED when the queue is full.
+extern SmErrorT sm_alarm_fm_raise( void* context, uint32_t generation,
+    const SFmAlarmDataT* fm_alarm_data );
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Clear
+// ================
+extern SmErrorT sm_alarm_fm_clear( void* context, uint32_t generation,
+    const AlarmFilter* fm_filter );
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Clear All
+// ====================
+extern SmErrorT sm_alarm_fm_clear_all( void* context, uint32_t generation,
+    const char fm_entity_instance_id[] );
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Get
+// ==============
+// Queues a lookup of the alarm, the result is found when FM has it.
+extern SmErrorT sm_alarm_fm_get( void* context, uint32_t generation,
+    const AlarmFilter* fm_filter );
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Dump Data
+// ====================
+extern void sm_alarm_fm_dump_data( FILE* log );
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Initialize
+// =====================
+// Starts the thread that makes the FM calls. Results are dispatched to the
+// callback from the selection objects of the calling thread.
+extern SmErrorT sm_alarm_fm_initialize( SmAlarmFmCallbackT callback );
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM - Finalize
+// ===================
+extern SmErrorT sm_alarm_fm_finalize( void );
+// ****************************************************************************
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SM_ALARM_FM_H__
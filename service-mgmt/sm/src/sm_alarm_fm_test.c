@@ -0,0 +1,575 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Drives the alarm FM queue and the alarm thread against the local FM
+// stand-in, exits non-zero when a check fails.  The queue is checked for
+// result dispatch, the retries and their backoff, a full queue and a
+// finalize while the worker is in FM.  The alarm thread is checked for
+// coalescing raises and clears that flap before they are reported, its
+// tick and audit timers are shortened so the checks run in seconds.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <dirent.h>
+
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_time.h"
+#include "sm_selobj.h"
+#include "sm_timer.h"
+#include "sm_thread_health.h"
+#include "fm_api_wrapper.h"
+#include "sm_alarm_fm.h"
+#include "sm_alarm.h"
+
+#define SM_ALARM_FM_TEST_TICK_INTERVAL_IN_MS                           100
+#define SM_ALARM_FM_TEST_AUDIT_TIMER_IN_MS                             200
+#define SM_ALARM_FM_TEST_NODE_NAME                          "controller-0"
+
+extern "C" SmErrorT __real_sm_timer_initialize(
+    unsigned int tick_interval_in_ms );
+extern "C" SmErrorT __real__sm_timer_register( const char name[],
+    unsigned int ms, SmTimerCallbackT callback, int64_t user_data,
+    SmTimerIdT* timer_id, const char* func, const char* file, int line );
+
+static SmAlarmFmResultT _results[SM_ALARM_FM_QUEUE_MAX];
+static unsigned int _results_total = 0;
+static unsigned int _failures = 0;
+
+// ****************************************************************************
+// Alarm FM Test - Check
+// =====================
+static void sm_alarm_fm_test_check( bool passed, const char name[] )
+{
+    printf( "%s: %s\n", passed ? "PASS" : "FAIL", name );
+
+    if( !passed )
+    {
+        ++_failures;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Timer Initialize
+// ================================
+// The alarm thread ticks every 5 seconds, shortened so the flush timer
+// fires on time.
+extern "C" SmErrorT __wrap_sm_timer_initialize(
+    unsigned int tick_interval_in_ms )
+{
+    return( __real_sm_timer_initialize( SM_ALARM_FM_TEST_TICK_INTERVAL_IN_MS ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Timer Register
+// ==============================
+// The first audit of the alarm thread settles whether FM holds alarms from
+// before a restart, shortened from a minute.
+extern "C" SmErrorT __wrap__sm_timer_register( const char name[],
+    unsigned int ms, SmTimerCallbackT callback, int64_t user_data,
+    SmTimerIdT* timer_id, const char* func, const char* file, int line )
+{
+    if( 0 == strcmp( "alarm audit", name ) )
+    {
+        ms = SM_ALARM_FM_TEST_AUDIT_TIMER_IN_MS;
+    }
+
+    return( __real__sm_timer_register( name, ms, callback, user_data,
+                                       timer_id, func, file, line ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Result
+// ======================
+static void sm_alarm_fm_test_result( SmAlarmFmResultT* result )
+{
+    memcpy( &(_results[_results_total % SM_ALARM_FM_QUEUE_MAX]), result,
+            sizeof(SmAlarmFmResultT) );
+    ++_results_total;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Wait
+// ====================
+// Dispatches results until the total is reached, returns the last result.
+static SmAlarmFmResultT* sm_alarm_fm_test_wait( unsigned int total,
+    long timeout_ms )
+{
+    SmTimeT time_prev;
+
+    sm_time_get( &time_prev );
+
+    while( total > _results_total )
+    {
+        if( timeout_ms <= sm_time_get_elapsed_ms( &time_prev ) )
+        {
+            return( NULL );
+        }
+
+        sm_selobj_dispatch( 50 );
+    }
+
+    return( &(_results[(_results_total - 1) % SM_ALARM_FM_QUEUE_MAX]) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Counter
+// =======================
+// Reads a counter back from the dump of the alarm FM data.
+static unsigned long sm_alarm_fm_test_counter( const char name[] )
+{
+    char* buffer = NULL;
+    size_t buffer_size = 0;
+    unsigned long value = 0;
+    const char* line;
+    FILE* log;
+
+    log = open_memstream( &buffer, &buffer_size );
+    if( NULL == log )
+    {
+        return( 0 );
+    }
+
+    sm_alarm_fm_dump_data( log );
+    fclose( log );
+
+    line = strstr( buffer, name );
+    if( NULL != line )
+    {
+        line += strlen( name );
+        line += strspn( line, "." );
+        value = strtoul( line, NULL, 10 );
+    }
+
+    free( buffer );
+
+    return( value );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Open Files
+// ==========================
+static unsigned int sm_alarm_fm_test_open_files( void )
+{
+    unsigned int total = 0;
+    struct dirent* entry;
+    DIR* dir;
+
+    dir = opendir( "/proc/self/fd" );
+    if( NULL == dir )
+    {
+        return( 0 );
+    }
+
+    while( NULL != (entry = readdir( dir )) )
+    {
+        if( '.' != entry->d_name[0] )
+        {
+            ++total;
+        }
+    }
+
+    closedir( dir );
+
+    return( total );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Alarm Data
+// ==========================
+static void sm_alarm_fm_test_alarm_data( const char entity_name[],
+    SFmAlarmDataT* fm_alarm_data, AlarmFilter* fm_filter )
+{
+    memset( fm_alarm_data, 0, sizeof(SFmAlarmDataT) );
+    snprintf( fm_alarm_data->alarm_id, sizeof(fm_alarm_data->alarm_id),
+              "%s", SM_ALARM_COMMUNICATION_FAILURE_ALARM_ID );
+    snprintf( fm_alarm_data->entity_instance_id,
+              sizeof(fm_alarm_data->entity_instance_id),
+              "host=%s.network=%s", SM_ALARM_FM_TEST_NODE_NAME, entity_name );
+    fm_alarm_data->alarm_state = FM_ALARM_STATE_SET;
+    fm_alarm_data->severity = FM_ALARM_SEVERITY_MAJOR;
+
+    memset( fm_filter, 0, sizeof(AlarmFilter) );
+    snprintf( fm_filter->alarm_id, sizeof(fm_filter->alarm_id), "%s",
+              fm_alarm_data->alarm_id );
+    snprintf( fm_filter->entity_instance_id,
+              sizeof(fm_filter->entity_instance_id), "%s",
+              fm_alarm_data->entity_instance_id );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Requests
+// ========================
+static void sm_alarm_fm_test_requests( void )
+{
+    SFmAlarmDataT fm_alarm_data;
+    AlarmFilter fm_filter;
+    SmAlarmFmResultT* result;
+    int context;
+
+    sm_alarm_fm_test_alarm_data( "mgmt", &fm_alarm_data, &fm_filter );
+
+    sm_alarm_fm_test_check(
+        SM_OKAY == sm_alarm_fm_raise( &context, 7, &fm_alarm_data ),
+        "raise queued" );
+
+    result = sm_alarm_fm_test_wait( 1, 2000 );
+    sm_alarm_fm_test_check(( NULL != result )&&
+                           ( SM_ALARM_FM_REQUEST_RAISE == result->type )&&
+                           ( &context == result->context )&&
+                           ( 7 == result->generation )&&
+                           ( FM_ERR_OK == result->fm_error )&&
+                           ( result->found )&&( '\0' != result->fm_uuid[0] ),
+                           "raise result dispatched" );
+
+    sm_alarm_fm_get( &context, 8, &fm_filter );
+    result = sm_alarm_fm_test_wait( 2, 2000 );
+    sm_alarm_fm_test_check(( NULL != result )&&
+                           ( SM_ALARM_FM_REQUEST_GET == result->type )&&
+                           ( 8 == result->generation )&&( result->found ),
+                           "get finds raised alarm" );
+
+    sm_alarm_fm_clear( &context, 9, &fm_filter );
+    result = sm_alarm_fm_test_wait( 3, 2000 );
+    sm_alarm_fm_test_check(( NULL != result )&&
+                           ( SM_ALARM_FM_REQUEST_CLEAR == result->type )&&
+                           ( FM_ERR_OK == result->fm_error ),
+                           "clear result dispatched" );
+
+    sm_alarm_fm_get( &context, 10, &fm_filter );
+    result = sm_alarm_fm_test_wait( 4, 2000 );
+    sm_alarm_fm_test_check(( NULL != result )&&
+                           ( FM_ERR_ENTITY_NOT_FOUND == result->fm_error )&&
+                           ( !result->found ),
+                           "get misses cleared alarm" );
+
+    sm_alarm_fm_test_check(
+        ( 0 == sm_alarm_fm_test_counter( "outstanding" ) )&&
+        ( 4 == sm_alarm_fm_test_counter( "completed" ) ),
+        "requests counted" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Retries
+// =======================
+static void sm_alarm_fm_test_retries( void )
+{
+    SFmAlarmDataT fm_alarm_data;
+    AlarmFilter fm_filter;
+    SmAlarmFmResultT* result;
+    SmTimeT time_prev;
+    long backoff_ms = 0;
+    long ms_expired;
+
+    sm_alarm_fm_test_alarm_data( "oam", &fm_alarm_data, &fm_filter );
+
+    int attempt;
+    for( attempt=0; SM_ALARM_FM_RETRY_MAX > attempt; ++attempt )
+    {
+        backoff_ms += SM_ALARM_FM_RETRY_DELAY_IN_MS << attempt;
+    }
+
+    setenv( "SM_FM_LOCAL_FAIL_EVERY", "1", 1 );
+
+    sm_time_get( &time_prev );
+    sm_alarm_fm_raise( NULL, 1, &fm_alarm_data );
+    result = sm_alarm_fm_test_wait( _results_total + 1, backoff_ms + 2000 );
+    ms_expired = sm_time_get_elapsed_ms( &time_prev );
+
+    sm_alarm_fm_test_check(( NULL != result )&&
+                           ( FM_ERR_NOCONNECT == result->fm_error ),
+                           "raise fails after retries" );
+    sm_alarm_fm_test_check( backoff_ms <= ms_expired,
+                            "retries back off" );
+    sm_alarm_fm_test_check(
+        ( SM_ALARM_FM_RETRY_MAX == sm_alarm_fm_test_counter( "retries" ) )&&
+        ( 1 == sm_alarm_fm_test_counter( "failed" ) ),
+        "retries counted" );
+
+    // FM comes back while the worker backs off from the first attempt.
+    sm_alarm_fm_raise( NULL, 2, &fm_alarm_data );
+    usleep( 100000 );
+    unsetenv( "SM_FM_LOCAL_FAIL_EVERY" );
+
+    result = sm_alarm_fm_test_wait( _results_total + 1, backoff_ms + 2000 );
+    sm_alarm_fm_test_check(( NULL != result )&&
+                           ( FM_ERR_OK == result->fm_error )&&
+                           ( SM_ALARM_FM_RETRY_MAX + 1 ==
+                             sm_alarm_fm_test_counter( "retries" ) ),
+                           "raise succeeds on retry" );
+
+    // Every request now backs off, the queue fills behind the first.
+    setenv( "SM_FM_LOCAL_FAIL_EVERY", "1", 1 );
+
+    bool queued = true;
+    unsigned int request_i;
+    for( request_i=0; SM_ALARM_FM_QUEUE_MAX > request_i; ++request_i )
+    {
+        if( SM_OKAY != sm_alarm_fm_raise( NULL, request_i, &fm_alarm_data ) )
+        {
+            queued = false;
+        }
+    }
+
+    sm_alarm_fm_test_check( queued, "queue accepts its maximum" );
+    sm_alarm_fm_test_check(
+        ( SM_OKAY != sm_alarm_fm_raise( NULL, 0, &fm_alarm_data ) )&&
+        ( 1 == sm_alarm_fm_test_counter( "queue_full" ) ),
+        "queue full refused" );
+
+    usleep( 100000 );
+
+    sm_time_get( &time_prev );
+    sm_alarm_fm_finalize();
+    ms_expired = sm_time_get_elapsed_ms( &time_prev );
+
+    sm_alarm_fm_test_check( SM_ALARM_FM_RETRY_DELAY_IN_MS > ms_expired,
+                            "finalize interrupts backoff" );
+
+    unsetenv( "SM_FM_LOCAL_FAIL_EVERY" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Blocked
+// =======================
+// Finalizes while the worker is held in FM past the stop timeout.
+static void sm_alarm_fm_test_blocked( void )
+{
+    SFmAlarmDataT fm_alarm_data;
+    AlarmFilter fm_filter;
+    SmAlarmFmResultT* result;
+    SmTimeT time_prev;
+    unsigned int open_files;
+    unsigned int results_total;
+    long ms_expired;
+
+    sm_alarm_fm_test_alarm_data( "cluster-host", &fm_alarm_data,
+                                 &fm_filter );
+
+    open_files = sm_alarm_fm_test_open_files();
+
+    if( SM_OKAY != sm_alarm_fm_initialize( sm_alarm_fm_test_result ) )
+    {
+        sm_alarm_fm_test_check( false, "initialize" );
+        return;
+    }
+
+    setenv( "SM_FM_LOCAL_DELAY_MS", "6500", 1 );
+
+    results_total = _results_total;
+    sm_alarm_fm_raise( NULL, 1, &fm_alarm_data );
+    usleep( 200000 );
+
+    unsetenv( "SM_FM_LOCAL_DELAY_MS" );
+
+    sm_time_get( &time_prev );
+    sm_alarm_fm_finalize();
+    ms_expired = sm_time_get_elapsed_ms( &time_prev );
+
+    sm_alarm_fm_test_check(( 5000 <= ms_expired )&&( 6000 > ms_expired ),
+                           "finalize gives up on blocked worker" );
+    sm_alarm_fm_test_check(
+        SM_OKAY != sm_alarm_fm_initialize( sm_alarm_fm_test_result ),
+        "initialize refused while worker blocked" );
+
+    sm_time_get( &time_prev );
+    while(( open_files < sm_alarm_fm_test_open_files() )&&
+          ( 3000 > sm_time_get_elapsed_ms( &time_prev ) ))
+    {
+        usleep( 50000 );
+    }
+
+    sm_alarm_fm_test_check( open_files == sm_alarm_fm_test_open_files(),
+                            "blocked worker closes event fd" );
+
+    if( SM_OKAY != sm_alarm_fm_initialize( sm_alarm_fm_test_result ) )
+    {
+        sm_alarm_fm_test_check( false, "initialize after worker returned" );
+        return;
+    }
+
+    sm_alarm_fm_raise( NULL, 2, &fm_alarm_data );
+    result = sm_alarm_fm_test_wait( results_total + 1, 2000 );
+    sm_alarm_fm_test_check(( NULL != result )&&
+                           ( results_total + 1 == _results_total )&&
+                           ( 2 == result->generation )&&
+                           ( FM_ERR_OK == result->fm_error ),
+                           "blocked result not dispatched" );
+
+    sm_alarm_fm_finalize();
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Raised
+// ======================
+static bool sm_alarm_fm_test_raised( const char entity_name[] )
+{
+    SFmAlarmDataT fm_alarm_data;
+    AlarmFilter fm_filter;
+
+    sm_alarm_fm_test_alarm_data( entity_name, &fm_alarm_data, &fm_filter );
+
+    return( FM_ERR_OK == fm_get_fault_wrapper( &fm_filter, &fm_alarm_data ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Settle
+// ======================
+// Waits for the alarm to reach the state in FM and its result to be taken
+// by the alarm thread.
+static bool sm_alarm_fm_test_settle( const char entity_name[], bool raised )
+{
+    SmTimeT time_prev;
+
+    sm_time_get( &time_prev );
+
+    while( 5000 > sm_time_get_elapsed_ms( &time_prev ) )
+    {
+        if(( raised == sm_alarm_fm_test_raised( entity_name ) )&&
+           ( 0 == sm_alarm_fm_test_counter( "outstanding" ) ))
+        {
+            return( true );
+        }
+
+        usleep( 50000 );
+    }
+
+    return( false );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Raise
+// =====================
+static void sm_alarm_fm_test_raise( const char entity_name[] )
+{
+    sm_alarm_raise_communication_alarm( SM_ALARM_COMMUNICATION_FAILURE,
+        SM_ALARM_FM_TEST_NODE_NAME, entity_name, SM_ALARM_SEVERITY_MAJOR,
+        SM_ALARM_PROBABLE_CAUSE_UNDERLYING_RESOURCE_UNAVAILABLE,
+        "communication failure", "", "", true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Clear
+// =====================
+static void sm_alarm_fm_test_clear( const char entity_name[] )
+{
+    sm_alarm_clear( SM_ALARM_COMMUNICATION_FAILURE,
+                    SM_ALARM_FM_TEST_NODE_NAME, "", entity_name );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Coalescing
+// ==========================
+static void sm_alarm_fm_test_coalescing( void )
+{
+    fm_ent_inst_t fm_entity_instance_id;
+    unsigned long raises;
+    unsigned long clears;
+
+    // Start from an empty FM, the alarms of the queue checks are left.
+    snprintf( fm_entity_instance_id, sizeof(fm_entity_instance_id),
+              "host=%s", SM_ALARM_FM_TEST_NODE_NAME );
+    fm_clear_all_wrapper( &fm_entity_instance_id );
+
+    if( SM_OKAY != sm_alarm_initialize() )
+    {
+        sm_alarm_fm_test_check( false, "alarm initialize" );
+        return;
+    }
+
+    // Let the first audit find FM empty.
+    usleep( 1000000 );
+
+    raises = sm_alarm_fm_test_counter( "raise_requests" );
+    clears = sm_alarm_fm_test_counter( "clear_requests" );
+
+    sm_alarm_fm_test_raise( "mgmt" );
+    sm_alarm_fm_test_clear( "mgmt" );
+    sm_alarm_fm_test_raise( "mgmt" );
+    sm_alarm_fm_test_raise( "oam" );
+    sm_alarm_fm_test_clear( "oam" );
+
+    sm_alarm_fm_test_check( sm_alarm_fm_test_settle( "mgmt", true ),
+                            "flapping alarm raised" );
+    sm_alarm_fm_test_check(
+        ( raises + 1 == sm_alarm_fm_test_counter( "raise_requests" ) )&&
+        ( clears == sm_alarm_fm_test_counter( "clear_requests" ) ),
+        "raise, clear, raise sends one raise" );
+    sm_alarm_fm_test_check( !sm_alarm_fm_test_raised( "oam" ),
+                            "raise, clear sends nothing" );
+
+    sm_alarm_fm_test_clear( "mgmt" );
+    sm_alarm_fm_test_raise( "mgmt" );
+    sm_alarm_fm_test_raise( "cluster-host" );
+
+    sm_alarm_fm_test_check( sm_alarm_fm_test_settle( "cluster-host", true ),
+                            "marker alarm raised" );
+    sm_alarm_fm_test_check(
+        ( raises + 2 == sm_alarm_fm_test_counter( "raise_requests" ) )&&
+        ( clears == sm_alarm_fm_test_counter( "clear_requests" ) )&&
+        ( sm_alarm_fm_test_raised( "mgmt" ) ),
+        "clear, raise of raised alarm sends nothing" );
+
+    sm_alarm_fm_test_clear( "mgmt" );
+
+    sm_alarm_fm_test_check(( sm_alarm_fm_test_settle( "mgmt", false ) )&&
+        ( clears + 1 == sm_alarm_fm_test_counter( "clear_requests" ) ),
+        "clear sends one clear" );
+
+    sm_alarm_finalize();
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm FM Test - Main
+// ====================
+int main( int argc, char *argv[], char *envp[] )
+{
+    unsetenv( "SM_FM_LOCAL_FAIL_EVERY" );
+    unsetenv( "SM_FM_LOCAL_DELAY_MS" );
+
+    if(( SM_OKAY != fm_mutex_initialize() )||
+       ( SM_OKAY != sm_thread_health_mutex_initialize() )||
+       ( SM_OKAY != sm_selobj_mutex_initialize() )||
+       ( SM_OKAY != sm_timer_mutex_initialize() )||
+       ( SM_OKAY != sm_selobj_initialize() )||
+       ( SM_OKAY != sm_alarm_fm_initialize( sm_alarm_fm_test_result ) ))
+    {
+        printf( "FAIL: initialize\n" );
+        return( EXIT_FAILURE );
+    }
+
+    printf( "alarm FM queue\n" );
+    sm_alarm_fm_test_requests();
+    sm_alarm_fm_test_retries();
+    sm_alarm_fm_test_blocked();
+
+    printf( "alarm thread\n" );
+    sm_alarm_fm_test_coalescing();
+
+    printf( "%u failed\n", _failures );
+
+    return( ( 0 == _failures ) ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+// ****************************************************************************
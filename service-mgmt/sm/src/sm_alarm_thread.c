@@ -34,14 +34,17 @@
 #include "sm_selobj.h"
 #include "sm_node_utils.h"
 #include "sm_thread_health.h"
+#include "sm_journal.h"
+#include "sm_alarm_fm.h"
 
 #define SM_ALARM_THREAD_NAME                                         "sm_alarm"
 #define SM_ALARM_THREAD_ALARM_REPORT_TIMER_IN_MS                           5000
 #define SM_ALARM_THREAD_ALARM_AUDIT_TIMER_IN_MS                           60000
+#define SM_ALARM_THREAD_ALARM_FLUSH_TIMER_IN_MS                           1000
 #define SM_ALARM_THREAD_TICK_INTERVAL_IN_MS                                5000
-#define SM_ALARM_CUSTOMER_LOG_FILE                 "/var/log/sm-customer.alarm"
+#define SM_ALARM_THREAD_RETRY_MAX_IN_MS                                   60000
+#define SM_ALARM_THREAD_HASH_BUCKETS                                        64
 
-#define SM_ALARM_ENTRY_INUSE                                         0xFDFDFDFD
 #define SM_ALARM_DOMAIN_ENTRY_INUSE                                  0xFDFDFDFD
 
 typedef enum
@@ -55,9 +58,10 @@ typedef enum
     SM_ALARM_STATE_MAX,
 } SmAlarmStateT;
 
-typedef struct
+typedef struct SmAlarmEntry
 {
-    uint32_t inuse;
+    struct SmAlarmEntry* next;
+    uint32_t hash;
     SmAlarmT alarm;
     SmAlarmStateT alarm_state;
     SmAlarmNodeNameT alarm_node_name;
@@ -73,6 +77,17 @@ typedef struct
     // External FM Alarm Data
     fm_uuid_t fm_uuid;
     SFmAlarmDataT fm_alarm_data;
+
+    // FM Request State, generation counts the changes of alarm_state so
+    // results of requests made for an older state are recognized.
+    uint32_t generation;
+    bool fm_raised;
+    bool fm_uncertain;
+    bool fm_inflight;
+    bool fm_seen;
+    bool removed;
+    unsigned int fm_failures;
+    SmTimeT fm_failure_time;
 } SmAlarmEntryT;
 
 typedef struct
@@ -87,12 +102,14 @@ static bool _thread_created = false;
 static pthread_t _alarm_thread;
 static SmTimerIdT _alarm_report_timer_id = SM_TIMER_ID_INVALID;
 static SmTimerIdT _alarm_audit_timer_id = SM_TIMER_ID_INVALID;
+static SmTimerIdT _alarm_flush_timer_id = SM_TIMER_ID_INVALID;
 static int _server_fd = -1;
 static bool _server_fd_registered = false;
-static SmAlarmEntryT _alarms[SM_ALARMS_MAX];
+static SmAlarmEntryT* _alarms[SM_ALARM_THREAD_HASH_BUCKETS];
+static SmAlarmEntryT* _retired_alarms = NULL;
+static bool _audit_all = true;
 static SmAlarmDomainEntryT _alarm_domains[SM_ALARM_DOMAINS_MAX];
 static uint64_t _customer_alarm_log_id = 0;
-static FILE * _customer_alarm_log = NULL;
  
 // ****************************************************************************
 // Alarm Thread - Event Type String
@@ -312,131 +329,176 @@ static const char * sm_alarm_thread_alarm_str( SmAlarmT alarm )
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Alarm Thread - Log Time String
+// ==============================
+static void sm_alarm_thread_log_time_str( struct timespec* ts_real,
+    char time_str[], int time_str_size )
+{
+    char date_str[32];
+    struct tm t_real;
+
+    if( NULL == localtime_r( &(ts_real->tv_sec), &t_real ) )
+    {
+        snprintf( time_str, time_str_size, "YYYY:MM:DD HH:MM:SS.xxx" );
+    } else {
+        strftime( date_str, sizeof(date_str), "%FT%T", &t_real );
+        snprintf( time_str, time_str_size, "%s.%03ld", date_str,
+                  ts_real->tv_nsec/1000000 );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm Thread - Log Field
+// ========================
+static void sm_alarm_thread_log_field( const char* fields[],
+    int* field_count, const char name[], const char value[] )
+{
+    fields[(*field_count)++] = name;
+    fields[(*field_count)++] = value;
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Alarm Thread - Log
 // ==================
+// Journals the alarm as the name and value pairs of the customer alarm
+// log, sm-journal displays it.
 static void sm_alarm_thread_log( SmAlarmEntryT* entry )
 {
-    char date_str[32];
-    struct tm t_real;
+    const char* fields[SM_JOURNAL_FIELDS_MAX];
+    char threshold_str[16];
+    char observed_str[16];
+    char raised_str[80];
+    char changed_str[80];
+    char cleared_str[80];
+    int field_count = 0;
+    int entity_field;
+    struct timespec ts_real;
+    SmErrorT error;
 
-    fprintf( _customer_alarm_log, "alarm-log-id:                  %" PRIu64 "\n",
-             ++_customer_alarm_log_id );
-    fprintf( _customer_alarm_log, "alarm-type:                    %s\n",
-             sm_alarm_thread_alarm_str( entry->alarm ) );
+    sm_alarm_thread_log_field( fields, &field_count, "alarm-type",
+                               sm_alarm_thread_alarm_str( entry->alarm ) );
 
     if( '\0' != entry->alarm_node_name[0] )
     {
-        fprintf( _customer_alarm_log, "alarm-node:                    %s\n",
-                 entry->alarm_node_name );
+        sm_alarm_thread_log_field( fields, &field_count, "alarm-node",
+                                   entry->alarm_node_name );
     }
 
-    fprintf( _customer_alarm_log, "alarm-domain:                  %s\n",
-             entry->alarm_domain_name );
-    fprintf( _customer_alarm_log, "alarm-entity:                  %s\n",
-             entry->alarm_entity_name );
-    fprintf( _customer_alarm_log, "alarm-event-type:              %s\n",
-             sm_alarm_thread_event_type_str( entry->alarm_data.event_type ) );
-    fprintf( _customer_alarm_log, "alarm-probable-cause:          %s\n",
-             sm_alarm_thread_probable_cause_str( entry->alarm_data.probable_cause ) );
+    sm_alarm_thread_log_field( fields, &field_count, "alarm-domain",
+                               entry->alarm_domain_name );
+
+    entity_field = field_count + 1;
+    sm_alarm_thread_log_field( fields, &field_count, "alarm-entity",
+                               entry->alarm_entity_name );
+
+    sm_alarm_thread_log_field( fields, &field_count, "alarm-event-type",
+        sm_alarm_thread_event_type_str( entry->alarm_data.event_type ) );
+    sm_alarm_thread_log_field( fields, &field_count, "alarm-probable-cause",
+        sm_alarm_thread_probable_cause_str( entry->alarm_data.probable_cause ) );
 
     if( '\0' != entry->alarm_data.specific_problem_text[0] )
     {
-        fprintf( _customer_alarm_log, "alarm-specific-problem-text:   %s\n",
-                 entry->alarm_data.specific_problem_text );
+        sm_alarm_thread_log_field( fields, &field_count,
+                                   "alarm-specific-problem-text",
+                                   entry->alarm_data.specific_problem_text );
     }
 
-    fprintf( _customer_alarm_log, "alarm-perceived-severity:      %s\n",
-             sm_alarm_thread_severity_str( entry->alarm_data.perceived_severity ) );
+    sm_alarm_thread_log_field( fields, &field_count,
+        "alarm-perceived-severity",
+        sm_alarm_thread_severity_str( entry->alarm_data.perceived_severity ) );
 
     if( SM_ALARM_SEVERITY_CLEARED != entry->alarm_data.perceived_severity )
     {
-        fprintf( _customer_alarm_log, "alarm-trend-indication:        %s\n",
-                 sm_alarm_thread_trend_str( entry->alarm_data.trend_indication ) );
+        sm_alarm_thread_log_field( fields, &field_count,
+            "alarm-trend-indication",
+            sm_alarm_thread_trend_str( entry->alarm_data.trend_indication ) );
     }
 
     if( entry->alarm_data.state_info.applicable )
     {
-        fprintf( _customer_alarm_log, "alarm-entity-state:            %s\n", 
-                 entry->alarm_data.state_info.state );
-        fprintf( _customer_alarm_log, "alarm-entity-status:           %s\n",
-                 entry->alarm_data.state_info.status );
-        fprintf( _customer_alarm_log, "alarm-entity-condition:        %s\n",
-                 entry->alarm_data.state_info.condition );
+        sm_alarm_thread_log_field( fields, &field_count, "alarm-entity-state",
+                                   entry->alarm_data.state_info.state );
+        sm_alarm_thread_log_field( fields, &field_count, "alarm-entity-status",
+                                   entry->alarm_data.state_info.status );
+        sm_alarm_thread_log_field( fields, &field_count,
+                                   "alarm-entity-condition",
+                                   entry->alarm_data.state_info.condition );
     }
 
     if( entry->alarm_data.threshold_info.applicable )
     {
-        fprintf( _customer_alarm_log, "alarm-threshold-value:         %i\n",
-                 entry->alarm_data.threshold_info.threshold_value );
-        fprintf( _customer_alarm_log, "alarm-observed_value:          %i\n",
-                 entry->alarm_data.threshold_info.observed_value );
+        snprintf( threshold_str, sizeof(threshold_str), "%i",
+                  entry->alarm_data.threshold_info.threshold_value );
+        snprintf( observed_str, sizeof(observed_str), "%i",
+                  entry->alarm_data.threshold_info.observed_value );
+
+        sm_alarm_thread_log_field( fields, &field_count,
+                                   "alarm-threshold-value", threshold_str );
+        sm_alarm_thread_log_field( fields, &field_count,
+                                   "alarm-observed_value", observed_str );
     }
 
     if( '\0' != entry->alarm_data.proposed_repair_action[0] )
     {
-        fprintf( _customer_alarm_log, "alarm-proposed-repair-action:  %s\n",
-                 entry->alarm_data.proposed_repair_action );
+        sm_alarm_thread_log_field( fields, &field_count,
+                                   "alarm-proposed-repair-action",
+                                   entry->alarm_data.proposed_repair_action );
     }
 
     if( '\0' != entry->alarm_data.additional_text[0] )
     {
-        fprintf( _customer_alarm_log, "alarm-additional-text:         %s\n",
-                 entry->alarm_data.additional_text );
+        sm_alarm_thread_log_field( fields, &field_count,
+                                   "alarm-additional-text",
+                                   entry->alarm_data.additional_text );
     }
 
     if( SM_ALARM_SEVERITY_CLEARED != entry->alarm_data.perceived_severity )
     {
-        fprintf( _customer_alarm_log, "alarm-service-affecting:       %s\n",
-                 entry->alarm_data.service_affecting ? "yes" : "no" );
-        fprintf( _customer_alarm_log, "alarm-suppression-allowed:     %s\n",
-                 entry->alarm_data.suppression_allowed ? "yes" : "no" );
+        sm_alarm_thread_log_field( fields, &field_count,
+            "alarm-service-affecting",
+            entry->alarm_data.service_affecting ? "yes" : "no" );
+        sm_alarm_thread_log_field( fields, &field_count,
+            "alarm-suppression-allowed",
+            entry->alarm_data.suppression_allowed ? "yes" : "no" );
     }
 
     if( 0 != entry->alarm_raised_time.tv_sec )
     {
-        if( NULL == localtime_r( &(entry->alarm_raised_time.tv_sec), &t_real ) )
-        {
-            fprintf( _customer_alarm_log, "alarm-raised-time:             "
-                     "YYYY:MM:DD HH:MM:SS.xxx\n" );
-        } else {
-            strftime( date_str, sizeof(date_str), "%FT%T", &t_real );
-            fprintf( _customer_alarm_log, "alarm-raised-time:             "
-                     "%s.%03ld\n", date_str,
-                     entry->alarm_raised_time.tv_nsec/1000000 );
-        }
+        sm_alarm_thread_log_time_str( &(entry->alarm_raised_time),
+                                      raised_str, sizeof(raised_str) );
+        sm_alarm_thread_log_field( fields, &field_count, "alarm-raised-time",
+                                   raised_str );
     }
 
     if( 0 != entry->alarm_changed_time.tv_sec )
     {
-        if( NULL == localtime_r( &(entry->alarm_changed_time.tv_sec), &t_real ) )
-        {
-            fprintf( _customer_alarm_log, "alarm-changed-time:            "
-                     "YYYY:MM:DD HH:MM:SS.xxx\n" );
-        } else {
-            strftime( date_str, sizeof(date_str), "%FT%T", &t_real );
-            fprintf( _customer_alarm_log, "alarm-changed-time:            "
-                     "%s.%03ld\n", date_str,
-                     entry->alarm_changed_time.tv_nsec/1000000 );
-        }
+        sm_alarm_thread_log_time_str( &(entry->alarm_changed_time),
+                                      changed_str, sizeof(changed_str) );
+        sm_alarm_thread_log_field( fields, &field_count, "alarm-changed-time",
+                                   changed_str );
     }
 
     if( 0 != entry->alarm_cleared_time.tv_sec )
     {
-        if( NULL == localtime_r( &(entry->alarm_cleared_time.tv_sec), &t_real ) )
-        {
-            fprintf( _customer_alarm_log, "alarm-cleared-time:            "
-                     "YYYY:MM:DD HH:MM:SS.xxx\n" );
-        } else {
-            strftime( date_str, sizeof(date_str), "%FT%T", &t_real );
-            fprintf( _customer_alarm_log, "alarm-cleared-time:            "
-                     "%s.%03ld\n", date_str,
-                     entry->alarm_cleared_time.tv_nsec/1000000 );
-        }
+        sm_alarm_thread_log_time_str( &(entry->alarm_cleared_time),
+                                      cleared_str, sizeof(cleared_str) );
+        sm_alarm_thread_log_field( fields, &field_count, "alarm-cleared-time",
+                                   cleared_str );
     }
 
-    fprintf( _customer_alarm_log, "\n" );
-    fflush( _customer_alarm_log );
+    clock_gettime( CLOCK_REALTIME, &ts_real );
+
+    error = sm_journal_append( SM_JOURNAL_EVENT_ALARM,
+                               ++_customer_alarm_log_id, &ts_real,
+                               entity_field, field_count, fields );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to journal alarm for %s, error=%s.",
+                  entry->alarm_entity_name, sm_error_str( error ) );
+    }
 }
 // ****************************************************************************
 
@@ -521,22 +583,33 @@ static bool sm_alarm_thread_domain_managed( SmAlarmT alarm )
 // ****************************************************************************
 
 // ****************************************************************************
-// Alarm Thread - Find Empty
-// =========================
-static SmAlarmEntryT* sm_alarm_thread_find_empty( void )
+// Alarm Thread - Hash
+// ===================
+static uint32_t sm_alarm_thread_hash( SmAlarmT alarm,
+    const char node_name[], const char domain_name[],
+    const char entity_name[] )
 {
-    SmAlarmEntryT* entry;
+    const char* names[] = { node_name, domain_name, entity_name };
+    const char* name;
+    uint32_t hash = 2166136261U;
+
+    hash ^= (uint32_t) alarm;
+    hash *= 16777619U;
 
-    unsigned int entry_i;
-    for( entry_i=0; SM_ALARMS_MAX > entry_i; ++entry_i )
+    unsigned int name_i;
+    for( name_i=0; (sizeof(names)/sizeof(names[0])) > name_i; ++name_i )
     {
-        entry = &(_alarms[entry_i]);
+        for( name = names[name_i]; '\0' != *name; ++name )
+        {
+            hash ^= (uint8_t) *name;
+            hash *= 16777619U;
+        }
 
-        if( SM_ALARM_ENTRY_INUSE != entry->inuse )
-            return( entry );
+        hash ^= 0xFF;
+        hash *= 16777619U;
     }
 
-    return( NULL );
+    return( hash );
 }
 // ****************************************************************************
 
@@ -548,16 +621,14 @@ static SmAlarmEntryT* sm_alarm_thread_find( SmAlarmT alarm,
     SmAlarmEntityNameT entity_name )
 {
     SmAlarmEntryT* entry;
+    uint32_t hash;
 
-    unsigned int entry_i;
-    for( entry_i=0; SM_ALARMS_MAX > entry_i; ++entry_i )
-    {
-        entry = &(_alarms[entry_i]);
-
-        if( SM_ALARM_ENTRY_INUSE != entry->inuse )
-            continue;
+    hash = sm_alarm_thread_hash( alarm, node_name, domain_name, entity_name );
 
-        if(( alarm == entry->alarm )&&
+    for( entry = _alarms[hash % SM_ALARM_THREAD_HASH_BUCKETS];
+         NULL != entry; entry = entry->next )
+    {
+        if(( hash == entry->hash )&&( alarm == entry->alarm )&&
            ( 0 == strcmp( node_name,   entry->alarm_node_name   ) )&&
            ( 0 == strcmp( domain_name, entry->alarm_domain_name ) )&&
            ( 0 == strcmp( entity_name, entry->alarm_entity_name ) ))
@@ -568,6 +639,125 @@ static SmAlarmEntryT* sm_alarm_thread_find( SmAlarmT alarm,
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Alarm Thread - Allocate
+// =======================
+static SmAlarmEntryT* sm_alarm_thread_allocate( SmAlarmT alarm,
+    SmAlarmNodeNameT node_name, SmAlarmDomainNameT domain_name,
+    SmAlarmEntityNameT entity_name )
+{
+    SmAlarmEntryT* entry;
+    SmAlarmEntryT** bucket;
+
+    entry = (SmAlarmEntryT*) malloc( sizeof(SmAlarmEntryT) );
+    if( NULL == entry )
+    {
+        return( NULL );
+    }
+
+    memset( entry, 0, sizeof(SmAlarmEntryT) );
+
+    entry->alarm = alarm;
+    entry->alarm_state = SM_ALARM_STATE_INITIAL;
+    snprintf( entry->alarm_node_name, sizeof(entry->alarm_node_name),
+              "%s", node_name );
+    snprintf( entry->alarm_domain_name, sizeof(entry->alarm_domain_name),
+              "%s", domain_name );
+    snprintf( entry->alarm_entity_name, sizeof(entry->alarm_entity_name),
+              "%s", entity_name );
+    entry->hash = sm_alarm_thread_hash( alarm, entry->alarm_node_name,
+                                        entry->alarm_domain_name,
+                                        entry->alarm_entity_name );
+
+    // Until the first audit, FM may hold the alarm from before a restart.
+    entry->fm_uncertain = _audit_all;
+
+    bucket = &(_alarms[entry->hash % SM_ALARM_THREAD_HASH_BUCKETS]);
+    entry->next = *bucket;
+    *bucket = entry;
+
+    return( entry );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm Thread - Remove
+// =====================
+// Unlinks the entry, an entry with an FM request outstanding is retired
+// and freed when the result arrives.
+static void sm_alarm_thread_remove( SmAlarmEntryT* entry )
+{
+    SmAlarmEntryT** link;
+
+    for( link = &(_alarms[entry->hash % SM_ALARM_THREAD_HASH_BUCKETS]);
+         NULL != *link; link = &((*link)->next) )
+    {
+        if( entry == *link )
+        {
+            *link = entry->next;
+            break;
+        }
+    }
+
+    if( entry->fm_inflight )
+    {
+        entry->removed = true;
+        entry->next = _retired_alarms;
+        _retired_alarms = entry;
+    } else {
+        free( entry );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm Thread - Release Retired
+// ==============================
+static void sm_alarm_thread_release_retired( SmAlarmEntryT* entry )
+{
+    SmAlarmEntryT** link;
+
+    for( link = &_retired_alarms; NULL != *link; link = &((*link)->next) )
+    {
+        if( entry == *link )
+        {
+            *link = entry->next;
+            free( entry );
+            return;
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm Thread - Remove All
+// =========================
+static void sm_alarm_thread_remove_all( void )
+{
+    SmAlarmEntryT* entry;
+    SmAlarmEntryT* next;
+
+    unsigned int bucket_i;
+    for( bucket_i=0; SM_ALARM_THREAD_HASH_BUCKETS > bucket_i; ++bucket_i )
+    {
+        for( entry = _alarms[bucket_i]; NULL != entry; entry = next )
+        {
+            next = entry->next;
+            free( entry );
+        }
+        _alarms[bucket_i] = NULL;
+    }
+
+    for( entry = _retired_alarms; NULL != entry; entry = next )
+    {
+        next = entry->next;
+        free( entry );
+    }
+
+    _retired_alarms = NULL;
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Alarm Thread - Add
 // ==================
@@ -581,32 +771,37 @@ static void sm_alarm_thread_add( struct timespec* ts_real, SmAlarmT alarm,
     entry = sm_alarm_thread_find( alarm, node_name, domain_name, entity_name );
     if( NULL == entry )
     {
-        entry = sm_alarm_thread_find_empty();
+        entry = sm_alarm_thread_allocate( alarm, node_name, domain_name,
+                                          entity_name );
         if( NULL == entry )
         {
-            DPRINTFE( "Failed to store alarm, no more room." );
+            DPRINTFE( "Failed to store alarm, out of memory." );
             return;
-
-        } else {
-            // New alarm entry.
-            memset( entry, 0, sizeof(SmAlarmEntryT) );
-
-            entry->inuse = SM_ALARM_ENTRY_INUSE;
-            entry->alarm = alarm;
-            entry->alarm_state = SM_ALARM_STATE_INITIAL;
-            snprintf( entry->alarm_node_name, sizeof(entry->alarm_node_name),
-                      "%s", node_name );
-            snprintf( entry->alarm_domain_name, sizeof(entry->alarm_domain_name),
-                      "%s", domain_name );
-            snprintf( entry->alarm_entity_name, sizeof(entry->alarm_entity_name),
-                      "%s", entity_name );
         }
     }
 
     switch( entry->alarm_state )
     {
-        case SM_ALARM_STATE_INITIAL:
         case SM_ALARM_STATE_CLEARING:
+            if(( entry->fm_raised )&&( !entry->fm_uncertain )&&
+               ( 0 == memcmp( &(entry->alarm_data), data,
+                              sizeof(SmAlarmDataT) ) ))
+            {
+                // Cleared and raised again before the clear was sent,
+                // FM still has the alarm as raised.
+                memset( &(entry->alarm_cleared_time), 0, sizeof(struct timespec) );
+                entry->alarm_state = SM_ALARM_STATE_RAISED;
+                ++(entry->generation);
+                DPRINTFI( "Alarm (%s) for node (%s) domain (%s) entity (%s) "
+                          "raised again before clear was reported.",
+                          sm_alarm_thread_alarm_str( entry->alarm ),
+                          entry->alarm_node_name, entry->alarm_domain_name,
+                          entry->alarm_entity_name );
+                break;
+            }
+            // Fall through.
+
+        case SM_ALARM_STATE_INITIAL:
         case SM_ALARM_STATE_CLEARED:
             memcpy( &(entry->alarm_raised_time), ts_real, sizeof(struct timespec) );
             memset( &(entry->alarm_changed_time), 0, sizeof(struct timespec) );
@@ -632,6 +827,7 @@ static void sm_alarm_thread_add( struct timespec* ts_real, SmAlarmT alarm,
     if( raise_alarm )
     {
         entry->alarm_state = SM_ALARM_STATE_RAISING;
+        ++(entry->generation);
         memcpy( &(entry->alarm_data), data, sizeof(entry->alarm_data) );
         DPRINTFI( "Raising alarm (%s) for node (%s) domain (%s) entity (%s).",
                   sm_alarm_thread_alarm_str( entry->alarm ),
@@ -661,6 +857,10 @@ static void sm_alarm_thread_delete( struct timespec* ts_real, SmAlarmT alarm,
 
     if( SM_ALARM_STATE_CLEARED != entry->alarm_state )
     {
+        if( SM_ALARM_STATE_CLEARING != entry->alarm_state )
+        {
+            ++(entry->generation);
+        }
         memcpy( &(entry->alarm_cleared_time), ts_real, sizeof(struct timespec) );
         entry->alarm_state = SM_ALARM_STATE_CLEARING;
         DPRINTFI( "Clearing alarm (%s) for node (%s) domain (%s) entity (%s).",
@@ -673,7 +873,7 @@ static void sm_alarm_thread_delete( struct timespec* ts_real, SmAlarmT alarm,
                   sm_alarm_thread_alarm_str( entry->alarm ),
                   entry->alarm_node_name, entry->alarm_domain_name,
                   entry->alarm_entity_name );
-        entry->inuse = 0; //This alarm has reached the end of its lifecycle
+        sm_alarm_thread_remove( entry ); //This alarm has reached the end of its lifecycle
     }
 }
 // ****************************************************************************
@@ -1046,7 +1246,6 @@ static SmErrorT sm_alarm_thread_build_fm_alarm_data( SmAlarmEntryT* entry )
 // ==========================
 static void sm_alarm_thread_raise_alarm( SmAlarmEntryT* entry )
 {
-    EFmErrorT fm_error;
     SmErrorT error;
 
     if( SM_ALARM_SEVERITY_CLEARED == entry->alarm_data.perceived_severity )
@@ -1066,26 +1265,36 @@ static void sm_alarm_thread_raise_alarm( SmAlarmEntryT* entry )
         return;
     }
 
-    fm_error = fm_set_fault_wrapper( &(entry->fm_alarm_data),
-                                     &(entry->fm_uuid) );
-    if( FM_ERR_OK != fm_error )
+    error = sm_alarm_fm_raise( entry, entry->generation,
+                               &(entry->fm_alarm_data) );
+    if( SM_OKAY != error )
     {
-        DPRINTFE( "Failed to set alarm (%s) for node (%s) domain (%s) "
-                  "entity (%s), error=%i",
+        DPRINTFD( "FM queue full, raise of alarm (%s) for node (%s) "
+                  "domain (%s) entity (%s) deferred.",
                   sm_alarm_thread_alarm_str( entry->alarm ),
                   entry->alarm_node_name, entry->alarm_domain_name,
-                  entry->alarm_entity_name, fm_error );
+                  entry->alarm_entity_name );
         return;
     }
 
-    DPRINTFI( "Raised alarm (%s) for node (%s) domain (%s) entity (%s), "
-              "fm_uuid=%s.", sm_alarm_thread_alarm_str( entry->alarm ),
-              entry->alarm_node_name, entry->alarm_domain_name,
-              entry->alarm_entity_name, entry->fm_uuid );
+    entry->fm_inflight = true;
+}
+// ****************************************************************************
 
-    entry->alarm_state = SM_ALARM_STATE_RAISED;
+// ****************************************************************************
+// Alarm Thread - Alarm Cleared
+// ============================
+static void sm_alarm_thread_alarm_cleared( SmAlarmEntryT* entry )
+{
+    entry->alarm_state = SM_ALARM_STATE_CLEARED;
+    entry->alarm_data.perceived_severity = SM_ALARM_SEVERITY_CLEARED;
+    entry->alarm_data.state_info.applicable = false;
+    entry->alarm_data.threshold_info.applicable = false;
+    entry->alarm_data.proposed_repair_action[0] = '\0';
+    entry->alarm_data.additional_text[0] = '\0';
 
     sm_alarm_thread_log( entry );
+    sm_alarm_thread_remove( entry ); //This alarm has reached the end of its lifecycle
 }
 // ****************************************************************************
 
@@ -1096,9 +1305,20 @@ static void sm_alarm_thread_clear_alarm( SmAlarmEntryT* entry )
 {
     AlarmFilter fm_filter;
     char fm_entity_type_id[FM_MAX_BUFFER_LENGTH];
-    EFmErrorT fm_error;
     SmErrorT error;
 
+    if(( !entry->fm_raised )&&( !entry->fm_uncertain ))
+    {
+        // The raise never reached FM, nothing to clear.
+        DPRINTFI( "Alarm (%s) for node (%s) domain (%s) entity (%s) cleared "
+                  "before raise was reported.",
+                  sm_alarm_thread_alarm_str( entry->alarm ),
+                  entry->alarm_node_name, entry->alarm_domain_name,
+                  entry->alarm_entity_name );
+        sm_alarm_thread_remove( entry );
+        return;
+    }
+
     error = sm_alarm_thread_get_fm_alarm_id( entry->alarm,
                             entry->alarm_node_name, entry->alarm_domain_name,
                             entry->alarm_entity_name, fm_filter.alarm_id,
@@ -1111,31 +1331,18 @@ static void sm_alarm_thread_clear_alarm( SmAlarmEntryT* entry )
         return;
     }
 
-    fm_error = fm_clear_fault_wrapper( &fm_filter );
-    if(( FM_ERR_OK != fm_error )&&( FM_ERR_ENTITY_NOT_FOUND != fm_error ))
+    error = sm_alarm_fm_clear( entry, entry->generation, &fm_filter );
+    if( SM_OKAY != error )
     {
-        DPRINTFE( "Failed to clear alarm (%s) for node (%s) domain (%s) "
-                  "entity (%s), error=%i",
+        DPRINTFD( "FM queue full, clear of alarm (%s) for node (%s) "
+                  "domain (%s) entity (%s) deferred.",
                   sm_alarm_thread_alarm_str( entry->alarm ),
                   entry->alarm_node_name, entry->alarm_domain_name,
-                  entry->alarm_entity_name, fm_error );
+                  entry->alarm_entity_name );
         return;
     }
 
-    DPRINTFI( "Cleared alarm (%s) for node (%s) domain (%s) entity (%s), "
-              "fm_uuid=%s.", sm_alarm_thread_alarm_str( entry->alarm ),
-              entry->alarm_node_name, entry->alarm_domain_name,
-              entry->alarm_entity_name, entry->fm_uuid );
-
-    entry->alarm_state = SM_ALARM_STATE_CLEARED;
-    entry->alarm_data.perceived_severity = SM_ALARM_SEVERITY_CLEARED;
-    entry->alarm_data.state_info.applicable = false;
-    entry->alarm_data.threshold_info.applicable = false;
-    entry->alarm_data.proposed_repair_action[0] = '\0';
-    entry->alarm_data.additional_text[0] = '\0';
-
-    sm_alarm_thread_log( entry );
-    entry->inuse = 0; //This alarm has reached the end of its lifecycle
+    entry->fm_inflight = true;
 }
 // ****************************************************************************
 
@@ -1145,48 +1352,48 @@ static void sm_alarm_thread_clear_alarm( SmAlarmEntryT* entry )
 static void sm_alarm_thread_clear_all( struct timespec* ts_real, 
     SmAlarmDomainNameT domain_name )
 {
-    char date_str[32];
-    struct tm t_real;
+    const char* fields[1];
     char fm_entity_instance_id[FM_MAX_BUFFER_LENGTH];
-    EFmErrorT fm_error;
-    SmAlarmEntryT* entry = NULL;
+    SmAlarmEntryT* entry;
+    SmAlarmEntryT* next;
+    SmErrorT error;
 
     snprintf( fm_entity_instance_id, FM_MAX_BUFFER_LENGTH,
               "service_domain=%s", domain_name );
 
-    fm_error = fm_clear_all_wrapper( &fm_entity_instance_id );
-    if(( FM_ERR_OK != fm_error )&&( FM_ERR_ENTITY_NOT_FOUND != fm_error ))
+    error = sm_alarm_fm_clear_all( NULL, 0, fm_entity_instance_id );
+    if( SM_OKAY != error )
     {
-        DPRINTFE( "Failed to clear service domain (%s) alarms, error=%i",
-                  domain_name, fm_error );
+        DPRINTFE( "Failed to queue clear of service domain (%s) alarms, "
+                  "audit will clear them.", domain_name );
+        _audit_all = true;
     }
 
     DPRINTFI( "Cleared all alarms." );
 
-    unsigned int entry_i;
-    for( entry_i=0; SM_ALARMS_MAX > entry_i; ++entry_i )
+    unsigned int bucket_i;
+    for( bucket_i=0; SM_ALARM_THREAD_HASH_BUCKETS > bucket_i; ++bucket_i )
     {
-        entry = &(_alarms[entry_i]);
-
-        if( SM_ALARM_ENTRY_INUSE != entry->inuse )
-            continue;
-
-        if( 0 == strcmp( domain_name, entry->alarm_domain_name ) )
+        for( entry = _alarms[bucket_i]; NULL != entry; entry = next )
         {
-            memset( entry, 0, sizeof(SmAlarmEntryT) );
+            next = entry->next;
+
+            if( 0 == strcmp( domain_name, entry->alarm_domain_name ) )
+            {
+                sm_alarm_thread_remove( entry );
+            }
         }
     }
 
-    if( NULL == localtime_r( &(ts_real->tv_sec), &t_real ) )
+    fields[0] = domain_name;
+
+    error = sm_journal_append( SM_JOURNAL_EVENT_ALARMS_CLEARED,
+                               _customer_alarm_log_id, ts_real, 0, 1,
+                               fields );
+    if( SM_OKAY != error )
     {
-        fprintf( _customer_alarm_log,
-                 "----- all alarms cleared for %s -----\n\n",
-                 domain_name );
-    } else {
-        strftime( date_str, sizeof(date_str), "%FT%T", &t_real );
-        fprintf( _customer_alarm_log, "----- all alarms cleared for %s at "
-                 "%s.%03ld -----\n\n", domain_name, date_str,
-                 ts_real->tv_nsec/1000000 );
+        DPRINTFE( "Failed to journal alarms cleared for %s, error=%s.",
+                  domain_name, sm_error_str( error ) );
     }
 }
 // ****************************************************************************
@@ -1198,6 +1405,7 @@ static void sm_alarm_thread_manage_domain_alarms(
     SmAlarmDomainNameT domain_name, bool manage )
 {
     SmAlarmEntryT* entry;
+    SmAlarmEntryT* next;
     SmAlarmDomainEntryT* domain_entry;
 
     domain_entry = sm_alarm_thread_find_domain( domain_name );
@@ -1223,50 +1431,266 @@ static void sm_alarm_thread_manage_domain_alarms(
     if( manage )
     {
         DPRINTFI( "Managing alarms for domain (%s).", domain_name );
+
+        // FM may hold alarms of the domain raised by the previous manager.
+        _audit_all = true;
                   
     } else {
         DPRINTFI( "No longer managing alarms for domain (%s).", domain_name );
 
-        unsigned int entry_i;
-        for( entry_i=0; SM_ALARMS_MAX > entry_i; ++entry_i )
+        unsigned int bucket_i;
+        for( bucket_i=0; SM_ALARM_THREAD_HASH_BUCKETS > bucket_i; ++bucket_i )
         {
-            entry = &(_alarms[entry_i]);
-
-            if( SM_ALARM_ENTRY_INUSE == entry->inuse )
+            for( entry = _alarms[bucket_i]; NULL != entry; entry = next )
             {
+                next = entry->next;
+
                 if( sm_alarm_thread_domain_managed( entry->alarm ) )
                 {
-                    memset( entry, 0, sizeof(SmAlarmEntryT) );
+                    sm_alarm_thread_remove( entry );
                 }
             }
-        }    
+        }
     }
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Alarm Thread - Retry Pending
+// ============================
+// Backs off an alarm whose FM requests failed, doubling from the report
+// interval up to a minute.
+static bool sm_alarm_thread_retry_pending( SmAlarmEntryT* entry )
+{
+    long backoff_ms;
+    unsigned int shift;
+
+    if( 0 == entry->fm_failures )
+    {
+        return( false );
+    }
+
+    shift = entry->fm_failures - 1;
+    if( 4 < shift )
+    {
+        shift = 4;
+    }
+
+    backoff_ms = (long) SM_ALARM_THREAD_ALARM_REPORT_TIMER_IN_MS << shift;
+    if( SM_ALARM_THREAD_RETRY_MAX_IN_MS < backoff_ms )
+    {
+        backoff_ms = SM_ALARM_THREAD_RETRY_MAX_IN_MS;
+    }
+
+    return( backoff_ms > sm_time_get_elapsed_ms( &(entry->fm_failure_time) ) );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Alarm Thread - Report
 // =====================
+// Sends the current state of each changed alarm, the raises and clears
+// made since the last report are coalesced into that one state.
 static void sm_alarm_thread_report( void )
 {
     SmAlarmEntryT* entry;
+    SmAlarmEntryT* next;
 
-    unsigned int entry_i;
-    for( entry_i=0; SM_ALARMS_MAX > entry_i; ++entry_i )
+    unsigned int bucket_i;
+    for( bucket_i=0; SM_ALARM_THREAD_HASH_BUCKETS > bucket_i; ++bucket_i )
     {
-        entry = &(_alarms[entry_i]);
+        for( entry = _alarms[bucket_i]; NULL != entry; entry = next )
+        {
+            next = entry->next;
 
-        if( SM_ALARM_ENTRY_INUSE != entry->inuse )
-            continue;
-        
-        // Call Fault Management.
-        if( SM_ALARM_STATE_CLEARING == entry->alarm_state )
+            if(( entry->fm_inflight )||
+               ( sm_alarm_thread_retry_pending( entry ) ))
+                continue;
+
+            // Call Fault Management.
+            if( SM_ALARM_STATE_CLEARING == entry->alarm_state )
+            {
+                sm_alarm_thread_clear_alarm( entry );
+
+            } else if( SM_ALARM_STATE_RAISING == entry->alarm_state ) {
+                sm_alarm_thread_raise_alarm( entry );
+            }
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm Thread - Flush Timer
+// ==========================
+static bool sm_alarm_thread_flush_timer( SmTimerIdT timer_id,
+    int64_t user_data )
+{
+    _alarm_flush_timer_id = SM_TIMER_ID_INVALID;
+    sm_alarm_thread_report();
+    return( false );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm Thread - Schedule Report
+// ==============================
+static void sm_alarm_thread_schedule_report( void )
+{
+    SmErrorT error;
+
+    if( SM_TIMER_ID_INVALID != _alarm_flush_timer_id )
+    {
+        return;
+    }
+
+    error = sm_timer_register( "alarm flush",
+                               SM_ALARM_THREAD_ALARM_FLUSH_TIMER_IN_MS,
+                               sm_alarm_thread_flush_timer, 0,
+                               &_alarm_flush_timer_id );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to create alarm flush timer, error=%s.",
+                  sm_error_str( error ) );
+        sm_alarm_thread_report();
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Alarm Thread - FM Result
+// ========================
+static void sm_alarm_thread_fm_result( SmAlarmFmResultT* result )
+{
+    SmAlarmEntryT* entry = (SmAlarmEntryT*) result->context;
+    bool current;
+
+    if(( FM_ERR_OK != result->fm_error )&&
+       (( FM_ERR_ENTITY_NOT_FOUND != result->fm_error )||
+        ( SM_ALARM_FM_REQUEST_RAISE == result->type )))
+    {
+        if( NULL == entry )
         {
-            sm_alarm_thread_clear_alarm( entry );
+            DPRINTFE( "Failed to %s alarms, error=%i, audit will retry.",
+                      sm_alarm_fm_request_type_str( result->type ),
+                      result->fm_error );
+            _audit_all = true;
+            return;
+        }
+
+        entry->fm_inflight = false;
 
-        } else if( SM_ALARM_STATE_RAISING == entry->alarm_state ) {
-            sm_alarm_thread_raise_alarm( entry );
+        if( entry->removed )
+        {
+            sm_alarm_thread_release_retired( entry );
+            return;
         }
+
+        DPRINTFE( "Failed to %s alarm (%s) for node (%s) domain (%s) "
+                  "entity (%s), error=%i",
+                  sm_alarm_fm_request_type_str( result->type ),
+                  sm_alarm_thread_alarm_str( entry->alarm ),
+                  entry->alarm_node_name, entry->alarm_domain_name,
+                  entry->alarm_entity_name, result->fm_error );
+
+        ++(entry->fm_failures);
+        sm_time_get( &(entry->fm_failure_time) );
+        entry->fm_uncertain = true;
+        return;
+    }
+
+    if( NULL == entry )
+    {
+        return;
+    }
+
+    entry->fm_inflight = false;
+
+    if( entry->removed )
+    {
+        sm_alarm_thread_release_retired( entry );
+        return;
+    }
+
+    entry->fm_failures = 0;
+    entry->fm_uncertain = false;
+
+    current = ( result->generation == entry->generation );
+
+    switch( result->type )
+    {
+        case SM_ALARM_FM_REQUEST_RAISE:
+            entry->fm_raised = true;
+            snprintf( entry->fm_uuid, sizeof(entry->fm_uuid), "%s",
+                      result->fm_uuid );
+
+            if(( current )&&
+               ( SM_ALARM_STATE_RAISING == entry->alarm_state ))
+            {
+                DPRINTFI( "Raised alarm (%s) for node (%s) domain (%s) "
+                          "entity (%s), fm_uuid=%s.",
+                          sm_alarm_thread_alarm_str( entry->alarm ),
+                          entry->alarm_node_name, entry->alarm_domain_name,
+                          entry->alarm_entity_name, entry->fm_uuid );
+
+                entry->alarm_state = SM_ALARM_STATE_RAISED;
+                sm_alarm_thread_log( entry );
+                return;
+            }
+        break;
+
+        case SM_ALARM_FM_REQUEST_CLEAR:
+            entry->fm_raised = false;
+
+            if(( current )&&
+               ( SM_ALARM_STATE_CLEARING == entry->alarm_state ))
+            {
+                DPRINTFI( "Cleared alarm (%s) for node (%s) domain (%s) "
+                          "entity (%s), fm_uuid=%s.",
+                          sm_alarm_thread_alarm_str( entry->alarm ),
+                          entry->alarm_node_name, entry->alarm_domain_name,
+                          entry->alarm_entity_name, entry->fm_uuid );
+
+                sm_alarm_thread_alarm_cleared( entry );
+                return;
+            }
+        break;
+
+        case SM_ALARM_FM_REQUEST_GET:
+            entry->fm_raised = result->found;
+
+            if( result->found )
+            {
+                snprintf( entry->fm_uuid, sizeof(entry->fm_uuid), "%s",
+                          result->fm_uuid );
+
+            } else if( SM_ALARM_STATE_RAISED == entry->alarm_state ) {
+                DPRINTFI( "Alarm (%s) for node (%s) domain (%s) entity (%s) "
+                          "not found in FM, raising again.",
+                          sm_alarm_thread_alarm_str( entry->alarm ),
+                          entry->alarm_node_name, entry->alarm_domain_name,
+                          entry->alarm_entity_name );
+                entry->alarm_state = SM_ALARM_STATE_RAISING;
+                ++(entry->generation);
+            }
+        break;
+
+        default:
+        break;
+    }
+
+    if(( SM_ALARM_STATE_RAISED == entry->alarm_state )&&( !entry->fm_raised ))
+    {
+        // Raised again while its clear was outstanding.
+        entry->alarm_state = SM_ALARM_STATE_RAISING;
+        ++(entry->generation);
+    }
+
+    // The alarm changed while the request was outstanding.
+    if(( SM_ALARM_STATE_RAISING == entry->alarm_state )||
+       ( SM_ALARM_STATE_CLEARING == entry->alarm_state ))
+    {
+        sm_alarm_thread_schedule_report();
     }
 }
 // ****************************************************************************
@@ -1274,9 +1698,8 @@ static void sm_alarm_thread_report( void )
 // ****************************************************************************
 // Alarm Thread - Audit
 // ====================
-static void sm_alarm_thread_audit( const char entity_instance[] )
+static bool sm_alarm_thread_audit( const char entity_instance[] )
 {
-    bool found;
     char fm_entity_instance_id[FM_MAX_BUFFER_LENGTH];
     SFmAlarmDataT fm_alarm_data[SM_ALARMS_MAX];
     unsigned fm_total_alarms = SM_ALARMS_MAX;
@@ -1288,6 +1711,7 @@ static void sm_alarm_thread_audit( const char entity_instance[] )
     SmAlarmEntityNameT entity_name;
     SmAlarmEntryT* entry;
     char hostname[SM_NODE_NAME_MAX_CHAR];
+    bool complete = true;
     SmErrorT error;
 
     error = sm_node_utils_get_hostname( hostname );
@@ -1295,7 +1719,7 @@ static void sm_alarm_thread_audit( const char entity_instance[] )
     {
         DPRINTFE( "Failed to get hostname, error=%s.",
                   sm_error_str( error ) );
-        return;
+        return( false );
     }
 
     snprintf( fm_entity_instance_id, FM_MAX_BUFFER_LENGTH, "%s",
@@ -1306,13 +1730,17 @@ static void sm_alarm_thread_audit( const char entity_instance[] )
     if(( FM_ERR_OK != fm_error )&&( FM_ERR_ENTITY_NOT_FOUND != fm_error ))
     {
         DPRINTFE( "Failed to get all alarms, error=%i", fm_error );
-        return;
+        return( false );
+    }
+
+    if( FM_ERR_ENTITY_NOT_FOUND == fm_error )
+    {
+        fm_total_alarms = 0;
     }
 
     unsigned int fm_alarm_i;
     for( fm_alarm_i=0; fm_total_alarms > fm_alarm_i; ++fm_alarm_i )
     {
-        found = false;
         fm_alarm = &(fm_alarm_data[fm_alarm_i]);
 
         sm_alarm_thread_get_alarm_id( fm_alarm, &alarm, node_name,
@@ -1353,54 +1781,104 @@ static void sm_alarm_thread_audit( const char entity_instance[] )
                                       entity_name );
         if( NULL != entry )
         {
-            if( SM_ALARM_STATE_RAISING == entry->alarm_state
-                || SM_ALARM_STATE_RAISED == entry->alarm_state )
-            {
-                // only when a matching record locally to be considered as "found"
-                found = true;
-                entry->alarm_state = SM_ALARM_STATE_RAISED;
-            }else
+            entry->fm_seen = true;
+            entry->fm_raised = true;
+            snprintf( entry->fm_uuid, sizeof(entry->fm_uuid), "%s",
+                      fm_alarm->uuid );
+
+            // Raised alarms are current, clearing alarms are cleared
+            // by the next report.
+            if(( SM_ALARM_STATE_RAISING == entry->alarm_state )||
+               ( SM_ALARM_STATE_RAISED == entry->alarm_state )||
+               ( SM_ALARM_STATE_CLEARING == entry->alarm_state ))
             {
-                // found a record, but not in raising/raised mode, alarm need to be cleared
+                continue;
             }
+
+            //alarm is cleared, retire the record
+            DPRINTFI( "Removed cleared alarm, fm_alarm_id=%s, "
+                      "fm_entity_instance_id=%s, fm_uuid=%s.",
+                      fm_alarm->alarm_id, fm_alarm->entity_instance_id,
+                      fm_alarm->uuid );
+            sm_alarm_thread_remove( entry );
+        } else {
+            DPRINTFI( "Deleting stale alarm, fm_alarm_id=%s, "
+                      "fm_entity_instance_id=%s, fm_uuid=%s.",
+                      fm_alarm->alarm_id, fm_alarm->entity_instance_id,
+                      fm_alarm->uuid );
         }
 
-        if( !found )
-        {
-            AlarmFilter fm_filter;
+        AlarmFilter fm_filter;
+
+        snprintf( fm_filter.alarm_id, sizeof(fm_filter.alarm_id), "%s",
+                  fm_alarm->alarm_id );
+        snprintf( fm_filter.entity_instance_id, 
+                  sizeof(fm_filter.entity_instance_id), "%s",
+                  fm_alarm->entity_instance_id );
 
-            snprintf( fm_filter.alarm_id, sizeof(fm_filter.alarm_id), "%s",
-                      fm_alarm->alarm_id );
-            snprintf( fm_filter.entity_instance_id, 
-                      sizeof(fm_filter.entity_instance_id), "%s",
+        error = sm_alarm_fm_clear( NULL, 0, &fm_filter );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to queue clear of stale alarm (fm_alarm_id=%s, "
+                      "fm_entity_instance_id=%s).", fm_alarm->alarm_id,
                       fm_alarm->entity_instance_id );
+            complete = false;
+        }
+    }
 
-            fm_error = fm_clear_fault_wrapper( &fm_filter );
-            if(( FM_ERR_OK != fm_error )&&( FM_ERR_ENTITY_NOT_FOUND != fm_error ))
-            {
-                DPRINTFE( "Failed to clear stale alarm (fm_alarm_id=%s, "
-                          "fm_entity_instance_id=%s), error=%i",
-                          fm_alarm->alarm_id, fm_alarm->entity_instance_id,
-                          fm_error );
-            }
+    return( complete );
+}
+// ****************************************************************************
 
-            if ( NULL != entry )
-            {
-                //alarm is cleared, retire the record
-                entry->inuse = 0;
-                DPRINTFI( "Removed cleared alarm, fm_alarm_id=%s, "
-                      "fm_entity_instance_id=%s, fm_uuid=%s.",
-                      fm_alarm->alarm_id, fm_alarm->entity_instance_id,
-                      fm_alarm->uuid );
-            }else
+// ****************************************************************************
+// Alarm Thread - Audit All
+// ========================
+// Reconciles every alarm with FM, done on start, when a domain becomes
+// managed and after a failed clear of all alarms.
+static void sm_alarm_thread_audit_all( void )
+{
+    SmAlarmEntryT* entry;
+
+    unsigned int bucket_i;
+    for( bucket_i=0; SM_ALARM_THREAD_HASH_BUCKETS > bucket_i; ++bucket_i )
+    {
+        for( entry = _alarms[bucket_i]; NULL != entry; entry = entry->next )
+        {
+            entry->fm_seen = false;
+        }
+    }
+
+    if(( !sm_alarm_thread_audit( "service_domain" ) )||
+       ( !sm_alarm_thread_audit( "host" ) ))
+    {
+        return;
+    }
+
+    for( bucket_i=0; SM_ALARM_THREAD_HASH_BUCKETS > bucket_i; ++bucket_i )
+    {
+        for( entry = _alarms[bucket_i]; NULL != entry; entry = entry->next )
+        {
+            if( entry->fm_inflight )
+                continue;
+
+            if( !entry->fm_seen )
             {
-                DPRINTFI( "Deleted stale alarm, fm_alarm_id=%s, "
-                          "fm_entity_instance_id=%s, fm_uuid=%s.",
-                          fm_alarm->alarm_id, fm_alarm->entity_instance_id,
-                          fm_alarm->uuid );
+                entry->fm_raised = false;
+
+                if( SM_ALARM_STATE_RAISED == entry->alarm_state )
+                {
+                    entry->alarm_state = SM_ALARM_STATE_RAISING;
+                    ++(entry->generation);
+                }
             }
+
+            entry->fm_uncertain = false;
         }
     }
+
+    _audit_all = false;
+
+    sm_alarm_thread_schedule_report();
 }
 // ****************************************************************************
 
@@ -1418,29 +1896,46 @@ static bool sm_alarm_thread_report_timer( SmTimerIdT timer_id,
 // ****************************************************************************
 // Alarm Thread - Audit Timer
 // ==========================
+// Looks up in FM only the raised alarms whose FM state is uncertain, the
+// alarms still being raised or cleared are resent by the report.
 static bool sm_alarm_thread_audit_timer( SmTimerIdT timer_id,
     int64_t user_data )
 {
+    AlarmFilter fm_filter;
+    char fm_entity_type_id[FM_MAX_BUFFER_LENGTH];
     SmAlarmEntryT* entry;
+    SmErrorT error;
 
-    // Set raised alarms to raising, the audit will set them
-    // to raised, if FM really has them.
-    unsigned int entry_i;
-    for( entry_i=0; SM_ALARMS_MAX > entry_i; ++entry_i )
+    if( _audit_all )
     {
-        entry = &(_alarms[entry_i]);
+        sm_alarm_thread_audit_all();
+        return( true );
+    }
 
-        if( SM_ALARM_ENTRY_INUSE != entry->inuse )
-            continue;
-        
-        if( SM_ALARM_STATE_RAISED == entry->alarm_state )
+    unsigned int bucket_i;
+    for( bucket_i=0; SM_ALARM_THREAD_HASH_BUCKETS > bucket_i; ++bucket_i )
+    {
+        for( entry = _alarms[bucket_i]; NULL != entry; entry = entry->next )
         {
-            entry->alarm_state = SM_ALARM_STATE_RAISING;
+            if(( !entry->fm_uncertain )||( entry->fm_inflight )||
+               ( SM_ALARM_STATE_RAISED != entry->alarm_state ))
+                continue;
+
+            error = sm_alarm_thread_get_fm_alarm_id( entry->alarm,
+                            entry->alarm_node_name, entry->alarm_domain_name,
+                            entry->alarm_entity_name, fm_filter.alarm_id,
+                            fm_entity_type_id, fm_filter.entity_instance_id );
+            if( SM_OKAY != error )
+                continue;
+
+            error = sm_alarm_fm_get( entry, entry->generation, &fm_filter );
+            if( SM_OKAY != error )
+                return( true );
+
+            entry->fm_inflight = true;
         }
     }
 
-    sm_alarm_thread_audit( "service_domain" );
-    sm_alarm_thread_audit( "host"  );
     return( true );
 }
 // ****************************************************************************
@@ -1516,7 +2011,7 @@ static void sm_alarm_thread_dispatch( int selobj, int64_t user_data )
     }
 
     if( report_alarm )
-        sm_alarm_thread_report();
+        sm_alarm_thread_schedule_report();
 }
 // ****************************************************************************
 
@@ -1550,6 +2045,14 @@ static SmErrorT sm_alarm_thread_initialize_thread( void )
         _server_fd_registered = true;
     }
 
+    error = sm_alarm_fm_initialize( sm_alarm_thread_fm_result );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to initialize alarm FM module, error=%s.",
+                  sm_error_str( error ) );
+        return( error );
+    }
+
     error = sm_timer_initialize( SM_ALARM_THREAD_TICK_INTERVAL_IN_MS );
     if( SM_OKAY != error )
     {
@@ -1580,22 +2083,6 @@ static SmErrorT sm_alarm_thread_initialize_thread( void )
         return( SM_FAILED );
     }
 
-    if( NULL != _customer_alarm_log )
-    {
-        fflush( _customer_alarm_log );
-        fclose( _customer_alarm_log );
-        _customer_alarm_log = NULL;
-    }
-
-    _customer_alarm_log = fopen( SM_ALARM_CUSTOMER_LOG_FILE, "a" );
-    if( NULL == _customer_alarm_log )
-    {
-        DPRINTFE( "Failed to open customer alarm log file (%s).", 
-                  SM_ALARM_CUSTOMER_LOG_FILE );
-        return( SM_FAILED );
-    }
-    chmod( SM_ALARM_CUSTOMER_LOG_FILE, 0640);
-
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -1631,6 +2118,18 @@ static SmErrorT sm_alarm_thread_finalize_thread( void )
         _alarm_audit_timer_id = SM_TIMER_ID_INVALID;
     }
 
+    if( SM_TIMER_ID_INVALID != _alarm_flush_timer_id )
+    {
+        error = sm_timer_deregister( _alarm_flush_timer_id );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to cancel alarm flush timer, error=%s.",
+                      sm_error_str( error ) );
+        }
+
+        _alarm_flush_timer_id = SM_TIMER_ID_INVALID;
+    }
+
     error = sm_timer_finalize();
     if( SM_OKAY != error )
     {
@@ -1650,20 +2149,24 @@ static SmErrorT sm_alarm_thread_finalize_thread( void )
         _server_fd_registered = false;
     }
 
-    error = sm_selobj_finalize();
+    error = sm_alarm_fm_finalize();
     if( SM_OKAY != error )
     {
-        DPRINTFE( "Failed to finialize selection object module, error=%s.",
+        DPRINTFE( "Failed to finalize alarm FM module, error=%s.",
                   sm_error_str( error ) );
     }
 
-    if( NULL != _customer_alarm_log )
+    sm_alarm_thread_remove_all();
+
+    error = sm_selobj_finalize();
+    if( SM_OKAY != error )
     {
-        fflush( _customer_alarm_log );
-        fclose( _customer_alarm_log );
-        _customer_alarm_log = NULL;
+        DPRINTFE( "Failed to finialize selection object module, error=%s.",
+                  sm_error_str( error ) );
     }
 
+    sm_journal_flush();
+
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -1749,6 +2252,8 @@ SmErrorT sm_alarm_thread_start( int server_fd )
 
     memset( _alarms, 0, sizeof(_alarms) );
     memset( _alarm_domains, 0, sizeof(_alarm_domains) );
+    _retired_alarms = NULL;
+    _audit_all = true;
 
     _stay_on = 1;
     _thread_created = false;
@@ -1786,7 +2291,12 @@ SmErrorT sm_alarm_thread_stop( void )
         while( true )
         {
             result = pthread_tryjoin_np( _alarm_thread, NULL );
-            if(( 0 != result )&&( EBUSY != result ))
+            if( 0 == result )
+            {
+                break;
+            }
+
+            if( EBUSY != result )
             {
                 if(( ESRCH != result )&&( EINVAL != result ))
                 {
@@ -1814,7 +2324,6 @@ SmErrorT sm_alarm_thread_stop( void )
     _server_fd = -1;
     _thread_created = false;
 
-    memset( _alarms, 0, sizeof(_alarms) );
     memset( _alarm_domains, 0, sizeof(_alarm_domains) );
 
     return( SM_OKAY );
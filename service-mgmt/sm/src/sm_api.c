@@ -34,6 +34,12 @@
 #define SM_API_MSG_TYPE_DEPROVISION_SERVICE         "DEPROVISION_SERVICE"
 #define SM_API_MSG_TYPE_PROVISION_SERVICE_DOMAIN_INTERFACE "PROVISION_SERVICE_DOMAIN_INTERFACE"
 #define SM_API_MSG_TYPE_DEPROVISION_SERVICE_DOMAIN_INTERFACE "DEPROVISION_SERVICE_DOMAIN_INTERFACE"
+#define SM_API_MSG_TYPE_ACTION_STATS                "ACTION_STATS"
+#define SM_API_MSG_TYPE_ACTION_STATS_ACK            "ACTION_STATS_ACK"
+#define SM_API_MSG_TYPE_ACTION_STATS_END            "ACTION_STATS_END"
+#define SM_API_MSG_TYPE_SWACT_BLOCKERS              "SWACT_BLOCKERS"
+#define SM_API_MSG_TYPE_SWACT_BLOCKERS_ACK          "SWACT_BLOCKERS_ACK"
+#define SM_API_MSG_TYPE_SWACT_BLOCKERS_END          "SWACT_BLOCKERS_END"
 
 #define SM_API_MSG_NODE_ACTION_UNKNOWN              "unknown"
 #define SM_API_MSG_NODE_ACTION_LOCK                 "lock"
@@ -374,6 +380,142 @@ SmErrorT sm_api_send_node_set_ack( char node_name[], SmNodeSetActionT action,
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// API - Send Action Stats
+// =======================
+SmErrorT sm_api_send_action_stats( SmServiceActionStatsT* stats, int seqno )
+{
+    int bytes_written;
+
+    if( 0 == stats->count )
+    {
+        return( SM_OKAY );
+    }
+
+    memset( _tx_buffer, 0, sizeof(_tx_buffer) );
+
+    bytes_written = snprintf( _tx_buffer, sizeof(_tx_buffer),
+                              "%s,%s,%i,%s,%s,%s,%s,%u,%u,%u,%i,%li,%lu,"
+                              "%li,%li,%li,%lu,%lu,%li,%li",
+                              SM_API_MSG_VERSION, SM_API_MSG_REVISION,
+                              seqno, SM_API_MSG_TYPE_ACTION_STATS_ACK, "sm",
+                              stats->service_name,
+                              sm_service_action_str( stats->action ),
+                              stats->count, stats->failed, stats->outliers,
+                              stats->timeout_in_ms, stats->wall_last_ms,
+                              (unsigned long)
+                              (stats->wall_total_ms / stats->count),
+                              sm_service_action_stats_percentile_ms( stats, 50 ),
+                              sm_service_action_stats_percentile_ms( stats, 95 ),
+                              stats->wall_max_ms,
+                              (unsigned long)
+                              (stats->user_total_us / stats->count),
+                              (unsigned long)
+                              (stats->system_total_us / stats->count),
+                              stats->max_rss_kb, stats->major_faults_max );
+    if( 0 < bytes_written )
+    {
+        if( 0 > sendto( _sm_api_socket, &_tx_buffer, bytes_written, 0,
+                        (struct sockaddr*) &_sm_api_client_address,
+                        _sm_api_client_address_len ) )
+        {
+            DPRINTFE( "Failed to send service (%s) action stats, error=%s",
+                      stats->service_name, strerror( errno ) );
+            return( SM_FAILED );
+        }
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// API - Send Action Stats End
+// ===========================
+SmErrorT sm_api_send_action_stats_end( unsigned int count, int seqno )
+{
+    int bytes_written;
+
+    memset( _tx_buffer, 0, sizeof(_tx_buffer) );
+
+    bytes_written = snprintf( _tx_buffer, sizeof(_tx_buffer),
+                              "%s,%s,%i,%s,%s,%u",
+                              SM_API_MSG_VERSION, SM_API_MSG_REVISION,
+                              seqno, SM_API_MSG_TYPE_ACTION_STATS_END, "sm",
+                              count );
+    if( 0 < bytes_written )
+    {
+        if( 0 > sendto( _sm_api_socket, &_tx_buffer, bytes_written, 0,
+                        (struct sockaddr*) &_sm_api_client_address,
+                        _sm_api_client_address_len ) )
+        {
+            DPRINTFE( "Failed to send action stats end, error=%s",
+                      strerror( errno ) );
+            return( SM_FAILED );
+        }
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// API - Send Swact Blockers
+// =========================
+SmErrorT sm_api_send_swact_blockers( SmSwactProfilerBlockerT blockers[],
+    unsigned int num_blockers, int seqno )
+{
+    int bytes_written;
+
+    unsigned int blocker_i;
+    for( blocker_i=0; num_blockers > blocker_i; ++blocker_i )
+    {
+        memset( _tx_buffer, 0, sizeof(_tx_buffer) );
+
+        bytes_written = snprintf( _tx_buffer, sizeof(_tx_buffer),
+                                  "%s,%s,%i,%s,%s,%s,%u,%li,%li",
+                                  SM_API_MSG_VERSION, SM_API_MSG_REVISION,
+                                  seqno, SM_API_MSG_TYPE_SWACT_BLOCKERS_ACK,
+                                  "sm", blockers[blocker_i].name,
+                                  blockers[blocker_i].swacts,
+                                  blockers[blocker_i].total_ms,
+                                  blockers[blocker_i].max_ms );
+        if( 0 < bytes_written )
+        {
+            if( 0 > sendto( _sm_api_socket, &_tx_buffer, bytes_written, 0,
+                            (struct sockaddr*) &_sm_api_client_address,
+                            _sm_api_client_address_len ) )
+            {
+                DPRINTFE( "Failed to send swact blocker (%s), error=%s",
+                          blockers[blocker_i].name, strerror( errno ) );
+                return( SM_FAILED );
+            }
+        }
+    }
+
+    memset( _tx_buffer, 0, sizeof(_tx_buffer) );
+
+    bytes_written = snprintf( _tx_buffer, sizeof(_tx_buffer),
+                              "%s,%s,%i,%s,%s,%u",
+                              SM_API_MSG_VERSION, SM_API_MSG_REVISION,
+                              seqno, SM_API_MSG_TYPE_SWACT_BLOCKERS_END, "sm",
+                              num_blockers );
+    if( 0 < bytes_written )
+    {
+        if( 0 > sendto( _sm_api_socket, &_tx_buffer, bytes_written, 0,
+                        (struct sockaddr*) &_sm_api_client_address,
+                        _sm_api_client_address_len ) )
+        {
+            DPRINTFE( "Failed to send swact blockers end, error=%s",
+                      strerror( errno ) );
+            return( SM_FAILED );
+        }
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // API - Dispatch
 // ==============
@@ -670,6 +812,33 @@ static void sm_api_dispatch( int selobj, int64_t user_data )
         {
             _callbacks.deprovision_service_domain_interface( service_domain, service_domain_interface, seqno);
         }
+    }
+    else if( 0 == strcmp( SM_API_MSG_TYPE_ACTION_STATS,
+                          params[SM_API_MSG_TYPE_FIELD] ) )
+    {
+        char empty_name[] = "";
+
+        // The service name is optional, all services are sent without it.
+        service_name = empty_name;
+
+        if(( params[SM_API_MSG_ORIGIN_FIELD] != NULL )&&
+           ( params[SM_API_MSG_SERVICE_NAME_FIELD] != NULL ))
+        {
+            service_name = (char*) params[SM_API_MSG_SERVICE_NAME_FIELD];
+        }
+
+        if( NULL != _callbacks.action_stats )
+        {
+            _callbacks.action_stats( service_name, seqno );
+        }
+    }
+    else if( 0 == strcmp( SM_API_MSG_TYPE_SWACT_BLOCKERS,
+                          params[SM_API_MSG_TYPE_FIELD] ) )
+    {
+        if( NULL != _callbacks.swact_blockers )
+        {
+            _callbacks.swact_blockers( seqno );
+        }
     } else {
         DPRINTFE( "Unknown/unsupported message-type (%s) received.",
                   params[SM_API_MSG_TYPE_FIELD] );
@@ -7,6 +7,8 @@
 #define __SM_API_H__
 
 #include "sm_types.h"
+#include "sm_service_action_stats.h"
+#include "sm_swact_profiler.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,6 +48,10 @@ typedef void (*SmApiDeprovisionServiceDomainInterfaceCallbackT) (char service_do
 typedef void (*SmApiConfigureServiceDomainInterfaceCallbackT) (char service_domain[],
         char service_domain_interface[], int seqno);
 
+typedef void (*SmApiActionStatsCallbackT) (char service_name[], int seqno);
+
+typedef void (*SmApiSwactBlockersCallbackT) (int seqno);
+
 typedef struct
 {
     SmApiNodeSetCallbackT node_set;
@@ -54,6 +60,8 @@ typedef struct
     SmApiDeprovisionServiceCallbackT deprovision_service;
     SmApiProvisionServiceDomainInterfaceCallbackT provision_service_domain_interface;
     SmApiDeprovisionServiceDomainInterfaceCallbackT deprovision_service_domain_interface;
+    SmApiActionStatsCallbackT action_stats;
+    SmApiSwactBlockersCallbackT swact_blockers;
 } SmApiCallbacksT;
 
 // ****************************************************************************
@@ -85,6 +93,29 @@ extern SmErrorT sm_api_send_node_set_ack( char node_name[],
     int seqno );
 // ****************************************************************************
 
+// ****************************************************************************
+// API - Send Action Stats
+// =======================
+// One reply is sent per service action, followed by an end marker.
+extern SmErrorT sm_api_send_action_stats( SmServiceActionStatsT* stats,
+    int seqno );
+// ****************************************************************************
+
+// ****************************************************************************
+// API - Send Action Stats End
+// ===========================
+extern SmErrorT sm_api_send_action_stats_end( unsigned int count,
+    int seqno );
+// ****************************************************************************
+
+// ****************************************************************************
+// API - Send Swact Blockers
+// =========================
+// One reply is sent per blocking service, followed by an end marker.
+extern SmErrorT sm_api_send_swact_blockers( SmSwactProfilerBlockerT blockers[],
+    unsigned int num_blockers, int seqno );
+// ****************************************************************************
+
 // ***************************************************************************
 // API - Initialize
 // ================
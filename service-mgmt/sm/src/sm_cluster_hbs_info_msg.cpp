@@ -25,6 +25,7 @@
 #include "sm_worker_thread.h"
 #include "sm_node_utils.h"
 #include "sm_util_types.h"
+#include "sm_failover.h"
 
 // uncomment when debugging this module to enabled DPRINTFD output to log file
 // #define __DEBUG__MSG__
@@ -37,8 +38,15 @@
 #define LOOPBACK_IP "127.0.0.1"
 #define SM_CLIENT_PORT_KEY "sm_client_port"
 #define SM_SERVER_PORT_KEY "sm_server_port"
+// subscription is renewed with the alive pulse, and is considered lost
+// when hbsAgent has not acknowledged it for two renew intervals
+#define SM_CLUSTER_HBS_SUBSCRIBE_RENEW_SEC 10
+// any hbsAgent answers a request with its reqid, only a reply of this
+// cluster info revision or later acknowledges the subscription
+#define SM_CLUSTER_HBS_SUBSCRIBE_ACK_REVISION 1
 const char json_fmt[] = "{\"origin\":\"sm\",\"service\":\"heartbeat\",\"request\":\"cluster_info\",\"reqid\":\"%d\"}";
-const int request_size = sizeof(json_fmt) + 10;
+const char json_subscribe_fmt[] = "{\"origin\":\"sm\",\"service\":\"heartbeat\",\"request\":\"cluster_info_subscribe\",\"reqid\":\"%d\"}";
+const int request_size = sizeof(json_subscribe_fmt) + 10;
 
 static const unsigned int size_of_msg_header =
                             sizeof(mtce_hbs_cluster_type)
@@ -121,6 +129,9 @@ void log_cluster_hbs_state(const SmClusterHbsStateT& state)
 
 pthread_mutex_t SmClusterHbsInfoMsg::sm_cluster_hbs_mutex;
 const unsigned short Invalid_Req_Id = 0;
+// hbsAgent pushes with the invalid reqid and answers a request with its
+// own, so the alive pulse takes a reqid no query or subscription uses
+const unsigned short Alive_Pulse_Req_Id = 0xFFFF;
 int SmClusterHbsInfoMsg::_sock = -1;
 SmClusterHbsStateT SmClusterHbsInfoMsg::_cluster_hbs_state_current;
 SmClusterHbsStateT SmClusterHbsInfoMsg::_cluster_hbs_state_previous;
@@ -131,6 +142,11 @@ char SmClusterHbsInfoMsg::server_port[SM_CONFIGURATION_VALUE_MAX_CHAR + 1] = {0}
 char SmClusterHbsInfoMsg::client_port[SM_CONFIGURATION_VALUE_MAX_CHAR + 1] = {0};
 std::atomic_flag SmClusterHbsInfoMsg::_sending_query = ATOMIC_FLAG_INIT;
 struct sockaddr_in SmClusterHbsInfoMsg::sock_addr = {0};
+unsigned short SmClusterHbsInfoMsg::_subscribe_reqid = Invalid_Req_Id;
+time_t SmClusterHbsInfoMsg::_subscribe_sent = 0;
+time_t SmClusterHbsInfoMsg::_subscribe_acked = 0;
+unsigned int SmClusterHbsInfoMsg::_state_version = 0;
+unsigned int SmClusterHbsInfoMsg::_push_count = 0;
 
 const SmClusterHbsStateT& SmClusterHbsInfoMsg::get_current_state()
 {
@@ -256,6 +272,27 @@ void SmClusterHbsInfoMsg::_cluster_hbs_info_msg_received( int selobj, int64_t us
                   msg.version, msg.revision, msg.bytes, msg.reqid);
         DPRINTFD("period %d number of rec %d", msg.period_msec, msg.histories);
 
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        if(Invalid_Req_Id == msg.reqid)
+        {
+            _push_count ++;
+        }else if(_subscribe_reqid == msg.reqid)
+        {
+            if(SM_CLUSTER_HBS_SUBSCRIBE_ACK_REVISION > msg.revision)
+            {
+                DPRINTFD("hbsAgent revision %d does not acknowledge subscription [%d]",
+                         msg.revision, msg.reqid);
+            }else
+            {
+                if(!is_subscribed())
+                {
+                    DPRINTFI("hbsAgent accepted cluster info subscription [%d]", msg.reqid);
+                }
+                _subscribe_acked = ts.tv_sec;
+            }
+        }
+
         SmClusterHbsStateT state;
         if(msg.histories > 0)
         {
@@ -278,16 +315,17 @@ void SmClusterHbsInfoMsg::_cluster_hbs_info_msg_received( int selobj, int64_t us
             DPRINTFD("No rbs cluster info history data is received");
         }
 
-        struct timespec ts;
         clock_gettime(CLOCK_REALTIME, &ts);
         state.last_update = ts.tv_sec;
         state.storage0_enabled = (bool)msg.storage0_enabled;
         if(state != _cluster_hbs_state_current)
         {
+            state.version = ++_state_version;
             _cluster_hbs_state_previous = _cluster_hbs_state_current;
             _cluster_hbs_state_current = state;
-            DPRINTFD("cluster hbs state changed");
+            DPRINTFD("cluster hbs state changed, version %u", state.version);
             log_cluster_hbs_state(_cluster_hbs_state_current);
+            sm_failover_signal(SM_FAILOVER_TRIGGER_CLUSTER_HBS_INFO);
         }
         else
         {
@@ -335,7 +373,7 @@ SmErrorT SmClusterHbsInfoMsg::set_address()
 
 static void send_query(SmSimpleAction&)
 {
-    SmClusterHbsInfoMsg::cluster_hbs_info_query();
+    SmClusterHbsInfoMsg::send_alive_pulse();
 }
 
 static SmSimpleAction _query_hbs_cluster_info_action("send hbs-cluster query", send_query);
@@ -374,7 +412,7 @@ bool SmClusterHbsInfoMsg::cluster_hbs_info_query(cluster_hbs_query_ready_callbac
 
         if(alive_pulse)
         {
-            reqid = 0;
+            reqid = Alive_Pulse_Req_Id;
         }else
         {
             if(0 != clock_gettime(CLOCK_REALTIME, &ts))
@@ -399,7 +437,7 @@ bool SmClusterHbsInfoMsg::cluster_hbs_info_query(cluster_hbs_query_ready_callbac
 
         int msg_size = snprintf(query, sizeof(query), json_fmt, reqid);
 
-        if (reqid != 0)
+        if (!alive_pulse)
         {
             DPRINTFI("send hbs cluster query [%d]", reqid);
         }
@@ -420,9 +458,80 @@ bool SmClusterHbsInfoMsg::cluster_hbs_info_query(cluster_hbs_query_ready_callbac
 
 bool SmClusterHbsInfoMsg::send_alive_pulse()
 {
+    struct timespec ts;
+    bool renew;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    {
+        mutex_holder holder(&sm_cluster_hbs_mutex);
+        renew = (0 == _subscribe_sent ||
+                 ts.tv_sec - _subscribe_sent >= SM_CLUSTER_HBS_SUBSCRIBE_RENEW_SEC);
+    }
+    if(renew)
+    {
+        _send_subscribe();
+    }
     return cluster_hbs_info_query(NULL);
 }
 
+// ****************************************************************************
+// SmClusterHbsInfoMsg::_send_subscribe -
+//      request hbsAgent to push cluster hbs info on every change.
+//      hbsAgent acknowledges with a response carrying the same reqid and
+//      a revision of SM_CLUSTER_HBS_SUBSCRIBE_ACK_REVISION or later, older
+//      hbsAgent ignores the request or answers it as a query.
+// ========================
+bool SmClusterHbsInfoMsg::_send_subscribe()
+{
+    char request[request_size];
+    struct timespec ts;
+    mutex_holder holder(&sm_cluster_hbs_mutex);
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    _subscribe_sent = ts.tv_sec;
+
+    // reqid 1 to 0xFFFE, distinct from a push and the alive pulse
+    _subscribe_reqid = (unsigned short)(_subscribe_reqid % 0xFFFE + 1);
+
+    struct sockaddr_in *addr = _get_address();
+    int msg_size = snprintf(request, sizeof(request), json_subscribe_fmt, _subscribe_reqid);
+    if(0 > sendto(_sock, request, msg_size, 0, (sockaddr*)addr, sizeof(*addr)))
+    {
+        DPRINTFE("Failed to send subscribe msg. Error %s", strerror(errno));
+        return false;
+    }
+    DPRINTFD("send hbs cluster subscribe [%d]", _subscribe_reqid);
+    return true;
+}
+
+// ****************************************************************************
+// SmClusterHbsInfoMsg::is_subscribed -
+//      true if hbsAgent pushes updates, i.e the cached state is current.
+// ========================
+bool SmClusterHbsInfoMsg::is_subscribed()
+{
+    struct timespec ts;
+    mutex_holder holder(&sm_cluster_hbs_mutex);
+
+    if(0 == _subscribe_acked)
+    {
+        return false;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec - _subscribe_acked < SM_CLUSTER_HBS_SUBSCRIBE_RENEW_SEC * 2;
+}
+
+unsigned int SmClusterHbsInfoMsg::get_state_version()
+{
+    mutex_holder holder(&sm_cluster_hbs_mutex);
+    return _state_version;
+}
+
+unsigned int SmClusterHbsInfoMsg::get_push_count()
+{
+    mutex_holder holder(&sm_cluster_hbs_mutex);
+    return _push_count;
+}
+
 SmErrorT SmClusterHbsInfoMsg::open_socket()
 {
     struct addrinfo *address = NULL;
@@ -578,6 +687,9 @@ void SmClusterHbsInfoMsg::dump_hbs_record(FILE* fp)
     clock_gettime(CLOCK_REALTIME, &ts);
     t = ts.tv_sec - _cluster_hbs_state_current.last_update;
     fprintf(fp, "\ncluster hbs info\n");
+    fprintf(fp, "  Subscription %s, %u updates pushed, state version %u\n",
+            is_subscribed() ? "active" : "inactive (query mode)",
+            _push_count, _state_version);
     if(0 == _cluster_hbs_state_current.last_update)
     {
         fprintf(fp, "  Current state, no data received yet\n");
@@ -49,6 +49,8 @@ typedef struct
     SmClusterHbsInfoT controllers[max_controllers];
     bool storage0_enabled;
     time_t last_update;
+    // stamped on receipt, increases with every change; not compared
+    unsigned int version;
 }SmClusterHbsStateT;
 
 bool operator==(const SmClusterHbsStateT& lhs, const SmClusterHbsStateT& rhs);
@@ -69,6 +71,12 @@ typedef void(*cluster_hbs_query_ready_callback)();
 //       hbsAgent sends hbs cluster info when there is a change in the cluster.
 //       Keep track of most up-to-date info prior to a failure occurs.
 //       Provide async query with callback when hbsAgent response is received
+//
+//       sm subscribes to pushed updates and renews the subscription with
+//       the alive pulse.  While hbsAgent acknowledges the subscription, by
+//       a reply of the subscribe revision, the cached state is current and
+//       no query is needed; otherwise (older hbsAgent) the query path is
+//       used.
 // ========================
 class SmClusterHbsInfoMsg
 {
@@ -80,6 +88,9 @@ class SmClusterHbsInfoMsg
         static const SmClusterHbsStateT& get_previous_state();
         static bool cluster_hbs_info_query(cluster_hbs_query_ready_callback callback = NULL);
         static bool send_alive_pulse();
+        static bool is_subscribed();
+        static unsigned int get_state_version();
+        static unsigned int get_push_count();
         static void dump_hbs_record(FILE* fp);
         static int get_peer_controller_index();
         static int get_this_controller_index();
@@ -94,6 +105,7 @@ class SmClusterHbsInfoMsg
         static hbs_query_respond_callback _callbacks;
         static SmErrorT open_socket();
         static SmErrorT get_controller_index();
+        static bool _send_subscribe();
 
         static struct sockaddr_in* _get_address();
         static void _cluster_hbs_info_msg_received( int selobj, int64_t user_data );
@@ -106,6 +118,11 @@ class SmClusterHbsInfoMsg
         static int this_controller_index;
         static std::atomic_flag _sending_query;
         static struct sockaddr_in sock_addr;
+        static unsigned short _subscribe_reqid;
+        static time_t _subscribe_sent;
+        static time_t _subscribe_acked;
+        static unsigned int _state_version;
+        static unsigned int _push_count;
 };
 
 #endif // __SM_CLUSTER_HBS_INFO_MSG_H__
@@ -0,0 +1,464 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Drives the cluster hbs info subscription against a stand-in hbsAgent on
+// the loopback, exits non-zero when a check fails.  The stand-in answers
+// each request with its reqid, as hbsAgent does, and in subscribe mode
+// acknowledges the subscription and pushes every change unsolicited.  A
+// legacy stand-in answers every request as a query of revision 0.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_selobj.h"
+#include "sm_configuration_table.h"
+#include "sm_failover.h"
+#include "sm_cluster_hbs_info_msg.h"
+
+#define SM_CLUSTER_HBS_TEST_RUN_MS                                     100
+#define SM_CLUSTER_HBS_TEST_BUFFER_MAX_CHAR                            512
+
+typedef struct
+{
+    int sock;
+    // Revision answered, a subscription is acknowledged from revision 1.
+    unsigned short revision;
+    bool subscribed;
+    struct sockaddr_in subscriber;
+    unsigned int subscribes;
+    unsigned int queries;
+    unsigned short subscribe_reqid;
+    unsigned short query_reqid;
+    unsigned short reachable[max_controllers];
+} SmClusterHbsTestAgentT;
+
+static SmClusterHbsTestAgentT _agent;
+static char _server_port[16];
+static char _client_port[16];
+static unsigned int _failover_signals = 0;
+static unsigned int _queries_ready = 0;
+static unsigned int _failures = 0;
+
+// ****************************************************************************
+// Cluster Hbs Test - Check
+// ========================
+static void sm_cluster_hbs_test_check( bool passed, const char name[] )
+{
+    printf( "%s: %s\n", passed ? "PASS" : "FAIL", name );
+
+    if( !passed )
+    {
+        ++_failures;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Cluster Hbs Test - Configuration Provider
+// =========================================
+SmErrorT sm_configuration_table_get( const char* key, char* buf,
+    unsigned int buf_size )
+{
+    if( 0 == strcmp( "sm_server_port", key ) )
+    {
+        snprintf( buf, buf_size, "%s", _server_port );
+        return( SM_OKAY );
+    }
+
+    if( 0 == strcmp( "sm_client_port", key ) )
+    {
+        snprintf( buf, buf_size, "%s", _client_port );
+        return( SM_OKAY );
+    }
+
+    return( SM_NOT_FOUND );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Cluster Hbs Test - Failover Signal
+// ==================================
+void sm_failover_signal( SmFailoverTriggerT trigger )
+{
+    if( SM_FAILOVER_TRIGGER_CLUSTER_HBS_INFO == trigger )
+    {
+        ++_failover_signals;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Cluster Hbs Test - Query Ready
+// ==============================
+static void sm_cluster_hbs_test_query_ready( void )
+{
+    ++_queries_ready;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Cluster Hbs Test - Agent Send
+// =============================
+// Sends the cluster info the stand-in holds, one history per controller.
+static void sm_cluster_hbs_test_agent_send( struct sockaddr_in* addr,
+    unsigned short reqid )
+{
+    mtce_hbs_cluster_type msg;
+    unsigned int size;
+
+    memset( &msg, 0, sizeof(msg) );
+
+    msg.version = MTCE_HBS_CLUSTER_VERSION;
+    msg.revision = _agent.revision;
+    msg.magic_number = MTCE_HBS_MAGIC_NUMBER;
+    msg.reqid = reqid;
+    msg.period_msec = 100;
+    msg.histories = max_controllers;
+
+    unsigned int controller_i;
+    for( controller_i=0; max_controllers > controller_i; ++controller_i )
+    {
+        mtce_hbs_cluster_history_type* history = &(msg.history[controller_i]);
+
+        history->controller = controller_i;
+        history->entries = 1;
+        history->entry[0].hosts_enabled = _agent.reachable[controller_i];
+        history->entry[0].hosts_responding = _agent.reachable[controller_i];
+    }
+
+    size = sizeof(msg) - sizeof(mtce_hbs_cluster_history_type)
+         * ( MTCE_HBS_MAX_HISTORY_ELEMENTS - max_controllers );
+    msg.bytes = size;
+
+    if( 0 > sendto( _agent.sock, &msg, size, 0, (struct sockaddr*) addr,
+                    sizeof(*addr) ) )
+    {
+        printf( "Failed to send cluster info, error=%s.\n", strerror(errno) );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Cluster Hbs Test - Agent Receive
+// ================================
+static void sm_cluster_hbs_test_agent_receive( int selobj, int64_t user_data )
+{
+    char request[SM_CLUSTER_HBS_TEST_BUFFER_MAX_CHAR];
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    unsigned short reqid = 0;
+    const char* reqid_str;
+    int bytes_read;
+
+    bytes_read = recvfrom( selobj, request, sizeof(request)-1, MSG_DONTWAIT,
+                           (struct sockaddr*) &addr, &addr_len );
+    if( 0 > bytes_read )
+    {
+        return;
+    }
+
+    request[bytes_read] = '\0';
+
+    reqid_str = strstr( request, "\"reqid\":\"" );
+    if( NULL != reqid_str )
+    {
+        reqid = (unsigned short) atoi( reqid_str + strlen("\"reqid\":\"") );
+    }
+
+    if(( 0 < _agent.revision )&&
+       ( NULL != strstr( request, "\"cluster_info_subscribe\"" ) ))
+    {
+        ++_agent.subscribes;
+        _agent.subscribe_reqid = reqid;
+        _agent.subscribed = true;
+        _agent.subscriber = addr;
+    } else {
+        ++_agent.queries;
+        _agent.query_reqid = reqid;
+    }
+
+    sm_cluster_hbs_test_agent_send( &addr, reqid );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Cluster Hbs Test - Agent Change
+// ===============================
+// Changes the nodes the peer controller reaches, pushing the change to a
+// subscriber.
+static void sm_cluster_hbs_test_agent_change( unsigned short reachable )
+{
+    _agent.reachable[1] = reachable;
+
+    if( _agent.subscribed )
+    {
+        sm_cluster_hbs_test_agent_send( &(_agent.subscriber), 0 );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Cluster Hbs Test - Agent Open
+// =============================
+// Binds the stand-in to an ephemeral loopback port, which SM is configured
+// to send to, and reserves another for SM to bind to.
+static SmErrorT sm_cluster_hbs_test_agent_open( void )
+{
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    int sock;
+
+    memset( &addr, 0, sizeof(addr) );
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+    _agent.sock = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+    if( 0 > _agent.sock )
+    {
+        printf( "Failed to create socket, error=%s.\n", strerror(errno) );
+        return( SM_FAILED );
+    }
+
+    if(( 0 > bind( _agent.sock, (struct sockaddr*) &addr, sizeof(addr) ) )||
+       ( 0 > getsockname( _agent.sock, (struct sockaddr*) &addr, &addr_len ) ))
+    {
+        printf( "Failed to bind socket, error=%s.\n", strerror(errno) );
+        return( SM_FAILED );
+    }
+
+    snprintf( _server_port, sizeof(_server_port), "%d",
+              ntohs( addr.sin_port ) );
+
+    sock = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+    if( 0 > sock )
+    {
+        printf( "Failed to create socket, error=%s.\n", strerror(errno) );
+        return( SM_FAILED );
+    }
+
+    addr.sin_port = 0;
+
+    if(( 0 > bind( sock, (struct sockaddr*) &addr, sizeof(addr) ) )||
+       ( 0 > getsockname( sock, (struct sockaddr*) &addr, &addr_len ) ))
+    {
+        printf( "Failed to bind socket, error=%s.\n", strerror(errno) );
+        close( sock );
+        return( SM_FAILED );
+    }
+
+    snprintf( _client_port, sizeof(_client_port), "%d",
+              ntohs( addr.sin_port ) );
+    close( sock );
+
+    return( sm_selobj_register( _agent.sock, sm_cluster_hbs_test_agent_receive,
+                                0 ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Cluster Hbs Test - Run
+// ======================
+// Dispatches the stand-in and SM until the messages on the loopback are
+// delivered.
+static void sm_cluster_hbs_test_run( void )
+{
+    struct timespec start, now;
+    long elapsed_ms;
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+
+    do
+    {
+        sm_selobj_dispatch( 10 );
+
+        clock_gettime( CLOCK_MONOTONIC, &now );
+        elapsed_ms = (now.tv_sec - start.tv_sec) * 1000
+                   + (now.tv_nsec - start.tv_nsec) / 1000000;
+    } while( SM_CLUSTER_HBS_TEST_RUN_MS > elapsed_ms );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Cluster Hbs Test - Reachable
+// ============================
+static int sm_cluster_hbs_test_reachable( void )
+{
+    return( SmClusterHbsInfoMsg::get_current_state().controllers[1]
+            .number_of_node_reachable );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Cluster Hbs Test - Subscribed
+// =============================
+static void sm_cluster_hbs_test_subscribed( void )
+{
+    SmClusterHbsInfoMsg::send_alive_pulse();
+    sm_cluster_hbs_test_run();
+
+    sm_cluster_hbs_test_check(( 1 == _agent.subscribes )&&
+                              ( 1 == _agent.queries ),
+                              "subscribe and pulse sent" );
+    sm_cluster_hbs_test_check(( 0 != _agent.query_reqid )&&
+                              ( _agent.subscribe_reqid != _agent.query_reqid ),
+                              "pulse reqid apart from subscribe and push" );
+    sm_cluster_hbs_test_check( SmClusterHbsInfoMsg::is_subscribed(),
+                               "subscription acknowledged" );
+    sm_cluster_hbs_test_check( 0 == SmClusterHbsInfoMsg::get_push_count(),
+                               "replies not counted as pushes" );
+    sm_cluster_hbs_test_check(( 3 == sm_cluster_hbs_test_reachable() )&&
+                              ( 1 == SmClusterHbsInfoMsg::get_state_version() )&&
+                              ( 1 == _failover_signals ), "initial state" );
+
+    sm_cluster_hbs_test_agent_change( 2 );
+    sm_cluster_hbs_test_run();
+
+    sm_cluster_hbs_test_check( 1 == SmClusterHbsInfoMsg::get_push_count(),
+                               "change pushed" );
+    sm_cluster_hbs_test_check(( 2 == sm_cluster_hbs_test_reachable() )&&
+                              ( 2 == SmClusterHbsInfoMsg::get_state_version() )&&
+                              ( 3 == SmClusterHbsInfoMsg::get_previous_state()
+                                     .controllers[1].number_of_node_reachable )&&
+                              ( 2 == _failover_signals ), "pushed state" );
+
+    // Within the renew interval, the pulse does not resubscribe and an
+    // unchanged state is not a new version.
+    SmClusterHbsInfoMsg::send_alive_pulse();
+    sm_cluster_hbs_test_run();
+
+    sm_cluster_hbs_test_check(( 1 == _agent.subscribes )&&
+                              ( 2 == _agent.queries )&&
+                              ( 1 == SmClusterHbsInfoMsg::get_push_count() )&&
+                              ( 2 == SmClusterHbsInfoMsg::get_state_version() ),
+                              "pulse within renew interval" );
+
+    SmClusterHbsInfoMsg::cluster_hbs_info_query( sm_cluster_hbs_test_query_ready );
+    sm_cluster_hbs_test_run();
+
+    sm_cluster_hbs_test_check(( 1 == _queries_ready )&&
+                              ( 3 == _agent.queries ), "query answered" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Cluster Hbs Test - Legacy
+// =========================
+static void sm_cluster_hbs_test_legacy( void )
+{
+    SmClusterHbsInfoMsg::send_alive_pulse();
+    sm_cluster_hbs_test_run();
+
+    sm_cluster_hbs_test_check( 2 == _agent.queries,
+                               "subscribe answered as a query" );
+    sm_cluster_hbs_test_check( !SmClusterHbsInfoMsg::is_subscribed(),
+                               "subscription not acknowledged" );
+    sm_cluster_hbs_test_check(( 0 == SmClusterHbsInfoMsg::get_push_count() )&&
+                              ( 3 == sm_cluster_hbs_test_reachable() )&&
+                              ( 1 == SmClusterHbsInfoMsg::get_state_version() ),
+                              "state from replies" );
+
+    // Changes reach a legacy subscriber only through a query.
+    sm_cluster_hbs_test_agent_change( 2 );
+    sm_cluster_hbs_test_run();
+
+    sm_cluster_hbs_test_check( 3 == sm_cluster_hbs_test_reachable(),
+                               "change not pushed" );
+
+    SmClusterHbsInfoMsg::cluster_hbs_info_query( sm_cluster_hbs_test_query_ready );
+    sm_cluster_hbs_test_run();
+
+    sm_cluster_hbs_test_check(( 1 == _queries_ready )&&
+                              ( 2 == sm_cluster_hbs_test_reachable() )&&
+                              ( 2 == SmClusterHbsInfoMsg::get_state_version() ),
+                              "change queried" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Cluster Hbs Test - Agent
+// ========================
+// Runs SM against a stand-in of the revision given, in a child so that
+// each run starts from the initial subscription state.
+static unsigned int sm_cluster_hbs_test_agent( unsigned short revision )
+{
+    pid_t pid;
+    int status;
+
+    pid = fork();
+    if( 0 > pid )
+    {
+        printf( "Failed to fork, error=%s.\n", strerror(errno) );
+        return( 1 );
+    }
+
+    if( 0 == pid )
+    {
+        memset( &_agent, 0, sizeof(_agent) );
+        _agent.revision = revision;
+        _agent.reachable[0] = 3;
+        _agent.reachable[1] = 3;
+
+        if(( SM_OKAY != sm_selobj_mutex_initialize() )||
+           ( SM_OKAY != sm_selobj_initialize() )||
+           ( SM_OKAY != sm_cluster_hbs_test_agent_open() )||
+           ( SM_OKAY != SmClusterHbsInfoMsg::initialize() ))
+        {
+            printf( "FAIL: initialize\n" );
+            fflush( stdout );
+            _exit( 1 );
+        }
+
+        if( 0 < revision )
+        {
+            sm_cluster_hbs_test_subscribed();
+        } else {
+            sm_cluster_hbs_test_legacy();
+        }
+
+        fflush( stdout );
+        _exit( _failures );
+    }
+
+    if(( pid != waitpid( pid, &status, 0 ) )||( !WIFEXITED( status ) ))
+    {
+        printf( "FAIL: hbsAgent revision %u run\n", revision );
+        return( 1 );
+    }
+
+    return( WEXITSTATUS( status ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Cluster Hbs Test - Main
+// =======================
+int main( int argc, char *argv[], char *envp[] )
+{
+    unsigned int failures = 0;
+
+    printf( "subscribing hbsAgent\n" );
+    fflush( stdout );
+    failures += sm_cluster_hbs_test_agent( 1 );
+
+    printf( "legacy hbsAgent\n" );
+    fflush( stdout );
+    failures += sm_cluster_hbs_test_agent( 0 );
+
+    printf( "%u failed\n", failures );
+
+    return( ( 0 == failures ) ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+// ****************************************************************************
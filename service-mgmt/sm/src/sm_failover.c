@@ -6,6 +6,7 @@
 #include "sm_failover.h"
 
 #include <stdlib.h>
+#include <inttypes.h>
 #include <pthread.h>
 #include <string.h>
 #include <time.h>
@@ -14,6 +15,7 @@
 #include <errno.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/eventfd.h>
 
 #include "sm_service_domain_interface_table.h"
 #include "sm_debug.h"
@@ -21,6 +23,7 @@
 #include "sm_node_utils.h"
 #include "sm_db_nodes.h"
 #include "sm_timer.h"
+#include "sm_selobj.h"
 #include "sm_service_group_table.h"
 #include "sm_node_api.h"
 #include "sm_utils.h"
@@ -41,11 +44,13 @@
 #include "sm_failover_fsm.h"
 #include "sm_api.h"
 #include "sm_cluster_hbs_info_msg.h"
+#include "sm_log.h"
 
 #define SM_FAILOVER_STATE_TRANSITION_TIME_IN_MS 2000
 #define SM_FAILOVER_MULTI_FAILURE_WAIT_TIMER_IN_MS 2000
 #define SM_FAILOVER_RECOVERY_INTERVAL_IN_SEC 100
 #define SM_FAILOVER_INTERFACE_STATE_REPORT_INTERVAL_MS 20000
+#define SM_FAILOVER_AUDIT_INTERVAL_IN_MS 1000
 
 #define SM_FAILOVER_PEER_IS_NORMAL_THRESHOLD 10
 
@@ -158,6 +163,12 @@ static int _heartbeat_count = 0;
 
 static bool _if_state_changed = false;
 
+static int _failover_event_fd = -1;
+static uint32_t _pending_triggers = 0;
+static uint64_t _trigger_counts[SM_FAILOVER_TRIGGER_MAX];
+static uint64_t _evaluation_count = 0;
+static uint64_t _fsm_event_count = 0;
+
 SmErrorT sm_exec_json_command(const char* cmd, char result_buf[], int result_len);
 SmErrorT sm_failover_get_node_oper_state(char* node_name, SmNodeOperationalStateT *state);
 void _log_nodes_state();
@@ -172,6 +183,89 @@ SmErrorT sm_failover_mutex_finalize ( void )
     return sm_mutex_finalize(&sm_failover_mutex);
 }
 
+// ****************************************************************************
+// Failover - trigger string
+// ==================
+static const char* sm_failover_trigger_str( SmFailoverTriggerT trigger )
+{
+    switch( trigger )
+    {
+        case SM_FAILOVER_TRIGGER_AUDIT:
+            return( "audit" );
+        case SM_FAILOVER_TRIGGER_INTERFACE_STATE:
+            return( "interface-state" );
+        case SM_FAILOVER_TRIGGER_HELLO_MSG:
+            return( "hello-msg" );
+        case SM_FAILOVER_TRIGGER_PEER_NODE_INFO:
+            return( "peer-node-info" );
+        case SM_FAILOVER_TRIGGER_NODE_STATE:
+            return( "node-state" );
+        case SM_FAILOVER_TRIGGER_CONTROLLER_STATE:
+            return( "controller-state" );
+        case SM_FAILOVER_TRIGGER_FAILOVER_STATE:
+            return( "failover-state" );
+        case SM_FAILOVER_TRIGGER_CLUSTER_HBS_INFO:
+            return( "cluster-hbs-info" );
+        default:
+            return( "???" );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover - triggers to string
+// ==================
+static void sm_failover_triggers_str( uint32_t triggers, char buf[],
+    unsigned int len )
+{
+    unsigned int used = 0;
+    int trigger_i;
+
+    buf[0] = '\0';
+    for( trigger_i=0; SM_FAILOVER_TRIGGER_MAX > trigger_i; ++trigger_i )
+    {
+        if(( triggers & (1U << trigger_i) )&&( used < len ))
+        {
+            used += snprintf( &(buf[used]), len - used, "%s%s",
+                              ( 0 == used ) ? "" : ",",
+                              sm_failover_trigger_str(
+                                    (SmFailoverTriggerT) trigger_i ) );
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover - signal
+// ==================
+void sm_failover_signal( SmFailoverTriggerT trigger )
+{
+    if(( 0 > trigger )||( SM_FAILOVER_TRIGGER_MAX <= trigger ))
+    {
+        DPRINTFE( "Unknown failover trigger (%i).", trigger );
+        return;
+    }
+
+    // Lock free, callers may hold the mutexes of other modules.
+    __sync_fetch_and_add( &(_trigger_counts[trigger]), 1 );
+
+    uint32_t prev = __sync_fetch_and_or( &_pending_triggers, 1U << trigger );
+
+    if(( 0 == prev )&&( 0 <= _failover_event_fd ))
+    {
+        uint64_t count = 1;
+        if( 0 > write( _failover_event_fd, &count, sizeof(count) ) )
+        {
+            if( EAGAIN != errno )
+            {
+                DPRINTFE( "Failed to signal failover evaluation, error=%s.",
+                          strerror( errno ) );
+            }
+        }
+    }
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Failover - interface check
 // ==================
@@ -272,6 +366,7 @@ void sm_failover_lost_hello_msg()
     {
         DPRINTFI( "Neighbor (%s) declared dead.", _peer_name );
         _hello_msg_alive = false;
+        sm_failover_signal( SM_FAILOVER_TRIGGER_HELLO_MSG );
     }
 }
 
@@ -287,7 +382,11 @@ void sm_failover_hello_msg_restore()
     {
         if ( SM_FAILOVER_INTERFACE_OK == iter->get_state() )
         {
-            _hello_msg_alive = true;
+            if( !_hello_msg_alive )
+            {
+                _hello_msg_alive = true;
+                sm_failover_signal( SM_FAILOVER_TRIGGER_HELLO_MSG );
+            }
             break;
         }
     }
@@ -323,6 +422,7 @@ void sm_failover_lost_heartbeat( SmFailoverInterfaceT* interface )
     }
 
     _if_state_changed = true;
+    sm_failover_signal( SM_FAILOVER_TRIGGER_INTERFACE_STATE );
 }
 // ****************************************************************************
 
@@ -368,6 +468,7 @@ void sm_failover_heartbeat_restore( SmFailoverInterfaceT* interface )
     }
 
     _if_state_changed = true;
+    sm_failover_signal( SM_FAILOVER_TRIGGER_INTERFACE_STATE );
 }
 // ****************************************************************************
 
@@ -401,6 +502,7 @@ void sm_failover_interface_down( const char* const interface_name )
     if( 0 < impacted )
     {
         _if_state_changed = true;
+        sm_failover_signal( SM_FAILOVER_TRIGGER_INTERFACE_STATE );
     }
 }
 // ****************************************************************************
@@ -437,6 +539,7 @@ void sm_failover_interface_up( const char* const interface_name )
     if( 0 < impacted )
     {
         _if_state_changed = true;
+        sm_failover_signal( SM_FAILOVER_TRIGGER_INTERFACE_STATE );
     }
 }
 // ****************************************************************************
@@ -502,6 +605,7 @@ void sm_failover_node_info_update(const char node_name[], SmHeartbeatMsgNodeInfo
         {
             DPRINTFI("%s Node Info changed %#x => %#x", node_name, _peer_node_info, node_info);
             _peer_node_info = node_info;
+            sm_failover_signal( SM_FAILOVER_TRIGGER_PEER_NODE_INFO );
         }
     } else
     {
@@ -923,6 +1027,20 @@ SmErrorT sm_failover_set_system(const SmSystemFailoverStatus& failover_status)
     host_target_state = failover_status.get_host_schedule_state();
     peer_target_state = failover_status.get_peer_schedule_state();
     SmHeartbeatStateT heartbeat_state = failover_status.get_heartbeat_state();
+    char flight_recorder_file[SM_PROCESS_NAME_MAX_CHAR+32];
+    char reason_text[SM_LOG_REASON_TEXT_MAX_CHAR];
+
+    // Keep the debug logs that led to the decision.
+    snprintf( flight_recorder_file, sizeof(flight_recorder_file),
+              SM_DEBUG_FLIGHT_RECORDER_FILE_FORMAT, "sm", "failover" );
+    sm_debug_flight_recorder_save( flight_recorder_file );
+
+    snprintf( reason_text, sizeof(reason_text), "peer %s to %s, heartbeat %s",
+              _peer_name, sm_node_schedule_state_str( peer_target_state ),
+              ( SM_HEARTBEAT_OK == heartbeat_state ) ? "ok" : "lost" );
+    sm_log_node_failover( _host_name, sm_node_schedule_state_str( _host_state ),
+                          sm_node_schedule_state_str( host_target_state ),
+                          reason_text );
 
     if(SM_NODE_STATE_ACTIVE == host_target_state &&
         SM_NODE_STATE_FAILED == peer_target_state &&
@@ -1023,12 +1141,26 @@ SmErrorT sm_failover_set_system(const SmSystemFailoverStatus& failover_status)
 // ****************************************************************************
 
 // ****************************************************************************
-// Failover - audit
+// Failover - evaluate
 // =======================
-void sm_failover_audit()
+// Re-evaluates the failover inputs after one or more triggers, feeding the
+// failover FSM.  Runs on the main thread only.
+static void sm_failover_evaluate( uint32_t triggers )
 {
     mutex_holder holder(&sm_failover_mutex);
 
+    triggers |= __sync_fetch_and_and( &_pending_triggers, 0 );
+    if( 0 == triggers )
+    {
+        return;
+    }
+
+    char triggers_str[128];
+    sm_failover_triggers_str( triggers, triggers_str, sizeof(triggers_str) );
+    ++_evaluation_count;
+    DPRINTFD( "Failover evaluation %" PRIu64 ", triggers=%s.",
+              _evaluation_count, triggers_str );
+
     timespec now;
     time_t now_ms;
     clock_gettime( CLOCK_MONOTONIC_RAW, &now );
@@ -1108,6 +1240,10 @@ void sm_failover_audit()
         {
             event_data.set_interface_state(SM_INTERFACE_ADMIN, SM_FAILOVER_INTERFACE_UNKNOWN);
         }
+        ++_fsm_event_count;
+        DPRINTFI( "Failover event %s, triggers=%s.",
+                  sm_failover_event_str( SM_FAILOVER_EVENT_IF_STATE_CHANGED ),
+                  triggers_str );
         SmFailoverFSM::get_fsm().send_event(SM_FAILOVER_EVENT_IF_STATE_CHANGED, &event_data);
         _if_state_changed = false;
     }
@@ -1138,6 +1274,17 @@ void sm_failover_audit()
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Failover - audit
+// =======================
+// Slow consistency check, catches any input change that was not signalled.
+void sm_failover_audit()
+{
+    __sync_fetch_and_add( &(_trigger_counts[SM_FAILOVER_TRIGGER_AUDIT]), 1 );
+    sm_failover_evaluate( 1U << SM_FAILOVER_TRIGGER_AUDIT );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Failover - audit timeout callback
 // =======================
@@ -1149,6 +1296,26 @@ static bool sm_failover_audit_timeout(SmTimerIdT timer_id,
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Failover - dispatch
+// =======================
+static void sm_failover_dispatch( int selobj, int64_t user_data )
+{
+    uint64_t count;
+
+    if( 0 > read( _failover_event_fd, &count, sizeof(count) ) )
+    {
+        if( EAGAIN != errno )
+        {
+            DPRINTFE( "Failed to read failover event, error=%s.",
+                      strerror( errno ) );
+        }
+    }
+
+    sm_failover_evaluate( 0 );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Failover - exec mtce command
 // =======================
@@ -1443,7 +1610,39 @@ SmErrorT sm_failover_initialize( void )
         }
     }
 
-    error = sm_timer_register( "failover audit", 50,
+    _failover_event_fd = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+    if( 0 > _failover_event_fd )
+    {
+        DPRINTFE( "Failed to open failover event file descriptor, error=%s.",
+                  strerror( errno ) );
+        return( SM_FAILED );
+    }
+
+    error = sm_selobj_register( _failover_event_fd, sm_failover_dispatch, 0 );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to register selection object, error=%s.",
+                  sm_error_str( error ) );
+        close( _failover_event_fd );
+        _failover_event_fd = -1;
+        return( error );
+    }
+
+    // Triggers signalled before the event file descriptor existed found
+    // nothing to write to, and later signals see them pending and skip
+    // the write.
+    if( 0 != __sync_fetch_and_or( &_pending_triggers, 0 ) )
+    {
+        uint64_t count = 1;
+        if( 0 > write( _failover_event_fd, &count, sizeof(count) ) )
+        {
+            DPRINTFE( "Failed to signal failover evaluation, error=%s.",
+                      strerror( errno ) );
+        }
+    }
+
+    error = sm_timer_register( "failover audit",
+           SM_FAILOVER_AUDIT_INTERVAL_IN_MS,
            sm_failover_audit_timeout,
            0, &failover_audit_timer_id );
 
@@ -1454,6 +1653,9 @@ SmErrorT sm_failover_initialize( void )
         return SM_FAILED;
     }
 
+    // Evaluate the initial state rather than waiting for the first audit.
+    sm_failover_signal( SM_FAILOVER_TRIGGER_AUDIT );
+
     return SM_OKAY;
 }
 // ****************************************************************************
@@ -1468,6 +1670,20 @@ SmErrorT sm_failover_finalize( void )
     SmErrorT error;
 
     sm_timer_deregister( failover_audit_timer_id );
+
+    if( 0 <= _failover_event_fd )
+    {
+        error = sm_selobj_deregister( _failover_event_fd );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to deregister selection object, error=%s.",
+                      sm_error_str( error ) );
+        }
+
+        close( _failover_event_fd );
+        _failover_event_fd = -1;
+    }
+
     if( NULL != _sm_db_handle )
     {
         error = sm_db_disconnect( _sm_db_handle );
@@ -1577,6 +1793,20 @@ void dump_peer_failover_fsm_state(FILE* fp)
     fprintf(fp, "   Peer Failover FSM state:   %s\n", sm_failover_state_str(state));
 }
 
+void dump_evaluation_state(FILE* fp)
+{
+    int trigger_i;
+
+    fprintf(fp, "   Failover evaluations:   %" PRIu64 "\n", _evaluation_count);
+    fprintf(fp, "   Failover FSM events:   %" PRIu64 "\n", _fsm_event_count);
+    for( trigger_i=0; SM_FAILOVER_TRIGGER_MAX > trigger_i; ++trigger_i )
+    {
+        fprintf(fp, "      trigger %s:   %" PRIu64 "\n",
+                sm_failover_trigger_str((SmFailoverTriggerT) trigger_i),
+                _trigger_counts[trigger_i]);
+    }
+}
+
 // ****************************************************************************
 // Failover - dump state
 // ======================
@@ -1588,4 +1818,6 @@ void sm_failover_dump_state(FILE* fp)
     dump_interfaces_state(fp);
     dump_peer_if_state(fp);
     dump_peer_failover_fsm_state(fp);
+    dump_evaluation_state(fp);
+    sm_failover_ss_dump_state(fp);
 }
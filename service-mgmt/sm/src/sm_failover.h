@@ -30,6 +30,19 @@ typedef enum
     SM_FAILOVER_DEGRADE_SOURCE_IF_DOWN = 2
 }SmFailoverDegradeSourceT;
 
+typedef enum
+{
+    SM_FAILOVER_TRIGGER_AUDIT,
+    SM_FAILOVER_TRIGGER_INTERFACE_STATE,
+    SM_FAILOVER_TRIGGER_HELLO_MSG,
+    SM_FAILOVER_TRIGGER_PEER_NODE_INFO,
+    SM_FAILOVER_TRIGGER_NODE_STATE,
+    SM_FAILOVER_TRIGGER_CONTROLLER_STATE,
+    SM_FAILOVER_TRIGGER_FAILOVER_STATE,
+    SM_FAILOVER_TRIGGER_CLUSTER_HBS_INFO,
+    SM_FAILOVER_TRIGGER_MAX
+}SmFailoverTriggerT;
+
 
 // ****************************************************************************
 // initialize mutex
@@ -44,15 +57,17 @@ extern SmErrorT sm_failover_mutex_finalize ( void );
 // ****************************************************************************
 
 // ****************************************************************************
-// Failover - check
+// Failover - signal
 // ==================
-extern void sm_failover_check();
+// Records that an input of the failover evaluation has changed and wakes
+// the main thread to re-evaluate.  Safe to call from any thread.
+extern void sm_failover_signal( SmFailoverTriggerT trigger );
 // ****************************************************************************
 
 // ****************************************************************************
 // Failover - audit
 // ==================
-extern void sm_failover_audit(bool recheck);
+extern void sm_failover_audit();
 // ****************************************************************************
 
 // ****************************************************************************
@@ -6,6 +6,7 @@
 #include "sm_failover_fail_pending_state.h"
 #include <stdlib.h>
 #include <unistd.h>
+#include <time.h>
 #include "sm_configuration_table.h"
 #include "sm_cluster_hbs_info_msg.h"
 #include "sm_types.h"
@@ -41,6 +42,9 @@ static inline int get_failpending_timeout()
 static const int fail_pending_timeout = 0;
 
 static SmTimerIdT action_timer_id = SM_TIMER_ID_INVALID;
+static struct timespec _fail_pending_start; // time the failure was detected
+
+void _cluster_hbs_response_callback();
 static const int RESET_TIMEOUT = 10 * 1000; // 10 seconds for a reset command to reboot a node
 static const int GO_ACTIVE_TIMEOUT = 30 * 1000; // 30 seconds for standby node go active
 static const int WAIT_RESET_TIMEOUT = RESET_TIMEOUT + 5 * 1000; // extra 5 seconds for sending reset command
@@ -216,6 +220,11 @@ SmErrorT SmFailoverFailPendingState::event_handler(SmFailoverEventT event, const
             break;
 
         case SM_FAILOVER_EVENT_FAIL_PENDING_TIMEOUT:
+            if(SmClusterHbsInfoMsg::is_subscribed())
+            {
+                // pushed updates keep the cached state current, no query was sent
+                _cluster_hbs_response_callback();
+            }
             sm_node_utils_is_aio_duplex(&duplex);
             if( duplex &&
                 0 == (sm_failover_get_host_node_info_flags() & SM_FAILOVER_HEARTBEAT_ALIVE))
@@ -265,6 +274,14 @@ SmErrorT SmFailoverFailPendingState::event_handler(SmFailoverEventT event, const
                     return error;
                 }
 
+                struct timespec now;
+                clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+                DPRINTFI("Failover decision %ld ms after failure detected, "
+                         "fail pending timeout %d ms",
+                         (long)((now.tv_sec - _fail_pending_start.tv_sec) * 1000 +
+                                (now.tv_nsec - _fail_pending_start.tv_nsec) / 1000000),
+                         get_failpending_timeout());
+
                 error = sm_failover_set_system(failover_status);
                 if(SM_NODE_STATE_FAILED == host_state)
                 {
@@ -311,6 +328,7 @@ bool SmFailoverFailPendingState::_fail_pending_timeout(
 SmErrorT SmFailoverFailPendingState::enter_state()
 {
     SmFSMState::enter_state();
+    clock_gettime(CLOCK_MONOTONIC_RAW, &_fail_pending_start);
     DPRINTFI("Pre failure hbs cluster info:");
     const SmClusterHbsStateT& cluster_hbs_state = SmClusterHbsInfoMsg::get_current_state();
     log_cluster_hbs_state(cluster_hbs_state);
@@ -352,6 +370,11 @@ SmErrorT SmFailoverFailPendingState::_register_timer()
                               SmFailoverFailPendingState::_fail_pending_timeout,
                               0, &this->_pending_timer_id);
 
+    if(SmClusterHbsInfoMsg::is_subscribed())
+    {
+        return error;
+    }
+
     const char* delay_query_hbs_timer_name = "DELAY QUERY HBS";
 
     error = sm_timer_register(delay_query_hbs_timer_name, fail_pending_timeout - 200,
@@ -6,6 +6,8 @@
 #include "sm_failover_fsm.h"
 #include <stdlib.h>
 #include "sm_debug.h"
+#include "sm_failover.h"
+#include "sm_eru_services.h"
 #include "sm_failover_initial_state.h"
 #include "sm_failover_normal_state.h"
 #include "sm_failover_fail_pending_state.h"
@@ -149,6 +151,9 @@ SmErrorT SmFailoverFSM::set_state(SmFailoverStateT state)
     }
 
     this->_current_state = state;
+    sm_failover_signal(SM_FAILOVER_TRIGGER_FAILOVER_STATE);
+    sm_eru_services_set_transition(SM_ERU_SERVICES_TRANSITION_FAILOVER,
+        SM_FAILOVER_STATE_INITIAL != state && SM_FAILOVER_STATE_NORMAL != state);
 
     error = new_state_handler->enter_state();
     if(SM_OKAY != error)
@@ -0,0 +1,1456 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Runs the failover state machine against simulated controllers on a
+// virtual clock.  Each scenario file describes the system, a timeline of
+// interface, heartbeat and cluster-hbs events, and the outcome expected
+// of SM: the survivor it picks, the actions it takes and how long it takes
+// to decide.  The generator builds random scenarios and checks them
+// against the invariants every failover decision must hold.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <sys/wait.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_failover.h"
+#include "sm_failover_fsm.h"
+#include "sm_failover_ss.h"
+#include "sm_failover_sim.h"
+
+#define SM_FAILOVER_SIM_RUN_AFTER_MS                                 30000
+#define SM_FAILOVER_SIM_PEER_INFO_INTERVAL_MS                          100
+#define SM_FAILOVER_SIM_STEPS_MAX                                   100000
+#define SM_FAILOVER_SIM_TIMEOUT_SEC                                      5
+#define SM_FAILOVER_SIM_FAIL_PENDING_DEFAULT_MS                       2000
+#define SM_FAILOVER_SIM_FAIL_PENDING_MIN_MS                           1200
+#define SM_FAILOVER_SIM_LINE_MAX_CHAR                                  256
+#define SM_FAILOVER_SIM_EXIT_FAILED                                      1
+#define SM_FAILOVER_SIM_EXIT_INVALID                                     2
+
+extern "C" int __real_clock_gettime( clockid_t clock_id, struct timespec* tp );
+extern "C" pid_t __real_fork( void );
+
+static struct option _sm_failover_sim_long_options[] =
+{
+    { "generate", required_argument, NULL, 'g'},
+    { "seed",     required_argument, NULL, 's'},
+    { "save",     required_argument, NULL, 'o'},
+    { "verbose",  no_argument,       NULL, 'v'},
+    { "help",     no_argument,       NULL, 'h'},
+    {0, 0, 0, 0}
+};
+
+static const char* _event_names[SM_FAILOVER_SIM_EVENT_MAX] =
+{
+    "link-down", "link-up", "heartbeat-lost", "heartbeat-ok", "hello-lost",
+    "hello-ok", "peer-info", "hbs", "hbs-down", "hbs-up", "peer-enabled",
+    "peer-disabled"
+};
+
+static const char* _peer_info_flags[] =
+{
+    "cluster-host-down", "mgmt-down", "oam-down", "admin-down"
+};
+
+static int _stdout_fd = -1;
+
+// ****************************************************************************
+// Failover Simulation - Usage
+// ===========================
+static void usage( void )
+{
+    printf( " usage:\n"
+            "   sm-failover-sim [--verbose] <scenario> ...\n"
+            "   sm-failover-sim --generate <number> [--seed <number>]\n"
+            "                   [--save <directory>]\n"
+            "       --generate : run the number of random scenarios given,\n"
+            "                    checking the failover invariants\n"
+            "       --seed     : seed of the random scenarios\n"
+            "       --save     : directory to write failing random scenarios\n"
+            "                    to, they replay as scenario files\n"
+            "       --verbose  : trace events, timers and actions on the\n"
+            "                    virtual clock along with the SM log\n"
+            "       --help     : print out this help message\n"
+            "\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Fail Pending Timeout
+// ==========================================
+// The fail pending timeout the scenario configures, as SM applies it.
+static int64_t sm_failover_sim_fail_pending_ms(
+    const SmFailoverSimScenarioT* scenario )
+{
+    unsigned int config_i;
+    for( config_i=0; scenario->num_config > config_i; ++config_i )
+    {
+        if( 0 == strcmp( "FAILPENDING_TIMEOUT_MS",
+                         scenario->config[config_i].key ) )
+        {
+            int64_t timeout_ms = atoi( scenario->config[config_i].value );
+
+            if( SM_FAILOVER_SIM_FAIL_PENDING_MIN_MS <= timeout_ms )
+            {
+                return( timeout_ms );
+            }
+            break;
+        }
+    }
+
+    return( SM_FAILOVER_SIM_FAIL_PENDING_DEFAULT_MS );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Apply Event
+// =================================
+static void sm_failover_sim_apply_event( const SmFailoverSimEventT* event )
+{
+    SmFailoverSimInterfaceT interface = (SmFailoverSimInterfaceT) event->target;
+
+    sm_failover_sim_trace( "event %s", _event_names[event->type] );
+
+    switch( event->type )
+    {
+        case SM_FAILOVER_SIM_EVENT_LINK_DOWN:
+        case SM_FAILOVER_SIM_EVENT_LINK_UP:
+            sm_failover_sim_link_change( interface,
+                    SM_FAILOVER_SIM_EVENT_LINK_UP == event->type );
+        break;
+
+        case SM_FAILOVER_SIM_EVENT_HEARTBEAT_LOST:
+        case SM_FAILOVER_SIM_EVENT_HEARTBEAT_OK:
+            sm_failover_sim_heartbeat( interface,
+                    SM_FAILOVER_SIM_EVENT_HEARTBEAT_OK == event->type );
+        break;
+
+        case SM_FAILOVER_SIM_EVENT_HELLO_LOST:
+            sm_failover_lost_hello_msg();
+        break;
+
+        case SM_FAILOVER_SIM_EVENT_HELLO_OK:
+            sm_failover_hello_msg_restore();
+        break;
+
+        case SM_FAILOVER_SIM_EVENT_PEER_INFO:
+            sm_failover_node_info_update( _sm_failover_sim.peer_name,
+                    (SmHeartbeatMsgNodeInfoT) ((event->target << 8)
+                                               | event->value) );
+        break;
+
+        case SM_FAILOVER_SIM_EVENT_HBS:
+            sm_failover_sim_hbs_update( event->target, event->value,
+                                        event->extra );
+        break;
+
+        case SM_FAILOVER_SIM_EVENT_HBS_DOWN:
+            _sm_failover_sim.hbs_responding = false;
+        break;
+
+        case SM_FAILOVER_SIM_EVENT_HBS_UP:
+            _sm_failover_sim.hbs_responding = true;
+        break;
+
+        case SM_FAILOVER_SIM_EVENT_PEER_ENABLED:
+            _sm_failover_sim.peer_oper_state = SM_NODE_OPERATIONAL_STATE_ENABLED;
+            SmFailoverFSM::get_fsm().send_event( SM_FAILOVER_EVENT_NODE_ENABLED,
+                                                 NULL );
+        break;
+
+        case SM_FAILOVER_SIM_EVENT_PEER_DISABLED:
+            _sm_failover_sim.peer_oper_state = SM_NODE_OPERATIONAL_STATE_DISABLED;
+        break;
+
+        default:
+        break;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Run Until
+// ===============================
+// Advances the virtual clock to the time given, delivering the scenario
+// events and timers in time order and dispatching SM after each one.
+static SmErrorT sm_failover_sim_run_until( int64_t end_ms,
+    unsigned int* event_i )
+{
+    const SmFailoverSimScenarioT* scenario = _sm_failover_sim.scenario;
+    unsigned int steps = 0;
+
+    while( SM_FAILOVER_SIM_STEPS_MAX > ++steps )
+    {
+        int64_t event_ms = SM_FAILOVER_SIM_NEVER;
+        int64_t timer_ms = sm_failover_sim_timer_next();
+        int64_t next_ms;
+
+        if( scenario->num_events > *event_i )
+        {
+            event_ms = scenario->events[*event_i].at_ms;
+        }
+
+        if(( SM_FAILOVER_SIM_NEVER != event_ms )&&
+           (( SM_FAILOVER_SIM_NEVER == timer_ms )||( timer_ms >= event_ms )))
+        {
+            next_ms = event_ms;
+        } else {
+            next_ms = timer_ms;
+        }
+
+        if(( SM_FAILOVER_SIM_NEVER == next_ms )||( end_ms < next_ms ))
+        {
+            if( end_ms > _sm_failover_sim.now_ms )
+            {
+                _sm_failover_sim.now_ms = end_ms;
+            }
+            return( SM_OKAY );
+        }
+
+        if( next_ms > _sm_failover_sim.now_ms )
+        {
+            _sm_failover_sim.now_ms = next_ms;
+        }
+
+        if( next_ms == event_ms )
+        {
+            const SmFailoverSimEventT* event = &(scenario->events[*event_i]);
+            int repeat_i;
+
+            for( repeat_i=0; event->extra > repeat_i
+                 || 0 == repeat_i; ++repeat_i )
+            {
+                if( 0 < repeat_i )
+                {
+                    _sm_failover_sim.now_ms
+                        += SM_FAILOVER_SIM_PEER_INFO_INTERVAL_MS;
+                }
+                sm_failover_sim_apply_event( event );
+                sm_failover_sim_dispatch();
+
+                if( SM_FAILOVER_SIM_EVENT_PEER_INFO != event->type )
+                {
+                    break;
+                }
+            }
+            ++(*event_i);
+        } else {
+            sm_failover_sim_timer_fire();
+            sm_failover_sim_dispatch();
+        }
+    }
+
+    printf( "Scenario (%s) did not settle after %u steps.\n", scenario->name,
+            steps );
+    return( SM_FAILED );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Find Action
+// =================================
+static bool sm_failover_sim_find_action( const char action[] )
+{
+    unsigned int action_i;
+    for( action_i=0; _sm_failover_sim.num_actions > action_i; ++action_i )
+    {
+        if( 0 == strcmp( action, _sm_failover_sim.actions[action_i] ) )
+        {
+            return( true );
+        }
+    }
+
+    return( false );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Check
+// ===========================
+// Checks the outcome of the run against the scenario expectations and the
+// failover invariants.  Returns the number of failures found.
+static unsigned int sm_failover_sim_check( void )
+{
+    const SmFailoverSimScenarioT* scenario = _sm_failover_sim.scenario;
+    const SmFailoverSimWorldT* sim = &_sm_failover_sim;
+    SmFailoverStateT state = SmFailoverFSM::get_fsm().get_state();
+    int64_t first_event_ms = 0;
+    int64_t decision_ms = 0;
+    unsigned int failures = 0;
+
+    if( 0 < scenario->num_events )
+    {
+        first_event_ms = scenario->events[0].at_ms;
+    }
+    decision_ms = sim->decision_ms - first_event_ms;
+
+    if( SM_FAILOVER_SIM_EXPECT_NO_DECISION == scenario->expect_decision )
+    {
+        if( 0 < sim->num_decisions )
+        {
+            printf( "  expected no decision, got host %s, peer %s at %"
+                    PRIi64 " ms\n",
+                    sm_node_schedule_state_str( sim->decision_host_state ),
+                    sm_node_schedule_state_str( sim->decision_peer_state ),
+                    decision_ms );
+            ++failures;
+        }
+    } else if( SM_FAILOVER_SIM_EXPECT_DECISION == scenario->expect_decision ) {
+        if( 0 == sim->num_decisions )
+        {
+            printf( "  expected decision host %s, peer %s, got none\n",
+                    sm_node_schedule_state_str( scenario->expect_host_state ),
+                    sm_node_schedule_state_str( scenario->expect_peer_state ) );
+            ++failures;
+
+        } else if(( scenario->expect_host_state != sim->decision_host_state )||
+                  ( scenario->expect_peer_state != sim->decision_peer_state )) {
+            printf( "  expected decision host %s, peer %s, got host %s, "
+                    "peer %s\n",
+                    sm_node_schedule_state_str( scenario->expect_host_state ),
+                    sm_node_schedule_state_str( scenario->expect_peer_state ),
+                    sm_node_schedule_state_str( sim->decision_host_state ),
+                    sm_node_schedule_state_str( sim->decision_peer_state ) );
+            ++failures;
+        }
+    }
+
+    if(( SM_FAILOVER_SIM_NEVER != scenario->expect_decision_min_ms )&&
+       (( 0 == sim->num_decisions )||
+        ( scenario->expect_decision_min_ms > decision_ms )||
+        ( scenario->expect_decision_max_ms < decision_ms )))
+    {
+        printf( "  expected decision within %" PRIi64 "-%" PRIi64 " ms, got ",
+                scenario->expect_decision_min_ms,
+                scenario->expect_decision_max_ms );
+        if( 0 == sim->num_decisions )
+        {
+            printf( "none\n" );
+        } else {
+            printf( "%" PRIi64 " ms\n", decision_ms );
+        }
+        ++failures;
+    }
+
+    if(( 0 <= scenario->expect_failover_state )&&
+       ( scenario->expect_failover_state != (int) state ))
+    {
+        printf( "  expected failover state %s, got %s\n",
+                sm_failover_state_str(
+                    (SmFailoverStateT) scenario->expect_failover_state ),
+                sm_failover_state_str( state ) );
+        ++failures;
+    }
+
+    if( scenario->expect_actions_exact )
+    {
+        bool match = ( scenario->num_expect_actions == sim->num_actions );
+
+        unsigned int action_i;
+        for( action_i=0; match && sim->num_actions > action_i; ++action_i )
+        {
+            match = ( 0 == strcmp( scenario->expect_actions[action_i],
+                                   sim->actions[action_i] ) );
+        }
+
+        if( !match )
+        {
+            printf( "  expected actions" );
+            for( action_i=0; scenario->num_expect_actions > action_i; ++action_i )
+            {
+                printf( " %s", scenario->expect_actions[action_i] );
+            }
+            printf( "\n  got actions     " );
+            for( action_i=0; sim->num_actions > action_i; ++action_i )
+            {
+                printf( " %s", sim->actions[action_i] );
+            }
+            printf( "\n" );
+            ++failures;
+        }
+    }
+
+    unsigned int expect_i;
+    for( expect_i=0; scenario->num_expect_present > expect_i; ++expect_i )
+    {
+        if( !sm_failover_sim_find_action( scenario->expect_present[expect_i] ) )
+        {
+            printf( "  expected action %s\n",
+                    scenario->expect_present[expect_i] );
+            ++failures;
+        }
+    }
+
+    for( expect_i=0; scenario->num_expect_absent > expect_i; ++expect_i )
+    {
+        if( sm_failover_sim_find_action( scenario->expect_absent[expect_i] ) )
+        {
+            printf( "  unexpected action %s\n",
+                    scenario->expect_absent[expect_i] );
+            ++failures;
+        }
+    }
+
+    // The invariants hold for every scenario, not only generated ones.
+    if( 0 == sim->num_decisions )
+    {
+        return( failures );
+    }
+
+    if(( SM_NODE_STATE_ACTIVE == sim->decision_host_state )&&
+       ( SM_NODE_STATE_ACTIVE == sim->decision_peer_state ))
+    {
+        printf( "  invariant: both controllers left active\n" );
+        ++failures;
+    }
+
+    if(( SM_NODE_STATE_FAILED == sim->decision_host_state )&&
+       ( SM_NODE_STATE_FAILED == sim->decision_peer_state ))
+    {
+        printf( "  invariant: both controllers failed\n" );
+        ++failures;
+    }
+
+    if( sm_failover_sim_fail_pending_ms( scenario ) > decision_ms )
+    {
+        printf( "  invariant: decided after %" PRIi64 " ms, before the fail "
+                "pending timeout of %" PRIi64 " ms\n", decision_ms,
+                sm_failover_sim_fail_pending_ms( scenario ) );
+        ++failures;
+    }
+
+    return( failures );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Finish
+// ============================
+static void sm_failover_sim_finish( void ) __attribute__ ((noreturn));
+static void sm_failover_sim_finish( void )
+{
+    unsigned int failures;
+
+    fflush( stdout );
+    if( 0 <= _stdout_fd )
+    {
+        dup2( _stdout_fd, STDOUT_FILENO );
+        close( _stdout_fd );
+        _stdout_fd = -1;
+    }
+
+    failures = sm_failover_sim_check();
+    fflush( stdout );
+
+    _exit( 0 == failures ? EXIT_SUCCESS : SM_FAILOVER_SIM_EXIT_FAILED );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Restart
+// =============================
+void sm_failover_sim_restart( void )
+{
+    sm_failover_sim_trace( "sm restarted" );
+    sm_failover_sim_finish();
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Child
+// ===========================
+// Runs a scenario in a process of its own, the failover sources keep their
+// state in statics and are only ever initialized once.
+static void sm_failover_sim_child( const SmFailoverSimScenarioT* scenario,
+    bool verbose )
+{
+    unsigned int event_i = 0;
+    int64_t run_ms = scenario->run_ms;
+    SmErrorT error;
+
+    alarm( SM_FAILOVER_SIM_TIMEOUT_SEC );
+
+    if( !verbose )
+    {
+        int null_fd = open( "/dev/null", O_WRONLY );
+
+        _stdout_fd = dup( STDOUT_FILENO );
+        if( 0 <= null_fd )
+        {
+            dup2( null_fd, STDOUT_FILENO );
+            close( null_fd );
+        }
+    }
+
+    sm_debug_set_log_level( verbose ? SM_DEBUG_LOG_LEVEL_INFO
+                                    : SM_DEBUG_LOG_LEVEL_ERROR );
+
+    sm_failover_sim_setup( scenario, verbose );
+
+    error = sm_failover_mutex_initialize();
+    if( SM_OKAY == error )
+    {
+        // The heartbeat thread starts before the failover module and can
+        // report before it is initialized.
+        sm_failover_signal( SM_FAILOVER_TRIGGER_PEER_NODE_INFO );
+
+        error = sm_failover_initialize();
+    }
+
+    if( SM_OKAY != error )
+    {
+        printf( "Failed to initialize failover, error=%s.\n",
+                sm_error_str( error ) );
+        fflush( stdout );
+        _exit( SM_FAILOVER_SIM_EXIT_INVALID );
+    }
+
+    // The initial evaluation is due at once, not on the first audit.
+    struct pollfd fds;
+
+    fds.fd = _sm_failover_sim.selobj;
+    fds.events = POLLIN;
+    fds.revents = 0;
+
+    if(( 0 >= poll( &fds, 1, 0 ) )||( 0 == ( POLLIN & fds.revents ) ))
+    {
+        printf( "  invariant: initial failover evaluation not signalled\n" );
+        fflush( stdout );
+        _exit( SM_FAILOVER_SIM_EXIT_FAILED );
+    }
+
+    // As the service domain does once it has a heartbeat, and the peer
+    // reports on each interface that is in use.
+    SmFailoverFSM::get_fsm().send_event( SM_FAILOVER_EVENT_HEARTBEAT_ENABLED,
+                                         NULL );
+
+    int if_i;
+    for( if_i=0; SM_FAILOVER_SIM_INTERFACE_MAX > if_i; ++if_i )
+    {
+        if( scenario->interfaces[if_i] )
+        {
+            sm_failover_sim_heartbeat( (SmFailoverSimInterfaceT) if_i, true );
+        }
+    }
+
+    sm_failover_hello_msg_restore();
+    sm_failover_node_info_update( _sm_failover_sim.peer_name,
+        (SmHeartbeatMsgNodeInfoT) (SM_FAILOVER_STATE_NORMAL << 8) );
+    sm_failover_sim_dispatch();
+
+    if( SM_OKAY != sm_failover_sim_run_until( -1, &event_i ) )
+    {
+        sm_failover_sim_finish();
+    }
+
+    // What SM did settling in is not part of the scenario.
+    _sm_failover_sim.num_actions = 0;
+    _sm_failover_sim.dropped_actions = 0;
+    _sm_failover_sim.num_decisions = 0;
+    sm_failover_sim_trace( "warm up done, failover state %s",
+        sm_failover_state_str( SmFailoverFSM::get_fsm().get_state() ) );
+
+    if( SM_FAILOVER_SIM_NEVER == run_ms )
+    {
+        run_ms = SM_FAILOVER_SIM_RUN_AFTER_MS;
+        if( 0 < scenario->num_events )
+        {
+            run_ms += scenario->events[scenario->num_events-1].at_ms;
+        }
+    }
+
+    sm_failover_sim_run_until( run_ms, &event_i );
+    sm_failover_sim_finish();
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Run
+// =========================
+// Returns true if the scenario met its expectations.
+static bool sm_failover_sim_run( const SmFailoverSimScenarioT* scenario,
+    bool verbose )
+{
+    pid_t pid;
+    int status;
+
+    fflush( stdout );
+
+    pid = __real_fork();
+    if( 0 > pid )
+    {
+        printf( "Failed to fork scenario (%s), error=%s.\n", scenario->name,
+                strerror(errno) );
+        return( false );
+
+    } else if( 0 == pid ) {
+        sm_failover_sim_child( scenario, verbose );
+        _exit( SM_FAILOVER_SIM_EXIT_INVALID );
+    }
+
+    while( 0 > waitpid( pid, &status, 0 ) )
+    {
+        if( EINTR != errno )
+        {
+            printf( "Failed to wait on scenario (%s), error=%s.\n",
+                    scenario->name, strerror(errno) );
+            return( false );
+        }
+    }
+
+    if( WIFSIGNALED( status ) )
+    {
+        printf( "  %s\n", ( SIGALRM == WTERMSIG( status ) )
+                          ? "hung" : strsignal( WTERMSIG( status ) ) );
+        return( false );
+    }
+
+    return( WIFEXITED( status )&&( EXIT_SUCCESS == WEXITSTATUS( status ) ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Interface Value
+// =====================================
+static int sm_failover_sim_interface_value( const char str[] )
+{
+    int if_i;
+    for( if_i=0; SM_FAILOVER_SIM_INTERFACE_MAX > if_i; ++if_i )
+    {
+        if( 0 == strcmp( str, sm_failover_sim_interface_str(
+                                  (SmFailoverSimInterfaceT) if_i ) ) )
+        {
+            return( if_i );
+        }
+    }
+
+    return( -1 );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Schedule State Value
+// ==========================================
+static int sm_failover_sim_schedule_state_value( const char str[] )
+{
+    int state_i;
+    for( state_i=0; SM_NODE_STATE_MAX > state_i; ++state_i )
+    {
+        if( 0 == strcmp( str, sm_node_schedule_state_str(
+                                  (SmNodeScheduleStateT) state_i ) ) )
+        {
+            return( state_i );
+        }
+    }
+
+    return( -1 );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Failover State Value
+// ==========================================
+static int sm_failover_sim_failover_state_value( const char str[] )
+{
+    int state_i;
+    for( state_i=0; SM_FAILOVER_STATE_MAX > state_i; ++state_i )
+    {
+        if( 0 == strcmp( str, sm_failover_state_str(
+                                  (SmFailoverStateT) state_i ) ) )
+        {
+            return( state_i );
+        }
+    }
+
+    return( -1 );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Parse Event
+// =================================
+// Parses "<ms> <event> [arguments]" of an at line.
+static bool sm_failover_sim_parse_event( char* args[], unsigned int num_args,
+    SmFailoverSimEventT* event )
+{
+    if( 2 > num_args )
+    {
+        return( false );
+    }
+
+    memset( event, 0, sizeof(SmFailoverSimEventT) );
+    event->at_ms = atoll( args[0] );
+    event->type = SM_FAILOVER_SIM_EVENT_MAX;
+
+    int type_i;
+    for( type_i=0; SM_FAILOVER_SIM_EVENT_MAX > type_i; ++type_i )
+    {
+        if( 0 == strcmp( args[1], _event_names[type_i] ) )
+        {
+            event->type = (SmFailoverSimEventTypeT) type_i;
+            break;
+        }
+    }
+
+    switch( event->type )
+    {
+        case SM_FAILOVER_SIM_EVENT_LINK_DOWN:
+        case SM_FAILOVER_SIM_EVENT_LINK_UP:
+        case SM_FAILOVER_SIM_EVENT_HEARTBEAT_LOST:
+        case SM_FAILOVER_SIM_EVENT_HEARTBEAT_OK:
+            if( 3 != num_args )
+            {
+                return( false );
+            }
+            event->target = sm_failover_sim_interface_value( args[2] );
+            return( 0 <= event->target );
+
+        case SM_FAILOVER_SIM_EVENT_PEER_INFO:
+            if( 3 > num_args )
+            {
+                return( false );
+            }
+
+            event->target = sm_failover_sim_failover_state_value( args[2] );
+            event->extra = 1;
+
+            unsigned int arg_i;
+            for( arg_i=3; num_args > arg_i; ++arg_i )
+            {
+                unsigned int flag_i;
+
+                if( 'x' == args[arg_i][0] )
+                {
+                    event->extra = atoi( &(args[arg_i][1]) );
+                    continue;
+                }
+
+                for( flag_i=0; sizeof(_peer_info_flags)
+                     / sizeof(_peer_info_flags[0]) > flag_i; ++flag_i )
+                {
+                    if( 0 == strcmp( args[arg_i], _peer_info_flags[flag_i] ) )
+                    {
+                        event->value |= 1 << flag_i;
+                        break;
+                    }
+                }
+
+                if( sizeof(_peer_info_flags)/sizeof(_peer_info_flags[0])
+                    == flag_i )
+                {
+                    return( false );
+                }
+            }
+            return(( 0 <= event->target )&&( 0 < event->extra ));
+
+        case SM_FAILOVER_SIM_EVENT_HBS:
+            if(( 4 > num_args )||( 5 < num_args ))
+            {
+                return( false );
+            }
+
+            if( 0 == strcmp( "host", args[2] ) )
+            {
+                event->target = 0;
+            } else if( 0 == strcmp( "peer", args[2] ) ) {
+                event->target = 1;
+            } else {
+                return( false );
+            }
+
+            event->value = atoi( args[3] );
+            if( 5 == num_args )
+            {
+                if( 0 != strcmp( "stall", args[4] ) )
+                {
+                    return( false );
+                }
+                event->extra = 1;
+            }
+            return( true );
+
+        case SM_FAILOVER_SIM_EVENT_MAX:
+            return( false );
+
+        default:
+            return( 2 == num_args );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Initialize Scenario
+// =========================================
+static void sm_failover_sim_init_scenario( SmFailoverSimScenarioT* scenario,
+    const char name[] )
+{
+    memset( scenario, 0, sizeof(SmFailoverSimScenarioT) );
+
+    snprintf( scenario->name, sizeof(scenario->name), "%s", name );
+    scenario->system_mode = SM_SYSTEM_MODE_STANDARD;
+    scenario->host_state = SM_NODE_STATE_ACTIVE;
+    scenario->peer_state = SM_NODE_STATE_STANDBY;
+    scenario->interfaces[SM_FAILOVER_SIM_INTERFACE_OAM] = true;
+    scenario->interfaces[SM_FAILOVER_SIM_INTERFACE_MGMT] = true;
+    scenario->hbs_subscribed = true;
+    scenario->hbs_delay_ms = 50;
+    scenario->hbs_reachable[0] = 2;
+    scenario->hbs_reachable[1] = 2;
+    scenario->reset_peer_ms = 1000;
+    scenario->run_ms = SM_FAILOVER_SIM_NEVER;
+    scenario->expect_decision_min_ms = SM_FAILOVER_SIM_NEVER;
+    scenario->expect_decision_max_ms = SM_FAILOVER_SIM_NEVER;
+    scenario->expect_failover_state = -1;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Parse Expect
+// ==================================
+static bool sm_failover_sim_parse_expect( char* args[], unsigned int num_args,
+    SmFailoverSimScenarioT* scenario )
+{
+    if( 2 > num_args )
+    {
+        return( false );
+    }
+
+    if( 0 == strcmp( "decision", args[0] ) )
+    {
+        if(( 2 == num_args )&&( 0 == strcmp( "none", args[1] ) ))
+        {
+            scenario->expect_decision = SM_FAILOVER_SIM_EXPECT_NO_DECISION;
+            return( true );
+        }
+
+        int host_state = sm_failover_sim_schedule_state_value( args[1] );
+        int peer_state = ( 3 == num_args )
+                       ? sm_failover_sim_schedule_state_value( args[2] ) : -1;
+
+        if(( 0 > host_state )||( 0 > peer_state ))
+        {
+            return( false );
+        }
+
+        scenario->expect_decision = SM_FAILOVER_SIM_EXPECT_DECISION;
+        scenario->expect_host_state = (SmNodeScheduleStateT) host_state;
+        scenario->expect_peer_state = (SmNodeScheduleStateT) peer_state;
+        return( true );
+
+    } else if( 0 == strcmp( "decision-ms", args[0] ) ) {
+        if( 3 != num_args )
+        {
+            return( false );
+        }
+        scenario->expect_decision_min_ms = atoll( args[1] );
+        scenario->expect_decision_max_ms = atoll( args[2] );
+        return( scenario->expect_decision_min_ms
+                <= scenario->expect_decision_max_ms );
+
+    } else if( 0 == strcmp( "state", args[0] ) ) {
+        scenario->expect_failover_state
+            = sm_failover_sim_failover_state_value( args[1] );
+        return(( 2 == num_args )&&( 0 <= scenario->expect_failover_state ));
+
+    } else if( 0 == strcmp( "actions", args[0] ) ) {
+        scenario->expect_actions_exact = true;
+
+        unsigned int arg_i;
+        for( arg_i=1; num_args > arg_i; ++arg_i )
+        {
+            if(( SM_FAILOVER_SIM_EXPECT_ACTIONS_MAX
+                 <= scenario->num_expect_actions )||
+               ( 0 == strcmp( "none", args[arg_i] ) ))
+            {
+                return( 0 == strcmp( "none", args[arg_i] )
+                        && 2 == num_args );
+            }
+            snprintf( scenario->expect_actions[scenario->num_expect_actions++],
+                      SM_FAILOVER_SIM_ACTION_NAME_MAX_CHAR, "%s",
+                      args[arg_i] );
+        }
+        return( true );
+
+    } else if( 0 == strcmp( "action", args[0] ) ) {
+        if(( 2 != num_args )||
+           ( SM_FAILOVER_SIM_EXPECT_ACTIONS_MAX <= scenario->num_expect_present ))
+        {
+            return( false );
+        }
+        snprintf( scenario->expect_present[scenario->num_expect_present++],
+                  SM_FAILOVER_SIM_ACTION_NAME_MAX_CHAR, "%s", args[1] );
+        return( true );
+
+    } else if( 0 == strcmp( "no-action", args[0] ) ) {
+        if(( 2 != num_args )||
+           ( SM_FAILOVER_SIM_EXPECT_ACTIONS_MAX <= scenario->num_expect_absent ))
+        {
+            return( false );
+        }
+        snprintf( scenario->expect_absent[scenario->num_expect_absent++],
+                  SM_FAILOVER_SIM_ACTION_NAME_MAX_CHAR, "%s", args[1] );
+        return( true );
+    }
+
+    return( false );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Parse Line
+// ================================
+static bool sm_failover_sim_parse_line( char* args[], unsigned int num_args,
+    SmFailoverSimScenarioT* scenario )
+{
+    const char* key = args[0];
+    char** values = &(args[1]);
+    unsigned int num_values = num_args - 1;
+
+    if( 0 == strcmp( "at", key ) )
+    {
+        if( SM_FAILOVER_SIM_EVENTS_MAX <= scenario->num_events )
+        {
+            return( false );
+        }
+
+        SmFailoverSimEventT* event = &(scenario->events[scenario->num_events]);
+
+        if(( !sm_failover_sim_parse_event( values, num_values, event ) )||
+           (( 0 < scenario->num_events )&&
+            ( event[-1].at_ms > event->at_ms ))||( 0 > event->at_ms ))
+        {
+            return( false );
+        }
+        ++(scenario->num_events);
+        return( true );
+
+    } else if( 0 == strcmp( "expect", key ) ) {
+        return( sm_failover_sim_parse_expect( values, num_values, scenario ) );
+
+    } else if( 0 == strcmp( "interfaces", key ) ) {
+        memset( scenario->interfaces, 0, sizeof(scenario->interfaces) );
+
+        unsigned int value_i;
+        for( value_i=0; num_values > value_i; ++value_i )
+        {
+            int interface = sm_failover_sim_interface_value( values[value_i] );
+
+            if( 0 > interface )
+            {
+                return( false );
+            }
+            scenario->interfaces[interface] = true;
+        }
+        return( scenario->interfaces[SM_FAILOVER_SIM_INTERFACE_OAM]
+                && scenario->interfaces[SM_FAILOVER_SIM_INTERFACE_MGMT] );
+
+    } else if( 0 == strcmp( "config", key ) ) {
+        if(( 2 != num_values )||
+           ( SM_FAILOVER_SIM_CONFIG_MAX <= scenario->num_config ))
+        {
+            return( false );
+        }
+
+        SmFailoverSimConfigT* config = &(scenario->config[scenario->num_config++]);
+
+        snprintf( config->key, sizeof(config->key), "%s", values[0] );
+        snprintf( config->value, sizeof(config->value), "%s", values[1] );
+        return( true );
+
+    } else if( 0 == strcmp( "hbs-reachable", key ) ) {
+        if( 2 != num_values )
+        {
+            return( false );
+        }
+        scenario->hbs_reachable[0] = atoi( values[0] );
+        scenario->hbs_reachable[1] = atoi( values[1] );
+        return( true );
+    }
+
+    if( 1 != num_values )
+    {
+        return( false );
+    }
+
+    const char* value = values[0];
+
+    if( 0 == strcmp( "mode", key ) )
+    {
+        if( 0 == strcmp( "duplex", value ) )
+        {
+            scenario->system_mode = SM_SYSTEM_MODE_STANDARD;
+        } else if( 0 == strcmp( "aio-duplex", value ) ) {
+            scenario->system_mode = SM_SYSTEM_MODE_CPE_DUPLEX;
+        } else if( 0 == strcmp( "aio-duplex-direct", value ) ) {
+            scenario->system_mode = SM_SYSTEM_MODE_CPE_DUPLEX_DC;
+        } else {
+            return( false );
+        }
+
+    } else if(( 0 == strcmp( "host", key ) )||( 0 == strcmp( "peer", key ) )) {
+        int state = sm_failover_sim_schedule_state_value( value );
+
+        if(( SM_NODE_STATE_ACTIVE != state )&&( SM_NODE_STATE_STANDBY != state ))
+        {
+            return( false );
+        }
+
+        if( 0 == strcmp( "host", key ) )
+        {
+            scenario->host_state = (SmNodeScheduleStateT) state;
+        } else {
+            scenario->peer_state = (SmNodeScheduleStateT) state;
+        }
+
+    } else if( 0 == strcmp( "hbs-subscribed", key ) ) {
+        scenario->hbs_subscribed = ( 0 == strcmp( "yes", value ) );
+
+    } else if( 0 == strcmp( "hbs-delay", key ) ) {
+        scenario->hbs_delay_ms = ( 0 == strcmp( "none", value ) )
+                               ? SM_FAILOVER_SIM_NEVER : atoi( value );
+
+    } else if( 0 == strcmp( "storage0", key ) ) {
+        scenario->storage0 = ( 0 == strcmp( "yes", value ) );
+
+    } else if( 0 == strcmp( "reset-peer", key ) ) {
+        scenario->reset_peer_ms = ( 0 == strcmp( "never", value ) )
+                                ? SM_FAILOVER_SIM_NEVER : atoi( value );
+
+    } else if( 0 == strcmp( "run", key ) ) {
+        scenario->run_ms = atoll( value );
+
+    } else {
+        return( false );
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Load
+// ==========================
+static SmErrorT sm_failover_sim_load( const char filename[],
+    SmFailoverSimScenarioT* scenario )
+{
+    char line[SM_FAILOVER_SIM_LINE_MAX_CHAR];
+    unsigned int line_num = 0;
+    const char* name;
+    FILE* fp;
+
+    fp = fopen( filename, "r" );
+    if( NULL == fp )
+    {
+        printf( "Failed to open scenario %s, error=%s.\n", filename,
+                strerror(errno) );
+        return( SM_FAILED );
+    }
+
+    name = strrchr( filename, '/' );
+    sm_failover_sim_init_scenario( scenario, ( NULL == name ) ? filename
+                                                              : name+1 );
+
+    while( NULL != fgets( line, sizeof(line), fp ) )
+    {
+        char* args[SM_FAILOVER_SIM_EXPECT_ACTIONS_MAX+2];
+        unsigned int num_args = 0;
+        char* save = NULL;
+        char* comment;
+        char* arg;
+
+        ++line_num;
+
+        comment = strchr( line, '#' );
+        if( NULL != comment )
+        {
+            *comment = '\0';
+        }
+
+        for( arg = strtok_r( line, " \t\r\n", &save ); NULL != arg;
+             arg = strtok_r( NULL, " \t\r\n", &save ) )
+        {
+            if( sizeof(args)/sizeof(args[0]) <= num_args )
+            {
+                break;
+            }
+            args[num_args++] = arg;
+        }
+
+        if( 0 == num_args )
+        {
+            continue;
+        }
+
+        if(( NULL != arg )||
+           ( !sm_failover_sim_parse_line( args, num_args, scenario ) ))
+        {
+            printf( "%s:%u: invalid scenario line.\n", filename, line_num );
+            fclose( fp );
+            return( SM_FAILED );
+        }
+    }
+
+    fclose( fp );
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Save
+// ==========================
+// Writes a scenario back out in the form it is loaded from.
+static SmErrorT sm_failover_sim_save( const char filename[],
+    const SmFailoverSimScenarioT* scenario, unsigned int seed )
+{
+    const char* mode = "duplex";
+    FILE* fp;
+
+    fp = fopen( filename, "w" );
+    if( NULL == fp )
+    {
+        printf( "Failed to create %s, error=%s.\n", filename, strerror(errno) );
+        return( SM_FAILED );
+    }
+
+    if( SM_SYSTEM_MODE_CPE_DUPLEX == scenario->system_mode )
+    {
+        mode = "aio-duplex";
+    } else if( SM_SYSTEM_MODE_CPE_DUPLEX_DC == scenario->system_mode ) {
+        mode = "aio-duplex-direct";
+    }
+
+    fprintf( fp, "# Generated with --seed %u, failed the failover "
+             "invariants.\n", seed );
+    fprintf( fp, "mode %s\n", mode );
+    fprintf( fp, "host %s\n", sm_node_schedule_state_str( scenario->host_state ) );
+    fprintf( fp, "peer %s\n", sm_node_schedule_state_str( scenario->peer_state ) );
+    fprintf( fp, "interfaces" );
+
+    int if_i;
+    for( if_i=0; SM_FAILOVER_SIM_INTERFACE_MAX > if_i; ++if_i )
+    {
+        if( scenario->interfaces[if_i] )
+        {
+            fprintf( fp, " %s", sm_failover_sim_interface_str(
+                                    (SmFailoverSimInterfaceT) if_i ) );
+        }
+    }
+    fprintf( fp, "\n" );
+
+    fprintf( fp, "hbs-subscribed %s\n", scenario->hbs_subscribed ? "yes" : "no" );
+    if( SM_FAILOVER_SIM_NEVER == scenario->hbs_delay_ms )
+    {
+        fprintf( fp, "hbs-delay none\n" );
+    } else {
+        fprintf( fp, "hbs-delay %i\n", scenario->hbs_delay_ms );
+    }
+    fprintf( fp, "hbs-reachable %i %i\n", scenario->hbs_reachable[0],
+             scenario->hbs_reachable[1] );
+    fprintf( fp, "storage0 %s\n", scenario->storage0 ? "yes" : "no" );
+    if( SM_FAILOVER_SIM_NEVER == scenario->reset_peer_ms )
+    {
+        fprintf( fp, "reset-peer never\n" );
+    } else {
+        fprintf( fp, "reset-peer %i\n", scenario->reset_peer_ms );
+    }
+
+    unsigned int config_i;
+    for( config_i=0; scenario->num_config > config_i; ++config_i )
+    {
+        fprintf( fp, "config %s %s\n", scenario->config[config_i].key,
+                 scenario->config[config_i].value );
+    }
+
+    unsigned int event_i;
+    for( event_i=0; scenario->num_events > event_i; ++event_i )
+    {
+        const SmFailoverSimEventT* event = &(scenario->events[event_i]);
+
+        fprintf( fp, "at %" PRIi64 " %s", event->at_ms,
+                 _event_names[event->type] );
+
+        switch( event->type )
+        {
+            case SM_FAILOVER_SIM_EVENT_LINK_DOWN:
+            case SM_FAILOVER_SIM_EVENT_LINK_UP:
+            case SM_FAILOVER_SIM_EVENT_HEARTBEAT_LOST:
+            case SM_FAILOVER_SIM_EVENT_HEARTBEAT_OK:
+                fprintf( fp, " %s", sm_failover_sim_interface_str(
+                                        (SmFailoverSimInterfaceT) event->target ) );
+            break;
+
+            case SM_FAILOVER_SIM_EVENT_PEER_INFO:
+                fprintf( fp, " %s", sm_failover_state_str(
+                                        (SmFailoverStateT) event->target ) );
+
+                unsigned int flag_i;
+                for( flag_i=0; sizeof(_peer_info_flags)
+                     / sizeof(_peer_info_flags[0]) > flag_i; ++flag_i )
+                {
+                    if( event->value & (1 << flag_i) )
+                    {
+                        fprintf( fp, " %s", _peer_info_flags[flag_i] );
+                    }
+                }
+
+                if( 1 < event->extra )
+                {
+                    fprintf( fp, " x%i", event->extra );
+                }
+            break;
+
+            case SM_FAILOVER_SIM_EVENT_HBS:
+                fprintf( fp, " %s %i%s", ( 0 == event->target ) ? "host" : "peer",
+                         event->value, event->extra ? " stall" : "" );
+            break;
+
+            default:
+            break;
+        }
+        fprintf( fp, "\n" );
+    }
+
+    fclose( fp );
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Random
+// ============================
+static int sm_failover_sim_random( unsigned int* seed, int min, int max )
+{
+    return( min + (int) (rand_r( seed ) % (unsigned int) (max - min + 1)) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Generate Scenario
+// =======================================
+// Builds a random scenario, failures of a single controller or of the
+// links between them, with the cluster-hbs view of it.
+static void sm_failover_sim_generate_scenario( unsigned int seed,
+    SmFailoverSimScenarioT* scenario )
+{
+    static const SmSystemModeT modes[] =
+    {
+        SM_SYSTEM_MODE_STANDARD, SM_SYSTEM_MODE_CPE_DUPLEX,
+        SM_SYSTEM_MODE_CPE_DUPLEX_DC
+    };
+    static const char* fail_pending_ms[] = { "1200", "2000", "3000" };
+    char name[SM_FAILOVER_SIM_CONFIG_MAX_CHAR];
+    int64_t at_ms = 0;
+
+    snprintf( name, sizeof(name), "seed-%u", seed );
+    sm_failover_sim_init_scenario( scenario, name );
+
+    scenario->system_mode = modes[sm_failover_sim_random( &seed, 0, 2 )];
+    if( sm_failover_sim_random( &seed, 0, 1 ) )
+    {
+        scenario->host_state = SM_NODE_STATE_STANDBY;
+        scenario->peer_state = SM_NODE_STATE_ACTIVE;
+    }
+    scenario->interfaces[SM_FAILOVER_SIM_INTERFACE_CLUSTER_HOST]
+        = ( 3 > sm_failover_sim_random( &seed, 0, 9 ) ) ? false : true;
+    scenario->interfaces[SM_FAILOVER_SIM_INTERFACE_ADMIN]
+        = ( 2 > sm_failover_sim_random( &seed, 0, 9 ) );
+    scenario->hbs_subscribed = sm_failover_sim_random( &seed, 0, 1 );
+    scenario->hbs_delay_ms = ( 0 == sm_failover_sim_random( &seed, 0, 9 ) )
+                           ? SM_FAILOVER_SIM_NEVER
+                           : sm_failover_sim_random( &seed, 10, 400 );
+    scenario->storage0 = sm_failover_sim_random( &seed, 0, 1 );
+    scenario->reset_peer_ms = ( 0 == sm_failover_sim_random( &seed, 0, 9 ) )
+                            ? SM_FAILOVER_SIM_NEVER
+                            : sm_failover_sim_random( &seed, 100, 5000 );
+
+    int fail_pending_i = sm_failover_sim_random( &seed, 0, 3 );
+    if( 3 > fail_pending_i )
+    {
+        snprintf( scenario->config[0].key, sizeof(scenario->config[0].key),
+                  "FAILPENDING_TIMEOUT_MS" );
+        snprintf( scenario->config[0].value, sizeof(scenario->config[0].value),
+                  "%s", fail_pending_ms[fail_pending_i] );
+        scenario->num_config = 1;
+    }
+
+    int num_events = sm_failover_sim_random( &seed, 1, 8 );
+    int event_i;
+    for( event_i=0; num_events > event_i; ++event_i )
+    {
+        SmFailoverSimEventT* event = &(scenario->events[event_i]);
+        int interface;
+
+        do
+        {
+            interface = sm_failover_sim_random( &seed, 0,
+                                    SM_FAILOVER_SIM_INTERFACE_MAX-1 );
+        } while( !scenario->interfaces[interface] );
+
+        at_ms += sm_failover_sim_random( &seed, 0, 2500 );
+
+        event->at_ms = at_ms;
+        event->type = (SmFailoverSimEventTypeT)
+            sm_failover_sim_random( &seed, 0, SM_FAILOVER_SIM_EVENT_MAX-1 );
+        event->target = interface;
+
+        if( SM_FAILOVER_SIM_EVENT_PEER_INFO == event->type )
+        {
+            event->target = sm_failover_sim_random( &seed,
+                                SM_FAILOVER_STATE_NORMAL,
+                                SM_FAILOVER_STATE_SURVIVED );
+            event->value = sm_failover_sim_random( &seed, 0, 15 );
+            event->extra = sm_failover_sim_random( &seed, 1, 12 );
+
+        } else if( SM_FAILOVER_SIM_EVENT_HBS == event->type ) {
+            event->target = sm_failover_sim_random( &seed, 0, 1 );
+            event->value = sm_failover_sim_random( &seed, 0, 2 );
+            event->extra = ( 0 == sm_failover_sim_random( &seed, 0, 3 ) );
+        }
+    }
+    scenario->num_events = num_events;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Generate
+// ==============================
+static int sm_failover_sim_generate( unsigned int count, unsigned int seed,
+    const char save_dir[] )
+{
+    SmFailoverSimScenarioT scenario;
+    struct timespec start, end;
+    unsigned int failed = 0;
+    double elapsed;
+
+    __real_clock_gettime( CLOCK_MONOTONIC, &start );
+
+    unsigned int count_i;
+    for( count_i=0; count > count_i; ++count_i )
+    {
+        unsigned int scenario_seed = seed + count_i;
+
+        sm_failover_sim_generate_scenario( scenario_seed, &scenario );
+
+        if( sm_failover_sim_run( &scenario, false ) )
+        {
+            continue;
+        }
+
+        ++failed;
+        printf( "FAIL %s\n", scenario.name );
+
+        if( NULL != save_dir )
+        {
+            char filename[512];
+
+            snprintf( filename, sizeof(filename), "%s/%s.scenario", save_dir,
+                      scenario.name );
+            sm_failover_sim_save( filename, &scenario, scenario_seed );
+        }
+    }
+
+    __real_clock_gettime( CLOCK_MONOTONIC, &end );
+
+    elapsed = (end.tv_sec - start.tv_sec)
+            + (end.tv_nsec - start.tv_nsec) / 1000000000.0;
+
+    printf( "%u scenarios from seed %u, %u failed, %.3f s, %.0f "
+            "scenarios/s\n", count, seed, failed, elapsed,
+            ( 0 < elapsed ) ? count / elapsed : 0.0 );
+
+    return( 0 == failed ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Main
+// ==========================
+int main( int argc, char *argv[] )
+{
+    SmFailoverSimScenarioT scenario;
+    unsigned int generate = 0;
+    unsigned int seed = 1;
+    const char* save_dir = NULL;
+    unsigned int failed = 0;
+    bool verbose = false;
+    int c;
+
+    while( true )
+    {
+        c = getopt_long( argc, argv, "g:s:o:vh", _sm_failover_sim_long_options,
+                         NULL );
+        if( -1 == c )
+        {
+            break;
+        }
+
+        switch( c )
+        {
+            case 'g':
+                generate = strtoul( optarg, NULL, 0 );
+            break;
+
+            case 's':
+                seed = strtoul( optarg, NULL, 0 );
+            break;
+
+            case 'o':
+                save_dir = optarg;
+            break;
+
+            case 'v':
+                verbose = true;
+            break;
+
+            case 'h':
+            case '?':
+                usage();
+                exit( 0 );
+            break;
+        }
+    }
+
+    if( 0 < generate )
+    {
+        return( sm_failover_sim_generate( generate, seed, save_dir ) );
+    }
+
+    if( optind >= argc )
+    {
+        usage();
+        return( EXIT_FAILURE );
+    }
+
+    for( ; argc > optind; ++optind )
+    {
+        if( SM_OKAY != sm_failover_sim_load( argv[optind], &scenario ) )
+        {
+            ++failed;
+            continue;
+        }
+
+        if( sm_failover_sim_run( &scenario, verbose ) )
+        {
+            printf( "PASS %s\n", scenario.name );
+        } else {
+            printf( "FAIL %s\n", scenario.name );
+            ++failed;
+        }
+    }
+
+    return( 0 == failed ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+// ****************************************************************************
@@ -0,0 +1,278 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __SM_FAILOVER_SIM_H__
+#define __SM_FAILOVER_SIM_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+#include "sm_timer.h"
+#include "sm_selobj.h"
+#include "sm_hw.h"
+#include "sm_service_domain_interface_table.h"
+#include "sm_cluster_hbs_info_msg.h"
+
+#define SM_FAILOVER_SIM_EVENTS_MAX                                      64
+#define SM_FAILOVER_SIM_ACTIONS_MAX                                     64
+#define SM_FAILOVER_SIM_ACTION_NAME_MAX_CHAR                            32
+#define SM_FAILOVER_SIM_EXPECT_ACTIONS_MAX                              16
+#define SM_FAILOVER_SIM_CONFIG_MAX                                       8
+#define SM_FAILOVER_SIM_CONFIG_MAX_CHAR                                 48
+#define SM_FAILOVER_SIM_TIMERS_MAX                                      32
+#define SM_FAILOVER_SIM_TIMER_NAME_MAX_CHAR                             40
+#define SM_FAILOVER_SIM_FILES_MAX                                        8
+#define SM_FAILOVER_SIM_NEVER                                           -1
+
+// Time SM runs before the first scenario event, long enough for the
+// interfaces to leave their initial transition.
+#define SM_FAILOVER_SIM_WARMUP_MS                                     3000
+
+typedef enum
+{
+    SM_FAILOVER_SIM_INTERFACE_OAM,
+    SM_FAILOVER_SIM_INTERFACE_MGMT,
+    SM_FAILOVER_SIM_INTERFACE_CLUSTER_HOST,
+    SM_FAILOVER_SIM_INTERFACE_ADMIN,
+    SM_FAILOVER_SIM_INTERFACE_MAX
+} SmFailoverSimInterfaceT;
+
+typedef enum
+{
+    SM_FAILOVER_SIM_EVENT_LINK_DOWN,
+    SM_FAILOVER_SIM_EVENT_LINK_UP,
+    SM_FAILOVER_SIM_EVENT_HEARTBEAT_LOST,
+    SM_FAILOVER_SIM_EVENT_HEARTBEAT_OK,
+    SM_FAILOVER_SIM_EVENT_HELLO_LOST,
+    SM_FAILOVER_SIM_EVENT_HELLO_OK,
+    SM_FAILOVER_SIM_EVENT_PEER_INFO,
+    SM_FAILOVER_SIM_EVENT_HBS,
+    SM_FAILOVER_SIM_EVENT_HBS_DOWN,
+    SM_FAILOVER_SIM_EVENT_HBS_UP,
+    SM_FAILOVER_SIM_EVENT_PEER_ENABLED,
+    SM_FAILOVER_SIM_EVENT_PEER_DISABLED,
+    SM_FAILOVER_SIM_EVENT_MAX
+} SmFailoverSimEventTypeT;
+
+typedef struct
+{
+    int64_t at_ms;
+    SmFailoverSimEventTypeT type;
+    // Interface for the link and heartbeat events, controller for the
+    // hbs event (0 host, 1 peer), failover state for peer-info.
+    int target;
+    // Reachable nodes for the hbs event, interface down flags for
+    // peer-info.
+    int value;
+    // Peer stalled for the hbs event, repeat count for peer-info.
+    int extra;
+} SmFailoverSimEventT;
+
+typedef struct
+{
+    char key[SM_FAILOVER_SIM_CONFIG_MAX_CHAR];
+    char value[SM_FAILOVER_SIM_CONFIG_MAX_CHAR];
+} SmFailoverSimConfigT;
+
+typedef enum
+{
+    SM_FAILOVER_SIM_EXPECT_UNSET,
+    SM_FAILOVER_SIM_EXPECT_DECISION,
+    SM_FAILOVER_SIM_EXPECT_NO_DECISION,
+} SmFailoverSimExpectDecisionT;
+
+typedef struct
+{
+    char name[SM_FAILOVER_SIM_CONFIG_MAX_CHAR];
+    SmSystemModeT system_mode;
+    SmNodeScheduleStateT host_state;
+    SmNodeScheduleStateT peer_state;
+    bool interfaces[SM_FAILOVER_SIM_INTERFACE_MAX];
+    bool hbs_subscribed;
+    int hbs_delay_ms;
+    int hbs_reachable[max_controllers];
+    bool storage0;
+    int reset_peer_ms;
+    int64_t run_ms;
+    SmFailoverSimConfigT config[SM_FAILOVER_SIM_CONFIG_MAX];
+    unsigned int num_config;
+    SmFailoverSimEventT events[SM_FAILOVER_SIM_EVENTS_MAX];
+    unsigned int num_events;
+
+    SmFailoverSimExpectDecisionT expect_decision;
+    SmNodeScheduleStateT expect_host_state;
+    SmNodeScheduleStateT expect_peer_state;
+    int64_t expect_decision_min_ms;
+    int64_t expect_decision_max_ms;
+    int expect_failover_state;
+    bool expect_actions_exact;
+    char expect_actions[SM_FAILOVER_SIM_EXPECT_ACTIONS_MAX]
+                       [SM_FAILOVER_SIM_ACTION_NAME_MAX_CHAR];
+    unsigned int num_expect_actions;
+    char expect_present[SM_FAILOVER_SIM_EXPECT_ACTIONS_MAX]
+                       [SM_FAILOVER_SIM_ACTION_NAME_MAX_CHAR];
+    unsigned int num_expect_present;
+    char expect_absent[SM_FAILOVER_SIM_EXPECT_ACTIONS_MAX]
+                      [SM_FAILOVER_SIM_ACTION_NAME_MAX_CHAR];
+    unsigned int num_expect_absent;
+} SmFailoverSimScenarioT;
+
+typedef struct
+{
+    bool inuse;
+    SmTimerIdT id;
+    char name[SM_FAILOVER_SIM_TIMER_NAME_MAX_CHAR];
+    unsigned int ms;
+    int64_t due_ms;
+    SmTimerCallbackT callback;
+    int64_t user_data;
+} SmFailoverSimTimerT;
+
+typedef struct
+{
+    bool exists;
+    char path[SM_FAILOVER_SIM_CONFIG_MAX_CHAR];
+    int64_t created_ms;
+} SmFailoverSimFileT;
+
+// The simulated world the failover sources run against.  Everything the
+// stub providers return comes from here, and everything SM asks them to
+// do is recorded here.
+typedef struct
+{
+    const SmFailoverSimScenarioT* scenario;
+    bool verbose;
+    int64_t now_ms;
+
+    char host_name[SM_NODE_NAME_MAX_CHAR];
+    char peer_name[SM_NODE_NAME_MAX_CHAR];
+    char leader[SM_NODE_NAME_MAX_CHAR];
+    SmNodeScheduleStateT host_state;
+    SmNodeScheduleStateT peer_state;
+    SmNodeOperationalStateT peer_oper_state;
+    bool unhealthy;
+    bool degraded;
+
+    bool link_enabled[SM_FAILOVER_SIM_INTERFACE_MAX];
+    SmServiceDomainInterfaceT interfaces[SM_FAILOVER_SIM_INTERFACE_MAX];
+    unsigned int num_interfaces;
+    SmHwInterfaceChangeCallbackT interface_change;
+
+    int selobj;
+    SmSelObjCallbackT selobj_callback;
+    int64_t selobj_user_data;
+
+    SmFailoverSimTimerT timers[SM_FAILOVER_SIM_TIMERS_MAX];
+    SmTimerIdT next_timer_id;
+
+    bool hbs_responding;
+    unsigned int hbs_queries;
+    SmClusterHbsStateT hbs_mtce;
+    SmClusterHbsStateT hbs_current;
+    SmClusterHbsStateT hbs_previous;
+
+    SmFailoverSimFileT files[SM_FAILOVER_SIM_FILES_MAX];
+
+    char actions[SM_FAILOVER_SIM_ACTIONS_MAX]
+                [SM_FAILOVER_SIM_ACTION_NAME_MAX_CHAR];
+    unsigned int num_actions;
+    unsigned int dropped_actions;
+
+    unsigned int num_decisions;
+    int64_t decision_ms;
+    SmNodeScheduleStateT decision_host_state;
+    SmNodeScheduleStateT decision_peer_state;
+} SmFailoverSimWorldT;
+
+extern SmFailoverSimWorldT _sm_failover_sim;
+
+// ****************************************************************************
+// Failover Simulation - Setup
+// ===========================
+// Builds the world for a scenario, before SM is initialized against it.
+extern void sm_failover_sim_setup( const SmFailoverSimScenarioT* scenario,
+    bool verbose );
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Trace
+// ===========================
+extern void sm_failover_sim_trace( const char* format, ... )
+    __attribute__ ((format (printf, 1, 2)));
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Action
+// ============================
+// Records something SM asked a provider to do.
+extern void sm_failover_sim_action( const char* format, ... )
+    __attribute__ ((format (printf, 1, 2)));
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Timer Next
+// ================================
+// Returns the time the next timer is due, or SM_FAILOVER_SIM_NEVER.
+extern int64_t sm_failover_sim_timer_next( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Timer Fire
+// ================================
+// Runs the timer that is due first.
+extern void sm_failover_sim_timer_fire( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Dispatch
+// ==============================
+// Runs the selection object callback while its file descriptor is readable,
+// as the SM main loop would.
+extern void sm_failover_sim_dispatch( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Restart
+// =============================
+// SM restarts itself, the run ends here and its outcome is checked.
+extern void sm_failover_sim_restart( void ) __attribute__ ((noreturn));
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Link Change
+// =================================
+extern void sm_failover_sim_link_change( SmFailoverSimInterfaceT interface,
+    bool enabled );
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Heartbeat
+// ===============================
+// Reports the heartbeat of the peer on an interface, as the heartbeat
+// thread does.
+extern void sm_failover_sim_heartbeat( SmFailoverSimInterfaceT interface,
+    bool alive );
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Cluster Heartbeat Update
+// ==============================================
+// Changes what mtce reports for a controller.  Pushed straight to SM when
+// subscribed, otherwise seen by SM on its next query.
+extern void sm_failover_sim_hbs_update( int controller, int reachable,
+    bool stalled );
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Interface String
+// ======================================
+extern const char* sm_failover_sim_interface_str(
+    SmFailoverSimInterfaceT interface );
+// ****************************************************************************
+
+#endif // __SM_FAILOVER_SIM_H__
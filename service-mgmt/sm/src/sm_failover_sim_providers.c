@@ -0,0 +1,1350 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Stub providers for the failover simulation.  The failover sources are
+// linked unchanged, the interface, heartbeat, node, cluster-hbs and timer
+// modules they call are replaced here by a simulated world on a virtual
+// clock.  The providers that live in libsm_common are interposed by the
+// executable.  The libc calls the failover sources make for time, sleeps,
+// flag files and the sm restart are wrapped at link time, so that a run
+// never touches the files SM shares with mtce.
+//
+#include "sm_failover_sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+
+#include "sm_debug.h"
+#include "sm_utils.h"
+#include "sm_node_utils.h"
+#include "sm_node_api.h"
+#include "sm_node_fsm.h"
+#include "sm_node_swact_monitor.h"
+#include "sm_db.h"
+#include "sm_db_nodes.h"
+#include "sm_log.h"
+#include "sm_configuration_table.h"
+#include "sm_service_domain_table.h"
+#include "sm_service_domain_member_table.h"
+#include "sm_service_domain_assignment_table.h"
+#include "sm_service_domain_interface_table.h"
+#include "sm_service_domain_fsm.h"
+#include "sm_service_domain_neighbor_fsm.h"
+#include "sm_service_domain_utils.h"
+#include "sm_worker_thread.h"
+#include "sm_failover.h"
+#include "sm_failover_ss.h"
+
+#define SM_FAILOVER_SIM_MONOTONIC_BASE_MS                    1000000LL
+#define SM_FAILOVER_SIM_REALTIME_BASE_MS                  1700000000000LL
+#define SM_FAILOVER_SIM_DOMAIN                             "controller"
+#define SM_FAILOVER_SIM_RESET_PEER_FILE           "/var/run/.sm_reset_peer"
+
+extern "C" int __real_open( const char* path, int flags, ... );
+extern "C" FILE* __real_fopen( const char* path, const char* mode );
+
+typedef struct
+{
+    const char* path;
+    const char* create_action;
+    const char* remove_action;
+} SmFailoverSimFileActionT;
+
+static const SmFailoverSimFileActionT _file_actions[] =
+{
+    { SM_FAILOVER_SIM_RESET_PEER_FILE, "reset-peer", NULL },
+    { "/var/run/.sm_stay_fail", "stayfailed-set", "stayfailed-clear" },
+};
+
+static const char* _interface_names[SM_FAILOVER_SIM_INTERFACE_MAX] =
+{
+    "oam0", "mgmt0", "cluster0", "admin0"
+};
+
+static const char* _domain_interfaces[SM_FAILOVER_SIM_INTERFACE_MAX] =
+{
+    SM_SERVICE_DOMAIN_OAM_INTERFACE,
+    SM_SERVICE_DOMAIN_MGMT_INTERFACE,
+    SM_SERVICE_DOMAIN_CLUSTER_HOST_INTERFACE,
+    SM_SERVICE_DOMAIN_ADMIN_INTERFACE
+};
+
+SmFailoverSimWorldT _sm_failover_sim;
+
+// ****************************************************************************
+// Failover Simulation - Interface String
+// ======================================
+const char* sm_failover_sim_interface_str( SmFailoverSimInterfaceT interface )
+{
+    switch( interface )
+    {
+        case SM_FAILOVER_SIM_INTERFACE_OAM:
+            return( "oam" );
+        case SM_FAILOVER_SIM_INTERFACE_MGMT:
+            return( "mgmt" );
+        case SM_FAILOVER_SIM_INTERFACE_CLUSTER_HOST:
+            return( "cluster-host" );
+        case SM_FAILOVER_SIM_INTERFACE_ADMIN:
+            return( "admin" );
+        default:
+            return( "???" );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Trace
+// ===========================
+void sm_failover_sim_trace( const char* format, ... )
+{
+    va_list arguments;
+
+    if( !_sm_failover_sim.verbose )
+    {
+        return;
+    }
+
+    printf( "  %7" PRIi64 " ms  ", _sm_failover_sim.now_ms );
+    va_start( arguments, format );
+    vprintf( format, arguments );
+    va_end( arguments );
+    printf( "\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Action
+// ============================
+void sm_failover_sim_action( const char* format, ... )
+{
+    va_list arguments;
+
+    if( SM_FAILOVER_SIM_ACTIONS_MAX <= _sm_failover_sim.num_actions )
+    {
+        ++_sm_failover_sim.dropped_actions;
+        return;
+    }
+
+    char* action = _sm_failover_sim.actions[_sm_failover_sim.num_actions++];
+
+    va_start( arguments, format );
+    vsnprintf( action, SM_FAILOVER_SIM_ACTION_NAME_MAX_CHAR, format,
+               arguments );
+    va_end( arguments );
+
+    sm_failover_sim_trace( "action %s", action );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Role
+// ==========================
+static const char* sm_failover_sim_role( const char node_name[] )
+{
+    if( 0 == strcmp( node_name, _sm_failover_sim.host_name ) )
+    {
+        return( "host" );
+    } else if( 0 == strcmp( node_name, _sm_failover_sim.peer_name ) ) {
+        return( "peer" );
+    }
+
+    return( "unknown" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Setup
+// ===========================
+void sm_failover_sim_setup( const SmFailoverSimScenarioT* scenario,
+    bool verbose )
+{
+    SmFailoverSimWorldT* sim = &_sm_failover_sim;
+
+    sim->scenario = scenario;
+    sim->verbose = verbose;
+    sim->now_ms = -SM_FAILOVER_SIM_WARMUP_MS;
+
+    snprintf( sim->host_name, sizeof(sim->host_name), "%s",
+              SM_NODE_CONTROLLER_0_NAME );
+    snprintf( sim->peer_name, sizeof(sim->peer_name), "%s",
+              SM_NODE_CONTROLLER_1_NAME );
+    snprintf( sim->leader, sizeof(sim->leader), "%s",
+              ( SM_NODE_STATE_ACTIVE == scenario->host_state )
+              ? sim->host_name : sim->peer_name );
+    sim->host_state = scenario->host_state;
+    sim->peer_state = scenario->peer_state;
+    sim->peer_oper_state = SM_NODE_OPERATIONAL_STATE_ENABLED;
+
+    // The domain interface table always holds all of them, the node
+    // configuration decides which are in use.
+    sim->num_interfaces = SM_FAILOVER_SIM_INTERFACE_MAX;
+
+    int if_i;
+    for( if_i=0; SM_FAILOVER_SIM_INTERFACE_MAX > if_i; ++if_i )
+    {
+        SmServiceDomainInterfaceT* interface = &(sim->interfaces[if_i]);
+
+        sim->link_enabled[if_i] = true;
+        interface->id = if_i + 1;
+        snprintf( interface->service_domain,
+                  sizeof(interface->service_domain), "%s",
+                  SM_FAILOVER_SIM_DOMAIN );
+        snprintf( interface->service_domain_interface,
+                  sizeof(interface->service_domain_interface), "%s",
+                  _domain_interfaces[if_i] );
+        interface->interface_state = SM_INTERFACE_STATE_ENABLED;
+    }
+
+    sim->selobj = -1;
+    sim->next_timer_id = 1;
+
+    sim->hbs_responding = true;
+
+    unsigned int controller_i;
+    for( controller_i=0; max_controllers > controller_i; ++controller_i )
+    {
+        sim->hbs_mtce.controllers[controller_i].number_of_node_reachable
+            = scenario->hbs_reachable[controller_i];
+        sim->hbs_mtce.controllers[controller_i].storage0_responding
+            = scenario->storage0;
+    }
+    sim->hbs_mtce.storage0_enabled = scenario->storage0;
+    sim->hbs_mtce.last_update
+        = (SM_FAILOVER_SIM_REALTIME_BASE_MS + sim->now_ms) / 1000;
+    sim->hbs_mtce.version = 1;
+    sim->hbs_current = sim->hbs_mtce;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Timer Next
+// ================================
+int64_t sm_failover_sim_timer_next( void )
+{
+    int64_t next_ms = SM_FAILOVER_SIM_NEVER;
+
+    unsigned int timer_i;
+    for( timer_i=0; SM_FAILOVER_SIM_TIMERS_MAX > timer_i; ++timer_i )
+    {
+        SmFailoverSimTimerT* timer = &(_sm_failover_sim.timers[timer_i]);
+
+        if(( timer->inuse )&&
+           (( SM_FAILOVER_SIM_NEVER == next_ms )||( next_ms > timer->due_ms )))
+        {
+            next_ms = timer->due_ms;
+        }
+    }
+
+    return( next_ms );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Timer Find
+// ================================
+static SmFailoverSimTimerT* sm_failover_sim_timer_find( SmTimerIdT timer_id )
+{
+    unsigned int timer_i;
+    for( timer_i=0; SM_FAILOVER_SIM_TIMERS_MAX > timer_i; ++timer_i )
+    {
+        SmFailoverSimTimerT* timer = &(_sm_failover_sim.timers[timer_i]);
+
+        if(( timer->inuse )&&( timer_id == timer->id ))
+        {
+            return( timer );
+        }
+    }
+
+    return( NULL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Timer Fire
+// ================================
+void sm_failover_sim_timer_fire( void )
+{
+    SmFailoverSimTimerT* due = NULL;
+
+    unsigned int timer_i;
+    for( timer_i=0; SM_FAILOVER_SIM_TIMERS_MAX > timer_i; ++timer_i )
+    {
+        SmFailoverSimTimerT* timer = &(_sm_failover_sim.timers[timer_i]);
+
+        if(( timer->inuse )&&
+           (( NULL == due )||( due->due_ms > timer->due_ms )||
+            (( due->due_ms == timer->due_ms )&&( due->id > timer->id ))))
+        {
+            due = timer;
+        }
+    }
+
+    if( NULL == due )
+    {
+        return;
+    }
+
+    // The callback may register or deregister timers, including itself.
+    SmTimerIdT timer_id = due->id;
+    SmTimerCallbackT callback = due->callback;
+    int64_t user_data = due->user_data;
+
+    bool rearm = callback( timer_id, user_data );
+
+    due = sm_failover_sim_timer_find( timer_id );
+    if( NULL != due )
+    {
+        if( rearm )
+        {
+            due->due_ms = _sm_failover_sim.now_ms + due->ms;
+        } else {
+            due->inuse = false;
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Dispatch
+// ==============================
+void sm_failover_sim_dispatch( void )
+{
+    struct pollfd fds;
+
+    if(( 0 > _sm_failover_sim.selobj )||
+       ( NULL == _sm_failover_sim.selobj_callback ))
+    {
+        return;
+    }
+
+    // Bounded, a callback that never drains its descriptor is reported by
+    // the scenario outcome rather than hanging the run.
+    unsigned int dispatch_i;
+    for( dispatch_i=0; 16 > dispatch_i; ++dispatch_i )
+    {
+        fds.fd = _sm_failover_sim.selobj;
+        fds.events = POLLIN;
+        fds.revents = 0;
+
+        if(( 0 >= poll( &fds, 1, 0 ) )||( 0 == ( POLLIN & fds.revents ) ))
+        {
+            break;
+        }
+
+        _sm_failover_sim.selobj_callback( _sm_failover_sim.selobj,
+                                          _sm_failover_sim.selobj_user_data );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Link Change
+// =================================
+void sm_failover_sim_link_change( SmFailoverSimInterfaceT interface,
+    bool enabled )
+{
+    SmHwInterfaceChangeDataT data;
+
+    _sm_failover_sim.link_enabled[interface] = enabled;
+
+    if( NULL == _sm_failover_sim.interface_change )
+    {
+        return;
+    }
+
+    memset( &data, 0, sizeof(data) );
+    data.type = SM_HW_INTERFACE_CHANGE_TYPE_UNKNOWN;
+    snprintf( data.interface_name, sizeof(data.interface_name), "%s",
+              _interface_names[interface] );
+    data.interface_state = enabled ? SM_INTERFACE_STATE_ENABLED
+                                   : SM_INTERFACE_STATE_DISABLED;
+
+    _sm_failover_sim.interface_change( &data );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Heartbeat
+// ===============================
+void sm_failover_sim_heartbeat( SmFailoverSimInterfaceT interface,
+    bool alive )
+{
+    SmServiceDomainInterfaceT* domain_interface
+        = &(_sm_failover_sim.interfaces[interface]);
+    SmFailoverInterfaceT failover_interface;
+
+    failover_interface.service_domain = domain_interface->service_domain;
+    failover_interface.service_domain_interface
+        = domain_interface->service_domain_interface;
+    failover_interface.interface_name = domain_interface->interface_name;
+    failover_interface.interface_state = domain_interface->interface_state;
+
+    if( alive )
+    {
+        sm_failover_heartbeat_restore( &failover_interface );
+    } else {
+        sm_failover_lost_heartbeat( &failover_interface );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Cluster Heartbeat Receive
+// ===============================================
+// Mirrors the handling of an hbsAgent message by SM.
+static void sm_failover_sim_hbs_receive( void )
+{
+    SmFailoverSimWorldT* sim = &_sm_failover_sim;
+    SmClusterHbsStateT state = sim->hbs_mtce;
+
+    if( state != sim->hbs_current )
+    {
+        state.last_update
+            = (SM_FAILOVER_SIM_REALTIME_BASE_MS + sim->now_ms) / 1000;
+        state.version = sim->hbs_current.version + 1;
+        sim->hbs_previous = sim->hbs_current;
+        sim->hbs_current = state;
+        sm_failover_sim_trace( "hbs state v%u received", state.version );
+        sm_failover_signal( SM_FAILOVER_TRIGGER_CLUSTER_HBS_INFO );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Cluster Heartbeat Reply
+// =============================================
+static bool sm_failover_sim_hbs_reply( SmTimerIdT timer_id, int64_t user_data )
+{
+    cluster_hbs_query_ready_callback callback
+        = (cluster_hbs_query_ready_callback) (intptr_t) user_data;
+
+    if( _sm_failover_sim.hbs_responding )
+    {
+        sm_failover_sim_hbs_receive();
+
+        if( NULL != callback )
+        {
+            callback();
+        }
+    }
+
+    return( false );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Cluster Heartbeat Update
+// ==============================================
+void sm_failover_sim_hbs_update( int controller, int reachable, bool stalled )
+{
+    SmClusterHbsInfoT* info = &(_sm_failover_sim.hbs_mtce.controllers[controller]);
+
+    info->number_of_node_reachable = reachable;
+    info->sm_heartbeat_fail = stalled;
+
+    if(( _sm_failover_sim.scenario->hbs_subscribed )&&
+       ( _sm_failover_sim.hbs_responding ))
+    {
+        sm_failover_sim_hbs_receive();
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - File
+// ==========================
+// Flag files SM shares with mtce and the rest of the node are kept in the
+// simulated world, everything under /var is treated as one of them.
+static SmFailoverSimFileT* sm_failover_sim_file( const char path[],
+    bool create )
+{
+    SmFailoverSimFileT* unused = NULL;
+
+    if( 0 != strncmp( path, "/var/", 5 ) )
+    {
+        return( NULL );
+    }
+
+    unsigned int file_i;
+    for( file_i=0; SM_FAILOVER_SIM_FILES_MAX > file_i; ++file_i )
+    {
+        SmFailoverSimFileT* file = &(_sm_failover_sim.files[file_i]);
+
+        if( 0 == strcmp( path, file->path ) )
+        {
+            return( file );
+        }
+
+        if(( NULL == unused )&&( '\0' == file->path[0] ))
+        {
+            unused = file;
+        }
+    }
+
+    if(( create )&&( NULL != unused ))
+    {
+        snprintf( unused->path, sizeof(unused->path), "%s", path );
+        return( unused );
+    }
+
+    return( NULL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - File Exists
+// =================================
+static bool sm_failover_sim_file_exists( SmFailoverSimFileT* file )
+{
+    int reset_peer_ms = _sm_failover_sim.scenario->reset_peer_ms;
+
+    if( !file->exists )
+    {
+        return( false );
+    }
+
+    // Mtce removes the reset request once it has reset the peer.
+    if(( 0 == strcmp( SM_FAILOVER_SIM_RESET_PEER_FILE, file->path ) )&&
+       ( SM_FAILOVER_SIM_NEVER != reset_peer_ms )&&
+       ( _sm_failover_sim.now_ms >= file->created_ms + reset_peer_ms ))
+    {
+        sm_failover_sim_trace( "mtce reset the peer" );
+        file->exists = false;
+        _sm_failover_sim.peer_state = SM_NODE_STATE_FAILED;
+        return( false );
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - File Set
+// ==============================
+static void sm_failover_sim_file_set( SmFailoverSimFileT* file, bool exists )
+{
+    if( exists == sm_failover_sim_file_exists( file ) )
+    {
+        return;
+    }
+
+    file->exists = exists;
+    file->created_ms = _sm_failover_sim.now_ms;
+
+    unsigned int action_i;
+    for( action_i=0; sizeof(_file_actions)/sizeof(_file_actions[0]) > action_i;
+         ++action_i )
+    {
+        const SmFailoverSimFileActionT* file_action = &(_file_actions[action_i]);
+        const char* action = exists ? file_action->create_action
+                                    : file_action->remove_action;
+
+        if(( 0 == strcmp( file_action->path, file->path ) )&&( NULL != action ))
+        {
+            sm_failover_sim_action( "%s", action );
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Wrapped libc
+// ==================================
+extern "C" int __wrap_clock_gettime( clockid_t clock_id, struct timespec* tp )
+{
+    int64_t ms = _sm_failover_sim.now_ms;
+
+    if( CLOCK_REALTIME == clock_id )
+    {
+        ms += SM_FAILOVER_SIM_REALTIME_BASE_MS;
+    } else {
+        ms += SM_FAILOVER_SIM_MONOTONIC_BASE_MS;
+    }
+
+    tp->tv_sec = ms / 1000;
+    tp->tv_nsec = (ms % 1000) * 1000000;
+    return( 0 );
+}
+
+extern "C" time_t __wrap_time( time_t* tloc )
+{
+    time_t now = (SM_FAILOVER_SIM_REALTIME_BASE_MS + _sm_failover_sim.now_ms)
+               / 1000;
+
+    if( NULL != tloc )
+    {
+        *tloc = now;
+    }
+    return( now );
+}
+
+extern "C" int __wrap_usleep( useconds_t usec )
+{
+    _sm_failover_sim.now_ms += usec / 1000;
+    return( 0 );
+}
+
+extern "C" unsigned int __wrap_sleep( unsigned int seconds )
+{
+    _sm_failover_sim.now_ms += seconds * 1000;
+    return( 0 );
+}
+
+extern "C" int __wrap_open( const char* path, int flags, ... )
+{
+    va_list arguments;
+    mode_t mode = 0;
+
+    if( O_CREAT & flags )
+    {
+        va_start( arguments, flags );
+        mode = va_arg( arguments, int );
+        va_end( arguments );
+    }
+
+    SmFailoverSimFileT* file = sm_failover_sim_file( path, O_CREAT & flags );
+    if( NULL == file )
+    {
+        if( 0 == strncmp( path, "/var/", 5 ) )
+        {
+            errno = ENOENT;
+            return( -1 );
+        }
+        return( __real_open( path, flags, mode ) );
+    }
+
+    if( O_CREAT & flags )
+    {
+        sm_failover_sim_file_set( file, true );
+
+    } else if( !sm_failover_sim_file_exists( file ) ) {
+        errno = ENOENT;
+        return( -1 );
+    }
+
+    return( __real_open( "/dev/null", O_RDWR | O_CLOEXEC ) );
+}
+
+extern "C" FILE* __wrap_fopen( const char* path, const char* mode )
+{
+    if( 0 == strncmp( path, "/var/", 5 ) )
+    {
+        return( __real_fopen( "/dev/null", mode ) );
+    }
+    return( __real_fopen( path, mode ) );
+}
+
+extern "C" int __wrap_access( const char* path, int mode )
+{
+    SmFailoverSimFileT* file = sm_failover_sim_file( path, false );
+
+    if(( NULL == file )||( !sm_failover_sim_file_exists( file ) ))
+    {
+        errno = ENOENT;
+        return( -1 );
+    }
+    return( 0 );
+}
+
+extern "C" int __wrap_unlink( const char* path )
+{
+    SmFailoverSimFileT* file = sm_failover_sim_file( path, false );
+
+    if(( NULL == file )||( !sm_failover_sim_file_exists( file ) ))
+    {
+        errno = ENOENT;
+        return( -1 );
+    }
+
+    sm_failover_sim_file_set( file, false );
+    return( 0 );
+}
+
+extern "C" int __wrap_remove( const char* path )
+{
+    return( __wrap_unlink( path ) );
+}
+
+// The only fork in the failover sources is the pmon-restart of sm, which
+// ends the run.
+extern "C" pid_t __wrap_fork( void )
+{
+    sm_failover_sim_action( "restart-sm" );
+    sm_failover_sim_restart();
+    errno = EPERM;
+    return( -1 );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Timer Provider
+// ====================================
+SmErrorT _sm_timer_register( const char name[], unsigned int ms,
+    SmTimerCallbackT callback, int64_t user_data, SmTimerIdT* timer_id,
+    const char* func, const char* file, int line )
+{
+    unsigned int timer_i;
+    for( timer_i=0; SM_FAILOVER_SIM_TIMERS_MAX > timer_i; ++timer_i )
+    {
+        SmFailoverSimTimerT* timer = &(_sm_failover_sim.timers[timer_i]);
+
+        if( timer->inuse )
+        {
+            continue;
+        }
+
+        timer->inuse = true;
+        timer->id = _sm_failover_sim.next_timer_id++;
+        snprintf( timer->name, sizeof(timer->name), "%s", name );
+        timer->ms = ms;
+        timer->due_ms = _sm_failover_sim.now_ms + ms;
+        timer->callback = callback;
+        timer->user_data = user_data;
+
+        *timer_id = timer->id;
+        return( SM_OKAY );
+    }
+
+    printf( "Timer table full, timer (%s) from %s not registered.\n",
+            name, func );
+    *timer_id = SM_TIMER_ID_INVALID;
+    return( SM_FAILED );
+}
+
+SmErrorT _sm_timer_deregister( SmTimerIdT timer_id, const char* func,
+    const char* file, int line )
+{
+    SmFailoverSimTimerT* timer = sm_failover_sim_timer_find( timer_id );
+
+    if( NULL != timer )
+    {
+        timer->inuse = false;
+    }
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Selection Object Provider
+// ===============================================
+SmErrorT sm_selobj_register( int selobj, SmSelObjCallbackT callback,
+    int64_t user_data )
+{
+    _sm_failover_sim.selobj = selobj;
+    _sm_failover_sim.selobj_callback = callback;
+    _sm_failover_sim.selobj_user_data = user_data;
+    return( SM_OKAY );
+}
+
+SmErrorT sm_selobj_deregister( int selobj )
+{
+    if( selobj == _sm_failover_sim.selobj )
+    {
+        _sm_failover_sim.selobj = -1;
+        _sm_failover_sim.selobj_callback = NULL;
+    }
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Hardware Provider
+// =======================================
+SmErrorT sm_hw_initialize( SmHwCallbacksT* callbacks )
+{
+    _sm_failover_sim.interface_change = callbacks->interface_change;
+    return( SM_OKAY );
+}
+
+SmErrorT sm_hw_finalize( void )
+{
+    _sm_failover_sim.interface_change = NULL;
+    return( SM_OKAY );
+}
+
+SmErrorT sm_hw_get_if_state( const char if_name[], bool* enabled )
+{
+    int if_i;
+    for( if_i=0; SM_FAILOVER_SIM_INTERFACE_MAX > if_i; ++if_i )
+    {
+        if( 0 == strcmp( if_name, _interface_names[if_i] ) )
+        {
+            *enabled = _sm_failover_sim.link_enabled[if_i];
+            return( SM_OKAY );
+        }
+    }
+    return( SM_NOT_FOUND );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Database Provider
+// =======================================
+SmErrorT sm_db_connect( const char* sm_db_name, SmDbHandleT** sm_db_handle,
+    bool readonly )
+{
+    *sm_db_handle = (SmDbHandleT*) &_sm_failover_sim;
+    return( SM_OKAY );
+}
+
+SmErrorT sm_db_disconnect( SmDbHandleT* sm_db_handle )
+{
+    return( SM_OKAY );
+}
+
+SmErrorT sm_db_nodes_query( SmDbHandleT* sm_db_handle, const char* db_query,
+    SmDbNodeT* record )
+{
+    const char* node_name = NULL;
+
+    if( NULL != strstr( db_query, _sm_failover_sim.host_name ) )
+    {
+        node_name = _sm_failover_sim.host_name;
+    } else if( NULL != strstr( db_query, _sm_failover_sim.peer_name ) ) {
+        node_name = _sm_failover_sim.peer_name;
+    } else {
+        return( SM_NOT_FOUND );
+    }
+
+    memset( record, 0, sizeof(SmDbNodeT) );
+    snprintf( record->name, sizeof(record->name), "%s", node_name );
+    record->admin_state = SM_NODE_ADMIN_STATE_UNLOCKED;
+    record->oper_state = SM_NODE_OPERATIONAL_STATE_ENABLED;
+    record->avail_status = SM_NODE_AVAIL_STATUS_AVAILABLE;
+
+    if( node_name == _sm_failover_sim.peer_name )
+    {
+        record->oper_state = _sm_failover_sim.peer_oper_state;
+    }
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Configuration Provider
+// ============================================
+SmErrorT sm_configuration_table_get( const char* key, char* buf,
+    unsigned int buf_size )
+{
+    const SmFailoverSimScenarioT* scenario = _sm_failover_sim.scenario;
+
+    if( NULL == scenario )
+    {
+        return( SM_NOT_FOUND );
+    }
+
+    unsigned int config_i;
+    for( config_i=0; scenario->num_config > config_i; ++config_i )
+    {
+        if( 0 == strcmp( key, scenario->config[config_i].key ) )
+        {
+            snprintf( buf, buf_size, "%s", scenario->config[config_i].value );
+            return( SM_OKAY );
+        }
+    }
+    return( SM_NOT_FOUND );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Node Utilities Provider
+// =============================================
+SmErrorT sm_node_utils_get_hostname( char node_name[] )
+{
+    snprintf( node_name, SM_NODE_NAME_MAX_CHAR, "%s",
+              _sm_failover_sim.host_name );
+    return( SM_OKAY );
+}
+
+SmSystemModeT sm_node_utils_get_system_mode( void )
+{
+    if( NULL == _sm_failover_sim.scenario )
+    {
+        return( SM_SYSTEM_MODE_UNKNOWN );
+    }
+    return( _sm_failover_sim.scenario->system_mode );
+}
+
+SmErrorT sm_node_utils_is_aio_duplex( bool* is_aio_duplex )
+{
+    SmSystemModeT system_mode = sm_node_utils_get_system_mode();
+
+    *is_aio_duplex = ( SM_SYSTEM_MODE_CPE_DUPLEX == system_mode )||
+                     ( SM_SYSTEM_MODE_CPE_DUPLEX_DC == system_mode );
+    return( SM_OKAY );
+}
+
+static SmErrorT sm_failover_sim_get_interface( SmFailoverSimInterfaceT interface,
+    char interface_name[] )
+{
+    if(( NULL == _sm_failover_sim.scenario )||
+       ( !_sm_failover_sim.scenario->interfaces[interface] ))
+    {
+        return( SM_NOT_FOUND );
+    }
+
+    snprintf( interface_name, SM_INTERFACE_NAME_MAX_CHAR, "%s",
+              _interface_names[interface] );
+    return( SM_OKAY );
+}
+
+SmErrorT sm_node_utils_get_oam_interface( char interface_name[] )
+{
+    return( sm_failover_sim_get_interface( SM_FAILOVER_SIM_INTERFACE_OAM,
+                                           interface_name ) );
+}
+
+SmErrorT sm_node_utils_get_mgmt_interface( char interface_name[] )
+{
+    return( sm_failover_sim_get_interface( SM_FAILOVER_SIM_INTERFACE_MGMT,
+                                           interface_name ) );
+}
+
+SmErrorT sm_node_utils_get_cluster_host_interface( char interface_name[] )
+{
+    return( sm_failover_sim_get_interface(
+                SM_FAILOVER_SIM_INTERFACE_CLUSTER_HOST, interface_name ) );
+}
+
+SmErrorT sm_node_utils_get_admin_interface( char interface_name[] )
+{
+    return( sm_failover_sim_get_interface( SM_FAILOVER_SIM_INTERFACE_ADMIN,
+                                           interface_name ) );
+}
+
+SmErrorT sm_node_utils_set_unhealthy( void )
+{
+    if( !_sm_failover_sim.unhealthy )
+    {
+        _sm_failover_sim.unhealthy = true;
+        sm_failover_sim_action( "unhealthy-set" );
+    }
+    return( SM_OKAY );
+}
+
+void sm_node_utils_reset_unhealthy_flag( void )
+{
+    if( _sm_failover_sim.unhealthy )
+    {
+        _sm_failover_sim.unhealthy = false;
+        sm_failover_sim_action( "unhealthy-clear" );
+    }
+}
+
+SmErrorT sm_utils_indicate_degraded( void )
+{
+    if( !_sm_failover_sim.degraded )
+    {
+        _sm_failover_sim.degraded = true;
+        sm_failover_sim_action( "degraded-set" );
+    }
+    return( SM_OKAY );
+}
+
+SmErrorT sm_utils_clear_degraded( void )
+{
+    if( _sm_failover_sim.degraded )
+    {
+        _sm_failover_sim.degraded = false;
+        sm_failover_sim_action( "degraded-clear" );
+    }
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Node Provider
+// ===================================
+SmErrorT sm_node_api_get_hostname( char node_name[] )
+{
+    return( sm_node_utils_get_hostname( node_name ) );
+}
+
+SmErrorT sm_node_api_get_peername( char peer_name[SM_NODE_NAME_MAX_CHAR] )
+{
+    snprintf( peer_name, SM_NODE_NAME_MAX_CHAR, "%s",
+              _sm_failover_sim.peer_name );
+    return( SM_OKAY );
+}
+
+SmErrorT sm_node_api_swact( char node_name[], bool force )
+{
+    sm_failover_sim_action( "swact" );
+    _sm_failover_sim.host_state = SM_NODE_STATE_STANDBY;
+    _sm_failover_sim.peer_state = SM_NODE_STATE_ACTIVE;
+    return( SM_OKAY );
+}
+
+SmErrorT sm_node_api_fail_node( char node_name[] )
+{
+    sm_failover_sim_action( "node-fail:%s", sm_failover_sim_role( node_name ) );
+    return( SM_OKAY );
+}
+
+SmErrorT sm_node_api_recover_node( char node_name[] )
+{
+    sm_failover_sim_action( "node-recover:%s",
+                            sm_failover_sim_role( node_name ) );
+    return( SM_OKAY );
+}
+
+SmErrorT sm_node_api_delete_node( char node_name[] )
+{
+    sm_failover_sim_action( "node-delete:%s",
+                            sm_failover_sim_role( node_name ) );
+    return( SM_OKAY );
+}
+
+SmErrorT sm_node_fsm_event_handler( char node_name[], SmNodeEventT event,
+    void* event_data[], const char reason_text[] )
+{
+    if( SM_NODE_EVENT_DISABLED != event )
+    {
+        sm_failover_sim_trace( "node %s event %i", node_name, event );
+        return( SM_OKAY );
+    }
+
+    sm_failover_sim_action( "node-disable:%s",
+                            sm_failover_sim_role( node_name ) );
+
+    if( 0 == strcmp( node_name, _sm_failover_sim.peer_name ) )
+    {
+        _sm_failover_sim.peer_state = SM_NODE_STATE_FAILED;
+    } else {
+        _sm_failover_sim.host_state = SM_NODE_STATE_FAILED;
+    }
+    return( SM_OKAY );
+}
+
+void SmNodeSwactMonitor::SwactStart( SmNodeScheduleStateT my_role )
+{
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Service Domain Provider
+// =============================================
+// A single controller domain with a single controller aggregate member,
+// the assignment of a node follows its schedule state in the world.
+static SmServiceDomainT _domain;
+static SmServiceDomainMemberT _member;
+static SmServiceDomainAssignmentT _assignment;
+
+static SmServiceDomainT* sm_failover_sim_domain( void )
+{
+    memset( &_domain, 0, sizeof(_domain) );
+    snprintf( _domain.name, sizeof(_domain.name), "%s", SM_FAILOVER_SIM_DOMAIN );
+    snprintf( _domain.leader, sizeof(_domain.leader), "%s",
+              _sm_failover_sim.leader );
+    return( &_domain );
+}
+
+SmServiceDomainT* sm_service_domain_table_read( char name[] )
+{
+    if( 0 != strcmp( name, SM_FAILOVER_SIM_DOMAIN ) )
+    {
+        return( NULL );
+    }
+    return( sm_failover_sim_domain() );
+}
+
+void sm_service_domain_table_foreach( void* user_data[],
+    SmServiceDomainTableForEachCallbackT callback )
+{
+    callback( user_data, sm_failover_sim_domain() );
+}
+
+void sm_service_domain_member_table_foreach( char service_domain_name[],
+    void* user_data[], SmServiceDomainMemberTableForEachCallbackT callback )
+{
+    memset( &_member, 0, sizeof(_member) );
+    snprintf( _member.name, sizeof(_member.name), "%s", SM_FAILOVER_SIM_DOMAIN );
+    snprintf( _member.service_group_name, sizeof(_member.service_group_name),
+              "controller-services" );
+    snprintf( _member.service_group_aggregate,
+              sizeof(_member.service_group_aggregate), "controller-aggregate" );
+    callback( user_data, &_member );
+}
+
+SmServiceDomainAssignmentT* sm_service_domain_assignment_table_read(
+    char name[], char node_name[], char service_group_name[] )
+{
+    SmNodeScheduleStateT state;
+
+    if( 0 == strcmp( node_name, _sm_failover_sim.host_name ) )
+    {
+        state = _sm_failover_sim.host_state;
+    } else if( 0 == strcmp( node_name, _sm_failover_sim.peer_name ) ) {
+        state = _sm_failover_sim.peer_state;
+    } else {
+        return( NULL );
+    }
+
+    memset( &_assignment, 0, sizeof(_assignment) );
+    snprintf( _assignment.name, sizeof(_assignment.name), "%s", name );
+    snprintf( _assignment.node_name, sizeof(_assignment.node_name), "%s",
+              node_name );
+    snprintf( _assignment.service_group_name,
+              sizeof(_assignment.service_group_name), "%s",
+              service_group_name );
+
+    switch( state )
+    {
+        case SM_NODE_STATE_ACTIVE:
+            _assignment.desired_state = SM_SERVICE_GROUP_STATE_ACTIVE;
+        break;
+        case SM_NODE_STATE_STANDBY:
+            _assignment.desired_state = SM_SERVICE_GROUP_STATE_STANDBY;
+        break;
+        case SM_NODE_STATE_FAILED:
+            _assignment.desired_state = SM_SERVICE_GROUP_STATE_DISABLED;
+        break;
+        case SM_NODE_STATE_INIT:
+            _assignment.desired_state = SM_SERVICE_GROUP_STATE_INITIAL;
+        break;
+        default:
+            return( NULL );
+    }
+
+    _assignment.state = _assignment.desired_state;
+    return( &_assignment );
+}
+
+SmServiceDomainInterfaceT* sm_service_domain_interface_table_read(
+    char service_domain_name[], char service_domain_interface_name[] )
+{
+    unsigned int if_i;
+    for( if_i=0; _sm_failover_sim.num_interfaces > if_i; ++if_i )
+    {
+        SmServiceDomainInterfaceT* interface = &(_sm_failover_sim.interfaces[if_i]);
+
+        if(( 0 == strcmp( service_domain_name, interface->service_domain ) )&&
+           ( 0 == strcmp( service_domain_interface_name,
+                          interface->service_domain_interface ) ))
+        {
+            return( interface );
+        }
+    }
+    return( NULL );
+}
+
+void sm_service_domain_interface_table_foreach( void* user_data[],
+    SmServiceDomainInterfaceTableForEachCallbackT callback )
+{
+    unsigned int if_i;
+    for( if_i=0; _sm_failover_sim.num_interfaces > if_i; ++if_i )
+    {
+        callback( user_data, &(_sm_failover_sim.interfaces[if_i]) );
+    }
+}
+
+SmErrorT sm_service_domain_fsm_event_handler( char name[],
+    SmServiceDomainEventT event, void* event_data[], const char reason_text[] )
+{
+    if( SM_SERVICE_DOMAIN_EVENT_CHANGING_LEADER == event )
+    {
+        sm_failover_sim_action( "leader" );
+        snprintf( _sm_failover_sim.leader, sizeof(_sm_failover_sim.leader),
+                  "%s", _sm_failover_sim.host_name );
+    } else {
+        sm_failover_sim_trace( "domain %s event %i", name, event );
+    }
+    return( SM_OKAY );
+}
+
+SmErrorT sm_service_domain_neighbor_fsm_event_handler( char neighbor_name[],
+    char service_domain[], SmServiceDomainNeighborEventT event,
+    void* event_data[], const char reason_text[] )
+{
+    if( SM_SERVICE_DOMAIN_NEIGHBOR_EVENT_DOWN == event )
+    {
+        sm_failover_sim_action( "neighbor-down" );
+    } else {
+        sm_failover_sim_trace( "neighbor %s event %i", neighbor_name, event );
+    }
+    return( SM_OKAY );
+}
+
+SmErrorT sm_service_domain_utils_service_domain_active_self( char name[] )
+{
+    sm_failover_sim_action( "domain-active" );
+    _sm_failover_sim.host_state = SM_NODE_STATE_ACTIVE;
+    return( SM_OKAY );
+}
+
+SmErrorT sm_service_domain_utils_service_domain_disable_self( char name[] )
+{
+    sm_failover_sim_action( "domain-disable" );
+    _sm_failover_sim.host_state = SM_NODE_STATE_FAILED;
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Log Provider
+// ==================================
+// Every failover decision is logged before it is carried out, which makes
+// this the point the decision is taken from.
+void sm_log_node_failover( char entity_name[], const char prev_state[],
+    const char state[], const char reason_text[] )
+{
+    SmFailoverSimWorldT* sim = &_sm_failover_sim;
+    SmSystemFailoverStatus& status = SmSystemFailoverStatus::get_status();
+
+    if( 0 == sim->num_decisions++ )
+    {
+        sim->decision_ms = sim->now_ms;
+        sim->decision_host_state = status.get_host_schedule_state();
+        sim->decision_peer_state = status.get_peer_schedule_state();
+    }
+
+    sm_failover_sim_trace( "decision host %s => %s, %s", prev_state, state,
+                           reason_text );
+}
+
+void sm_debug_flight_recorder_save( const char filename[] )
+{
+    sm_failover_sim_trace( "flight recorder saved" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Cluster Heartbeat Provider
+// ================================================
+const SmClusterHbsStateT& SmClusterHbsInfoMsg::get_current_state()
+{
+    return( _sm_failover_sim.hbs_current );
+}
+
+const SmClusterHbsStateT& SmClusterHbsInfoMsg::get_previous_state()
+{
+    return( _sm_failover_sim.hbs_previous );
+}
+
+bool SmClusterHbsInfoMsg::cluster_hbs_info_query(
+    cluster_hbs_query_ready_callback callback )
+{
+    SmTimerIdT timer_id;
+
+    ++_sm_failover_sim.hbs_queries;
+    sm_failover_sim_trace( "hbs query" );
+
+    if( SM_FAILOVER_SIM_NEVER == _sm_failover_sim.scenario->hbs_delay_ms )
+    {
+        return( true );
+    }
+
+    sm_timer_register( "hbs query reply", _sm_failover_sim.scenario->hbs_delay_ms,
+                       sm_failover_sim_hbs_reply, (int64_t) (intptr_t) callback,
+                       &timer_id );
+    return( true );
+}
+
+bool SmClusterHbsInfoMsg::is_subscribed()
+{
+    return( _sm_failover_sim.scenario->hbs_subscribed );
+}
+
+int SmClusterHbsInfoMsg::get_this_controller_index()
+{
+    return( 0 );
+}
+
+int SmClusterHbsInfoMsg::get_peer_controller_index()
+{
+    return( 1 );
+}
+
+bool operator==( const SmClusterHbsStateT& lhs, const SmClusterHbsStateT& rhs )
+{
+    if( lhs.storage0_enabled != rhs.storage0_enabled )
+    {
+        return( false );
+    }
+
+    unsigned int controller_i;
+    for( controller_i=0; max_controllers > controller_i; ++controller_i )
+    {
+        const SmClusterHbsInfoT& lhs_info = lhs.controllers[controller_i];
+        const SmClusterHbsInfoT& rhs_info = rhs.controllers[controller_i];
+
+        if(( lhs_info.storage0_responding != rhs_info.storage0_responding )||
+           ( lhs_info.sm_heartbeat_fail != rhs_info.sm_heartbeat_fail )||
+           ( lhs_info.number_of_node_reachable
+             != rhs_info.number_of_node_reachable ))
+        {
+            return( false );
+        }
+    }
+    return( true );
+}
+
+bool operator!=( const SmClusterHbsStateT& lhs, const SmClusterHbsStateT& rhs )
+{
+    return( !( lhs == rhs ) );
+}
+
+void log_cluster_hbs_state( const SmClusterHbsStateT& state )
+{
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Failover Simulation - Worker Provider
+// =====================================
+// Actions queued to the worker thread are recorded, not run, they talk to
+// mtce.
+SmWorkerThread SmWorkerThread::_the_worker;
+
+SmWorkerThread::SmWorkerThread()
+{
+}
+
+SmWorkerThread::~SmWorkerThread()
+{
+}
+
+SmWorkerThread& SmWorkerThread::get_worker()
+{
+    return( _the_worker );
+}
+
+void SmWorkerThread::add_action( SmAction* action )
+{
+    sm_failover_sim_action( "%s", action->get_name() );
+}
+
+void SmWorkerThread::add_priority_action( SmAction* action )
+{
+    sm_failover_sim_action( "%s", action->get_name() );
+}
+
+SmSimpleAction::SmSimpleAction( const char* action_name,
+    SmSimpleActionCallback callback )
+{
+    _callback = callback;
+    snprintf( _action_name, sizeof(_action_name), "%s", action_name );
+}
+
+SmSimpleAction::~SmSimpleAction()
+{
+}
+
+void SmSimpleAction::action()
+{
+}
+
+const char* SmSimpleAction::get_name() const
+{
+    return( _action_name );
+}
+// ****************************************************************************
@@ -27,6 +27,9 @@
 //
 SmErrorT _get_survivor_dc(const SmSystemStatusT& system_status, SmSystemFailoverStatus& selection);
 
+static char _last_decision[512] = "";
+static unsigned int _decision_count = 0;
+
 // select standby as failed
 SmErrorT _fail_standby(const SmSystemStatusT& system_status, SmSystemFailoverStatus& selection)
 {
@@ -290,8 +293,55 @@ SmErrorT _get_system_status(SmSystemStatusT& sys_status, char host_name[], char
     sys_status.peer_status.node_name = peer_name;
     sys_status.peer_status.node_info_flags = sm_failover_get_peer_node_info_flags();
     sys_status.peer_status.current_schedule_state = sm_get_controller_state(peer_name);
+
+    sys_status.this_controller_index = SmClusterHbsInfoMsg::get_this_controller_index();
+    sys_status.peer_controller_index = SmClusterHbsInfoMsg::get_peer_controller_index();
     return SM_OKAY;
 }
+
+// ****************************************************************************
+// _format_decision - one line record of all inputs and the result of a
+// survivor selection, so that a field decision can be replayed offline
+// ===================
+static void _format_decision(const SmSystemStatusT& system_status,
+    const SmSystemFailoverStatus& selection, char buf[], unsigned int len)
+{
+    const SmClusterHbsStateT& pre = selection.get_pre_failure_cluster_hbs_state();
+    const SmClusterHbsStateT& cur = selection.get_cluster_hbs_state();
+
+    snprintf(buf, len, "mode=%s hb=%d "
+        "host=%s,%s,flags=%#x,if=%d/%d/%d/%d "
+        "peer=%s,%s,flags=%#x "
+        "idx=%d/%d pre_hbs=%s cur_hbs=%s(v%u) storage0=%d "
+        "reach=%d/%d stall=%d/%d "
+        "=> host=%s peer=%s",
+        sm_system_mode_str(system_status.system_mode),
+        system_status.heartbeat_state,
+        system_status.host_status.node_name,
+        sm_node_schedule_state_str(system_status.host_status.current_schedule_state),
+        system_status.host_status.node_info_flags,
+        system_status.host_status.mgmt_state,
+        system_status.host_status.cluster_host_state,
+        system_status.host_status.oam_state,
+        system_status.host_status.admin_state,
+        system_status.peer_status.node_name,
+        sm_node_schedule_state_str(system_status.peer_status.current_schedule_state),
+        system_status.peer_status.node_info_flags,
+        system_status.this_controller_index,
+        system_status.peer_controller_index,
+        is_valid(pre) ? "yes" : "no",
+        is_valid(cur) ? "yes" : "no",
+        cur.version,
+        cur.storage0_enabled,
+        cur.controllers[0].number_of_node_reachable,
+        cur.controllers[1].number_of_node_reachable,
+        cur.controllers[0].sm_heartbeat_fail,
+        cur.controllers[1].sm_heartbeat_fail,
+        sm_node_schedule_state_str(selection.get_host_schedule_state()),
+        sm_node_schedule_state_str(selection.get_peer_schedule_state()));
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // sm_failover_ss_get_survivor - select the failover survivor
 // This is the main entry/container for the failover logic to determine how
@@ -394,8 +444,8 @@ SmErrorT sm_failover_ss_get_survivor(const SmSystemStatusT& system_status, SmSys
         if(has_cluser_info && max_nodes_available > 1)
         {
             DPRINTFD("storage-0 is %s", expect_storage_0 ? "enabled":"not enabled");
-            int this_controller_index = SmClusterHbsInfoMsg::get_this_controller_index();
-            int peer_controller_index = SmClusterHbsInfoMsg::get_peer_controller_index();
+            int this_controller_index = system_status.this_controller_index;
+            int peer_controller_index = system_status.peer_controller_index;
 
             bool survivor_selected = false;
             selection.set_peer_stall(false);
@@ -509,7 +559,11 @@ SmErrorT sm_failover_ss_get_survivor(const SmSystemStatusT& system_status, SmSys
 
     if(SM_SYSTEM_MODE_CPE_DUPLEX_DC == system_status.system_mode)
     {
-        return _get_survivor_dc(system_status, selection);
+        SmErrorT error = _get_survivor_dc(system_status, selection);
+        _format_decision(system_status, selection, _last_decision, sizeof(_last_decision));
+        ++_decision_count;
+        DPRINTFI("Failover decision: %s", _last_decision);
+        return error;
     }
 
     SmNodeScheduleStateT host_schedule_state, peer_schedule_state;
@@ -535,6 +589,10 @@ SmErrorT sm_failover_ss_get_survivor(const SmSystemStatusT& system_status, SmSys
         );
     }
 
+    _format_decision(system_status, selection, _last_decision, sizeof(_last_decision));
+    ++_decision_count;
+    DPRINTFI("Failover decision: %s", _last_decision);
+
     selection.serialize();
     return SM_OKAY;
 }
@@ -576,3 +634,16 @@ SmErrorT _get_survivor_dc(const SmSystemStatusT& system_status, SmSystemFailover
     }
     return SM_OKAY;
 }
+
+// ****************************************************************************
+// sm_failover_ss_dump_state - dump the last survivor selection
+// ===================
+void sm_failover_ss_dump_state(FILE* fp)
+{
+    fprintf(fp, "   Survivor selections:   %u\n", _decision_count);
+    if('\0' != _last_decision[0])
+    {
+        fprintf(fp, "   Last selection:   %s\n", _last_decision);
+    }
+}
+// ****************************************************************************
@@ -40,6 +40,9 @@ typedef struct
     SmNodeStatusT peer_status;
     SmHeartbeatStateT heartbeat_state;
     SmSystemModeT system_mode;
+    // index of host and peer in the cluster hbs controllers array
+    int this_controller_index;
+    int peer_controller_index;
 }SmSystemStatusT;
 
 
@@ -117,4 +120,10 @@ SmErrorT sm_failover_ss_get_survivor(SmSystemFailoverStatus& selection);
 
 SmErrorT sm_failover_ss_get_survivor(const SmSystemStatusT& system_status, SmSystemFailoverStatus& selection);
 
+// ****************************************************************************
+// sm_failover_ss_dump_state - dump the inputs and result of the last
+// survivor selection
+// ===================
+void sm_failover_ss_dump_state(FILE* fp);
+
 #endif // __SM_FAILOVER_SS_H__
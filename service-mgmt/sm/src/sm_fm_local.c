@@ -0,0 +1,288 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Local stand-in for the FM library, built with SM_FM_LOCAL so that SM
+// can raise and clear alarms on a system without FM.  Alarms are kept in
+// memory only.  Setting SM_FM_LOCAL_FAIL_EVERY=N in the environment fails
+// every Nth call with FM_ERR_NOCONNECT to exercise the retries, setting
+// SM_FM_LOCAL_DELAY_MS=N holds every call for N milliseconds the way an
+// unresponsive FM would.
+//
+#ifdef SM_FM_LOCAL
+
+#include <fmAPI.h>
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sm_debug.h"
+
+#define SM_FM_LOCAL_ALARMS_MAX                                          512
+
+typedef struct
+{
+    bool inuse;
+    SFmAlarmDataT fm_alarm_data;
+} SmFmLocalAlarmT;
+
+// Callers are serialized by the FM wrapper mutex.
+static SmFmLocalAlarmT _alarms[SM_FM_LOCAL_ALARMS_MAX];
+static unsigned int _uuid_next = 0;
+static unsigned int _calls = 0;
+
+// ****************************************************************************
+// FM Local - Fail
+// ===============
+static bool sm_fm_local_fail( void )
+{
+    const char* fail_every;
+    const char* delay;
+    long every;
+
+    ++_calls;
+
+    delay = getenv( "SM_FM_LOCAL_DELAY_MS" );
+    if( NULL != delay )
+    {
+        usleep( strtol( delay, NULL, 10 ) * 1000 );
+    }
+
+    fail_every = getenv( "SM_FM_LOCAL_FAIL_EVERY" );
+    if( NULL == fail_every )
+    {
+        return( false );
+    }
+
+    every = strtol( fail_every, NULL, 10 );
+
+    return(( 0 < every )&&( 0 == (_calls % every) ));
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// FM Local - Find
+// ===============
+static SmFmLocalAlarmT* sm_fm_local_find( const char alarm_id[],
+    const char entity_instance_id[] )
+{
+    unsigned int alarm_i;
+    for( alarm_i=0; SM_FM_LOCAL_ALARMS_MAX > alarm_i; ++alarm_i )
+    {
+        if(( _alarms[alarm_i].inuse )&&
+           ( 0 == strcmp( alarm_id, _alarms[alarm_i].fm_alarm_data.alarm_id ) )&&
+           ( 0 == strcmp( entity_instance_id,
+                     _alarms[alarm_i].fm_alarm_data.entity_instance_id ) ))
+        {
+            return( &(_alarms[alarm_i]) );
+        }
+    }
+
+    return( NULL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// FM Local - Set Fault
+// ====================
+EFmErrorT fm_set_fault( const SFmAlarmDataT* alarm, fm_uuid_t* uuid )
+{
+    SmFmLocalAlarmT* entry;
+
+    if( sm_fm_local_fail() )
+    {
+        return( FM_ERR_NOCONNECT );
+    }
+
+    snprintf( *uuid, sizeof(fm_uuid_t), "00000000-0000-0000-0000-%012u",
+              ++_uuid_next );
+
+    if( FM_ALARM_STATE_SET != alarm->alarm_state )
+    {
+        // Logs are not kept.
+        return( FM_ERR_OK );
+    }
+
+    entry = sm_fm_local_find( alarm->alarm_id, alarm->entity_instance_id );
+    if( NULL == entry )
+    {
+        unsigned int alarm_i;
+        for( alarm_i=0; SM_FM_LOCAL_ALARMS_MAX > alarm_i; ++alarm_i )
+        {
+            if( !_alarms[alarm_i].inuse )
+            {
+                entry = &(_alarms[alarm_i]);
+                break;
+            }
+        }
+
+        if( NULL == entry )
+        {
+            DPRINTFE( "FM local stand-in full." );
+            return( FM_ERR_NOCONNECT );
+        }
+    }
+
+    entry->inuse = true;
+    memcpy( &(entry->fm_alarm_data), alarm, sizeof(SFmAlarmDataT) );
+    snprintf( entry->fm_alarm_data.uuid, sizeof(entry->fm_alarm_data.uuid),
+              "%s", *uuid );
+
+    DPRINTFI( "FM local set alarm %s for %s.", alarm->alarm_id,
+              alarm->entity_instance_id );
+
+    return( FM_ERR_OK );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// FM Local - Clear Fault
+// ======================
+EFmErrorT fm_clear_fault( AlarmFilter* filter )
+{
+    SmFmLocalAlarmT* entry;
+
+    if( sm_fm_local_fail() )
+    {
+        return( FM_ERR_NOCONNECT );
+    }
+
+    entry = sm_fm_local_find( filter->alarm_id, filter->entity_instance_id );
+    if( NULL == entry )
+    {
+        return( FM_ERR_ENTITY_NOT_FOUND );
+    }
+
+    entry->inuse = false;
+
+    DPRINTFI( "FM local cleared alarm %s for %s.", filter->alarm_id,
+              filter->entity_instance_id );
+
+    return( FM_ERR_OK );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// FM Local - Clear All
+// ====================
+EFmErrorT fm_clear_all( fm_ent_inst_t* inst_id )
+{
+    size_t len = strlen( *inst_id );
+
+    if( sm_fm_local_fail() )
+    {
+        return( FM_ERR_NOCONNECT );
+    }
+
+    unsigned int alarm_i;
+    for( alarm_i=0; SM_FM_LOCAL_ALARMS_MAX > alarm_i; ++alarm_i )
+    {
+        if(( _alarms[alarm_i].inuse )&&
+           ( 0 == strncmp( *inst_id,
+                  _alarms[alarm_i].fm_alarm_data.entity_instance_id, len ) ))
+        {
+            _alarms[alarm_i].inuse = false;
+        }
+    }
+
+    return( FM_ERR_OK );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// FM Local - Get Fault
+// ====================
+EFmErrorT fm_get_fault( AlarmFilter* filter, SFmAlarmDataT* alarm )
+{
+    SmFmLocalAlarmT* entry;
+
+    if( sm_fm_local_fail() )
+    {
+        return( FM_ERR_NOCONNECT );
+    }
+
+    entry = sm_fm_local_find( filter->alarm_id, filter->entity_instance_id );
+    if( NULL == entry )
+    {
+        return( FM_ERR_ENTITY_NOT_FOUND );
+    }
+
+    memcpy( alarm, &(entry->fm_alarm_data), sizeof(SFmAlarmDataT) );
+
+    return( FM_ERR_OK );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// FM Local - Get Faults
+// =====================
+EFmErrorT fm_get_faults( fm_ent_inst_t* inst_id, SFmAlarmDataT* alarm,
+    unsigned int* max_alarms_to_get )
+{
+    size_t len = strlen( *inst_id );
+    unsigned int total = 0;
+
+    if( sm_fm_local_fail() )
+    {
+        return( FM_ERR_NOCONNECT );
+    }
+
+    unsigned int alarm_i;
+    for( alarm_i=0; SM_FM_LOCAL_ALARMS_MAX > alarm_i; ++alarm_i )
+    {
+        if( *max_alarms_to_get <= total )
+            break;
+
+        if(( _alarms[alarm_i].inuse )&&
+           ( 0 == strncmp( *inst_id,
+                  _alarms[alarm_i].fm_alarm_data.entity_instance_id, len ) ))
+        {
+            memcpy( &(alarm[total++]), &(_alarms[alarm_i].fm_alarm_data),
+                    sizeof(SFmAlarmDataT) );
+        }
+    }
+
+    *max_alarms_to_get = total;
+
+    return(( 0 == total ) ? FM_ERR_ENTITY_NOT_FOUND : FM_ERR_OK );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// FM Local - Get Faults By Id
+// ===========================
+EFmErrorT fm_get_faults_by_id( fm_alarm_id* alarm_id, SFmAlarmDataT* alarm,
+    unsigned int* max_alarms_to_get )
+{
+    unsigned int total = 0;
+
+    if( sm_fm_local_fail() )
+    {
+        return( FM_ERR_NOCONNECT );
+    }
+
+    unsigned int alarm_i;
+    for( alarm_i=0; SM_FM_LOCAL_ALARMS_MAX > alarm_i; ++alarm_i )
+    {
+        if( *max_alarms_to_get <= total )
+            break;
+
+        if(( _alarms[alarm_i].inuse )&&
+           ( 0 == strcmp( *alarm_id, _alarms[alarm_i].fm_alarm_data.alarm_id ) ))
+        {
+            memcpy( &(alarm[total++]), &(_alarms[alarm_i].fm_alarm_data),
+                    sizeof(SFmAlarmDataT) );
+        }
+    }
+
+    *max_alarms_to_get = total;
+
+    return(( 0 == total ) ? FM_ERR_ENTITY_NOT_FOUND : FM_ERR_OK );
+}
+// ****************************************************************************
+
+#endif // SM_FM_LOCAL
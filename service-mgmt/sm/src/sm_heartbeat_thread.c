@@ -37,6 +37,7 @@
 #include "sm_failover.h"
 #include "sm_cluster_hbs_info_msg.h"
 #include "sm_util_types.h"
+#include "sm_task_affinity.h"
 
 #define SM_HEARTBEAT_THREAD_NAME                                    "sm_heartbeat"
 #define SM_HEARTBEAT_THREAD_TICK_INTERVAL_IN_MS                                100
@@ -1280,6 +1281,13 @@ static void* sm_heartbeat_thread_main( void* arguments )
         pthread_exit( NULL );
     }
 
+    error = sm_task_affinity_pin_thread( SM_HEARTBEAT_THREAD_NAME );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to pin heartbeat thread, error=%s.",
+                  sm_error_str( error ) );
+    }
+
     DPRINTFI( "Starting" );
 
     // Warn after 400 milliseconds, fail after 3 seconds.
@@ -94,6 +94,36 @@ void sm_log_node_state_change( char entity_name[], const char prev_state[],
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Log - Node Failover
+// ===================
+void sm_log_node_failover( char entity_name[], const char prev_state[],
+    const char state[], const char reason_text[] )
+{
+    SmLogThreadMsgT msg;
+    SmLogThreadMsgStateChangeLogT* state_change = &(msg.u.state_change);
+
+    memset( &msg, 0, sizeof(msg) );
+
+    msg.type = SM_LOG_THREAD_MSG_NODE_FAILOVER_LOG;
+
+    clock_gettime( CLOCK_REALTIME, &(state_change->ts_real) );
+
+    snprintf( state_change->node_name, sizeof(state_change->node_name),
+              "%s", entity_name );
+    snprintf( state_change->entity_name, sizeof(state_change->entity_name),
+              "%s", entity_name );
+    snprintf( state_change->prev_state, sizeof(state_change->prev_state),
+              "%s", prev_state );
+    snprintf( state_change->state, sizeof(state_change->state),
+              "%s", state );
+    snprintf( state_change->reason_text, sizeof(state_change->reason_text),
+              "%s", reason_text );
+
+    send( _client_fd, &msg, sizeof(msg), 0 );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Log - Interface State Change
 // ============================
@@ -26,6 +26,13 @@ extern void sm_log_node_state_change( char entity_name[],
     const char prev_state[], const char state[], const char reason_text[] );
 // ****************************************************************************
 
+// ****************************************************************************
+// Log - Node Failover
+// ===================
+extern void sm_log_node_failover( char entity_name[],
+    const char prev_state[], const char state[], const char reason_text[] );
+// ****************************************************************************
+
 // ****************************************************************************
 // Log - Interface State Change
 // ============================
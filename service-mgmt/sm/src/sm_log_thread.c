@@ -31,13 +31,11 @@
 #include "sm_debug.h"
 #include "sm_trap.h"
 #include "sm_thread_health.h"
-
-#define SM_LOG_WRITE_BRIEF_LOGS
+#include "sm_journal.h"
 
 #define SM_LOG_THREAD_NAME                                          "sm_log"
 #define SM_LOG_THREAD_LOG_REPORT_TIMER_IN_MS                            5000
 #define SM_LOG_THREAD_TICK_INTERVAL_IN_MS                               5000
-#define SM_LOG_CUSTOMER_LOG_FILE                  "/var/log/sm-customer.log"
 
 #define SM_LOG_ENTRY_INUSE                                        0xFDFDFDFD
 
@@ -56,7 +54,6 @@ static bool _server_fd_registered = false;
 static SmListT* _logs = NULL;
 static SmLogEntryT _log_storage[SM_LOGS_MAX];
 static uint64_t _customer_log_id = 0;
-static FILE * _customer_log = NULL;
 
 // ****************************************************************************
 // Log Thread - Log String
@@ -234,32 +231,32 @@ static EFmAlarmTypeT sm_log_thread_get_fm_log_type( SmLogEventTypeT event_type )
 }
 // ****************************************************************************
 
-// ****************************************************************************
-// Log Thread - Log Brief Header
-// =============================
-static void sm_log_thread_log_brief_header( void )
-{
-    // Output the brief log header every so many logs.
-    if( 0 == ( _customer_log_id % 512 ) )
-    {
-        fprintf( _customer_log, "+-------------------------+------------+----------------------+----------------------------------+----------------------------------+----------------------------------+---------------------------------------------------------------------------\n" );
-        fprintf( _customer_log, "| timestamp               | log-id     | log-type             | entity-name                      | from-state                       | to-state                         | reason                                                                    \n" );
-        fprintf( _customer_log, "+-------------------------+------------+----------------------+----------------------------------+----------------------------------+----------------------------------+---------------------------------------------------------------------------\n" );
-    }
-}
-// ****************************************************************************
-
 // ****************************************************************************
 // Log Thread - Log Brief
 // ======================
-static void sm_log_thread_log_brief( const char time[], const char type[],
-    const char entity_name[], const char prev_state_change[], 
-    const char state_change[],
-    char reason_text[] )
+// Journals a row of the customer log, sm-journal displays it.
+static void sm_log_thread_log_brief( SmJournalEventT event_type,
+    const struct timespec* ts_real, const char type[],
+    const char entity_name[], const char prev_state_change[],
+    const char state_change[], const char reason_text[] )
 {
-    fprintf( _customer_log, "| %s | %10" PRIu64 " | %-20s | %-32s | "
-             "%-32s | %-32s | %-s \n", time, ++_customer_log_id, type,
-             entity_name, prev_state_change, state_change, reason_text );
+    const char* fields[SM_JOURNAL_LOG_FIELD_MAX];
+    SmErrorT error;
+
+    fields[SM_JOURNAL_LOG_FIELD_LOG_TYPE] = type;
+    fields[SM_JOURNAL_LOG_FIELD_ENTITY_NAME] = entity_name;
+    fields[SM_JOURNAL_LOG_FIELD_FROM_STATE] = prev_state_change;
+    fields[SM_JOURNAL_LOG_FIELD_TO_STATE] = state_change;
+    fields[SM_JOURNAL_LOG_FIELD_REASON] = reason_text;
+
+    error = sm_journal_append( event_type, ++_customer_log_id, ts_real,
+                               SM_JOURNAL_LOG_FIELD_ENTITY_NAME,
+                               SM_JOURNAL_LOG_FIELD_MAX, fields );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to journal %s log for %s, error=%s.", type,
+                  entity_name, sm_error_str( error ) );
+    }
 }
 // ****************************************************************************
 
@@ -269,33 +266,9 @@ static void sm_log_thread_log_brief( const char time[], const char type[],
 static void sm_log_thread_log_reboot( const char reboot_type[],
     SmLogThreadMsgRebootLogT* reboot )
 {
-    char time_str[80];
-    char date_str[32];
-    struct tm t_real;
-
-    if( NULL == localtime_r( &(reboot->ts_real.tv_sec), &t_real ) )
-    {
-        snprintf( time_str, sizeof(time_str), "YYYY:MM:DD HH:MM:SS.xxx" );
-    } else {
-        strftime( date_str, sizeof(date_str), "%FT%T", &t_real );
-        snprintf( time_str, sizeof(time_str), "%s.%03ld", date_str,
-                  reboot->ts_real.tv_nsec/1000000 );
-    }
-
-#ifdef SM_LOG_WRITE_BRIEF_LOGS
-    sm_log_thread_log_brief_header();
-
-    sm_log_thread_log_brief( time_str, reboot_type, reboot->entity_name,
-                             "", "", reboot->reason_text );
-#else
-    fprintf( _customer_log, "log-id:      %" PRIu64 "\n", ++_customer_log_id );
-    fprintf( _customer_log, "log-type:    reboot\n" );
-    fprintf( _customer_log, "timestamp:   %s\n", time_str );
-    fprintf( _customer_log, "entity-name: %s\n", reboot->entity_name );
-    fprintf( _customer_log, "reason-text: %s\n\n", reboot->reason_text );
-#endif // SM_LOG_WRITE_BRIEF_LOGS
-
-    fflush( _customer_log );
+    sm_log_thread_log_brief( SM_JOURNAL_EVENT_REBOOT, &(reboot->ts_real),
+                             reboot_type, reboot->entity_name, "", "",
+                             reboot->reason_text );
 }
 // ****************************************************************************
 
@@ -305,20 +278,8 @@ static void sm_log_thread_log_reboot( const char reboot_type[],
 static void sm_log_thread_log_state_change( const char state_change_type[],
     SmLogThreadMsgStateChangeLogT* state_change )
 {
-    char time_str[80];
     char prev_state_change_str[80];
     char state_change_str[80];
-    char date_str[32];
-    struct tm t_real;
-
-    if( NULL == localtime_r( &(state_change->ts_real.tv_sec), &t_real ) )
-    {
-        snprintf( time_str, sizeof(time_str), "YYYY:MM:DD HH:MM:SS.xxx" );
-    } else {
-        strftime( date_str, sizeof(date_str), "%FT%T", &t_real );
-        snprintf( time_str, sizeof(time_str), "%s.%03ld", date_str,
-                  state_change->ts_real.tv_nsec/1000000 );
-    }
 
     snprintf( prev_state_change_str, sizeof(prev_state_change_str), "%s%s%s",
               state_change->prev_state,
@@ -330,28 +291,25 @@ static void sm_log_thread_log_state_change( const char state_change_type[],
               ('\0' == state_change->status[0]) ? "" : "-",
               ('\0' == state_change->status[0]) ? "" : state_change->status );
 
-#ifdef SM_LOG_WRITE_BRIEF_LOGS
-    sm_log_thread_log_brief_header();
-
-    sm_log_thread_log_brief( time_str, state_change_type,
+    sm_log_thread_log_brief( SM_JOURNAL_EVENT_STATE_CHANGE,
+                             &(state_change->ts_real), state_change_type,
                              state_change->entity_name,
                              prev_state_change_str, state_change_str,
                              state_change->reason_text );
-#else
-    fprintf( _customer_log, "log-id:          %" PRIu64 "\n", ++_customer_log_id );
-    fprintf( _customer_log, "log-type:        state-change\n" );
-    fprintf( _customer_log, "timestamp:       %s\n", time_str );
-    fprintf( _customer_log, "entity-name:     %s\n", state_change->entity_name );
-    fprintf( _customer_log, "previous-state:  %s\n", state_change->prev_state );
-    fprintf( _customer_log, "previous-status: %s\n",
-             ('\0' == state_change->prev_status[0]) ? "" : state_change->prev_status );
-    fprintf( _customer_log, "current-state:   %s\n", state_change->state );
-    fprintf( _customer_log, "current-status:  %s\n",
-             ('\0' == state_change->status[0]) ? "" : state_change->status );
-    fprintf( _customer_log, "reason-text:     %s\n\n", state_change->reason_text );
-#endif // SM_LOG_WRITE_BRIEF_LOGS
-
-    fflush( _customer_log );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Log Thread - Log Failover
+// =========================
+static void sm_log_thread_log_failover( const char failover_type[],
+    SmLogThreadMsgStateChangeLogT* state_change )
+{
+    sm_log_thread_log_brief( SM_JOURNAL_EVENT_FAILOVER,
+                             &(state_change->ts_real), failover_type,
+                             state_change->entity_name,
+                             state_change->prev_state, state_change->state,
+                             state_change->reason_text );
 }
 // ****************************************************************************
 
@@ -552,6 +510,10 @@ static void sm_log_thread_dispatch( int selobj, int64_t user_data )
             }
         break;
 
+        case SM_LOG_THREAD_MSG_NODE_FAILOVER_LOG:
+            sm_log_thread_log_failover( "node-failover", state_change );
+        break;
+
         case SM_LOG_THREAD_MSG_INTERFACE_STATE_CHANGE_LOG:
             sm_log_thread_log_state_change( "interface-scn", state_change );
         break;
@@ -652,6 +614,7 @@ static bool sm_log_thread_report_timer( SmTimerIdT timer_id,
     int64_t user_data )
 {
     sm_log_thread_report();
+    sm_journal_flush();
     return( true );
 }
 // ****************************************************************************
@@ -705,22 +668,6 @@ static SmErrorT sm_log_thread_initialize_thread( void )
         return( SM_FAILED );
     }
 
-    if( NULL != _customer_log )
-    {
-        fflush( _customer_log );
-        fclose( _customer_log );
-        _customer_log = NULL;
-    }
-
-    _customer_log = fopen( SM_LOG_CUSTOMER_LOG_FILE, "a" );
-    if( NULL == _customer_log )
-    {
-        DPRINTFE( "Failed to open customer log file (%s).", 
-                  SM_LOG_CUSTOMER_LOG_FILE );
-        return( SM_FAILED );
-    }
-    chmod( SM_LOG_CUSTOMER_LOG_FILE, 0640);
-
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -770,12 +717,7 @@ static SmErrorT sm_log_thread_finalize_thread( void )
                   sm_error_str( error ) );
     }
 
-    if( NULL != _customer_log )
-    {
-        fflush( _customer_log );
-        fclose( _customer_log );
-        _customer_log = NULL;
-    }
+    sm_journal_flush();
 
     return( SM_OKAY );
 }
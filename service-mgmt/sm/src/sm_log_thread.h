@@ -21,6 +21,7 @@ typedef enum
     SM_LOG_THREAD_MSG_NODE_REBOOT_LOG,
     SM_LOG_THREAD_MSG_NODE_REBOOT_FORCE_LOG,
     SM_LOG_THREAD_MSG_NODE_STATE_CHANGE_LOG,
+    SM_LOG_THREAD_MSG_NODE_FAILOVER_LOG,
     SM_LOG_THREAD_MSG_LICENSE_CHANGE_LOG,
     SM_LOG_THREAD_MSG_COMMUNICATION_STATE_CHANGE_LOG,
     SM_LOG_THREAD_MSG_INTERFACE_STATE_CHANGE_LOG,
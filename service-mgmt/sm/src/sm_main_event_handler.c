@@ -14,7 +14,10 @@
 #include "sm_debug.h"
 #include "sm_timer.h"
 #include "sm_utils.h"
+#include "sm_node_utils.h"
 #include "sm_api.h"
+#include "sm_service_action_stats.h"
+#include "sm_swact_profiler.h"
 #include "sm_notify_api.h"
 #include "sm_db.h"
 #include "sm_db_foreach.h"
@@ -85,6 +88,19 @@ static bool sm_main_event_handler_audit_node( SmTimerIdT timer_id,
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Main Event Handler - Node Readiness
+// ===================================
+static void sm_main_event_handler_node_readiness( bool enabled,
+    const char reason_text[] )
+{
+    DPRINTFI( "Node readiness is now %s (%s), auditing node.",
+              enabled ? "enabled" : "disabled", reason_text );
+
+    sm_main_event_handler_audit_node( SM_TIMER_ID_INVALID, 0 );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Main Event Handler - Audit Interfaces
 // =====================================
@@ -240,6 +256,56 @@ static void sm_main_event_handler_api_service_restart_callback(
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Main Event Handler - API Action Stats Callback
+// ==============================================
+static void sm_main_event_handler_api_send_action_stats( void* user_data[],
+    SmServiceActionStatsT* stats )
+{
+    int seqno = *(int*) user_data[0];
+    unsigned int* count = (unsigned int*) user_data[1];
+
+    if( 0 == stats->count )
+    {
+        return;
+    }
+
+    if( SM_OKAY == sm_api_send_action_stats( stats, seqno ) )
+    {
+        ++(*count);
+    }
+}
+
+static void sm_main_event_handler_api_action_stats_callback(
+    char service_name[], int seqno )
+{
+    unsigned int count = 0;
+    void* user_data[] = {&seqno, &count};
+
+    DPRINTFD( "Action stats requested for service (%s), seqno=%i.",
+              service_name, seqno );
+
+    sm_service_action_stats_foreach( service_name, user_data,
+                                     sm_main_event_handler_api_send_action_stats );
+    sm_api_send_action_stats_end( count, seqno );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Main Event Handler - API Swact Blockers Callback
+// ================================================
+static void sm_main_event_handler_api_swact_blockers_callback( int seqno )
+{
+    SmSwactProfilerBlockerT blockers[10];
+    unsigned int num_blockers;
+
+    num_blockers = sm_swact_profiler_top_blockers( blockers,
+                        sizeof(blockers) / sizeof(SmSwactProfilerBlockerT) );
+
+    sm_api_send_swact_blockers( blockers, num_blockers, seqno );
+}
+// ****************************************************************************
+
 static void sm_main_event_handler_api_provision_service_callback(
     char service_group_name[], char service_name[], int seqno )
 {
@@ -406,6 +472,10 @@ SmErrorT sm_main_event_handler_initialize( void )
         = sm_main_event_handler_api_provision_service_domain_interface_callback;
     _api_callbacks.deprovision_service_domain_interface
         = sm_main_event_handler_api_deprovision_service_domain_interface_callback;
+    _api_callbacks.action_stats
+        = sm_main_event_handler_api_action_stats_callback;
+    _api_callbacks.swact_blockers
+        = sm_main_event_handler_api_swact_blockers_callback;
 
     error = sm_api_register_callbacks( &_api_callbacks );
     if( SM_OKAY != error )
@@ -442,6 +512,15 @@ SmErrorT sm_main_event_handler_initialize( void )
                   "error=%s.", sm_error_str( error ) );
         return( error );
     }
+
+    error = sm_node_utils_watch_initialize(
+                    sm_main_event_handler_node_readiness );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to watch node readiness, error=%s.",
+                  sm_error_str( error ) );
+        return( error );
+    }
     
     return( SM_OKAY );
 }
@@ -454,6 +533,13 @@ SmErrorT sm_main_event_handler_finalize( void )
 {
     SmErrorT error;
 
+    error = sm_node_utils_watch_finalize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to stop watching node readiness, error=%s.",
+                  sm_error_str( error ) );
+    }
+
     error = sm_service_group_api_deregister_callback(
                     sm_main_event_handler_service_group_state_callback );
     if( SM_OKAY != error )
@@ -783,6 +783,9 @@ static int sm_send_msg(SmServiceDomainInterfaceT* interface, SmMsgT* msg )
     result = sendto( interface->unicast_socket, msg, sizeof(SmMsgT),
                      0, (struct sockaddr *) &dst_addr4, sizeof(dst_addr4) );
 
+    DPRINTFD( "Sent message (%i) on interface (%s), result=%i.",
+              ntohs(msg->header.msg_type), interface->interface_name, result );
+
     return result;
 }
 
@@ -814,6 +817,9 @@ static int sm_send_ipv6_msg(SmServiceDomainInterfaceT* interface, SmMsgT* msg )
     result = sm_msg_sendmsg_src_ipv6( interface->unicast_socket, msg, sizeof(SmMsgT),
                                         0, &dst_addr6, &interface->network_address.u.ipv6.sin6 );
 
+    DPRINTFD( "Sent message (%i) on interface (%s), result=%i.",
+              ntohs(msg->header.msg_type), interface->interface_name, result );
+
     return result;
 }
 // ****************************************************************************
@@ -38,6 +38,7 @@
 #include "sm_log.h"
 #include "sm_troubleshoot.h"
 #include "sm_node_swact_monitor.h"
+#include "sm_failover.h"
 
 #define SM_REBOOT_DELAY_IN_MS           30000
 #define SM_REBOOT_TIMEOUT_IN_MINS       8
@@ -691,6 +692,8 @@ SmErrorT sm_node_api_update_node( char node_name[],
 
     if( send_update )
     {
+        sm_failover_signal( SM_FAILOVER_TRIGGER_NODE_STATE );
+
         error = sm_node_api_send_node_update( old_state_uuid, &node, true );
         if( SM_OKAY != error )
         {
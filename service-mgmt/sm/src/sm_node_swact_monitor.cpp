@@ -7,7 +7,9 @@
 #include "sm_debug.h"
 #include "sm_node_utils.h"
 #include "sm_swact_state.h"
+#include "sm_swact_profiler.h"
 #include "sm_service_enable.h"
+#include "sm_eru_services.h"
 
 bool SmNodeSwactMonitor::swact_started = false;
 static bool duplex = false;
@@ -26,6 +28,8 @@ void SmNodeSwactMonitor::SwactStart(SmNodeScheduleStateT my_role)
     }
     SmNodeSwactMonitor::swact_started = true;
     SmNodeSwactMonitor::my_role = my_role;
+    sm_swact_profiler_start(my_role);
+    sm_eru_services_set_transition(SM_ERU_SERVICES_TRANSITION_SWACT, true);
     DPRINTFI("Swact has started, host will be %s", sm_node_schedule_state_str(my_role));
 }
 
@@ -40,6 +44,16 @@ void SmNodeSwactMonitor::SwactUpdate(const char* hostname, SmNodeScheduleStateT
             SmNodeSwactMonitor::SwactCompleted(
                 SM_NODE_STATE_ACTIVE == SmNodeSwactMonitor::my_role );
         }
+        else if( SM_NODE_STATE_STANDBY == SmNodeSwactMonitor::my_role )
+        {
+            // The old active side is done once it has gone standby.
+            sm_swact_profiler_end( SM_NODE_STATE_STANDBY == node_state );
+            if( SM_NODE_STATE_STANDBY == node_state )
+            {
+                sm_eru_services_set_transition(
+                    SM_ERU_SERVICES_TRANSITION_SWACT, false );
+            }
+        }
 
     }
 }
@@ -55,4 +69,6 @@ void SmNodeSwactMonitor::SwactCompleted(bool result)
         sm_service_enable_throttle_add_cores(false);
     }
     DPRINTFI("Swact has %s.", result ? "completed successfully": "failed");
+    sm_swact_profiler_end(result);
+    sm_eru_services_set_transition(SM_ERU_SERVICES_TRANSITION_SWACT, false);
 }
@@ -0,0 +1,319 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "sm_pid_file_monitor.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/inotify.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_selobj.h"
+
+#define SM_PID_FILE_MONITOR_MAX                               512
+#define SM_PID_FILE_MONITOR_ENTRY_VALID                0xFDFDFDFD
+#define SM_PID_FILE_MONITOR_EVENTS \
+    ( IN_CLOSE_WRITE | IN_MOVED_TO )
+
+typedef struct
+{
+    uint32_t valid;
+    int wd;
+    char dir[SM_SERVICE_PID_FILE_MAX_CHAR];
+    char name[SM_SERVICE_PID_FILE_MAX_CHAR];
+    SmPidFileMonitorCallbackT callback;
+    int64_t user_data;
+} SmPidFileMonitorEntryT;
+
+static int _inotify_fd = -1;
+static SmPidFileMonitorEntryT _entries[SM_PID_FILE_MONITOR_MAX];
+
+// ****************************************************************************
+// Pid File Monitor - Split Path
+// =============================
+static bool sm_pid_file_monitor_split_path( const char pid_file[],
+    char dir[], char name[] )
+{
+    const char* slash = strrchr( pid_file, '/' );
+
+    if(( NULL == slash )||( '\0' == slash[1] ))
+    {
+        return( false );
+    }
+
+    if( slash == pid_file )
+    {
+        snprintf( dir, SM_SERVICE_PID_FILE_MAX_CHAR, "/" );
+    } else {
+        snprintf( dir, SM_SERVICE_PID_FILE_MAX_CHAR, "%.*s",
+                  (int) (slash - pid_file), pid_file );
+    }
+
+    snprintf( name, SM_SERVICE_PID_FILE_MAX_CHAR, "%s", slash+1 );
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pid File Monitor - Watch
+// ========================
+SmErrorT sm_pid_file_monitor_watch( const char pid_file[],
+    SmPidFileMonitorCallbackT callback, int64_t user_data )
+{
+    char dir[SM_SERVICE_PID_FILE_MAX_CHAR];
+    char name[SM_SERVICE_PID_FILE_MAX_CHAR];
+    SmPidFileMonitorEntryT* entry;
+    SmPidFileMonitorEntryT* free_entry = NULL;
+    int wd;
+
+    if( 0 > _inotify_fd )
+    {
+        return( SM_NOT_IMPLEMENTED );
+    }
+
+    if( !sm_pid_file_monitor_split_path( pid_file, dir, name ) )
+    {
+        DPRINTFE( "Invalid pid file (%s).", pid_file );
+        return( SM_FAILED );
+    }
+
+    unsigned int entry_i;
+    for( entry_i=0; SM_PID_FILE_MONITOR_MAX > entry_i; ++entry_i )
+    {
+        entry = &(_entries[entry_i]);
+
+        if( SM_PID_FILE_MONITOR_ENTRY_VALID != entry->valid )
+        {
+            if( NULL == free_entry )
+            {
+                free_entry = entry;
+            }
+            continue;
+        }
+
+        if(( user_data == entry->user_data )&&
+           ( 0 == strcmp( dir, entry->dir ) )&&
+           ( 0 == strcmp( name, entry->name ) ))
+        {
+            entry->callback = callback;
+            return( SM_OKAY );
+        }
+    }
+
+    if( NULL == free_entry )
+    {
+        DPRINTFE( "Failed to watch pid file (%s), no free entries.",
+                  pid_file );
+        return( SM_FAILED );
+    }
+
+    // The kernel returns the same watch descriptor for a directory that
+    // is already watched.
+    wd = inotify_add_watch( _inotify_fd, dir, SM_PID_FILE_MONITOR_EVENTS );
+    if( 0 > wd )
+    {
+        DPRINTFD( "Failed to watch directory (%s) of pid file (%s), "
+                  "error=%s.", dir, pid_file, strerror( errno ) );
+        return( SM_FAILED );
+    }
+
+    free_entry->valid = SM_PID_FILE_MONITOR_ENTRY_VALID;
+    free_entry->wd = wd;
+    snprintf( free_entry->dir, sizeof(free_entry->dir), "%s", dir );
+    snprintf( free_entry->name, sizeof(free_entry->name), "%s", name );
+    free_entry->callback = callback;
+    free_entry->user_data = user_data;
+
+    DPRINTFD( "Watching pid file (%s), wd=%i.", pid_file, wd );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pid File Monitor - Unwatch
+// ==========================
+SmErrorT sm_pid_file_monitor_unwatch( const char pid_file[],
+    int64_t user_data )
+{
+    char dir[SM_SERVICE_PID_FILE_MAX_CHAR];
+    char name[SM_SERVICE_PID_FILE_MAX_CHAR];
+    SmPidFileMonitorEntryT* entry;
+    int wd = -1;
+
+    if(( 0 > _inotify_fd )||
+       ( !sm_pid_file_monitor_split_path( pid_file, dir, name ) ))
+    {
+        return( SM_OKAY );
+    }
+
+    unsigned int entry_i;
+    for( entry_i=0; SM_PID_FILE_MONITOR_MAX > entry_i; ++entry_i )
+    {
+        entry = &(_entries[entry_i]);
+
+        if(( SM_PID_FILE_MONITOR_ENTRY_VALID == entry->valid )&&
+           ( user_data == entry->user_data )&&
+           ( 0 == strcmp( dir, entry->dir ) )&&
+           ( 0 == strcmp( name, entry->name ) ))
+        {
+            wd = entry->wd;
+            memset( entry, 0, sizeof(SmPidFileMonitorEntryT) );
+            break;
+        }
+    }
+
+    if( 0 > wd )
+    {
+        return( SM_OKAY );
+    }
+
+    for( entry_i=0; SM_PID_FILE_MONITOR_MAX > entry_i; ++entry_i )
+    {
+        entry = &(_entries[entry_i]);
+
+        if(( SM_PID_FILE_MONITOR_ENTRY_VALID == entry->valid )&&
+           ( wd == entry->wd ))
+        {
+            return( SM_OKAY );
+        }
+    }
+
+    inotify_rm_watch( _inotify_fd, wd );
+
+    DPRINTFD( "Stopped watching directory (%s).", dir );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pid File Monitor - Dispatch
+// ===========================
+static void sm_pid_file_monitor_dispatch( int selobj, int64_t user_data )
+{
+    char buf[4096]
+        __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    char pid_file[SM_SERVICE_PID_FILE_MAX_CHAR*2];
+    const struct inotify_event* event;
+    SmPidFileMonitorEntryT* entry;
+    ssize_t len;
+
+    for( ;; )
+    {
+        len = read( _inotify_fd, buf, sizeof(buf) );
+        if( 0 >= len )
+        {
+            if(( 0 > len )&&( EAGAIN != errno )&&( EINTR != errno ))
+            {
+                DPRINTFE( "Failed to read pid file events, error=%s.",
+                          strerror( errno ) );
+            }
+            break;
+        }
+
+        char* ptr;
+        for( ptr = buf; buf + len > ptr;
+             ptr += sizeof(struct inotify_event) + event->len )
+        {
+            event = (const struct inotify_event*) ptr;
+
+            if( event->mask & IN_Q_OVERFLOW )
+            {
+                DPRINTFI( "Pid file events overflowed, notifying all." );
+            } else if( 0 == event->len ) {
+                continue;
+            }
+
+            unsigned int entry_i;
+            for( entry_i=0; SM_PID_FILE_MONITOR_MAX > entry_i; ++entry_i )
+            {
+                entry = &(_entries[entry_i]);
+
+                if( SM_PID_FILE_MONITOR_ENTRY_VALID != entry->valid )
+                    continue;
+
+                if(( 0 == (event->mask & IN_Q_OVERFLOW) )&&
+                   (( event->wd != entry->wd )||
+                    ( 0 != strcmp( event->name, entry->name ) )))
+                    continue;
+
+                snprintf( pid_file, sizeof(pid_file), "%s/%s",
+                          ( 0 == strcmp( "/", entry->dir ) ) ? ""
+                          : entry->dir, entry->name );
+
+                DPRINTFD( "Pid file (%s) changed.", pid_file );
+
+                // The callback may unwatch, so the entry is not used after.
+                entry->callback( pid_file, entry->user_data );
+            }
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pid File Monitor - Initialize
+// =============================
+SmErrorT sm_pid_file_monitor_initialize( void )
+{
+    SmErrorT error;
+
+    memset( _entries, 0, sizeof(_entries) );
+
+    _inotify_fd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+    if( 0 > _inotify_fd )
+    {
+        DPRINTFE( "Failed to initialize inotify, error=%s, pid files will "
+                  "only be audited.", strerror( errno ) );
+        return( SM_OKAY );
+    }
+
+    error = sm_selobj_register( _inotify_fd, sm_pid_file_monitor_dispatch, 0 );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to register selection object, error=%s.",
+                  sm_error_str( error ) );
+        close( _inotify_fd );
+        _inotify_fd = -1;
+        return( error );
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pid File Monitor - Finalize
+// ===========================
+SmErrorT sm_pid_file_monitor_finalize( void )
+{
+    SmErrorT error;
+
+    if( 0 <= _inotify_fd )
+    {
+        error = sm_selobj_deregister( _inotify_fd );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to deregister selection object, error=%s.",
+                      sm_error_str( error ) );
+        }
+
+        close( _inotify_fd );
+        _inotify_fd = -1;
+    }
+
+    memset( _entries, 0, sizeof(_entries) );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
@@ -0,0 +1,52 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __SM_PID_FILE_MONITOR_H__
+#define __SM_PID_FILE_MONITOR_H__
+
+#include <stdint.h>
+
+#include "sm_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*SmPidFileMonitorCallbackT) (const char pid_file[],
+        int64_t user_data);
+
+// ****************************************************************************
+// Pid File Monitor - Watch
+// ========================
+// Calls back whenever the pid file is written or moved into place.  The
+// directory holding the pid file must exist.
+extern SmErrorT sm_pid_file_monitor_watch( const char pid_file[],
+    SmPidFileMonitorCallbackT callback, int64_t user_data );
+// ****************************************************************************
+
+// ****************************************************************************
+// Pid File Monitor - Unwatch
+// ==========================
+extern SmErrorT sm_pid_file_monitor_unwatch( const char pid_file[],
+    int64_t user_data );
+// ****************************************************************************
+
+// ****************************************************************************
+// Pid File Monitor - Initialize
+// =============================
+extern SmErrorT sm_pid_file_monitor_initialize( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Pid File Monitor - Finalize
+// ===========================
+extern SmErrorT sm_pid_file_monitor_finalize( void );
+// ****************************************************************************
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SM_PID_FILE_MONITOR_H__
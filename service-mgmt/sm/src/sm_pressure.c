@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "sm_pressure.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sm_types.h"
+#include "sm_debug.h"
+
+// ****************************************************************************
+// Pressure - Source String
+// ========================
+const char* sm_pressure_source_str( SmPressureSourceT source )
+{
+    switch( source )
+    {
+        case SM_PRESSURE_SOURCE_PSI:
+            return( "psi" );
+        break;
+
+        case SM_PRESSURE_SOURCE_LOADAVG:
+            return( "loadavg" );
+        break;
+
+        default:
+            return( "none" );
+        break;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pressure - Read Stall
+// =====================
+static bool sm_pressure_read_stall( const char stall_file[], float* avg10 )
+{
+    char line[256];
+    bool found = false;
+    FILE* fp;
+
+    fp = fopen( stall_file, "r" );
+    if( NULL == fp )
+    {
+        return( false );
+    }
+
+    while( NULL != fgets( line, sizeof(line), fp ) )
+    {
+        if( 1 == sscanf( line, "some avg10=%f", avg10 ) )
+        {
+            found = true;
+            break;
+        }
+    }
+
+    fclose( fp );
+
+    return( found );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pressure - Read Files
+// =====================
+SmErrorT sm_pressure_read_files( const char cpu_file[], const char io_file[],
+    const char loadavg_file[], SmPressureT* pressure )
+{
+    float load1;
+    long num_cpus;
+    FILE* fp;
+
+    memset( pressure, 0, sizeof(SmPressureT) );
+
+    if( sm_pressure_read_stall( cpu_file, &(pressure->cpu) ) )
+    {
+        if( !sm_pressure_read_stall( io_file, &(pressure->io) ) )
+        {
+            pressure->io = 0;
+        }
+
+        pressure->source = SM_PRESSURE_SOURCE_PSI;
+        return( SM_OKAY );
+    }
+
+    fp = fopen( loadavg_file, "r" );
+    if( NULL == fp )
+    {
+        return( SM_NOT_FOUND );
+    }
+
+    if( 1 != fscanf( fp, "%f", &load1 ) )
+    {
+        fclose( fp );
+        DPRINTFE( "Failed to parse %s.", loadavg_file );
+        return( SM_FAILED );
+    }
+
+    fclose( fp );
+
+    num_cpus = sysconf( _SC_NPROCESSORS_ONLN );
+    if( 0 >= num_cpus )
+    {
+        num_cpus = 1;
+    }
+
+    pressure->cpu = ( load1 / (float) num_cpus - 1.0f ) * 100.0f;
+    if( 0.0f > pressure->cpu )
+    {
+        pressure->cpu = 0.0f;
+    } else if( 100.0f < pressure->cpu ) {
+        pressure->cpu = 100.0f;
+    }
+
+    pressure->source = SM_PRESSURE_SOURCE_LOADAVG;
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pressure - Read
+// ===============
+SmErrorT sm_pressure_read( SmPressureT* pressure )
+{
+    return( sm_pressure_read_files( SM_PRESSURE_CPU_FILE, SM_PRESSURE_IO_FILE,
+                                    SM_PRESSURE_LOADAVG_FILE, pressure ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pressure - Window
+// =================
+int sm_pressure_window( int window, int running, int limit,
+    const SmPressureT* pressure )
+{
+    float stall;
+
+    stall = ( pressure->cpu > pressure->io ) ? pressure->cpu : pressure->io;
+
+    if( SM_PRESSURE_HIGH <= stall )
+    {
+        window = window / 2;
+        if( 1 > window )
+        {
+            window = 1;
+        }
+    }
+    else if(( SM_PRESSURE_LOW > stall )&&( running >= window ))
+    {
+        window = window + 1;
+        if( limit * 2 < window )
+        {
+            window = limit * 2;
+        }
+    }
+    else if(( SM_PRESSURE_LOW > stall )&&( 0 == running ))
+    {
+        window = limit;
+    }
+
+    return( window );
+}
+// ****************************************************************************
@@ -0,0 +1,72 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __SM_PRESSURE_H__
+#define __SM_PRESSURE_H__
+
+#include "sm_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SM_PRESSURE_CPU_FILE                          "/proc/pressure/cpu"
+#define SM_PRESSURE_IO_FILE                            "/proc/pressure/io"
+#define SM_PRESSURE_LOADAVG_FILE                             "/proc/loadavg"
+#define SM_PRESSURE_HIGH                                               40.0f
+#define SM_PRESSURE_LOW                                                10.0f
+
+typedef enum
+{
+    SM_PRESSURE_SOURCE_NONE,
+    SM_PRESSURE_SOURCE_PSI,
+    SM_PRESSURE_SOURCE_LOADAVG,
+} SmPressureSourceT;
+
+typedef struct
+{
+    SmPressureSourceT source;
+    float cpu;
+    float io;
+} SmPressureT;
+
+// ****************************************************************************
+// Pressure - Source String
+// ========================
+extern const char* sm_pressure_source_str( SmPressureSourceT source );
+// ****************************************************************************
+
+// ****************************************************************************
+// Pressure - Read Files
+// =====================
+// Reads the 10 second "some" stall percentages from the given PSI files.
+// Without PSI, cpu is the run queue excess over the online cpus from the
+// loadavg file, as a percentage, and io is zero.
+extern SmErrorT sm_pressure_read_files( const char cpu_file[],
+    const char io_file[], const char loadavg_file[], SmPressureT* pressure );
+// ****************************************************************************
+
+// ****************************************************************************
+// Pressure - Read
+// ===============
+extern SmErrorT sm_pressure_read( SmPressureT* pressure );
+// ****************************************************************************
+
+// ****************************************************************************
+// Pressure - Window
+// =================
+// Returns the next enable window for the larger of the cpu and io stalls.
+// At SM_PRESSURE_HIGH or more the window halves, down to one.  Below
+// SM_PRESSURE_LOW it grows by one, up to twice the limit, while every slot
+// is running, and returns to the limit once nothing is running.
+extern int sm_pressure_window( int window, int running, int limit,
+    const SmPressureT* pressure );
+// ****************************************************************************
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SM_PRESSURE_H__
@@ -0,0 +1,278 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Drives the pressure readings and the enable window from synthetic PSI
+// and loadavg files, exits non-zero when a check fails.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_pressure.h"
+
+#define SM_PRESSURE_TEST_LIMIT                                           4
+
+typedef struct
+{
+    float cpu;
+    float io;
+    int running;
+    int window;
+} SmPressureTestStepT;
+
+// From the window at the core limit with every slot running, low pressure
+// grows it to twice the limit, high pressure halves it down to one, and
+// it is back at the limit once idle.
+static SmPressureTestStepT _steps[] =
+{
+    {  2.0f,  1.0f, 4, 5 },
+    {  9.9f,  0.0f, 5, 6 },
+    {  0.5f,  3.0f, 6, 7 },
+    {  0.0f,  0.0f, 7, 8 },
+    {  0.0f,  0.0f, 8, 8 },
+    {  5.0f,  5.0f, 3, 8 },
+    { 25.0f,  2.0f, 8, 8 },
+    { 40.0f,  0.0f, 8, 4 },
+    {  3.0f, 62.5f, 4, 2 },
+    { 90.0f, 90.0f, 2, 1 },
+    { 55.0f,  0.0f, 1, 1 },
+    { 12.0f, 12.0f, 1, 1 },
+    {  1.0f,  1.0f, 1, 2 },
+    {  1.0f,  1.0f, 1, 2 },
+    {  1.0f,  1.0f, 0, 4 },
+};
+
+static char _dir[] = "/tmp/sm-pressure-test-XXXXXX";
+static char _cpu_file[64];
+static char _io_file[64];
+static char _loadavg_file[64];
+static unsigned int _failures = 0;
+
+// ****************************************************************************
+// Pressure Test - Check
+// =====================
+static void sm_pressure_test_check( bool passed, const char name[] )
+{
+    printf( "%s: %s\n", passed ? "PASS" : "FAIL", name );
+
+    if( !passed )
+    {
+        ++_failures;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pressure Test - Write
+// =====================
+// Writes the file, or removes it when contents is NULL.
+static void sm_pressure_test_write( const char filename[],
+    const char contents[] )
+{
+    FILE* fp;
+
+    if( NULL == contents )
+    {
+        unlink( filename );
+        return;
+    }
+
+    fp = fopen( filename, "w" );
+    if( NULL == fp )
+    {
+        printf( "Failed to create %s, error=%s.\n", filename,
+                strerror(errno) );
+        exit( EXIT_FAILURE );
+    }
+
+    fputs( contents, fp );
+    fclose( fp );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pressure Test - Write Stall
+// ===========================
+static void sm_pressure_test_write_stall( const char filename[], float some )
+{
+    char contents[256];
+
+    snprintf( contents, sizeof(contents),
+              "some avg10=%.2f avg60=1.17 avg300=0.31 total=214403519\n"
+              "full avg10=0.00 avg60=0.00 avg300=0.00 total=0\n", some );
+
+    sm_pressure_test_write( filename, contents );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pressure Test - Read
+// ====================
+static SmErrorT sm_pressure_test_read( SmPressureT* pressure )
+{
+    return( sm_pressure_read_files( _cpu_file, _io_file, _loadavg_file,
+                                    pressure ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pressure Test - Files
+// =====================
+static void sm_pressure_test_files( void )
+{
+    char contents[128];
+    long num_cpus;
+    SmPressureT pressure;
+    SmErrorT error;
+
+    sm_pressure_test_write_stall( _cpu_file, 37.5f );
+    sm_pressure_test_write_stall( _io_file, 4.25f );
+    sm_pressure_test_write( _loadavg_file, "0.52 0.58 0.59 1/467 1234\n" );
+
+    error = sm_pressure_test_read( &pressure );
+    sm_pressure_test_check(( SM_OKAY == error )&&
+                           ( SM_PRESSURE_SOURCE_PSI == pressure.source )&&
+                           ( 37.5f == pressure.cpu )&&
+                           ( 4.25f == pressure.io ), "psi cpu and io" );
+
+    sm_pressure_test_write( _io_file, NULL );
+
+    error = sm_pressure_test_read( &pressure );
+    sm_pressure_test_check(( SM_OKAY == error )&&
+                           ( SM_PRESSURE_SOURCE_PSI == pressure.source )&&
+                           ( 37.5f == pressure.cpu )&&
+                           ( 0.0f == pressure.io ), "psi without io" );
+
+    sm_pressure_test_write( _io_file, "full avg10=9.00 avg60=0.00 "
+                                      "avg300=0.00 total=0\n" );
+
+    error = sm_pressure_test_read( &pressure );
+    sm_pressure_test_check(( SM_OKAY == error )&&
+                           ( 0.0f == pressure.io ), "psi io without some" );
+
+    // Without PSI, the run queue excess over the online cpus.
+    num_cpus = sysconf( _SC_NPROCESSORS_ONLN );
+    if( 0 >= num_cpus )
+    {
+        num_cpus = 1;
+    }
+
+    sm_pressure_test_write( _cpu_file, NULL );
+    sm_pressure_test_write_stall( _io_file, 80.0f );
+    snprintf( contents, sizeof(contents), "%.2f 0.58 0.59 3/467 1234\n",
+              (float) num_cpus * 1.25f );
+    sm_pressure_test_write( _loadavg_file, contents );
+
+    error = sm_pressure_test_read( &pressure );
+    sm_pressure_test_check(( SM_OKAY == error )&&
+                           ( SM_PRESSURE_SOURCE_LOADAVG == pressure.source )&&
+                           ( 24.9f < pressure.cpu )&&
+                           ( 25.1f > pressure.cpu )&&
+                           ( 0.0f == pressure.io ), "loadavg excess" );
+
+    snprintf( contents, sizeof(contents), "%.2f 0.58 0.59 3/467 1234\n",
+              (float) num_cpus * 0.5f );
+    sm_pressure_test_write( _loadavg_file, contents );
+
+    error = sm_pressure_test_read( &pressure );
+    sm_pressure_test_check(( SM_OKAY == error )&&( 0.0f == pressure.cpu ),
+                           "loadavg below cpus" );
+
+    snprintf( contents, sizeof(contents), "%.2f 0.58 0.59 3/467 1234\n",
+              (float) num_cpus * 4.0f );
+    sm_pressure_test_write( _loadavg_file, contents );
+
+    error = sm_pressure_test_read( &pressure );
+    sm_pressure_test_check(( SM_OKAY == error )&&( 100.0f == pressure.cpu ),
+                           "loadavg capped" );
+
+    sm_pressure_test_write( _loadavg_file, "garbage\n" );
+
+    error = sm_pressure_test_read( &pressure );
+    sm_pressure_test_check( SM_FAILED == error, "loadavg unparsable" );
+
+    sm_pressure_test_write( _io_file, NULL );
+    sm_pressure_test_write( _loadavg_file, NULL );
+
+    error = sm_pressure_test_read( &pressure );
+    sm_pressure_test_check(( SM_NOT_FOUND == error )&&
+                           ( SM_PRESSURE_SOURCE_NONE == pressure.source ),
+                           "no files" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pressure Test - Window
+// ======================
+static void sm_pressure_test_window( void )
+{
+    char name[128];
+    int window = SM_PRESSURE_TEST_LIMIT;
+    SmPressureT pressure;
+    SmErrorT error;
+
+    unsigned int step_i;
+    for( step_i=0; sizeof(_steps)/sizeof(_steps[0]) > step_i; ++step_i )
+    {
+        SmPressureTestStepT* step = &(_steps[step_i]);
+        int next;
+
+        sm_pressure_test_write_stall( _cpu_file, step->cpu );
+        sm_pressure_test_write_stall( _io_file, step->io );
+
+        error = sm_pressure_test_read( &pressure );
+        if( SM_OKAY != error )
+        {
+            sm_pressure_test_check( false, "window read" );
+            return;
+        }
+
+        next = sm_pressure_window( window, step->running,
+                                   SM_PRESSURE_TEST_LIMIT, &pressure );
+
+        snprintf( name, sizeof(name), "window %d -> %d, cpu=%.1f%%, "
+                  "io=%.1f%%, running=%d, expected %d", window, next,
+                  step->cpu, step->io, step->running, step->window );
+
+        sm_pressure_test_check( step->window == next, name );
+
+        window = next;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Pressure Test - Main
+// ====================
+int main( int argc, char *argv[], char *envp[] )
+{
+    if( NULL == mkdtemp( _dir ) )
+    {
+        printf( "Failed to create directory, error=%s.\n", strerror(errno) );
+        return( EXIT_FAILURE );
+    }
+
+    snprintf( _cpu_file, sizeof(_cpu_file), "%s/cpu", _dir );
+    snprintf( _io_file, sizeof(_io_file), "%s/io", _dir );
+    snprintf( _loadavg_file, sizeof(_loadavg_file), "%s/loadavg", _dir );
+
+    sm_pressure_test_files();
+    sm_pressure_test_window();
+
+    unlink( _cpu_file );
+    unlink( _io_file );
+    unlink( _loadavg_file );
+    rmdir( _dir );
+
+    printf( "%u failed\n", _failures );
+
+    return( ( 0 == _failures ) ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+// ****************************************************************************
@@ -37,12 +37,14 @@
 #include "sm_db.h"
 #include "sm_node_utils.h"
 #include "sm_node_stats.h"
+#include "sm_eru_services.h"
 #include "sm_node_api.h"
 #include "sm_service_domain_api.h"
 #include "sm_service_domain_interface_api.h"
 #include "sm_service_group_api.h"
 #include "sm_service_api.h"
 #include "sm_service_action.h"
+#include "sm_service_action_stats.h"
 #include "sm_service_enable.h"
 #include "sm_service_heartbeat_api.h"
 #include "sm_service_heartbeat_thread.h"
@@ -53,11 +55,20 @@
 #include "sm_heartbeat_thread.h"
 #include "sm_failover.h"
 #include "sm_task_affining_thread.h"
+#include "sm_task_affinity.h"
+#include "sm_spawner.h"
 #include "sm_worker_thread.h"
 #include "sm_configuration_table.h"
 #include "sm_cluster_hbs_info_msg.h"
+#include "sm_journal.h"
 #include "fm_api_wrapper.h"
 #include "sm_swact_state.h"
+#include "sm_swact_profiler.h"
+#include "sm_service_plan.h"
+#include "sm_service_table.h"
+#include "sm_service_dependency_table.h"
+#include "sm_service_group_table.h"
+#include "sm_service_group_member_table.h"
 
 #define SM_PROCESS_DB_CHECKPOINT_INTERVAL_IN_MS         30000
 #define SM_PROCESS_TICK_INTERVAL_IN_MS                    200
@@ -80,17 +91,22 @@ static void sm_process_reap_children( void )
 {
     if( _reap_children )
     {
+        struct rusage usage;
         pid_t pid;
         int status;
+        int exit_code;
 
-        while( 0 < (pid = waitpid( -1, &status, WNOHANG | WUNTRACED )) )
+        while( 0 < (pid = wait4( -1, &status, WNOHANG | WUNTRACED, &usage )) )
         {
             if( WIFEXITED( status ) )
             {
-                sm_process_death_save( pid, WEXITSTATUS( status ) );
+                exit_code = WEXITSTATUS( status );
             } else {
-                sm_process_death_save( pid, SM_PROCESS_FAILED );
+                exit_code = SM_PROCESS_FAILED;
             }
+
+            sm_service_action_stats_exited( pid, exit_code, &usage );
+            sm_process_death_save( pid, exit_code );
         }
 
         _reap_children = 0;
@@ -201,6 +217,15 @@ static SmErrorT sm_process_initialize( void )
         return( SM_FAILED );
     }
 
+    // Forked while the process is still small, actions fall back to
+    // forking sm when the spawner is not available.
+    error = sm_spawner_initialize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to initialize spawner module, error=%s.",
+                  sm_error_str( error ) );
+    }
+
     error = SmWorkerThread::initialize();
     if( SM_OKAY != error )
     {
@@ -233,6 +258,22 @@ static SmErrorT sm_process_initialize( void )
         return( SM_FAILED );
     }
 
+    // Only feeds the ERU, SM runs without it.
+    error = sm_eru_services_initialize( true );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to initialize eru services module, error=%s.",
+                  sm_error_str( error ) );
+    }
+
+    error = sm_journal_initialize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to initialize journal module, error=%s.",
+                  sm_error_str( error ) );
+        return( SM_FAILED );
+    }
+
     error = sm_alarm_initialize();
     if( SM_OKAY != error )
     {
@@ -255,6 +296,14 @@ static SmErrorT sm_process_initialize( void )
         DPRINTFE("Failed to initialize cluster hbs info messaging");
     }
 
+    error = sm_task_affinity_initialize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to initialize task affinity module, error=%s.",
+                  sm_error_str( error ) );
+        return( SM_FAILED );
+    }
+
     if (_is_aio_simplex)
     {
     	sm_heartbeat_thread_disable_heartbeat();
@@ -326,6 +375,14 @@ static SmErrorT sm_process_initialize( void )
         return( SM_FAILED );
     }
 
+    error = sm_swact_profiler_initialize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to initialize swact profiler module, error=%s.",
+                  sm_error_str( error ) );
+        return( SM_FAILED );
+    }
+
     error = sm_service_api_initialize();
     if( SM_OKAY != error )
     {
@@ -435,6 +492,13 @@ static SmErrorT sm_process_finalize( void )
                   sm_error_str( error ) );
     }
 
+    error = sm_swact_profiler_finalize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to finalize swact profiler module, error=%s.",
+                  sm_error_str( error ) );
+    }
+
     error = sm_service_action_finalize();
     if( SM_OKAY != error )
     {
@@ -498,6 +562,13 @@ static SmErrorT sm_process_finalize( void )
                   sm_error_str( error ) );
     }
 
+    error = sm_eru_services_finalize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to finalize eru services module, error=%s.",
+                  sm_error_str( error ) );
+    }
+
     error = sm_thread_health_finalize();
     if( SM_OKAY != error )
     {
@@ -526,6 +597,13 @@ static SmErrorT sm_process_finalize( void )
                   sm_error_str( error ) );
     }
 
+    error = sm_spawner_finalize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to finalize spawner module, error=%s.",
+                  sm_error_str( error ) );
+    }
+
     error = sm_timer_finalize();
     if( SM_OKAY != error )
     {
@@ -546,6 +624,13 @@ static SmErrorT sm_process_finalize( void )
         DPRINTFE("Failed to finalize cluster hbs info messaging");
     }
 
+    error = sm_task_affinity_finalize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to finalize task affinity module, error=%s.",
+                  sm_error_str( error ) );
+    }
+
     error = sm_log_finalize();
     if( SM_OKAY != error )
     {
@@ -553,6 +638,13 @@ static SmErrorT sm_process_finalize( void )
                   sm_error_str( error ) );
     }
 
+    error = sm_journal_finalize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to finalize journal module, error=%s.",
+                  sm_error_str( error ) );
+    }
+
     // mutexes
     fm_mutex_finalize();
     sm_failover_mutex_finalize();
@@ -638,6 +730,94 @@ static int get_process_nice_val()
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Process - Set Debug Log Mode
+// ============================
+static void sm_process_set_debug_log_mode( void )
+{
+    char buf[SM_CONFIGURATION_VALUE_MAX_CHAR + 1];
+    SmDebugLogModeT mode = SM_DEBUG_LOG_MODE_TEXT;
+
+    if( SM_OKAY == sm_configuration_table_get( "sm_debug_log_mode", buf,
+                                               sizeof(buf) - 1 ) )
+    {
+        if( 0 == strcmp( "binary", buf ) )
+        {
+            mode = SM_DEBUG_LOG_MODE_BINARY;
+        } else if(( '\0' != buf[0] )&&( 0 != strcmp( "text", buf ) )) {
+            DPRINTFE( "Invalid sm_debug_log_mode value %s, using text.", buf );
+        }
+    }
+
+    DPRINTFI( "Debug log mode is %s.", sm_debug_log_mode_str( mode ) );
+    sm_debug_set_log_mode( mode );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Process - Plan
+// ==============
+// Loads the services from the database and prints the expected go-active
+// makespan without starting anything.
+static SmErrorT sm_process_plan( const char durations_file[] )
+{
+    SmErrorT error;
+
+    error = sm_db_initialize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to initialize database module, error=%s.",
+                  sm_error_str( error ) );
+        return( error );
+    }
+
+    error = sm_service_group_table_initialize();
+    if( SM_OKAY == error )
+    {
+        error = sm_service_group_member_table_initialize();
+    }
+    if( SM_OKAY == error )
+    {
+        error = sm_service_action_table_initialize();
+    }
+    if( SM_OKAY == error )
+    {
+        error = sm_service_table_initialize();
+    }
+    if( SM_OKAY == error )
+    {
+        error = sm_service_dependency_table_initialize();
+    }
+    if( SM_OKAY == error )
+    {
+        error = sm_service_plan_initialize();
+    }
+
+    if( SM_OKAY == error )
+    {
+        error = sm_service_plan_simulate( durations_file, stdout );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to simulate go-active plan, error=%s.",
+                      sm_error_str( error ) );
+        }
+    } else {
+        DPRINTFE( "Failed to load services, error=%s.",
+                  sm_error_str( error ) );
+    }
+
+    sm_service_plan_finalize();
+    sm_service_dependency_table_finalize();
+    sm_service_table_finalize();
+    sm_service_action_table_finalize();
+    sm_service_group_member_table_finalize();
+    sm_service_group_table_finalize();
+    sm_db_finalize();
+
+    return( error );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Process - Main
 // ==============
@@ -655,9 +835,48 @@ SmErrorT sm_process_main( int argc, char *argv[], char *envp[] )
     static struct option long_options[] = {
         {"interval-extension", 1, 0, 'i'},
         {"timeout-extension",  1, 0, 't'},
+        {"plan",               2, 0, 'p'},
         {0, 0, 0, 0}
     };
     int long_index = 0;
+    bool do_plan = false;
+    const char* durations_file = NULL;
+
+    // Check for cmdline args
+    while ((opt = getopt_long(argc, argv, "i:t:p::",
+                              long_options,
+                              &long_index)) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+            {
+                sm_service_action_table_set_interval_extension( atoi(optarg) );
+                break;
+            }
+            case 't':
+            {
+                sm_service_action_table_set_timeout_extension( atoi(optarg) );
+                break;
+            }
+            case 'p':
+            {
+                do_plan = true;
+                durations_file = optarg;
+                break;
+            }
+            default:
+            {
+                DPRINTFE( "Failed to process cmdline arg." );
+                return( SM_FAILED );
+            }
+        }
+    }
+
+    if( do_plan )
+    {
+        return( sm_process_plan( durations_file ) );
+    }
 
     sm_process_setup_signal_handler();
 
@@ -688,31 +907,6 @@ SmErrorT sm_process_main( int argc, char *argv[], char *envp[] )
         }
     }
 
-    // Check for cmdline args
-    while ((opt = getopt_long(argc, argv, "i:t:",
-                              long_options,
-                              &long_index)) != -1)
-    {
-        switch (opt)
-        {
-            case 'i':
-            {
-                sm_service_action_table_set_interval_extension( atoi(optarg) );
-                break;
-            }
-            case 't':
-            {
-                sm_service_action_table_set_timeout_extension( atoi(optarg) );
-                break;
-            }
-            default:
-            {
-                DPRINTFE( "Failed to process cmdline arg." );
-                return( SM_FAILED );
-            }
-        }
-    }
-
     error = sm_process_wait_node_configuration();
     if( SM_OKAY != error )
     {
@@ -771,6 +965,8 @@ SmErrorT sm_process_main( int argc, char *argv[], char *envp[] )
         return( error );
     }
 
+    sm_process_set_debug_log_mode();
+
     int process_nice_val = get_process_nice_val();
 
     result = setpriority( PRIO_PROCESS, getpid(), process_nice_val);
@@ -781,6 +977,13 @@ SmErrorT sm_process_main( int argc, char *argv[], char *envp[] )
         return( SM_FAILED );
     }
 
+    error = sm_task_affinity_pin_thread( "main" );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to pin main thread, error=%s.",
+                  sm_error_str(error) );
+    }
+
     error = sm_utils_set_boot_complete();
     if( SM_OKAY != error )
     {
@@ -13,9 +13,13 @@
 #include <unistd.h>
 #include <signal.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/eventfd.h>
+#include <sys/epoll.h>
 #include <sys/prctl.h>
+#include <sys/syscall.h>
 
 #include "sm_types.h"
 #include "sm_debug.h"
@@ -62,12 +66,14 @@ struct task_state_notify_info
 #define SM_PROCESS_DEATH_MAX                              1024
 #define SM_PROCESS_DEATH_INFO_VALID                 0xFDFDFDFD
 #define SM_PROCESS_DEATH_MAX_DISPATCH                        8
+#define SM_PROCESS_DEATH_PIDFD_EVENTS_MAX                   16
 
 typedef struct
 {
     uint32_t valid;
     pid_t pid;
     int exit_code;
+    struct timespec detected;
 } SmProcessDeathInfoT;
 
 typedef struct
@@ -75,14 +81,128 @@ typedef struct
     uint32_t valid;
     pid_t pid;
     bool child_process;
+    int pidfd;
+    SmProcessDeathBackendT backend;
     int64_t user_data;
     SmProcessDeathCallbackT death_callback;
 } SmProcessCallbackInfoT;
 
 static int _process_death_fd = -1;
+static int _process_death_pidfd_epoll_fd = -1;
+static bool _pidfd_supported = true;
 static SmProcessCallbackInfoT _callbacks[SM_PROCESS_DEATH_MAX];
 static SmProcessDeathInfoT _process_deaths[SM_PROCESS_DEATH_MAX];
 static uint64_t _process_death_count = 0;
+static SmProcessDeathInfoT* _dispatch_info = NULL;
+static SmProcessCallbackInfoT* _dispatch_callback = NULL;
+
+// ****************************************************************************
+// Process Death - Backend String
+// ==============================
+const char* sm_process_death_backend_str( SmProcessDeathBackendT backend )
+{
+    switch( backend )
+    {
+        case SM_PROCESS_DEATH_BACKEND_NONE:
+            return( "none" );
+        case SM_PROCESS_DEATH_BACKEND_CHILD:
+            return( "child" );
+        case SM_PROCESS_DEATH_BACKEND_PIDFD:
+            return( "pidfd" );
+        case SM_PROCESS_DEATH_BACKEND_KERNEL_NOTIFY:
+            return( "kernel-notify" );
+        case SM_PROCESS_DEATH_BACKEND_AUDIT:
+            return( "audit" );
+        default:
+            return( "???" );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Process Death - Pidfd Open
+// ==========================
+// Returns SM_NOT_FOUND when the process has already exited and
+// SM_NOT_IMPLEMENTED when pidfds are not available.
+static SmErrorT sm_process_death_pidfd_open( SmProcessCallbackInfoT* callback )
+{
+#ifdef __NR_pidfd_open
+    struct epoll_event event;
+    int pidfd;
+
+    if(( !_pidfd_supported )||( 0 > _process_death_pidfd_epoll_fd ))
+    {
+        return( SM_NOT_IMPLEMENTED );
+    }
+
+    if( 0 <= callback->pidfd )
+    {
+        return( SM_OKAY );
+    }
+
+    pidfd = (int) syscall( __NR_pidfd_open, callback->pid, 0 );
+    if( 0 > pidfd )
+    {
+        if( ESRCH == errno )
+        {
+            return( SM_NOT_FOUND );
+        }
+
+        if(( ENOSYS == errno )||( EINVAL == errno ))
+        {
+            DPRINTFI( "Pidfds not supported, error=%s, using kernel "
+                      "notifications.", strerror( errno ) );
+            _pidfd_supported = false;
+        } else {
+            DPRINTFE( "Failed to open pidfd for pid (%i), error=%s.",
+                      (int) callback->pid, strerror( errno ) );
+        }
+        return( SM_NOT_IMPLEMENTED );
+    }
+
+    fcntl( pidfd, F_SETFD, FD_CLOEXEC );
+
+    memset( &event, 0, sizeof(event) );
+    event.events = EPOLLIN;
+    event.data.fd = pidfd;
+
+    if( 0 > epoll_ctl( _process_death_pidfd_epoll_fd, EPOLL_CTL_ADD, pidfd,
+                       &event ) )
+    {
+        DPRINTFE( "Failed to watch pidfd for pid (%i), error=%s.",
+                  (int) callback->pid, strerror( errno ) );
+        close( pidfd );
+        return( SM_NOT_IMPLEMENTED );
+    }
+
+    callback->pidfd = pidfd;
+
+    DPRINTFD( "Watching pid (%i) with pidfd (%i).", (int) callback->pid,
+              pidfd );
+
+    return( SM_OKAY );
+#else
+    return( SM_NOT_IMPLEMENTED );
+#endif // __NR_pidfd_open
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Process Death - Pidfd Close
+// ===========================
+static void sm_process_death_pidfd_close( SmProcessCallbackInfoT* callback )
+{
+    if( 0 > callback->pidfd )
+    {
+        return;
+    }
+
+    epoll_ctl( _process_death_pidfd_epoll_fd, EPOLL_CTL_DEL, callback->pidfd,
+               NULL );
+    close( callback->pidfd );
+    callback->pidfd = -1;
+}
+// ****************************************************************************
 
 // ****************************************************************************
 // Process Death - Already Registered
@@ -118,26 +238,7 @@ SmErrorT sm_process_death_register( pid_t pid, bool child_process,
     SmProcessDeathCallbackT death_callback, int64_t user_data )
 {
     SmProcessCallbackInfoT* callback = NULL;
-
-#ifdef __SM_PROCESS_DEATH_KERNEL_NOTIFICATION_SUPPORTED__
-    if( !child_process )
-    {
-        struct task_state_notify_info info;
-
-        info.pid    = pid ;
-        info.sig    = SM_KERNEL_NOTIFY_SIGNAL;
-        info.events = SM_KERNEL_NOTIFY_FLAGS;
-
-        if( -1 > prctl( PR_DO_NOTIFY_TASK_STATE, &info ) )
-        {
-            DPRINTFE( "Failed to register for kernel notifications for "
-                      "pid (%i), error=%s.", (int) pid, strerror(errno) );
-        }
-
-        DPRINTFD( "Register for kernel notifications for pid (%i).",
-                  (int) pid );
-    }
-#endif // __SM_PROCESS_DEATH_KERNEL_NOTIFICATION_SUPPORTED__
+    SmErrorT error;
 
     unsigned int callbacks_i;
     for( callbacks_i=0; SM_PROCESS_DEATH_MAX > callbacks_i; ++callbacks_i )
@@ -157,6 +258,8 @@ SmErrorT sm_process_death_register( pid_t pid, bool child_process,
             callback->valid = SM_PROCESS_DEATH_INFO_VALID;
             callback->pid = pid;
             callback->child_process = child_process;
+            callback->pidfd = -1;
+            callback->backend = SM_PROCESS_DEATH_BACKEND_NONE;
             callback->death_callback = death_callback;
             callback->user_data = user_data;
             break;
@@ -170,6 +273,48 @@ SmErrorT sm_process_death_register( pid_t pid, bool child_process,
         return( SM_FAILED );
     }
 
+    if( child_process )
+    {
+        callback->backend = SM_PROCESS_DEATH_BACKEND_CHILD;
+        return( SM_OKAY );
+    }
+
+    error = sm_process_death_pidfd_open( callback );
+    if( SM_OKAY == error )
+    {
+        callback->backend = SM_PROCESS_DEATH_BACKEND_PIDFD;
+        return( SM_OKAY );
+
+    } else if( SM_NOT_FOUND == error ) {
+        // Exited before it could be watched, report it now.
+        DPRINTFI( "Process (%i) already exited on registration.", (int) pid );
+        callback->backend = SM_PROCESS_DEATH_BACKEND_PIDFD;
+        sm_process_death_save( pid, SM_PROCESS_FAILED );
+        return( SM_OKAY );
+    }
+
+#ifdef __SM_PROCESS_DEATH_KERNEL_NOTIFICATION_SUPPORTED__
+    if( SM_PROCESS_DEATH_BACKEND_KERNEL_NOTIFY != callback->backend )
+    {
+        struct task_state_notify_info info;
+
+        info.pid    = pid ;
+        info.sig    = SM_KERNEL_NOTIFY_SIGNAL;
+        info.events = SM_KERNEL_NOTIFY_FLAGS;
+
+        if( -1 > prctl( PR_DO_NOTIFY_TASK_STATE, &info ) )
+        {
+            DPRINTFE( "Failed to register for kernel notifications for "
+                      "pid (%i), error=%s.", (int) pid, strerror(errno) );
+        }
+
+        DPRINTFD( "Register for kernel notifications for pid (%i).",
+                  (int) pid );
+
+        callback->backend = SM_PROCESS_DEATH_BACKEND_KERNEL_NOTIFY;
+    }
+#endif // __SM_PROCESS_DEATH_KERNEL_NOTIFICATION_SUPPORTED__
+
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -192,8 +337,10 @@ SmErrorT sm_process_death_deregister( pid_t pid )
         if( pid != callback->pid )
             continue;
 
+        sm_process_death_pidfd_close( callback );
+
 #ifdef __SM_PROCESS_DEATH_KERNEL_NOTIFICATION_SUPPORTED__
-        if( !callback->child_process )
+        if( SM_PROCESS_DEATH_BACKEND_KERNEL_NOTIFY == callback->backend )
         {
             struct task_state_notify_info info;
 
@@ -253,6 +400,7 @@ SmErrorT sm_process_death_save( pid_t pid, int exit_code )
             info->valid = SM_PROCESS_DEATH_INFO_VALID;
             info->pid = pid;
             info->exit_code = exit_code;
+            clock_gettime( CLOCK_MONOTONIC, &(info->detected) );
             break;
         }
     }
@@ -301,8 +449,17 @@ static void sm_process_death_dispatch( int selobj, int64_t user_data )
                 {
                     if( NULL != callback->death_callback )
                     {
+                        sm_process_death_pidfd_close( callback );
+
+                        _dispatch_info = info;
+                        _dispatch_callback = callback;
+
                         callback->death_callback( info->pid, info->exit_code,
                                                   callback->user_data );
+
+                        _dispatch_info = NULL;
+                        _dispatch_callback = NULL;
+
                         callback->valid = 0;
                     }
                 }
@@ -347,6 +504,81 @@ static void sm_process_death_dispatch( int selobj, int64_t user_data )
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Process Death - Pidfd Dispatch
+// ==============================
+static void sm_process_death_pidfd_dispatch( int selobj, int64_t user_data )
+{
+    struct epoll_event events[SM_PROCESS_DEATH_PIDFD_EVENTS_MAX];
+    SmProcessCallbackInfoT* callback;
+    int num_events;
+
+    num_events = epoll_wait( _process_death_pidfd_epoll_fd, events,
+                             SM_PROCESS_DEATH_PIDFD_EVENTS_MAX, 0 );
+    if( 0 > num_events )
+    {
+        if( EINTR != errno )
+        {
+            DPRINTFE( "Failed to wait on pidfds, error=%s.",
+                      strerror( errno ) );
+        }
+        return;
+    }
+
+    int event_i;
+    for( event_i=0; num_events > event_i; ++event_i )
+    {
+        unsigned int callbacks_i;
+        for( callbacks_i=0; SM_PROCESS_DEATH_MAX > callbacks_i; ++callbacks_i )
+        {
+            callback = &(_callbacks[callbacks_i]);
+
+            if(( SM_PROCESS_DEATH_INFO_VALID != callback->valid )||
+               ( events[event_i].data.fd != callback->pidfd ))
+                continue;
+
+            DPRINTFD( "Pidfd process (%i) death notification.",
+                      (int) callback->pid );
+
+            // Stop watching, the pidfd stays readable once exited.
+            sm_process_death_pidfd_close( callback );
+            sm_process_death_save( callback->pid, SM_PROCESS_FAILED );
+            break;
+        }
+
+        if( SM_PROCESS_DEATH_MAX <= callbacks_i )
+        {
+            epoll_ctl( _process_death_pidfd_epoll_fd, EPOLL_CTL_DEL,
+                       events[event_i].data.fd, NULL );
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Process Death - Detection
+// =========================
+SmErrorT sm_process_death_detection( pid_t pid,
+    SmProcessDeathBackendT* backend, long* dispatch_latency_us )
+{
+    struct timespec now;
+
+    if(( NULL == _dispatch_info )||( pid != _dispatch_info->pid ))
+    {
+        return( SM_NOT_FOUND );
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    *backend = _dispatch_callback->backend;
+    *dispatch_latency_us
+        = (now.tv_sec - _dispatch_info->detected.tv_sec) * 1000000
+        + (now.tv_nsec - _dispatch_info->detected.tv_nsec) / 1000;
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
 #ifdef __SM_PROCESS_DEATH_KERNEL_NOTIFICATION_SUPPORTED__
 // ****************************************************************************
 // Process Death - Signal Handler
@@ -390,6 +622,23 @@ SmErrorT sm_process_death_initialize( void )
         return( error );
     }
 
+    _process_death_pidfd_epoll_fd = epoll_create1( EPOLL_CLOEXEC );
+    if( 0 > _process_death_pidfd_epoll_fd )
+    {
+        DPRINTFE( "Failed to create pidfd epoll, error=%s, using kernel "
+                  "notifications.", strerror( errno ) );
+    } else {
+        error = sm_selobj_register( _process_death_pidfd_epoll_fd,
+                                    sm_process_death_pidfd_dispatch, 0 );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to register pidfd selection object, error=%s.",
+                      sm_error_str( error ) );
+            close( _process_death_pidfd_epoll_fd );
+            _process_death_pidfd_epoll_fd = -1;
+        }
+    }
+
 #ifdef __SM_PROCESS_DEATH_KERNEL_NOTIFICATION_SUPPORTED__
     struct sigaction sa;
     
@@ -425,6 +674,28 @@ SmErrorT sm_process_death_finalize( void )
         close( _process_death_fd );
     }
 
+    if( 0 <= _process_death_pidfd_epoll_fd )
+    {
+        unsigned int callbacks_i;
+        for( callbacks_i=0; SM_PROCESS_DEATH_MAX > callbacks_i; ++callbacks_i )
+        {
+            if( SM_PROCESS_DEATH_INFO_VALID == _callbacks[callbacks_i].valid )
+            {
+                sm_process_death_pidfd_close( &(_callbacks[callbacks_i]) );
+            }
+        }
+
+        error = sm_selobj_deregister( _process_death_pidfd_epoll_fd );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to deregister pidfd selection object, "
+                      "error=%s.", sm_error_str( error ) );
+        }
+
+        close( _process_death_pidfd_epoll_fd );
+        _process_death_pidfd_epoll_fd = -1;
+    }
+
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -17,9 +17,25 @@
 extern "C" {
 #endif
 
+typedef enum
+{
+    SM_PROCESS_DEATH_BACKEND_NONE,
+    SM_PROCESS_DEATH_BACKEND_CHILD,
+    SM_PROCESS_DEATH_BACKEND_PIDFD,
+    SM_PROCESS_DEATH_BACKEND_KERNEL_NOTIFY,
+    SM_PROCESS_DEATH_BACKEND_AUDIT,
+} SmProcessDeathBackendT;
+
 typedef void (*SmProcessDeathCallbackT) (pid_t pid, int exit_code, 
         int64_t user_data);
 
+// ****************************************************************************
+// Process Death - Backend String
+// ==============================
+extern const char* sm_process_death_backend_str(
+    SmProcessDeathBackendT backend );
+// ****************************************************************************
+
 // ****************************************************************************
 // Process Death - Already Registered
 // ==================================
@@ -30,6 +46,9 @@ extern bool sm_process_death_already_registered( pid_t pid,
 // ****************************************************************************
 // Process Death - Register
 // ========================
+// Children are reported through sm_process_death_save() by the reaper.
+// Other processes are watched with a pidfd, or with kernel task state
+// notifications when pidfds are not available.
 extern SmErrorT sm_process_death_register( pid_t pid, bool child_process, 
     SmProcessDeathCallbackT death_callback, int64_t user_data );
 // ****************************************************************************
@@ -46,6 +65,16 @@ extern SmErrorT sm_process_death_deregister( pid_t pid );
 extern SmErrorT sm_process_death_save( pid_t pid, int exit_code );
 // ****************************************************************************
 
+// ****************************************************************************
+// Process Death - Detection
+// =========================
+// Only valid from within a death callback, gives the backend that detected
+// the death and the dispatch latency, the time from detection to the
+// callback.  The time of death itself is not known to the backends.
+extern SmErrorT sm_process_death_detection( pid_t pid,
+    SmProcessDeathBackendT* backend, long* dispatch_latency_us );
+// ****************************************************************************
+
 // ****************************************************************************
 // Process Death - Initialize
 // ==========================
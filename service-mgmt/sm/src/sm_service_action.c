@@ -20,11 +20,28 @@
 
 #include "sm_types.h"
 #include "sm_debug.h"
+#include "sm_utils.h"
 #include "sm_sha512.h"
 #include "sm_service_action_table.h"
 #include "sm_service_action_result_table.h"
+#include "sm_task_affinity.h"
+#include "sm_spawner.h"
+#include "sm_service_action_stats.h"
 
 #define SM_SERVICE_ACTION_VALIDATE_TIMER_IN_MS              60000
+#define SM_SERVICE_ACTION_ENV_MAX                             128
+#define SM_SERVICE_ACTION_ENV_MAX_CHAR                      16384
+#define SM_SERVICE_ACTION_NICE                                 -1
+
+typedef struct
+{
+    unsigned int count;
+    unsigned int used;
+    char* vars[SM_SERVICE_ACTION_ENV_MAX+1];
+    char storage[SM_SERVICE_ACTION_ENV_MAX_CHAR];
+} SmServiceActionEnvT;
+
+static SmServiceActionEnvT _action_env;
 
 // ****************************************************************************
 // Service Action - Validate
@@ -265,6 +282,9 @@ SmErrorT sm_service_action_result( int exit_code, char service_name[],
                   "%i", exit_code );
     }
 
+    DPRINTFD( "Service (%s) action (%s) exited, exit_code=%s.", service_name,
+              sm_service_action_str( action ), plugin_exit_code );
+
     *action_result = SM_SERVICE_ACTION_RESULT_UNKNOWN;
     *service_state = SM_SERVICE_STATE_UNKNOWN;
     *service_status = SM_SERVICE_STATUS_UNKNOWN;
@@ -361,11 +381,42 @@ SmErrorT sm_service_action_abort( char service_name[], int process_id )
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Action - Environment Set
+// ================================
+static int sm_service_action_env_set( SmServiceActionEnvT* env,
+    const char key[], const char value[] )
+{
+    int len;
+
+    if( SM_SERVICE_ACTION_ENV_MAX <= env->count )
+    {
+        errno = E2BIG;
+        return( -1 );
+    }
+
+    len = snprintf( &(env->storage[env->used]),
+                    sizeof(env->storage) - env->used, "%s=%s", key, value );
+    if(( 0 > len )||( (int) (sizeof(env->storage) - env->used) <= len ))
+    {
+        errno = E2BIG;
+        return( -1 );
+    }
+
+    env->vars[env->count++] = &(env->storage[env->used]);
+    env->vars[env->count] = NULL;
+    env->used += len + 1;
+
+    return( 0 );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Action - Setup Instance Environment Variables
 // =====================================================
 static SmErrorT sm_service_action_setup_instance_env_vars( char instance_name[],
-    char instance_params[], SmServiceActionDataT* action_data )
+    char instance_params[], SmServiceActionDataT* action_data,
+    SmServiceActionEnvT* env )
 {
     char looking_for = '=';
     char key_storage[SM_SERVICE_INSTANCE_PARAMS_MAX_CHAR+32];
@@ -377,39 +428,40 @@ static SmErrorT sm_service_action_setup_instance_env_vars( char instance_name[],
     if( 0 == strcmp( SM_SERVICE_ACTION_PLUGIN_TYPE_OCF_SCRIPT,
                      action_data->plugin_type ) )
     {
-        if( 0 > setenv( "OCF_RA_VERSION_MAJOR", 
-                        SM_SERVICE_ACTION_PLUGIN_TYPE_OCF_VERSION, 1 ) )
+        if( 0 > sm_service_action_env_set( env, "OCF_RA_VERSION_MAJOR",
+                        SM_SERVICE_ACTION_PLUGIN_TYPE_OCF_VERSION ) )
         {
             DPRINTFE( "Failed to set environment variable "
                       "(OCF_RA_VERSION_MAJOR), error=%s.", strerror( errno ) );
             goto ERROR;
         }
 
-        if( 0 > setenv( "OCF_RA_VERSION_MINOR", 
-                        SM_SERVICE_ACTION_PLUGIN_TYPE_OCF_REVISION, 1 ) )
+        if( 0 > sm_service_action_env_set( env, "OCF_RA_VERSION_MINOR",
+                        SM_SERVICE_ACTION_PLUGIN_TYPE_OCF_REVISION ) )
         {
             DPRINTFE( "Failed to set environment variable "
                       "(OCF_RA_VERSION_MINOR), error=%s.", strerror( errno ) );
             goto ERROR;
         }
 
-        if( 0 > setenv( "OCF_ROOT",
-                        SM_SERVICE_ACTION_PLUGIN_TYPE_OCF_DIR, 1 ) )
+        if( 0 > sm_service_action_env_set( env, "OCF_ROOT",
+                                           SM_SERVICE_ACTION_PLUGIN_TYPE_OCF_DIR ) )
         {
             DPRINTFE( "Failed to set environment variable "
                       "(OCF_ROOT), error=%s.", strerror( errno ) );
             goto ERROR;
         }
 
-        if( 0 > setenv( "OCF_RESOURCE_INSTANCE", instance_name, 1 ) )
+        if( 0 > sm_service_action_env_set( env, "OCF_RESOURCE_INSTANCE",
+                                           instance_name ) )
         {
             DPRINTFE( "Failed to set environment variable "
                       "(OCF_RESOURCE_INSTANCE), error=%s.", strerror( errno ) );
             goto ERROR;
         }
 
-        if( 0 > setenv( "OCF_RESOURCE_TYPE",
-                        action_data->plugin_name, 1 ) )
+        if( 0 > sm_service_action_env_set( env, "OCF_RESOURCE_TYPE",
+                                           action_data->plugin_name ) )
         {
             DPRINTFE( "Failed to set environment variable "
                       "(OCF_RESOURCE_TYPE), error=%s.", strerror( errno ) );
@@ -439,7 +491,7 @@ static SmErrorT sm_service_action_setup_instance_env_vars( char instance_name[],
                 DPRINTFD( "%s set environment: %s=%s", instance_name, key,
                           value );
 
-                if( 0 > setenv( key, value, 1 ) )
+                if( 0 > sm_service_action_env_set( env, key, value ) )
                 {
                     DPRINTFE( "Failed to set environment variable (%s=%s), "
                               "error=%s.", key, value, strerror( errno ) );
@@ -479,7 +531,7 @@ static SmErrorT sm_service_action_setup_instance_env_vars( char instance_name[],
         DPRINTFD( "%s set environment: %s=%s", instance_name, key,
                   value );
 
-        if( 0 > setenv( key, value, 1 ) )
+        if( 0 > sm_service_action_env_set( env, key, value ) )
         {
             DPRINTFE( "Failed to set environment variable (%s=%s), "
                       "error=%s.", key, value, strerror( errno ) );
@@ -498,7 +550,7 @@ ERROR:
 // Service Action - Setup Plugin Environment Variables
 // ===================================================
 static SmErrorT sm_service_action_setup_plugin_env_vars(
-    SmServiceActionDataT* action_data )
+    SmServiceActionDataT* action_data, SmServiceActionEnvT* env )
 {
     char looking_for = '=';
     char key_storage[SM_SERVICE_ACTION_PLUGIN_PARAMS_MAX_CHAR+32];
@@ -510,7 +562,8 @@ static SmErrorT sm_service_action_setup_plugin_env_vars(
     if( 0 == strcmp( SM_SERVICE_ACTION_PLUGIN_TYPE_LSB_SCRIPT,
                      action_data->plugin_type ) )
     {
-        if( 0 > setenv( "SYSTEMCTL_SKIP_REDIRECT", "1", 1 ) )
+        if( 0 > sm_service_action_env_set( env, "SYSTEMCTL_SKIP_REDIRECT",
+                                           "1" ) )
         {
             DPRINTFE( "Failed to set environment variable "
                       "(SYSTEMCTL_SKIP_REDIRECT), error=%s.",
@@ -521,7 +574,8 @@ static SmErrorT sm_service_action_setup_plugin_env_vars(
     } else if( 0 == strcmp( SM_SERVICE_ACTION_PLUGIN_TYPE_OCF_SCRIPT,
                             action_data->plugin_type ) )
     {
-        if( 0 > setenv( "HA_LOGFACILITY", "daemon", 1 ) )
+        if( 0 > sm_service_action_env_set( env, "HA_LOGFACILITY",
+                                           "daemon" ) )
         {
             DPRINTFE( "Failed to set environment variable (HA_LOGFACILITY), "
                       "error=%s.", strerror( errno ) );
@@ -552,7 +606,7 @@ static SmErrorT sm_service_action_setup_plugin_env_vars(
                 DPRINTFD( "%s set environment: %s=%s", 
                           action_data->service_name, key, value );
 
-                if( 0 > setenv( key, value, 1 ) )
+                if( 0 > sm_service_action_env_set( env, key, value ) )
                 {
                     DPRINTFE( "Failed to set environment variable (%s=%s), "
                               "error=%s.", key, value, strerror( errno ) );
@@ -589,7 +643,7 @@ static SmErrorT sm_service_action_setup_plugin_env_vars(
         DPRINTFD( "%s set environment: %s=%s", action_data->service_name,
                   key, value );
 
-        if( 0 > setenv( key, value, 1 ) )
+        if( 0 > sm_service_action_env_set( env, key, value ) )
         {
             DPRINTFE( "Failed to set environment variable (%s=%s), "
                       "error=%s.", key, value, strerror( errno ) );
@@ -608,12 +662,17 @@ ERROR:
 // Service Action - Setup Environment
 // ==================================
 static SmErrorT sm_service_action_setup_env( char instance_name[],
-    char instance_params[], SmServiceActionDataT* action_data )
+    char instance_params[], SmServiceActionDataT* action_data,
+    SmServiceActionEnvT* env )
 {
     SmErrorT error;
 
+    env->count = 0;
+    env->used = 0;
+    env->vars[0] = NULL;
+
     error = sm_service_action_setup_instance_env_vars( instance_name,
-                                            instance_params, action_data );
+                                            instance_params, action_data, env );
     if( SM_OKAY != error )
     {
         DPRINTFE( "Failed to set instance environment variables for service "
@@ -623,7 +682,7 @@ static SmErrorT sm_service_action_setup_env( char instance_name[],
         return( error );
     }
 
-    error = sm_service_action_setup_plugin_env_vars( action_data );
+    error = sm_service_action_setup_plugin_env_vars( action_data, env );
     if( SM_OKAY != error )
     {
         DPRINTFE( "Failed to set plugin environment variables for service "
@@ -637,6 +696,97 @@ static SmErrorT sm_service_action_setup_env( char instance_name[],
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Action - Fork
+// =====================
+// Used when the spawner is not available, the environment has already
+// been prepared in _action_env.
+static SmErrorT sm_service_action_fork( SmServiceActionDataT* action_data,
+    char* argv[], bool service_managed, pid_t* process_id )
+{
+    pid_t pid;
+    int result;
+
+    pid = fork();
+    if( 0 > pid )
+    {
+        DPRINTFE( "Failed to fork process for service (%s), error=%s.",
+                  action_data->service_name, strerror( errno ) );
+        return( SM_FAILED );
+
+    } else if( 0 == pid ) {
+        // Child process.
+        DPRINTFD( "Child process created for service (%s).",
+                  action_data->service_name );
+
+        if( 0 > setpgid( 0, 0 ) )
+        {
+            DPRINTFE( "Failed to set process group id for service (%s), "
+                      "error=%s.", action_data->service_name,
+                      strerror( errno ) );
+            exit( SM_SERVICE_ACTION_PLUGIN_FAILURE );
+        }
+
+        sm_utils_close_fds( 0 );
+
+        if( 0 > open( "/dev/null", O_RDONLY ) )
+        {
+            DPRINTFE( "Failed to open stdin to /dev/null for service (%s), "
+                      "error=%s.", action_data->service_name,
+                      strerror( errno ) );
+        }
+
+        if( 0 > open( "/dev/null", O_WRONLY ) )
+        {
+            DPRINTFE( "Failed to open stdout to /dev/null for service (%s), "
+                      "error=%s.", action_data->service_name, 
+                      strerror( errno ) );
+        }
+
+        if( 0 > open( "/dev/null", O_WRONLY ) )
+        {
+            DPRINTFE( "Failed to open stderr to /dev/null for service (%s), "
+                      "error=%s.", action_data->service_name,
+                      strerror( errno ) );
+        }
+
+        result = setpriority( PRIO_PROCESS, getpid(), SM_SERVICE_ACTION_NICE );
+        if( 0 > result )
+        {
+            DPRINTFE( "Failed to set priority of process, error=%s.",
+                      strerror( errno ) );
+            exit( SM_SERVICE_ACTION_PLUGIN_FAILURE );
+        }
+
+        sm_task_affinity_restore_child();
+
+        if( !service_managed )
+        {
+            exit( SM_SERVICE_ACTION_PLUGIN_FORCE_SUCCESS );
+        }
+
+        unsigned int env_i;
+        for( env_i=0; _action_env.count > env_i; ++env_i )
+        {
+            putenv( _action_env.vars[env_i] );
+        }
+
+        if( 0 > execv( argv[0], argv ) )
+        {
+            DPRINTFE( "Failed to exec command for service (%s), "
+                      "error=%s.", action_data->service_name,
+                      strerror( errno ) );
+        }
+
+        exit( SM_SERVICE_ACTION_PLUGIN_FAILURE );
+    }
+
+    *process_id = pid;
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Action - Run
 // ====================
@@ -648,7 +798,6 @@ SmErrorT sm_service_action_run( char service_name[], char instance_name[],
     bool service_managed = true;
     struct stat stat_data;
     char plugin_exec[SM_SERVICE_ACTION_PLUGIN_EXEC_MAX_CHAR];
-    int result;
     SmServiceActionDataT* action_data;
     SmErrorT error;
 
@@ -721,124 +870,80 @@ SmErrorT sm_service_action_run( char service_name[], char instance_name[],
         }
     }
 
-    pid = fork();
-    if( 0 > pid )
-    {
-        DPRINTFE( "Failed to fork process for service (%s), error=%s.",
-                  action_data->service_name, strerror( errno ) );
-        return( SM_FAILED );
-
-    } else if( 0 == pid ) {
-        // Child process.
-        struct rlimit file_limits;
-
-        DPRINTFD( "Child process created for service (%s).",
-                  action_data->service_name );
-
-        if( 0 > setpgid( 0, 0 ) )
-        {
-            DPRINTFE( "Failed to set process group id for service (%s), "
-                      "error=%s.", action_data->service_name,
-                      strerror( errno ) );
-            exit( SM_SERVICE_ACTION_PLUGIN_FAILURE );
-        }
-
-        if( 0 > getrlimit( RLIMIT_NOFILE, &file_limits ) )
-        {
-            DPRINTFE( "Failed to get file limits for service (%s), "
-                      "error=%s.", action_data->service_name,
-                      strerror( errno ) );
-            exit( SM_SERVICE_ACTION_PLUGIN_FAILURE );
-        }
-
-        unsigned int fd_i;
-        for( fd_i=0; fd_i < file_limits.rlim_cur; ++fd_i )
-        {
-            close( fd_i );
-        }
-
-        if( 0 > open( "/dev/null", O_RDONLY ) )
-        {
-            DPRINTFE( "Failed to open stdin to /dev/null for service (%s), "
-                      "error=%s.", action_data->service_name,
-                      strerror( errno ) );
-        }
-
-        if( 0 > open( "/dev/null", O_WRONLY ) )
-        {
-            DPRINTFE( "Failed to open stdout to /dev/null for service (%s), "
-                      "error=%s.", action_data->service_name, 
-                      strerror( errno ) );
-        }
-
-        if( 0 > open( "/dev/null", O_WRONLY ) )
-        {
-            DPRINTFE( "Failed to open stderr to /dev/null for service (%s), "
-                      "error=%s.", action_data->service_name,
-                      strerror( errno ) );
-        }
-
-        result = setpriority( PRIO_PROCESS, getpid(), -1 );
-        if( 0 > result )
-        {
-            DPRINTFE( "Failed to set priority of process, error=%s.",
-                      strerror( errno ) );
-            exit( SM_SERVICE_ACTION_PLUGIN_FAILURE );
-        }
+#ifdef SM_SERVICE_ACTION_TIME_PLUGIN
+    char time_exec[] = "/usr/bin/time";
+    char time_append[] = "-a";
+    char time_output[] = "-o";
+    char time_file[80];
+    char* argv[] = {time_exec, time_append, time_output, time_file,
+                    plugin_exec, action_data->plugin_command, NULL};
+
+    snprintf( time_file, sizeof(time_file), "/tmp/%s_%s-timing.txt",
+              action_data->service_name, action_data->plugin_command );
+#else
+    char* argv[] = {plugin_exec, action_data->plugin_command, NULL};
+#endif // SM_SERVICE_ACTION_TIME_PLUGIN
 
-        if( !service_managed )
-        {
-            exit( SM_SERVICE_ACTION_PLUGIN_FORCE_SUCCESS );
-        }
+    _action_env.count = 0;
+    _action_env.used = 0;
+    _action_env.vars[0] = NULL;
 
+    if( service_managed )
+    {
         error = sm_service_action_setup_env( instance_name, instance_params,
-                                             action_data );
+                                             action_data, &_action_env );
         if( SM_OKAY != error )
         {
             DPRINTFE( "Failed to setup environment for service (%s), "
                       "error=%s.", action_data->service_name,
                       sm_error_str( error ) );
-            exit( SM_SERVICE_ACTION_PLUGIN_FAILURE );
+            return( error );
         }
+    }
 
-#ifdef SM_SERVICE_ACTION_TIME_PLUGIN
-        char time_exec[] = "/usr/bin/time";
-        char time_append[] = "-a";
-        char time_output[] = "-o";
-        char time_file[80];
-        char* argv[] = {time_exec, time_append, time_output, time_file,
-                        plugin_exec, action_data->plugin_command, NULL};
+    pid = -1;
+
+    if( sm_spawner_available() )
+    {
+        SmSpawnerRequestT request;
 
-        snprintf( time_file, sizeof(time_file), "/tmp/%s_%s-timing.txt",
-                  action_data->service_name, action_data->plugin_command );
+        memset( &request, 0, sizeof(request) );
+        request.argv = argv;
+        request.envp = _action_env.vars;
+        request.cwd = NULL;
+        request.nice = SM_SERVICE_ACTION_NICE;
+        request.force_exit = !service_managed;
+        request.exit_code = SM_SERVICE_ACTION_PLUGIN_FORCE_SUCCESS;
+        request.failure_exit_code = SM_SERVICE_ACTION_PLUGIN_FAILURE;
 
-        if( 0 > execv( time_exec, argv ) )
+        error = sm_spawner_spawn( &request, &pid );
+        if( SM_OKAY != error )
         {
-            DPRINTFE( "Failed to exec command for service (%s), "
-                      "error=%s.", action_data->service_name,
-                      strerror( errno ) );
+            DPRINTFE( "Failed to spawn process for service (%s), forking "
+                      "instead, error=%s.", action_data->service_name,
+                      sm_error_str( error ) );
+            pid = -1;
         }
-#else
-        char* argv[] = {plugin_exec, action_data->plugin_command, NULL};
+    }
 
-        if( 0 > execv( plugin_exec, argv ) )
+    if( 0 > pid )
+    {
+        error = sm_service_action_fork( action_data, argv, service_managed,
+                                        &pid );
+        if( SM_OKAY != error )
         {
-            DPRINTFE( "Failed to exec command for service (%s), "
-                      "error=%s.", action_data->service_name,
-                      strerror( errno ) );
+            return( error );
         }
-#endif // SM_SERVICE_ACTION_TIME_PLUGIN
+    }
 
-        exit( SM_SERVICE_ACTION_PLUGIN_FAILURE );
+    *process_id = (int) pid;
+    *timeout_in_ms = action_data->timeout_in_secs * 1000;
 
-    } else {
-        // Parent process.
-        *process_id = (int) pid;
-        *timeout_in_ms = action_data->timeout_in_secs * 1000;
+    sm_service_action_stats_launched( service_name, action, pid,
+                                      *timeout_in_ms );
 
-        DPRINTFD( "Child process (%i) created for service (%s).", *process_id,
-                  action_data->service_name );
-    }
+    DPRINTFD( "Child process (%i) created for service (%s).", *process_id,
+              action_data->service_name );
 
     return( SM_OKAY );
 }
@@ -867,6 +972,14 @@ SmErrorT sm_service_action_initialize( void )
         return( error );
     }
 
+    error = sm_service_action_stats_initialize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to initialize service action stats, error=%s.",
+                  sm_error_str( error ) );
+        return( error );
+    }
+
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -878,6 +991,13 @@ SmErrorT sm_service_action_finalize( void )
 {
     SmErrorT error;
 
+    error = sm_service_action_stats_finalize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to finalize service action stats, error=%s.",
+                  sm_error_str( error ) );
+    }
+
     error = sm_service_action_result_table_finalize();
     if( SM_OKAY != error )
     {
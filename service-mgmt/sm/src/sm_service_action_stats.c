@@ -0,0 +1,431 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "sm_service_action_stats.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_time.h"
+#include "sm_swact_profiler.h"
+#include "sm_service_plan.h"
+
+#define SM_SERVICE_ACTION_STATS_MAX                                 1024
+#define SM_SERVICE_ACTION_STATS_PENDING_MAX                          256
+#define SM_SERVICE_ACTION_STATS_WINDOW_IN_MS                     3600000
+#define SM_SERVICE_ACTION_STATS_OUTLIER_PERCENT                       50
+
+typedef struct
+{
+    pid_t pid;
+    SmServiceActionStatsT* stats;
+    SmTimeT launched;
+} SmServiceActionStatsPendingT;
+
+static unsigned int _num_stats = 0;
+static SmServiceActionStatsT _stats[SM_SERVICE_ACTION_STATS_MAX];
+static SmServiceActionStatsPendingT _pending[SM_SERVICE_ACTION_STATS_PENDING_MAX];
+static uint64_t _untracked_exits = 0;
+
+// ****************************************************************************
+// Service Action Stats - Read
+// ===========================
+SmServiceActionStatsT* sm_service_action_stats_read( const char service_name[],
+    SmServiceActionT action )
+{
+    SmServiceActionStatsT* stats;
+
+    unsigned int stats_i;
+    for( stats_i=0; _num_stats > stats_i; ++stats_i )
+    {
+        stats = &(_stats[stats_i]);
+
+        if(( action == stats->action )&&
+           ( 0 == strcmp( service_name, stats->service_name ) ))
+        {
+            return( stats );
+        }
+    }
+
+    return( NULL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Find
+// ===========================
+static SmServiceActionStatsT* sm_service_action_stats_find(
+    char service_name[], SmServiceActionT action )
+{
+    SmServiceActionStatsT* stats;
+
+    stats = sm_service_action_stats_read( service_name, action );
+    if( NULL != stats )
+    {
+        return( stats );
+    }
+
+    if( SM_SERVICE_ACTION_STATS_MAX <= _num_stats )
+    {
+        return( NULL );
+    }
+
+    stats = &(_stats[_num_stats++]);
+    memset( stats, 0, sizeof(SmServiceActionStatsT) );
+    snprintf( stats->service_name, sizeof(stats->service_name), "%s",
+              service_name );
+    stats->action = action;
+    sm_time_get( &(stats->window_start) );
+
+    return( stats );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Launched
+// ===============================
+void sm_service_action_stats_launched( char service_name[],
+    SmServiceActionT action, pid_t pid, int timeout_in_ms )
+{
+    SmServiceActionStatsT* stats;
+    SmServiceActionStatsPendingT* pending = NULL;
+
+    stats = sm_service_action_stats_find( service_name, action );
+    if( NULL == stats )
+    {
+        DPRINTFD( "No room for service (%s) action (%s) stats.",
+                  service_name, sm_service_action_str( action ) );
+        return;
+    }
+
+    stats->timeout_in_ms = timeout_in_ms;
+
+    unsigned int pending_i;
+    for( pending_i=0; SM_SERVICE_ACTION_STATS_PENDING_MAX > pending_i;
+         ++pending_i )
+    {
+        if(( 0 >= _pending[pending_i].pid )||( pid == _pending[pending_i].pid ))
+        {
+            pending = &(_pending[pending_i]);
+            break;
+        }
+    }
+
+    if( NULL == pending )
+    {
+        DPRINTFD( "Too many actions pending, service (%s) action (%s) not "
+                  "tracked.", service_name, sm_service_action_str( action ) );
+        return;
+    }
+
+    pending->pid = pid;
+    pending->stats = stats;
+    sm_time_get( &(pending->launched) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Roll Windows
+// ===================================
+// Moves the windows on by the number of windows elapsed, the current
+// window becomes the previous one after one window and both are cleared
+// after two or more.
+static void sm_service_action_stats_roll( SmServiceActionStatsT* stats )
+{
+    long elapsed_ms = sm_time_get_elapsed_ms( &(stats->window_start) );
+    long windows = elapsed_ms / SM_SERVICE_ACTION_STATS_WINDOW_IN_MS;
+    long advance_ms;
+
+    if( 0 >= windows )
+    {
+        return;
+    }
+
+    if( 1 == windows )
+    {
+        memcpy( stats->wall_previous, stats->wall_current,
+                sizeof(stats->wall_previous) );
+    } else {
+        memset( stats->wall_previous, 0, sizeof(stats->wall_previous) );
+    }
+
+    memset( stats->wall_current, 0, sizeof(stats->wall_current) );
+
+    // Windows stay aligned to when the stats were created.
+    advance_ms = windows * SM_SERVICE_ACTION_STATS_WINDOW_IN_MS;
+    stats->window_start.tv_sec += advance_ms / 1000;
+    stats->window_start.tv_nsec += (advance_ms % 1000) * 1000000;
+    if( 1000000000 <= stats->window_start.tv_nsec )
+    {
+        stats->window_start.tv_sec++;
+        stats->window_start.tv_nsec -= 1000000000;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Record Wall Time
+// =======================================
+static void sm_service_action_stats_record_wall( SmServiceActionStatsT* stats,
+    long wall_ms )
+{
+    unsigned int bucket_i = 0;
+
+    sm_service_action_stats_roll( stats );
+
+    while(( (SM_SERVICE_ACTION_STATS_BUCKETS-1) > bucket_i )&&
+          ( (1L << bucket_i) <= wall_ms ))
+    {
+        ++bucket_i;
+    }
+
+    stats->wall_current[bucket_i]++;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Exited
+// =============================
+void sm_service_action_stats_exited( pid_t pid, int exit_code,
+    const struct rusage* usage )
+{
+    SmServiceActionStatsT* stats;
+    SmServiceActionStatsPendingT* pending = NULL;
+    long wall_ms, user_us = 0, system_us = 0, max_rss_kb = 0;
+    long major_faults = 0;
+
+    unsigned int pending_i;
+    for( pending_i=0; SM_SERVICE_ACTION_STATS_PENDING_MAX > pending_i;
+         ++pending_i )
+    {
+        if( pid == _pending[pending_i].pid )
+        {
+            pending = &(_pending[pending_i]);
+            break;
+        }
+    }
+
+    if( NULL == pending )
+    {
+        ++_untracked_exits;
+        return;
+    }
+
+    stats = pending->stats;
+    wall_ms = sm_time_get_elapsed_ms( &(pending->launched) );
+
+    sm_swact_profiler_action( stats->service_name, stats->action,
+                              &(pending->launched), exit_code );
+
+    pending->pid = 0;
+    pending->stats = NULL;
+
+    if( NULL != usage )
+    {
+        user_us = usage->ru_utime.tv_sec * 1000000 + usage->ru_utime.tv_usec;
+        system_us = usage->ru_stime.tv_sec * 1000000 + usage->ru_stime.tv_usec;
+        max_rss_kb = usage->ru_maxrss;
+        major_faults = usage->ru_majflt;
+    }
+
+    stats->count++;
+    if( 0 != exit_code )
+    {
+        stats->failed++;
+    }
+
+    stats->wall_last_ms = wall_ms;
+    stats->wall_total_ms += wall_ms;
+    if( wall_ms > stats->wall_max_ms )
+    {
+        stats->wall_max_ms = wall_ms;
+    }
+
+    stats->user_total_us += user_us;
+    stats->system_total_us += system_us;
+    if( user_us > stats->user_max_us )
+    {
+        stats->user_max_us = user_us;
+    }
+    if( system_us > stats->system_max_us )
+    {
+        stats->system_max_us = system_us;
+    }
+    if( max_rss_kb > stats->max_rss_kb )
+    {
+        stats->max_rss_kb = max_rss_kb;
+    }
+
+    stats->major_faults_total += major_faults;
+    if( major_faults > stats->major_faults_max )
+    {
+        stats->major_faults_max = major_faults;
+    }
+
+    sm_service_action_stats_record_wall( stats, wall_ms );
+
+    if(( SM_SERVICE_ACTION_ENABLE == stats->action )||
+       ( SM_SERVICE_ACTION_GO_ACTIVE == stats->action ))
+    {
+        sm_service_plan_invalidate();
+    }
+
+    if(( 0 < stats->timeout_in_ms )&&
+       ( wall_ms * 100 >= (long) stats->timeout_in_ms
+                          * SM_SERVICE_ACTION_STATS_OUTLIER_PERCENT ))
+    {
+        stats->outliers++;
+
+        DPRINTFI( "Service (%s) action (%s) took %li ms of its %i ms "
+                  "timeout, exit_code=%i, user=%li us, system=%li us, "
+                  "max_rss=%li kB, major_faults=%li.", stats->service_name,
+                  sm_service_action_str( stats->action ), wall_ms,
+                  stats->timeout_in_ms, exit_code, user_us, system_us,
+                  max_rss_kb, major_faults );
+    } else {
+        DPRINTFD( "Service (%s) action (%s) took %li ms, exit_code=%i, "
+                  "user=%li us, system=%li us, max_rss=%li kB, "
+                  "major_faults=%li.", stats->service_name,
+                  sm_service_action_str( stats->action ), wall_ms,
+                  exit_code, user_us, system_us, max_rss_kb, major_faults );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Percentile
+// =================================
+long sm_service_action_stats_percentile_ms( SmServiceActionStatsT* stats,
+    unsigned int percent )
+{
+    uint64_t total = 0;
+    uint64_t seen = 0;
+
+    sm_service_action_stats_roll( stats );
+
+    unsigned int bucket_i;
+    for( bucket_i=0; SM_SERVICE_ACTION_STATS_BUCKETS > bucket_i; ++bucket_i )
+    {
+        total += stats->wall_current[bucket_i] + stats->wall_previous[bucket_i];
+    }
+
+    if( 0 == total )
+    {
+        return( 0 );
+    }
+
+    for( bucket_i=0; SM_SERVICE_ACTION_STATS_BUCKETS > bucket_i; ++bucket_i )
+    {
+        seen += stats->wall_current[bucket_i] + stats->wall_previous[bucket_i];
+
+        if( seen * 100 >= total * percent )
+        {
+            break;
+        }
+    }
+
+    if( SM_SERVICE_ACTION_STATS_BUCKETS <= bucket_i + 1 )
+    {
+        return( stats->wall_max_ms );
+    }
+
+    return( 1L << bucket_i );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - For Each
+// ===============================
+void sm_service_action_stats_foreach( const char service_name[],
+    void* user_data[], SmServiceActionStatsForEachCallbackT callback )
+{
+    unsigned int stats_i;
+    for( stats_i=0; _num_stats > stats_i; ++stats_i )
+    {
+        if(( NULL != service_name )&&( '\0' != service_name[0] )&&
+           ( 0 != strcmp( service_name, _stats[stats_i].service_name ) ))
+            continue;
+
+        callback( user_data, &(_stats[stats_i]) );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Dump Data
+// ================================
+static void sm_service_action_stats_dump( void* user_data[],
+    SmServiceActionStatsT* stats )
+{
+    FILE* log = (FILE*) user_data[0];
+
+    if( 0 == stats->count )
+    {
+        return;
+    }
+
+    fprintf( log, "  %-32s %-12s count=%u failed=%u outliers=%u "
+             "timeout_ms=%i\n", stats->service_name,
+             sm_service_action_str( stats->action ), stats->count,
+             stats->failed, stats->outliers, stats->timeout_in_ms );
+    fprintf( log, "      wall_ms: last=%li avg=%" PRIu64 " p50<=%li "
+             "p95<=%li max=%li\n", stats->wall_last_ms,
+             stats->wall_total_ms / stats->count,
+             sm_service_action_stats_percentile_ms( stats, 50 ),
+             sm_service_action_stats_percentile_ms( stats, 95 ),
+             stats->wall_max_ms );
+    fprintf( log, "      cpu_us: user_avg=%" PRIu64 " user_max=%li "
+             "system_avg=%" PRIu64 " system_max=%li\n",
+             stats->user_total_us / stats->count, stats->user_max_us,
+             stats->system_total_us / stats->count, stats->system_max_us );
+    fprintf( log, "      max_rss_kb=%li major_faults_avg=%" PRIu64
+             " major_faults_max=%li\n", stats->max_rss_kb,
+             stats->major_faults_total / stats->count,
+             stats->major_faults_max );
+}
+
+void sm_service_action_stats_dump_data( FILE* log )
+{
+    void* user_data[] = {log};
+
+    fprintf( log, "--------------------------------------------------------------------\n" );
+    fprintf( log, "SERVICE ACTION STATS DATA\n" );
+    fprintf( log, "  untracked_exits..............................%" PRIu64 "\n", _untracked_exits );
+    sm_service_action_stats_foreach( NULL, user_data,
+                                     sm_service_action_stats_dump );
+    fprintf( log, "--------------------------------------------------------------------\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Initialize
+// =================================
+SmErrorT sm_service_action_stats_initialize( void )
+{
+    _num_stats = 0;
+    _untracked_exits = 0;
+    memset( _stats, 0, sizeof(_stats) );
+    memset( _pending, 0, sizeof(_pending) );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Finalize
+// ===============================
+SmErrorT sm_service_action_stats_finalize( void )
+{
+    _num_stats = 0;
+    memset( _pending, 0, sizeof(_pending) );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __SM_SERVICE_ACTION_STATS_H__
+#define __SM_SERVICE_ACTION_STATS_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/resource.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+#include "sm_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bucket i holds wall times below 2^i ms.
+#define SM_SERVICE_ACTION_STATS_BUCKETS                               20
+
+typedef struct
+{
+    char service_name[SM_SERVICE_NAME_MAX_CHAR];
+    SmServiceActionT action;
+    int timeout_in_ms;
+    unsigned int count;
+    unsigned int failed;
+    unsigned int outliers;
+    long wall_last_ms;
+    long wall_max_ms;
+    uint64_t wall_total_ms;
+    uint64_t user_total_us;
+    uint64_t system_total_us;
+    long user_max_us;
+    long system_max_us;
+    long max_rss_kb;
+    uint64_t major_faults_total;
+    long major_faults_max;
+    SmTimeT window_start;
+    uint32_t wall_current[SM_SERVICE_ACTION_STATS_BUCKETS];
+    uint32_t wall_previous[SM_SERVICE_ACTION_STATS_BUCKETS];
+} SmServiceActionStatsT;
+
+typedef void (*SmServiceActionStatsForEachCallbackT) (void* user_data[],
+        SmServiceActionStatsT* stats);
+
+// ****************************************************************************
+// Service Action Stats - Launched
+// ===============================
+extern void sm_service_action_stats_launched( char service_name[],
+    SmServiceActionT action, pid_t pid, int timeout_in_ms );
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Exited
+// =============================
+// Called by the reapers, usage may be NULL when it is not known.
+extern void sm_service_action_stats_exited( pid_t pid, int exit_code,
+    const struct rusage* usage );
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Read
+// ===========================
+// Returns NULL when the action has not been launched yet.
+extern SmServiceActionStatsT* sm_service_action_stats_read(
+    const char service_name[], SmServiceActionT action );
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Percentile
+// =================================
+// Upper bound in ms of the given percentile of the rolling wall times.
+extern long sm_service_action_stats_percentile_ms(
+    SmServiceActionStatsT* stats, unsigned int percent );
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - For Each
+// ===============================
+// A NULL or empty service name walks all services.
+extern void sm_service_action_stats_foreach( const char service_name[],
+    void* user_data[], SmServiceActionStatsForEachCallbackT callback );
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Dump Data
+// ================================
+extern void sm_service_action_stats_dump_data( FILE* log );
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Initialize
+// =================================
+extern SmErrorT sm_service_action_stats_initialize( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Action Stats - Finalize
+// ===============================
+extern SmErrorT sm_service_action_stats_finalize( void );
+// ****************************************************************************
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SM_SERVICE_ACTION_STATS_H__
@@ -15,6 +15,7 @@
 #include "sm_service_table.h"
 #include "sm_service_dependency.h"
 #include "sm_service_engine.h"
+#include "sm_service_plan.h"
 #include "sm_service_fsm.h"
 #include "sm_service_go_active.h"
 #include "sm_service_go_standby.h"
@@ -406,6 +407,14 @@ SmErrorT sm_service_api_initialize( void )
         return( error );
     }
 
+    error = sm_service_plan_initialize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to initialize service plan, error=%s.",
+                  sm_error_str( error ) );
+        return( error );
+    }
+
     error = sm_service_engine_initialize();
     if( SM_OKAY != error )
     {
@@ -462,6 +471,13 @@ SmErrorT sm_service_api_finalize( void )
                   sm_error_str( error ) );
     }
 
+    error = sm_service_plan_finalize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to finalize service plan, error=%s.",
+                  sm_error_str( error ) );
+    }
+
     error = sm_service_dependency_finalize();
     if( SM_OKAY != error )
     {
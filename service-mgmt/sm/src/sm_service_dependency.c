@@ -14,6 +14,7 @@
 #include "sm_service_table.h"
 #include "sm_service_dependency_table.h"
 #include "sm_service_domain_member_table.h"
+#include "sm_swact_profiler.h"
 
 // ****************************************************************************
 // Service Dependency - Dependent State Compare
@@ -64,6 +65,8 @@ static void sm_service_dependency_dependent_state_compare(
                       service_dependency->dependent, service->name,
                       sm_service_state_str(dependent_service->state),
                       sm_service_state_str(service_dependency->dependent_state) );
+            sm_swact_profiler_dependency_unmet( service->name,
+                                                service_dependency->dependent );
             *met = false;
         }
     } else if( SM_COMPARE_OPERATOR_GE == compare_operator )
@@ -82,6 +85,8 @@ static void sm_service_dependency_dependent_state_compare(
                       service_dependency->dependent, service->name,
                       sm_service_state_str(dependent_service->state),
                       sm_service_state_str(service_dependency->dependent_state) );
+            sm_swact_profiler_dependency_unmet( service->name,
+                                                service_dependency->dependent );
             *met = false;
         }
     } else {
@@ -19,6 +19,7 @@
 
 static SmListT* _service_domain_assignments = NULL;
 static SmDbHandleT* _sm_db_handle = NULL;
+static unsigned int _generation = 0;
 
 // ****************************************************************************
 // Service Domain Assignment Table - Read
@@ -396,9 +397,12 @@ static SmErrorT sm_service_domain_assignment_table_add( void* user_data[],
         assignment->sched_list = SM_SERVICE_DOMAIN_SCHEDULING_LIST_NIL;
         assignment->reason_text[0] = '\0';
         assignment->exchanged = false;
+        assignment->weight_node_index = -1;
+        assignment->weight_generation = 0;
 
         SM_LIST_PREPEND( _service_domain_assignments,
                          (SmListEntryDataPtrT) assignment );
+        ++_generation;
     } else { 
         assignment->id = db_assignment->id;
         snprintf( assignment->uuid, sizeof(assignment->uuid), 
@@ -485,14 +489,26 @@ SmErrorT sm_service_domain_assignment_table_insert( char name[],
     snprintf( assignment->reason_text, sizeof(assignment->reason_text),
               "%s", reason_text );
     assignment->exchanged = false;
+    assignment->weight_node_index = -1;
+    assignment->weight_generation = 0;
 
     SM_LIST_PREPEND( _service_domain_assignments,
                  (SmListEntryDataPtrT) assignment );
+    ++_generation;
 
     return( SM_OKAY );
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Domain Assignment Table - Generation
+// ============================================
+unsigned int sm_service_domain_assignment_table_generation( void )
+{
+    return( _generation );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Domain Assignment Table - Delete
 // ========================================
@@ -518,6 +534,7 @@ SmErrorT sm_service_domain_assignment_table_delete( char name[],
 
         SM_LIST_REMOVE( _service_domain_assignments,
                         (SmListEntryDataPtrT) assignment );
+        ++_generation;
     }
 
     return( SM_OKAY );
@@ -624,6 +641,7 @@ SmErrorT sm_service_domain_assignment_table_finalize( void )
     SmErrorT error;
 
     SM_LIST_CLEANUP_ALL( _service_domain_assignments );
+    ++_generation;
 
     if( NULL != _sm_db_handle )
     {
@@ -34,6 +34,8 @@ typedef struct
     SmServiceDomainSchedulingListT sched_list;
     char reason_text[SM_SERVICE_GROUP_REASON_TEXT_MAX_CHAR];
     bool exchanged;
+    int weight_node_index;
+    unsigned int weight_generation;
 } SmServiceDomainAssignmentT;
 
 typedef int (*SmServiceDomainAssignmentTableCompareCallbackT)
@@ -149,6 +151,13 @@ extern SmErrorT sm_service_domain_assignment_table_insert( char name[],
     int64_t health, long last_state_change, const char reason_text[] );
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Domain Assignment Table - Generation
+// ============================================
+// Changes whenever assignments are added to or removed from the table.
+extern unsigned int sm_service_domain_assignment_table_generation( void );
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Domain Assignment Table - Delete
 // ========================================
@@ -30,6 +30,7 @@
 #include "sm_service_domain_weight.h"
 #include "sm_alarm.h"
 #include "sm_log.h"
+#include "sm_failover.h"
 
 #define SM_SERVICE_DOMAIN_SCHEDULE_INTERVAL_IN_MS    3000
 
@@ -37,6 +38,26 @@ static SmDbHandleT* _sm_db_handle = NULL;
 static SmTimerIdT _scheduler_timer_id = SM_TIMER_ID_INVALID;
 static SmMsgCallbacksT _msg_callbacks = {0};
 
+typedef enum
+{
+    SM_SERVICE_DOMAIN_SCHEDULER_STAGE_PRESELECT,
+    SM_SERVICE_DOMAIN_SCHEDULER_STAGE_WEIGHT,
+    SM_SERVICE_DOMAIN_SCHEDULER_STAGE_STATE,
+    SM_SERVICE_DOMAIN_SCHEDULER_STAGE_ACTIVE,
+    SM_SERVICE_DOMAIN_SCHEDULER_STAGE_STANDBY,
+    SM_SERVICE_DOMAIN_SCHEDULER_STAGE_POST_SELECT,
+    SM_SERVICE_DOMAIN_SCHEDULER_STAGE_APPLY,
+    SM_SERVICE_DOMAIN_SCHEDULER_STAGE_MAX
+} SmServiceDomainSchedulerStageT;
+
+typedef struct
+{
+    int evaluated;
+    int filters;
+    int changed;
+    long stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_MAX];
+} SmServiceDomainSchedulerPassT;
+
 // ****************************************************************************
 // Service Domain Scheduler - Set Scheduling State
 // ===============================================
@@ -792,6 +813,7 @@ static void sm_service_domain_scheduler_apply_change( void* user_data[],
 
         assignment->desired_state = desired_state;
         assignment->last_state_change = (long) ts.tv_sec;
+        ++(*(int*) user_data[0]);
 
         error = sm_service_domain_assignment_table_persist( assignment );
         if( SM_OKAY != error )
@@ -802,6 +824,8 @@ static void sm_service_domain_scheduler_apply_change( void* user_data[],
                       assignment->node_name, sm_error_str( error ) );
             return;
         }
+
+        sm_failover_signal( SM_FAILOVER_TRIGGER_CONTROLLER_STATE );
     } else {
         SCHED_LOG( assignment->name, "No update of desired state (%s) "
                    "for member (%s) of node (%s) current_state=%s, " 
@@ -945,10 +969,12 @@ static void sm_service_domain_scheduler_apply_change( void* user_data[],
 // Service Domain Scheduler - Apply Changes
 // ========================================
 static SmErrorT sm_service_domain_scheduler_apply_changes( 
-    char service_domain_name[] )
+    char service_domain_name[], int* changed )
 {
-    sm_service_domain_assignment_table_foreach( service_domain_name, NULL,
-                                    sm_service_domain_scheduler_apply_change );
+    void* user_data[] = {changed};
+
+    sm_service_domain_assignment_table_foreach( service_domain_name,
+                        user_data, sm_service_domain_scheduler_apply_change );
 
     return( SM_OKAY );
 }
@@ -1014,19 +1040,38 @@ static void sm_service_domain_scheduler_dump( SmServiceDomainT* domain )
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Domain Scheduler - Stage Time
+// =====================================
+// Returns the microseconds since start and moves start to now.
+static long sm_service_domain_scheduler_stage_time( struct timespec* start )
+{
+    struct timespec now;
+    long elapsed_us;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    elapsed_us = (long) ( (now.tv_sec - start->tv_sec) * 1000000
+                        + (now.tv_nsec - start->tv_nsec) / 1000 );
+    *start = now;
+
+    return( elapsed_us );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Domain Scheduler - Schedule
 // ===================================
-static SmErrorT sm_service_domain_scheduler_schedule( SmServiceDomainT* domain )
+static SmErrorT sm_service_domain_scheduler_schedule( SmServiceDomainT* domain,
+    SmServiceDomainSchedulerPassT* pass )
 {
-    long ms_expired;
-    SmTimeT time_prev, time_now;
+    struct timespec stage_start;
     bool removing_activity;
     SmServiceDomainFilterCountsT filter_counts;
     SmErrorT error;
 
     // Apply Preselect Filters.
-    sm_time_get( &time_prev );
+    clock_gettime( CLOCK_MONOTONIC, &stage_start );
 
     error = sm_service_domain_filter_preselect_apply( domain->name,
                                                       &filter_counts );
@@ -1037,10 +1082,10 @@ static SmErrorT sm_service_domain_scheduler_schedule( SmServiceDomainT* domain )
         return( error );
     }
 
-    sm_time_get( &time_now );
-    ms_expired = sm_time_delta_in_ms( &time_now, &time_prev );
-    DPRINTFD( "Scheduler execute - preselect apply filters, took %li ms.",
-              ms_expired );
+    pass->stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_PRESELECT]
+        = sm_service_domain_scheduler_stage_time( &stage_start );
+    pass->evaluated = filter_counts.total_members;
+    ++(pass->filters);
 
     SCHED_LOG( domain->name, "Filter counts: active(%i) go-active(%i) "
                "standby(%i) go-standby(%i) disabling(%i) disabled (%i) "
@@ -1052,8 +1097,6 @@ static SmErrorT sm_service_domain_scheduler_schedule( SmServiceDomainT* domain )
                filter_counts.unavailable_members, filter_counts.total_members );
 
     // Apply Weights.
-    sm_time_get( &time_prev );
-
     error = sm_service_domain_weight_apply( domain->name );
     if( SM_OKAY != error )
     {
@@ -1062,13 +1105,10 @@ static SmErrorT sm_service_domain_scheduler_schedule( SmServiceDomainT* domain )
         return( error );
     }
 
-    sm_time_get( &time_now );
-    ms_expired = sm_time_delta_in_ms( &time_now, &time_prev );
-    DPRINTFD( "Scheduler execute - apply weights, took %li ms.", ms_expired );
+    pass->stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_WEIGHT]
+        = sm_service_domain_scheduler_stage_time( &stage_start );
 
     // Update scheduling states.
-    sm_time_get( &time_prev );
-
     error = sm_service_domain_scheduler_update_state( domain,
                                                       &removing_activity );
     if( SM_OKAY != error )
@@ -1078,14 +1118,10 @@ static SmErrorT sm_service_domain_scheduler_schedule( SmServiceDomainT* domain )
         return( error );
     }
 
-    sm_time_get( &time_now );
-    ms_expired = sm_time_delta_in_ms( &time_now, &time_prev );
-    DPRINTFD( "Scheduler execute - update scheduling states, took %li ms.",
-              ms_expired );
+    pass->stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_STATE]
+        = sm_service_domain_scheduler_stage_time( &stage_start );
 
     // Select Active.
-    sm_time_get( &time_prev );
-
     if( removing_activity )
     {
         SCHED_LOG( domain->name, "Removing activity, active selection "
@@ -1100,13 +1136,10 @@ static SmErrorT sm_service_domain_scheduler_schedule( SmServiceDomainT* domain )
         }
     }
 
-    sm_time_get( &time_now );
-    ms_expired = sm_time_delta_in_ms( &time_now, &time_prev );
-    DPRINTFD( "Scheduler execute - select active, took %li ms.", ms_expired );
+    pass->stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_ACTIVE]
+        = sm_service_domain_scheduler_stage_time( &stage_start );
 
     // Select Standby.
-    sm_time_get( &time_prev );
-
     error = sm_service_domain_scheduler_select_standby( domain );
     if( SM_OKAY != error )
     {
@@ -1115,13 +1148,10 @@ static SmErrorT sm_service_domain_scheduler_schedule( SmServiceDomainT* domain )
         return( error );
     }
 
-    sm_time_get( &time_now );
-    ms_expired = sm_time_delta_in_ms( &time_now, &time_prev );
-    DPRINTFD( "Scheduler execute - select standby, took %li ms.", ms_expired );
+    pass->stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_STANDBY]
+        = sm_service_domain_scheduler_stage_time( &stage_start );
 
     // Apply Post Select Filters.
-    sm_time_get( &time_prev );
-
     error = sm_service_domain_filter_post_select_apply( domain->name,
                                                         &filter_counts );
     if( SM_OKAY != error )
@@ -1131,10 +1161,9 @@ static SmErrorT sm_service_domain_scheduler_schedule( SmServiceDomainT* domain )
         return( error );
     }
 
-    sm_time_get( &time_now );
-    ms_expired = sm_time_delta_in_ms( &time_now, &time_prev );
-    DPRINTFD( "Scheduler execute - post select apply filters, took %li ms.",
-              ms_expired );
+    pass->stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_POST_SELECT]
+        = sm_service_domain_scheduler_stage_time( &stage_start );
+    ++(pass->filters);
 
     SCHED_LOG( domain->name, "Filter counts: active(%i) go-active(%i) "
                "standby(%i) go-standby(%i) disabling(%i) disabled (%i) "
@@ -1148,9 +1177,10 @@ static SmErrorT sm_service_domain_scheduler_schedule( SmServiceDomainT* domain )
     sm_service_domain_scheduler_dump( domain );
 
     // Apply Changes.
-    sm_time_get( &time_prev );
+    clock_gettime( CLOCK_MONOTONIC, &stage_start );
 
-    error = sm_service_domain_scheduler_apply_changes( domain->name );
+    error = sm_service_domain_scheduler_apply_changes( domain->name,
+                                                       &(pass->changed) );
     if( SM_OKAY != error )
     {
         DPRINTFE( "Service domain (%s) apply changes failed, error=%s.",
@@ -1158,9 +1188,8 @@ static SmErrorT sm_service_domain_scheduler_schedule( SmServiceDomainT* domain )
         return( error );
     }
 
-    sm_time_get( &time_now );
-    ms_expired = sm_time_delta_in_ms( &time_now, &time_prev );
-    DPRINTFD( "Scheduler execute - apply changes, took %li ms.", ms_expired );
+    pass->stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_APPLY]
+        = sm_service_domain_scheduler_stage_time( &stage_start );
 
     return( SM_OKAY );
 }
@@ -1393,8 +1422,13 @@ void sm_service_domain_scheduler_schedule_service_domain(
     SmServiceDomainT* domain )
 {
     bool syncing;
+    struct timespec pass_start;
+    SmServiceDomainSchedulerPassT pass;
     SmErrorT error;
 
+    memset( &pass, 0, sizeof(pass) );
+    clock_gettime( CLOCK_MONOTONIC, &pass_start );
+
     SCHED_LOG_START( domain->name, "--start------------------------------" );
     SCHED_LOG( domain->name, "%s.",
                sm_service_domain_state_str(domain->state) );
@@ -1419,7 +1453,7 @@ void sm_service_domain_scheduler_schedule_service_domain(
             goto DONE;
         }
 
-        error = sm_service_domain_scheduler_schedule( domain );
+        error = sm_service_domain_scheduler_schedule( domain, &pass );
         if( SM_OKAY != error )
         {
             DPRINTFE( "Failed to schedule service domain (%s), error=%s.",
@@ -1448,6 +1482,19 @@ void sm_service_domain_scheduler_schedule_service_domain(
 
 DONE:
     SCHED_LOG_DONE( domain->name, "--complete---------------------------" );
+    SCHED_LOG_PASS( domain->name, "pass took %li us, evaluated=%i, "
+                    "filters=%i, changed=%i, stages(preselect=%li "
+                    "weight=%li state=%li active=%li standby=%li "
+                    "post-select=%li apply=%li)",
+                    sm_service_domain_scheduler_stage_time( &pass_start ),
+                    pass.evaluated, pass.filters, pass.changed,
+                    pass.stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_PRESELECT],
+                    pass.stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_WEIGHT],
+                    pass.stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_STATE],
+                    pass.stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_ACTIVE],
+                    pass.stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_STANDBY],
+                    pass.stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_POST_SELECT],
+                    pass.stage_us[SM_SERVICE_DOMAIN_SCHEDULER_STAGE_APPLY] );
 }
 // ****************************************************************************
 
@@ -6,6 +6,10 @@
 #include "sm_service_domain_weight.h"
 
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
 
 #include "sm_limits.h"
 #include "sm_types.h"
@@ -16,6 +20,24 @@
 #include "sm_db_nodes.h"
 #include "sm_service_domain_assignment_table.h"
 
+typedef struct
+{
+    char name[SM_NODE_NAME_MAX_CHAR];
+    SmNodeAdminStateT admin_state;
+    SmNodeAvailStatusT avail_status;
+} SmServiceDomainWeightNodeT;
+
+static bool _nodes_loaded = false;
+static unsigned int _nodes_db_generation = 0;
+static unsigned int _nodes_count = 0;
+static SmServiceDomainWeightNodeT _nodes[SM_NODE_MAX];
+static unsigned int _assignment_generation = 0;
+static unsigned int _weight_generation = 1;
+static uint64_t _applies = 0;
+static uint64_t _apply_us = 0;
+static uint64_t _node_model_loads = 0;
+static uint64_t _pair_recomputes = 0;
+
 // ****************************************************************************
 // Service Domain Weight - Cleanup
 // ===============================
@@ -85,13 +107,141 @@ static void sm_service_domain_weight_assignments( void* user_data[],
 // ****************************************************************************
 
 // ****************************************************************************
-// Service Domain Weight -  Add Location
-// =====================================
-static void sm_service_domain_weight_add_location( void* user_data[],
+// Service Domain Weight - Node Model Add
+// ======================================
+static SmErrorT sm_service_domain_weight_node_model_add( void* user_data[],
+    void* record )
+{
+    SmServiceDomainWeightNodeT* nodes = (SmServiceDomainWeightNodeT*) user_data[0];
+    unsigned int* nodes_count = (unsigned int*) user_data[1];
+    SmDbNodeT* node = (SmDbNodeT*) record;
+
+    if( SM_NODE_MAX <= *nodes_count )
+    {
+        DPRINTFE( "No space for node (%s) in weight node model.", node->name );
+        return( SM_OKAY );
+    }
+
+    snprintf( nodes[*nodes_count].name, sizeof(nodes[*nodes_count].name),
+              "%s", node->name );
+    nodes[*nodes_count].admin_state = node->admin_state;
+    nodes[*nodes_count].avail_status = node->avail_status;
+    ++(*nodes_count);
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Domain Weight - Invalidate
+// ==================================
+static void sm_service_domain_weight_invalidate( void )
+{
+    // Assignments start at zero, so zero is never a valid generation.
+    if( 0 == ++_weight_generation )
+    {
+        ++_weight_generation;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Domain Weight - Refresh
+// ===============================
+// Reloads the node model only after a node was written, the cached node of
+// each assignment is kept unless the node order or assignments changed.
+static SmErrorT sm_service_domain_weight_refresh( void )
+{
+    unsigned int nodes_count = 0;
+    unsigned int db_generation = sm_db_nodes_generation();
+    unsigned int assignment_generation
+        = sm_service_domain_assignment_table_generation();
+    SmServiceDomainWeightNodeT nodes[SM_NODE_MAX];
+    SmDbNodeT node;
+    void* user_data[] = { nodes, &nodes_count };
+    SmErrorT error;
+
+    if( assignment_generation != _assignment_generation )
+    {
+        _assignment_generation = assignment_generation;
+        sm_service_domain_weight_invalidate();
+    }
+
+    if(( _nodes_loaded )&&( db_generation == _nodes_db_generation ))
+    {
+        return( SM_OKAY );
+    }
+
+    error = sm_db_foreach( SM_DATABASE_NAME, SM_NODES_TABLE_NAME,
+                           NULL, &node, &sm_db_nodes_convert,
+                           sm_service_domain_weight_node_model_add,
+                           user_data );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to loop over nodes, error=%s.",
+                  sm_error_str( error ) );
+        return( error );
+    }
+
+    ++_node_model_loads;
+
+    bool reordered = ( nodes_count != _nodes_count );
+
+    unsigned int node_i;
+    for( node_i=0; !reordered && nodes_count > node_i; ++node_i )
+    {
+        reordered = ( 0 != strcmp( nodes[node_i].name, _nodes[node_i].name ) );
+    }
+
+    memcpy( _nodes, nodes, sizeof(SmServiceDomainWeightNodeT)*nodes_count );
+    _nodes_count = nodes_count;
+    _nodes_db_generation = db_generation;
+    _nodes_loaded = true;
+
+    if( reordered )
+    {
+        sm_service_domain_weight_invalidate();
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Domain Weight - Node
+// ============================
+static void sm_service_domain_weight_node(
     SmServiceDomainAssignmentT* assignment )
 {
-    int weight_multipler = *(int*) user_data[0];
-    SmDbNodeT* node = (SmDbNodeT*) user_data[1];
+    SmServiceDomainWeightNodeT* node;
+
+    if( _weight_generation != assignment->weight_generation )
+    {
+        assignment->weight_node_index = -1;
+
+        unsigned int node_i;
+        for( node_i=0; _nodes_count > node_i; ++node_i )
+        {
+            if( 0 == strcmp( assignment->node_name, _nodes[node_i].name ) )
+            {
+                assignment->weight_node_index = (int) node_i;
+                break;
+            }
+        }
+
+        assignment->weight_generation = _weight_generation;
+        ++_pair_recomputes;
+    }
+
+    if( 0 > assignment->weight_node_index )
+    {
+        return;
+    }
+
+    node = &(_nodes[assignment->weight_node_index]);
+
+    // Location, nodes earlier in the table weigh less.
+    int weight_multipler = assignment->weight_node_index + 1;
 
 #ifdef SM_CONFIG_OPTION_STANDBY_ALL_SERVICES_ON_A_LOCKED_NODE
     if( SM_NODE_ADMIN_STATE_LOCKED == node->admin_state )
@@ -106,17 +256,8 @@ static void sm_service_domain_weight_add_location( void* user_data[],
 #else
     assignment->sched_weight += weight_multipler * 100;
 #endif // SM_CONFIG_OPTION_STANDBY_ALL_SERVICES_ON_A_LOCKED_NODE
-}
-// ****************************************************************************
-
-// ****************************************************************************
-// Service Domain Weight -  Add Location
-// =====================================
-static void sm_service_domain_weight_check_availability( void* user_data[],
-    SmServiceDomainAssignmentT* assignment )
-{
-    SmDbNodeT* node = (SmDbNodeT*) user_data[0];
 
+    // Availability.
     if( SM_NODE_AVAIL_STATUS_FAILED == node->avail_status )
     {
         DPRINTFD("Node %s is FAILED", node->name);
@@ -126,77 +267,69 @@ static void sm_service_domain_weight_check_availability( void* user_data[],
 // ****************************************************************************
 
 // ****************************************************************************
-// Service Domain Weight - By Location
-// ===================================
-static SmErrorT sm_service_domain_weight_by_location( void* user_data[],
-    void* record )
+// Service Domain Weight - Assignment
+// ==================================
+static void sm_service_domain_weight_assignment( void* user_data[],
+    SmServiceDomainAssignmentT* assignment )
 {
-    char* service_domain_name = (char*) user_data[0];
-    int* weight_multipler = (int*) user_data[1];    
-    SmDbNodeT* node = (SmDbNodeT*) record;
-    void* user_data2[] = {weight_multipler, node};
-
-    sm_service_domain_assignment_table_foreach_node_in_service_domain(
-                                service_domain_name, node->name, user_data2,
-                                sm_service_domain_weight_add_location );
-
-    ++(*weight_multipler);
-
-    return( SM_OKAY );
+    sm_service_domain_weight_cleanup( user_data, assignment );
+    sm_service_domain_weight_assignments( user_data, assignment );
+    sm_service_domain_weight_node( assignment );
 }
 // ****************************************************************************
 
-static SmErrorT sm_service_domain_weight_by_availability(void* user_data[],
-    void* record )
-{
-    char* service_domain_name = (char*) user_data[0];
-    SmDbNodeT* node = (SmDbNodeT*) record;
-    void* user_data2[] = {node};
-
-    sm_service_domain_assignment_table_foreach_node_in_service_domain(
-                                service_domain_name, node->name, user_data2,
-                                sm_service_domain_weight_check_availability );
-
-    return( SM_OKAY );
-}
-
 // ****************************************************************************
 // Service Domain Weight - Apply
 // =============================
 SmErrorT sm_service_domain_weight_apply( char service_domain_name[] )
 {
-    int weight_multipler = 1;
-    SmDbNodeT node;
-    void* user_data[] = {service_domain_name, &weight_multipler};
+    struct timespec start, end;
     SmErrorT error;
 
-    // Weight - Cleanup
-    sm_service_domain_assignment_table_foreach( service_domain_name,
-                    user_data, sm_service_domain_weight_cleanup );
+    clock_gettime( CLOCK_MONOTONIC, &start );
+
+    error = sm_service_domain_weight_refresh();
+    if( SM_OKAY != error )
+    {
+        return( error );
+    }
 
-    // Weight - By Assignment.
     sm_service_domain_assignment_table_foreach( service_domain_name,
-                    user_data, sm_service_domain_weight_assignments );
+                    NULL, sm_service_domain_weight_assignment );
 
-    // Weight - By Location.
-    error = sm_db_foreach( SM_DATABASE_NAME, SM_NODES_TABLE_NAME,
-                           NULL, &node, &sm_db_nodes_convert,
-                           sm_service_domain_weight_by_location,
-                           user_data );
+    clock_gettime( CLOCK_MONOTONIC, &end );
 
-    error = sm_db_foreach( SM_DATABASE_NAME, SM_NODES_TABLE_NAME,
-                           NULL, &node, &sm_db_nodes_convert,
-                           sm_service_domain_weight_by_availability,
-                           user_data );
+    ++_applies;
+    _apply_us += (uint64_t) ( (end.tv_sec - start.tv_sec) * 1000000
+                            + (end.tv_nsec - start.tv_nsec) / 1000 );
 
-    if( SM_OKAY != error )
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Domain Weight - Dump Data
+// =================================
+void sm_service_domain_weight_dump_data( FILE* log )
+{
+    fprintf( log, "--------------------------------------------------------------------\n" );
+    fprintf( log, "SERVICE DOMAIN WEIGHT DATA\n" );
+    fprintf( log, "  nodes........................................%u\n", _nodes_count );
+    fprintf( log, "  generation...................................%u\n", _weight_generation );
+    fprintf( log, "  applies......................................%" PRIu64 "\n", _applies );
+    fprintf( log, "  apply_us.....................................%" PRIu64 "\n", _apply_us );
+    fprintf( log, "  node_model_loads.............................%" PRIu64 "\n", _node_model_loads );
+    fprintf( log, "  pair_recomputes..............................%" PRIu64 "\n", _pair_recomputes );
+
+    unsigned int node_i;
+    for( node_i=0; _nodes_count > node_i; ++node_i )
     {
-        DPRINTFE( "Failed to loop over nodes, error=%s.",
-                  sm_error_str( error ) );
-        return( error );
+        fprintf( log, "  %-32s admin=%s, avail=%s\n", _nodes[node_i].name,
+                 sm_node_admin_state_str( _nodes[node_i].admin_state ),
+                 sm_node_avail_status_str( _nodes[node_i].avail_status ) );
     }
-    
-    return( SM_OKAY );
+
+    fprintf( log, "--------------------------------------------------------------------\n" );
 }
 // ****************************************************************************
 
@@ -205,6 +338,10 @@ SmErrorT sm_service_domain_weight_apply( char service_domain_name[] )
 // ==================================
 SmErrorT sm_service_domain_weight_initialize()
 {
+    _nodes_loaded = false;
+    _nodes_count = 0;
+    sm_service_domain_weight_invalidate();
+
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -214,6 +351,10 @@ SmErrorT sm_service_domain_weight_initialize()
 // ================================
 SmErrorT sm_service_domain_weight_finalize( void )
 {
+    _nodes_loaded = false;
+    _nodes_count = 0;
+    sm_service_domain_weight_invalidate();
+
     return( SM_OKAY );
 }
 // ****************************************************************************
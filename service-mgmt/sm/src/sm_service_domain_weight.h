@@ -6,6 +6,8 @@
 #ifndef __SM_SERVICE_DOMAIN_WEIGHT_H__
 #define __SM_SERVICE_DOMAIN_WEIGHT_H__
 
+#include <stdio.h>
+
 #include "sm_types.h"
 #include "sm_db.h"
 
@@ -19,6 +21,12 @@ extern "C" {
 extern SmErrorT sm_service_domain_weight_apply( char service_domain_name[] );
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Domain Weight - Dump Data
+// =================================
+extern void sm_service_domain_weight_dump_data( FILE* log );
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Domain Weight - Initialize
 // ==================================
@@ -11,7 +11,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
-#include <semaphore.h>
 #include <errno.h>
 
 #include "sm_types.h"
@@ -24,18 +23,25 @@
 #include "sm_configuration_table.h"
 #include "sm_node_utils.h"
 #include "sm_util_types.h"
+#include "sm_pressure.h"
+#include "sm_service_enabling_throttle_state.h"
 
 #define SERVICE_ENABLING_THROTTLE_DEFAULT_SIZE 2
 #define EXTRA_CORES_STORAGE "/etc/platform/.task_affining_incomplete"
 #define PLATFORM_CORES_FILE "/var/run/sm/.platform_cores"
 
+// The window shrinks by half while stall pressure is high and grows by one
+// while it is low and every slot is in use, up to twice the core limit.
+#define SERVICE_ENABLING_PRESSURE_INTERVAL_IN_MS                    1000
+
 static pthread_mutex_t sm_service_enable_mutex;
-static sem_t sem;
 static int num_initial_cores = 0;
-static sem_t sem_more_cores;
 static bool check_more_cores_available = false;
 static bool more_cores_available = false;
 static int  num_extra_cores = 0;
+static int  throttle_window = 0;
+static int  throttle_running = 0;
+static SmTimerIdT pressure_timer_id = SM_TIMER_ID_INVALID;
 
 SmErrorT sm_service_enable_mutex_initialize ( void )
 {
@@ -59,8 +65,12 @@ void sm_service_enable_throttle_add_cores( bool additional_cores )
     {
         if( more_cores_available )
         {
-            sem_destroy(&sem);
             more_cores_available = false;
+            if( throttle_window > num_initial_cores )
+            {
+                throttle_window = num_initial_cores;
+            }
+            num_extra_cores = 0;
         }
     }else
     {
@@ -622,18 +632,81 @@ static int get_initial_throttle()
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Enable - Pressure Timeout
+// =================================
+static bool sm_service_enable_pressure_timeout( SmTimerIdT timer_id,
+    int64_t user_data )
+{
+    SmPressureT pressure;
+    int window;
+    int limit;
+    SmErrorT error;
+
+    mutex_holder holder(&sm_service_enable_mutex);
+
+    limit = num_initial_cores + num_extra_cores;
+
+    if(( 0 == throttle_running )&&( limit == throttle_window ))
+    {
+        return( true );
+    }
+
+    error = sm_pressure_read( &pressure );
+    if( SM_OKAY != error )
+    {
+        DPRINTFD( "No pressure information, error=%s.", sm_error_str(error) );
+        return( true );
+    }
+
+    window = sm_pressure_window( throttle_window, throttle_running, limit,
+                                 &pressure );
+
+    if( window != throttle_window )
+    {
+        sm_debug_log( SM_DEBUG_SCHED_LOG, "enable-throttle: window %d -> %d, "
+                      "running=%d, limit=%d, cpu=%.1f%%, io=%.1f%%, "
+                      "source=%s.", throttle_window, window, throttle_running,
+                      limit, pressure.cpu, pressure.io,
+                      sm_pressure_source_str( pressure.source ) );
+
+        if( window > throttle_window )
+        {
+            sm_service_enabling_throttle_state_wake();
+        }
+
+        throttle_window = window;
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Enable - Initialize
 // ===========================
 SmErrorT sm_service_enable_initialize( void )
 {
+    SmErrorT error;
+
     num_initial_cores = get_initial_throttle();
     DPRINTFI("Enable services initial throttle size %d ", num_initial_cores);
 
-    if( 0 != sem_init(&sem, 0, num_initial_cores) )
+    throttle_window = num_initial_cores;
+    throttle_running = 0;
+
+    if( MAX_SERVICE_EXPECTED > num_initial_cores )
     {
-        DPRINTFE( "Could not initialize sempaphore. Error (%d)", errno );
-        return SM_FAILED;
+        error = sm_timer_register( "enable throttle pressure",
+                                   SERVICE_ENABLING_PRESSURE_INTERVAL_IN_MS,
+                                   sm_service_enable_pressure_timeout, 0,
+                                   &pressure_timer_id );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to create enable throttle pressure timer, "
+                      "error=%s.", sm_error_str( error ) );
+            return( error );
+        }
     }
 
     return( SM_OKAY );
@@ -645,7 +718,21 @@ SmErrorT sm_service_enable_initialize( void )
 // =========================
 SmErrorT sm_service_enable_finalize( void )
 {
-    sem_destroy(&sem);
+    SmErrorT error;
+
+    if( SM_TIMER_ID_INVALID != pressure_timer_id )
+    {
+        error = sm_timer_deregister( pressure_timer_id );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to cancel enable throttle pressure timer, "
+                      "error=%s.", sm_error_str( error ) );
+        }
+        pressure_timer_id = SM_TIMER_ID_INVALID;
+    }
+
+    throttle_window = 0;
+    throttle_running = 0;
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -664,58 +751,37 @@ static int get_extra_cores()
 // ==============
 bool sm_service_enable_throttle_check( void )
 {
-    int wait_res = sem_trywait(&sem);
-    if ( 0 == wait_res )
-    {
-        return true;
-    } else if( EAGAIN == errno )
+    mutex_holder holder(&sm_service_enable_mutex);
+
+    if(( throttle_running >= throttle_window )&&( check_more_cores_available ))
     {
-        mutex_holder holder(&sm_service_enable_mutex);
-        if(check_more_cores_available)
+        int new_num_platform_cores = get_extra_cores();
+        if( -1 == new_num_platform_cores )
         {
-            int new_num_platform_cores = get_extra_cores();
-            if( -1 == new_num_platform_cores )
-            {
-                //not ready, will try again next attempt
-            }
-            else
-            {
-                if (num_initial_cores < new_num_platform_cores)
-                {
-                    num_extra_cores = new_num_platform_cores - num_initial_cores;
-                    DPRINTFI("Enable services additional throttle size %d ", num_extra_cores);
-
-                    if( 0 != sem_init(&sem_more_cores, 0, num_extra_cores) )
-                    {
-                        DPRINTFE( "Could not initialize sempaphore for additional cores. Error (%d)", errno );
-                        // cannot use additional cores
-                        num_extra_cores = 0;
-                    }else
-                    {
-                        more_cores_available = true;
-                    }
-                }else
-                {
-                    DPRINTFI("Enable services no more additional core available");
-                }
-                check_more_cores_available = false;
-            }
-
-        }else if (more_cores_available)
+            //not ready, will try again next attempt
+        }
+        else
         {
-            wait_res = sem_trywait(&sem_more_cores);
-            if ( 0 == wait_res )
+            if (num_initial_cores < new_num_platform_cores)
             {
-                return true;
-            }else if( EAGAIN != errno )
+                num_extra_cores = new_num_platform_cores - num_initial_cores;
+                DPRINTFI("Enable services additional throttle size %d ", num_extra_cores);
+                throttle_window += num_extra_cores;
+                more_cores_available = true;
+            }else
             {
-                DPRINTFE( "Wait for additional cores failed error (%d) ", errno );
+                DPRINTFI("Enable services no more additional core available");
             }
+            check_more_cores_available = false;
         }
-    }else
+    }
+
+    if( throttle_running < throttle_window )
     {
-        DPRINTFE( "Wait failed error (%d) ", errno );
+        ++throttle_running;
+        return true;
     }
+
     return false;
 }
 // ****************************************************************************
@@ -725,18 +791,17 @@ bool sm_service_enable_throttle_check( void )
 // ==============
 void sm_service_enable_throttle_uncheck( void )
 {
-    int res;
-    res = sem_post(&sem);
-    if( -1 == res )
+    mutex_holder holder(&sm_service_enable_mutex);
+
+    if( 0 < throttle_running )
     {
-        if(EOVERFLOW == errno)
-        {
-            res = sem_post(&sem_more_cores);
-        }
+        --throttle_running;
+    } else {
+        DPRINTFE( "Error uncheck enable throttle, no ticket outstanding." );
     }
 
-    if( 0 != res )
+    if( throttle_running < throttle_window )
     {
-        DPRINTFE( "Error uncheck enable throttle. Error (%d)", errno );
+        sm_service_enabling_throttle_state_wake();
     }
 }
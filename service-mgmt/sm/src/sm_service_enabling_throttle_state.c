@@ -7,51 +7,147 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/eventfd.h>
 
 #include "sm_types.h"
 #include "sm_debug.h"
+#include "sm_selobj.h"
 #include "sm_service_fsm.h"
 #include "sm_service_go_active.h"
 #include "sm_service_enable.h"
 #include "sm_service_dependency.h"
 
-#define SM_SERVICE_ENABLING_THROTTLE_TIMEOUT_IN_MS  25
+#define SM_SERVICE_ENABLING_THROTTLE_WAITERS_MAX                     512
+
+static int _wake_fd = -1;
+static unsigned int _num_waiters = 0;
+static int64_t _waiters[SM_SERVICE_ENABLING_THROTTLE_WAITERS_MAX];
 
 // Check if a service is ready to go enable from throttling
-static SmErrorT sm_service_enabling_throttle_check( SmServiceT* service, bool& goahead );
+static SmErrorT sm_service_enabling_throttle_check( SmServiceT* service,
+    bool& dependency_met, bool& goahead );
 
 // ****************************************************************************
-// Service Enabling Throttle State - Timeout Timer
+// Service Enabling Throttle State - Wake
 // ======================================
-static bool sm_service_enabling_throttle_state_timeout_timer( SmTimerIdT timer_id,
-    int64_t user_data )
+void sm_service_enabling_throttle_state_wake( void )
 {
-    int64_t id = user_data;
-    SmServiceT* service;
-    SmErrorT error;
+    uint64_t count = 1;
 
-    service = sm_service_table_read_by_id( id );
-    if( NULL == service )
+    if( 0 > _wake_fd )
     {
-        DPRINTFE( "Failed to read service %d, error=%s.",
-                  id, sm_error_str(SM_NOT_FOUND) );
-        // service no longer exists, deprovisioned?
-        service->action_state_timer_id = SM_TIMER_ID_INVALID;
-        return( false );
+        return;
     }
 
-    bool goahead;
-    error = sm_service_enabling_throttle_check(service, goahead);
-    if( SM_OKAY != error )
+    if( 0 > write( _wake_fd, &count, sizeof(count) ) )
     {
-        DPRINTFE( "Failed to check service %s throttling state, error=%s.",
-                  service->name, sm_error_str( error ) );
-        // retry next time
-        return true;
+        DPRINTFE( "Failed to wake throttled services, error=%s.",
+                  strerror( errno ) );
     }
+}
+// ****************************************************************************
 
-    if ( goahead )
+// ****************************************************************************
+// Service Enabling Throttle State - Remove Waiter
+// ===============================================
+static void sm_service_enabling_throttle_remove_waiter( int64_t id )
+{
+    unsigned int waiter_i;
+    for( waiter_i=0; _num_waiters > waiter_i; ++waiter_i )
     {
+        if( id == _waiters[waiter_i] )
+        {
+            memmove( &(_waiters[waiter_i]), &(_waiters[waiter_i+1]),
+                     (_num_waiters - waiter_i - 1) * sizeof(int64_t) );
+            --_num_waiters;
+            return;
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Enabling Throttle State - Add Waiter
+// ============================================
+static void sm_service_enabling_throttle_add_waiter( SmServiceT* service )
+{
+    unsigned int waiter_i;
+    for( waiter_i=0; _num_waiters > waiter_i; ++waiter_i )
+    {
+        if( service->id == _waiters[waiter_i] )
+        {
+            return;
+        }
+    }
+
+    if( SM_SERVICE_ENABLING_THROTTLE_WAITERS_MAX <= _num_waiters )
+    {
+        DPRINTFE( "Too many services waiting to enable, service (%s) not "
+                  "queued.", service->name );
+        return;
+    }
+
+    _waiters[_num_waiters++] = service->id;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Enabling Throttle State - Dispatch
+// ==========================================
+// Services are let through in the order they started waiting.  Services
+// with unmet dependencies are passed over, the walk stops at the first
+// service refused a ticket.
+static void sm_service_enabling_throttle_state_dispatch( int selobj,
+    int64_t user_data )
+{
+    int64_t waiters[SM_SERVICE_ENABLING_THROTTLE_WAITERS_MAX];
+    unsigned int num_waiters = _num_waiters;
+    uint64_t count;
+    bool dependency_met;
+    bool goahead;
+    SmServiceT* service;
+    SmErrorT error;
+
+    read( _wake_fd, &count, sizeof(count) );
+
+    memcpy( waiters, _waiters, num_waiters * sizeof(int64_t) );
+
+    unsigned int waiter_i;
+    for( waiter_i=0; num_waiters > waiter_i; ++waiter_i )
+    {
+        service = sm_service_table_read_by_id( waiters[waiter_i] );
+        if(( NULL == service )||
+           ( SM_SERVICE_STATE_ENABLING_THROTTLE != service->state ))
+        {
+            // service no longer exists, deprovisioned?
+            sm_service_enabling_throttle_remove_waiter( waiters[waiter_i] );
+            continue;
+        }
+
+        error = sm_service_enabling_throttle_check( service, dependency_met,
+                                                    goahead );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to check service %s throttling state, error=%s.",
+                      service->name, sm_error_str( error ) );
+            // retry next time
+            continue;
+        }
+
+        if( !dependency_met )
+        {
+            DPRINTFD( "%s dependency not met", service->name );
+            continue;
+        }
+
+        if( !goahead )
+        {
+            DPRINTFD( "%s waiting for throttle to open", service->name );
+            break;
+        }
+
         error = sm_service_fsm_event_handler( service->name,
                                           SM_SERVICE_EVENT_ENABLE,
                                           NULL, "throttle open to enable service" );
@@ -59,28 +155,17 @@ static bool sm_service_enabling_throttle_state_timeout_timer( SmTimerIdT timer_i
         {
             DPRINTFE( "Failed to signal enable service "
                       "(%s), error=%s.", service->name, sm_error_str( error ) );
-
-            // retry next time
-            return true;
         }
-    }else
-    {
-        DPRINTFD("%s dependency not met", service->name);
-        // cannot goahead enable the service, wait for next attempt
-        return true;
     }
-
-    // set to enabling state, timer is no more needed
-    return( false );
 }
 // ****************************************************************************
 
 // ****************************************************************************
 // Service Enabling Throttle State - check if a service is ready to enable
 // ==============================
-SmErrorT sm_service_enabling_throttle_check( SmServiceT* service, bool& goahead )
+SmErrorT sm_service_enabling_throttle_check( SmServiceT* service,
+    bool& dependency_met, bool& goahead )
 {
-    bool dependency_met;
     SmErrorT error;
     // Are enable dependencies met?
     goahead = false;
@@ -111,10 +196,7 @@ SmErrorT sm_service_enabling_throttle_check( SmServiceT* service, bool& goahead
 // ==============================
 SmErrorT sm_service_enabling_throttle_state_entry( SmServiceT* service )
 {
-    char timer_name[80] = "";
-    SmTimerIdT action_state_timer_id;
     SmErrorT error;
-    int timeout = SM_SERVICE_ENABLING_THROTTLE_TIMEOUT_IN_MS;
 
     if( SM_TIMER_ID_INVALID != service->action_state_timer_id )
     {
@@ -128,21 +210,10 @@ SmErrorT sm_service_enabling_throttle_state_entry( SmServiceT* service )
         service->action_state_timer_id = SM_TIMER_ID_INVALID;
     }
 
-    snprintf( timer_name, sizeof(timer_name), "%s wait for enabling",
-              service->name );
+    sm_service_enabling_throttle_remove_waiter( service->id );
+    sm_service_enabling_throttle_add_waiter( service );
+    sm_service_enabling_throttle_state_wake();
 
-    error = sm_timer_register( timer_name,
-                               timeout,
-                               sm_service_enabling_throttle_state_timeout_timer,
-                               service->id, &action_state_timer_id );
-    if( SM_OKAY != error )
-    {
-        DPRINTFE( "Failed to create enabling throttle timer for service "
-                  "(%s), error=%s.", service->name, sm_error_str( error ) );
-        return( error );
-    }
-
-    service->action_state_timer_id = action_state_timer_id;
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -154,6 +225,8 @@ SmErrorT sm_service_enabling_throttle_state_exit( SmServiceT* service )
 {
     SmErrorT error;
 
+    sm_service_enabling_throttle_remove_waiter( service->id );
+
     if( SM_TIMER_ID_INVALID != service->action_state_timer_id )
     {
         error = sm_timer_deregister( service->action_state_timer_id );
@@ -191,7 +264,9 @@ SmErrorT sm_service_enabling_throttle_state_event_handler( SmServiceT* service,
     switch( event )
     {
         case SM_SERVICE_EVENT_ENABLE_THROTTLE:
-            // ignore. already in this state
+            // already in this state, dependencies may have changed
+            sm_service_enabling_throttle_add_waiter( service );
+            sm_service_enabling_throttle_state_wake();
         break;
 
         break;
@@ -248,6 +323,29 @@ SmErrorT sm_service_enabling_throttle_state_event_handler( SmServiceT* service,
 // ===================================
 SmErrorT sm_service_enabling_throttle_state_initialize( void )
 {
+    SmErrorT error;
+
+    _num_waiters = 0;
+
+    _wake_fd = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+    if( 0 > _wake_fd )
+    {
+        DPRINTFE( "Failed to open file descriptor, error=%s.",
+                  strerror( errno ) );
+        return( SM_FAILED );
+    }
+
+    error = sm_selobj_register( _wake_fd,
+                                sm_service_enabling_throttle_state_dispatch, 0 );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to register selection object, error=%s.",
+                  sm_error_str( error ) );
+        close( _wake_fd );
+        _wake_fd = -1;
+        return( error );
+    }
+
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -257,6 +355,23 @@ SmErrorT sm_service_enabling_throttle_state_initialize( void )
 // =================================
 SmErrorT sm_service_enabling_throttle_state_finalize( void )
 {
+    SmErrorT error;
+
+    if( 0 <= _wake_fd )
+    {
+        error = sm_selobj_deregister( _wake_fd );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to deregister selection object, error=%s.",
+                      sm_error_str( error ) );
+        }
+
+        close( _wake_fd );
+        _wake_fd = -1;
+    }
+
+    _num_waiters = 0;
+
     return( SM_OKAY );
 }
 // ****************************************************************************
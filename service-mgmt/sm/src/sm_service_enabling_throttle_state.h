@@ -14,6 +14,13 @@
 extern "C" {
 #endif
 
+// ****************************************************************************
+// Service Enabling Throttle State - Wake
+// ======================================
+// Has the waiting services retry, oldest first, once back in the main loop.
+extern void sm_service_enabling_throttle_state_wake( void );
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Enabling Throttle State - Entry
 // ==============================
@@ -22,9 +22,9 @@
 #include "sm_service_fsm.h"
 #include "sm_service_go_active.h"
 #include "sm_service_go_standby.h"
+#include "sm_service_plan.h"
 
 #define SM_SERVICE_ENGINE_TIMER_IN_MS                               500
-#define SM_SERVICE_ENGINE_MIN_TIME_BETWEEN_SIGNALS_IN_MS            100
 
 static int _engine_fd = -1;
 static SmTimerIdT _engine_timer_id = SM_TIMER_ID_INVALID;
@@ -48,28 +48,17 @@ static bool sm_service_engine_timeout( SmTimerIdT timer_id, int64_t user_data )
 // ****************************************************************************
 // Service Engine - Signal
 // =======================
+// Signals raised before the engine runs are folded into one sweep by the
+// eventfd, so every signal is written.
 SmErrorT sm_service_engine_signal( SmServiceT* service )
 {
-    static SmTimeT time_last_signal = {0};
-
-    long ms_expired;
-    SmTimeT time_now;
-
-    sm_time_get( &time_now );
-    ms_expired = sm_time_delta_in_ms( &time_now, &time_last_signal );
+    uint64_t count = 1;
 
-    if( SM_SERVICE_ENGINE_MIN_TIME_BETWEEN_SIGNALS_IN_MS > ms_expired )
+    if( 0 > write( _engine_fd, &count, sizeof(count) ) )
     {
-        uint64_t count = 1;
-
-        if( 0 > write( _engine_fd, &count, sizeof(count) ) )
-        {
-            DPRINTFE( "Failed to signal service (%s), error=%s",
-                      service->name, strerror( errno ) );
-            return( SM_FAILED );
-        }
-
-        time_last_signal = time_now;
+        DPRINTFE( "Failed to signal service (%s), error=%s",
+                  service->name, strerror( errno ) );
+        return( SM_FAILED );
     }
 
     return( SM_OKAY );
@@ -455,7 +444,7 @@ static void sm_service_engine_dispatch( int selobj, int64_t user_data )
 
     read( _engine_fd, &count, sizeof(count) );
 
-    sm_service_table_foreach( NULL, sm_service_engine_signal_handler );
+    sm_service_plan_foreach( NULL, sm_service_engine_signal_handler );
 }
 // ****************************************************************************
 
@@ -34,7 +34,11 @@
 #include "sm_service_audit.h"
 #include "sm_service_heartbeat_api.h"
 #include "sm_process_death.h"
+#include "sm_pid_file_monitor.h"
+#include "sm_time.h"
 #include "sm_log.h"
+#include "sm_swact_profiler.h"
+#include "sm_eru_services.h"
 
 #define SM_SERVICE_FSM_PID_FILE_AUDIT_IN_MS         2000
 
@@ -800,6 +804,7 @@ SmErrorT sm_service_fsm_event_handler( char service_name[],
     SmServiceStatusT prev_status;
     SmServiceConditionT prev_condition;
     SmServiceT* service;
+    SmTimeT persist_start;
     SmErrorT error;
 
     service = sm_service_table_read( service_name );
@@ -1031,6 +1036,14 @@ SmErrorT sm_service_fsm_event_handler( char service_name[],
                   SM_SERVICE_CONDITION_NONE == service->condition
                   ? "" : sm_service_condition_str( service->condition ) );
 
+        if( prev_state != service->state )
+        {
+            sm_swact_profiler_service_state( service_name, prev_state,
+                                             service->state );
+        }
+
+        sm_time_get( &persist_start );
+
         error = sm_service_table_persist( service );
         if( SM_OKAY != error )
         {
@@ -1038,6 +1051,8 @@ SmErrorT sm_service_fsm_event_handler( char service_name[],
                       service->name, sm_error_str(error) );
             return( error );
         }
+
+        sm_swact_profiler_persisted( service_name, false, &persist_start );
        
         if(( prev_state != service->state )||( prev_status != service->status ))
         {
@@ -1428,6 +1443,32 @@ static void sm_service_fsm_heartbeat_fail_callback( char service_name[] )
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Service FSM - Record Death Detection
+// ====================================
+// The detection latency is -1 when the backend does not give the time of
+// death, the event driven backends are woken by the death itself.
+static void sm_service_fsm_record_death_detection( SmServiceT* service,
+    SmProcessDeathBackendT backend, long detect_latency_us,
+    long dispatch_latency_us )
+{
+    service->death_backend = backend;
+    service->death_count++;
+    service->death_detect_last_us = detect_latency_us;
+    service->death_dispatch_last_us = dispatch_latency_us;
+
+    if( detect_latency_us > service->death_detect_max_us )
+    {
+        service->death_detect_max_us = detect_latency_us;
+    }
+
+    if( dispatch_latency_us > service->death_dispatch_max_us )
+    {
+        service->death_dispatch_max_us = dispatch_latency_us;
+    }
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service FSM - Process Failure Callback
 // ======================================
@@ -1439,6 +1480,9 @@ static void sm_service_fsm_process_failure_callback( pid_t pid, int exit_code,
     SmServiceEventT event = SM_SERVICE_EVENT_PROCESS_FAILURE;
     SmErrorT error;
 
+    SmProcessDeathBackendT backend = SM_PROCESS_DEATH_BACKEND_NONE;
+    long dispatch_latency_us = 0;
+
     service = sm_service_table_read_by_pid( (int) pid );
     if( NULL == service )
     {
@@ -1446,9 +1490,18 @@ static void sm_service_fsm_process_failure_callback( pid_t pid, int exit_code,
                   user_data, sm_error_str(SM_NOT_FOUND) );
         return;
     }
-    
-    DPRINTFI_SVC( "Service (%s) process failure, pid=%i, exit_code=%i.",
-              service->name, (int) pid, exit_code );
+
+    if( SM_OKAY == sm_process_death_detection( pid, &backend,
+                                               &dispatch_latency_us ) )
+    {
+        sm_service_fsm_record_death_detection( service, backend, -1,
+                                               dispatch_latency_us );
+    }
+
+    DPRINTFI_SVC( "Service (%s) process failure, pid=%i, exit_code=%i, "
+              "detected by %s, dispatched in %li us.", service->name,
+              (int) pid, exit_code, sm_process_death_backend_str( backend ),
+              dispatch_latency_us );
 
     sm_service_get_terminate_reason(service, reason_text, sizeof(reason_text));
 
@@ -1497,6 +1550,36 @@ EXIT:
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Service FSM - Pid File Changed
+// ==============================
+static void sm_service_fsm_pid_file_changed( const char pid_file[],
+    int64_t user_data )
+{
+    SmServiceT* service;
+    SmErrorT error;
+
+    service = sm_service_table_read_by_id( user_data );
+    if( NULL == service )
+    {
+        DPRINTFE_SVC( "Failed to read service, error=%s.",
+                  sm_error_str(SM_NOT_FOUND) );
+        return;
+    }
+
+    DPRINTFD_SVC( "Pid file (%s) for service (%s) changed, pid=%i.",
+              pid_file, service->name, service->pid );
+
+    error = sm_service_fsm_process_failure_register( service );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE_SVC( "Failed to register for process failure for "
+                  "service (%s), error=%s.", service->name,
+                  sm_error_str( error ) );
+    }
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service FSM - Process Failure Register
 // ======================================
@@ -1510,6 +1593,12 @@ SmErrorT sm_service_fsm_process_failure_register( SmServiceT* service )
 
     if( '\0' != service->pid_file[0] )
     {
+        // Re-resolve the pid as soon as the pid file is rewritten, the
+        // audit timer below remains as a fallback.
+        sm_pid_file_monitor_watch( service->pid_file,
+                                   sm_service_fsm_pid_file_changed,
+                                   service->id );
+
         pid_file = fopen ( service->pid_file, "r" );
 
         if( NULL == pid_file )
@@ -1558,7 +1647,19 @@ SmErrorT sm_service_fsm_process_failure_register( SmServiceT* service )
                       " is no longer valid.", pid,
                       service->pid_file, service->name );
             remove_pid_file( service->pid_file );
+
+            if( pid == service->pid )
+            {
+                // At most the time since the process was last seen alive,
+                // handled by the audit itself.
+                sm_service_fsm_record_death_detection( service,
+                    SM_PROCESS_DEATH_BACKEND_AUDIT,
+                    sm_time_get_elapsed_ms( &(service->pid_alive_time) )
+                    * 1000, 0 );
+            }
+
             service->pid = -1;
+            sm_eru_services_set( service->name, service->pid );
 
             if( !sm_process_death_already_registered( pid,
                     sm_service_fsm_process_failure_callback ) )
@@ -1585,7 +1686,24 @@ SmErrorT sm_service_fsm_process_failure_register( SmServiceT* service )
             goto EXIT;
         }
 
+        if(( 0 <= service->pid )&&( pid != service->pid ))
+        {
+            DPRINTFI_SVC( "Service (%s) pid changed from %i to %i.",
+                      service->name, service->pid, pid );
+
+            error = sm_process_death_deregister( service->pid );
+            if( SM_OKAY != error )
+            {
+                DPRINTFE_SVC( "Failed to deregister for process failure "
+                          "callback for service (%s), pid=%i, error=%s.",
+                          service->name, service->pid,
+                          sm_error_str( error ) );
+            }
+        }
+
         service->pid = pid;
+        sm_time_get( &(service->pid_alive_time) );
+        sm_eru_services_set( service->name, service->pid );
 
         if( sm_process_death_already_registered( pid,
                     sm_service_fsm_process_failure_callback ) )
@@ -1656,6 +1774,11 @@ SmErrorT sm_service_fsm_process_failure_deregister( SmServiceT* service )
 {
     SmErrorT error;
 
+    if( '\0' != service->pid_file[0] )
+    {
+        sm_pid_file_monitor_unwatch( service->pid_file, service->id );
+    }
+
     if( SM_TIMER_ID_INVALID != service->pid_file_audit_timer_id )
     {
         error = sm_timer_deregister( service->pid_file_audit_timer_id );
@@ -1679,12 +1802,46 @@ SmErrorT sm_service_fsm_process_failure_deregister( SmServiceT* service )
         }
 
         service->pid = -1;
+        sm_eru_services_set( service->name, service->pid );
     }
 
     return( SM_OKAY );
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Service FSM - Dump Process Death Data
+// =====================================
+static void sm_service_fsm_dump_process_death( void* user_data[],
+    SmServiceT* service )
+{
+    FILE* log = (FILE*) user_data[0];
+
+    if(( 0 > service->pid )&&( 0 == service->death_count ))
+    {
+        return;
+    }
+
+    fprintf( log, "  %-40s pid=%-7i deaths=%-4u by=%-13s detect_us=%li/%li "
+             "dispatch_us=%li/%li\n", service->name, service->pid,
+             service->death_count,
+             sm_process_death_backend_str( service->death_backend ),
+             service->death_detect_last_us, service->death_detect_max_us,
+             service->death_dispatch_last_us,
+             service->death_dispatch_max_us );
+}
+
+void sm_service_fsm_dump_process_death_data( FILE* log )
+{
+    void* user_data[] = {log};
+
+    fprintf( log, "--------------------------------------------------------------------\n" );
+    fprintf( log, "SERVICE PROCESS DEATH DATA\n" );
+    sm_service_table_foreach( user_data, sm_service_fsm_dump_process_death );
+    fprintf( log, "--------------------------------------------------------------------\n" );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service FSM - Initialize
 // ========================
@@ -1822,6 +1979,14 @@ SmErrorT sm_service_fsm_initialize( void )
         return( error );
     }
 
+    error = sm_pid_file_monitor_initialize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE_SVC( "Failed to initialize pid file monitor module, "
+                  "error=%s.", sm_error_str( error ) );
+        return( error );
+    }
+
     _hb_callbacks.okay_callback = sm_service_fsm_heartbeat_okay_callback;
     _hb_callbacks.warn_callback = sm_service_fsm_heartbeat_warn_callback;
     _hb_callbacks.degrade_callback = sm_service_fsm_heartbeat_degrade_callback;
@@ -1967,6 +2132,13 @@ SmErrorT sm_service_fsm_finalize( void )
                   sm_error_str( error ) );
     }
 
+    error = sm_pid_file_monitor_finalize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE_SVC( "Failed to finalize pid file monitor module, "
+                  "error=%s.", sm_error_str( error ) );
+    }
+
     return( SM_OKAY );
 }
 // ****************************************************************************
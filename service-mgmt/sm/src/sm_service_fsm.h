@@ -6,6 +6,8 @@
 #ifndef __SM_SERVICE_FSM_H__
 #define __SM_SERVICE_FSM_H__
 
+#include <stdio.h>
+
 #include "sm_types.h"
 #include "sm_service_table.h"
 
@@ -85,6 +87,15 @@ extern SmErrorT sm_service_fsm_process_failure_deregister(
     SmServiceT* service );
 // ****************************************************************************
 
+// ****************************************************************************
+// Service FSM - Dump Process Death Data
+// =====================================
+// Per service, the backend that last detected a process death and the
+// detection latency.  For the pid file audit, the latency is the time since
+// the pid was last seen alive.
+extern void sm_service_fsm_dump_process_death_data( FILE* log );
+// ****************************************************************************
+
 // ****************************************************************************
 // Service FSM - Initialize
 // ========================
@@ -17,6 +17,7 @@
 #include "sm_service_dependency.h"
 #include "sm_service_fsm.h"
 #include "sm_service_action.h"
+#include "sm_service_plan.h"
 
 // ****************************************************************************
 // Service Go-Active - Result Handler
@@ -326,6 +327,12 @@ SmErrorT sm_service_go_active( SmServiceT* service )
 
     DPRINTFD( "All dependencies for service (%s) were met.", service->name );
 
+    if( !sm_service_plan_go_active_acquire( service ) )
+    {
+        DPRINTFD( "Go-active of service (%s) deferred.", service->name );
+        return( SM_OKAY );
+    }
+
     // Run action.
     error = sm_service_action_run( service->name, 
                                    service->instance_name,
@@ -13,11 +13,13 @@
 #include "sm_debug.h"
 #include "sm_node_utils.h"
 #include "sm_time.h"
+#include "sm_timer.h"
 #include "sm_service_group_table.h"
 #include "sm_service_group_member_table.h"
 #include "sm_service_api.h"
 #include "sm_service_group_health.h"
 #include "sm_service_domain_utils.h"
+#include "sm_service_group_fsm.h"
 
 // ****************************************************************************
 // Service Group Audit - Set Service Reason Text
@@ -139,32 +141,58 @@ static void sm_service_group_audit_map_service_condition(
 // ****************************************************************************
 
 // ****************************************************************************
-// Service Group Audit - Service For Status
+// Service Group Audit - Condition Rank
+// ====================================
+// A member condition replaces the group condition unless the group
+// condition ranks higher, the unknown conditions are never replaced.
+static int sm_service_group_audit_condition_rank(
+    SmServiceGroupConditionT condition )
+{
+    switch( condition )
+    {
+        case SM_SERVICE_GROUP_CONDITION_NONE:
+            return( 0 );
+
+        case SM_SERVICE_GROUP_CONDITION_DATA_INCONSISTENT:
+        case SM_SERVICE_GROUP_CONDITION_DATA_OUTDATED:
+        case SM_SERVICE_GROUP_CONDITION_DATA_CONSISTENT:
+        case SM_SERVICE_GROUP_CONDITION_DATA_SYNC:
+        case SM_SERVICE_GROUP_CONDITION_DATA_STANDALONE:
+            return( 1 );
+
+        case SM_SERVICE_GROUP_CONDITION_RECOVERY_FAILURE:
+            return( 2 );
+
+        case SM_SERVICE_GROUP_CONDITION_ACTION_FAILURE:
+            return( 3 );
+
+        case SM_SERVICE_GROUP_CONDITION_FATAL_FAILURE:
+            return( 4 );
+
+        default:
+            return( 5 );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Audit - Member Contribution
 // ========================================
-static void sm_service_group_audit_service_for_status( void* user_data[],
-    SmServiceGroupMemberT* service_group_member )
+static void sm_service_group_audit_member_contribution(
+    SmServiceGroupT* service_group, SmServiceGroupMemberT* service_group_member,
+    SmServiceGroupMemberAuditT* contribution, char service_reason_text[] )
 {
     bool do_increment = true;
     long elapsed_ms, delta_ms;
-    SmServiceGroupT* service_group = (SmServiceGroupT*) user_data[0];
-    SmServiceGroupStatusT* status = (SmServiceGroupStatusT*) user_data[1];
-    SmServiceGroupConditionT* condition = (SmServiceGroupConditionT*) user_data[2];
-    int* failed = (int*) user_data[3];
-    int* degraded = (int*) user_data[4];
-    int* warn = (int*) user_data[5];
-    int* healthy = (int*) user_data[6];
-    bool* reason_text_writable = (bool*) user_data[7];
-    char* reason_text = (char*) user_data[8];
-    int reason_text_size = *(int*) user_data[9];
-    SmServiceGroupStatusT prev_status = *status;
-    SmServiceGroupConditionT prev_condition = *condition;
     SmServiceStatusT sgm_imply_status;
     SmServiceGroupStatusT mapped_status;
     SmServiceGroupConditionT mapped_condition;
-    char service_reason_text[SM_SERVICE_GROUP_REASON_TEXT_MAX_CHAR] = "";
     static bool _is_aio_simplex = false;
     SmErrorT error;
 
+    memset( contribution, 0, sizeof(SmServiceGroupMemberAuditT) );
+    service_reason_text[0] = '\0';
+
     sgm_imply_status = service_group_member->service_status;
     if( 0 != service_group_member->service_failure_timestamp )
     {
@@ -198,6 +226,9 @@ static void sm_service_group_audit_service_for_status( void* user_data[],
                       delta_ms );
 
             do_increment = false;
+            contribution->debounce_end_ms
+                = service_group_member->service_failure_timestamp
+                + adjusted_failure_debounce + 1;
 
             switch( service_group_member->service_failure_impact )
             {
@@ -207,31 +238,31 @@ static void sm_service_group_audit_service_for_status( void* user_data[],
 
                 case SM_SERVICE_SEVERITY_MINOR:
                     sgm_imply_status  = SM_SERVICE_STATUS_WARN;
-                    ++(*warn);
+                    contribution->warn = true;
                 break;
 
                 case SM_SERVICE_SEVERITY_MAJOR:
                     sgm_imply_status  = SM_SERVICE_STATUS_DEGRADED;
-                    ++(*degraded);
+                    contribution->degraded = true;
                 break;
 
                 case SM_SERVICE_SEVERITY_CRITICAL:
                     sgm_imply_status  = SM_SERVICE_STATUS_FAILED;
-                    ++(*failed);
+                    contribution->failed = true;
                 break;
 
                 default:
                 break;
             }
         } else {
-            ++(*healthy);
+            contribution->healthy = true;
             DPRINTFD( "Service group (%s) member (%s) failure debounce "
                       "no longer in effect, delta_ms=%li.", service_group->name,
                       service_group_member->service_name, delta_ms );
         }
     }else
     {
-        ++(*healthy);
+        contribution->healthy = true;
     }
 
     switch( sgm_imply_status )
@@ -254,7 +285,7 @@ static void sm_service_group_audit_service_for_status( void* user_data[],
 
             if( do_increment )
             {
-                ++(*warn);
+                contribution->warn = true;
             }
         break;
 
@@ -274,7 +305,7 @@ static void sm_service_group_audit_service_for_status( void* user_data[],
 
             if( do_increment )
             {
-                ++(*degraded);
+                contribution->degraded = true;
             }
         break;
 
@@ -292,7 +323,7 @@ static void sm_service_group_audit_service_for_status( void* user_data[],
 
                     if( do_increment )
                     {
-                        ++(*warn);
+                        contribution->warn = true;
                     }
                 break;
 
@@ -302,7 +333,7 @@ static void sm_service_group_audit_service_for_status( void* user_data[],
 
                     if( do_increment )
                     {
-                        ++(*degraded);
+                        contribution->degraded = true;
                     }
                 break;
 
@@ -315,7 +346,7 @@ static void sm_service_group_audit_service_for_status( void* user_data[],
 
                     if( do_increment )
                     {
-                        ++(*failed);
+                        contribution->failed = true;
                     }
                 break;
 
@@ -339,108 +370,99 @@ static void sm_service_group_audit_service_for_status( void* user_data[],
         break;
     }
 
-    if( SM_SERVICE_GROUP_STATUS_UNKNOWN != mapped_status )
+    contribution->status = mapped_status;
+    contribution->condition = mapped_condition;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Audit - Totals Apply
+// ==================================
+static void sm_service_group_audit_totals_apply( SmServiceGroupAuditT* totals,
+    const SmServiceGroupMemberAuditT* contribution, int sign )
+{
+    totals->failed += contribution->failed ? sign : 0;
+    totals->degraded += contribution->degraded ? sign : 0;
+    totals->warn += contribution->warn ? sign : 0;
+    totals->healthy += contribution->healthy ? sign : 0;
+    totals->debounce_pending += ( 0 != contribution->debounce_end_ms ) ? sign : 0;
+
+    if( SM_SERVICE_GROUP_STATUS_UNKNOWN != contribution->status )
     {
-        switch( *status )
-        {
-            case SM_SERVICE_GROUP_STATUS_NONE:
-                *status = mapped_status;
-            break;
-
-            case SM_SERVICE_GROUP_STATUS_WARN:
-                if( SM_SERVICE_GROUP_STATUS_NONE != mapped_status )
-                {
-                    *status = mapped_status;
-                }
-            break;
-
-            case SM_SERVICE_GROUP_STATUS_DEGRADED:
-               if(( SM_SERVICE_GROUP_STATUS_NONE != mapped_status )&&
-                  ( SM_SERVICE_GROUP_STATUS_WARN != mapped_status ))
-                {
-                    *status = mapped_status;
-                }
-            break;
-
-            case SM_SERVICE_GROUP_STATUS_FAILED:
-                if(( SM_SERVICE_GROUP_STATUS_NONE     != mapped_status )&&
-                   ( SM_SERVICE_GROUP_STATUS_WARN     != mapped_status )&&
-                   ( SM_SERVICE_GROUP_STATUS_DEGRADED != mapped_status ))
-                {
-                    *status = mapped_status;
-                }
-            break;
-
-            default:
-                DPRINTFE( "Service group (%s) status (%s) not handled.",
-                          service_group->name, 
-                          sm_service_group_status_str( mapped_status ) );
-            break;
-        }
+        totals->status_count[contribution->status] += sign;
+        totals->condition_count[contribution->condition] += sign;
+    }
+}
+// ****************************************************************************
 
-        switch( *condition )
+// ****************************************************************************
+// Service Group Audit - Debounce Schedule
+// =======================================
+static bool sm_service_group_audit_debounce_timeout( SmTimerIdT timer_id,
+    int64_t user_data );
+
+static void sm_service_group_audit_debounce_schedule(
+    SmServiceGroupT* service_group, long end_ms )
+{
+    SmServiceGroupAuditT* totals = &(service_group->audit);
+    long delay_ms;
+    SmErrorT error;
+
+    if(( SM_TIMER_ID_INVALID != totals->debounce_timer_id )&&
+       ( totals->debounce_timer_end_ms <= end_ms ))
+    {
+        return;
+    }
+
+    if( SM_TIMER_ID_INVALID != totals->debounce_timer_id )
+    {
+        error = sm_timer_deregister( totals->debounce_timer_id );
+        if( SM_OKAY != error )
         {
-            case SM_SERVICE_GROUP_CONDITION_NONE:
-                *condition = mapped_condition;
-            break;
-
-            case SM_SERVICE_GROUP_CONDITION_DATA_INCONSISTENT:
-            case SM_SERVICE_GROUP_CONDITION_DATA_OUTDATED:
-            case SM_SERVICE_GROUP_CONDITION_DATA_CONSISTENT:
-            case SM_SERVICE_GROUP_CONDITION_DATA_SYNC:
-            case SM_SERVICE_GROUP_CONDITION_DATA_STANDALONE:
-                if( SM_SERVICE_GROUP_CONDITION_NONE != mapped_condition )
-                {
-                    *condition = mapped_condition;
-                }
-            break;
-
-            case SM_SERVICE_GROUP_CONDITION_RECOVERY_FAILURE:
-                if(( SM_SERVICE_GROUP_CONDITION_NONE != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_INCONSISTENT != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_OUTDATED != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_CONSISTENT != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_SYNC != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_STANDALONE != mapped_condition ))
-                {
-                    *condition = mapped_condition;
-                }
-            break;
-
-            case SM_SERVICE_GROUP_CONDITION_ACTION_FAILURE:
-                if(( SM_SERVICE_GROUP_CONDITION_NONE != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_INCONSISTENT != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_OUTDATED != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_CONSISTENT != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_SYNC != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_STANDALONE != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_RECOVERY_FAILURE != mapped_condition ))
-                {
-                    *condition = mapped_condition;
-                }
-            break;
-
-            case SM_SERVICE_GROUP_CONDITION_FATAL_FAILURE:
-                if(( SM_SERVICE_GROUP_CONDITION_NONE != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_INCONSISTENT != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_OUTDATED != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_CONSISTENT != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_SYNC != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_DATA_STANDALONE != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_RECOVERY_FAILURE != mapped_condition )&&
-                   ( SM_SERVICE_GROUP_CONDITION_ACTION_FAILURE != mapped_condition ))
-                {
-                    *condition = mapped_condition;
-                }
-            break;
-
-            default:
-                DPRINTFE( "Service group (%s) condition (%s) not handled.",
-                          service_group->name, 
-                          sm_service_group_condition_str( mapped_condition ) );
-            break;
+            DPRINTFE( "Failed to cancel service group (%s) debounce timer, "
+                      "error=%s.", service_group->name, sm_error_str( error ) );
         }
-    } else {
+        totals->debounce_timer_id = SM_TIMER_ID_INVALID;
+    }
+
+    delay_ms = end_ms - sm_time_get_elapsed_ms( NULL );
+    if( 0 > delay_ms )
+    {
+        delay_ms = 0;
+    }
+
+    error = sm_timer_register( "service group debounce", (unsigned int) delay_ms,
+                               sm_service_group_audit_debounce_timeout,
+                               service_group->id, &totals->debounce_timer_id );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to create service group (%s) debounce timer, "
+                  "error=%s.", service_group->name, sm_error_str( error ) );
+        totals->valid = false;
+        return;
+    }
+
+    totals->debounce_timer_end_ms = end_ms;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Audit - Member Update
+// ===================================
+static void sm_service_group_audit_member_update(
+    SmServiceGroupT* service_group, SmServiceGroupMemberT* service_group_member )
+{
+    SmServiceGroupMemberAuditT contribution;
+    char service_reason_text[SM_SERVICE_GROUP_REASON_TEXT_MAX_CHAR];
+
+    sm_service_group_audit_member_contribution( service_group,
+            service_group_member, &contribution, service_reason_text );
+
+    if(( SM_SERVICE_GROUP_STATUS_UNKNOWN == contribution.status )&&
+       (( !service_group_member->audit.counted )||
+        ( SM_SERVICE_GROUP_STATUS_UNKNOWN
+          != service_group_member->audit.status )))
+    {
         DPRINTFE( "Service (%s) has unmapped severity (%s) for service "
                   "group (%s).", service_group_member->service_name,
                   sm_service_severity_str(
@@ -448,82 +470,436 @@ static void sm_service_group_audit_service_for_status( void* user_data[],
                   service_group->name );
     }
 
-    if(( *status != service_group->status )&&( prev_status != *status ))
+    if( service_group_member->audit.counted )
+    {
+        if(( contribution.status != service_group_member->audit.status )||
+           ( contribution.condition != service_group_member->audit.condition ))
+        {
+            DPRINTFI( "Service group (%s) member (%s) has mapped status (%s) "
+                      "and condition (%s).", service_group_member->name,
+                      service_group_member->service_name,
+                      sm_service_group_status_str( contribution.status ),
+                      sm_service_group_condition_str( contribution.condition ) );
+        }
+
+        sm_service_group_audit_totals_apply( &(service_group->audit),
+                                    &(service_group_member->audit), -1 );
+    }
+
+    contribution.counted = true;
+    service_group_member->audit = contribution;
+
+    sm_service_group_audit_totals_apply( &(service_group->audit),
+                                         &contribution, 1 );
+
+    service_group->audit.reason_text_stale = true;
+
+    if( 0 != contribution.debounce_end_ms )
     {
-        DPRINTFI( "Service group (%s) member (%s) has mapped status (%s), "
-                  "overall_status=%s.", service_group_member->name,
-                  service_group_member->service_name,
-                  sm_service_group_status_str(mapped_status),
-                  sm_service_group_status_str(*status) );
+        sm_service_group_audit_debounce_schedule( service_group,
+                                                  contribution.debounce_end_ms );
     }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Audit - Rebuild Member
+// ====================================
+static void sm_service_group_audit_rebuild_member( void* user_data[],
+    SmServiceGroupMemberT* service_group_member )
+{
+    SmServiceGroupT* service_group = (SmServiceGroupT*) user_data[0];
+
+    service_group_member->audit.counted = false;
+
+    sm_service_group_audit_member_update( service_group, service_group_member );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Audit - Rebuild
+// =============================
+static void sm_service_group_audit_rebuild( SmServiceGroupT* service_group )
+{
+    SmServiceGroupAuditT* totals = &(service_group->audit);
+    SmTimerIdT debounce_timer_id = totals->debounce_timer_id;
+    long debounce_timer_end_ms = totals->debounce_timer_end_ms;
+    void* user_data[] = { service_group };
+
+    memset( totals, 0, sizeof(SmServiceGroupAuditT) );
+    totals->debounce_timer_id = debounce_timer_id;
+    totals->debounce_timer_end_ms = debounce_timer_end_ms;
+    totals->valid = true;
+    totals->generation = sm_service_group_member_table_generation();
+
+    sm_service_group_member_table_foreach_member( service_group->name,
+                    user_data, sm_service_group_audit_rebuild_member );
 
-    if(( *condition != service_group->condition )&&
-       ( prev_condition != *condition ))
+    DPRINTFD( "Service group (%s) audit totals rebuilt, failed=%i, "
+              "degraded=%i, warn=%i, healthy=%i.", service_group->name,
+              totals->failed, totals->degraded, totals->warn,
+              totals->healthy );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Audit - Debounce Member
+// =====================================
+static void sm_service_group_audit_debounce_member( void* user_data[],
+    SmServiceGroupMemberT* service_group_member )
+{
+    SmServiceGroupT* service_group = (SmServiceGroupT*) user_data[0];
+    long now_ms = *(long*) user_data[1];
+    long* next_end_ms = (long*) user_data[2];
+
+    if(( 0 != service_group_member->audit.debounce_end_ms )&&
+       ( now_ms >= service_group_member->audit.debounce_end_ms ))
     {
-        DPRINTFI( "Service group (%s) member (%s) has mapped condition (%s), "
-                  "overall_condition=%s.", service_group_member->name,
-                  service_group_member->service_name,
-                  sm_service_group_condition_str(mapped_condition),
-                  sm_service_group_condition_str(*condition) );
+        sm_service_group_audit_member_update( service_group,
+                                              service_group_member );
     }
 
-    if( SM_SERVICE_GROUP_STATUS_NONE != *status )
+    if(( 0 != service_group_member->audit.debounce_end_ms )&&
+       (( 0 == *next_end_ms )||
+        ( service_group_member->audit.debounce_end_ms < *next_end_ms )))
     {
-        if( prev_status != *status )
-        {
-            *reason_text_writable = true;
-            reason_text[0] = '\0';
-        }
+        *next_end_ms = service_group_member->audit.debounce_end_ms;
+    }
+}
+// ****************************************************************************
 
-        if(( '\0' != service_reason_text[0] )&&( *reason_text_writable ))
+// ****************************************************************************
+// Service Group Audit - Debounce Expire
+// =====================================
+// Refreshes the members whose debounce has ended and keeps the timer armed
+// for the earliest one still pending.
+static void sm_service_group_audit_debounce_expire(
+    SmServiceGroupT* service_group )
+{
+    long now_ms = sm_time_get_elapsed_ms( NULL );
+    long next_end_ms = 0;
+    void* user_data[] = { service_group, &now_ms, &next_end_ms };
+
+    sm_service_group_member_table_foreach_member( service_group->name,
+                    user_data, sm_service_group_audit_debounce_member );
+
+    if( 0 != next_end_ms )
+    {
+        sm_service_group_audit_debounce_schedule( service_group, next_end_ms );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Audit - Debounce Timeout
+// ======================================
+static bool sm_service_group_audit_debounce_timeout( SmTimerIdT timer_id,
+    int64_t user_data )
+{
+    int64_t id = user_data;
+    SmServiceGroupT* service_group;
+    SmErrorT error;
+
+    service_group = sm_service_group_table_read_by_id( id );
+    if( NULL == service_group )
+    {
+        DPRINTFE( "Failed to read service group, error=%s.",
+                  sm_error_str(SM_NOT_FOUND) );
+        return( false );
+    }
+
+    service_group->audit.debounce_timer_id = SM_TIMER_ID_INVALID;
+
+    if( !service_group->audit.valid )
+    {
+        return( false );
+    }
+
+    sm_service_group_audit_debounce_expire( service_group );
+
+    error = sm_service_group_fsm_event_handler( service_group->name,
+                SM_SERVICE_GROUP_EVENT_AUDIT, NULL, "failure debounce expired" );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to audit service group (%s), error=%s.",
+                  service_group->name, sm_error_str( error ) );
+    }
+
+    return( false );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Audit - Reason Text For Member
+// ============================================
+static void sm_service_group_audit_reason_text_for_member( void* user_data[],
+    SmServiceGroupMemberT* service_group_member )
+{
+    SmServiceGroupT* service_group = (SmServiceGroupT*) user_data[0];
+    SmServiceGroupStatusT* status = (SmServiceGroupStatusT*) user_data[1];
+    bool* reason_text_writable = (bool*) user_data[2];
+    char* reason_text = (char*) user_data[3];
+    SmServiceGroupMemberAuditT contribution;
+    char service_reason_text[SM_SERVICE_GROUP_REASON_TEXT_MAX_CHAR];
+
+    sm_service_group_audit_member_contribution( service_group,
+            service_group_member, &contribution, service_reason_text );
+
+    // Only members at or after the one raising the status are listed.
+    if(( SM_SERVICE_GROUP_STATUS_UNKNOWN != contribution.status )&&
+       ( contribution.status > *status ))
+    {
+        *status = contribution.status;
+        *reason_text_writable = true;
+        reason_text[0] = '\0';
+    }
+
+    if(( SM_SERVICE_GROUP_STATUS_NONE != *status )&&
+       ( '\0' != service_reason_text[0] )&&( *reason_text_writable ))
+    {
+        *reason_text_writable
+            = sm_service_group_audit_write_reason_text(
+                    service_reason_text, reason_text,
+                    SM_SERVICE_GROUP_REASON_TEXT_MAX_CHAR );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Audit - Reason Text
+// =================================
+static void sm_service_group_audit_reason_text( SmServiceGroupT* service_group )
+{
+    SmServiceGroupStatusT status = SM_SERVICE_GROUP_STATUS_NONE;
+    bool reason_text_writable = true;
+    char reason_text[SM_SERVICE_GROUP_REASON_TEXT_MAX_CHAR] = "";
+    void* user_data[] = { service_group, &status, &reason_text_writable,
+                          reason_text };
+
+    sm_service_group_member_table_foreach_member( service_group->name,
+                    user_data, sm_service_group_audit_reason_text_for_member );
+
+    snprintf( service_group->reason_text, sizeof(service_group->reason_text),
+              "%s", reason_text );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Audit - Derive Status
+// ===================================
+static void sm_service_group_audit_derive( SmServiceGroupAuditT* totals,
+    SmServiceGroupStatusT* status, SmServiceGroupConditionT* condition )
+{
+    int rank, best_rank = 0;
+
+    *status = SM_SERVICE_GROUP_STATUS_NONE;
+    *condition = SM_SERVICE_GROUP_CONDITION_NONE;
+
+    if( 0 < totals->status_count[SM_SERVICE_GROUP_STATUS_FAILED] )
+    {
+        *status = SM_SERVICE_GROUP_STATUS_FAILED;
+    } else if( 0 < totals->status_count[SM_SERVICE_GROUP_STATUS_DEGRADED] ) {
+        *status = SM_SERVICE_GROUP_STATUS_DEGRADED;
+    } else if( 0 < totals->status_count[SM_SERVICE_GROUP_STATUS_WARN] ) {
+        *status = SM_SERVICE_GROUP_STATUS_WARN;
+    }
+
+    // Equally ranked conditions resolve to the highest value.
+    int condition_i;
+    for( condition_i=0; SM_SERVICE_GROUP_CONDITION_MAX > condition_i;
+         ++condition_i )
+    {
+        if( 0 >= totals->condition_count[condition_i] )
+            continue;
+
+        rank = sm_service_group_audit_condition_rank(
+                                (SmServiceGroupConditionT) condition_i );
+        if( rank >= best_rank )
         {
-            *reason_text_writable
-                = sm_service_group_audit_write_reason_text(
-                        service_reason_text, reason_text, reason_text_size );
+            best_rank = rank;
+            *condition = (SmServiceGroupConditionT) condition_i;
         }
     }
 }
 // ****************************************************************************
 
+#ifdef SM_SERVICE_GROUP_AUDIT_VERIFY
+// ****************************************************************************
+// Service Group Audit - Verify Member
+// ===================================
+static void sm_service_group_audit_verify_member( void* user_data[],
+    SmServiceGroupMemberT* service_group_member )
+{
+    SmServiceGroupT* service_group = (SmServiceGroupT*) user_data[0];
+    SmServiceGroupAuditT* totals = (SmServiceGroupAuditT*) user_data[1];
+    SmServiceGroupMemberAuditT contribution;
+    char service_reason_text[SM_SERVICE_GROUP_REASON_TEXT_MAX_CHAR];
+
+    sm_service_group_audit_member_contribution( service_group,
+            service_group_member, &contribution, service_reason_text );
+
+    sm_service_group_audit_totals_apply( totals, &contribution, 1 );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Audit - Verify
+// ============================
+// Compares the running totals against a full recomputation.  Expired
+// debounces have been refreshed by the status audit before this runs.
+static void sm_service_group_audit_verify( SmServiceGroupT* service_group )
+{
+    SmServiceGroupAuditT* totals = &(service_group->audit);
+    SmServiceGroupAuditT recomputed;
+    void* user_data[] = { service_group, &recomputed };
+
+    memset( &recomputed, 0, sizeof(recomputed) );
+
+    sm_service_group_member_table_foreach_member( service_group->name,
+                    user_data, sm_service_group_audit_verify_member );
+
+    if(( recomputed.failed != totals->failed )||
+       ( recomputed.degraded != totals->degraded )||
+       ( recomputed.warn != totals->warn )||
+       ( recomputed.healthy != totals->healthy )||
+       ( recomputed.debounce_pending != totals->debounce_pending )||
+       ( 0 != memcmp( recomputed.status_count, totals->status_count,
+                      sizeof(recomputed.status_count) ) )||
+       ( 0 != memcmp( recomputed.condition_count, totals->condition_count,
+                      sizeof(recomputed.condition_count) ) ))
+    {
+        DPRINTFE( "Service group (%s) audit totals inconsistent, "
+                  "failed=%i/%i, degraded=%i/%i, warn=%i/%i, healthy=%i/%i, "
+                  "rebuilding.", service_group->name, totals->failed,
+                  recomputed.failed, totals->degraded, recomputed.degraded,
+                  totals->warn, recomputed.warn, totals->healthy,
+                  recomputed.healthy );
+
+        sm_service_group_audit_rebuild( service_group );
+    }
+}
+// ****************************************************************************
+#endif // SM_SERVICE_GROUP_AUDIT_VERIFY
+
+// ****************************************************************************
+// Service Group Audit - Member Changed
+// ====================================
+void sm_service_group_audit_member_changed(
+    SmServiceGroupMemberT* service_group_member )
+{
+    SmServiceGroupT* service_group;
+
+    service_group = sm_service_group_table_read( service_group_member->name );
+    if( NULL == service_group )
+    {
+        return;
+    }
+
+    // Stale totals are rebuilt by the next status audit.
+    if(( !service_group->audit.valid )||
+       ( sm_service_group_member_table_generation()
+         != service_group->audit.generation ))
+    {
+        return;
+    }
+
+    sm_service_group_audit_member_update( service_group, service_group_member );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Group Audit - Status
 // ============================
 SmErrorT sm_service_group_audit_status( SmServiceGroupT* service_group )
 {
-    int failed=0, degraded=0, warn=0, healthy=0;
-    SmServiceGroupStatusT audit_status = SM_SERVICE_GROUP_STATUS_NONE;
-    SmServiceGroupConditionT audit_condition = SM_SERVICE_GROUP_CONDITION_NONE;
-    int64_t audit_health = 0;
-    bool reason_text_writable = true;
-    char reason_text[SM_SERVICE_GROUP_REASON_TEXT_MAX_CHAR] = "";
-    int reason_text_size = SM_SERVICE_GROUP_REASON_TEXT_MAX_CHAR;
-    void* user_data[] = { service_group, &audit_status, &audit_condition,
-                          &failed, &degraded, &warn, &healthy, &reason_text_writable,
-                          reason_text, &reason_text_size };
+    SmServiceGroupAuditT* totals = &(service_group->audit);
+    SmServiceGroupStatusT audit_status;
+    SmServiceGroupConditionT audit_condition;
 
-    sm_service_group_member_table_foreach_member( service_group->name,
-                    user_data, sm_service_group_audit_service_for_status );
+    if(( !totals->valid )||
+       ( sm_service_group_member_table_generation() != totals->generation ))
+    {
+        sm_service_group_audit_rebuild( service_group );
+
+    } else if( 0 < totals->debounce_pending ) {
+        // A debounce that ended without its timer firing yet.
+        sm_service_group_audit_debounce_expire( service_group );
+    }
+
+#ifdef SM_SERVICE_GROUP_AUDIT_VERIFY
+    sm_service_group_audit_verify( service_group );
+#endif
 
-    audit_health = sm_service_group_health_calculate( failed, degraded, warn );
+    sm_service_group_audit_derive( totals, &audit_status, &audit_condition );
 
-    if(SM_SERVICE_GROUP_STATUS_FAILED == audit_status && 0 < healthy &&
+    if(SM_SERVICE_GROUP_STATUS_FAILED == audit_status && 0 < totals->healthy &&
         sm_is_aa_service_group(service_group->name))
     {
-        service_group->status = SM_SERVICE_GROUP_STATUS_DEGRADED;
-    }else
+        audit_status = SM_SERVICE_GROUP_STATUS_DEGRADED;
+    }
+
+    if(( audit_status != service_group->status )||
+       ( audit_condition != service_group->condition ))
     {
-        service_group->status = audit_status;
+        totals->reason_text_stale = true;
     }
+
+    service_group->status = audit_status;
     service_group->condition = audit_condition;
-    service_group->health = audit_health;
+    service_group->health = sm_service_group_health_calculate( totals->failed,
+                                            totals->degraded, totals->warn );
 
-    snprintf( service_group->reason_text, sizeof(service_group->reason_text),
-              "%s", reason_text );
+    if( totals->reason_text_stale )
+    {
+        if( 0 < totals->status_count[SM_SERVICE_GROUP_STATUS_WARN]
+              + totals->status_count[SM_SERVICE_GROUP_STATUS_DEGRADED]
+              + totals->status_count[SM_SERVICE_GROUP_STATUS_FAILED] )
+        {
+            sm_service_group_audit_reason_text( service_group );
+        } else {
+            service_group->reason_text[0] = '\0';
+        }
+
+        totals->reason_text_stale = false;
+    }
 
     return( SM_OKAY );
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Group Audit - Dump Service Group
+// ========================================
+static void sm_service_group_audit_dump_service_group( void* user_data[],
+    SmServiceGroupT* service_group )
+{
+    FILE* log = (FILE*) user_data[0];
+    SmServiceGroupAuditT* totals = &(service_group->audit);
+
+    fprintf( log, "  %-32s valid=%s, failed=%i, degraded=%i, warn=%i, "
+             "healthy=%i, debounce_pending=%i\n", service_group->name,
+             totals->valid ? "yes" : "no", totals->failed, totals->degraded,
+             totals->warn, totals->healthy, totals->debounce_pending );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Audit - Dump Data
+// ===============================
+void sm_service_group_audit_dump_data( FILE* log )
+{
+    void* user_data[] = { log };
+
+    fprintf( log, "--------------------------------------------------------------------\n" );
+    fprintf( log, "SERVICE GROUP AUDIT TOTALS\n" );
+
+    sm_service_group_table_foreach( user_data,
+                                    sm_service_group_audit_dump_service_group );
+
+    fprintf( log, "--------------------------------------------------------------------\n" );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Group Audit - Initialize
 // ================================
@@ -533,11 +909,30 @@ SmErrorT sm_service_group_audit_initialize( void )
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Group Audit - Finalize Service Group
+// ============================================
+static void sm_service_group_audit_finalize_service_group( void* user_data[],
+    SmServiceGroupT* service_group )
+{
+    if( SM_TIMER_ID_INVALID != service_group->audit.debounce_timer_id )
+    {
+        sm_timer_deregister( service_group->audit.debounce_timer_id );
+        service_group->audit.debounce_timer_id = SM_TIMER_ID_INVALID;
+    }
+
+    service_group->audit.valid = false;
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Group Audit - Finalize
 // ==============================
 SmErrorT sm_service_group_audit_finalize( void )
 {
+    sm_service_group_table_foreach( NULL,
+                            sm_service_group_audit_finalize_service_group );
+
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -6,11 +6,13 @@
 #ifndef __SM_SERVICE_GROUP_AUDIT_H__
 #define __SM_SERVICE_GROUP_AUDIT_H__
 
+#include <stdio.h>
 #include <stdbool.h>
 #include <stdint.h>
 
 #include "sm_types.h"
 #include "sm_service_group_table.h"
+#include "sm_service_group_member_table.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,6 +24,21 @@ extern "C" {
 extern SmErrorT sm_service_group_audit_status( SmServiceGroupT* service_group );
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Group Audit - Member Changed
+// ====================================
+// Moves the member's contribution in its service group's totals, call
+// after changing the member's service state, status or condition.
+extern void sm_service_group_audit_member_changed(
+    SmServiceGroupMemberT* service_group_member );
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Audit - Dump Data
+// ===============================
+extern void sm_service_group_audit_dump_data( FILE* log );
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Group Audit - Initialize
 // ================================
@@ -31,12 +31,14 @@
 #include "sm_service_group_go_standby.h"
 #include "sm_service_group_disable.h"
 #include "sm_service_group_audit.h"
+#include "sm_service_group_notification.h"
 #include "sm_service_api.h"
 #include "sm_log.h"
 #include "sm_node_utils.h"
 #include "sm_node_swact_monitor.h"
 #include "sm_failover_utils.h"
 #include "sm_swact_state.h"
+#include "sm_swact_profiler.h"
 
 static SmListT* _callbacks = NULL;
 
@@ -105,6 +107,8 @@ static void sm_service_group_fsm_update_service_group_member(
     {
         service_group_member->service_state = service->state;
         service_group_member->service_status = service->status;
+
+        sm_service_group_audit_member_changed( service_group_member );
     }
 }
 // ****************************************************************************
@@ -743,6 +747,7 @@ SmErrorT sm_service_group_fsm_event_handler( char service_group_name[],
     SmServiceGroupConditionT prev_condition;
     char prev_reason_text[SM_SERVICE_GROUP_REASON_TEXT_MAX_CHAR];
     SmServiceGroupT* service_group;
+    SmTimeT persist_start;
     SmErrorT error;
 
     service_group = sm_service_group_table_read( service_group_name );
@@ -903,6 +908,15 @@ SmErrorT sm_service_group_fsm_event_handler( char service_group_name[],
                   SM_SERVICE_GROUP_CONDITION_NONE == service_group->condition
                   ? "" : sm_service_group_condition_str( service_group->condition ) );
 
+        if( prev_state != service_group->state )
+        {
+            sm_swact_profiler_service_group_state( service_group_name,
+                                                   prev_state,
+                                                   service_group->state );
+        }
+
+        sm_time_get( &persist_start );
+
         error = sm_service_group_table_persist( service_group );
         if( SM_OKAY != error )
         {
@@ -911,6 +925,9 @@ SmErrorT sm_service_group_fsm_event_handler( char service_group_name[],
             return( error );
         }
 
+        sm_swact_profiler_persisted( service_group_name, true,
+                                     &persist_start );
+
         if(( prev_state != service_group->state )||
            ( prev_status != service_group->status ))
         { 
@@ -1025,6 +1042,8 @@ static void sm_service_group_fsm_service_scn( char service_name[],
                                     = sm_time_get_elapsed_ms( NULL );
     }
 
+    sm_service_group_audit_member_changed( service_group_member );
+
     if( SM_SERVICE_STATUS_NONE == status )
     {
         snprintf( reason_text, sizeof(reason_text), "%s service state "
@@ -1169,6 +1188,14 @@ SmErrorT sm_service_group_fsm_initialize( void )
         return( error );
     }
 
+    error = sm_service_group_notification_initialize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to initialize service group notification module, "
+                  "error=%s.", sm_error_str( error ) );
+        return( error );
+    }
+
     error = sm_service_api_register_callback( sm_service_group_fsm_service_scn );
     if( SM_OKAY != error )
     {
@@ -1287,6 +1314,13 @@ SmErrorT sm_service_group_fsm_finalize( void )
                   "error=%s.", sm_error_str( error ) );
     }
 
+    error = sm_service_group_notification_finalize();
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to finalize service group notification module, "
+                  "error=%s.", sm_error_str( error ) );
+    }
+
     return( SM_OKAY );
 }
 // ****************************************************************************
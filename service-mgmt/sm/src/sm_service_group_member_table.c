@@ -19,6 +19,7 @@
 
 static SmListT* _service_group_members = NULL;
 static SmDbHandleT* _sm_db_handle = NULL;
+static unsigned int _generation = 0;
 
 // ****************************************************************************
 // Service Group Member Table - Read
@@ -131,6 +132,15 @@ void sm_service_group_member_table_foreach_member( char service_group_name[],
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Group Member Table - Generation
+// =======================================
+unsigned int sm_service_group_member_table_generation( void )
+{
+    return( _generation );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Group Member Table - Add
 // ================================
@@ -181,6 +191,8 @@ static SmErrorT sm_service_group_member_table_add( void* user_data[],
         service_group_member->provisioned = db_service_group_member->provisioned;
     }
 
+    ++_generation;
+
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -235,6 +247,7 @@ SmErrorT sm_service_group_member_deprovision(char service_group_name[], char ser
 
     SM_LIST_REMOVE( _service_group_members, (SmListEntryDataPtrT) service_group_member );
     free(service_group_member);
+    ++_generation;
     return SM_OKAY;
 }
 
@@ -253,6 +266,8 @@ SmErrorT sm_service_group_member_table_load( void )
         _service_group_members = NULL;
     }
 
+    ++_generation;
+
     snprintf( db_query, sizeof(db_query), "%s = 'yes'",
               SM_SERVICE_GROUP_MEMBERS_TABLE_COLUMN_PROVISIONED );
 
@@ -15,6 +15,19 @@
 extern "C" {
 #endif
 
+// What a member adds to its service group's audit totals.
+typedef struct
+{
+    bool counted;
+    SmServiceGroupStatusT status;
+    SmServiceGroupConditionT condition;
+    bool failed;
+    bool degraded;
+    bool warn;
+    bool healthy;
+    long debounce_end_ms;
+} SmServiceGroupMemberAuditT;
+
 typedef struct
 {
     int64_t id;
@@ -26,6 +39,7 @@ typedef struct
     SmServiceSeverityT service_failure_impact;
     long service_failure_timestamp;
     bool provisioned;
+    SmServiceGroupMemberAuditT audit;
 } SmServiceGroupMemberT;
 
 typedef void (*SmServiceGroupMemberTableForEachCallbackT)
@@ -67,6 +81,13 @@ extern void sm_service_group_member_table_foreach_member(
     SmServiceGroupMemberTableForEachCallbackT callback );
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Group Member Table - Generation
+// =======================================
+// Changes whenever members are added, reloaded or removed.
+extern unsigned int sm_service_group_member_table_generation( void );
+// ****************************************************************************
+
 extern SmErrorT sm_service_group_member_provision(char service_group_name[], char service_name[]);
 
 extern SmErrorT sm_service_group_member_deprovision(char service_group_name[], char service_name[]);
@@ -14,6 +14,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/time.h>
@@ -26,6 +27,9 @@
 #include "sm_service_domain_member_table.h"
 #include "sm_service_group_table.h"
 #include "sm_service_group_fsm.h"
+#include "sm_task_affinity.h"
+#include "sm_spawner.h"
+#include "sm_configuration_table.h"
 
 typedef struct 
 {
@@ -44,8 +48,30 @@ typedef struct
 #define SM_NOTIFICATION_SCRIPT_SUCCESS                               0
 #define SM_NOTIFICATION_SCRIPT_TIMEOUT                          -65534
 #define SM_NOTIFICATION_SCRIPT_FAILURE                          -65535
+#define SM_NOTIFICATION_SCRIPT_NICE                                 -1
+#define SM_NOTIFICATION_ENV_MAX                                      8
+#define SM_NOTIFICATION_ENV_VAR_MAX_CHAR                           128
+#define SM_NOTIFICATION_HANDLER_KEY           "sm_notification_handler"
+#define SM_NOTIFICATION_LOG_FILE               "/tmp/sm-notification.log"
+
+// Handlers that are run inside sm rather than as the notification script,
+// sm-notification does nothing unless its log file is turned on.
+typedef enum
+{
+    SM_NOTIFICATION_HANDLER_SCRIPT,
+    SM_NOTIFICATION_HANDLER_BUILTIN_NONE,
+    SM_NOTIFICATION_HANDLER_BUILTIN_LOG,
+} SmNotificationHandlerT;
+
+typedef struct
+{
+    char* vars[SM_NOTIFICATION_ENV_MAX+1];
+    char data[SM_NOTIFICATION_ENV_MAX][SM_NOTIFICATION_ENV_VAR_MAX_CHAR];
+} SmNotificationEnvVarsT;
 
 static unsigned long _seqnum = 0;
+static SmNotificationHandlerT _handler = SM_NOTIFICATION_HANDLER_SCRIPT;
+static SmNotificationEnvVarsT _env_vars;
 
 
 // ****************************************************************************
@@ -372,6 +398,106 @@ static SmErrorT sm_service_group_notification_setup_env(
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Group Notification - Build Environment
+// ==============================================
+// Same variables as sm_service_group_notification_setup_env(), as
+// NAME=VALUE strings for the spawner.
+static void sm_service_group_notification_build_env( SmNotificationEnvT* env,
+    SmNotificationEnvVarsT* env_vars )
+{
+    unsigned int var_i = 0;
+
+#define SM_NOTIFICATION_ENV_ADD( name, value ) \
+    snprintf( env_vars->data[var_i], SM_NOTIFICATION_ENV_VAR_MAX_CHAR, \
+              "%s=%s", name, value ); \
+    env_vars->vars[var_i] = env_vars->data[var_i]; \
+    ++var_i
+
+    SM_NOTIFICATION_ENV_ADD( "NOTIFICATION_SEQNUM", env->seqnum_str );
+    SM_NOTIFICATION_ENV_ADD( "SERVICE_GROUP_NAME", env->service_group_name );
+    SM_NOTIFICATION_ENV_ADD( "SERVICE_GROUP_DESIRED_STATE",
+        sm_service_group_state_str( env->service_group_desired_state ) );
+    SM_NOTIFICATION_ENV_ADD( "SERVICE_GROUP_STATE",
+        sm_service_group_state_str( env->service_group_state ) );
+    SM_NOTIFICATION_ENV_ADD( "SERVICE_GROUP_NOTIFICATION",
+        sm_service_group_notification_str( env->service_group_notification ) );
+
+    if( env->part_of_aggregate )
+    {
+        SM_NOTIFICATION_ENV_ADD( "SERVICE_GROUP_AGGREGATE_NAME",
+            env->service_group_aggregate_name );
+        SM_NOTIFICATION_ENV_ADD( "SERVICE_GROUP_AGGREGATE_DESIRED_STATE",
+            sm_service_group_state_str(
+                env->service_group_aggregate_desired_state ) );
+        SM_NOTIFICATION_ENV_ADD( "SERVICE_GROUP_AGGREGATE_STATE",
+            sm_service_group_state_str(
+                env->service_group_aggregate_state ) );
+    }
+
+#undef SM_NOTIFICATION_ENV_ADD
+
+    env_vars->vars[var_i] = NULL;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Notification - Builtin Log
+// ========================================
+// Writes the record sm-notification writes when its log file is turned on.
+static void sm_service_group_notification_builtin_log( SmNotificationEnvT* env )
+{
+    char time_str[32];
+    struct tm t_real;
+    time_t now;
+    FILE* fp;
+
+    fp = fopen( SM_NOTIFICATION_LOG_FILE, "a" );
+    if( NULL == fp )
+    {
+        DPRINTFE( "Failed to open notification log (%s), error=%s.",
+                  SM_NOTIFICATION_LOG_FILE, strerror( errno ) );
+        return;
+    }
+
+    now = time( NULL );
+    if( NULL == localtime_r( &now, &t_real ) )
+    {
+        snprintf( time_str, sizeof(time_str), "YYYY-MM-DDTHH:MM:SS" );
+    } else {
+        strftime( time_str, sizeof(time_str), "%FT%T", &t_real );
+    }
+
+    fprintf( fp, "=======================================\n" );
+    fprintf( fp, "           TIME: %s\n", time_str );
+    fprintf( fp, "SEQUENCE_NUMBER: %s\n", env->seqnum_str );
+    fprintf( fp, "\n" );
+
+    if( env->part_of_aggregate )
+    {
+        fprintf( fp, "SERVICE_GROUP_AGGREGATE\n" );
+        fprintf( fp, "           name: %s\n",
+                 env->service_group_aggregate_name );
+        fprintf( fp, "  desired_state: %s\n", sm_service_group_state_str(
+                 env->service_group_aggregate_desired_state ) );
+        fprintf( fp, "          state: %s\n", sm_service_group_state_str(
+                 env->service_group_aggregate_state ) );
+        fprintf( fp, "\n" );
+    }
+
+    fprintf( fp, "SERVICE_GROUP\n" );
+    fprintf( fp, "           name: %s\n", env->service_group_name );
+    fprintf( fp, "  desired_state: %s\n",
+             sm_service_group_state_str( env->service_group_desired_state ) );
+    fprintf( fp, "          state: %s\n",
+             sm_service_group_state_str( env->service_group_state ) );
+    fprintf( fp, "   notification: %s\n", sm_service_group_notification_str(
+             env->service_group_notification ) );
+
+    fclose( fp );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Group Notification - Run
 // ================================
@@ -389,6 +515,27 @@ static SmErrorT sm_service_group_notification_run( char service_group_name[],
 
     memset( &env, 0, sizeof(SmNotificationEnvT) );
 
+    if( SM_NOTIFICATION_HANDLER_SCRIPT != _handler )
+    {
+        if( SM_NOTIFICATION_HANDLER_BUILTIN_LOG == _handler )
+        {
+            error = sm_service_group_notification_get_env( service_group_name,
+                                                           notification, &env );
+            if( SM_OKAY != error )
+            {
+                DPRINTFE( "Failed to get environment for service group (%s) "
+                          "notification (%s), error=%s.", service_group_name,
+                          sm_service_group_notification_str(notification),
+                          sm_error_str( error ) );
+                return( SM_FAILED );
+            }
+
+            sm_service_group_notification_builtin_log( &env );
+        }
+
+        return( SM_OKAY );
+    }
+
     if( 0 > access( SM_NOTIFICATION_SCRIPT,  F_OK | X_OK ) )
     {
         DPRINTFE( "Service group notification script access failed, "
@@ -420,6 +567,42 @@ static SmErrorT sm_service_group_notification_run( char service_group_name[],
         return( SM_FAILED );
     }
 
+    if( sm_spawner_available() )
+    {
+        SmSpawnerRequestT request;
+
+        snprintf( program_name, sizeof(program_name), "%s",
+                  SM_NOTIFICATION_SCRIPT );
+
+        char* argv[] = {program_name, NULL};
+
+        sm_service_group_notification_build_env( &env, &_env_vars );
+
+        memset( &request, 0, sizeof(request) );
+        request.argv = argv;
+        request.envp = _env_vars.vars;
+        request.cwd = NULL;
+        request.nice = SM_NOTIFICATION_SCRIPT_NICE;
+        request.force_exit = false;
+        request.failure_exit_code = SM_NOTIFICATION_SCRIPT_FAILURE;
+
+        error = sm_spawner_spawn( &request, &pid );
+        if( SM_OKAY == error )
+        {
+            *process_id = (int) pid;
+
+            DPRINTFD( "Spawned notification process (%i) for service group "
+                      "(%s) notification (%s).", *process_id,
+                      service_group_name,
+                      sm_service_group_notification_str(notification) );
+            return( SM_OKAY );
+        }
+
+        DPRINTFE( "Failed to spawn notification process for service group "
+                  "(%s), forking instead, error=%s.", service_group_name,
+                  sm_error_str( error ) );
+    }
+
     pid = fork();
     if( 0 > pid )
     {
@@ -429,8 +612,6 @@ static SmErrorT sm_service_group_notification_run( char service_group_name[],
 
     } else if( 0 == pid ) {
         // Child process.
-        struct rlimit file_limits;
-
         DPRINTFD( "Child notification process created for service group "
                   "(%s).", service_group_name );
 
@@ -444,20 +625,7 @@ static SmErrorT sm_service_group_notification_run( char service_group_name[],
             exit( SM_NOTIFICATION_SCRIPT_FAILURE );
         }
 
-        if( 0 > getrlimit( RLIMIT_NOFILE, &file_limits ) )
-        {
-            DPRINTFE( "Failed to get file limits for service group (%s) "
-                      "notification (%s), error=%s.", service_group_name,
-                      sm_service_group_notification_str(notification),
-                      strerror( errno ) );
-            exit( SM_NOTIFICATION_SCRIPT_FAILURE );
-        }
-
-        unsigned int fd_i;
-        for( fd_i=0; fd_i < file_limits.rlim_cur; ++fd_i )
-        {
-            close( fd_i );
-        }
+        sm_utils_close_fds( 0 );
 
         if( 0 > open( "/dev/null", O_RDONLY ) )
         {
@@ -483,7 +651,8 @@ static SmErrorT sm_service_group_notification_run( char service_group_name[],
                       strerror( errno ) );
         }
 
-        result = setpriority( PRIO_PROCESS, getpid(), -1 );
+        result = setpriority( PRIO_PROCESS, getpid(),
+                              SM_NOTIFICATION_SCRIPT_NICE );
         if( 0 > result )
         {
             DPRINTFE( "Failed to set priority of process, error=%s.",
@@ -491,6 +660,8 @@ static SmErrorT sm_service_group_notification_run( char service_group_name[],
             exit( SM_NOTIFICATION_SCRIPT_FAILURE );
         }
 
+        sm_task_affinity_restore_child();
+
         error = sm_service_group_notification_setup_env( &env );
         if( SM_OKAY != error )
         {
@@ -589,31 +760,15 @@ static bool sm_service_group_notification_timeout( SmTimerIdT timer_id,
 // ****************************************************************************
 
 // ****************************************************************************
-// Service Group Notification - Complete
-// =====================================
-static void sm_service_group_notification_complete( pid_t pid, int exit_code,
-    int64_t user_data )
+// Service Group Notification - Result
+// ===================================
+static void sm_service_group_notification_result(
+    SmServiceGroupT* service_group, int exit_code )
 {
-    SmServiceGroupT* service_group;
     SmServiceGroupEventT event;
     char reason_text[SM_SERVICE_GROUP_REASON_TEXT_MAX_CHAR] = "";
     SmErrorT error;
 
-    service_group = sm_service_group_table_read_by_notification_pid( (int) pid );
-    if( NULL == service_group )
-    {
-        DPRINTFE( "Failed to query service group based on pid (%i), error=%s.",
-                  (int) pid, sm_error_str(SM_NOT_FOUND) );
-        return;
-    }
-    
-    if( -1 == service_group->notification_pid )
-    {
-        DPRINTFE( "Service group (%s) not running notification script.",
-                  service_group->name );
-        return;
-    }
-
     if( SM_TIMER_ID_INVALID != service_group->notification_timer_id )
     {
         error = sm_timer_deregister( service_group->notification_timer_id );
@@ -668,6 +823,69 @@ static void sm_service_group_notification_complete( pid_t pid, int exit_code,
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Group Notification - Complete
+// =====================================
+static void sm_service_group_notification_complete( pid_t pid, int exit_code,
+    int64_t user_data )
+{
+    SmServiceGroupT* service_group;
+
+    service_group = sm_service_group_table_read_by_notification_pid( (int) pid );
+    if( NULL == service_group )
+    {
+        DPRINTFE( "Failed to query service group based on pid (%i), error=%s.",
+                  (int) pid, sm_error_str(SM_NOT_FOUND) );
+        return;
+    }
+    
+    if( -1 == service_group->notification_pid )
+    {
+        DPRINTFE( "Service group (%s) not running notification script.",
+                  service_group->name );
+        return;
+    }
+
+    sm_service_group_notification_result( service_group, exit_code );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Group Notification - Builtin Complete
+// =============================================
+// Builtin handlers finish before the notify returns, the result is delivered
+// from the timer so the fsm sees it after the state entry, as it would for
+// the script.
+static bool sm_service_group_notification_builtin_complete(
+    SmTimerIdT timer_id, int64_t user_data )
+{
+    int64_t id = user_data;
+    SmServiceGroupT* service_group;
+
+    service_group = sm_service_group_table_read_by_id( id );
+    if( NULL == service_group )
+    {
+        DPRINTFE( "Failed to read service group, error=%s.",
+                  sm_error_str(SM_NOT_FOUND) );
+        return( false );
+    }
+
+    if( timer_id != service_group->notification_timer_id )
+    {
+        DPRINTFE( "Service group (%s) builtin notification not running.",
+                  service_group->name );
+        return( false );
+    }
+
+    // Returning false releases the timer.
+    service_group->notification_timer_id = SM_TIMER_ID_INVALID;
+
+    sm_service_group_notification_result( service_group,
+                                          SM_NOTIFICATION_SCRIPT_SUCCESS );
+    return( false );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Group Notification - Notify
 // ===================================
@@ -694,25 +912,32 @@ SmErrorT sm_service_group_notification_notify( SmServiceGroupT* service_group,
         return( error );
     }
    
-    // Register for notification script exit.
-    error = sm_process_death_register( process_id, true,
-                                       sm_service_group_notification_complete,
-                                       0 );
-    if( SM_OKAY != error )
-    {
-        DPRINTFE( "Failed to register for notification completion for "
-                  "service group (%s), error=%s.", service_group->name,
-                  sm_error_str( error ) );
-        abort();
-    }
-
     // Create timer for notification completion.
     snprintf( timer_name, sizeof(timer_name), "%s %s notification ",
               service_group->name, notification_str );
 
-    error = sm_timer_register( timer_name, timeout_in_ms,
-                               sm_service_group_notification_timeout,
+    if( SM_NOTIFICATION_HANDLER_SCRIPT == _handler )
+    {
+        // Register for notification script exit.
+        error = sm_process_death_register( process_id, true,
+                                       sm_service_group_notification_complete,
+                                       0 );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to register for notification completion for "
+                      "service group (%s), error=%s.", service_group->name,
+                      sm_error_str( error ) );
+            abort();
+        }
+
+        error = sm_timer_register( timer_name, timeout_in_ms,
+                                   sm_service_group_notification_timeout,
+                                   service_group->id, &timer_id );
+    } else {
+        error = sm_timer_register( timer_name, 0,
+                               sm_service_group_notification_builtin_complete,
                                service_group->id, &timer_id );
+    }
     if( SM_OKAY != error )
     {
         DPRINTFE( "Failed to create a timer for notification for service "
@@ -793,6 +1018,31 @@ SmErrorT sm_service_group_notification_abort( SmServiceGroupT* service_group )
 // =======================================
 SmErrorT sm_service_group_notification_initialize( void )
 {
+    char buf[32] = "";
+
+    _handler = SM_NOTIFICATION_HANDLER_SCRIPT;
+
+    if( SM_OKAY == sm_configuration_table_get( SM_NOTIFICATION_HANDLER_KEY,
+                                               buf, sizeof(buf)-1 ) )
+    {
+        if( 0 == strcmp( "builtin-none", buf ) )
+        {
+            _handler = SM_NOTIFICATION_HANDLER_BUILTIN_NONE;
+
+        } else if( 0 == strcmp( "builtin-log", buf ) ) {
+            _handler = SM_NOTIFICATION_HANDLER_BUILTIN_LOG;
+
+        } else if(( '\0' != buf[0] )&&( 0 != strcmp( "script", buf ) )) {
+            DPRINTFE( "Unknown notification handler (%s), using script.",
+                      buf );
+        }
+    }
+
+    DPRINTFI( "Service group notification handler is %s.",
+              ( SM_NOTIFICATION_HANDLER_SCRIPT == _handler ) ? "script"
+              : ( SM_NOTIFICATION_HANDLER_BUILTIN_NONE == _handler )
+              ? "builtin-none" : "builtin-log" );
+
     return( SM_OKAY );
 }
 // ****************************************************************************
@@ -802,6 +1052,8 @@ SmErrorT sm_service_group_notification_initialize( void )
 // =====================================
 SmErrorT sm_service_group_notification_finalize( void )
 {
+    _handler = SM_NOTIFICATION_HANDLER_SCRIPT;
+
     return( SM_OKAY );
 }
 // ****************************************************************************
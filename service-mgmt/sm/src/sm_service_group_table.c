@@ -146,6 +146,8 @@ static SmErrorT sm_service_group_table_add( void* user_data[], void* record )
         service_group->notification_complete = false;
         service_group->notification_failed = false;
         service_group->notification_timeout = false;
+        service_group->audit.valid = false;
+        service_group->audit.debounce_timer_id = SM_TIMER_ID_INVALID;
 
         SM_LIST_PREPEND( _service_groups, (SmListEntryDataPtrT) service_group );
 
@@ -157,6 +159,7 @@ static SmErrorT sm_service_group_table_add( void* user_data[], void* record )
             = db_service_group->failure_debounce_in_ms;
         service_group->fatal_error_reboot
             = db_service_group->fatal_error_reboot;
+        service_group->audit.valid = false;
     }
 
     return( SM_OKAY );
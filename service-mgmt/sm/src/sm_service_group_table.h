@@ -16,6 +16,23 @@
 extern "C" {
 #endif
 
+// Running totals of the members' audit contributions.
+typedef struct
+{
+    bool valid;
+    unsigned int generation;
+    int failed;
+    int degraded;
+    int warn;
+    int healthy;
+    int debounce_pending;
+    int status_count[SM_SERVICE_GROUP_STATUS_MAX];
+    int condition_count[SM_SERVICE_GROUP_CONDITION_MAX];
+    bool reason_text_stale;
+    SmTimerIdT debounce_timer_id;
+    long debounce_timer_end_ms;
+} SmServiceGroupAuditT;
+
 typedef struct
 {
     int64_t id;
@@ -37,6 +54,7 @@ typedef struct
     bool notification_complete;
     bool notification_failed;
     bool notification_timeout;
+    SmServiceGroupAuditT audit;
 } SmServiceGroupT;
 
 typedef void (*SmServiceGroupTableForEachCallbackT) 
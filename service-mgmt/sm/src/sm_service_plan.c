@@ -0,0 +1,952 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "sm_service_plan.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_configuration_table.h"
+#include "sm_service_table.h"
+#include "sm_service_dependency_table.h"
+#include "sm_service_action_stats.h"
+
+#define SM_SERVICE_PLAN_SERVICES_MAX                                 512
+#define SM_SERVICE_PLAN_PREREQS_MAX                                   32
+#define SM_SERVICE_PLAN_DURATION_DEFAULT_IN_MS                      1000
+#define SM_SERVICE_PLAN_CONCURRENCY_DEFAULT                            8
+#define SM_SERVICE_PLAN_CONCURRENCY_KEY           "sm_go_active_concurrency"
+#define SM_SERVICE_PLAN_ENABLING_THROTTLE_DEFAULT                      2
+
+typedef enum
+{
+    SM_SERVICE_PLAN_STEP_ENABLE,
+    SM_SERVICE_PLAN_STEP_GO_ACTIVE,
+    SM_SERVICE_PLAN_STEP_MAX,
+} SmServicePlanStepTypeT;
+
+#define SM_SERVICE_PLAN_STEPS_MAX \
+    ( SM_SERVICE_PLAN_SERVICES_MAX * SM_SERVICE_PLAN_STEP_MAX )
+#define SM_SERVICE_PLAN_STEP_ID( node_i, step_type ) \
+    ( (node_i) * SM_SERVICE_PLAN_STEP_MAX + (step_type) )
+
+typedef struct
+{
+    bool action_exists;
+    long duration_ms;
+    long priority_ms;
+    unsigned int num_prereqs;
+    unsigned int prereqs[SM_SERVICE_PLAN_PREREQS_MAX];
+} SmServicePlanStepT;
+
+typedef struct
+{
+    SmServiceT* service;
+    char name[SM_SERVICE_NAME_MAX_CHAR];
+    char group_name[SM_SERVICE_GROUP_NAME_MAX_CHAR];
+    bool waiting;
+    SmServicePlanStepT steps[SM_SERVICE_PLAN_STEP_MAX];
+} SmServicePlanNodeT;
+
+typedef struct
+{
+    long start_ms[SM_SERVICE_PLAN_STEPS_MAX];
+    long finish_ms[SM_SERVICE_PLAN_STEPS_MAX];
+    long makespan_ms;
+    unsigned int unscheduled;
+} SmServicePlanScheduleT;
+
+static unsigned int _num_nodes = 0;
+static SmServicePlanNodeT _nodes[SM_SERVICE_PLAN_SERVICES_MAX];
+static unsigned int _order[SM_SERVICE_PLAN_SERVICES_MAX];
+static bool _built = false;
+static bool _overflow = false;
+static bool _cyclic = false;
+static bool _reweigh = true;
+static unsigned int _generation = 0;
+static unsigned int _concurrency = SM_SERVICE_PLAN_CONCURRENCY_DEFAULT;
+static unsigned int _dropped_prereqs = 0;
+static long _critical_path_ms = 0;
+static uint64_t _rebuilds = 0;
+static uint64_t _reweighs = 0;
+static uint64_t _deferred = 0;
+static SmServicePlanScheduleT _schedule[2];
+
+// ****************************************************************************
+// Service Plan - Step Type String
+// ===============================
+static const char* sm_service_plan_step_str( unsigned int step_type )
+{
+    if( SM_SERVICE_PLAN_STEP_ENABLE == step_type )
+    {
+        return( "enable" );
+    }
+
+    return( "go-active" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Find Node
+// ========================
+static int sm_service_plan_find_node( const char service_name[] )
+{
+    unsigned int node_i;
+    for( node_i=0; _num_nodes > node_i; ++node_i )
+    {
+        if( 0 == strcmp( service_name, _nodes[node_i].name ) )
+        {
+            return( (int) node_i );
+        }
+    }
+
+    return( -1 );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Add Node
+// =======================
+static void sm_service_plan_add_node( void* user_data[], SmServiceT* service )
+{
+    SmServicePlanNodeT* node;
+
+    if( SM_SERVICE_PLAN_SERVICES_MAX <= _num_nodes )
+    {
+        _overflow = true;
+        return;
+    }
+
+    node = &(_nodes[_num_nodes]);
+    memset( node, 0, sizeof(SmServicePlanNodeT) );
+
+    node->service = service;
+    snprintf( node->name, sizeof(node->name), "%s", service->name );
+    snprintf( node->group_name, sizeof(node->group_name), "%s",
+              service->group_name );
+    node->steps[SM_SERVICE_PLAN_STEP_ENABLE].action_exists
+        = service->enable_action_exists;
+    node->steps[SM_SERVICE_PLAN_STEP_GO_ACTIVE].action_exists
+        = service->go_active_action_exists;
+
+    _order[_num_nodes] = _num_nodes;
+    ++_num_nodes;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Add Prerequisite
+// ===============================
+static void sm_service_plan_add_prereq( SmServicePlanStepT* step,
+    unsigned int prereq )
+{
+    unsigned int prereq_i;
+    for( prereq_i=0; step->num_prereqs > prereq_i; ++prereq_i )
+    {
+        if( prereq == step->prereqs[prereq_i] )
+        {
+            return;
+        }
+    }
+
+    if( SM_SERVICE_PLAN_PREREQS_MAX <= step->num_prereqs )
+    {
+        ++_dropped_prereqs;
+        return;
+    }
+
+    step->prereqs[step->num_prereqs++] = prereq;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Add Dependency
+// =============================
+// An action dependency waits for the dependent to reach a state, which for
+// a plan towards enabled-active is the end of its go-active step when the
+// state is enabled-active and the end of its enable step otherwise.
+static void sm_service_plan_add_dependency( void* user_data[],
+    SmServiceDependencyT* service_dependency )
+{
+    SmServicePlanStepT* step = (SmServicePlanStepT*) user_data[0];
+    int dependent_i;
+
+    dependent_i = sm_service_plan_find_node( service_dependency->dependent );
+    if( 0 > dependent_i )
+    {
+        return;
+    }
+
+    if( SM_SERVICE_STATE_ENABLED_ACTIVE == service_dependency->dependent_state )
+    {
+        sm_service_plan_add_prereq( step, SM_SERVICE_PLAN_STEP_ID( dependent_i,
+                                    SM_SERVICE_PLAN_STEP_GO_ACTIVE ) );
+    } else {
+        sm_service_plan_add_prereq( step, SM_SERVICE_PLAN_STEP_ID( dependent_i,
+                                    SM_SERVICE_PLAN_STEP_ENABLE ) );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Build
+// ====================
+static void sm_service_plan_build( void )
+{
+    SmServicePlanNodeT* node;
+    void* user_data[1];
+
+    _num_nodes = 0;
+    _overflow = false;
+    _dropped_prereqs = 0;
+
+    sm_service_table_foreach( NULL, sm_service_plan_add_node );
+
+    unsigned int node_i;
+    for( node_i=0; _num_nodes > node_i; ++node_i )
+    {
+        node = &(_nodes[node_i]);
+
+        user_data[0] = &(node->steps[SM_SERVICE_PLAN_STEP_ENABLE]);
+        sm_service_dependency_table_foreach( SM_SERVICE_DEPENDENCY_TYPE_ACTION,
+                        node->name, SM_SERVICE_STATE_NA,
+                        SM_SERVICE_ACTION_ENABLE, user_data,
+                        sm_service_plan_add_dependency );
+
+        sm_service_plan_add_prereq( &(node->steps[SM_SERVICE_PLAN_STEP_GO_ACTIVE]),
+                        SM_SERVICE_PLAN_STEP_ID( node_i, SM_SERVICE_PLAN_STEP_ENABLE ) );
+
+        user_data[0] = &(node->steps[SM_SERVICE_PLAN_STEP_GO_ACTIVE]);
+        sm_service_dependency_table_foreach( SM_SERVICE_DEPENDENCY_TYPE_ACTION,
+                        node->name, SM_SERVICE_STATE_NA,
+                        SM_SERVICE_ACTION_GO_ACTIVE, user_data,
+                        sm_service_plan_add_dependency );
+    }
+
+    if( _overflow )
+    {
+        DPRINTFE( "More than %i services, go-active planning disabled.",
+                  SM_SERVICE_PLAN_SERVICES_MAX );
+    }
+
+    if( 0 < _dropped_prereqs )
+    {
+        DPRINTFE( "Dropped %u dependencies beyond %i per step.",
+                  _dropped_prereqs, SM_SERVICE_PLAN_PREREQS_MAX );
+    }
+
+    _generation = sm_service_table_generation();
+    _built = true;
+    ++_rebuilds;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Weigh
+// ====================
+// Weighs each step by the average wall time of its action so far.
+static void sm_service_plan_weigh( void )
+{
+    static const SmServiceActionT actions[SM_SERVICE_PLAN_STEP_MAX]
+        = { SM_SERVICE_ACTION_ENABLE, SM_SERVICE_ACTION_GO_ACTIVE };
+    SmServiceActionStatsT* stats;
+    SmServicePlanStepT* step;
+
+    unsigned int node_i;
+    for( node_i=0; _num_nodes > node_i; ++node_i )
+    {
+        unsigned int step_i;
+        for( step_i=0; SM_SERVICE_PLAN_STEP_MAX > step_i; ++step_i )
+        {
+            step = &(_nodes[node_i].steps[step_i]);
+
+            if( !step->action_exists )
+            {
+                step->duration_ms = 0;
+                continue;
+            }
+
+            stats = sm_service_action_stats_read( _nodes[node_i].name,
+                                                  actions[step_i] );
+            if(( NULL != stats )&&( 0 < stats->count ))
+            {
+                step->duration_ms = (long) (stats->wall_total_ms / stats->count);
+            } else {
+                step->duration_ms = SM_SERVICE_PLAN_DURATION_DEFAULT_IN_MS;
+            }
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Prioritize
+// =========================
+// The priority of a step is the length of the longest path from its start
+// to the end of the plan.  Services are ordered by the priority of their
+// first step, ties keep table order.
+static void sm_service_plan_prioritize( void )
+{
+    unsigned int num_steps = _num_nodes * SM_SERVICE_PLAN_STEP_MAX;
+    SmServicePlanStepT* step;
+    SmServicePlanStepT* prereq;
+    bool changed = true;
+    unsigned int pass = 0;
+
+    unsigned int step_id;
+    for( step_id=0; num_steps > step_id; ++step_id )
+    {
+        step = &(_nodes[step_id / SM_SERVICE_PLAN_STEP_MAX]
+                 .steps[step_id % SM_SERVICE_PLAN_STEP_MAX]);
+        step->priority_ms = step->duration_ms;
+    }
+
+    while(( changed )&&( num_steps >= pass ))
+    {
+        changed = false;
+        ++pass;
+
+        for( step_id=0; num_steps > step_id; ++step_id )
+        {
+            step = &(_nodes[step_id / SM_SERVICE_PLAN_STEP_MAX]
+                     .steps[step_id % SM_SERVICE_PLAN_STEP_MAX]);
+
+            unsigned int prereq_i;
+            for( prereq_i=0; step->num_prereqs > prereq_i; ++prereq_i )
+            {
+                unsigned int prereq_id = step->prereqs[prereq_i];
+
+                prereq = &(_nodes[prereq_id / SM_SERVICE_PLAN_STEP_MAX]
+                           .steps[prereq_id % SM_SERVICE_PLAN_STEP_MAX]);
+
+                if( prereq->duration_ms + step->priority_ms
+                    > prereq->priority_ms )
+                {
+                    prereq->priority_ms = prereq->duration_ms
+                                        + step->priority_ms;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    if( changed != _cyclic )
+    {
+        if( changed )
+        {
+            DPRINTFE( "Service action dependencies have a cycle, go-active "
+                      "priorities are approximate." );
+        } else {
+            DPRINTFI( "Service action dependencies no longer have a cycle." );
+        }
+        _cyclic = changed;
+    }
+
+    _critical_path_ms = 0;
+
+    unsigned int order_i;
+    for( order_i=0; _num_nodes > order_i; ++order_i )
+    {
+        unsigned int node_i = _order[order_i];
+        long priority_ms
+            = _nodes[node_i].steps[SM_SERVICE_PLAN_STEP_ENABLE].priority_ms;
+
+        if( priority_ms > _critical_path_ms )
+        {
+            _critical_path_ms = priority_ms;
+        }
+
+        unsigned int insert_i = order_i;
+        while(( 0 < insert_i )&&
+              (( _nodes[_order[insert_i-1]].steps[SM_SERVICE_PLAN_STEP_ENABLE]
+                 .priority_ms < priority_ms )||
+               (( _nodes[_order[insert_i-1]].steps[SM_SERVICE_PLAN_STEP_ENABLE]
+                  .priority_ms == priority_ms )&&( _order[insert_i-1] > node_i ))))
+        {
+            _order[insert_i] = _order[insert_i-1];
+            --insert_i;
+        }
+        _order[insert_i] = node_i;
+    }
+
+    ++_reweighs;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Refresh
+// ======================
+static void sm_service_plan_refresh( void )
+{
+    if(( !_built )||( _generation != sm_service_table_generation() ))
+    {
+        sm_service_plan_build();
+        sm_service_plan_weigh();
+        sm_service_plan_prioritize();
+        _reweigh = false;
+
+        DPRINTFI( "Planned go-active of %u services, critical path %li ms, "
+                  "concurrency %u.", _num_nodes, _critical_path_ms,
+                  _concurrency );
+
+    } else if( _reweigh ) {
+        sm_service_plan_weigh();
+        sm_service_plan_prioritize();
+        _reweigh = false;
+
+        DPRINTFD( "Reweighed go-active plan, critical path %li ms.",
+                  _critical_path_ms );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Invalidate
+// =========================
+void sm_service_plan_invalidate( void )
+{
+    _reweigh = true;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - For Each
+// =======================
+void sm_service_plan_foreach( void* user_data[],
+    SmServiceTableForEachCallbackT callback )
+{
+    sm_service_plan_refresh();
+
+    if( _overflow )
+    {
+        sm_service_table_foreach( user_data, callback );
+        return;
+    }
+
+    unsigned int order_i;
+    for( order_i=0; _num_nodes > order_i; ++order_i )
+    {
+        // A callback that changes the service table ends the walk, the
+        // next sweep walks the new plan.
+        if( _generation != sm_service_table_generation() )
+        {
+            DPRINTFD( "Services changed during sweep." );
+            break;
+        }
+
+        callback( user_data, _nodes[_order[order_i]].service );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Go-Active Acquire
+// ================================
+bool sm_service_plan_go_active_acquire( SmServiceT* service )
+{
+    SmServicePlanNodeT* node;
+    SmServicePlanNodeT* self = NULL;
+    unsigned int running = 0;
+    unsigned int held = 0;
+
+    sm_service_plan_refresh();
+
+    if(( 0 == _concurrency )||( _overflow ))
+    {
+        return( true );
+    }
+
+    unsigned int order_i;
+    for( order_i=0; _num_nodes > order_i; ++order_i )
+    {
+        node = &(_nodes[_order[order_i]]);
+
+        if( service == node->service )
+        {
+            self = node;
+            continue;
+        }
+
+        if( SM_SERVICE_ACTION_GO_ACTIVE == node->service->action_running )
+        {
+            ++running;
+            node->waiting = false;
+
+        } else if( node->waiting ) {
+            if(( SM_SERVICE_STATE_ENABLED_GO_ACTIVE != node->service->state )||
+               ( SM_SERVICE_STATE_ENABLED_ACTIVE
+                 != node->service->desired_state ))
+            {
+                node->waiting = false;
+
+            } else if( NULL == self ) {
+                // Ready and on a longer path, keep a slot for it.
+                ++held;
+            }
+        }
+    }
+
+    if( NULL == self )
+    {
+        return( true );
+    }
+
+    if( _concurrency <= running + held )
+    {
+        if( !self->waiting )
+        {
+            DPRINTFI( "Deferring go-active of service (%s), running=%u, "
+                      "held=%u, concurrency=%u.", service->name, running,
+                      held, _concurrency );
+            ++_deferred;
+        }
+        self->waiting = true;
+        return( false );
+    }
+
+    self->waiting = false;
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Schedule
+// =======================
+// List schedules the plan with the given step budgets, zero is unlimited.
+// Steps without an action finish as soon as they are ready.
+static void sm_service_plan_schedule( bool plan_order,
+    unsigned int enable_budget, unsigned int go_active_budget,
+    SmServicePlanScheduleT* schedule )
+{
+    unsigned int num_steps = _num_nodes * SM_SERVICE_PLAN_STEP_MAX;
+    unsigned int budget[SM_SERVICE_PLAN_STEP_MAX];
+    unsigned int running[SM_SERVICE_PLAN_STEP_MAX] = {0};
+    SmServicePlanStepT* step;
+    long now_ms = 0;
+    bool launched;
+
+    budget[SM_SERVICE_PLAN_STEP_ENABLE] = enable_budget;
+    budget[SM_SERVICE_PLAN_STEP_GO_ACTIVE] = go_active_budget;
+
+    unsigned int step_id;
+    for( step_id=0; num_steps > step_id; ++step_id )
+    {
+        schedule->start_ms[step_id] = -1;
+        schedule->finish_ms[step_id] = -1;
+    }
+
+    schedule->makespan_ms = 0;
+    schedule->unscheduled = 0;
+
+    for( ;; )
+    {
+        do
+        {
+            launched = false;
+
+            unsigned int order_i;
+            for( order_i=0; _num_nodes > order_i; ++order_i )
+            {
+                unsigned int node_i = plan_order ? _order[order_i] : order_i;
+
+                unsigned int step_i;
+                for( step_i=0; SM_SERVICE_PLAN_STEP_MAX > step_i; ++step_i )
+                {
+                    step_id = SM_SERVICE_PLAN_STEP_ID( node_i, step_i );
+                    step = &(_nodes[node_i].steps[step_i]);
+
+                    if( 0 <= schedule->start_ms[step_id] )
+                        continue;
+
+                    bool ready = true;
+
+                    unsigned int prereq_i;
+                    for( prereq_i=0; step->num_prereqs > prereq_i; ++prereq_i )
+                    {
+                        long finish_ms
+                            = schedule->finish_ms[step->prereqs[prereq_i]];
+
+                        if(( 0 > finish_ms )||( now_ms < finish_ms ))
+                        {
+                            ready = false;
+                            break;
+                        }
+                    }
+
+                    if( !ready )
+                        continue;
+
+                    if( 0 < step->duration_ms )
+                    {
+                        if(( 0 < budget[step_i] )&&
+                           ( budget[step_i] <= running[step_i] ))
+                            continue;
+
+                        ++running[step_i];
+                    }
+
+                    schedule->start_ms[step_id] = now_ms;
+                    schedule->finish_ms[step_id] = now_ms + step->duration_ms;
+
+                    if( 0 == step->duration_ms )
+                    {
+                        launched = true;
+                    }
+                }
+            }
+        } while( launched );
+
+        long next_ms = -1;
+
+        for( step_id=0; num_steps > step_id; ++step_id )
+        {
+            if(( 0 <= schedule->start_ms[step_id] )&&
+               ( now_ms < schedule->finish_ms[step_id] )&&
+               (( 0 > next_ms )||( next_ms > schedule->finish_ms[step_id] )))
+            {
+                next_ms = schedule->finish_ms[step_id];
+            }
+        }
+
+        if( 0 > next_ms )
+        {
+            break;
+        }
+
+        now_ms = next_ms;
+
+        for( step_id=0; num_steps > step_id; ++step_id )
+        {
+            if(( 0 <= schedule->start_ms[step_id] )&&
+               ( now_ms == schedule->finish_ms[step_id] )&&
+               ( now_ms > schedule->start_ms[step_id] ))
+            {
+                --running[step_id % SM_SERVICE_PLAN_STEP_MAX];
+            }
+        }
+    }
+
+    for( step_id=0; num_steps > step_id; ++step_id )
+    {
+        if( 0 > schedule->start_ms[step_id] )
+        {
+            ++schedule->unscheduled;
+
+        } else if( schedule->finish_ms[step_id] > schedule->makespan_ms ) {
+            schedule->makespan_ms = schedule->finish_ms[step_id];
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Read Durations
+// =============================
+static SmErrorT sm_service_plan_read_durations( const char durations_file[] )
+{
+    char line[256];
+    char service_name[SM_SERVICE_NAME_MAX_CHAR];
+    char action_str[32];
+    long duration_ms;
+    unsigned int line_num = 0;
+    SmServiceActionT action;
+    SmServicePlanStepT* step;
+    FILE* fp;
+
+    fp = fopen( durations_file, "r" );
+    if( NULL == fp )
+    {
+        DPRINTFE( "Failed to open durations file (%s), error=%s.",
+                  durations_file, strerror( errno ) );
+        return( SM_FAILED );
+    }
+
+    while( NULL != fgets( line, sizeof(line), fp ) )
+    {
+        ++line_num;
+
+        if(( '#' == line[0] )||( '\n' == line[0] )||( '\0' == line[0] ))
+            continue;
+
+        if( 3 != sscanf( line, "%31[^,],%31[^,],%li", service_name,
+                         action_str, &duration_ms ) )
+        {
+            DPRINTFE( "Skipping malformed line %u of durations file (%s).",
+                      line_num, durations_file );
+            continue;
+        }
+
+        int node_i = sm_service_plan_find_node( service_name );
+        if( 0 > node_i )
+            continue;
+
+        action = sm_service_action_value( action_str );
+        if( SM_SERVICE_ACTION_ENABLE == action )
+        {
+            step = &(_nodes[node_i].steps[SM_SERVICE_PLAN_STEP_ENABLE]);
+        } else if( SM_SERVICE_ACTION_GO_ACTIVE == action ) {
+            step = &(_nodes[node_i].steps[SM_SERVICE_PLAN_STEP_GO_ACTIVE]);
+        } else {
+            continue;
+        }
+
+        if( step->action_exists )
+        {
+            step->duration_ms = ( 0 > duration_ms ) ? 0 : duration_ms;
+        }
+    }
+
+    fclose( fp );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Simulate
+// =======================
+SmErrorT sm_service_plan_simulate( const char durations_file[], FILE* out )
+{
+    char buf[SM_CONFIGURATION_VALUE_MAX_CHAR + 1];
+    unsigned int path[SM_SERVICE_PLAN_STEPS_MAX];
+    unsigned int path_len = 0;
+    unsigned int enable_budget = SM_SERVICE_PLAN_ENABLING_THROTTLE_DEFAULT;
+    SmServicePlanScheduleT* planned = &(_schedule[0]);
+    SmServicePlanScheduleT* table = &(_schedule[1]);
+    SmErrorT error;
+
+    if(( SM_OKAY == sm_configuration_table_get( "ENABLING_THROTTLE", buf,
+                                                sizeof(buf) - 1 ) )&&
+       ( SM_SERVICE_PLAN_ENABLING_THROTTLE_DEFAULT < atoi( buf ) ))
+    {
+        enable_budget = (unsigned int) atoi( buf );
+    }
+
+    sm_service_plan_build();
+    sm_service_plan_weigh();
+
+    if( _overflow )
+    {
+        return( SM_FAILED );
+    }
+
+    if(( NULL != durations_file )&&( '\0' != durations_file[0] ))
+    {
+        error = sm_service_plan_read_durations( durations_file );
+        if( SM_OKAY != error )
+        {
+            return( error );
+        }
+    }
+
+    sm_service_plan_prioritize();
+    _reweigh = false;
+
+    sm_service_plan_schedule( true, enable_budget, _concurrency, planned );
+    sm_service_plan_schedule( false, enable_budget, _concurrency, table );
+
+    fprintf( out, "services=%u go-active-concurrency=%u enable-throttle=%u "
+             "critical-path-ms=%li%s\n", _num_nodes, _concurrency,
+             enable_budget, _critical_path_ms,
+             _cyclic ? " (dependency cycle)" : "" );
+
+    unsigned int node_i;
+    for( node_i=0; _num_nodes > node_i; ++node_i )
+    {
+        const char* group_name = _nodes[node_i].group_name;
+        long planned_ms = 0, table_ms = 0;
+        unsigned int num_services = 0;
+
+        unsigned int prev_i;
+        for( prev_i=0; node_i > prev_i; ++prev_i )
+        {
+            if( 0 == strcmp( group_name, _nodes[prev_i].group_name ) )
+                break;
+        }
+
+        if( node_i != prev_i )
+            continue;
+
+        unsigned int member_i;
+        for( member_i=node_i; _num_nodes > member_i; ++member_i )
+        {
+            if( 0 != strcmp( group_name, _nodes[member_i].group_name ) )
+                continue;
+
+            unsigned int step_id = SM_SERVICE_PLAN_STEP_ID( member_i,
+                                            SM_SERVICE_PLAN_STEP_GO_ACTIVE );
+            ++num_services;
+
+            if( planned->finish_ms[step_id] > planned_ms )
+                planned_ms = planned->finish_ms[step_id];
+
+            if( table->finish_ms[step_id] > table_ms )
+                table_ms = table->finish_ms[step_id];
+        }
+
+        fprintf( out, "  group %-32s services=%-3u makespan-ms=%-8li "
+                 "table-order-ms=%li\n", '\0' != group_name[0] ? group_name
+                 : "-", num_services, planned_ms, table_ms );
+    }
+
+    fprintf( out, "makespan-ms=%li table-order-ms=%li\n",
+             planned->makespan_ms, table->makespan_ms );
+
+    if( 0 < planned->unscheduled )
+    {
+        fprintf( out, "unreachable-steps=%u\n", planned->unscheduled );
+    }
+
+    // Walk back from the last step to finish through the prerequisite
+    // that finished last.
+    unsigned int num_steps = _num_nodes * SM_SERVICE_PLAN_STEP_MAX;
+    int last = -1;
+
+    unsigned int step_id;
+    for( step_id=0; num_steps > step_id; ++step_id )
+    {
+        if(( 0 <= planned->start_ms[step_id] )&&(( 0 > last )||
+           ( planned->finish_ms[step_id] > planned->finish_ms[last] )))
+        {
+            last = (int) step_id;
+        }
+    }
+
+    while(( 0 <= last )&&( num_steps > path_len ))
+    {
+        SmServicePlanStepT* step = &(_nodes[last / SM_SERVICE_PLAN_STEP_MAX]
+                                     .steps[last % SM_SERVICE_PLAN_STEP_MAX]);
+        int prev = -1;
+
+        path[path_len++] = (unsigned int) last;
+
+        unsigned int prereq_i;
+        for( prereq_i=0; step->num_prereqs > prereq_i; ++prereq_i )
+        {
+            unsigned int prereq_id = step->prereqs[prereq_i];
+
+            if(( 0 > prev )||
+               ( planned->finish_ms[prereq_id] > planned->finish_ms[prev] ))
+            {
+                prev = (int) prereq_id;
+            }
+        }
+
+        last = prev;
+    }
+
+    fprintf( out, "critical path:\n" );
+
+    while( 0 < path_len )
+    {
+        step_id = path[--path_len];
+
+        if( 0 == _nodes[step_id / SM_SERVICE_PLAN_STEP_MAX]
+                 .steps[step_id % SM_SERVICE_PLAN_STEP_MAX].duration_ms )
+            continue;
+
+        fprintf( out, "  %-32s %-10s start-ms=%-8li finish-ms=%li\n",
+                 _nodes[step_id / SM_SERVICE_PLAN_STEP_MAX].name,
+                 sm_service_plan_step_str( step_id % SM_SERVICE_PLAN_STEP_MAX ),
+                 planned->start_ms[step_id], planned->finish_ms[step_id] );
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Dump Data
+// ========================
+void sm_service_plan_dump_data( FILE* log )
+{
+    SmServicePlanNodeT* node;
+
+    fprintf( log, "--------------------------------------------------------------------\n" );
+    fprintf( log, "SERVICE PLAN DATA\n" );
+    fprintf( log, "  concurrency..................................%u\n", _concurrency );
+    fprintf( log, "  services.....................................%u\n", _num_nodes );
+    fprintf( log, "  overflow.....................................%s\n", _overflow ? "yes" : "no" );
+    fprintf( log, "  cyclic.......................................%s\n", _cyclic ? "yes" : "no" );
+    fprintf( log, "  critical_path_ms.............................%li\n", _critical_path_ms );
+    fprintf( log, "  rebuilds.....................................%" PRIu64 "\n", _rebuilds );
+    fprintf( log, "  reweighs.....................................%" PRIu64 "\n", _reweighs );
+    fprintf( log, "  deferred.....................................%" PRIu64 "\n", _deferred );
+
+    unsigned int order_i;
+    for( order_i=0; _num_nodes > order_i; ++order_i )
+    {
+        node = &(_nodes[_order[order_i]]);
+
+        fprintf( log, "  %-32s priority_ms=%-8li enable_ms=%-6li "
+                 "go_active_ms=%-6li%s\n", node->name,
+                 node->steps[SM_SERVICE_PLAN_STEP_ENABLE].priority_ms,
+                 node->steps[SM_SERVICE_PLAN_STEP_ENABLE].duration_ms,
+                 node->steps[SM_SERVICE_PLAN_STEP_GO_ACTIVE].duration_ms,
+                 node->waiting ? " waiting" : "" );
+    }
+
+    fprintf( log, "--------------------------------------------------------------------\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Initialize
+// =========================
+SmErrorT sm_service_plan_initialize( void )
+{
+    char buf[SM_CONFIGURATION_VALUE_MAX_CHAR + 1];
+    int concurrency = SM_SERVICE_PLAN_CONCURRENCY_DEFAULT;
+
+    _num_nodes = 0;
+    _built = false;
+    _overflow = false;
+    _cyclic = false;
+    _reweigh = true;
+    _critical_path_ms = 0;
+    _rebuilds = 0;
+    _reweighs = 0;
+    _deferred = 0;
+
+    if(( SM_OKAY == sm_configuration_table_get( SM_SERVICE_PLAN_CONCURRENCY_KEY,
+                                                buf, sizeof(buf) - 1 ) )&&
+       ( '\0' != buf[0] ))
+    {
+        concurrency = atoi( buf );
+    }
+
+    if( 0 > concurrency )
+    {
+        DPRINTFE( "Invalid %s value %i, using %i.",
+                  SM_SERVICE_PLAN_CONCURRENCY_KEY, concurrency,
+                  SM_SERVICE_PLAN_CONCURRENCY_DEFAULT );
+        concurrency = SM_SERVICE_PLAN_CONCURRENCY_DEFAULT;
+    }
+
+    _concurrency = (unsigned int) concurrency;
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Finalize
+// =======================
+SmErrorT sm_service_plan_finalize( void )
+{
+    _num_nodes = 0;
+    _built = false;
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
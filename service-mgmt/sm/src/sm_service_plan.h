@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __SM_SERVICE_PLAN_H__
+#define __SM_SERVICE_PLAN_H__
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "sm_types.h"
+#include "sm_service_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ****************************************************************************
+// Service Plan - Invalidate
+// =========================
+// Marks the step durations stale, the plan is reweighted on the next sweep.
+extern void sm_service_plan_invalidate( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - For Each
+// =======================
+// Walks the services longest remaining path first.
+extern void sm_service_plan_foreach( void* user_data[],
+    SmServiceTableForEachCallbackT callback );
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Go-Active Acquire
+// ================================
+// Returns false when the service has to wait for a go-active slot, either
+// because the concurrency budget is used up or because it is held for
+// services on a longer path.
+extern bool sm_service_plan_go_active_acquire( SmServiceT* service );
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Simulate
+// =======================
+// Prints the expected makespan of bringing every service enabled-active,
+// in plan order and in table order.  Durations are read from a file of
+// "service,action,ms" lines when one is given.
+extern SmErrorT sm_service_plan_simulate( const char durations_file[],
+    FILE* out );
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Dump Data
+// ========================
+extern void sm_service_plan_dump_data( FILE* log );
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Initialize
+// =========================
+extern SmErrorT sm_service_plan_initialize( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan - Finalize
+// =======================
+extern SmErrorT sm_service_plan_finalize( void );
+// ****************************************************************************
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SM_SERVICE_PLAN_H__
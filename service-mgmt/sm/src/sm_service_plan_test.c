@@ -0,0 +1,551 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Drives the go-active plan over a synthetic service table, exits non-zero
+// when a check fails.  The service, dependency, action stats and
+// configuration tables are stand-ins defined here.  Four short services
+// come first in table order, ahead of a database -> api -> web chain that
+// is the critical path.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_configuration_table.h"
+#include "sm_service_table.h"
+#include "sm_service_dependency_table.h"
+#include "sm_service_action_stats.h"
+#include "sm_service_plan.h"
+
+#define SM_SERVICE_PLAN_TEST_SERVICES_MAX                                8
+#define SM_SERVICE_PLAN_TEST_DEPENDENCIES_MAX                            8
+#define SM_SERVICE_PLAN_TEST_ENABLE_IN_MS                              100
+#define SM_SERVICE_PLAN_TEST_SHORT_IN_MS                               200
+
+typedef struct
+{
+    const char* name;
+    long go_active_ms;
+} SmServicePlanTestServiceT;
+
+static const SmServicePlanTestServiceT _service_defs[] =
+{
+    { "ntp",      SM_SERVICE_PLAN_TEST_SHORT_IN_MS },
+    { "dns",      SM_SERVICE_PLAN_TEST_SHORT_IN_MS },
+    { "syslog",   SM_SERVICE_PLAN_TEST_SHORT_IN_MS },
+    { "lldp",     SM_SERVICE_PLAN_TEST_SHORT_IN_MS },
+    { "database", 3000 },
+    { "api",      2000 },
+    { "web",      1000 },
+};
+
+#define SM_SERVICE_PLAN_TEST_SERVICES \
+    ( sizeof(_service_defs) / sizeof(_service_defs[0]) )
+
+static SmServiceT _services[SM_SERVICE_PLAN_TEST_SERVICES_MAX];
+static unsigned int _generation = 1;
+static SmServiceDependencyT _dependencies[SM_SERVICE_PLAN_TEST_DEPENDENCIES_MAX];
+static unsigned int _num_dependencies = 0;
+static SmServiceActionStatsT _stats[SM_SERVICE_PLAN_TEST_SERVICES_MAX][2];
+static char _concurrency[16];
+static unsigned int _failures = 0;
+
+// ****************************************************************************
+// Service Plan Test - Check
+// =========================
+static void sm_service_plan_test_check( bool passed, const char name[] )
+{
+    printf( "%s: %s\n", passed ? "PASS" : "FAIL", name );
+
+    if( !passed )
+    {
+        ++_failures;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan Test - Configuration Provider
+// ==========================================
+SmErrorT sm_configuration_table_get( const char* key, char* buf,
+    unsigned int buf_size )
+{
+    if( 0 == strcmp( "sm_go_active_concurrency", key ) )
+    {
+        snprintf( buf, buf_size, "%s", _concurrency );
+        return( SM_OKAY );
+    }
+
+    return( SM_NOT_FOUND );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan Test - Service Table Provider
+// ==========================================
+void sm_service_table_foreach( void* user_data[],
+    SmServiceTableForEachCallbackT callback )
+{
+    unsigned int service_i;
+    for( service_i=0; SM_SERVICE_PLAN_TEST_SERVICES > service_i; ++service_i )
+    {
+        callback( user_data, &(_services[service_i]) );
+    }
+}
+
+unsigned int sm_service_table_generation( void )
+{
+    return( _generation );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan Test - Dependency Table Provider
+// =============================================
+void sm_service_dependency_table_foreach( SmServiceDependencyTypeT type,
+    char service_name[], SmServiceStateT state, SmServiceActionT action,
+    void* user_data[], SmServiceDependencyTableForEachCallbackT callback )
+{
+    unsigned int dependency_i;
+    for( dependency_i=0; _num_dependencies > dependency_i; ++dependency_i )
+    {
+        SmServiceDependencyT* dependency = &(_dependencies[dependency_i]);
+
+        if(( type == dependency->type )&&( action == dependency->action )&&
+           ( 0 == strcmp( service_name, dependency->service_name ) ))
+        {
+            callback( user_data, dependency );
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan Test - Action Stats Provider
+// =========================================
+SmServiceActionStatsT* sm_service_action_stats_read(
+    const char service_name[], SmServiceActionT action )
+{
+    unsigned int service_i;
+    for( service_i=0; SM_SERVICE_PLAN_TEST_SERVICES > service_i; ++service_i )
+    {
+        if( 0 != strcmp( service_name, _services[service_i].name ) )
+            continue;
+
+        if( SM_SERVICE_ACTION_ENABLE == action )
+            return( &(_stats[service_i][0]) );
+
+        if( SM_SERVICE_ACTION_GO_ACTIVE == action )
+            return( &(_stats[service_i][1]) );
+    }
+
+    return( NULL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan Test - Find
+// ========================
+static SmServiceT* sm_service_plan_test_find( const char name[] )
+{
+    unsigned int service_i;
+    for( service_i=0; SM_SERVICE_PLAN_TEST_SERVICES > service_i; ++service_i )
+    {
+        if( 0 == strcmp( name, _services[service_i].name ) )
+        {
+            return( &(_services[service_i]) );
+        }
+    }
+
+    return( NULL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan Test - Add Dependency
+// ==================================
+// The go-active of the service waits for the dependent to be active.
+static void sm_service_plan_test_add_dependency( const char service_name[],
+    SmServiceActionT action, const char dependent[] )
+{
+    SmServiceDependencyT* dependency = &(_dependencies[_num_dependencies++]);
+
+    memset( dependency, 0, sizeof(SmServiceDependencyT) );
+    dependency->type = SM_SERVICE_DEPENDENCY_TYPE_ACTION;
+    snprintf( dependency->service_name, sizeof(dependency->service_name),
+              "%s", service_name );
+    dependency->state = SM_SERVICE_STATE_NA;
+    dependency->action = action;
+    snprintf( dependency->dependent, sizeof(dependency->dependent), "%s",
+              dependent );
+    dependency->dependent_state = SM_SERVICE_STATE_ENABLED_ACTIVE;
+
+    ++_generation;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan Test - Setup
+// =========================
+// Loads the tables with every service enabled and none active.
+static void sm_service_plan_test_setup( unsigned int concurrency )
+{
+    SmServiceT* service;
+
+    memset( _services, 0, sizeof(_services) );
+    memset( _stats, 0, sizeof(_stats) );
+    _num_dependencies = 0;
+
+    unsigned int service_i;
+    for( service_i=0; SM_SERVICE_PLAN_TEST_SERVICES > service_i; ++service_i )
+    {
+        service = &(_services[service_i]);
+
+        snprintf( service->name, sizeof(service->name), "%s",
+                  _service_defs[service_i].name );
+        snprintf( service->group_name, sizeof(service->group_name), "%s",
+                  "test-services" );
+        service->enable_action_exists = true;
+        service->go_active_action_exists = true;
+        service->desired_state = SM_SERVICE_STATE_ENABLED_ACTIVE;
+        service->state = SM_SERVICE_STATE_ENABLED_STANDBY;
+        service->action_running = SM_SERVICE_ACTION_NONE;
+
+        _stats[service_i][0].count = 1;
+        _stats[service_i][0].wall_total_ms = SM_SERVICE_PLAN_TEST_ENABLE_IN_MS;
+        _stats[service_i][1].count = 1;
+        _stats[service_i][1].wall_total_ms
+            = (uint64_t) _service_defs[service_i].go_active_ms;
+    }
+
+    sm_service_plan_test_add_dependency( "api", SM_SERVICE_ACTION_GO_ACTIVE,
+                                         "database" );
+    sm_service_plan_test_add_dependency( "web", SM_SERVICE_ACTION_GO_ACTIVE,
+                                         "api" );
+
+    snprintf( _concurrency, sizeof(_concurrency), "%u", concurrency );
+    sm_service_plan_initialize();
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan Test - Ready
+// =========================
+static bool sm_service_plan_test_ready( SmServiceT* service )
+{
+    unsigned int dependency_i;
+    for( dependency_i=0; _num_dependencies > dependency_i; ++dependency_i )
+    {
+        SmServiceDependencyT* dependency = &(_dependencies[dependency_i]);
+
+        if(( SM_SERVICE_ACTION_GO_ACTIVE == dependency->action )&&
+           ( 0 == strcmp( service->name, dependency->service_name ) )&&
+           ( SM_SERVICE_STATE_ENABLED_ACTIVE
+             != sm_service_plan_test_find( dependency->dependent )->state ))
+        {
+            return( false );
+        }
+    }
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan Test - Plan Value
+// ==============================
+// Reads a value back from the dump of the plan data.
+static long sm_service_plan_test_value( const char name[] )
+{
+    char* buffer = NULL;
+    size_t buffer_size = 0;
+    long value = -1;
+    const char* line;
+    FILE* log;
+
+    log = open_memstream( &buffer, &buffer_size );
+    if( NULL == log )
+    {
+        return( -1 );
+    }
+
+    sm_service_plan_dump_data( log );
+    fclose( log );
+
+    line = strstr( buffer, name );
+    if( NULL != line )
+    {
+        line += strlen( name );
+        line += strspn( line, ".=" );
+        value = strtol( line, NULL, 10 );
+    }
+
+    free( buffer );
+
+    return( value );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan Test - Acquire Order
+// =================================
+// Sweeps the services in table order on a virtual clock, as go-active
+// requests arrive when dependencies are met, and starts the go-active of
+// each service granted a slot.  With two slots the database has to start
+// as soon as the first short services finish, ahead of the short services
+// still waiting.
+static void sm_service_plan_test_acquire_order( void )
+{
+    long finish_ms[SM_SERVICE_PLAN_TEST_SERVICES_MAX];
+    long database_start_ms = -1;
+    long now_ms = 0;
+    char order[256] = "";
+    SmServiceT* service;
+
+    sm_service_plan_test_setup( 2 );
+
+    for( ;; )
+    {
+        unsigned int service_i;
+        for( service_i=0; SM_SERVICE_PLAN_TEST_SERVICES > service_i;
+             ++service_i )
+        {
+            service = &(_services[service_i]);
+
+            if(( SM_SERVICE_STATE_ENABLED_ACTIVE == service->state )||
+               ( SM_SERVICE_ACTION_GO_ACTIVE == service->action_running )||
+               ( !sm_service_plan_test_ready( service ) ))
+            {
+                continue;
+            }
+
+            service->state = SM_SERVICE_STATE_ENABLED_GO_ACTIVE;
+
+            if( sm_service_plan_go_active_acquire( service ) )
+            {
+                service->action_running = SM_SERVICE_ACTION_GO_ACTIVE;
+                finish_ms[service_i]
+                    = now_ms + _service_defs[service_i].go_active_ms;
+
+                if( 0 == strcmp( "database", service->name ) )
+                {
+                    database_start_ms = now_ms;
+                }
+
+                snprintf( order + strlen(order), sizeof(order) - strlen(order),
+                          "%s%s", '\0' != order[0] ? " " : "", service->name );
+            }
+        }
+
+        long next_ms = -1;
+
+        for( service_i=0; SM_SERVICE_PLAN_TEST_SERVICES > service_i;
+             ++service_i )
+        {
+            if(( SM_SERVICE_ACTION_GO_ACTIVE
+                 == _services[service_i].action_running )&&
+               (( 0 > next_ms )||( finish_ms[service_i] < next_ms )))
+            {
+                next_ms = finish_ms[service_i];
+            }
+        }
+
+        if( 0 > next_ms )
+        {
+            break;
+        }
+
+        now_ms = next_ms;
+
+        for( service_i=0; SM_SERVICE_PLAN_TEST_SERVICES > service_i;
+             ++service_i )
+        {
+            service = &(_services[service_i]);
+
+            if(( SM_SERVICE_ACTION_GO_ACTIVE == service->action_running )&&
+               ( now_ms == finish_ms[service_i] ))
+            {
+                service->action_running = SM_SERVICE_ACTION_NONE;
+                service->state = SM_SERVICE_STATE_ENABLED_ACTIVE;
+            }
+        }
+    }
+
+    printf( "  order: %s, database start %li ms, all active at %li ms\n",
+            order, database_start_ms, now_ms );
+
+    sm_service_plan_test_check(
+        0 == strcmp( "ntp dns syslog database lldp api web", order ),
+        "go-active acquire order" );
+    sm_service_plan_test_check( SM_SERVICE_PLAN_TEST_SHORT_IN_MS
+                                == database_start_ms,
+                                "critical path starts on the first free slot" );
+    sm_service_plan_test_check( 6200 == now_ms, "all services active" );
+    sm_service_plan_test_check( 3 == sm_service_plan_test_value( "deferred" ),
+                                "deferred once per waiting service" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan Test - Dependency Failure
+// ======================================
+// A single slot is held for the api, waiting on a longer path, until the
+// database it depends on fails and its go-active is abandoned.  The wall
+// time of the failed go-active then reweighs the plan.
+static void sm_service_plan_test_dependency_failure( void )
+{
+    SmServiceT* ntp;
+    SmServiceT* dns;
+    SmServiceT* database;
+    SmServiceT* api;
+    SmServiceActionStatsT* stats;
+    long critical_path_ms;
+    long reweighs;
+
+    sm_service_plan_test_setup( 1 );
+
+    ntp = sm_service_plan_test_find( "ntp" );
+    dns = sm_service_plan_test_find( "dns" );
+    database = sm_service_plan_test_find( "database" );
+    api = sm_service_plan_test_find( "api" );
+
+    database->state = SM_SERVICE_STATE_ENABLED_ACTIVE;
+
+    ntp->state = SM_SERVICE_STATE_ENABLED_GO_ACTIVE;
+    sm_service_plan_test_check( sm_service_plan_go_active_acquire( ntp ),
+                                "first service granted" );
+    ntp->action_running = SM_SERVICE_ACTION_GO_ACTIVE;
+
+    api->state = SM_SERVICE_STATE_ENABLED_GO_ACTIVE;
+    sm_service_plan_test_check( !sm_service_plan_go_active_acquire( api ),
+                                "api deferred while the slot is used" );
+
+    ntp->action_running = SM_SERVICE_ACTION_NONE;
+    ntp->state = SM_SERVICE_STATE_ENABLED_ACTIVE;
+
+    dns->state = SM_SERVICE_STATE_ENABLED_GO_ACTIVE;
+    sm_service_plan_test_check( !sm_service_plan_go_active_acquire( dns ),
+                                "slot held for the waiting api" );
+
+    critical_path_ms = sm_service_plan_test_value( "critical_path_ms" );
+    reweighs = sm_service_plan_test_value( "reweighs" );
+
+    // The database go-active times out and the service fails, which
+    // abandons the go-active of the api.
+    database->state = SM_SERVICE_STATE_DISABLED;
+    api->state = SM_SERVICE_STATE_ENABLED_STANDBY;
+    stats = sm_service_action_stats_read( "database",
+                                          SM_SERVICE_ACTION_GO_ACTIVE );
+    stats->count += 1;
+    stats->failed += 1;
+    stats->wall_total_ms += 9000;
+    sm_service_plan_invalidate();
+
+    sm_service_plan_test_check( sm_service_plan_go_active_acquire( dns ),
+                                "held slot released on dependency failure" );
+    sm_service_plan_test_check( reweighs + 1
+                                == sm_service_plan_test_value( "reweighs" ),
+                                "plan reweighed after the failure" );
+    sm_service_plan_test_check( critical_path_ms + 3000
+                                == sm_service_plan_test_value( "critical_path_ms" ),
+                                "failed go-active lengthens the critical path" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Service Plan Test - Simulate
+// ============================
+// Reads the expected makespans and critical path back from the simulation,
+// then closes a dependency cycle that leaves the chain unreachable.
+static void sm_service_plan_test_simulate( void )
+{
+    char* buffer = NULL;
+    size_t buffer_size = 0;
+    long planned_ms = -1;
+    long table_ms = -1;
+    const char* line;
+    FILE* out;
+
+    sm_service_plan_test_setup( 2 );
+
+    out = open_memstream( &buffer, &buffer_size );
+    if( NULL == out )
+    {
+        sm_service_plan_test_check( false, "simulate output" );
+        return;
+    }
+
+    sm_service_plan_test_check( SM_OKAY == sm_service_plan_simulate( NULL,
+                                out ), "simulate" );
+    fclose( out );
+
+    line = strstr( buffer, "\nmakespan-ms=" );
+    if( NULL != line )
+    {
+        sscanf( line, "\nmakespan-ms=%li table-order-ms=%li", &planned_ms,
+                &table_ms );
+    }
+
+    printf( "  makespan %li ms, table order %li ms\n", planned_ms, table_ms );
+
+    sm_service_plan_test_check(( 0 < planned_ms )&&( planned_ms < table_ms ),
+                               "plan order beats table order" );
+
+    line = strstr( buffer, "critical path:\n" );
+    sm_service_plan_test_check(( NULL != line )&&
+        ( NULL != strstr( line, "database" ) )&&
+        ( strstr( line, "database" ) < strstr( line, "api" ) )&&
+        ( strstr( line, "api" ) < strstr( line, "web" ) )&&
+        ( NULL == strstr( line, "ntp" ) ), "critical path through the chain" );
+    sm_service_plan_test_check( NULL == strstr( buffer, "unreachable-steps" ),
+                                "every step reachable" );
+
+    free( buffer );
+    buffer = NULL;
+
+    sm_service_plan_test_add_dependency( "database",
+                                         SM_SERVICE_ACTION_GO_ACTIVE, "web" );
+
+    out = open_memstream( &buffer, &buffer_size );
+    if( NULL == out )
+    {
+        sm_service_plan_test_check( false, "simulate output" );
+        return;
+    }
+
+    sm_service_plan_simulate( NULL, out );
+    fclose( out );
+
+    sm_service_plan_test_check( NULL != strstr( buffer, "(dependency cycle)" ),
+                                "dependency cycle reported" );
+    sm_service_plan_test_check( NULL != strstr( buffer,
+                                "unreachable-steps=3\n" ),
+                                "go-active of the cycle unreachable" );
+
+    free( buffer );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Main
+// ====
+int main( int argc, char *argv[], char *envp[] )
+{
+    printf( "go-active acquire\n" );
+    sm_service_plan_test_acquire_order();
+    sm_service_plan_test_dependency_failure();
+
+    printf( "simulate\n" );
+    sm_service_plan_test_simulate();
+
+    printf( "%u failed\n", _failures );
+
+    return( ( 0 == _failures ) ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+// ****************************************************************************
@@ -27,6 +27,7 @@
 
 static SmListT* _services = NULL;
 static SmDbHandleT* _sm_db_handle = NULL;
+static unsigned int _generation = 0;
 
 static SmErrorT sm_service_table_add( void* user_data[], void* record );
 
@@ -177,6 +178,15 @@ void sm_service_table_foreach( void* user_data[],
 }
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Table - Generation
+// ==========================
+unsigned int sm_service_table_generation( void )
+{
+    return( _generation );
+}
+// ****************************************************************************
+
 // ****************************************************************************
 // Service Table - Add
 // ===================
@@ -243,6 +253,12 @@ static SmErrorT sm_service_table_add( void* user_data[], void* record )
         snprintf( service->pid_file, sizeof(service->pid_file), "%s",
                   db_service->pid_file );
         service->pid_file_audit_timer_id = SM_TIMER_ID_INVALID;
+        service->death_backend = SM_PROCESS_DEATH_BACKEND_NONE;
+        service->death_count = 0;
+        service->death_detect_last_us = -1;
+        service->death_detect_max_us = -1;
+        service->death_dispatch_last_us = 0;
+        service->death_dispatch_max_us = 0;
         service->action_fail_count = 0;
         service->max_action_failures = db_service->max_action_failures;
         service->transition_fail_count = 0;
@@ -318,6 +334,7 @@ static SmErrorT sm_service_table_add( void* user_data[], void* record )
         service->disable_skip_dependent = false;
 
         SM_LIST_PREPEND( _services, (SmListEntryDataPtrT) service );
+        ++_generation;
 
     } else {
         service->id = db_service->id;
@@ -384,6 +401,7 @@ SmErrorT sm_service_deprovision(char service_name[])
 
     SM_LIST_REMOVE( _services, (SmListEntryDataPtrT) service );
     free(service);
+    ++_generation;
     return SM_OKAY;
 }
 
@@ -404,6 +422,8 @@ SmErrorT sm_service_table_load( void )
         _services = NULL;
     }
 
+    ++_generation;
+
     snprintf( db_query, sizeof(db_query), "%s = 'yes'",
               SM_SERVICES_TABLE_COLUMN_PROVISIONED );
 
@@ -532,6 +552,7 @@ SmErrorT sm_service_table_finalize( void )
     SmErrorT error;
 
     SM_LIST_CLEANUP_ALL( _services );
+    ++_generation;
 
     if( NULL != _sm_db_handle )
     {
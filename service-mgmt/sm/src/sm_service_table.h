@@ -12,6 +12,8 @@
 #include "sm_limits.h"
 #include "sm_types.h"
 #include "sm_timer.h"
+#include "sm_time.h"
+#include "sm_process_death.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -43,6 +45,15 @@ typedef struct
     int pid;
     char pid_file[SM_SERVICE_PID_FILE_MAX_CHAR];
     SmTimerIdT pid_file_audit_timer_id;
+    SmTimeT pid_alive_time;
+    SmProcessDeathBackendT death_backend;
+    unsigned int death_count;
+    // Death to detection, -1 when the backend does not give the time of
+    // death.  Detection to the failure callback is the dispatch latency.
+    long death_detect_last_us;
+    long death_detect_max_us;
+    long death_dispatch_last_us;
+    long death_dispatch_max_us;
     int action_fail_count;
     int max_action_failures;
     int transition_fail_count;
@@ -100,6 +111,13 @@ extern void sm_service_table_foreach( void* user_data[],
     SmServiceTableForEachCallbackT callback );
 // ****************************************************************************
 
+// ****************************************************************************
+// Service Table - Generation
+// ==========================
+// Changes whenever services are added to or removed from the table.
+extern unsigned int sm_service_table_generation( void );
+// ****************************************************************************
+
 extern SmErrorT sm_service_provision(char service_name[]);
 
 extern SmErrorT sm_service_deprovision(char service_name[]);
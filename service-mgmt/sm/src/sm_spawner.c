@@ -0,0 +1,897 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "sm_spawner.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <poll.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/signalfd.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/prctl.h>
+
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_utils.h"
+#include "sm_selobj.h"
+#include "sm_process_death.h"
+#include "sm_service_action_stats.h"
+#include "sm_task_affinity.h"
+
+#define SM_SPAWNER_NAME                                     "sm_spawner"
+#define SM_SPAWNER_MSG_MAX_SIZE                                     32768
+#define SM_SPAWNER_MAX_ARGS                                            32
+#define SM_SPAWNER_MAX_ENVS                                           512
+#define SM_SPAWNER_REPLY_TIMEOUT_IN_MS                               2000
+#define SM_SPAWNER_IN_FLIGHT_MAX                                     1024
+
+typedef enum
+{
+    SM_SPAWNER_MSG_SPAWN = 1,
+    SM_SPAWNER_MSG_SPAWNED,
+    SM_SPAWNER_MSG_EXITED,
+} SmSpawnerMsgTypeT;
+
+typedef struct
+{
+    uint32_t type;
+    uint32_t seqnum;
+    int32_t nice;
+    int32_t force_exit;
+    int32_t exit_code;
+    int32_t failure_exit_code;
+    int32_t set_affinity;
+    int32_t reserved;
+    cpu_set_t affinity;
+    uint32_t argc;
+    uint32_t envc;
+    // Followed by the cwd, argv and envp strings, each nul terminated.
+} SmSpawnerRequestMsgT;
+
+typedef struct
+{
+    uint32_t type;
+    uint32_t seqnum;
+    int32_t pid;
+    int32_t error;
+    int32_t status;
+    struct rusage usage;
+} SmSpawnerReplyMsgT;
+
+static int _spawner_fd = -1;
+static pid_t _spawner_pid = -1;
+static uint32_t _spawner_seqnum = 0;
+static char _spawner_msg[SM_SPAWNER_MSG_MAX_SIZE];
+static uint64_t _spawn_count = 0;
+static uint64_t _spawn_failed = 0;
+static uint64_t _exit_count = 0;
+static uint64_t _launch_total_us = 0;
+static uint64_t _launch_max_us = 0;
+static uint64_t _rate_window_start_ms = 0;
+static uint64_t _rate_window_count = 0;
+static uint64_t _peak_launches_per_sec = 0;
+static pid_t _in_flight[SM_SPAWNER_IN_FLIGHT_MAX];
+static unsigned int _in_flight_count = 0;
+static uint64_t _in_flight_untracked = 0;
+static uint64_t _in_flight_failed = 0;
+
+// ****************************************************************************
+// Spawner - Monotonic Time
+// ========================
+static uint64_t sm_spawner_monotonic_us( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return( (uint64_t) ts.tv_sec * 1000000 + (uint64_t) ts.tv_nsec / 1000 );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Helper Send Reply
+// ===========================
+static void sm_spawner_helper_send_reply( int sock, uint32_t type,
+    uint32_t seqnum, pid_t pid, int error, int status,
+    const struct rusage* usage )
+{
+    SmSpawnerReplyMsgT reply;
+
+    memset( &reply, 0, sizeof(reply) );
+    reply.type = type;
+    reply.seqnum = seqnum;
+    reply.pid = pid;
+    reply.error = error;
+    reply.status = status;
+    if( NULL != usage )
+    {
+        reply.usage = *usage;
+    }
+
+    while(( 0 > send( sock, &reply, sizeof(reply), MSG_NOSIGNAL ) )&&
+          ( EINTR == errno ));
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Helper Spawn
+// ======================
+// Runs in the spawner process, which is forked before sm starts any
+// threads and stays single threaded, so it can vfork.  The child shares
+// the memory of the spawner until exec, so it only makes system calls.
+static void sm_spawner_helper_spawn( int sock, char msg[], ssize_t msg_size )
+{
+    SmSpawnerRequestMsgT* request = (SmSpawnerRequestMsgT*) msg;
+    char* argv[SM_SPAWNER_MAX_ARGS+1];
+    char* envp[SM_SPAWNER_MAX_ENVS+1];
+    char* cwd = NULL;
+    char* str;
+    char* end = msg + msg_size;
+    unsigned int envc = 0;
+    volatile int child_errno = 0;
+    sigset_t empty_mask;
+    pid_t pid;
+
+    if(( (ssize_t) sizeof(SmSpawnerRequestMsgT) > msg_size )||
+       ( SM_SPAWNER_MSG_SPAWN != request->type )||
+       ( SM_SPAWNER_MAX_ARGS < request->argc )||
+       ( SM_SPAWNER_MAX_ENVS < request->envc )||
+       (( 0 == request->argc )&&( !request->force_exit )))
+    {
+        sm_spawner_helper_send_reply( sock, SM_SPAWNER_MSG_SPAWNED,
+                                      request->seqnum, -1, EINVAL, 0,
+                                      NULL );
+        return;
+    }
+
+    str = msg + sizeof(SmSpawnerRequestMsgT);
+
+    unsigned int str_i;
+    for( str_i=0; (1 + request->argc + request->envc) > str_i; ++str_i )
+    {
+        char* nul = (char*) memchr( str, '\0', end - str );
+        if( NULL == nul )
+        {
+            sm_spawner_helper_send_reply( sock, SM_SPAWNER_MSG_SPAWNED,
+                                          request->seqnum, -1, EINVAL, 0,
+                                          NULL );
+            return;
+        }
+
+        if( 0 == str_i )
+        {
+            cwd = str;
+        } else if( request->argc >= str_i ) {
+            argv[str_i-1] = str;
+        } else {
+            envp[envc++] = str;
+        }
+
+        str = nul + 1;
+    }
+
+    argv[request->argc] = NULL;
+
+    // Inherited variables that the request does not override.
+    unsigned int env_i;
+    for( env_i=0; ( NULL != environ[env_i] )&&
+                  ( SM_SPAWNER_MAX_ENVS > envc ); ++env_i )
+    {
+        const char* name = environ[env_i];
+        size_t name_len = strcspn( name, "=" );
+        bool overridden = false;
+
+        for( str_i=0; request->envc > str_i; ++str_i )
+        {
+            if(( 0 == strncmp( envp[str_i], name, name_len ) )&&
+               ( '=' == envp[str_i][name_len] ))
+            {
+                overridden = true;
+                break;
+            }
+        }
+
+        if( !overridden )
+        {
+            envp[envc++] = (char*) name;
+        }
+    }
+
+    envp[envc] = NULL;
+
+    sigemptyset( &empty_mask );
+
+    pid = vfork();
+    if( 0 > pid )
+    {
+        sm_spawner_helper_send_reply( sock, SM_SPAWNER_MSG_SPAWNED,
+                                      request->seqnum, -1, errno, 0,
+                                      NULL );
+        return;
+
+    } else if( 0 == pid ) {
+        // Child process, shares memory with the spawner until exec.
+        sigprocmask( SIG_SETMASK, &empty_mask, NULL );
+        setpgid( 0, 0 );
+        sm_utils_close_fds( 3 );
+
+        if( 0 > setpriority( PRIO_PROCESS, 0, request->nice ) )
+        {
+            child_errno = errno;
+            _exit( request->failure_exit_code );
+        }
+
+        // Same placement as sm_task_affinity_restore_child() gives the
+        // children sm forks itself.
+        if( request->set_affinity )
+        {
+            sched_setaffinity( 0, sizeof(request->affinity),
+                               &(request->affinity) );
+        }
+
+        if(( NULL != cwd )&&( '\0' != cwd[0] )&&( 0 > chdir( cwd ) ))
+        {
+            child_errno = errno;
+            _exit( request->failure_exit_code );
+        }
+
+        if( request->force_exit )
+        {
+            _exit( request->exit_code );
+        }
+
+        execve( argv[0], argv, envp );
+
+        child_errno = errno;
+        _exit( request->failure_exit_code );
+    }
+
+    sm_spawner_helper_send_reply( sock, SM_SPAWNER_MSG_SPAWNED,
+                                  request->seqnum, pid, child_errno, 0,
+                                  NULL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Helper Reap
+// =====================
+static void sm_spawner_helper_reap( int sock, int signal_fd )
+{
+    struct signalfd_siginfo info;
+    struct rusage usage;
+    pid_t pid;
+    int status;
+
+    while( 0 < read( signal_fd, &info, sizeof(info) ) );
+
+    while( 0 < (pid = wait4( -1, &status, WNOHANG, &usage )) )
+    {
+        sm_spawner_helper_send_reply( sock, SM_SPAWNER_MSG_EXITED, 0, pid,
+                                      0, status, &usage );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Helper Main
+// =====================
+static void sm_spawner_helper_main( int sock, pid_t parent_pid )
+{
+    static char msg[SM_SPAWNER_MSG_MAX_SIZE];
+    struct pollfd fds[2];
+    sigset_t chld_mask;
+    int signal_fd;
+    int null_fd;
+    ssize_t msg_size;
+
+    prctl( PR_SET_NAME, SM_SPAWNER_NAME );
+    prctl( PR_SET_PDEATHSIG, SIGKILL );
+
+    if( parent_pid != getppid() )
+    {
+        _exit( EXIT_FAILURE );
+    }
+
+    int sig_i;
+    for( sig_i=1; _NSIG > sig_i; ++sig_i )
+    {
+        signal( sig_i, SIG_DFL );
+    }
+
+    sigemptyset( &chld_mask );
+    sigaddset( &chld_mask, SIGCHLD );
+    sigprocmask( SIG_SETMASK, &chld_mask, NULL );
+
+    if(( 3 != sock )&&( 0 > dup3( sock, 3, O_CLOEXEC ) ))
+    {
+        _exit( EXIT_FAILURE );
+    }
+
+    sock = 3;
+    sm_utils_close_fds( 4 );
+
+    null_fd = open( "/dev/null", O_RDWR );
+    if( 0 <= null_fd )
+    {
+        dup2( null_fd, STDIN_FILENO );
+        dup2( null_fd, STDOUT_FILENO );
+        dup2( null_fd, STDERR_FILENO );
+
+        if( STDERR_FILENO < null_fd )
+        {
+            close( null_fd );
+        }
+    }
+
+    signal_fd = signalfd( -1, &chld_mask, SFD_NONBLOCK | SFD_CLOEXEC );
+    if( 0 > signal_fd )
+    {
+        _exit( EXIT_FAILURE );
+    }
+
+    fds[0].fd = sock;
+    fds[0].events = POLLIN;
+    fds[1].fd = signal_fd;
+    fds[1].events = POLLIN;
+
+    for( ;; )
+    {
+        if( 0 > poll( fds, 2, -1 ) )
+        {
+            if( EINTR == errno )
+            {
+                continue;
+            }
+            _exit( EXIT_FAILURE );
+        }
+
+        if( fds[1].revents & POLLIN )
+        {
+            sm_spawner_helper_reap( sock, signal_fd );
+        }
+
+        if( fds[0].revents & POLLIN )
+        {
+            msg_size = recv( sock, msg, sizeof(msg), 0 );
+            if( 0 == msg_size )
+            {
+                _exit( EXIT_SUCCESS );
+
+            } else if( 0 < msg_size ) {
+                sm_spawner_helper_spawn( sock, msg, msg_size );
+            }
+        } else if( fds[0].revents & (POLLHUP | POLLERR) ) {
+            _exit( EXIT_SUCCESS );
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - In Flight Add
+// =======================
+static void sm_spawner_in_flight_add( pid_t pid )
+{
+    unsigned int in_flight_i;
+    for( in_flight_i=0; SM_SPAWNER_IN_FLIGHT_MAX > in_flight_i; ++in_flight_i )
+    {
+        if( 0 == _in_flight[in_flight_i] )
+        {
+            _in_flight[in_flight_i] = pid;
+            ++_in_flight_count;
+            return;
+        }
+    }
+
+    ++_in_flight_untracked;
+    DPRINTFE( "Too many spawned processes in flight, pid (%i) not tracked.",
+              (int) pid );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - In Flight Remove
+// ==========================
+static void sm_spawner_in_flight_remove( pid_t pid )
+{
+    unsigned int in_flight_i;
+    for( in_flight_i=0; SM_SPAWNER_IN_FLIGHT_MAX > in_flight_i; ++in_flight_i )
+    {
+        if( pid == _in_flight[in_flight_i] )
+        {
+            _in_flight[in_flight_i] = 0;
+            --_in_flight_count;
+            return;
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Process Exited
+// ========================
+static void sm_spawner_process_exited( SmSpawnerReplyMsgT* reply )
+{
+    int exit_code;
+
+    ++_exit_count;
+
+    sm_spawner_in_flight_remove( reply->pid );
+
+    if( WIFEXITED( reply->status ) )
+    {
+        exit_code = WEXITSTATUS( reply->status );
+    } else {
+        exit_code = SM_PROCESS_FAILED;
+    }
+
+    sm_service_action_stats_exited( reply->pid, exit_code, &(reply->usage) );
+    sm_process_death_save( reply->pid, exit_code );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Receive
+// =================
+// Returns the number of bytes received, zero when the spawner has gone
+// away, or -1 with errno set.
+static ssize_t sm_spawner_receive( SmSpawnerReplyMsgT* reply )
+{
+    ssize_t bytes;
+
+    bytes = recv( _spawner_fd, reply, sizeof(SmSpawnerReplyMsgT), 0 );
+    if(( 0 < bytes )&&( (ssize_t) sizeof(SmSpawnerReplyMsgT) != bytes ))
+    {
+        DPRINTFE( "Spawner reply truncated, bytes=%i.", (int) bytes );
+        errno = EAGAIN;
+        return( -1 );
+    }
+
+    return( bytes );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Lost
+// ==============
+static void sm_spawner_lost( const char reason[] )
+{
+    SmSpawnerReplyMsgT reply;
+    SmErrorT error;
+
+    if( 0 > _spawner_fd )
+    {
+        return;
+    }
+
+    DPRINTFE( "Spawner (%i) lost, %s, actions will be forked.",
+              (int) _spawner_pid, reason );
+
+    error = sm_selobj_deregister( _spawner_fd );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to deregister spawner selection object, "
+                  "error=%s.", sm_error_str( error ) );
+    }
+
+    // Exits the spawner reported before it went away.
+    while( 0 < sm_spawner_receive( &reply ) )
+    {
+        if( SM_SPAWNER_MSG_EXITED == reply.type )
+        {
+            sm_spawner_process_exited( &reply );
+        }
+    }
+
+    close( _spawner_fd );
+    _spawner_fd = -1;
+
+    // The spawner is the parent of the processes still in flight, their
+    // exits can no longer be reported.  Abort them while the spawner
+    // keeps their pids from being reused, and report them failed so that
+    // their callbacks and action statistics are not left waiting.
+    if( 0 < _in_flight_count )
+    {
+        DPRINTFE( "Aborting %u spawned processes in flight.",
+                  _in_flight_count );
+    }
+
+    unsigned int in_flight_i;
+    for( in_flight_i=0; SM_SPAWNER_IN_FLIGHT_MAX > in_flight_i; ++in_flight_i )
+    {
+        pid_t pid = _in_flight[in_flight_i];
+
+        if( 0 == pid )
+        {
+            continue;
+        }
+
+        if( 0 > kill( -pid, SIGKILL ) )
+        {
+            kill( pid, SIGKILL );
+        }
+
+        _in_flight[in_flight_i] = 0;
+        ++_in_flight_failed;
+
+        sm_service_action_stats_exited( pid, SM_PROCESS_FAILED, NULL );
+        sm_process_death_save( pid, SM_PROCESS_FAILED );
+    }
+
+    _in_flight_count = 0;
+
+    kill( _spawner_pid, SIGKILL );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Dispatch
+// ==================
+static void sm_spawner_dispatch( int selobj, int64_t user_data )
+{
+    SmSpawnerReplyMsgT reply;
+    ssize_t bytes;
+
+    while( 0 <= _spawner_fd )
+    {
+        bytes = sm_spawner_receive( &reply );
+        if( 0 == bytes )
+        {
+            sm_spawner_lost( "connection closed" );
+            break;
+
+        } else if( 0 > bytes ) {
+            if( EINTR == errno )
+            {
+                continue;
+            }
+            break;
+        }
+
+        if( SM_SPAWNER_MSG_EXITED == reply.type )
+        {
+            sm_spawner_process_exited( &reply );
+        } else {
+            DPRINTFE( "Unexpected spawner reply (%u), seqnum=%u.",
+                      reply.type, reply.seqnum );
+        }
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Available
+// ===================
+bool sm_spawner_available( void )
+{
+    return( 0 <= _spawner_fd );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Encode String
+// =======================
+static bool sm_spawner_encode_string( char** pos, const char str[] )
+{
+    size_t len = strlen( str ) + 1;
+
+    if( len > (size_t) (&(_spawner_msg[sizeof(_spawner_msg)]) - *pos) )
+    {
+        return( false );
+    }
+
+    memcpy( *pos, str, len );
+    *pos += len;
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Record Launch
+// =======================
+static void sm_spawner_record_launch( uint64_t start_us )
+{
+    uint64_t now_us = sm_spawner_monotonic_us();
+    uint64_t launch_us = now_us - start_us;
+    uint64_t now_ms = now_us / 1000;
+
+    ++_spawn_count;
+    _launch_total_us += launch_us;
+
+    if( launch_us > _launch_max_us )
+    {
+        _launch_max_us = launch_us;
+    }
+
+    if( 1000 <= (now_ms - _rate_window_start_ms) )
+    {
+        _rate_window_start_ms = now_ms;
+        _rate_window_count = 0;
+    }
+
+    if( ++_rate_window_count > _peak_launches_per_sec )
+    {
+        _peak_launches_per_sec = _rate_window_count;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Spawn
+// ===============
+SmErrorT sm_spawner_spawn( SmSpawnerRequestT* request, pid_t* pid )
+{
+    SmSpawnerRequestMsgT* msg = (SmSpawnerRequestMsgT*) _spawner_msg;
+    SmSpawnerReplyMsgT reply;
+    struct pollfd fds;
+    uint64_t start_us = sm_spawner_monotonic_us();
+    char* pos = _spawner_msg + sizeof(SmSpawnerRequestMsgT);
+    ssize_t bytes;
+
+    *pid = -1;
+
+    if( 0 > _spawner_fd )
+    {
+        return( SM_NOT_FOUND );
+    }
+
+    memset( msg, 0, sizeof(SmSpawnerRequestMsgT) );
+    msg->type = SM_SPAWNER_MSG_SPAWN;
+    msg->seqnum = ++_spawner_seqnum;
+    msg->nice = request->nice;
+    msg->force_exit = request->force_exit;
+    msg->exit_code = request->exit_code;
+    msg->failure_exit_code = request->failure_exit_code;
+    msg->set_affinity = sm_task_affinity_child_cpus( &(msg->affinity) );
+
+    if( !sm_spawner_encode_string( &pos, (NULL == request->cwd) ? ""
+                                         : request->cwd ) )
+    {
+        goto TOO_BIG;
+    }
+
+    for( ; NULL != request->argv[msg->argc]; ++msg->argc )
+    {
+        if(( SM_SPAWNER_MAX_ARGS <= msg->argc )||
+           ( !sm_spawner_encode_string( &pos, request->argv[msg->argc] ) ))
+        {
+            goto TOO_BIG;
+        }
+    }
+
+    for( ; NULL != request->envp[msg->envc]; ++msg->envc )
+    {
+        if(( SM_SPAWNER_MAX_ENVS <= msg->envc )||
+           ( !sm_spawner_encode_string( &pos, request->envp[msg->envc] ) ))
+        {
+            goto TOO_BIG;
+        }
+    }
+
+    if( 0 > send( _spawner_fd, _spawner_msg, pos - _spawner_msg,
+                  MSG_NOSIGNAL ) )
+    {
+        DPRINTFE( "Failed to send spawn request, error=%s.",
+                  strerror( errno ) );
+        sm_spawner_lost( "send failed" );
+        ++_spawn_failed;
+        return( SM_FAILED );
+    }
+
+    // Blocks the main thread, as the fork it replaces did, because the
+    // callers register the pid as soon as this returns.  The spawner only
+    // vforks and replies, so the reply follows the exec of the child
+    // within milliseconds.  A spawner that misses the timeout is dropped
+    // and later actions are forked, so the main thread stalls at most
+    // once for SM_SPAWNER_REPLY_TIMEOUT_IN_MS.
+    fds.fd = _spawner_fd;
+    fds.events = POLLIN;
+
+    for( ;; )
+    {
+        int result = poll( &fds, 1, SM_SPAWNER_REPLY_TIMEOUT_IN_MS );
+        if( 0 == result )
+        {
+            sm_spawner_lost( "spawn request timed out" );
+            ++_spawn_failed;
+            return( SM_FAILED );
+
+        } else if( 0 > result ) {
+            if( EINTR == errno )
+            {
+                continue;
+            }
+            DPRINTFE( "Failed to poll spawner, error=%s.", strerror( errno ) );
+            ++_spawn_failed;
+            return( SM_FAILED );
+        }
+
+        bytes = sm_spawner_receive( &reply );
+        if( 0 == bytes )
+        {
+            sm_spawner_lost( "connection closed" );
+            ++_spawn_failed;
+            return( SM_FAILED );
+
+        } else if( 0 > bytes ) {
+            continue;
+        }
+
+        if( SM_SPAWNER_MSG_EXITED == reply.type )
+        {
+            sm_spawner_process_exited( &reply );
+
+        } else if(( SM_SPAWNER_MSG_SPAWNED == reply.type )&&
+                  ( msg->seqnum == reply.seqnum )) {
+            break;
+        }
+    }
+
+    if( 0 > reply.pid )
+    {
+        DPRINTFE( "Spawner failed to spawn (%s), error=%s.",
+                  request->argv[0], strerror( reply.error ) );
+        ++_spawn_failed;
+        return( SM_FAILED );
+    }
+
+    if( 0 != reply.error )
+    {
+        DPRINTFE( "Spawner failed to exec (%s), pid=%i, error=%s.",
+                  request->argv[0], reply.pid, strerror( reply.error ) );
+    }
+
+    *pid = (pid_t) reply.pid;
+
+    sm_spawner_in_flight_add( *pid );
+    sm_spawner_record_launch( start_us );
+
+    DPRINTFD( "Spawned process (%i) for (%s).", (int) *pid,
+              request->force_exit ? "force-exit" : request->argv[0] );
+
+    return( SM_OKAY );
+
+TOO_BIG:
+    DPRINTFE( "Spawn request for (%s) exceeds %i bytes or limits.",
+              (NULL == request->argv[0]) ? "force-exit" : request->argv[0],
+              SM_SPAWNER_MSG_MAX_SIZE );
+    ++_spawn_failed;
+    return( SM_FAILED );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Dump Data
+// ===================
+void sm_spawner_dump_data( FILE* log )
+{
+    uint64_t launch_avg_us = 0;
+
+    if( 0 < _spawn_count )
+    {
+        launch_avg_us = _launch_total_us / _spawn_count;
+    }
+
+    fprintf( log, "--------------------------------------------------------------------\n" );
+    fprintf( log, "SPAWNER DATA\n" );
+    fprintf( log, "  pid..........................................%i\n", (int) _spawner_pid );
+    fprintf( log, "  available....................................%s\n", sm_spawner_available() ? "yes" : "no" );
+    fprintf( log, "  spawned......................................%" PRIu64 "\n", _spawn_count );
+    fprintf( log, "  spawn_failed.................................%" PRIu64 "\n", _spawn_failed );
+    fprintf( log, "  exited.......................................%" PRIu64 "\n", _exit_count );
+    fprintf( log, "  launch_avg_us................................%" PRIu64 "\n", launch_avg_us );
+    fprintf( log, "  launch_max_us................................%" PRIu64 "\n", _launch_max_us );
+    fprintf( log, "  peak_launches_per_sec........................%" PRIu64 "\n", _peak_launches_per_sec );
+    fprintf( log, "  in_flight....................................%u\n", _in_flight_count );
+    fprintf( log, "  in_flight_untracked..........................%" PRIu64 "\n", _in_flight_untracked );
+    fprintf( log, "  in_flight_failed.............................%" PRIu64 "\n", _in_flight_failed );
+    fprintf( log, "--------------------------------------------------------------------\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Initialize
+// ====================
+SmErrorT sm_spawner_initialize( void )
+{
+    int sockets[2];
+    pid_t parent_pid = getpid();
+    SmErrorT error;
+
+    memset( _in_flight, 0, sizeof(_in_flight) );
+    _in_flight_count = 0;
+
+    if( 0 > socketpair( AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0,
+                        sockets ) )
+    {
+        DPRINTFE( "Failed to create spawner socket pair, error=%s.",
+                  strerror( errno ) );
+        return( SM_FAILED );
+    }
+
+    _spawner_pid = fork();
+    if( 0 > _spawner_pid )
+    {
+        DPRINTFE( "Failed to fork spawner, error=%s.", strerror( errno ) );
+        close( sockets[0] );
+        close( sockets[1] );
+        return( SM_FAILED );
+
+    } else if( 0 == _spawner_pid ) {
+        close( sockets[0] );
+        sm_spawner_helper_main( sockets[1], parent_pid );
+        _exit( EXIT_FAILURE );
+    }
+
+    close( sockets[1] );
+    _spawner_fd = sockets[0];
+
+    if( 0 > fcntl( _spawner_fd, F_SETFL,
+                   fcntl( _spawner_fd, F_GETFL ) | O_NONBLOCK ) )
+    {
+        DPRINTFE( "Failed to make spawner socket non-blocking, error=%s.",
+                  strerror( errno ) );
+        error = SM_FAILED;
+        goto ERROR;
+    }
+
+    error = sm_selobj_register( _spawner_fd, sm_spawner_dispatch, 0 );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to register spawner selection object, error=%s.",
+                  sm_error_str( error ) );
+        goto ERROR;
+    }
+
+    DPRINTFI( "Spawner (%i) started.", (int) _spawner_pid );
+
+    return( SM_OKAY );
+
+ERROR:
+    close( _spawner_fd );
+    _spawner_fd = -1;
+    kill( _spawner_pid, SIGKILL );
+    return( error );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Finalize
+// ==================
+SmErrorT sm_spawner_finalize( void )
+{
+    SmErrorT error;
+
+    if( 0 <= _spawner_fd )
+    {
+        error = sm_selobj_deregister( _spawner_fd );
+        if( SM_OKAY != error )
+        {
+            DPRINTFE( "Failed to deregister spawner selection object, "
+                      "error=%s.", sm_error_str( error ) );
+        }
+
+        // The spawner exits when its end of the socket is closed.
+        close( _spawner_fd );
+        _spawner_fd = -1;
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
@@ -0,0 +1,72 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __SM_SPAWNER_H__
+#define __SM_SPAWNER_H__
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+#include "sm_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    char** argv;            // NULL terminated, argv[0] is the executable.
+    char** envp;            // NULL terminated NAME=VALUE entries, added to
+                            // the environment inherited by the spawner.
+    const char* cwd;        // NULL to inherit the working directory.
+    int nice;
+    bool force_exit;        // Do not exec, exit with exit_code instead.
+    int exit_code;
+    int failure_exit_code;  // Exit code when the child fails to exec.
+} SmSpawnerRequestT;
+
+// ****************************************************************************
+// Spawner - Available
+// ===================
+extern bool sm_spawner_available( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Spawn
+// ===============
+// Hands the request to the spawner process and waits for the pid of the
+// new process.  The exit of the process is delivered asynchronously
+// through sm_process_death_save(), register with child_process set.
+// Waits at most two seconds for the pid, after which the spawner is
+// dropped and sm_spawner_available() returns false.
+extern SmErrorT sm_spawner_spawn( SmSpawnerRequestT* request, pid_t* pid );
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Dump Data
+// ===================
+extern void sm_spawner_dump_data( FILE* log );
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Initialize
+// ====================
+// Forks the spawner process, must be called before the threads and the
+// bulk of the heap are created.
+extern SmErrorT sm_spawner_initialize( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner - Finalize
+// ==================
+extern SmErrorT sm_spawner_finalize( void );
+// ****************************************************************************
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SM_SPAWNER_H__
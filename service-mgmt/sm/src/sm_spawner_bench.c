@@ -0,0 +1,440 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Measures the actions launched per second and the main-thread time per
+// launch, through the spawner and by forking a process with a given heap.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_utils.h"
+#include "sm_selobj.h"
+#include "sm_spawner.h"
+#include "sm_process_death.h"
+#include "sm_service_action_stats.h"
+#include "sm_task_affinity.h"
+
+#define SM_SPAWNER_BENCH_ACTIONS                                     2000
+#define SM_SPAWNER_BENCH_NOFILE                                     65536
+#define SM_SPAWNER_BENCH_HEAPS_MAX                                     16
+#define SM_SPAWNER_BENCH_EXEC                                 "/bin/true"
+
+typedef enum
+{
+    SM_SPAWNER_BENCH_SPAWNER,
+    SM_SPAWNER_BENCH_FORK,
+    SM_SPAWNER_BENCH_FORK_CLOSE_LOOP,
+    SM_SPAWNER_BENCH_MAX
+} SmSpawnerBenchPathT;
+
+static struct option _sm_spawner_bench_long_options[] =
+{
+    { "actions", required_argument, NULL, 'a'},
+    { "heap",    required_argument, NULL, 'm'},
+    { "nofile",  required_argument, NULL, 'n'},
+    { "help",    no_argument,       NULL, 'h'},
+    {0, 0, 0, 0}
+};
+
+static unsigned int _exits = 0;
+static char* _heap[SM_SPAWNER_BENCH_HEAPS_MAX];
+static unsigned int _heap_mib = 0;
+
+// ****************************************************************************
+// Spawner Benchmark - Usage
+// =========================
+static void usage( void )
+{
+    printf( " usage:\n"
+            "   sm-spawner-bench [--actions <number>] [--heap <MiB>]\n"
+            "                    [--nofile <number>] [--help]\n"
+            "       --actions : actions to launch per path and heap size\n"
+            "       --heap    : heap of the launching process, can be\n"
+            "                   repeated, defaults to 512 and 2048\n"
+            "       --nofile  : open file limit, defaults to 65536\n"
+            "       --help    : print out this help message\n"
+            "\n"
+            "   Every action runs " SM_SPAWNER_BENCH_EXEC ".  fork is the\n"
+            "   fallback path, fork+close-loop closes every fd up to the\n"
+            "   open file limit as actions did before the spawner.\n"
+            "\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner Benchmark - Process Death Save
+// ======================================
+// Stands in for the process death module, the spawner reports exits here.
+SmErrorT sm_process_death_save( pid_t pid, int exit_code )
+{
+    ++_exits;
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner Benchmark - Action Statistics Exited
+// ============================================
+void sm_service_action_stats_exited( pid_t pid, int exit_code,
+    const struct rusage* usage )
+{
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner Benchmark - Task Affinity Child Cpus
+// ============================================
+bool sm_task_affinity_child_cpus( cpu_set_t* cpus )
+{
+    return( false );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner Benchmark - Monotonic Time
+// ==================================
+static double sm_spawner_bench_now_us( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return( (double) ts.tv_sec * 1000000.0 + (double) ts.tv_nsec / 1000.0 );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner Benchmark - Path String
+// ===============================
+static const char* sm_spawner_bench_path_str( SmSpawnerBenchPathT path )
+{
+    switch( path )
+    {
+        case SM_SPAWNER_BENCH_SPAWNER:
+            return( "spawner" );
+        case SM_SPAWNER_BENCH_FORK:
+            return( "fork" );
+        case SM_SPAWNER_BENCH_FORK_CLOSE_LOOP:
+            return( "fork+close-loop" );
+        default:
+            return( "???" );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner Benchmark - Grow Heap
+// =============================
+// Grows the heap to the given size, touching every page so that a fork has
+// to copy the page tables.
+static SmErrorT sm_spawner_bench_grow_heap( unsigned int heap_mib )
+{
+    unsigned int heap_i;
+    for( heap_i=0; SM_SPAWNER_BENCH_HEAPS_MAX > heap_i; ++heap_i )
+    {
+        if( NULL == _heap[heap_i] )
+        {
+            break;
+        }
+    }
+
+    if(( heap_mib <= _heap_mib )||( SM_SPAWNER_BENCH_HEAPS_MAX <= heap_i ))
+    {
+        return( SM_OKAY );
+    }
+
+    _heap[heap_i] = (char*) malloc( (size_t) (heap_mib - _heap_mib) << 20 );
+    if( NULL == _heap[heap_i] )
+    {
+        printf( "Failed to allocate %u MiB.\n", heap_mib - _heap_mib );
+        return( SM_FAILED );
+    }
+
+    memset( _heap[heap_i], 0xA5, (size_t) (heap_mib - _heap_mib) << 20 );
+    _heap_mib = heap_mib;
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner Benchmark - Fork
+// ========================
+// The fork fallback of sm_service_action_run(), with the close-all loop of
+// the previous action path when asked.
+static pid_t sm_spawner_bench_fork( bool close_loop )
+{
+    char* argv[] = { (char*) SM_SPAWNER_BENCH_EXEC, NULL };
+    struct rlimit file_limits;
+    pid_t pid;
+
+    pid = fork();
+    if( 0 == pid )
+    {
+        setpgid( 0, 0 );
+
+        if( close_loop )
+        {
+            getrlimit( RLIMIT_NOFILE, &file_limits );
+
+            unsigned int fd_i;
+            for( fd_i=0; fd_i < file_limits.rlim_cur; ++fd_i )
+            {
+                close( fd_i );
+            }
+        } else {
+            sm_utils_close_fds( 0 );
+        }
+
+        execv( argv[0], argv );
+        _exit( EXIT_FAILURE );
+    }
+
+    return( pid );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner Benchmark - Reap
+// ========================
+static void sm_spawner_bench_reap( int options )
+{
+    int status;
+
+    while( 0 < waitpid( -1, &status, options ) )
+    {
+        ++_exits;
+
+        if( WNOHANG & options )
+        {
+            continue;
+        }
+        break;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner Benchmark - Run
+// =======================
+static SmErrorT sm_spawner_bench_run( SmSpawnerBenchPathT path,
+    unsigned int actions )
+{
+    char* argv[] = { (char*) SM_SPAWNER_BENCH_EXEC, NULL };
+    char* envp[] = { NULL };
+    SmSpawnerRequestT request;
+    double main_us = 0.0;
+    double start_us;
+    double launch_us;
+    double elapsed_us;
+    pid_t pid;
+    SmErrorT error;
+
+    memset( &request, 0, sizeof(request) );
+    request.argv = argv;
+    request.envp = envp;
+    request.failure_exit_code = EXIT_FAILURE;
+
+    _exits = 0;
+    start_us = sm_spawner_bench_now_us();
+
+    unsigned int action_i;
+    for( action_i=0; actions > action_i; ++action_i )
+    {
+        launch_us = sm_spawner_bench_now_us();
+
+        if( SM_SPAWNER_BENCH_SPAWNER == path )
+        {
+            error = sm_spawner_spawn( &request, &pid );
+        } else {
+            pid = sm_spawner_bench_fork( SM_SPAWNER_BENCH_FORK_CLOSE_LOOP
+                                         == path );
+            error = ( 0 > pid ) ? SM_FAILED : SM_OKAY;
+        }
+
+        main_us += sm_spawner_bench_now_us() - launch_us;
+
+        if( SM_OKAY != error )
+        {
+            printf( "Failed to launch through %s, action=%u.\n",
+                    sm_spawner_bench_path_str( path ), action_i );
+            return( SM_FAILED );
+        }
+
+        if( SM_SPAWNER_BENCH_SPAWNER != path )
+        {
+            sm_spawner_bench_reap( WNOHANG );
+        }
+    }
+
+    while( actions > _exits )
+    {
+        if( SM_SPAWNER_BENCH_SPAWNER == path )
+        {
+            if( !sm_spawner_available() )
+            {
+                printf( "Spawner lost, exits=%u of %u.\n", _exits, actions );
+                return( SM_FAILED );
+            }
+            sm_selobj_dispatch( 100 );
+        } else {
+            sm_spawner_bench_reap( 0 );
+        }
+    }
+
+    elapsed_us = sm_spawner_bench_now_us() - start_us;
+
+    printf( "heap: %5u MiB  %-16s %8.0f actions/s  %9.1f us/launch "
+            "main-thread\n", _heap_mib, sm_spawner_bench_path_str( path ),
+            actions / (elapsed_us / 1000000.0), main_us / actions );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Spawner Benchmark - Main
+// ========================
+int main( int argc, char *argv[], char *envp[] )
+{
+    unsigned int heaps[SM_SPAWNER_BENCH_HEAPS_MAX];
+    unsigned int num_heaps = 0;
+    unsigned int actions = SM_SPAWNER_BENCH_ACTIONS;
+    struct rlimit file_limits;
+    rlim_t nofile = SM_SPAWNER_BENCH_NOFILE;
+    SmErrorT error;
+    int c;
+
+    while( true )
+    {
+        c = getopt_long( argc, argv, "", _sm_spawner_bench_long_options,
+                         NULL );
+        if( -1 == c )
+        {
+            break;
+        }
+
+        switch( c )
+        {
+            case 'a':
+                actions = (unsigned int) atoi( optarg );
+            break;
+
+            case 'm':
+                if( SM_SPAWNER_BENCH_HEAPS_MAX > num_heaps )
+                {
+                    heaps[num_heaps++] = (unsigned int) atoi( optarg );
+                }
+            break;
+
+            case 'n':
+                nofile = (rlim_t) atol( optarg );
+            break;
+
+            case 'h':
+            case '?':
+                usage();
+                exit( 0 );
+            break;
+        }
+    }
+
+    if( 0 == num_heaps )
+    {
+        heaps[num_heaps++] = 512;
+        heaps[num_heaps++] = 2048;
+    }
+
+    if( 0 == actions )
+    {
+        actions = 1;
+    }
+
+    if( 0 == getrlimit( RLIMIT_NOFILE, &file_limits ) )
+    {
+        file_limits.rlim_cur = nofile;
+        if( file_limits.rlim_max < nofile )
+        {
+            file_limits.rlim_max = nofile;
+        }
+
+        if(( 0 > setrlimit( RLIMIT_NOFILE, &file_limits ) )&&
+           ( 0 == getrlimit( RLIMIT_NOFILE, &file_limits ) ))
+        {
+            // Not allowed to raise the hard limit, go as far as it.
+            file_limits.rlim_cur = file_limits.rlim_max;
+            setrlimit( RLIMIT_NOFILE, &file_limits );
+        }
+
+        if( nofile > file_limits.rlim_cur )
+        {
+            printf( "Open file limit of %lu not allowed, using %lu.\n",
+                    (unsigned long) nofile,
+                    (unsigned long) file_limits.rlim_cur );
+        }
+    }
+
+    sm_selobj_mutex_initialize();
+
+    error = sm_selobj_initialize();
+    if( SM_OKAY != error )
+    {
+        printf( "Failed to initialize selection objects, error=%s.\n",
+                sm_error_str( error ) );
+        return( EXIT_FAILURE );
+    }
+
+    // As in sm, the spawner is forked before the heap grows.
+    error = sm_spawner_initialize();
+    if( SM_OKAY != error )
+    {
+        printf( "Failed to start the spawner, error=%s.\n",
+                sm_error_str( error ) );
+        return( EXIT_FAILURE );
+    }
+
+    getrlimit( RLIMIT_NOFILE, &file_limits );
+
+    printf( "actions: %u, open file limit: %lu\n", actions,
+            (unsigned long) file_limits.rlim_cur );
+
+    unsigned int heap_i;
+    for( heap_i=0; num_heaps > heap_i; ++heap_i )
+    {
+        if( SM_OKAY != sm_spawner_bench_grow_heap( heaps[heap_i] ) )
+        {
+            return( EXIT_FAILURE );
+        }
+
+        int path_i;
+        for( path_i=0; SM_SPAWNER_BENCH_MAX > path_i; ++path_i )
+        {
+            if( SM_OKAY != sm_spawner_bench_run( (SmSpawnerBenchPathT) path_i,
+                                                 actions ) )
+            {
+                return( EXIT_FAILURE );
+            }
+        }
+    }
+
+    sm_spawner_finalize();
+    sm_selobj_finalize();
+
+    return( EXIT_SUCCESS );
+}
+// ****************************************************************************
@@ -0,0 +1,782 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "sm_swact_profiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_time.h"
+#include "sm_service_group_member_table.h"
+#include "sm_configuration_table.h"
+
+#define SM_SWACT_PROFILER_SPANS_MAX                                  512
+#define SM_SWACT_PROFILER_PATH_MAX                                    32
+#define SM_SWACT_PROFILER_HISTORY_MAX                                 16
+#define SM_SWACT_PROFILER_REPORTS_DEFAULT                              5
+#define SM_SWACT_PROFILER_REPORTS_MAX                                 50
+#define SM_SWACT_PROFILER_REPORTS_KEY             "sm_swact_profile_reports"
+#define SM_SWACT_PROFILER_REPORT_FILE        "/var/log/sm-swact-profile.log"
+
+typedef struct
+{
+    bool is_group;
+    char name[SM_SERVICE_NAME_MAX_CHAR];
+    int from_state;
+    int via_state;
+    int to_state;
+    long start_ms;
+    long end_ms;
+    long dep_wait_ms;
+    char blocker[SM_SERVICE_NAME_MAX_CHAR];
+    SmServiceActionT action;
+    long launch_ms;
+    long exit_ms;
+    int exit_code;
+    long persist_us;
+} SmSwactProfilerSpanT;
+
+typedef struct
+{
+    char name[SM_SERVICE_NAME_MAX_CHAR];
+    long self_ms;
+} SmSwactProfilerPathEntryT;
+
+typedef struct
+{
+    unsigned int seqno;
+    SmNodeScheduleStateT role;
+    bool result;
+    long duration_ms;
+    unsigned int path_len;
+    SmSwactProfilerPathEntryT path[SM_SWACT_PROFILER_PATH_MAX];
+} SmSwactProfilerSummaryT;
+
+static bool _running = false;
+static unsigned int _seqno = 0;
+static SmNodeScheduleStateT _role = SM_NODE_STATE_UNKNOWN;
+static SmTimeT _start;
+static struct timespec _start_real;
+static unsigned int _num_spans = 0;
+static unsigned int _dropped_spans = 0;
+static SmSwactProfilerSpanT _spans[SM_SWACT_PROFILER_SPANS_MAX];
+static unsigned int _num_summaries = 0;
+static SmSwactProfilerSummaryT _summaries[SM_SWACT_PROFILER_HISTORY_MAX];
+static SmSwactProfilerBlockerT _blockers[SM_SWACT_PROFILER_HISTORY_MAX
+                                         * SM_SWACT_PROFILER_PATH_MAX];
+
+// ****************************************************************************
+// Swact Profiler - Find Span
+// ==========================
+static SmSwactProfilerSpanT* sm_swact_profiler_find_span( const char name[],
+    bool is_group, bool create )
+{
+    SmSwactProfilerSpanT* span;
+
+    unsigned int span_i;
+    for( span_i=0; _num_spans > span_i; ++span_i )
+    {
+        span = &(_spans[span_i]);
+
+        if(( is_group == span->is_group )&&( 0 == strcmp( name, span->name ) ))
+        {
+            return( span );
+        }
+    }
+
+    if( !create )
+    {
+        return( NULL );
+    }
+
+    if( SM_SWACT_PROFILER_SPANS_MAX <= _num_spans )
+    {
+        ++_dropped_spans;
+        return( NULL );
+    }
+
+    span = &(_spans[_num_spans++]);
+    memset( span, 0, sizeof(SmSwactProfilerSpanT) );
+    span->is_group = is_group;
+    snprintf( span->name, sizeof(span->name), "%s", name );
+    span->start_ms = -1;
+    span->end_ms = -1;
+    span->dep_wait_ms = -1;
+    span->action = SM_SERVICE_ACTION_NONE;
+    span->launch_ms = -1;
+    span->exit_ms = -1;
+
+    return( span );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Start
+// ======================
+void sm_swact_profiler_start( SmNodeScheduleStateT role )
+{
+    if( _running )
+    {
+        return;
+    }
+
+    _running = true;
+    _role = role;
+    _num_spans = 0;
+    _dropped_spans = 0;
+    ++_seqno;
+
+    sm_time_get( &_start );
+    clock_gettime( CLOCK_REALTIME, &_start_real );
+
+    DPRINTFI( "Swact profile (%u) started, host will be %s.", _seqno,
+              sm_node_schedule_state_str( role ) );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Service State
+// ==============================
+void sm_swact_profiler_service_state( char service_name[],
+    SmServiceStateT prev_state, SmServiceStateT state )
+{
+    SmSwactProfilerSpanT* span;
+
+    if( !_running )
+    {
+        return;
+    }
+
+    switch( state )
+    {
+        case SM_SERVICE_STATE_ENABLED_GO_ACTIVE:
+        case SM_SERVICE_STATE_ENABLED_GO_STANDBY:
+        case SM_SERVICE_STATE_ENABLING_THROTTLE:
+        case SM_SERVICE_STATE_ENABLING:
+        case SM_SERVICE_STATE_DISABLING:
+            span = sm_swact_profiler_find_span( service_name, false, true );
+            if( NULL == span )
+            {
+                return;
+            }
+
+            if( 0 > span->start_ms )
+            {
+                span->start_ms = sm_time_get_elapsed_ms( &_start );
+                span->from_state = prev_state;
+            }
+            span->via_state = state;
+            span->end_ms = -1;
+        break;
+
+        default:
+            span = sm_swact_profiler_find_span( service_name, false, false );
+            if(( NULL == span )||( 0 > span->start_ms ))
+            {
+                return;
+            }
+
+            span->end_ms = sm_time_get_elapsed_ms( &_start );
+            span->to_state = state;
+        break;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Service Group State
+// ====================================
+void sm_swact_profiler_service_group_state( char service_group_name[],
+    SmServiceGroupStateT prev_state, SmServiceGroupStateT state )
+{
+    SmSwactProfilerSpanT* span;
+
+    if( !_running )
+    {
+        return;
+    }
+
+    switch( state )
+    {
+        case SM_SERVICE_GROUP_STATE_GO_ACTIVE:
+        case SM_SERVICE_GROUP_STATE_GO_STANDBY:
+        case SM_SERVICE_GROUP_STATE_DISABLING:
+            span = sm_swact_profiler_find_span( service_group_name, true, true );
+            if( NULL == span )
+            {
+                return;
+            }
+
+            if( 0 > span->start_ms )
+            {
+                span->start_ms = sm_time_get_elapsed_ms( &_start );
+                span->from_state = prev_state;
+            }
+            span->via_state = state;
+            span->end_ms = -1;
+        break;
+
+        default:
+            span = sm_swact_profiler_find_span( service_group_name, true,
+                                                false );
+            if(( NULL == span )||( 0 > span->start_ms ))
+            {
+                return;
+            }
+
+            span->end_ms = sm_time_get_elapsed_ms( &_start );
+            span->to_state = state;
+        break;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Dependency Unmet
+// =================================
+void sm_swact_profiler_dependency_unmet( char service_name[],
+    char dependent[] )
+{
+    SmSwactProfilerSpanT* span;
+
+    if( !_running )
+    {
+        return;
+    }
+
+    span = sm_swact_profiler_find_span( service_name, false, true );
+    if( NULL == span )
+    {
+        return;
+    }
+
+    if( 0 > span->dep_wait_ms )
+    {
+        span->dep_wait_ms = sm_time_get_elapsed_ms( &_start );
+    }
+
+    // The last dependency seen unmet is the one that gated the service.
+    snprintf( span->blocker, sizeof(span->blocker), "%s", dependent );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Action
+// =======================
+void sm_swact_profiler_action( char service_name[], SmServiceActionT action,
+    SmTimeT* launched, int exit_code )
+{
+    SmSwactProfilerSpanT* span;
+
+    if(( !_running )||( SM_SERVICE_ACTION_AUDIT_ENABLED == action )||
+       ( SM_SERVICE_ACTION_AUDIT_DISABLED == action ))
+    {
+        return;
+    }
+
+    span = sm_swact_profiler_find_span( service_name, false, true );
+    if( NULL == span )
+    {
+        return;
+    }
+
+    span->action = action;
+    span->launch_ms = sm_time_delta_in_ms( launched, &_start );
+    span->exit_ms = sm_time_get_elapsed_ms( &_start );
+    span->exit_code = exit_code;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Persisted
+// ==========================
+void sm_swact_profiler_persisted( char name[], bool is_group,
+    SmTimeT* started )
+{
+    SmSwactProfilerSpanT* span;
+    SmTimeT now;
+
+    if( !_running )
+    {
+        return;
+    }
+
+    span = sm_swact_profiler_find_span( name, is_group, false );
+    if( NULL == span )
+    {
+        return;
+    }
+
+    sm_time_get( &now );
+
+    span->persist_us += (now.tv_sec - started->tv_sec) * 1000000
+                      + (now.tv_nsec - started->tv_nsec) / 1000;
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Critical Path
+// ==============================
+// Walks back from the last service to finish, following the dependency
+// each service waited on last.
+static void sm_swact_profiler_critical_path( SmSwactProfilerSummaryT* summary )
+{
+    SmSwactProfilerSpanT* span = NULL;
+    SmSwactProfilerSpanT* blocker;
+    long ready_ms;
+
+    unsigned int span_i;
+    for( span_i=0; _num_spans > span_i; ++span_i )
+    {
+        if(( !_spans[span_i].is_group )&&( 0 <= _spans[span_i].end_ms )&&
+           (( NULL == span )||( _spans[span_i].end_ms > span->end_ms )))
+        {
+            span = &(_spans[span_i]);
+        }
+    }
+
+    summary->path_len = 0;
+
+    while(( NULL != span )&&
+          ( SM_SWACT_PROFILER_PATH_MAX > summary->path_len ))
+    {
+        blocker = NULL;
+        ready_ms = ( 0 <= span->start_ms ) ? span->start_ms : 0;
+
+        if( '\0' != span->blocker[0] )
+        {
+            blocker = sm_swact_profiler_find_span( span->blocker, false,
+                                                   false );
+            if(( NULL != blocker )&&
+               (( 0 > blocker->end_ms )||( blocker->end_ms > span->end_ms )))
+            {
+                blocker = NULL;
+            }
+        }
+
+        if(( NULL != blocker )&&( blocker->end_ms > ready_ms ))
+        {
+            ready_ms = blocker->end_ms;
+        }
+
+        SmSwactProfilerPathEntryT* entry = &(summary->path[summary->path_len++]);
+        snprintf( entry->name, sizeof(entry->name), "%s", span->name );
+        entry->self_ms = span->end_ms - ready_ms;
+
+        if( NULL != blocker )
+        {
+            unsigned int path_i;
+            for( path_i=0; summary->path_len > path_i; ++path_i )
+            {
+                if( 0 == strcmp( blocker->name, summary->path[path_i].name ) )
+                {
+                    blocker = NULL;
+                    break;
+                }
+            }
+        }
+
+        span = blocker;
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Format Span
+// ============================
+static void sm_swact_profiler_format_span( SmSwactProfilerSpanT* span,
+    char buf[], unsigned int buf_size )
+{
+    unsigned int len;
+
+    if( span->is_group )
+    {
+        len = snprintf( buf, buf_size, "group %s %s->%s->%s", span->name,
+                sm_service_group_state_str( (SmServiceGroupStateT) span->from_state ),
+                sm_service_group_state_str( (SmServiceGroupStateT) span->via_state ),
+                0 <= span->end_ms
+                ? sm_service_group_state_str( (SmServiceGroupStateT) span->to_state )
+                : "?" );
+    } else {
+        len = snprintf( buf, buf_size, "  service %s %s->%s->%s", span->name,
+                sm_service_state_str( (SmServiceStateT) span->from_state ),
+                sm_service_state_str( (SmServiceStateT) span->via_state ),
+                0 <= span->end_ms
+                ? sm_service_state_str( (SmServiceStateT) span->to_state )
+                : "?" );
+    }
+
+    if(( buf_size > len )&&( 0 <= span->start_ms ))
+    {
+        len += snprintf( buf+len, buf_size-len, " start=%li", span->start_ms );
+    }
+
+    if(( buf_size > len )&&( 0 <= span->dep_wait_ms ))
+    {
+        len += snprintf( buf+len, buf_size-len, " dep_wait=%li blocker=%s",
+                         span->dep_wait_ms, span->blocker );
+    }
+
+    if(( buf_size > len )&&( SM_SERVICE_ACTION_NONE != span->action ))
+    {
+        len += snprintf( buf+len, buf_size-len, " %s=%li..%li rc=%i",
+                         sm_service_action_str( span->action ),
+                         span->launch_ms, span->exit_ms, span->exit_code );
+    }
+
+    if(( buf_size > len )&&( 0 < span->persist_us ))
+    {
+        len += snprintf( buf+len, buf_size-len, " persist_us=%li",
+                         span->persist_us );
+    }
+
+    if(( buf_size > len )&&( 0 <= span->end_ms ))
+    {
+        snprintf( buf+len, buf_size-len, " end=%li", span->end_ms );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Max Reports
+// ============================
+static unsigned int sm_swact_profiler_max_reports( void )
+{
+    char buf[SM_CONFIGURATION_VALUE_MAX_CHAR + 1];
+    int max_reports = SM_SWACT_PROFILER_REPORTS_DEFAULT;
+
+    if(( SM_OKAY == sm_configuration_table_get( SM_SWACT_PROFILER_REPORTS_KEY,
+                                                buf, sizeof(buf) - 1 ) )&&
+       ( '\0' != buf[0] ))
+    {
+        max_reports = atoi( buf );
+    }
+
+    if(( 0 > max_reports )||( SM_SWACT_PROFILER_REPORTS_MAX < max_reports ))
+    {
+        DPRINTFE( "Invalid %s value %i, using %i.",
+                  SM_SWACT_PROFILER_REPORTS_KEY, max_reports,
+                  SM_SWACT_PROFILER_REPORTS_DEFAULT );
+        max_reports = SM_SWACT_PROFILER_REPORTS_DEFAULT;
+    }
+
+    return( (unsigned int) max_reports );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Write Report
+// =============================
+// The newest report is in the report file, older ones are in .1, .2, ...
+static void sm_swact_profiler_write_report( SmSwactProfilerSummaryT* summary )
+{
+    char from[128];
+    char to[128];
+    char line[512];
+    char date_str[32];
+    struct tm t_real;
+    SmServiceGroupMemberT* member;
+    FILE* fp;
+    unsigned int max_reports = sm_swact_profiler_max_reports();
+
+    if( 0 == max_reports )
+    {
+        return;
+    }
+
+    unsigned int report_i;
+    for( report_i=max_reports-1; 0 < report_i; --report_i )
+    {
+        if( 1 == report_i )
+        {
+            snprintf( from, sizeof(from), "%s", SM_SWACT_PROFILER_REPORT_FILE );
+        } else {
+            snprintf( from, sizeof(from), "%s.%u",
+                      SM_SWACT_PROFILER_REPORT_FILE, report_i-1 );
+        }
+        snprintf( to, sizeof(to), "%s.%u", SM_SWACT_PROFILER_REPORT_FILE,
+                  report_i );
+
+        if(( 0 > rename( from, to ) )&&( ENOENT != errno ))
+        {
+            DPRINTFE( "Failed to rotate swact profile (%s), error=%s.",
+                      from, strerror( errno ) );
+        }
+    }
+
+    fp = fopen( SM_SWACT_PROFILER_REPORT_FILE, "w" );
+    if( NULL == fp )
+    {
+        DPRINTFE( "Failed to open swact profile (%s), error=%s.",
+                  SM_SWACT_PROFILER_REPORT_FILE, strerror( errno ) );
+        return;
+    }
+
+    if( NULL == localtime_r( &(_start_real.tv_sec), &t_real ) )
+    {
+        snprintf( date_str, sizeof(date_str), "YYYY:MM:DD HH:MM:SS" );
+    } else {
+        strftime( date_str, sizeof(date_str), "%FT%T", &t_real );
+    }
+
+    fprintf( fp, "swact-profile seqno=%u role=%s result=%s started=%s.%03ld "
+             "duration_ms=%li spans=%u dropped=%u\n", summary->seqno,
+             sm_node_schedule_state_str( summary->role ),
+             summary->result ? "success" : "failed", date_str,
+             _start_real.tv_nsec / 1000000, summary->duration_ms, _num_spans,
+             _dropped_spans );
+
+    fprintf( fp, "critical-path-ms:" );
+    unsigned int path_i;
+    for( path_i=0; summary->path_len > path_i; ++path_i )
+    {
+        fprintf( fp, "%s %s=%li", 0 == path_i ? "" : " <-",
+                 summary->path[path_i].name, summary->path[path_i].self_ms );
+    }
+    fprintf( fp, "\n" );
+
+    unsigned int group_i;
+    for( group_i=0; _num_spans >= group_i; ++group_i )
+    {
+        const char* group_name = "-";
+
+        if( _num_spans > group_i )
+        {
+            if( !_spans[group_i].is_group )
+                continue;
+
+            group_name = _spans[group_i].name;
+            sm_swact_profiler_format_span( &(_spans[group_i]), line,
+                                           sizeof(line) );
+            fprintf( fp, "%s\n", line );
+        } else {
+            fprintf( fp, "group -\n" );
+        }
+
+        unsigned int span_i;
+        for( span_i=0; _num_spans > span_i; ++span_i )
+        {
+            if( _spans[span_i].is_group )
+                continue;
+
+            member = sm_service_group_member_table_read_by_service(
+                                                    _spans[span_i].name );
+
+            if( _num_spans > group_i )
+            {
+                if(( NULL == member )||( 0 != strcmp( group_name, member->name ) ))
+                    continue;
+            } else {
+                // Services whose group did not change state.
+                if(( NULL != member )&&
+                   ( NULL != sm_swact_profiler_find_span( member->name, true,
+                                                          false ) ))
+                    continue;
+            }
+
+            sm_swact_profiler_format_span( &(_spans[span_i]), line,
+                                           sizeof(line) );
+            fprintf( fp, "%s\n", line );
+        }
+    }
+
+    fclose( fp );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - End
+// ====================
+void sm_swact_profiler_end( bool result )
+{
+    SmSwactProfilerSummaryT* summary;
+
+    if( !_running )
+    {
+        return;
+    }
+
+    _running = false;
+
+    summary = &(_summaries[_num_summaries % SM_SWACT_PROFILER_HISTORY_MAX]);
+    memset( summary, 0, sizeof(SmSwactProfilerSummaryT) );
+    summary->seqno = _seqno;
+    summary->role = _role;
+    summary->result = result;
+    summary->duration_ms = sm_time_get_elapsed_ms( &_start );
+
+    sm_swact_profiler_critical_path( summary );
+    ++_num_summaries;
+
+    DPRINTFI( "Swact profile (%u) %s after %li ms, last to finish was %s.",
+              summary->seqno, result ? "completed" : "failed",
+              summary->duration_ms,
+              0 < summary->path_len ? summary->path[0].name : "none" );
+
+    sm_swact_profiler_write_report( summary );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Top Blockers
+// =============================
+static int sm_swact_profiler_blocker_compare( const void* a, const void* b )
+{
+    const SmSwactProfilerBlockerT* blocker_a = (const SmSwactProfilerBlockerT*) a;
+    const SmSwactProfilerBlockerT* blocker_b = (const SmSwactProfilerBlockerT*) b;
+
+    if( blocker_a->total_ms != blocker_b->total_ms )
+    {
+        return( blocker_a->total_ms < blocker_b->total_ms ? 1 : -1 );
+    }
+
+    return( strcmp( blocker_a->name, blocker_b->name ) );
+}
+
+unsigned int sm_swact_profiler_top_blockers(
+    SmSwactProfilerBlockerT blockers[], unsigned int max_blockers )
+{
+    SmSwactProfilerSummaryT* summary;
+    SmSwactProfilerBlockerT* blocker;
+    unsigned int num_blockers = 0;
+    unsigned int num_summaries = _num_summaries;
+
+    if( SM_SWACT_PROFILER_HISTORY_MAX < num_summaries )
+    {
+        num_summaries = SM_SWACT_PROFILER_HISTORY_MAX;
+    }
+
+    unsigned int summary_i;
+    for( summary_i=0; num_summaries > summary_i; ++summary_i )
+    {
+        summary = &(_summaries[summary_i]);
+
+        unsigned int path_i;
+        for( path_i=0; summary->path_len > path_i; ++path_i )
+        {
+            blocker = NULL;
+
+            unsigned int blocker_i;
+            for( blocker_i=0; num_blockers > blocker_i; ++blocker_i )
+            {
+                if( 0 == strcmp( _blockers[blocker_i].name,
+                                 summary->path[path_i].name ) )
+                {
+                    blocker = &(_blockers[blocker_i]);
+                    break;
+                }
+            }
+
+            if( NULL == blocker )
+            {
+                blocker = &(_blockers[num_blockers++]);
+                memset( blocker, 0, sizeof(SmSwactProfilerBlockerT) );
+                snprintf( blocker->name, sizeof(blocker->name), "%s",
+                          summary->path[path_i].name );
+            }
+
+            blocker->swacts++;
+            blocker->total_ms += summary->path[path_i].self_ms;
+            if( summary->path[path_i].self_ms > blocker->max_ms )
+            {
+                blocker->max_ms = summary->path[path_i].self_ms;
+            }
+        }
+    }
+
+    qsort( _blockers, num_blockers, sizeof(SmSwactProfilerBlockerT),
+           sm_swact_profiler_blocker_compare );
+
+    if( max_blockers > num_blockers )
+    {
+        max_blockers = num_blockers;
+    }
+
+    memcpy( blockers, _blockers, max_blockers * sizeof(SmSwactProfilerBlockerT) );
+
+    return( max_blockers );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Dump Data
+// ==========================
+void sm_swact_profiler_dump_data( FILE* log )
+{
+    SmSwactProfilerBlockerT blockers[10];
+    SmSwactProfilerSummaryT* summary;
+    unsigned int num_blockers;
+
+    fprintf( log, "--------------------------------------------------------------------\n" );
+    fprintf( log, "SWACT PROFILER DATA\n" );
+    fprintf( log, "  running......................................%s\n", _running ? "yes" : "no" );
+    fprintf( log, "  seqno........................................%u\n", _seqno );
+    fprintf( log, "  spans........................................%u\n", _num_spans );
+    fprintf( log, "  dropped_spans................................%u\n", _dropped_spans );
+
+    unsigned int summary_i;
+    for( summary_i=0; SM_SWACT_PROFILER_HISTORY_MAX > summary_i; ++summary_i )
+    {
+        summary = &(_summaries[summary_i]);
+
+        if( 0 == summary->seqno )
+            continue;
+
+        fprintf( log, "  swact %u role=%s result=%s duration_ms=%li "
+                 "critical_path=%s\n", summary->seqno,
+                 sm_node_schedule_state_str( summary->role ),
+                 summary->result ? "success" : "failed",
+                 summary->duration_ms,
+                 0 < summary->path_len ? summary->path[0].name : "none" );
+    }
+
+    num_blockers = sm_swact_profiler_top_blockers( blockers,
+                        sizeof(blockers) / sizeof(SmSwactProfilerBlockerT) );
+
+    unsigned int blocker_i;
+    for( blocker_i=0; num_blockers > blocker_i; ++blocker_i )
+    {
+        fprintf( log, "  blocker %-32s swacts=%u total_ms=%li max_ms=%li\n",
+                 blockers[blocker_i].name, blockers[blocker_i].swacts,
+                 blockers[blocker_i].total_ms, blockers[blocker_i].max_ms );
+    }
+    fprintf( log, "--------------------------------------------------------------------\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Initialize
+// ===========================
+SmErrorT sm_swact_profiler_initialize( void )
+{
+    _running = false;
+    _seqno = 0;
+    _num_spans = 0;
+    _dropped_spans = 0;
+    _num_summaries = 0;
+    memset( _summaries, 0, sizeof(_summaries) );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Finalize
+// =========================
+SmErrorT sm_swact_profiler_finalize( void )
+{
+    _running = false;
+    _num_spans = 0;
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __SM_SWACT_PROFILER_H__
+#define __SM_SWACT_PROFILER_H__
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+#include "sm_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    char name[SM_SERVICE_NAME_MAX_CHAR];
+    unsigned int swacts;
+    long total_ms;
+    long max_ms;
+} SmSwactProfilerBlockerT;
+
+// ****************************************************************************
+// Swact Profiler - Start
+// ======================
+// Starts a new profile, ignored while a profile is already running.
+extern void sm_swact_profiler_start( SmNodeScheduleStateT role );
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - End
+// ====================
+// Computes the critical path and writes the report, ignored when no
+// profile is running.
+extern void sm_swact_profiler_end( bool result );
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Service State
+// ==============================
+extern void sm_swact_profiler_service_state( char service_name[],
+    SmServiceStateT prev_state, SmServiceStateT state );
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Service Group State
+// ====================================
+extern void sm_swact_profiler_service_group_state( char service_group_name[],
+    SmServiceGroupStateT prev_state, SmServiceGroupStateT state );
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Dependency Unmet
+// =================================
+extern void sm_swact_profiler_dependency_unmet( char service_name[],
+    char dependent[] );
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Action
+// =======================
+// Records an action that was launched at the given time and has exited.
+extern void sm_swact_profiler_action( char service_name[],
+    SmServiceActionT action, SmTimeT* launched, int exit_code );
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Persisted
+// ==========================
+extern void sm_swact_profiler_persisted( char name[], bool is_group,
+    SmTimeT* started );
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Top Blockers
+// =============================
+// Fills in the services found most on the critical path of recent swacts,
+// ordered by the time they held the swact up.  Returns the number filled.
+extern unsigned int sm_swact_profiler_top_blockers(
+    SmSwactProfilerBlockerT blockers[], unsigned int max_blockers );
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Dump Data
+// ==========================
+extern void sm_swact_profiler_dump_data( FILE* log );
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Initialize
+// ===========================
+extern SmErrorT sm_swact_profiler_initialize( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Swact Profiler - Finalize
+// =========================
+extern SmErrorT sm_swact_profiler_finalize( void );
+// ****************************************************************************
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SM_SWACT_PROFILER_H__
@@ -5,6 +5,7 @@
 //
 #include "sm_task_affining_thread.h"
 #include "sm_swact_state.h"
+#include "sm_task_affinity.h"
 #include "sm_time.h"
 #include "sm_debug.h"
 #include "sm_trap.h"
@@ -33,26 +34,39 @@ static pthread_t _task_affining_thread;
 // ============================================
 void affine_tasks( void )
 {
+    SmErrorT error;
+
     switch (sm_get_swact_state()) 
     {
         case SM_SWACT_STATE_START:
-	    DPRINTFI("Invoking system call, affining to idle cores...");
-	    system("source /etc/init.d/task_affinity_functions.sh; affine_tasks_to_idle_cores 2>/dev/null");
+            DPRINTFI("Affining tasks to idle cores...");
+            error = sm_task_affinity_affine_tasks( SM_TASK_AFFINITY_CPUS_IDLE );
+            if( SM_OKAY != error )
+            {
+                DPRINTFE( "Failed to affine tasks to idle cores, error=%s.",
+                          sm_error_str( error ) );
+            }
             DPRINTFI("Done affining tasks to idle cores, set state to none");
             sm_set_swact_state( SM_SWACT_STATE_NONE );
             return;
         case SM_SWACT_STATE_END:
-  	    DPRINTFI("Invoking system call, affining to platform cores...");
-            system("source /etc/init.d/task_affinity_functions.sh; affine_tasks_to_platform_cores 2>/dev/null");
-	    DPRINTFI("Done affining tasks to platform cores, set state to none");
+            DPRINTFI("Affining tasks to platform cores...");
+            error = sm_task_affinity_affine_tasks( SM_TASK_AFFINITY_CPUS_PLATFORM );
+            if( SM_OKAY != error )
+            {
+                DPRINTFE( "Failed to affine tasks to platform cores, error=%s.",
+                          sm_error_str( error ) );
+            }
+            DPRINTFI("Done affining tasks to platform cores, set state to none");
             sm_set_swact_state( SM_SWACT_STATE_NONE );
-	    return;
-	default:
-	    // SM_SWACT_STATE_NONE and everything else...
-	    return;
+            return;
+        default:
+            // SM_SWACT_STATE_NONE and everything else...
+            return;
     }
 }
-	
+// ****************************************************************************
+
 // ****************************************************************************
 // Task Affining Thread - Initialize Thread
 // ============================================
@@ -0,0 +1,582 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "sm_task_affinity.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/syscall.h>
+
+#include "sm_limits.h"
+#include "sm_types.h"
+#include "sm_debug.h"
+#include "sm_time.h"
+#include "sm_util_types.h"
+#include "sm_configuration_table.h"
+
+#define SM_TASK_AFFINITY_PLATFORM_CORES_FILE    "/var/run/sm/.platform_cores"
+#define SM_TASK_AFFINITY_ONLINE_CPUS_FILE       "/sys/devices/system/cpu/online"
+#define SM_TASK_AFFINITY_ISOLATED_CPUS_FILE     "/sys/devices/system/cpu/isolated"
+#define SM_TASK_AFFINITY_RT_CPU_KEY             "sm_rt_cpu"
+#define SM_TASK_AFFINITY_RT_PRIORITY_KEY        "sm_rt_priority"
+#define SM_TASK_AFFINITY_PF_KTHREAD             0x00200000
+
+static cpu_set_t _platform_cpus;
+static cpu_set_t _idle_cpus;
+static int _rt_cpu = -1;
+static int _rt_priority = 0;
+static pid_t _pinned_tids[SM_THREADS_MAX];
+static pthread_mutex_t _pinned_tids_mutex;
+
+static uint64_t _affine_runs = 0;
+static uint64_t _tasks_affined = 0;
+static uint64_t _tasks_skipped = 0;
+static uint64_t _tasks_kept = 0;
+static uint64_t _tasks_failed = 0;
+static long _last_affine_ms = 0;
+static uint64_t _threads_pinned = 0;
+static uint64_t _threads_pin_failed = 0;
+
+// ****************************************************************************
+// Task Affinity - Cpus String
+// ===========================
+static const char* sm_task_affinity_cpus_str( SmTaskAffinityCpusT cpus )
+{
+    switch( cpus )
+    {
+        case SM_TASK_AFFINITY_CPUS_PLATFORM:
+            return( "platform" );
+        case SM_TASK_AFFINITY_CPUS_IDLE:
+            return( "idle" );
+        default:
+            return( "???" );
+    }
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Read File
+// =========================
+static bool sm_task_affinity_read_file( const char filename[], char buf[],
+    unsigned int buf_size )
+{
+    FILE* fp;
+    size_t len;
+
+    buf[0] = '\0';
+
+    fp = fopen( filename, "r" );
+    if( NULL == fp )
+    {
+        return( false );
+    }
+
+    len = fread( buf, 1, buf_size-1, fp );
+    buf[len] = '\0';
+
+    fclose( fp );
+
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Parse Cpu List
+// ==============================
+// Accepts both the comma separated list written for the platform cores
+// and the kernel range format, e.g. "0-3,8,10-11".
+static int sm_task_affinity_parse_cpu_list( const char cpu_list[],
+    cpu_set_t* cpus )
+{
+    const char* p = cpu_list;
+    char* end;
+    long first, last, cpu_i;
+    int count = 0;
+
+    CPU_ZERO( cpus );
+
+    while( '\0' != *p )
+    {
+        if( !isdigit( *p ) )
+        {
+            ++p;
+            continue;
+        }
+
+        first = strtol( p, &end, 10 );
+        last = first;
+        p = end;
+
+        if( '-' == *p )
+        {
+            last = strtol( p+1, &end, 10 );
+            p = end;
+        }
+
+        for( cpu_i=first; (cpu_i <= last) && (CPU_SETSIZE > cpu_i); ++cpu_i )
+        {
+            if( !CPU_ISSET( cpu_i, cpus ) )
+            {
+                CPU_SET( cpu_i, cpus );
+                ++count;
+            }
+        }
+    }
+
+    return( count );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Load Cpus
+// =========================
+static void sm_task_affinity_load_cpus( void )
+{
+    char buf[1024];
+    cpu_set_t isolated_cpus;
+
+    if(( !sm_task_affinity_read_file( SM_TASK_AFFINITY_PLATFORM_CORES_FILE,
+                                      buf, sizeof(buf) ) )||
+       ( 0 == sm_task_affinity_parse_cpu_list( buf, &_platform_cpus ) ))
+    {
+        // sm is started on the platform cores.
+        if( 0 > sched_getaffinity( 0, sizeof(_platform_cpus), &_platform_cpus ) )
+        {
+            DPRINTFE( "Failed to get platform cpus, error=%s.",
+                      strerror( errno ) );
+            CPU_ZERO( &_platform_cpus );
+        }
+    }
+
+    if(( !sm_task_affinity_read_file( SM_TASK_AFFINITY_ONLINE_CPUS_FILE,
+                                      buf, sizeof(buf) ) )||
+       ( 0 == sm_task_affinity_parse_cpu_list( buf, &_idle_cpus ) ))
+    {
+        DPRINTFE( "Failed to get online cpus, using platform cpus." );
+        CPU_OR( &_idle_cpus, &_idle_cpus, &_platform_cpus );
+        return;
+    }
+
+    if(( sm_task_affinity_read_file( SM_TASK_AFFINITY_ISOLATED_CPUS_FILE,
+                                     buf, sizeof(buf) ) )&&
+       ( 0 < sm_task_affinity_parse_cpu_list( buf, &isolated_cpus ) ))
+    {
+        CPU_XOR( &isolated_cpus, &isolated_cpus, &_idle_cpus );
+        CPU_AND( &_idle_cpus, &_idle_cpus, &isolated_cpus );
+    }
+
+    CPU_OR( &_idle_cpus, &_idle_cpus, &_platform_cpus );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Load Realtime Configuration
+// ===========================================
+static void sm_task_affinity_load_rt_config( void )
+{
+    char buf[SM_CONFIGURATION_VALUE_MAX_CHAR + 1];
+    int min_priority = sched_get_priority_min( SCHED_FIFO );
+    int max_priority = sched_get_priority_max( SCHED_FIFO );
+
+    _rt_cpu = -1;
+    _rt_priority = 0;
+
+    if(( SM_OKAY == sm_configuration_table_get( SM_TASK_AFFINITY_RT_CPU_KEY,
+                                    buf, sizeof(buf) - 1 ) )&&( '\0' != buf[0] ))
+    {
+        _rt_cpu = atoi( buf );
+        if(( 0 > _rt_cpu )||( CPU_SETSIZE <= _rt_cpu )||
+           ( !CPU_ISSET( _rt_cpu, &_platform_cpus ) ))
+        {
+            DPRINTFE( "Invalid %s value %s, not a platform cpu, ignored.",
+                      SM_TASK_AFFINITY_RT_CPU_KEY, buf );
+            _rt_cpu = -1;
+        }
+    }
+
+    if(( SM_OKAY == sm_configuration_table_get( SM_TASK_AFFINITY_RT_PRIORITY_KEY,
+                                    buf, sizeof(buf) - 1 ) )&&( '\0' != buf[0] ))
+    {
+        _rt_priority = atoi( buf );
+        if(( min_priority > _rt_priority )||( max_priority < _rt_priority ))
+        {
+            DPRINTFE( "Invalid %s value %s, expected %i to %i, ignored.",
+                      SM_TASK_AFFINITY_RT_PRIORITY_KEY, buf, min_priority,
+                      max_priority );
+            _rt_priority = 0;
+        }
+    }
+
+    DPRINTFI( "Platform cpus=%i, idle cpus=%i, realtime cpu=%i, "
+              "realtime priority=%i.", CPU_COUNT( &_platform_cpus ),
+              CPU_COUNT( &_idle_cpus ), _rt_cpu, _rt_priority );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Is Pinned
+// =========================
+static bool sm_task_affinity_is_pinned( pid_t tid )
+{
+    mutex_holder holder( &_pinned_tids_mutex );
+
+    unsigned int tid_i;
+    for( tid_i=0; SM_THREADS_MAX > tid_i; ++tid_i )
+    {
+        if( tid == _pinned_tids[tid_i] )
+        {
+            return( true );
+        }
+    }
+
+    return( false );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Is Kernel Thread
+// ================================
+static bool sm_task_affinity_is_kernel_thread( const char pid_str[] )
+{
+    char filename[64];
+    char buf[512];
+    char* p;
+    unsigned int flags = 0;
+
+    snprintf( filename, sizeof(filename), "/proc/%s/stat", pid_str );
+
+    if( !sm_task_affinity_read_file( filename, buf, sizeof(buf) ) )
+    {
+        return( false );
+    }
+
+    // The command name can contain spaces, fields resume after the last ')'.
+    p = strrchr( buf, ')' );
+    if( NULL == p )
+    {
+        return( false );
+    }
+
+    if( 1 != sscanf( p+1, " %*c %*d %*d %*d %*d %*d %u", &flags ) )
+    {
+        return( false );
+    }
+
+    return( SM_TASK_AFFINITY_PF_KTHREAD & flags );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Affine Tasks
+// ============================
+SmErrorT sm_task_affinity_affine_tasks( SmTaskAffinityCpusT cpus )
+{
+    cpu_set_t* cpu_set;
+    cpu_set_t* replaced_set;
+    cpu_set_t task_set;
+    char task_dir_name[64];
+    DIR* proc_dir;
+    DIR* task_dir;
+    struct dirent* proc_entry;
+    struct dirent* task_entry;
+    SmTimeT time_prev;
+    pid_t tid;
+    uint64_t affined = 0;
+    uint64_t skipped = 0;
+    uint64_t kept = 0;
+    uint64_t failed = 0;
+
+    // Only tasks still on the set being replaced are moved, anything else
+    // was given its affinity on purpose.
+    switch( cpus )
+    {
+        case SM_TASK_AFFINITY_CPUS_PLATFORM:
+            cpu_set = &_platform_cpus;
+            replaced_set = &_idle_cpus;
+        break;
+        case SM_TASK_AFFINITY_CPUS_IDLE:
+            cpu_set = &_idle_cpus;
+            replaced_set = &_platform_cpus;
+        break;
+        default:
+            DPRINTFE( "Unknown cpus (%i) given.", cpus );
+            return( SM_FAILED );
+    }
+
+    if( 0 == CPU_COUNT( cpu_set ) )
+    {
+        DPRINTFE( "No %s cpus available.", sm_task_affinity_cpus_str( cpus ) );
+        return( SM_FAILED );
+    }
+
+    sm_time_get( &time_prev );
+
+    proc_dir = opendir( "/proc" );
+    if( NULL == proc_dir )
+    {
+        DPRINTFE( "Failed to open /proc, error=%s.", strerror( errno ) );
+        return( SM_FAILED );
+    }
+
+    while( NULL != (proc_entry = readdir( proc_dir )) )
+    {
+        if( !isdigit( proc_entry->d_name[0] ) )
+        {
+            continue;
+        }
+
+        if( sm_task_affinity_is_kernel_thread( proc_entry->d_name ) )
+        {
+            continue;
+        }
+
+        snprintf( task_dir_name, sizeof(task_dir_name), "/proc/%s/task",
+                  proc_entry->d_name );
+
+        task_dir = opendir( task_dir_name );
+        if( NULL == task_dir )
+        {
+            // Process exited.
+            ++skipped;
+            continue;
+        }
+
+        while( NULL != (task_entry = readdir( task_dir )) )
+        {
+            if( !isdigit( task_entry->d_name[0] ) )
+            {
+                continue;
+            }
+
+            tid = (pid_t) atoi( task_entry->d_name );
+
+            if( sm_task_affinity_is_pinned( tid ) )
+            {
+                ++skipped;
+                continue;
+            }
+
+            if( 0 > sched_getaffinity( tid, sizeof(task_set), &task_set ) )
+            {
+                // Task exited.
+                ++skipped;
+                continue;
+            }
+
+            if( !CPU_EQUAL( &task_set, replaced_set ) )
+            {
+                if( CPU_EQUAL( &task_set, cpu_set ) )
+                {
+                    ++skipped;
+                } else {
+                    ++kept;
+                }
+                continue;
+            }
+
+            if( 0 == sched_setaffinity( tid, sizeof(cpu_set_t), cpu_set ) )
+            {
+                ++affined;
+
+            } else if(( ESRCH == errno )||( EINVAL == errno )) {
+                // Task exited or is restricted to specific cpus.
+                ++skipped;
+
+            } else {
+                DPRINTFD( "Failed to set affinity of task %i, error=%s.",
+                          (int) tid, strerror( errno ) );
+                ++failed;
+            }
+        }
+
+        closedir( task_dir );
+    }
+
+    closedir( proc_dir );
+
+    _last_affine_ms = sm_time_get_elapsed_ms( &time_prev );
+    ++_affine_runs;
+    _tasks_affined += affined;
+    _tasks_skipped += skipped;
+    _tasks_kept += kept;
+    _tasks_failed += failed;
+
+    DPRINTFI( "Affined tasks to %s cpus (%i), affined=%" PRIu64 ", "
+              "skipped=%" PRIu64 ", kept own affinity=%" PRIu64 ", "
+              "failed=%" PRIu64 ", took %li ms.",
+              sm_task_affinity_cpus_str( cpus ), CPU_COUNT( cpu_set ),
+              affined, skipped, kept, failed, _last_affine_ms );
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Pin Thread
+// ==========================
+SmErrorT sm_task_affinity_pin_thread( const char thread_name[] )
+{
+    pid_t tid = (pid_t) syscall( SYS_gettid );
+
+    if( 0 <= _rt_cpu )
+    {
+        cpu_set_t cpu_set;
+
+        CPU_ZERO( &cpu_set );
+        CPU_SET( _rt_cpu, &cpu_set );
+
+        if( 0 > sched_setaffinity( 0, sizeof(cpu_set), &cpu_set ) )
+        {
+            DPRINTFE( "Failed to pin %s thread to cpu %i, error=%s.",
+                      thread_name, _rt_cpu, strerror( errno ) );
+            ++_threads_pin_failed;
+            return( SM_FAILED );
+        }
+
+        mutex_holder holder( &_pinned_tids_mutex );
+
+        unsigned int tid_i;
+        for( tid_i=0; SM_THREADS_MAX > tid_i; ++tid_i )
+        {
+            if( 0 == _pinned_tids[tid_i] )
+            {
+                _pinned_tids[tid_i] = tid;
+                break;
+            }
+        }
+    }
+
+    if( 0 < _rt_priority )
+    {
+        struct sched_param param;
+
+        memset( &param, 0, sizeof(param) );
+        param.sched_priority = _rt_priority;
+
+        // Processes forked from this thread must not inherit the policy.
+        if( 0 > sched_setscheduler( 0, SCHED_FIFO | SCHED_RESET_ON_FORK,
+                                    &param ) )
+        {
+            DPRINTFE( "Failed to set %s thread to SCHED_FIFO (priority=%i), "
+                      "error=%s.", thread_name, _rt_priority,
+                      strerror( errno ) );
+            ++_threads_pin_failed;
+            return( SM_FAILED );
+        }
+    }
+
+    if(( 0 <= _rt_cpu )||( 0 < _rt_priority ))
+    {
+        ++_threads_pinned;
+        DPRINTFI( "Thread %s (%i) pinned to cpu %i, realtime priority %i.",
+                  thread_name, (int) tid, _rt_cpu, _rt_priority );
+    }
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Restore Child
+// =============================
+void sm_task_affinity_restore_child( void )
+{
+    cpu_set_t cpus;
+
+    if( !sm_task_affinity_child_cpus( &cpus ) )
+    {
+        return;
+    }
+
+    sched_setaffinity( 0, sizeof(cpus), &cpus );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Child Cpus
+// ==========================
+bool sm_task_affinity_child_cpus( cpu_set_t* cpus )
+{
+    if(( 0 > _rt_cpu )||( 0 == CPU_COUNT( &_platform_cpus ) ))
+    {
+        return( false );
+    }
+
+    *cpus = _platform_cpus;
+    return( true );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Dump Data
+// =========================
+void sm_task_affinity_dump_data( FILE* log )
+{
+    fprintf( log, "--------------------------------------------------------------------\n" );
+    fprintf( log, "TASK AFFINITY DATA\n" );
+    fprintf( log, "  platform_cpus................................%i\n", CPU_COUNT( &_platform_cpus ) );
+    fprintf( log, "  idle_cpus....................................%i\n", CPU_COUNT( &_idle_cpus ) );
+    fprintf( log, "  realtime_cpu.................................%i\n", _rt_cpu );
+    fprintf( log, "  realtime_priority............................%i\n", _rt_priority );
+    fprintf( log, "  threads_pinned...............................%" PRIu64 "\n", _threads_pinned );
+    fprintf( log, "  threads_pin_failed...........................%" PRIu64 "\n", _threads_pin_failed );
+    fprintf( log, "  affine_runs..................................%" PRIu64 "\n", _affine_runs );
+    fprintf( log, "  tasks_affined................................%" PRIu64 "\n", _tasks_affined );
+    fprintf( log, "  tasks_skipped................................%" PRIu64 "\n", _tasks_skipped );
+    fprintf( log, "  tasks_kept...................................%" PRIu64 "\n", _tasks_kept );
+    fprintf( log, "  tasks_failed.................................%" PRIu64 "\n", _tasks_failed );
+    fprintf( log, "  last_affine_ms...............................%li\n", _last_affine_ms );
+    fprintf( log, "--------------------------------------------------------------------\n" );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Initialize
+// ==========================
+SmErrorT sm_task_affinity_initialize( void )
+{
+    SmErrorT error;
+
+    memset( _pinned_tids, 0, sizeof(_pinned_tids) );
+
+    error = sm_mutex_initialize( &_pinned_tids_mutex, false );
+    if( SM_OKAY != error )
+    {
+        DPRINTFE( "Failed to initialize pinned threads mutex, error=%s.",
+                  sm_error_str( error ) );
+        return( error );
+    }
+
+    CPU_ZERO( &_platform_cpus );
+    CPU_ZERO( &_idle_cpus );
+
+    sm_task_affinity_load_cpus();
+    sm_task_affinity_load_rt_config();
+
+    return( SM_OKAY );
+}
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Finalize
+// ========================
+SmErrorT sm_task_affinity_finalize( void )
+{
+    _rt_cpu = -1;
+    _rt_priority = 0;
+
+    return( sm_mutex_finalize( &_pinned_tids_mutex ) );
+}
+// ****************************************************************************
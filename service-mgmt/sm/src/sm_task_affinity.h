@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2026 Wind River Systems, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __SM_TASK_AFFINITY_H__
+#define __SM_TASK_AFFINITY_H__
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <sched.h>
+
+#include "sm_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    SM_TASK_AFFINITY_CPUS_PLATFORM,
+    SM_TASK_AFFINITY_CPUS_IDLE,
+} SmTaskAffinityCpusT;
+
+// ****************************************************************************
+// Task Affinity - Affine Tasks
+// ============================
+// Sets the cpu affinity of every user task on the host to the given cpu
+// set using sched_setaffinity(), replacing the task_affinity_functions.sh
+// helpers.  Only tasks on the set being replaced are moved, the platform
+// cpus when going to the idle cpus and the idle cpus when going back,
+// tasks with an affinity of their own are kept as they are.
+extern SmErrorT sm_task_affinity_affine_tasks( SmTaskAffinityCpusT cpus );
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Pin Thread
+// ==========================
+// Pins the calling thread to the reserved platform cpu (sm_rt_cpu) and
+// raises it to SCHED_FIFO (sm_rt_priority), when configured.
+extern SmErrorT sm_task_affinity_pin_thread( const char thread_name[] );
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Restore Child
+// =============================
+// Called in a forked child, undoes the affinity inherited from a pinned
+// thread so that actions run on the platform cpus.
+extern void sm_task_affinity_restore_child( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Child Cpus
+// ==========================
+// Returns true with the cpus that sm_task_affinity_restore_child() puts a
+// child on, for children launched by the spawner.
+extern bool sm_task_affinity_child_cpus( cpu_set_t* cpus );
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Dump Data
+// =========================
+extern void sm_task_affinity_dump_data( FILE* log );
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Initialize
+// ==========================
+extern SmErrorT sm_task_affinity_initialize( void );
+// ****************************************************************************
+
+// ****************************************************************************
+// Task Affinity - Finalize
+// ========================
+extern SmErrorT sm_task_affinity_finalize( void );
+// ****************************************************************************
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SM_TASK_AFFINITY_H__
@@ -22,12 +22,23 @@
 #include <sys/prctl.h>
 
 #include "sm_debug.h"
+#include "sm_utils.h"
 #include "sm_timer.h"
 #include "sm_msg.h"
 #include "sm_failover.h"
 #include "sm_service_domain_neighbor_fsm.h"
 #include "sm_service_domain_fsm.h"
 #include "sm_cluster_hbs_info_msg.h"
+#include "sm_task_affinity.h"
+#include "sm_spawner.h"
+#include "sm_service_action_stats.h"
+#include "sm_swact_profiler.h"
+#include "sm_service_plan.h"
+#include "sm_service_group_audit.h"
+#include "sm_service_domain_weight.h"
+#include "sm_journal.h"
+#include "sm_alarm_fm.h"
+#include "sm_service_fsm.h"
 
 #define SM_TROUBLESHOOT_NAME                                "sm_troubleshoot"
 
@@ -49,7 +60,6 @@ SmErrorT sm_troubleshoot_dump_data( const char reason[] )
     } else if( 0 == pid ) {
         // Child process.
         FILE* log = NULL;
-        struct rlimit file_limits;
         int result;
 
         result = prctl( PR_SET_NAME, SM_TROUBLESHOOT_NAME );
@@ -68,19 +78,8 @@ SmErrorT sm_troubleshoot_dump_data( const char reason[] )
             exit( EXIT_FAILURE );
         }
 
-        if( 0 > getrlimit( RLIMIT_NOFILE, &file_limits ) )
-        {
-            printf( "Failed to get file limits, error=%s.",
-                    strerror( errno ) );
-            exit( EXIT_FAILURE );
-        }
+        sm_utils_close_fds( 0 );
 
-        unsigned int fd_i;
-        for( fd_i=0; fd_i < file_limits.rlim_cur; ++fd_i )
-        {
-            close( fd_i );
-        }
-        
         if( 0 > open( "/dev/null", O_RDONLY ) )
         {
             printf( "Failed to open stdin to /dev/null, error=%s.\n",
@@ -129,6 +128,17 @@ SmErrorT sm_troubleshoot_dump_data( const char reason[] )
             SmClusterHbsInfoMsg::dump_hbs_record(log);
             sm_timer_dump_data( log ); fprintf( log, "\n" );
             sm_msg_dump_data( log );   fprintf( log, "\n" );
+            sm_task_affinity_dump_data( log ); fprintf( log, "\n" );
+            sm_spawner_dump_data( log ); fprintf( log, "\n" );
+            sm_service_action_stats_dump_data( log ); fprintf( log, "\n" );
+            sm_swact_profiler_dump_data( log ); fprintf( log, "\n" );
+            sm_service_plan_dump_data( log ); fprintf( log, "\n" );
+            sm_service_group_audit_dump_data( log ); fprintf( log, "\n" );
+            sm_service_domain_weight_dump_data( log ); fprintf( log, "\n" );
+            sm_debug_flight_recorder_dump_data( log ); fprintf( log, "\n" );
+            sm_journal_dump_data( log ); fprintf( log, "\n" );
+            sm_alarm_fm_dump_data( log ); fprintf( log, "\n" );
+            sm_service_fsm_dump_process_death_data( log ); fprintf( log, "\n" );
 
             fflush( log );
             fclose( log );